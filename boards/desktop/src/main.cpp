@@ -44,6 +44,7 @@ int main(int argc, char* argv[])
     std::signal(SIGTERM, Application::handle_signal);
     std::signal(SIGINT, Application::handle_signal);
 
+    app.audio_manager->lock_memory();
     app.audio_manager->start();
     app.engine_manager->start();
     app.ui_manager->main_ui_loop();
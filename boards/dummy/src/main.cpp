@@ -1,13 +1,17 @@
 #include <csignal>
+#include <cstdlib>
+#include <cstring>
 
 #include "core/audio/midi.hpp"
 
 #include "services/audio_manager.hpp"
+#include "services/bounce.hpp"
 #include "services/clock_manager.hpp"
 #include "services/controller.hpp"
 #include "services/engine_manager.hpp"
 #include "services/log_manager.hpp"
 #include "services/preset_manager.hpp"
+#include "services/soak.hpp"
 #include "services/state_manager.hpp"
 #include "services/ui_manager.hpp"
 
@@ -25,9 +29,9 @@ struct DummyUIManager final : UIManager {
 };
 
 struct DummyController final : Controller {
-  void set_color(LED, LEDColor) override{};
-  void flush_leds() override {}
-  void clear_leds() override {}
+  void do_set_color(LED, LEDColor) override{};
+  void do_flush_leds() override {}
+  void do_clear_leds() override {}
 };
 
 int main(int argc, char* argv[])
@@ -47,8 +51,26 @@ int main(int argc, char* argv[])
     std::signal(SIGTERM, Application::handle_signal);
     std::signal(SIGINT, Application::handle_signal);
 
+    // --bounce <file> [--seconds <n>]: render offline instead of running the ui
+    // --soak <minutes>: scripted headless run, failing on leaks and drift
+    const char* bounce_path = nullptr;
+    float bounce_seconds = 180;
+    float soak_minutes = 0;
+    for (int i = 1; i < argc - 1; i++) {
+      if (std::strcmp(argv[i], "--bounce") == 0) bounce_path = argv[i + 1];
+      if (std::strcmp(argv[i], "--seconds") == 0) bounce_seconds = std::atof(argv[i + 1]);
+      if (std::strcmp(argv[i], "--soak") == 0) soak_minutes = std::atof(argv[i + 1]);
+    }
+
     app.engine_manager->start();
+    app.audio_manager->lock_memory();
     app.audio_manager->start();
+    if (bounce_path != nullptr) {
+      return services::bounce::render(bounce_path, bounce_seconds) ? 0 : 1;
+    }
+    if (soak_minutes > 0) {
+      return services::soak::run(soak_minutes) ? 0 : 1;
+    }
     app.ui_manager->main_ui_loop();
 
   } catch (const char* e) {
@@ -65,14 +87,14 @@ int main(int argc, char* argv[])
 
 int handle_exception(const char* e)
 {
-  LOGE(e);
+  LOGE("{}", e);
   LOGE("Exception thrown, exitting!");
   return 1;
 }
 
 int handle_exception(std::exception& e)
 {
-  LOGE(e.what());
+  LOGE("{}", e.what());
   LOGE("Exception thrown, exitting!");
   return 1;
 }
@@ -25,6 +25,12 @@ namespace otto::service::audio {
 
     core::audio::AudioBufferPool& buffer_pool();
 
+    /// Ask jack to renegotiate the buffer size at runtime.
+    ///
+    /// The change lands asynchronously through the buffer size callback, which
+    /// rebuilds the pool. Call from a non-audio thread only
+    bool set_buffer_size(unsigned nframes);
+
   private:
     JackAudioDriver() = default;
     ~JackAudioDriver() noexcept = default;
@@ -46,7 +52,7 @@ namespace otto::service::audio {
     jack_client_t* client;
     jack_status_t jackStatus;
 
-    util::atomic_swap<core::midi::shared_vector<core::midi::AnyMidiEvent>> midi_bufs = {{}, {}};
+    util::atomic_swap<core::midi::EventArena> midi_bufs = {{}, {}};
 
     enum class PortType {
       Audio,
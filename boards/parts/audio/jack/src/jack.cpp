@@ -1,5 +1,8 @@
 #include "board/audio_driver.hpp"
 
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <string>
 #include <vector>
 
@@ -8,12 +11,15 @@
 #include <jack/midiport.h>
 
 #include "util/algorithm.hpp"
+#include "util/dsp/mix_kernels.hpp"
 #include "util/timer.hpp"
 
 #include "core/audio/processor.hpp"
 #include "core/globals.hpp"
 
 #include "services/audio.hpp"
+#include "services/audio_manager.hpp"
+#include "services/debug_ui.hpp"
 #include "services/engines.hpp"
 #include "services/logger.hpp"
 
@@ -33,6 +39,52 @@ namespace otto::service::audio {
     {
       LOGI("JACK shut down, exiting");
     }
+
+    /// Loopback latency measurement. Enabled with OTTO_JACK_LOOPBACK_TEST=1
+    /// and the left output wired back to the input (physically through the
+    /// converters, or inside jack to measure just the period buffering).
+    ///
+    /// A pulse is added on top of the output every couple of seconds, and the
+    /// number of frames until it shows up on the input is logged. Measured
+    /// from the output buffer handed to jack, so a physical loop includes the
+    /// driver's period queue and both converter delays.
+    struct LoopbackTest {
+      const bool enabled = std::getenv("OTTO_JACK_LOOPBACK_TEST") != nullptr;
+
+      void run(float* outL, const float* in, int nframes, int samplerate)
+      {
+        if (!enabled) return;
+        if (frames_since_pulse >= 0) {
+          for (int i = 0; i < nframes; i++) {
+            if (std::abs(in[i]) > threshold) {
+              long frames = frames_since_pulse + i;
+              LOGI("Loopback latency: {} frames ({:.2f} ms)", frames,
+                   frames * 1000.f / samplerate);
+              frames_since_pulse = -1;
+              countdown = 2 * samplerate;
+              return;
+            }
+          }
+          frames_since_pulse += nframes;
+          if (frames_since_pulse > samplerate) {
+            LOGW("Loopback latency: no pulse detected within 1s - is the loop connected?");
+            frames_since_pulse = -1;
+            countdown = 2 * samplerate;
+          }
+        } else if ((countdown -= nframes) <= 0) {
+          outL[0] += pulse_gain;
+          frames_since_pulse = 0;
+        }
+      }
+
+    private:
+      static constexpr float threshold = 0.25f;
+      static constexpr float pulse_gain = 0.5f;
+      long frames_since_pulse = -1;
+      long countdown = 0;
+    };
+
+    LoopbackTest loopback_test;
   } // namespace
 
   JackAudioDriver& JackAudioDriver::get() noexcept
@@ -83,6 +135,15 @@ namespace otto::service::audio {
       },
       this);
 
+    jack_set_xrun_callback(client,
+                           [](void*) {
+                             // Delivered on jack's notification thread, so the
+                             // midi queue cannot be sampled here
+                             services::xrun_stats::record_xrun(0);
+                             return 0;
+                           },
+                           this);
+
     jack_set_port_registration_callback(
       client,
       [](jack_port_id_t id, int is_register, void* data) {
@@ -103,6 +164,15 @@ namespace otto::service::audio {
     LOG_F(INFO, "Initialized JackAudio");
   }
 
+  bool JackAudioDriver::set_buffer_size(unsigned nframes)
+  {
+    if (jack_set_buffer_size(client, nframes) != 0) {
+      LOGE("Jack refused buffer size {}", nframes);
+      return false;
+    }
+    return true;
+  }
+
   void JackAudioDriver::shutdown()
   {
     LOG_F(INFO, "Closing Jack client");
@@ -294,19 +364,21 @@ namespace otto::service::audio {
 
     TIME_SCOPE("JackAudio::Process");
 
+    const auto cb_t0 = std::chrono::steady_clock::now();
+
     if ((size_t) nframes > bufferSize) {
       LOGE("Jack requested more frames than expected");
       return;
     }
 
     gatherMidiInput(nframes);
+    core::midi::preprocess_events(midi_bufs.inner());
 
     float* outLData = (float*) jack_port_get_buffer(ports.outL, nframes);
     float* outRData = (float*) jack_port_get_buffer(ports.outR, nframes);
     float* inData = (float*) jack_port_get_buffer(ports.input, nframes);
 
-    int ref_count = 0;
-    auto in_buf = AudioBufferHandle(inData, nframes, ref_count);
+    auto in_buf = AudioBufferHandle::borrowed(inData, nframes);
     auto out_data =
       engines::process({in_buf,
                         {midi_bufs.inner()},
@@ -316,10 +388,21 @@ namespace otto::service::audio {
 
     LOGW_IF(out_data.nframes != nframes, "Frames went missing!");
 
-    // Separate channels
-    for (int i = 0; i < nframes; i++) {
-      outLData[i] = std::get<0>(out_data.audio[i]);
-      outRData[i] = std::get<1>(out_data.audio[i]);
+    // Separate channels. The frames are contiguous interleaved stereo, so the
+    // split runs at SIMD width instead of per-frame tuple accesses
+    util::dsp::deinterleave2(outLData, outRData, &std::get<0>(out_data.audio[0]), nframes);
+
+    // Direct hardware monitoring - input straight to the output ports with
+    // one gain, skipping the chain's block of latency
+    const float monitor = services::AudioManager::current().direct_monitor();
+    if (monitor > 0.f) {
+      util::dsp::accumulate_scale(outLData, inData, monitor, nframes);
+      util::dsp::accumulate_scale(outRData, inData, monitor, nframes);
     }
+
+    loopback_test.run(outLData, inData, nframes, samplerate);
+
+    services::xrun_stats::push_callback_ns(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - cb_t0).count());
   }
 } // namespace otto::service::audio
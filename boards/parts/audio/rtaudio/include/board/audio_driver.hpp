@@ -20,6 +20,10 @@ namespace otto::services {
 
     RTAudioAudioManager();
 
+    /// Reopen the stream with a new buffer size. Stops the running stream
+    /// first, so call from a non-audio thread only
+    bool set_buffer_size(int frames) noexcept override;
+
   protected:
     int process(float* out_buf,
                  float* in_buf,
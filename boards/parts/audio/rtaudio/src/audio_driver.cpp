@@ -7,10 +7,14 @@
 #include <fmt/format.h>
 
 #include "util/algorithm.hpp"
+#include "util/dsp/denormals.hpp"
+#include "util/dsp/mix_kernels.hpp"
+#include "util/thread.hpp"
 
 #include "core/audio/processor.hpp"
 
 #include "services/audio_manager.hpp"
+#include "services/debug_ui.hpp"
 #include "services/engine_manager.hpp"
 #include "services/log_manager.hpp"
 #include "services/clock_manager.hpp"
@@ -67,7 +71,9 @@ namespace otto::services {
       _buffer_size = buf_siz;
       buffer_pool().set_buffer_size(buf_siz);
       client.startStream();
-      gam::sampleRate(samplerate());
+      // Also updates the Gamma domain and regenerates registered
+      // samplerate-dependent tables when the rate moved
+      samplerate_changed(_samplerate);
     } catch (RtAudioError& e) {
       e.printMessage();
       if (enable_input) {
@@ -80,6 +86,26 @@ namespace otto::services {
     }
   }
 
+  bool RTAudioAudioManager::set_buffer_size(int frames) noexcept
+  {
+    if (frames <= 0) return false;
+    if (frames == buffer_size()) return true;
+    try {
+      // RtAudio only takes the buffer size at openStream, so renegotiation is
+      // a stream bounce. stopStream joins the callback, so once it returns no
+      // block is in flight and the pool can be resized safely
+      if (client.isStreamRunning()) client.stopStream();
+      if (client.isStreamOpen()) client.closeStream();
+      _buffer_size = unsigned(frames);
+      init_audio();
+      LOGI("Renegotiated buffer size to {} frames", buffer_size());
+      return true;
+    } catch (RtAudioError& e) {
+      LOGE("Buffer size renegotiation failed: {}", e.getMessage());
+      return false;
+    }
+  }
+
   void RTAudioAudioManager::init_midi()
   {
     midi_out.emplace(RtMidi::Api::UNSPECIFIED, "OTTO");
@@ -106,6 +132,20 @@ namespace otto::services {
     midi_in->setCallback(
       [](double timeStamp, std::vector<unsigned char>* message, void* userData) {
         auto& self = *static_cast<RTAudioAudioManager*>(userData);
+        if (!message->empty() && (*message)[0] >= 0xF8) {
+          // System realtime - single bytes, routed to the clock service
+          // instead of the midi queue. The tick is stamped here so queueing
+          // jitter never reaches the tempo estimator
+          auto& clock = ClockManager::current();
+          switch ((*message)[0]) {
+          case 0xF8: clock.external_clock_tick(std::chrono::steady_clock::now()); break;
+          case 0xFA: clock.external_clock_start(); break;
+          case 0xFB: clock.external_clock_continue(); break;
+          case 0xFC: clock.external_clock_stop(); break;
+          default: break;
+          }
+          return;
+        }
         try {
           self.send_midi_event(core::midi::from_bytes(*message));
         } catch (util::exception& e) {
@@ -123,12 +163,22 @@ namespace otto::services {
                                    double stream_time,
                                    RtAudioStreamStatus stream_status)
   {
-    _buffer_number++;
+    publish_block();
     auto running = this->running() && Application::current().running();
     if (!running) {
       return 0;
     }
 
+    // The callback thread is created by RtAudio - apply the board's audio band
+    // (priority + core affinity) and flush-to-zero mode the first time it
+    // lands here
+    static thread_local bool sched_applied = false;
+    if (!sched_applied) {
+      util::scheduling::apply(util::scheduling::Band::audio);
+      util::dsp::flush_denormals_to_zero();
+      sched_applied = true;
+    }
+
     if ((unsigned) nframes > _buffer_size) {
       LOGE("RTAudio requested more frames than expected");
       return 0;
@@ -137,37 +187,45 @@ namespace otto::services {
     clock::time_point t0 = clock::now();
 
     midi_bufs.swap();
+    drain_midi_queue();
+    core::midi::preprocess_events(midi_bufs.inner());
 
-    int ref_count = 0;
-    auto in_buf = enable_input ? core::audio::AudioBufferHandle(in_data, nframes, ref_count) : Application::current().audio_manager->buffer_pool().allocate_clear();
-    // steal the inner midi buffer
+    if (stream_status != 0) {
+      xrun_stats::record_xrun(midi_bufs.inner().size());
+    }
+
+    // Wrap the device buffer directly - it outlives the process call, so no copy into
+    // the pool is needed
+    auto in_buf = enable_input ? core::audio::AudioBufferHandle::borrowed(in_data, nframes)
+                               : Application::current().audio_manager->buffer_pool().allocate_clear();
     auto out = Application::current().engine_manager->process(
-      {in_buf, {std::move(midi_bufs.inner())}, core::clock::ClockRange{}});
+      {in_buf, {midi_bufs.inner()}, core::clock::ClockRange{}});
 
     // process_audio_output(out);
 
     LOGW_IF(out.nframes != nframes, "Frames went missing!");
 
     // Separate channels
-    for (int i = 0; i < nframes; i++) {
-      out_data[i * 2] = out.audio[0][i];
-      out_data[i * 2 + 1] = out.audio[1][i];
+    util::dsp::interleave2(out_data, out.audio[0].data(), out.audio[1].data(), nframes);
+
+    // Direct hardware monitoring - raw input mixed straight into the device
+    // buffer, skipping the chain's full block of latency. The chain still got
+    // the same input above for fx and looper capture
+    const float monitor = direct_monitor();
+    if (enable_input && monitor > 0.f) {
+      util::dsp::accumulate_interleave2(out_data, in_data, in_data, monitor, nframes);
     }
 
     if (midi_out) {
       for (auto& ev : out.midi) {
-        util::match(ev, [this](auto& ev) {
-          auto bytes = ev.to_bytes();
-          midi_out->sendMessage(bytes.data(), bytes.size());
-        });
+        auto bytes = ev.to_bytes();
+        midi_out->sendMessage(bytes.data(), bytes.size());
       }
     }
 
-    // return the midi buffer
-    midi_bufs.inner() = out.midi.move_vector_out();
-
     clock::time_point t1 = clock::now();
 
+    xrun_stats::push_callback_ns(std::chrono::nanoseconds(t1 - t0).count());
     _cpu_time.add(std::chrono::nanoseconds(t1 - t0).count() / (1e9 / float(_samplerate) * nframes));
 
     return 0;
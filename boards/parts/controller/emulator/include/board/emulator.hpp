@@ -16,9 +16,9 @@ namespace otto::board {
 
     void draw(core::ui::vg::Canvas& ctx) override;
 
-    void set_color(services::LED, services::LEDColor) override;
-    void flush_leds() override;
-    void clear_leds() override;
+    void do_set_color(services::LED, services::LEDColor) override;
+    void do_flush_leds() override;
+    void do_clear_leds() override;
 
     void handle_click(core::ui::vg::Point p, ClickAction);
     void handle_scroll(core::ui::vg::Point p, float offset);
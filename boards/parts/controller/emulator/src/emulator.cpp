@@ -6,15 +6,15 @@ namespace otto::board {
 
   using namespace services;
 
-  void Emulator::set_color(LED led, LEDColor color)
+  void Emulator::do_set_color(LED led, LEDColor color)
   {
     _led_colors[led.key] = color;
   }
-  void Emulator::flush_leds()
+  void Emulator::do_flush_leds()
   {
     // NOOP
   }
-  void Emulator::clear_leds()
+  void Emulator::do_clear_leds()
   {
     for (auto& col : _led_colors) {
       col = LEDColor::Black;
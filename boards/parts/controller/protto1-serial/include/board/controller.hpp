@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <gsl/span>
 
 #include "util/locked.hpp"
@@ -24,6 +25,8 @@ namespace otto::services {
    * | 0xE0 | Clear all LEDs   | COLOR       |
    * | 0xE1 | Clear LED group  | GROUP,COLOR |
    * | 0xEC | Set LED color    | LED,COLOR   |
+   * | 0xEA | Fade LED         | LED,COLOR,COLOR,TIME |
+   * | 0xEB | Blink LED        | LED,COLOR,COLOR,TIME |
    * | 0x2A | Request key dump |             |
    * 
    * # MCU -> RPI Messages
@@ -51,6 +54,12 @@ namespace otto::services {
    * 
    * # Encoding of Steps
    * Encoder steps are encoded as signed single bytes.
+   *
+   * # Encoding of Time
+   * Effect durations are encoded as a single unsigned byte in units of 10ms,
+   * so the range is 10ms to 2.55s. Fades run once from the first color to the
+   * second; blinks alternate between the colors, each shown for half the
+   * period, until the next `Set LED color` for that led.
    * 
    * # Encoding of Keys/LEDs
    *
@@ -70,19 +79,40 @@ namespace otto::services {
   struct PrOTTO1SerialController final : Controller {
     PrOTTO1SerialController();
 
-    void set_color(LED, LEDColor) override;
-    void flush_leds() override;
-    void clear_leds() override;
+    void do_set_color(LED, LEDColor) override;
+    void do_flush_leds() override;
+    void do_clear_leds() override;
+    bool do_start_effect(LED, const LEDEffect&) override;
 
     static std::unique_ptr<Controller> make_or_dummy();
     static std::unique_ptr<Controller> make_or_emulator();
 
   private:
+    /// Parser state between bulk reads - a frame may straddle two reads
+    enum struct ParseState : std::uint8_t {
+      /// Awaiting a command byte
+      idle,
+      /// Collecting a fixed number of argument bytes
+      args,
+      /// Collecting a newline-terminated payload
+      line,
+      /// Awaiting the frame's trailing newline
+      tail,
+    };
+
+    /// Feed one bulk read through the table-driven parser, delivering each
+    /// completed frame to {@ref handle_message}
+    void parse_bytes(BytesView);
     void handle_message(BytesView);
     void queue_message(BytesView);
 
     void handle_keyevent(Command cmd, BytesView args, bool do_send_midi);
 
+    ParseState state_ = ParseState::idle;
+    std::array<std::uint8_t, 64> frame_ = {};
+    std::size_t frame_len_ = 0;
+    int args_left_ = 0;
+
     util::Serial serial = {"/dev/ttyACM0", 10, 1};
     util::double_buffered<EventBag, util::clear_inner> events_;
     util::double_buffered<std::vector<std::uint8_t>, util::clear_outer> write_buffer_;
@@ -25,6 +25,8 @@ namespace otto::services {
               clear_all_leds = 0xE0,
               clear_led_group = 0xE1,
               set_led_color = 0xEC,
+              fade_led = 0xEA,
+              blink_led = 0xEB,
               request_key_dump = 0x2A,
               key_down = 0x20,
               key_up = 0x21,
@@ -34,6 +36,30 @@ namespace otto::services {
               yellow_enc_step = 0x32,
               red_enc_step = 0x33)
 
+  /// Marks bytes that do not start a frame - the parser skips them to resync
+  constexpr std::int8_t invalid_cmd = -1;
+  /// Marks commands with a variable-length, newline-terminated payload
+  constexpr std::int8_t line_cmd = -2;
+
+  /// Argument byte count of each MCU -> RPI command, indexed by the raw
+  /// command byte. Frames are framed by this table plus the trailing
+  /// newline, so payload bytes are free to contain 0x0A
+  constexpr auto arg_table = [] {
+    std::array<std::int8_t, 256> res = {};
+    for (auto& e : res) e = invalid_cmd;
+    res[Command::request_alive] = 0;
+    res[Command::respond_alive] = 0;
+    res[Command::key_down] = 1;
+    res[Command::key_up] = 1;
+    res[Command::blue_enc_step] = 1;
+    res[Command::green_enc_step] = 1;
+    res[Command::yellow_enc_step] = 1;
+    res[Command::red_enc_step] = 1;
+    res[Command::debug_message] = line_cmd;
+    res[Command::respond_key_dump] = line_cmd;
+    return res;
+  }();
+
   byte to_byte(Key k)
   {
     return util::underlying(k);
@@ -108,11 +134,61 @@ namespace otto::services {
     }
   }
 
+  void P1SC::parse_bytes(BytesView bytes)
+  {
+    for (auto b : bytes) {
+    reconsider:
+      switch (state_) {
+        case ParseState::idle: {
+          auto args = arg_table[b];
+          if (args == invalid_cmd) break;
+          frame_len_ = 0;
+          frame_[frame_len_++] = b;
+          if (args == line_cmd) {
+            state_ = ParseState::line;
+          } else {
+            args_left_ = args;
+            state_ = args > 0 ? ParseState::args : ParseState::tail;
+          }
+        } break;
+        case ParseState::args: {
+          frame_[frame_len_++] = b;
+          if (--args_left_ == 0) state_ = ParseState::tail;
+        } break;
+        case ParseState::line: {
+          if (b == '\n') {
+            handle_message(BytesView(frame_.data(), frame_len_));
+            state_ = ParseState::idle;
+          } else if (frame_len_ == frame_.size()) {
+            LOGE("Overlong serial frame - dropping");
+            state_ = ParseState::idle;
+          } else {
+            frame_[frame_len_++] = b;
+          }
+        } break;
+        case ParseState::tail: {
+          if (b == '\n') {
+            handle_message(BytesView(frame_.data(), frame_len_));
+            state_ = ParseState::idle;
+          } else {
+            // Framing slip - this byte may itself start the next frame
+            LOGE("Serial framing error after command {:02X}", frame_[0]);
+            state_ = ParseState::idle;
+            goto reconsider;
+          }
+        } break;
+      }
+    }
+  }
+
   P1SC::PrOTTO1SerialController()
     : read_thread([this](auto should_run) noexcept {
+        // One bulk read per burst - an encoder storm arrives as one buffer
+        // and one pass through the parser, not one syscall per byte
+        std::array<std::uint8_t, 256> buf;
         while (should_run()) {
-          serial.read_line()
-            .map([&](auto&& bytes) { handle_message(bytes); })
+          serial.read_some({buf.data(), buf.size()})
+            .map([&](std::size_t n) { parse_bytes(util::BytesView(buf.data(), n)); })
             .map_error([&](auto&& error) {
               if (error.data() != util::Serial::ErrorCode::empty_buffer) {
                 LOGE("Error reading serial data {}", error.what());
@@ -140,19 +216,38 @@ namespace otto::services {
     }
   }
 
-  void P1SC::set_color(LED led, LEDColor color)
+  void P1SC::do_set_color(LED led, LEDColor color)
   {
     std::array<std::uint8_t, 6> msg = {0xEC, led.key._to_integral(), color.r, color.g, color.b,
                                        '\n'};
     queue_message(msg);
   }
 
-  void P1SC::flush_leds()
+  bool P1SC::do_start_effect(LED led, const LEDEffect& effect)
+  {
+    Command cmd = Command::fade_led;
+    switch (effect.type) {
+      case LEDEffect::Type::fade: cmd = Command::fade_led; break;
+      case LEDEffect::Type::blink: cmd = Command::blink_led; break;
+      default: return false;
+    }
+    auto time_cs = std::clamp<chrono::milliseconds::rep>(
+      chrono::duration_cast<chrono::milliseconds>(effect.period).count() / 10, 1, 255);
+    std::array<std::uint8_t, 10> msg = {cmd._to_integral(), led.key._to_integral(),
+                                        effect.from.r,      effect.from.g,
+                                        effect.from.b,      effect.to.r,
+                                        effect.to.g,        effect.to.b,
+                                        std::uint8_t(time_cs), '\n'};
+    queue_message(msg);
+    return true;
+  }
+
+  void P1SC::do_flush_leds()
   {
     write_buffer_.swap();
     serial.write(write_buffer_.inner());
   }
-  void P1SC::clear_leds()
+  void P1SC::do_clear_leds()
   {
     auto c = LEDColor::Black;
     std::array<std::uint8_t, 5> msg = {0xE0, c.r, c.g, c.b, '\n'};
@@ -16,9 +16,9 @@ namespace otto::services {
   struct TOOT_MCU_FIFO_Controller final : Controller {
     TOOT_MCU_FIFO_Controller();
 
-    void set_color(LED, LEDColor) override;
-    void flush_leds() override;
-    void clear_leds() override;
+    void do_set_color(LED, LEDColor) override;
+    void do_flush_leds() override;
+    void do_clear_leds() override;
 
     static std::unique_ptr<Controller> make_or_dummy();
 //    static std::unique_ptr<Controller> make_or_emulator();
@@ -7,6 +7,7 @@
 #include "services/log_manager.hpp"
 #include "services/ui_manager.hpp"
 #include "services/audio_manager.hpp"
+#include "services/debug_ui.hpp"
 
 //#include "board/emulator.hpp"
 
@@ -32,7 +33,9 @@ namespace otto::services {
               blue_enc_step = 0x30,
               green_enc_step = 0x31,
               yellow_enc_step = 0x32,
-              red_enc_step = 0x33)
+              red_enc_step = 0x33,
+              request_cpu_times = 0x40,
+              respond_cpu_times = 0x41)
 
   byte to_byte(Key k)
   {
@@ -101,6 +104,19 @@ namespace otto::services {
       case Command::debug_message: {
         DLOGI("MCU DEBUG: {}", std::string(bytes.begin(), bytes.end()));
       } break;
+      case Command::request_cpu_times: {
+        // Respond with the per-stage audio cpu times in microseconds, two big-endian
+        // bytes per stage, in audio_stage_timers::stage_names order
+        std::vector<byte> msg = make_message(Command::respond_cpu_times);
+        for (int i = 0; i < audio_stage_timers::stage_count; i++) {
+          auto us = audio_stage_timers::read_ns(audio_stage_timers::Stage(i)) / 1000;
+          if (us > 0xFFFF) us = 0xFFFF;
+          msg.push_back(byte(us >> 8));
+          msg.push_back(byte(us & 0xFF));
+        }
+        msg.push_back('\n');
+        queue_message(msg);
+      } break;
       default: {
         LOGE("Unparsable message");
         break;
@@ -111,13 +127,23 @@ namespace otto::services {
   TMFC::TOOT_MCU_FIFO_Controller()
     : read_thread([this](auto should_run) noexcept {
         while (should_run()) {
-          fifo0.read_line()
-            .map([&](auto&& bytes) { handle_message(bytes); })
-            .map_error([&](auto&& error) {
-              if (error.data() != util::FIFO::ErrorCode::empty_buffer) {
-                LOGE("Error reading fifo data {}", error.what());
-              }
-            });
+          // Wake once per burst, then drain every buffered frame without
+          // further syscalls
+          if (auto res = fifo0.wait_readable(100); !res) {
+            if (res.error().data() != util::FIFO::ErrorCode::empty_buffer) {
+              LOGE("Error polling fifo {}", res.error().what());
+            }
+            continue;
+          }
+          do {
+            fifo0.read_line()
+              .map([&](auto&& bytes) { handle_message(bytes); })
+              .map_error([&](auto&& error) {
+                if (error.data() != util::FIFO::ErrorCode::empty_buffer) {
+                  LOGE("Error reading fifo data {}", error.what());
+                }
+              });
+          } while (fifo0.has_buffered());
         }
       })
   {}
@@ -140,18 +166,18 @@ namespace otto::services {
 //   }
 // }
 
-  void TMFC::set_color(LED led, LEDColor color)
+  void TMFC::do_set_color(LED led, LEDColor color)
   {
     std::array<std::uint8_t, 6> msg = {0xEC, led.key._to_integral(), color.r, color.g, color.b,
                                        '\n'};
     queue_message(msg);
   }
-  void TMFC::flush_leds()
+  void TMFC::do_flush_leds()
   {
     write_buffer_.swap();
     fifo1.write(write_buffer_.inner());
   }
-  void TMFC::clear_leds()
+  void TMFC::do_clear_leds()
   {
     std::array<std::uint8_t, 5> msg = {0xE0, 0, '\n'};
     queue_message(msg);
@@ -1,4 +1,8 @@
 #include "./egl_connection.hpp"
+
+#include <chrono>
+
+#include "services/debug_ui.hpp"
 #include "services/log_manager.hpp"
 
 namespace otto::board::ui {
@@ -120,6 +124,11 @@ namespace otto::board::ui {
       LOGF("Error connecting the context to the surface");
     }
 
+    // Keep the back buffer across swaps, so frames only have to redraw damaged
+    // regions. If the driver refuses, the ui loop falls back to full redraws.
+    buffer_preserved = eglSurfaceAttrib(state.display, state.surface, EGL_SWAP_BEHAVIOR,
+                                        EGL_BUFFER_PRESERVED) == EGL_TRUE;
+
     // Set background color and clear buffers
     glClearColor(1.f, 1.f, 1.f, 1.f);
 
@@ -150,12 +159,20 @@ namespace otto::board::ui {
   }
 
   void EGLConnection::beginFrame()
+  {
+    beginFrame(0, 0, draw_size.width, draw_size.height);
+  }
+
+  void EGLConnection::beginFrame(int x, int y, int w, int h)
   {
     // Start with a clear screen
     glViewport(0, 0, draw_size.width, draw_size.height);
 
     glClearColor(0, 0, 0, 0);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, y, w, h);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -163,9 +180,45 @@ namespace otto::board::ui {
     glEnable(GL_STENCIL_TEST);
   }
 
+  void EGLConnection::set_swap_mode(SwapMode mode)
+  {
+    swap_mode = mode;
+    if (eglSwapInterval(state.display, mode == SwapMode::vsync ? 1 : 0) == EGL_FALSE) {
+      LOGE("Could not set swap interval - staying with the driver default");
+    }
+  }
+
   void EGLConnection::endFrame()
   {
+    using clock = std::chrono::steady_clock;
+    /// Half a 60Hz scanout. A swap blocking longer than this waited for
+    /// vblank because the previous frame had not hit scanout yet
+    constexpr std::uint64_t stall_threshold_ns = 8'000'000;
+
+    auto t0 = clock::now();
     eglSwapBuffers(state.display, state.surface);
+    auto ns = std::uint64_t(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count());
+
+    using services::ui_swap_stats;
+    ui_swap_stats::last_swap_ns.store(ns, std::memory_order_relaxed);
+    if (ns > ui_swap_stats::max_swap_ns.load(std::memory_order_relaxed)) {
+      ui_swap_stats::max_swap_ns.store(ns, std::memory_order_relaxed);
+    }
+    ui_swap_stats::frames.fetch_add(1, std::memory_order_relaxed);
+    if (ns > stall_threshold_ns) {
+      ui_swap_stats::stalled_swaps.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Frame cadence for the session report - the interval between successive
+    // presented frames, not just the time blocked in the swap
+    static clock::time_point last_present = {};
+    const auto now = clock::now();
+    if (last_present != clock::time_point{}) {
+      ui_swap_stats::push_frame_interval_ns(std::uint64_t(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_present).count()));
+    }
+    last_present = now;
   }
 
 } // namespace otto::board::ui
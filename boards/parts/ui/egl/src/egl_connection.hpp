@@ -14,12 +14,30 @@ namespace otto::board::ui {
     using DMXUpdate = DISPMANX_UPDATE_HANDLE_T;
     using VCRect = VC_RECT_T;
 
+    /// How {@ref endFrame} presents.
+    enum struct SwapMode {
+      /// Swap interval 1 - eglSwapBuffers waits for vblank. A missed frame
+      /// blocks the ui thread until the next one
+      vsync,
+      /// Swap interval 0 - eglSwapBuffers returns as soon as a buffer is
+      /// free. Frames that outpace scanout are dropped by the compositor
+      /// instead of stalling the ui thread
+      free_running,
+    };
+
     void init();
     void exit();
 
     void beginFrame();
+    /// Begin a frame, clearing only the given rectangle (GL coordinates, origin
+    /// bottom left). Requires the swap behaviour to be `EGL_BUFFER_PRESERVED` for
+    /// the rest of the previous frame to stay valid.
+    void beginFrame(int x, int y, int w, int h);
     void endFrame();
 
+    /// Set the swap mode. Callable any time after {@ref init}
+    void set_swap_mode(SwapMode mode);
+
     void initEGL();
 
     struct EGLData {
@@ -42,6 +60,12 @@ namespace otto::board::ui {
       int height = 240;
     } draw_size;
 
+    /// Whether the back buffer is kept across swaps. When false, every frame must
+    /// redraw the full screen.
+    bool buffer_preserved = false;
+
+    SwapMode swap_mode = SwapMode::vsync;
+
     struct EGLState {
       uint width;
       uint height;
@@ -16,7 +16,7 @@
 #include "./egl_deps.hpp"
 #include "board/ui/egl_ui_manager.hpp"
 
-static nlohmann::json config = {{"FPS", 30.f}, {"Debug", false}};
+static nlohmann::json config = {{"FPS", 30.f}, {"Debug", false}, {"VSync", true}};
 
 namespace otto::services {
 
@@ -27,6 +27,8 @@ namespace otto::services {
   {
     EGLConnection egl;
     egl.init();
+    egl.set_swap_mode(config["VSync"].get<bool>() ? EGLConnection::SwapMode::vsync
+                                                  : EGLConnection::SwapMode::free_running);
 
     NVGcontext* nvg = nvgCreateGLES2(NVG_ANTIALIAS | NVG_STENCIL_STROKES | NVG_DEBUG);
     if (nvg == NULL) {
@@ -60,14 +62,35 @@ namespace otto::services {
     float fps;
     duration<double> lastFrameTime;
 
-//    std::thread kbd_thread = std::thread([this] { read_keyboard(); });
+    // Exits when the application stops running, or right away if no keyboard
+    // is attached
+    std::thread kbd_thread = std::thread([this] { read_keyboard(); });
 
     while (Application::current().running()) {
       t0 = clock::now();
 
+      if (egl.buffer_preserved && frame_would_be_identical()) {
+        // Nothing changed - leave the previous frame on screen
+        skip_frame();
+        std::this_thread::sleep_for(waitTime * frame_time_multiplier());
+        continue;
+      }
+
       // Update and render
-      egl.beginFrame();
-      canvas.clearColor(vg::Colours::Black);
+      auto& screen = current_screen();
+      if (egl.buffer_preserved && screen.has_partial_damage()) {
+        // The cpu readout in the corner changes every frame
+        screen.invalidate({280, 215, 40, 25});
+        // Only clear the damaged area - the rest of the previous frame is still
+        // valid, and draw_frame scissors to the same area. GL origin is bottom left
+        auto d = screen.damage();
+        egl.beginFrame(int(d.x * xscale), int(egl.draw_size.height - (d.y + d.height) * yscale),
+                       int(std::ceil(d.width * xscale)), int(std::ceil(d.height * yscale)));
+      } else {
+        screen.invalidate_all();
+        egl.beginFrame();
+        canvas.clearColor(vg::Colours::Black);
+      }
       canvas.beginFrame(egl.draw_size.width, egl.draw_size.height);
       canvas.scale(xscale, yscale);
       draw_frame(canvas);
@@ -79,13 +102,19 @@ namespace otto::services {
         canvas.fillStyle(vg::Colours::White);
         canvas.textAlign(vg::TextAlign::Left, vg::TextAlign::Baseline);
         canvas.fillText(fmt::format("{:.2f} FPS", fps), {0, vg::height});
+        canvas.fillText(
+          fmt::format("swap {:.1f}ms  stalls {}",
+                      ui_swap_stats::last_swap_ns.load(std::memory_order_relaxed) / 1e6,
+                      ui_swap_stats::stalled_swaps.load(std::memory_order_relaxed)),
+          {0, vg::height - 16});
       }
 
       canvas.endFrame();
       egl.endFrame();
 
       lastFrameTime = clock::now() - t0;
-      std::this_thread::sleep_for(waitTime - lastFrameTime);
+      // Halve the frame rate when the audio thread is close to its deadline
+      std::this_thread::sleep_for(waitTime * frame_time_multiplier() - lastFrameTime);
 
       auto ms = std::chrono::duration_cast<nanoseconds>(lastFrameTime).count();
       fps = one_second / ms;
@@ -95,6 +124,6 @@ namespace otto::services {
 
     egl.exit();
 
-//    kbd_thread.join();
+    kbd_thread.join();
   }
 } // namespace otto::services
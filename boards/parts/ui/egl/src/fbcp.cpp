@@ -3,7 +3,12 @@
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 #include "util/exception.hpp"
+#include "util/thread.hpp"
 
 #include "services/log_manager.hpp"
 
@@ -11,7 +16,15 @@
 
 namespace otto::board::ui {
 
-  RpiFBCP::RpiFBCP(EGLConnection::EGLData& data) : egl_data(data) {}
+  /// An empty damage range - merging any real range into it yields that range
+  static constexpr int no_damage_first = std::numeric_limits<int>::max();
+  static constexpr int no_damage_last = 0;
+
+  RpiFBCP::RpiFBCP(EGLConnection::EGLData& data) : egl_data(data)
+  {
+    _pending_first = no_damage_first;
+    _pending_last = no_damage_last;
+  }
 
   void RpiFBCP::init()
   {
@@ -48,17 +61,68 @@ namespace otto::board::ui {
     }
 
     vc_dispmanx_rect_set(&rect1, 0, 0, vinfo.xres, vinfo.yres);
+
+    _transfer_thread = std::thread([this] {
+      util::scheduling::apply(util::scheduling::Band::worker);
+      transfer_loop();
+    });
   }
 
   void RpiFBCP::copy()
   {
-    vc_dispmanx_snapshot(egl_data.display, screen_resource, DISPMANX_NO_ROTATE);
-    vc_dispmanx_resource_read_data(screen_resource, &rect1, fbp,
-                                   vinfo.xres * vinfo.bits_per_pixel / 8);
+    copy(0, vinfo.yres);
+  }
+
+  void RpiFBCP::copy(int first_line, int last_line)
+  {
+    first_line = std::clamp(first_line, 0, int(vinfo.yres));
+    last_line = std::clamp(last_line, first_line, int(vinfo.yres));
+    if (first_line == last_line) return;
+
+    {
+      std::unique_lock lock{_damage_mutex};
+      _pending_first = std::min(_pending_first, first_line);
+      _pending_last = std::max(_pending_last, last_line);
+    }
+    _damage_cv.notify_one();
+  }
+
+  void RpiFBCP::transfer_loop()
+  {
+    for (;;) {
+      int first_line;
+      int last_line;
+      {
+        std::unique_lock lock{_damage_mutex};
+        _damage_cv.wait(lock, [this] { return _stop || _pending_last > _pending_first; });
+        if (_stop) return;
+        first_line = std::exchange(_pending_first, no_damage_first);
+        last_line = std::exchange(_pending_last, no_damage_last);
+      }
+
+      // GPU snapshot, then read the damaged lines out into the fbtft
+      // framebuffer. The kernel driver picks the dirty pages up from there
+      // and runs the SPI transfer by DMA - the only CPU cost on this thread
+      // is the readout.
+      vc_dispmanx_snapshot(egl_data.display, screen_resource, DISPMANX_NO_ROTATE);
+      auto pitch = vinfo.xres * vinfo.bits_per_pixel / 8;
+      VC_RECT_T rect;
+      vc_dispmanx_rect_set(&rect, 0, first_line, vinfo.xres, last_line - first_line);
+      vc_dispmanx_resource_read_data(screen_resource, &rect, fbp + first_line * pitch,
+                                     pitch);
+    }
   }
 
   void RpiFBCP::exit() noexcept
   {
+    if (_transfer_thread.joinable()) {
+      {
+        std::unique_lock lock{_damage_mutex};
+        _stop = true;
+      }
+      _damage_cv.notify_all();
+      _transfer_thread.join();
+    }
     munmap(fbp, finfo.smem_len);
     close(fbfd);
     vc_dispmanx_resource_delete(screen_resource);
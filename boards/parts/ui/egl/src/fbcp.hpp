@@ -2,6 +2,10 @@
 
 #include <linux/fb.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "./egl_connection.hpp"
 
 namespace otto::board::ui {
@@ -10,6 +14,13 @@ namespace otto::board::ui {
   /// framebuffer which is used by fbtft. This is useful when using an SPI
   /// display.
   ///
+  /// The copy itself - GPU snapshot, readout into the fbtft framebuffer, and
+  /// the SPI transfer the kernel driver runs from there - happens on a
+  /// dedicated worker-band thread. {@ref copy} only records the damaged
+  /// scanlines and wakes that thread, so the ui thread never waits on the
+  /// display link. Damage queued while a transfer is in flight merges into
+  /// the next one.
+  ///
   /// At some point in the future, we will probably want to skip some of these
   /// steps, possibly by including the spi driver directly and writing the main
   /// framebuffer to that on each frame.
@@ -23,9 +34,19 @@ namespace otto::board::ui {
 
     void init();
     void copy();
+    /// Queue a copy of the scanlines in `[first_line, last_line)`.
+    ///
+    /// Use with @ref services::UIManager::last_frame_damage to avoid pushing
+    /// unchanged lines over SPI. Returns immediately - the transfer runs on
+    /// the copy thread.
+    void copy(int first_line, int last_line);
     void exit() noexcept;
 
   private:
+    /// Runs on the copy thread - waits for damage, then snapshots and reads
+    /// out into the fbtft framebuffer
+    void transfer_loop();
+
     EGLConnection::EGLData& egl_data;
 
     DISPMANX_RESOURCE_HANDLE_T screen_resource;
@@ -35,6 +56,15 @@ namespace otto::board::ui {
 
     struct fb_fix_screeninfo finfo;
     struct fb_var_screeninfo vinfo;
+
+    /// The merged damage waiting for the copy thread. Empty when
+    /// `_pending_last <= _pending_first`. Guarded by `_damage_mutex`
+    std::mutex _damage_mutex;
+    std::condition_variable _damage_cv;
+    int _pending_first = 0;
+    int _pending_last = 0;
+    bool _stop = false;
+    std::thread _transfer_thread;
   };
 
 } // namespace otto::board::ui
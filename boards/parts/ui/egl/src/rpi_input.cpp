@@ -1,6 +1,7 @@
 #include <fcntl.h>
 #include <linux/input.h>
 #include <unistd.h>
+#include <chrono>
 #include <string>
 #include <thread>
 #include <vector>
@@ -109,6 +110,49 @@ namespace otto::services {
 
   void EGLUIManager::read_keyboard()
   {
+    int keyboard = open_device("event-kbd");
 
+    if (keyboard == -1) {
+      LOGE("Could not find a keyboard - keyboard input disabled");
+      return;
+    }
+
+    /// The merged events of one read batch, in arrival order.
+    ///
+    /// A fast encoder spin arrives as a run of identical key repeats, one per
+    /// SYN frame - each run collapses to a single dispatch. Presses and
+    /// releases are never merged, so no key transition is lost.
+    struct Pending {
+      Key key;
+      Action action;
+    };
+    std::vector<Pending> pending;
+    pending.reserve(event_buffer_size);
+
+    while (Application::current().running()) {
+      /// One syscall drains everything that arrived since the last wake
+      auto events = read_events(keyboard);
+      if (events.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        continue;
+      }
+
+      for (const auto& event : events) {
+        if (event.type != EV_KEY) continue;
+        auto action = event.value == key_press
+                        ? Action::press
+                        : event.value == key_release ? Action::release : Action::repeat;
+        auto key = Key(event.code);
+        if (action == Action::repeat && !pending.empty() && pending.back().key == key &&
+            pending.back().action == Action::repeat) {
+          // Merged into the previous repeat of the same key
+          continue;
+        }
+        pending.push_back({key, action});
+      }
+
+      for (const auto& p : pending) handle_keyevent(p.action, {}, p.key);
+      pending.clear();
+    }
   }
 } // namespace otto::board::ui
@@ -267,6 +267,9 @@ namespace otto::services {
         main_win.canvas().translate(518, 28);
         main_win.canvas().scale(215.f / 320.f, 161.f / 240.f);
       }
+      // This backend clears the whole window every frame, so partial redraws
+      // never apply here
+      current_screen().invalidate_all();
       draw_frame(main_win.canvas());
 
       main_win.end_frame();
@@ -275,7 +278,8 @@ namespace otto::services {
 
       spent = glfwGetTime() - t;
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(int(1000 / 120 - spent * 1000)));
+      // Halve the frame rate when the audio thread is close to its deadline
+      std::this_thread::sleep_for(std::chrono::milliseconds(int(frame_time_multiplier() * 1000 / 120 - spent * 1000)));
 
     }
   }
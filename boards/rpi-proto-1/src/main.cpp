@@ -14,6 +14,7 @@
 #include "services/settings.hpp"
 #include "board/audio_driver.hpp"
 #include "board/ui/egl_ui_manager.hpp"
+#include "util/thread.hpp"
 
 using namespace otto;
 using namespace otto::services;
@@ -25,6 +26,18 @@ int handle_exception();
 int main(int argc, char* argv[])
 {
   try {
+    // Scheduling layout for the quad-core Pi: audio alone on core 2, ui and
+    // logic on cores 0-1, the fx worker on core 3. Installed before any
+    // service can start a thread
+    util::scheduling::Config sched;
+    // The workers keep default priority - the fx worker spins, and SCHED_FIFO
+    // spinning would starve kernel threads on its core
+    sched.audio = {80, 0b0100};
+    sched.ui = {0, 0b0011};
+    sched.worker = {0, 0b1000};
+    util::scheduling::set_config(sched);
+    util::scheduling::apply(util::scheduling::Band::ui);
+
     Application app {
       [&] { return std::make_unique<LogManager>(argc, argv); },
       StateManager::create_default,
@@ -43,6 +56,7 @@ int main(int argc, char* argv[])
     std::signal(SIGTERM, Application::handle_signal);
     std::signal(SIGINT, Application::handle_signal);
 
+    app.audio_manager->lock_memory();
     app.audio_manager->start();
     app.engine_manager->start();
     app.ui_manager->main_ui_loop();
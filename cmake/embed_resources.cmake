@@ -0,0 +1,40 @@
+# Generates a .cpp embedding binary files as linked read-only data.
+#
+# Run in script mode:
+#   cmake -DOUTPUT=<out.cpp> "-DSYMBOLS=<a;b;...>" "-DFILES=<f1;f2;...>"
+#         -P embed_resources.cmake
+#
+# Each file becomes a byte array in .rodata and a `Resource` named after its
+# symbol, declared in src/core/ui/embedded_fonts.hpp. The data is demand-paged
+# straight from the executable, so embedding costs no startup I/O and the
+# pages are shared between processes.
+
+if(NOT OUTPUT OR NOT SYMBOLS OR NOT FILES)
+    message(FATAL_ERROR "embed_resources.cmake needs OUTPUT, SYMBOLS and FILES")
+endif()
+
+list(LENGTH FILES file_count)
+list(LENGTH SYMBOLS symbol_count)
+if(NOT file_count EQUAL symbol_count)
+    message(FATAL_ERROR "embed_resources.cmake: got ${file_count} files but ${symbol_count} symbols")
+endif()
+
+set(body "// Generated by cmake/embed_resources.cmake - do not edit\n")
+string(APPEND body "#include \"core/ui/embedded_fonts.hpp\"\n\n")
+string(APPEND body "namespace otto::core::ui::vg::embedded {\n\n")
+
+math(EXPR last "${file_count} - 1")
+foreach(i RANGE ${last})
+    list(GET FILES ${i} file)
+    list(GET SYMBOLS ${i} symbol)
+    file(READ "${file}" hex HEX)
+    # Byte count - file(SIZE) needs a newer cmake than the project minimum
+    string(LENGTH "${hex}" hex_length)
+    math(EXPR size "${hex_length} / 2")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+    string(APPEND body "  static const unsigned char ${symbol}_data[] = {\n${bytes}\n  };\n")
+    string(APPEND body "  const Resource ${symbol} = {${symbol}_data, ${size}UL};\n\n")
+endforeach()
+
+string(APPEND body "} // namespace otto::core::ui::vg::embedded\n")
+file(WRITE "${OUTPUT}" "${body}")
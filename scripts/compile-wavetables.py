@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Compile loose wavetable wavs into a packed band-limited mipmap set.
+
+Reads every ``*.wav`` in ``data/wavetables/``, takes each file as one cycle,
+and writes per-octave band-limited mip levels - level ``m`` holds
+``base_size >> m`` frames with every harmonic at or above its Nyquist
+removed - into one packed file that ``otto::util::WavetableSet``
+(src/util/wavetable_set.hpp) memory-maps at runtime. Resampling and
+band-limiting both happen on the harmonic spectrum, so every level is an
+exact low-passed copy of the same cycle rather than a decimation of it.
+Stdlib only - run it whenever the source tables change:
+
+    scripts/compile-wavetables.py [--data-dir data]
+
+The output ``data/wavetables.otwt`` is written atomically. Format (all
+little-endian): a 24-byte header (magic "OTWT", version, table count, mip
+count, base size), 64-byte entries (56-byte name + payload offset in
+frames), then the raw float frames, levels of one table contiguous.
+"""
+
+import argparse
+import cmath
+import struct
+import sys
+import wave
+from pathlib import Path
+
+MAGIC = 0x4F545754  # "OTWT"
+VERSION = 1
+BASE_SIZE = 2048
+MIP_COUNT = 8
+NAME_LEN = 56
+
+
+def read_mono(path):
+    """Read a wav as mono floats in [-1, 1], first channel only."""
+    with wave.open(str(path), "rb") as w:
+        channels = w.getnchannels()
+        width = w.getsampwidth()
+        raw = w.readframes(w.getnframes())
+    if width == 2:
+        scale, fmt = 32768.0, "<%dh" % (len(raw) // 2)
+        data = [s / scale for s in struct.unpack(fmt, raw)]
+    elif width == 4:
+        scale, fmt = 2147483648.0, "<%di" % (len(raw) // 4)
+        data = [s / scale for s in struct.unpack(fmt, raw)]
+    elif width == 1:
+        data = [(b - 128) / 128.0 for b in raw]
+    else:
+        raise ValueError(f"{path}: unsupported sample width {width}")
+    return data[::channels]
+
+
+def fft(x):
+    """Radix-2 FFT. len(x) must be a power of two."""
+    n = len(x)
+    if n == 1:
+        return list(x)
+    even = fft(x[0::2])
+    odd = fft(x[1::2])
+    twiddled = [cmath.exp(-2j * cmath.pi * k / n) * odd[k] for k in range(n // 2)]
+    return [even[k] + twiddled[k] for k in range(n // 2)] + \
+           [even[k] - twiddled[k] for k in range(n // 2)]
+
+
+def compile_table(samples):
+    """Return the MIP_COUNT band-limited levels of one table."""
+    n = len(samples)
+    if n & (n - 1):
+        raise ValueError(f"table length {n} is not a power of two")
+    spectrum = fft([complex(s) for s in samples])
+    levels = []
+    for m in range(MIP_COUNT):
+        size = BASE_SIZE >> m
+        band = [0j] * size
+        # Keep harmonics strictly below the level's Nyquist. Bin 0 stays
+        # zero - tables are zero-mean by definition
+        for k in range(1, min(n // 2, size // 2)):
+            band[k] = spectrum[k]
+            band[size - k] = spectrum[k].conjugate()
+        # Inverse via the conjugation trick; the 1/size it needs folds into
+        # the 1/n that keeps harmonic amplitudes equal across levels
+        level = [v.conjugate().real / n for v in fft([v.conjugate() for v in band])]
+        levels.append(level)
+    # Normalize the whole family by the full-resolution peak so the levels
+    # stay mutually consistent
+    peak = max(abs(v) for v in levels[0])
+    if peak > 0:
+        levels = [[v / peak for v in lvl] for lvl in levels]
+    return levels
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--data-dir", type=Path, default=Path("data"),
+                        help="OTTO data directory (default: data)")
+    args = parser.parse_args()
+
+    sources = sorted((args.data_dir / "wavetables").glob("*.wav"))
+    if not sources:
+        sys.exit(f"no wavs in {args.data_dir / 'wavetables'}")
+
+    entries = []
+    payload = bytearray()
+    offset = 0
+    for src in sources:
+        levels = compile_table(read_mono(src))
+        name = src.stem.encode()[: NAME_LEN - 1]
+        entries.append(struct.pack(f"<{NAME_LEN}sII", name, offset, 0))
+        for level in levels:
+            payload += struct.pack(f"<{len(level)}f", *level)
+            offset += len(level)
+
+    dest = args.data_dir / "wavetables.otwt"
+    tmp = dest.with_suffix(".otwt.tmp")
+    with open(tmp, "wb") as f:
+        f.write(struct.pack("<6I", MAGIC, VERSION, len(entries), MIP_COUNT, BASE_SIZE, 0))
+        for entry in entries:
+            f.write(entry)
+        f.write(payload)
+    tmp.rename(dest)
+    print(f"{dest}: {len(entries)} tables x {MIP_COUNT} levels, base {BASE_SIZE} frames")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <exception>
 #include <functional>
 #include <gsl/span>
@@ -25,15 +26,28 @@ namespace otto::core::audio {
     using pointer = float*;
     using const_iterator = const float*;
 
-    AudioBufferHandle(float* data, std::size_t length, int& reference_count) noexcept
+    /// The refcount is atomic with relaxed ordering - handles to the same
+    /// buffer are copied and dropped across the audio and worker threads, and
+    /// the count only gates reuse inside the pool's allocation lock
+    AudioBufferHandle(float* data, std::size_t length, std::atomic<int>& reference_count) noexcept
       : _data(data), _length(length), _reference_count(&reference_count)
     {
-      (*_reference_count)++;
+      _reference_count->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Wrap a driver-owned buffer without copying it into the pool.
+    ///
+    /// The returned handle does not partake in reference counting - the caller
+    /// guarantees the buffer outlives the handle, which for the audio drivers means the
+    /// duration of one process callback. `release()` is a no-op on borrowed handles.
+    static AudioBufferHandle borrowed(float* data, std::size_t length) noexcept
+    {
+      return AudioBufferHandle(data, length);
     }
 
     ~AudioBufferHandle() noexcept
     {
-      if (_reference_count) (*_reference_count)--;
+      if (_reference_count) _reference_count->fetch_sub(1, std::memory_order_relaxed);
     }
 
     AudioBufferHandle(AudioBufferHandle&& rhs) noexcept
@@ -46,7 +60,7 @@ namespace otto::core::audio {
     AudioBufferHandle(const AudioBufferHandle& rhs) noexcept
       : _data(rhs._data), _length(rhs._length), _reference_count(rhs._reference_count)
     {
-      (*_reference_count)++;
+      if (_reference_count) _reference_count->fetch_add(1, std::memory_order_relaxed);
     }
 
     AudioBufferHandle& operator=(AudioBufferHandle&& rhs) noexcept
@@ -64,13 +78,14 @@ namespace otto::core::audio {
       _data = rhs._data;
       _length = rhs._length;
       _reference_count = rhs._reference_count;
-      (*_reference_count)++;
+      if (_reference_count) _reference_count->fetch_add(1, std::memory_order_relaxed);
       return *this;
     }
 
     int reference_count() const
     {
-      return *_reference_count;
+      // Borrowed handles are always considered uniquely owned
+      return _reference_count ? _reference_count->load(std::memory_order_relaxed) : 1;
     }
 
     float* data() const
@@ -112,7 +127,7 @@ namespace otto::core::audio {
 
     void release()
     {
-      (*_reference_count)--;
+      if (_reference_count) _reference_count->fetch_sub(1, std::memory_order_relaxed);
       _reference_count = nullptr;
       _data = nullptr;
     }
@@ -132,6 +147,7 @@ namespace otto::core::audio {
     AudioBufferHandle slice(int idx, int length = -1)
     {
       length = length < 0 ? _length - idx : length;
+      if (!_reference_count) return AudioBufferHandle(_data + idx, std::size_t(length));
       return {_data + idx, std::size_t(length), *_reference_count};
     }
 
@@ -146,9 +162,14 @@ namespace otto::core::audio {
     }
 
   private:
+    /// Constructor for borrowed (non-refcounted) handles, see {@ref borrowed}
+    AudioBufferHandle(float* data, std::size_t length) noexcept
+      : _data(data), _length(length), _reference_count(nullptr)
+    {}
+
     float* _data;
     std::size_t _length;
-    int* _reference_count;
+    std::atomic<int>* _reference_count;
   };
 
   struct AudioBufferPool {
@@ -160,24 +181,35 @@ namespace otto::core::audio {
       reserve(number_of_buffers);
     }
 
+    /// Claim a buffer without zeroing it.
+    ///
+    /// This is the hot-path acquire: the engine process calls overwrite the
+    /// whole buffer anyway, so the memset would be pure waste. Use
+    /// {@ref allocate_clear} when the consumer accumulates into the buffer
     AudioBufferHandle allocate() noexcept
     {
-      for (std::size_t i = 0; i < reference_counts.size(); i++) {
-        if (reference_counts[i] < 1) {
+      // Buffers can be allocated from the fx worker thread while the audio thread also
+      // allocates, so claiming a buffer is guarded by a short spin lock.
+      while (_allocation_lock.test_and_set(std::memory_order_acquire));
+      for (std::size_t i = 0; i < _avaliable_buffers; i++) {
+        if (reference_counts[i].load(std::memory_order_relaxed) < 1) {
           if (i > _max_val) {
             LOGI("Using {} buffers", i + 1);
             _max_val = i;
           }
-          reference_counts[i] = 0;
-          int index = i * buffer_size;
-          return {data.get() + index, buffer_size, reference_counts[i]};
+          reference_counts[i].store(0, std::memory_order_relaxed);
+          AudioBufferHandle res = {_arena + i * _stride, buffer_size, reference_counts[i]};
+          _allocation_lock.clear(std::memory_order_release);
+          return res;
         }
       }
+      _allocation_lock.clear(std::memory_order_release);
       // TODO: handle this reasonably
       LOGF("No free audio buffers found. This shouldn't happen");
       std::terminate();
     }
 
+    /// Claim a buffer and zero it - for consumers that mix into it
     AudioBufferHandle allocate_clear()
     {
       auto res = allocate();
@@ -203,18 +235,68 @@ namespace otto::core::audio {
       reserve(number_of_buffers);
     }
 
+    /// Number of buffers currently claimed.
+    ///
+    /// Sampled without the allocation lock, so the count can be momentarily
+    /// off - fine for the debug/soak sampling it exists for. Between blocks
+    /// it should read zero; a persistent nonzero value is a leaked handle
+    int in_use() const noexcept
+    {
+      int n = 0;
+      for (std::size_t i = 0; i < _avaliable_buffers; i++) {
+        n += reference_counts[i].load(std::memory_order_relaxed) > 0;
+      }
+      return n;
+    }
+
+    /// High-water mark of simultaneously claimed buffers over the session.
+    ///
+    /// Tracked by {@ref allocate} anyway for the "Using N buffers" log line,
+    /// so reading it here is free - the session report includes it
+    int peak_in_use() const noexcept
+    {
+      return int(_max_val + 1);
+    }
+
+    /// Touch every page of the arena, so the audio thread never takes a
+    /// first-touch fault on a freshly allocated buffer. Call before processing
+    /// starts - this writes through the whole arena
+    void prefault() noexcept
+    {
+      constexpr auto floats_per_line = cache_line_size / sizeof(float);
+      const auto total = _avaliable_buffers * _stride + floats_per_line;
+      for (std::size_t i = 0; i < total; i += 1024) _storage[i] = 0;
+      if (total > 0) _storage[total - 1] = 0;
+    }
+
   private:
+    /// The alignment of each buffer in the arena. One cache line, so buffers processed
+    /// on different cores never share a line.
+    static constexpr std::size_t cache_line_size = 64;
+
     void reserve(std::size_t n) noexcept
     {
-      data = std::make_unique<float[]>(n * buffer_size);
+      // All buffers live in a single arena, with each buffer rounded up to a whole
+      // number of cache lines
+      constexpr auto floats_per_line = cache_line_size / sizeof(float);
+      _stride = (buffer_size + floats_per_line - 1) / floats_per_line * floats_per_line;
+      _storage = std::make_unique<float[]>(n * _stride + floats_per_line);
+      auto addr = reinterpret_cast<std::uintptr_t>(_storage.get());
+      auto misalign = addr % cache_line_size;
+      _arena = _storage.get() + (misalign == 0 ? 0 : (cache_line_size - misalign) / sizeof(float));
       _avaliable_buffers = n;
-      reference_counts.resize(_avaliable_buffers, 0);
+      // Atomics are not movable, so the counts are rebuilt, not resized. This
+      // only runs while audio is stopped
+      reference_counts = std::vector<std::atomic<int>>(_avaliable_buffers);
     }
 
     std::size_t buffer_size;
-    std::vector<int> reference_counts;
+    std::size_t _stride = 0;
+    std::atomic_flag _allocation_lock = ATOMIC_FLAG_INIT;
+    std::vector<std::atomic<int>> reference_counts;
     std::size_t _avaliable_buffers = 0;
-    std::unique_ptr<float[]> data;
+    std::unique_ptr<float[]> _storage;
+    float* _arena = nullptr;
     std::size_t _max_val = -1;
   };
 }
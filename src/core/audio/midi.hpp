@@ -15,7 +15,64 @@ namespace otto::core::midi {
 
   namespace detail {
 
-    inline double freq_table[128];
+    /// `2^(1/12)` - the frequency ratio of one equal-tempered semitone
+    constexpr double semitone_ratio = 1.0594630943592952646;
+    /// `2^(1/(12*256))` - one step of {@ref semitone_steps}
+    constexpr double semitone_step_ratio = 1.0002256593050698041;
+
+    /// Note frequencies for the given tuning, walked multiplicatively from
+    /// the reference note.
+    ///
+    /// Constexpr - `pow` is not, so the table is built by repeated
+    /// multiplication with {@ref semitone_ratio}. The accumulated error over
+    /// the 59 steps to either end is orders of magnitude below float
+    /// precision
+    constexpr std::array<float, 128> make_freq_table(double tuning) noexcept
+    {
+      std::array<float, 128> res = {};
+      res[69] = float(tuning);
+      double f = tuning;
+      for (int i = 70; i < 128; i++) {
+        f *= semitone_ratio;
+        res[i] = float(f);
+      }
+      f = tuning;
+      for (int i = 68; i >= 0; i--) {
+        f /= semitone_ratio;
+        res[i] = float(f);
+      }
+      return res;
+    }
+
+    constexpr std::array<float, 257> make_semitone_steps() noexcept
+    {
+      std::array<float, 257> res = {};
+      double r = 1;
+      for (int i = 0; i < 257; i++) {
+        res[i] = float(r);
+        r *= semitone_step_ratio;
+      }
+      return res;
+    }
+
+    /// The standard-tuning note table, baked in at compile time
+    constexpr std::array<float, 128> standard_freq_table = make_freq_table(440);
+
+    /// Note frequencies at the current tuning, as floats for the audio path.
+    ///
+    /// Constant-initialized to standard tuning, so startup does no table
+    /// work - {@ref generateFreqTable} rewrites it only when a non-440
+    /// tuning is requested
+    inline std::array<float, 128> freq_table = standard_freq_table;
+
+    /// Frequency ratios of one semitone split into 256 steps - `2^(i/(12*256))`.
+    ///
+    /// Together with `freq_table` this makes fractional-note frequency math
+    /// table driven: integer part from `freq_table`, cents from here, one
+    /// lerp between adjacent entries. The extra entry at the end lets the
+    /// lerp read `[i + 1]` unconditionally. Tuning-independent, so fully
+    /// constexpr and in read-only memory
+    constexpr std::array<float, 257> semitone_steps = make_semitone_steps();
 
     constexpr std::array<const char*, 128> note_names = {
       {"C-2", "C#-2", "D-2", "D#-2", "E-2", "F-2", "F#-2", "G-2", "G#-2", "A-2", "A#-2", "B-2",
@@ -145,7 +202,9 @@ namespace otto::core::midi {
     int controler = 0;
     int value = 0;
 
-    ControlChangeEvent(int controler, int value) : controler(controler), value(value) {}
+    ControlChangeEvent(int controler, int value)
+      : MidiEvent{Type::ControlChange, 0, 0}, controler(controler), value(value)
+    {}
     ControlChangeEvent(const MidiEvent& event) : MidiEvent(event) {}
 
     std::array<byte, 3> to_bytes()
@@ -165,7 +224,7 @@ namespace otto::core::midi {
   struct PitchBendEvent : public MidiEvent {
     int value = 0;
 
-    PitchBendEvent(int value) : value(value) {}
+    PitchBendEvent(int value) : MidiEvent{Type::PitchBend, 0, 0}, value(value) {}
     PitchBendEvent(const MidiEvent& event) : MidiEvent(event){};
 
     static PitchBendEvent from_bytes(gsl::span<byte> bytes, int time = 0)
@@ -178,9 +237,107 @@ namespace otto::core::midi {
     }
   };
 
+  /// Variant form of a midi event.
+  ///
+  /// Used at the cold edges - byte parsing and the cross-thread input queue.
+  /// Inside a block the events live as {@ref PackedMidiEvent} instead
   using AnyMidiEvent =
     mpark::variant<MidiEvent, NoteOnEvent, NoteOffEvent, ControlChangeEvent, PitchBendEvent>;
 
+  /// Flat POD form of one midi event - what the block arena stores.
+  ///
+  /// Eight bytes: type nibble, channel, the two data bytes and the frame
+  /// offset. Events are packed once at the block edge, so sorting,
+  /// partitioning and dispatch on the audio thread are plain member access
+  /// and a switch - no variant visit, no vtable
+  struct PackedMidiEvent {
+    using byte = MidiEvent::byte;
+
+    /// Raw {@ref MidiEvent::Type} nibble
+    byte type = 0;
+    byte channel = 0;
+    /// key / controller number / bend lsb
+    byte data0 = 0;
+    /// velocity / controller value / bend msb
+    byte data1 = 0;
+    int time = 0;
+
+    std::array<byte, 3> to_bytes() const noexcept
+    {
+      return {byte((type << 4) | channel), data0, data1};
+    }
+  };
+
+  inline PackedMidiEvent pack(const MidiEvent& e) noexcept
+  {
+    return {PackedMidiEvent::byte(e.type), PackedMidiEvent::byte(e.channel), 0, 0, e.time};
+  }
+
+  inline PackedMidiEvent pack(const NoteEvent& e) noexcept
+  {
+    return {PackedMidiEvent::byte(e.type), PackedMidiEvent::byte(e.channel), e.key, e.velocity,
+            e.time};
+  }
+
+  inline PackedMidiEvent pack(const ControlChangeEvent& e) noexcept
+  {
+    return {PackedMidiEvent::byte(e.type), PackedMidiEvent::byte(e.channel),
+            PackedMidiEvent::byte(e.controler), PackedMidiEvent::byte(e.value), e.time};
+  }
+
+  inline PackedMidiEvent pack(const PitchBendEvent& e) noexcept
+  {
+    return {PackedMidiEvent::byte(e.type), PackedMidiEvent::byte(e.channel),
+            PackedMidiEvent::byte(e.value & 0x7F), PackedMidiEvent::byte((e.value >> 7) & 0x7F),
+            e.time};
+  }
+
+  inline PackedMidiEvent pack(const AnyMidiEvent& e) noexcept
+  {
+    return mpark::visit([](const auto& ev) { return pack(ev); }, e);
+  }
+
+  /// Materialize the concrete event type from its packed form.
+  ///
+  /// The caller picks the type - {@ref events_of_type} guarantees it matches
+  template<typename Event>
+  Event unpack(const PackedMidiEvent&) noexcept;
+
+  template<>
+  inline NoteOnEvent unpack<NoteOnEvent>(const PackedMidiEvent& e) noexcept
+  {
+    auto res = NoteOnEvent(MidiEvent{MidiEvent::Type(e.type), e.channel, e.time});
+    res.key = e.data0;
+    res.velocity = e.data1;
+    return res;
+  }
+
+  template<>
+  inline NoteOffEvent unpack<NoteOffEvent>(const PackedMidiEvent& e) noexcept
+  {
+    auto res = NoteOffEvent(MidiEvent{MidiEvent::Type(e.type), e.channel, e.time});
+    res.key = e.data0;
+    res.velocity = e.data1;
+    return res;
+  }
+
+  template<>
+  inline ControlChangeEvent unpack<ControlChangeEvent>(const PackedMidiEvent& e) noexcept
+  {
+    auto res = ControlChangeEvent(MidiEvent{MidiEvent::Type(e.type), e.channel, e.time});
+    res.controler = e.data0;
+    res.value = e.data1;
+    return res;
+  }
+
+  template<>
+  inline PitchBendEvent unpack<PitchBendEvent>(const PackedMidiEvent& e) noexcept
+  {
+    auto res = PitchBendEvent(MidiEvent{MidiEvent::Type(e.type), e.channel, e.time});
+    res.value = (int(e.data1) << 7) | int(e.data0);
+    return res;
+  }
+
   inline AnyMidiEvent from_bytes(gsl::span<unsigned char> bytes, int time = 0)
   {
     if (bytes.size() < 3) throw util::exception("Midi event size must be >= 3 bytes");
@@ -201,10 +358,18 @@ namespace otto::core::midi {
     }
   }
 
+  /// Retune the note table.
+  ///
+  /// The standard-tuning table is baked in at compile time, so this only has
+  /// work to do for non-440 tunings
   inline void generateFreqTable(double tuning = 440)
   {
+    if (tuning == 440) {
+      detail::freq_table = detail::standard_freq_table;
+      return;
+    }
     for (int i = 0; i < 128; i++) {
-      detail::freq_table[i] = tuning * std::pow(2.0, double(i - 69) / double(12));
+      detail::freq_table[i] = float(tuning * std::pow(2.0, double(i - 69) / double(12)));
     }
   }
 
@@ -218,114 +383,275 @@ namespace otto::core::midi {
     return detail::freq_table[key];
   }
 
-  template<typename T, typename Allocator = std::allocator<T>>
-  struct shared_vector {
-    using value_type = T;
-    using vector_type = std::vector<T, Allocator>;
-    using allocator_type = Allocator;
-    using iterator = typename vector_type::iterator;
-
-    shared_vector() = default;
-
-    shared_vector(vector_type&& other) : _data(std::make_shared<vector_type>(std::move(other))) {}
-
-    shared_vector(const vector_type& other) : _data(std::make_shared<vector_type>(other)) {}
-
-    shared_vector(const allocator_type& alloc) : _data(std::make_shared<vector_type>(alloc)) {}
+  /// Frequency of a fractional midi note, table driven - no libm calls.
+  ///
+  /// Integer part from the note table, fraction from the semitone step table
+  /// with a lerp between adjacent steps. Error well below a hundredth of a
+  /// cent, so usable for bends and detune on the hot paths
+  inline float note_freq(float note) noexcept
+  {
+    note = std::clamp(note, 0.f, 127.f);
+    const int n = int(note);
+    const float x = (note - float(n)) * 256.f;
+    const int i = int(x);
+    const float t = x - float(i);
+    const float ratio =
+      detail::semitone_steps[i] + (detail::semitone_steps[i + 1] - detail::semitone_steps[i]) * t;
+    return detail::freq_table[n] * ratio;
+  }
 
-    bool empty() const {
-      return _data->empty();
-    }
+  /// Frequency ratio of a fractional semitone interval, table driven.
+  ///
+  /// `interval_ratio(1) == 2^(1/12)`, `interval_ratio(-12) == 0.5` etc.
+  /// Covers intervals in `[-69, 58]` semitones
+  inline float interval_ratio(float semitones) noexcept
+  {
+    return note_freq(69.f + semitones) * float(1.0 / detail::freq_table[69]);
+  }
 
-    auto begin()
+  /// Fixed-capacity inline storage for one block of midi events.
+  ///
+  /// Owned by the audio manager next to the buffer pool, and reset every
+  /// callback - event passing does no heap allocation on the audio thread.
+  /// {@ref EventBuffer} is the non-owning view that `ProcessData` carries
+  struct EventArena {
+    /// Matches the size of the midi input queue - more events than this in
+    /// one block means something upstream is dropping already
+    static constexpr std::size_t capacity = 256;
+
+    using value_type = PackedMidiEvent;
+    using iterator = PackedMidiEvent*;
+    using const_iterator = const PackedMidiEvent*;
+
+    iterator begin() noexcept
     {
-      return _data->begin();
+      return _storage.data();
     }
-    auto end()
+    iterator end() noexcept
     {
-      return _data->end();
+      return _storage.data() + _length;
     }
-    auto begin() const
+    const_iterator begin() const noexcept
     {
-      return _data->begin();
+      return _storage.data();
     }
-    auto end() const
+    const_iterator end() const noexcept
     {
-      return _data->end();
+      return _storage.data() + _length;
     }
-    auto cbegin() const
+
+    bool empty() const noexcept
     {
-      return _data->cbegin();
+      return _length == 0;
     }
-    auto cend() const
+    std::size_t size() const noexcept
     {
-      return _data->cend();
+      return _length;
     }
 
-    auto&& front()
+    void clear() noexcept
     {
-      return _data->front();
+      _length = 0;
     }
-    auto&& back()
+
+    void push_back(const PackedMidiEvent& ev) noexcept
     {
-      return _data->back();
+      // Dropping an event beats allocating on the audio thread
+      if (_length == capacity) return;
+      _storage[_length++] = ev;
     }
-    auto&& front() const
+
+    /// Accepts any of the concrete event types (or {@ref AnyMidiEvent}),
+    /// packing at the boundary so the caller never touches the packed form
+    template<typename Event>
+    void push_back(const Event& ev) noexcept
     {
-      return _data->front();
+      push_back(pack(ev));
     }
-    auto&& back() const
+
+    template<typename Event>
+    void emplace_back(Event&& ev) noexcept
     {
-      return _data->back();
+      push_back(std::forward<Event>(ev));
     }
 
-    auto& operator*()
+  private:
+    std::array<PackedMidiEvent, capacity> _storage = {};
+    std::size_t _length = 0;
+  };
+
+  /// Non-owning view of the events in an {@ref EventArena}.
+  ///
+  /// Trivially copyable - no shared ownership, no heap. A default-constructed
+  /// buffer is empty and silently drops pushes
+  struct EventBuffer {
+    using value_type = PackedMidiEvent;
+    using iterator = PackedMidiEvent*;
+
+    EventBuffer() = default;
+    EventBuffer(EventArena& arena) noexcept : _arena(&arena) {}
+
+    iterator begin() const noexcept
     {
-      return *_data;
+      return _arena ? _arena->begin() : nullptr;
     }
-    auto& operator*() const
+    iterator end() const noexcept
     {
-      return *_data;
+      return _arena ? _arena->end() : nullptr;
     }
 
-    auto& operator-> ()
+    bool empty() const noexcept
     {
-      return &*_data;
+      return begin() == end();
     }
-    auto& operator-> () const
+    std::size_t size() const noexcept
     {
-      return &*_data;
+      return end() - begin();
     }
 
-    auto& operator[](std::size_t i)
+    PackedMidiEvent& front() const noexcept
     {
-      return (_data)[i];
+      return *begin();
     }
-
-    auto clear()
+    PackedMidiEvent& back() const noexcept
     {
-      _data->clear();
+      return *(end() - 1);
     }
 
-    auto push_back(const value_type& el)
+    void clear() const noexcept
     {
-      _data->push_back(el);
+      if (_arena) _arena->clear();
     }
 
-    template<typename... Ref>
-    auto&& emplace_back(Ref&&... args)
+    template<typename Event>
+    void push_back(const Event& ev) const noexcept
     {
-      return _data->emplace_back(std::forward<Ref>(args)...);
+      if (_arena) _arena->push_back(ev);
     }
 
-    auto&& move_vector_out()
+    template<typename Event>
+    void emplace_back(Event&& ev) const noexcept
     {
-      return std::move(*_data);
+      if (_arena) _arena->emplace_back(std::forward<Event>(ev));
     }
 
   private:
-    std::shared_ptr<vector_type> _data = std::make_shared<vector_type>();
+    EventArena* _arena = nullptr;
   };
 
+  namespace detail {
+    /// Partition rank of each event type.
+    ///
+    /// Note-offs sort before note-ons: the sequencers retrigger a key by
+    /// sending its off and on in the same block, and the off has to land
+    /// first or it would kill the fresh note. The cost is that a key pressed
+    /// and released within one block loses its release - a sub-block tap is
+    /// rare enough to accept
+    template<typename Event>
+    struct event_rank;
+    template<>
+    struct event_rank<NoteOffEvent> : std::integral_constant<int, 0> {};
+    template<>
+    struct event_rank<NoteOnEvent> : std::integral_constant<int, 1> {};
+    template<>
+    struct event_rank<ControlChangeEvent> : std::integral_constant<int, 2> {};
+    template<>
+    struct event_rank<PitchBendEvent> : std::integral_constant<int, 3> {};
+  } // namespace detail
+
+  /// Partition rank of an event. See {@ref detail::event_rank}
+  inline int event_order(const PackedMidiEvent& event) noexcept
+  {
+    switch (MidiEvent::Type(event.type)) {
+    case MidiEvent::Type::NoteOff: return 0;
+    case MidiEvent::Type::NoteOn: return 1;
+    case MidiEvent::Type::ControlChange: return 2;
+    case MidiEvent::Type::PitchBend: return 3;
+    default: return 4;
+    }
+  }
+
+  /// Sort a block's events into typed spans - by type rank first, then frame
+  /// offset within each type.
+  ///
+  /// Called once per block by the audio driver after gathering input, so
+  /// consumers can iterate the spans from {@ref events_of_type} instead of
+  /// matching on the variant for every event
+  inline void preprocess_events(EventBuffer events) noexcept
+  {
+    std::sort(events.begin(), events.end(),
+              [](const PackedMidiEvent& a, const PackedMidiEvent& b) {
+                int ra = event_order(a);
+                int rb = event_order(b);
+                if (ra != rb) return ra < rb;
+                return a.time < b.time;
+              });
+  }
+
+  /// A span of events of a single known type within a preprocessed block.
+  ///
+  /// Iteration materializes the concrete event type by value from the
+  /// packed form - no visit, no branch
+  template<typename Event>
+  struct typed_event_range {
+    using base_iterator = EventBuffer::iterator;
+
+    struct iterator {
+      base_iterator it;
+
+      Event operator*() const
+      {
+        return unpack<Event>(*it);
+      }
+      iterator& operator++()
+      {
+        ++it;
+        return *this;
+      }
+      bool operator==(const iterator& r) const
+      {
+        return it == r.it;
+      }
+      bool operator!=(const iterator& r) const
+      {
+        return it != r.it;
+      }
+    };
+
+    iterator begin() const
+    {
+      return {first};
+    }
+    iterator end() const
+    {
+      return {last};
+    }
+    bool empty() const
+    {
+      return first == last;
+    }
+    std::size_t size() const
+    {
+      return last - first;
+    }
+
+    base_iterator first;
+    base_iterator last;
+  };
+
+  /// Get the span of events of one type from a block preprocessed with
+  /// {@ref preprocess_events}
+  template<typename Event>
+  typed_event_range<Event> events_of_type(EventBuffer events) noexcept
+  {
+    constexpr int rank = detail::event_rank<Event>::value;
+    auto first =
+      std::lower_bound(events.begin(), events.end(), rank,
+                       [](const PackedMidiEvent& e, int r) { return event_order(e) < r; });
+    auto last =
+      std::upper_bound(first, events.end(), rank,
+                       [](int r, const PackedMidiEvent& e) { return r < event_order(e); });
+    return {first, last};
+  }
 
 } // namespace otto::core::midi
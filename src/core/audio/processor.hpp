@@ -35,12 +35,12 @@ namespace otto::core::audio {
     static constexpr int channels = N;
 
     std::array<AudioBufferHandle, channels> audio;
-    midi::shared_vector<midi::AnyMidiEvent> midi;
+    midi::EventBuffer midi;
     clock::ClockRange clock;
     long nframes;
 
     ProcessData(std::array<AudioBufferHandle, channels> audio,
-                midi::shared_vector<midi::AnyMidiEvent> midi = {},
+                midi::EventBuffer midi = {},
                 clock::ClockRange clock = {}) noexcept;
 
     ProcessData<0> midi_only();
@@ -71,12 +71,12 @@ namespace otto::core::audio {
   struct ProcessData<0> {
     static constexpr int channels = 0;
 
-    midi::shared_vector<midi::AnyMidiEvent> midi;
+    midi::EventBuffer midi;
     clock::ClockRange clock;
     long nframes;
 
-    ProcessData(midi::shared_vector<midi::AnyMidiEvent> midi, clock::ClockRange clock, long nframes) noexcept;
-    ProcessData(midi::shared_vector<midi::AnyMidiEvent> midi, long nframes) noexcept : ProcessData(midi, {}, nframes) {}
+    ProcessData(midi::EventBuffer midi, clock::ClockRange clock, long nframes) noexcept;
+    ProcessData(midi::EventBuffer midi, long nframes) noexcept : ProcessData(midi, {}, nframes) {}
 
     template<std::size_t NN>
     ProcessData<NN> with(const std::array<AudioBufferHandle, NN>& buf);
@@ -91,16 +91,16 @@ namespace otto::core::audio {
     static constexpr int channels = 1;
 
     AudioBufferHandle audio;
-    midi::shared_vector<midi::AnyMidiEvent> midi;
+    midi::EventBuffer midi;
     clock::ClockRange clock;
     long nframes;
 
     ProcessData(AudioBufferHandle audio,
-                midi::shared_vector<midi::AnyMidiEvent> midi = {},
+                midi::EventBuffer midi = {},
                 clock::ClockRange clock = {}) noexcept;
 
     ProcessData(std::array<AudioBufferHandle, channels> audio,
-                midi::shared_vector<midi::AnyMidiEvent> midi = {},
+                midi::EventBuffer midi = {},
                 clock::ClockRange clock = {}) noexcept
       : ProcessData(audio[0], midi, clock)
     {}
@@ -5,7 +5,7 @@ namespace otto::core::audio {
 
   template<int N>
   ProcessData<N>::ProcessData(std::array<AudioBufferHandle, channels> audio,
-                              midi::shared_vector<midi::AnyMidiEvent> midi,
+                              midi::EventBuffer midi,
                               clock::ClockRange clock) noexcept
     : audio(audio), midi(midi), clock(clock), nframes(audio[0].size())
   {}
@@ -60,7 +60,7 @@ namespace otto::core::audio {
 
   // ProcessData<0> //
 
-  inline ProcessData<0>::ProcessData(midi::shared_vector<midi::AnyMidiEvent> midi,
+  inline ProcessData<0>::ProcessData(midi::EventBuffer midi,
                                      clock::ClockRange clock,
                                      long nframes) noexcept
     : midi(midi), clock(clock), nframes(nframes)
@@ -85,7 +85,7 @@ namespace otto::core::audio {
   // ProcessDaata<1> //
 
   inline ProcessData<1>::ProcessData(AudioBufferHandle audio,
-                                     midi::shared_vector<midi::AnyMidiEvent> midi,
+                                     midi::EventBuffer midi,
                                      clock::ClockRange clock) noexcept
     : audio(audio), midi(midi), clock(clock), nframes(audio.size())
   {}
@@ -0,0 +1,121 @@
+#include "routing_graph.hpp"
+
+#include <algorithm>
+
+#include "services/log_manager.hpp"
+
+namespace otto::core::audio {
+
+  int RoutingGraph::add_node(util::string_ref name, int channels, bool in_place)
+  {
+    if (nodes() >= max_nodes) return -1;
+    _nodes.push_back({name, channels, in_place});
+    return nodes() - 1;
+  }
+
+  bool RoutingGraph::add_edge(int from, int to)
+  {
+    if (int(_edges.size()) >= max_edges) return false;
+    if (from < 0 || from >= nodes() || to < 0 || to >= nodes() || from == to) return false;
+    _edges.push_back({from, to});
+    return true;
+  }
+
+  bool RoutingGraph::schedule()
+  {
+    const int n = nodes();
+    _order.clear();
+    _peak_buffers = 0;
+    _fused_passes = 0;
+
+    // Topological order (Kahn). Ready nodes are taken in declaration order,
+    // so the schedule is deterministic and follows the declaration where the
+    // graph allows it
+    std::vector<int> indegree(n, 0);
+    for (const auto& e : _edges) indegree[e.to]++;
+    std::vector<bool> scheduled(n, false);
+    while (int(_order.size()) < n) {
+      int next = -1;
+      for (int i = 0; i < n; i++) {
+        if (!scheduled[i] && indegree[i] == 0) {
+          next = i;
+          break;
+        }
+      }
+      if (next < 0) return false; // cycle
+      scheduled[next] = true;
+      _order.push_back(next);
+      for (const auto& e : _edges) {
+        if (e.from == next) indegree[e.to]--;
+      }
+    }
+
+    // Buffer groups: a node producing audio claims fresh slots, an in-place
+    // node joins the group of its first audio input - that edge is a fused
+    // pass, costing no slots of its own
+    std::vector<int> group(n, -1);
+    std::vector<int> pos_of(n, 0);
+    for (int pos = 0; pos < n; pos++) pos_of[_order[pos]] = pos;
+    for (int pos = 0; pos < n; pos++) {
+      const int node = _order[pos];
+      if (_nodes[node].channels == 0) continue;
+      group[node] = node;
+      if (!_nodes[node].in_place) continue;
+      for (const auto& e : _edges) {
+        if (e.to == node && group[e.from] >= 0) {
+          group[node] = group[e.from];
+          _fused_passes++;
+          break;
+        }
+      }
+    }
+
+    // Liveness: a group's slots are claimed when its first member runs and
+    // released after the last consumer of any member has run. The peak of the
+    // walk is the chain's pool demand
+    std::vector<int> claim_at(n, 0);  // slots claimed before position runs
+    std::vector<int> release_at(n, 0); // slots released after position ran
+    std::vector<int> group_channels(n, 0);
+    std::vector<int> group_release(n, 0);
+    for (int pos = 0; pos < n; pos++) {
+      const int node = _order[pos];
+      const int g = group[node];
+      if (g < 0) continue;
+      // A growing group (mono producer, stereo in-place consumer) claims the
+      // extra slots where it grows
+      const int grown = std::max(_nodes[node].channels, group_channels[g]);
+      claim_at[pos] += grown - group_channels[g];
+      group_channels[g] = grown;
+      group_release[g] = std::max(group_release[g], pos);
+      for (const auto& e : _edges) {
+        if (e.from == node && group[e.to] != g) {
+          group_release[g] = std::max(group_release[g], pos_of[e.to]);
+        }
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      if (group[i] == i) release_at[group_release[i]] += group_channels[i];
+    }
+    int live = 0;
+    for (int pos = 0; pos < n; pos++) {
+      live += claim_at[pos];
+      _peak_buffers = std::max(_peak_buffers, live);
+      live -= release_at[pos];
+    }
+    return true;
+  }
+
+  void RoutingGraph::log_schedule() const
+  {
+    std::string line;
+    for (const int node : _order) {
+      if (!line.empty()) line += " -> ";
+      line += _nodes[node].name.c_str();
+      if (_nodes[node].in_place) line += "*";
+    }
+    LOGI("Routing schedule: {}", line);
+    LOGI("  {} stages, {} fused passes, peak {} pool buffers", nodes(), fused_passes(),
+         peak_buffers());
+  }
+
+} // namespace otto::core::audio
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "util/string_ref.hpp"
+
+namespace otto::core::audio {
+
+  /// Declarative model of an audio processing chain.
+  ///
+  /// Nodes are the stages of {@ref services::EngineManager::process}, edges
+  /// the buffers flowing between them, all declared once at startup. A single
+  /// pass over the declaration computes the topological schedule, fuses
+  /// in-place consumers into their producer's buffer, and assigns pool slots
+  /// by liveness - so the peak {@ref AudioBufferPool} demand of the chain is
+  /// known (and checked) before the first block, instead of discovered from
+  /// the "Using N buffers" log under load. The hand-fused process call is the
+  /// executor; this is the schedule it must agree with.
+  struct RoutingGraph {
+    static constexpr int max_nodes = 16;
+    static constexpr int max_edges = 32;
+
+    /// Add a stage producing `channels` audio buffers (0 for midi-only
+    /// stages). An `in_place` stage consumes its first input's buffers and
+    /// writes the result into them - a fused pass, costing no extra slots.
+    ///
+    /// \returns the node index, or `-1` when the graph is full
+    int add_node(util::string_ref name, int channels, bool in_place = false);
+
+    /// Declare that `to` consumes the output of `from`.
+    ///
+    /// \returns `false` when the graph is full or an index is invalid
+    bool add_edge(int from, int to);
+
+    /// Compute the schedule. \returns `false` on a cycle
+    bool schedule();
+
+    /// Node index at position `pos` of the schedule.
+    ///
+    /// \preconditions `schedule()` returned `true` and `0 <= pos < nodes()`
+    int order(int pos) const noexcept { return _order[pos]; }
+
+    int nodes() const noexcept { return int(_nodes.size()); }
+
+    /// Most pool buffers live at once under the computed schedule
+    int peak_buffers() const noexcept { return _peak_buffers; }
+
+    /// Edges fused into their producer's buffer by in-place consumers
+    int fused_passes() const noexcept { return _fused_passes; }
+
+    /// Log the schedule, the per-stage buffer counts and the peak demand
+    void log_schedule() const;
+
+  private:
+    struct Node {
+      util::string_ref name;
+      int channels = 0;
+      bool in_place = false;
+    };
+    struct Edge {
+      int from = -1;
+      int to = -1;
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<Edge> _edges;
+    std::vector<int> _order;
+    int _peak_buffers = 0;
+    int _fused_passes = 0;
+  };
+
+} // namespace otto::core::audio
@@ -0,0 +1,226 @@
+#include "sample_analysis.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/audio/waveform.hpp"
+
+namespace otto::core::audio {
+
+  namespace {
+    /// Header of the sidecar format. Followed directly by the bin floats
+    struct SidecarHeader {
+      static constexpr std::uint32_t magic_value = 0x4F545341; // "OTSA"
+      static constexpr std::uint32_t version_value = 1;
+      std::uint32_t magic = magic_value;
+      std::uint32_t version = version_value;
+      std::uint64_t source_id = 0;
+      std::uint32_t frames = 0;
+      std::uint32_t bin_count = 0;
+      float rms = 0;
+      std::uint32_t trim_start = 0;
+      std::uint32_t trim_end = 0;
+      std::uint32_t reserved = 0;
+    };
+
+    /// -60 dB - below this a frame counts as leading/trailing silence
+    constexpr float trim_threshold = 1e-3f;
+
+    fs::path sidecar_path(const fs::path& cache_dir, const std::string& key)
+    {
+      // Keys can contain kit/entry separators - flatten to one file name
+      std::string name = key;
+      std::replace(name.begin(), name.end(), '/', '_');
+      return cache_dir / (name + ".ota");
+    }
+  } // namespace
+
+  SampleAnalysis SampleAnalysis::analyze(const float* data, std::uint32_t frames)
+  {
+    SampleAnalysis res;
+    res.peak_bins.reserve((frames + Waveform::bin_size - 1) / Waveform::bin_size);
+    double square_sum = 0;
+    std::uint32_t first = frames;
+    std::uint32_t last = 0;
+    for (std::uint32_t start = 0; start < frames; start += Waveform::bin_size) {
+      const auto len = std::min<std::uint32_t>(Waveform::bin_size, frames - start);
+      float max = 0.f;
+      for (std::uint32_t i = 0; i < len; i++) {
+        const float f = std::abs(data[start + i]);
+        max = std::max(f, max);
+        square_sum += double(f) * double(f);
+        if (f > trim_threshold) {
+          first = std::min(first, start + i);
+          last = start + i + 1;
+        }
+      }
+      res.peak_bins.push_back(max);
+    }
+    res.rms = frames > 0 ? float(std::sqrt(square_sum / double(frames))) : 0.f;
+    res.trim_start = first == frames ? 0 : first;
+    res.trim_end = last;
+    return res;
+  }
+
+  std::uint64_t SampleAnalysis::source_id_of(const fs::path& file) noexcept
+  {
+    struct stat st;
+    if (::stat(file.string().c_str(), &st) != 0) return 0;
+    return std::uint64_t(st.st_size) ^ (std::uint64_t(st.st_mtime) << 20);
+  }
+
+  bool SampleAnalysis::load_cached(const fs::path& cache_dir,
+                                   const std::string& key,
+                                   std::uint64_t source_id,
+                                   std::uint32_t frames,
+                                   SampleAnalysis& out)
+  {
+    std::FILE* f = std::fopen(sidecar_path(cache_dir, key).string().c_str(), "rb");
+    if (f == nullptr) return false;
+    SidecarHeader header;
+    if (std::fread(&header, sizeof(header), 1, f) != 1 ||
+        header.magic != SidecarHeader::magic_value ||
+        header.version != SidecarHeader::version_value || header.source_id != source_id ||
+        header.frames != frames ||
+        header.bin_count != (frames + Waveform::bin_size - 1) / Waveform::bin_size) {
+      std::fclose(f);
+      return false;
+    }
+    std::vector<float> bins(header.bin_count);
+    if (std::fread(bins.data(), sizeof(float), bins.size(), f) != bins.size()) {
+      std::fclose(f);
+      return false;
+    }
+    std::fclose(f);
+    out.peak_bins = std::move(bins);
+    out.rms = header.rms;
+    out.trim_start = header.trim_start;
+    out.trim_end = header.trim_end;
+    return true;
+  }
+
+  bool SampleAnalysis::save_cached(const fs::path& cache_dir,
+                                   const std::string& key,
+                                   std::uint64_t source_id,
+                                   std::uint32_t frames,
+                                   const SampleAnalysis& analysis)
+  {
+    std::error_code ec;
+    fs::create_directories(cache_dir, ec);
+    SidecarHeader header;
+    header.source_id = source_id;
+    header.frames = frames;
+    header.bin_count = std::uint32_t(analysis.peak_bins.size());
+    header.rms = analysis.rms;
+    header.trim_start = analysis.trim_start;
+    header.trim_end = analysis.trim_end;
+    const auto dest = sidecar_path(cache_dir, key);
+    const auto tmp = dest.string() + ".tmp";
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (f == nullptr) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && std::fwrite(analysis.peak_bins.data(), sizeof(float), analysis.peak_bins.size(), f) ==
+                 analysis.peak_bins.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+    return std::rename(tmp.c_str(), dest.string().c_str()) == 0;
+  }
+
+  MappedSampleAnalysis::MappedSampleAnalysis(MappedSampleAnalysis&& rhs) noexcept
+    : _map_base(rhs._map_base),
+      _map_length(rhs._map_length),
+      _bins(rhs._bins),
+      _bin_count(rhs._bin_count),
+      _rms(rhs._rms),
+      _trim_start(rhs._trim_start),
+      _trim_end(rhs._trim_end)
+  {
+    rhs._map_base = nullptr;
+    rhs._map_length = 0;
+    rhs._bins = nullptr;
+    rhs._bin_count = 0;
+  }
+
+  MappedSampleAnalysis& MappedSampleAnalysis::operator=(MappedSampleAnalysis&& rhs) noexcept
+  {
+    unmap();
+    _map_base = rhs._map_base;
+    _map_length = rhs._map_length;
+    _bins = rhs._bins;
+    _bin_count = rhs._bin_count;
+    _rms = rhs._rms;
+    _trim_start = rhs._trim_start;
+    _trim_end = rhs._trim_end;
+    rhs._map_base = nullptr;
+    rhs._map_length = 0;
+    rhs._bins = nullptr;
+    rhs._bin_count = 0;
+    return *this;
+  }
+
+  MappedSampleAnalysis::~MappedSampleAnalysis() noexcept
+  {
+    unmap();
+  }
+
+  void MappedSampleAnalysis::unmap() noexcept
+  {
+    if (_map_base != nullptr) {
+      ::munmap(_map_base, _map_length);
+      _map_base = nullptr;
+      _map_length = 0;
+    }
+    _bins = nullptr;
+    _bin_count = 0;
+  }
+
+  bool MappedSampleAnalysis::load(const fs::path& cache_dir,
+                                  const std::string& key,
+                                  std::uint64_t source_id,
+                                  std::uint32_t frames)
+  {
+    int fd = ::open(sidecar_path(cache_dir, key).string().c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(SidecarHeader)) {
+      ::close(fd);
+      return false;
+    }
+    auto length = std::size_t(st.st_size);
+    void* map = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    SidecarHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    if (header.magic != SidecarHeader::magic_value ||
+        header.version != SidecarHeader::version_value || header.source_id != source_id ||
+        header.frames != frames ||
+        header.bin_count != (frames + Waveform::bin_size - 1) / Waveform::bin_size ||
+        length < sizeof(header) + header.bin_count * sizeof(float)) {
+      ::munmap(map, length);
+      return false;
+    }
+
+    unmap();
+    _map_base = map;
+    _map_length = length;
+    _bins = reinterpret_cast<const float*>(static_cast<const char*>(map) + sizeof(header));
+    _bin_count = header.bin_count;
+    _rms = header.rms;
+    _trim_start = header.trim_start;
+    _trim_end = header.trim_end;
+    return true;
+  }
+
+} // namespace otto::core::audio
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "util/filesystem.hpp"
+
+namespace otto::core::audio {
+
+  /// Analysis derived from one sample's raw audio, with a persistent sidecar
+  /// cache.
+  ///
+  /// Loading a sample pays one O(frames) scan for the peak envelope the
+  /// waveform screens draw, plus rms and trim points. The scan result is tiny
+  /// compared to the audio, so it is cached compactly under `data/cache/`,
+  /// keyed by a caller-chosen name and the identity (size + mtime) of the
+  /// backing file - every load after the first reads the sidecar instead of
+  /// the sample data. A stale or mismatched sidecar is simply a miss.
+  struct SampleAnalysis {
+    /// `max |x|` per {@ref Waveform::bin_size} frames - exactly the bins the
+    /// waveform generator would compute
+    std::vector<float> peak_bins;
+    float rms = 0;
+    /// First and one-past-last frame above the trim threshold (-60 dB).
+    /// `trim_start == trim_end` means the sample is silent
+    std::uint32_t trim_start = 0;
+    std::uint32_t trim_end = 0;
+
+    /// The one O(frames) scan computing all of the above
+    static SampleAnalysis analyze(const float* data, std::uint32_t frames);
+
+    /// Identity of the file backing a sample - size and mtime folded
+    /// together. \returns `0` when the file cannot be statted
+    static std::uint64_t source_id_of(const fs::path& file) noexcept;
+
+    /// Load the sidecar for `key` into `out`.
+    ///
+    /// \returns `true` on a hit - the sidecar exists and matches `source_id`
+    /// and `frames`. On a miss `out` is untouched.
+    static bool load_cached(const fs::path& cache_dir,
+                            const std::string& key,
+                            std::uint64_t source_id,
+                            std::uint32_t frames,
+                            SampleAnalysis& out);
+
+    /// Write the sidecar for `key`. Written atomically - the sidecar is
+    /// either complete or absent
+    static bool save_cached(const fs::path& cache_dir,
+                            const std::string& key,
+                            std::uint64_t source_id,
+                            std::uint32_t frames,
+                            const SampleAnalysis& analysis);
+  };
+
+  /// A sidecar mapped in place - the peak-file counterpart of
+  /// {@ref SampleAnalysis::load_cached}.
+  ///
+  /// The bins are read straight out of the mapping, so a waveform over them
+  /// costs no allocation and no copy, and the kernel can share and evict the
+  /// pages - sample browsing renders from the file the way DAW peak files do.
+  /// The mapping must outlive every view of the bins.
+  struct MappedSampleAnalysis {
+    MappedSampleAnalysis() = default;
+    MappedSampleAnalysis(const MappedSampleAnalysis&) = delete;
+    MappedSampleAnalysis(MappedSampleAnalysis&&) noexcept;
+    MappedSampleAnalysis& operator=(MappedSampleAnalysis&&) noexcept;
+    ~MappedSampleAnalysis() noexcept;
+
+    /// Map the sidecar for `key`.
+    ///
+    /// \returns `true` on a hit - see {@ref SampleAnalysis::load_cached} for
+    /// the match rules. On a miss the previous mapping (if any) is kept
+    bool load(const fs::path& cache_dir,
+              const std::string& key,
+              std::uint64_t source_id,
+              std::uint32_t frames);
+
+    /// Release the mapping. Invalidates the bin pointer
+    void unmap() noexcept;
+
+    const float* bins() const noexcept { return _bins; }
+    std::uint32_t bin_count() const noexcept { return _bin_count; }
+    float rms() const noexcept { return _rms; }
+    std::uint32_t trim_start() const noexcept { return _trim_start; }
+    std::uint32_t trim_end() const noexcept { return _trim_end; }
+
+    explicit operator bool() const noexcept { return _map_base != nullptr; }
+
+  private:
+    void* _map_base = nullptr;
+    std::size_t _map_length = 0;
+    const float* _bins = nullptr;
+    std::uint32_t _bin_count = 0;
+    float _rms = 0;
+    std::uint32_t _trim_start = 0;
+    std::uint32_t _trim_end = 0;
+  };
+
+} // namespace otto::core::audio
@@ -1,33 +1,140 @@
 #include "waveform.hpp"
 
-#include "util/iterator.hpp"
+#include <thread>
+
 #include "util/algorithm.hpp"
+#include "util/iterator.hpp"
+
+#include "services/task_pool.hpp"
 
 #include <Gamma/Analysis.h>
 
 namespace otto::core::audio {
 
-  constexpr int bin_size = 30;
+  constexpr int bin_size = Waveform::bin_size;
+
+  namespace {
+
+    /// Generate bins for one waveform. Runs as a task pool job - bounded (one
+    /// sample) and generation publishes progress per chunk, so waiters can
+    /// consume partial results while the job runs.
+    void generate(Waveform::GenState& state)
+    {
+      /// Bins are published per chunk, so waiters see progress and cancellation
+      /// latency is bounded by one chunk
+      constexpr int bins_per_chunk = 512;
+      int bin = state.valid_bins.load(std::memory_order_relaxed);
+      const float* src = state.src + bin * bin_size;
+      int rem = state.src_len - bin * bin_size;
+      while (rem > 0 && !state.cancel.load(std::memory_order_relaxed)) {
+        for (int b = 0; b < bins_per_chunk && rem > 0; b++) {
+          auto len = std::min(bin_size, rem);
+          float max = 0.f;
+          for (int i = 0; i < len; i++) {
+            auto f = std::abs(src[i]);
+            max = std::max(f, max);
+          }
+          state.dst[bin] = max;
+          bin++;
+          rem -= len;
+          src += len;
+        }
+        state.valid_bins.store(bin, std::memory_order_release);
+      }
+      state.done.store(true, std::memory_order_release);
+    }
 
-  Waveform::Waveform(gsl::span<float> data, int min_points)
+  } // namespace
+
+  Waveform::Waveform(audio_span<float> data, int min_points)
     : input_data_(data),
       max_res_(std::floor(std::log(data.size() / min_points))),
       // points_(data.size() * (2 - std::pow(2, -max_res_)))
       points_(data.size())
   {
-    for (int i = 0; i < max_res_; i++) {
+    start_generation();
+  }
+
+  Waveform::Waveform(audio_span<float> data, int min_points, const std::vector<float>& bins)
+    : input_data_(data),
+      max_res_(std::floor(std::log(data.size() / min_points))),
+      points_(data.size())
+  {
+    // The bins are already here - no generation job, and with gen_state_ null
+    // every wait is a no-op
+    const auto n = std::min(bins.size(), std::size_t(points_.size()));
+    std::copy_n(bins.begin(), n, points_.data());
+  }
+
+  Waveform::Waveform(audio_span<float> data, int min_points, const float* bins, int bin_count)
+    : input_data_(data),
+      max_res_(std::floor(std::log(data.size() / min_points))),
+      // The bins stay in the peak file - nothing is copied, and with gen_state_
+      // null every wait is a no-op. Views only read the bins, so casting the
+      // constness away is safe
+      mapped_bins_(const_cast<float*>(bins), bin_count)
+  {}
+
+  Waveform& Waveform::operator=(Waveform&& rhs) noexcept
+  {
+    cancel_generation();
+    input_data_ = rhs.input_data_;
+    max_res_ = rhs.max_res_;
+    points_ = std::move(rhs.points_);
+    mapped_bins_ = rhs.mapped_bins_;
+    gen_state_ = std::move(rhs.gen_state_);
+    return *this;
+  }
+
+  Waveform::~Waveform() noexcept
+  {
+    cancel_generation();
+  }
+
+  void Waveform::start_generation()
+  {
+    if (input_data_.empty()) return;
+    gen_state_ = std::make_shared<GenState>();
+    gen_state_->src = input_data_.data();
+    gen_state_->src_len = input_data_.size();
+    gen_state_->dst = points_.data();
+    // High priority - a screen is usually waiting on the first bins
+    services::TaskPool::current().push(services::TaskPool::Priority::high,
+                                       [state = gen_state_] { generate(*state); });
+  }
+
+  void Waveform::cancel_generation() noexcept
+  {
+    if (!gen_state_) return;
+    gen_state_->cancel.store(true, std::memory_order_relaxed);
+    /// The generator checks the flag between chunks, so this wait is bounded by one
+    /// chunk of work
+    while (!gen_state_->done.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+    gen_state_ = nullptr;
+  }
+
+  void Waveform::await_bins(int last_bin) const noexcept
+  {
+    if (!gen_state_) return;
+    auto& state = *gen_state_;
+    while (state.valid_bins.load(std::memory_order_acquire) < last_bin &&
+           !state.done.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
     }
-    generate_res(0);
   }
 
-  gsl::span<float> Waveform::at_resolution(int res)
+  audio_span<float> Waveform::at_resolution(int res)
   {
     // int start = std::ceil(input_data_.size() * (1.f - std::pow(2.f, -float(res - 1.f))));
     // int length = std::ceil(input_data_.size() * std::pow(2.f, -float(res)));
     // return {points_.data() + start, length};
 
     // return {points_.data() + input_data_.size() * res, input_data_.size()};
-    return {points_.data(), std::ceil(float(input_data_.size()) / float(bin_size))};
+    if (!mapped_bins_.empty()) return mapped_bins_;
+    return {points_.data(),
+            std::ptrdiff_t(std::ceil(float(input_data_.size()) / float(bin_size)))};
   }
 
   void Waveform::generate_res(int res)
@@ -85,7 +192,7 @@ namespace otto::core::audio {
 
   WaveformView& Waveform::view(WaveformView& v, int first, int last)
   {
-    if (points_.size() == 0) {
+    if (points_.size() == 0 && mapped_bins_.empty()) {
       util::fill(v.points_, 0);
       return v;
     }
@@ -94,6 +201,8 @@ namespace otto::core::audio {
     OTTO_ASSERT(last >= first);
     int res = res_for_duration(last - first, nPoints);
     auto data = at_resolution(res);
+    /// Bins are generated front to back - only wait for the ones this view reads
+    await_bins(std::min<int>(last, input_data_.size() - 1) / bin_size + 1);
     v.start_ = first;
     v.step_ = (last - first) / float(nPoints);
     float idx = 0;
@@ -1,8 +1,11 @@
 #pragma once
 
-#include <gsl/span>
+#include <atomic>
+#include <memory>
 #include <vector>
 
+#include "util/audio_span.hpp"
+
 #include "services/log_manager.hpp"
 #include "util/dyn-array.hpp"
 
@@ -14,26 +17,77 @@ namespace otto::core::audio {
   ///
   /// Max size is size of input data.
   struct Waveform {
+    /// Frames per downsampled bin
+    static constexpr int bin_size = 30;
+
     Waveform() = default;
-    Waveform(gsl::span<float> data, int min_points);
+    /// Construct a waveform over `data`.
+    ///
+    /// Returns immediately - the downsampled bins are generated front to back on a
+    /// shared background thread, so constructing a waveform over a long recording
+    /// does not stall the calling thread. `data` must stay valid for the lifetime
+    /// of this object.
+    Waveform(audio_span<float> data, int min_points);
+    /// Construct a waveform over `data` with precomputed bins, e.g. from the
+    /// analysis cache - see {@ref SampleAnalysis}. No generation job runs,
+    /// and views never wait. `bins` must hold `max |x|` per {@ref bin_size}
+    /// frames of `data`
+    Waveform(audio_span<float> data, int min_points, const std::vector<float>& bins);
+    /// Construct a waveform over `data` referencing externally owned bins,
+    /// e.g. a mapped peak file - see {@ref MappedSampleAnalysis}. Nothing is
+    /// allocated or copied, no generation job runs, and views never wait.
+    /// `bins` must hold `max |x|` per {@ref bin_size} frames of `data`, and
+    /// must outlive this object
+    Waveform(audio_span<float> data, int min_points, const float* bins, int bin_count);
+    Waveform(Waveform&&) noexcept = default;
+    Waveform& operator=(Waveform&&) noexcept;
+    ~Waveform() noexcept;
 
     /// Get a view of the waveform
     WaveformView view(int nPoints, int first, int last);
 
     /// Update a view with a new area.
+    ///
+    /// Waits only for the bins the view actually reads - bins are generated front to
+    /// back, so views of already-generated regions never block.
     WaveformView& view(WaveformView& v, int first, int last);
 
+    /// State shared with the background generator job. Implementation detail, public
+    /// only so the generator in waveform.cpp can reach it.
+    struct GenState {
+      const float* src = nullptr;
+      int src_len = 0;
+      float* dst = nullptr;
+      /// Number of bins generated so far. Published with release ordering.
+      std::atomic<int> valid_bins = 0;
+      /// Set to stop the generator between chunks
+      std::atomic<bool> cancel = false;
+      /// Set when the job is finished or cancelled
+      std::atomic<bool> done = false;
+    };
+
   private:
-    gsl::span<float> at_resolution(int res);
+    audio_span<float> at_resolution(int res);
 
     int res_for_duration(int dur, int nPoints) const;
 
     void generate_res(int res);
 
-    gsl::span<float> input_data_;
+    /// Hand the bin generation to the background thread
+    void start_generation();
+    /// Stop a pending generation and wait for the generator to let go of our buffers
+    void cancel_generation() noexcept;
+    /// Block until the first `last_bin` bins are generated
+    void await_bins(int last_bin) const noexcept;
+
+    audio_span<float> input_data_;
     /// res 0 is original resolution, 1 is 1/2, 2 is 1/4 etc.
     int max_res_;
     util::dyn_array<float> points_ = {0};
+    /// Bins owned elsewhere (a mapped peak file). When non-empty, `points_` is
+    /// unused and views read straight out of the mapping
+    audio_span<float> mapped_bins_;
+    std::shared_ptr<GenState> gen_state_;
   };
 
   struct WaveformView {
@@ -6,18 +6,22 @@ namespace otto::core::engine {
 
   // IEngine ////////////////////////////////////////////////////////////////
 
-  IEngine::IEngine(std::unique_ptr<ui::Screen> screen)
-    : _screen(std::move(screen))
+  IEngine::IEngine(ScreenFactory screen_factory)
+    : _screen_factory(std::move(screen_factory))
   {}
 
-  ui::Screen& IEngine::screen() noexcept
+  ui::Screen& IEngine::screen()
   {
+    if (!_screen) {
+      _screen = _screen_factory();
+      _screen_factory = nullptr;
+    }
     return *_screen;
   }
 
-  ui::Screen const& IEngine::screen() const noexcept
+  ui::Screen const& IEngine::screen() const
   {
-    return *_screen;
+    return const_cast<IEngine*>(this)->screen();
   }
 
   int IEngine::current_preset() const noexcept
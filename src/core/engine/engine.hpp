@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "util/algorithm.hpp"
@@ -13,6 +15,7 @@
 
 #include "core/audio/processor.hpp"
 #include "core/props/props.hpp"
+#include "core/props/registry.hpp"
 #include "core/ui/screen.hpp"
 #include "core/voices/voice_manager.hpp"
 
@@ -38,7 +41,18 @@ namespace otto::core::engine {
   ///
   /// Use this when refering to a generic engine
   struct IEngine {
-    IEngine(std::unique_ptr<ui::Screen> screen);
+    /// Builds the engine's screen. Stored at construction, invoked on first
+    /// {@ref screen} call
+    using ScreenFactory = std::function<std::unique_ptr<ui::Screen>()>;
+
+    /// Construct with a screen factory.
+    ///
+    /// The screen is not built here - every engine is constructed up front at
+    /// startup, and most screens are never displayed in a given session, so
+    /// construction waits for the first {@ref screen} call. The factory
+    /// usually captures `this`, which is safe: it only runs after the engine
+    /// is fully constructed.
+    IEngine(ScreenFactory screen_factory);
 
     virtual ~IEngine() = default;
 
@@ -47,9 +61,10 @@ namespace otto::core::engine {
     /// The name of this module.
     virtual util::string_ref name() const noexcept = 0;
 
-    ui::Screen& screen() noexcept;
+    /// The engine's screen, built by the factory on the first call
+    ui::Screen& screen();
 
-    const ui::Screen& screen() const noexcept;
+    const ui::Screen& screen() const;
 
     /// The currently selected preset
     ///
@@ -94,7 +109,41 @@ namespace otto::core::engine {
     /// [nlohmann::json::exception](), see it for details.
     virtual void from_json(const nlohmann::json& j) = 0;
 
+    /// Total bytes of memory owned by this engine.
+    ///
+    /// The CRTP base reports `sizeof` the concrete type - which covers inline
+    /// wavetables, delay lines and scratch arrays - plus whatever the engine
+    /// reports through an `owned_buffer_bytes()` member for heap-allocated
+    /// buffers (the helpers in `util/footprint.hpp` cover the common
+    /// containers). Collected once at startup into the footprint report - see
+    /// {@ref services::engine_memory_stats}
+    virtual std::size_t memory_footprint() const noexcept
+    {
+      return 0;
+    }
+
+    /// The flat registry over this engine's numeric properties.
+    ///
+    /// Built lazily by the CRTP base on first call, then owned by the engine
+    /// for its lifetime - the reflection walk runs once, and bulk operations
+    /// like preset morphing work on the contiguous banks from then on.
+    ///
+    /// \returns `nullptr` for engines without reflected props
+    virtual props::PropertyRegistry* registry()
+    {
+      return nullptr;
+    }
+
+    /// Called after another engine has been selected in this slot.
+    ///
+    /// The dispatcher waits for the audio thread first, so the engine is
+    /// guaranteed not to be processing. Engines that hold regions from the
+    /// {@ref util::dsp::DelayArena} hand them back here - properties and
+    /// other state stay, as always
+    virtual void on_deselected() noexcept {}
+
   private:
+    ScreenFactory _screen_factory;
     std::unique_ptr<ui::Screen> _screen;
     int _current_preset = -1;
   };
@@ -155,12 +204,28 @@ namespace otto::core::engine {
   // Engine class /////////////////////////////////////////////////////////////
 
   namespace detail {
+    template<typename T, typename = void>
+    struct has_owned_buffer_bytes : std::false_type {};
+    template<typename T>
+    struct has_owned_buffer_bytes<T, std::void_t<decltype(std::declval<const T&>().owned_buffer_bytes())>>
+      : std::true_type {};
+    template<typename T>
+    constexpr bool has_owned_buffer_bytes_v = has_owned_buffer_bytes<T>::value;
+
     template<EngineType ET, typename Derived>
     struct EngineImpl : util::crtp<Derived, EngineImpl<ET, Derived>>, ITypedEngine<ET> {
       util::string_ref name() const noexcept override
       {
         return name_of_engine_v<Derived>;
       }
+      std::size_t memory_footprint() const noexcept override
+      {
+        if constexpr (has_owned_buffer_bytes_v<Derived>) {
+          return sizeof(Derived) + derived().owned_buffer_bytes();
+        } else {
+          return sizeof(Derived);
+        }
+      }
       nlohmann::json to_json() const override
       {
         return util::serialize(this->derived());
@@ -169,6 +234,11 @@ namespace otto::core::engine {
       {
         util::deserialize(this->derived(), j);
       }
+      props::PropertyRegistry* registry() override
+      {
+        if (!_registry) _registry = std::make_unique<props::PropertyRegistry>(this->derived());
+        return _registry.get();
+      }
 
       static constexpr auto reflect_name()
       {
@@ -184,6 +254,9 @@ namespace otto::core::engine {
     protected:
       using ITypedEngine<ET>::ITypedEngine;
       using util::crtp<Derived, EngineImpl<ET, Derived>>::derived;
+
+    private:
+      std::unique_ptr<props::PropertyRegistry> _registry;
     };
   } // namespace detail
 
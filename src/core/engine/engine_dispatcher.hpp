@@ -1,11 +1,12 @@
 #pragma once
 
+#include <array>
+#include <tuple>
+
 #include <foonathan/array/flat_map.hpp>
 #include "core/engine/engine.hpp"
 #include "core/engine/nullengine.hpp"
 
-#include "util/variant_w_base.hpp"
-
 namespace otto::core::engine {
 
   /// Interface base class for the EngineDispatcher struct
@@ -19,6 +20,11 @@ namespace otto::core::engine {
 
     virtual std::vector<util::string_ref> make_name_list() const = 0;
 
+    /// Call `f` with every engine owned by this dispatcher, selected or not.
+    ///
+    /// Used by the startup footprint report - see {@ref IEngine::memory_footprint}
+    virtual void for_each_engine(const std::function<void(const IEngine&)>& f) const = 0;
+
     virtual ~IEngineDispatcher() = default;
 
     /// Is the engine allowed to be in an "OFF" state?
@@ -26,6 +32,11 @@ namespace otto::core::engine {
   };
 
   /// Owns engines of type `ET`, and dispatches to a selected one of them
+  ///
+  /// All engines are constructed once, up front, and stay alive for the
+  /// lifetime of the dispatcher. `select()` is just a pointer swap, so
+  /// switching engines neither allocates nor runs DSP constructors, and a
+  /// deselected engine keeps its state until it is selected again.
   template<EngineType ET, typename... Engines>
   struct EngineDispatcher final : IEngineDispatcher {
     enum struct ErrorCode { none = 0, engine_not_found, type_mismatch };
@@ -34,7 +45,6 @@ namespace otto::core::engine {
 
     static constexpr const EngineType engine_type = ET;
     using ITypedEngine = engine::ITypedEngine<ET>;
-    using variant = util::variant_w_base<ITypedEngine, Engines...>;
     using DataMap = foonathan::array::flat_map<util::string_ref, nlohmann::json>;
 
     // Initialization
@@ -50,6 +60,16 @@ namespace otto::core::engine {
     /// Access the currently selected engine
     ITypedEngine* operator->() noexcept;
 
+    /// Visit the currently selected engine as its concrete type.
+    ///
+    /// Dispatches on the selected index instead of going through the virtual
+    /// `process()`, so the engine call can be inlined into the caller - with a fixed
+    /// chain like the one in DefaultEngineManager this lets the compiler fuse across
+    /// stage boundaries. The visitor is called with the null engine when none is
+    /// selected.
+    template<typename Visitor>
+    decltype(auto) visit(Visitor&& visitor);
+
     /// Select engine by name
     ///
     /// \effects Find engine with name `name`, and `select(engine)`
@@ -64,6 +84,8 @@ namespace otto::core::engine {
 
     std::vector<util::string_ref> make_name_list() const override;
 
+    void for_each_engine(const std::function<void(const IEngine&)>& f) const override;
+
     /// Access the screen used to select engines/presets
     ///
     /// The returned screen has the dynamic type [EngineSelectorScreen]()
@@ -76,9 +98,16 @@ namespace otto::core::engine {
     void from_json(const nlohmann::json&);
 
   private:
+    template<std::size_t I, typename Visitor>
+    decltype(auto) visit_impl(Visitor&& visitor, int idx);
+
+    /// Engine state loaded from json, but not yet applied to an engine. Applied
+    /// and removed when the engine is first selected
     DataMap _engine_data;
     NullEngine<ET> _null_engine;
-    variant _engine_storage = util::in_place_index_t<0>();
+    std::tuple<Engines...> _engines;
+    std::array<ITypedEngine*, sizeof...(Engines)> _engine_ptrs = {};
+    int _current_index = -1;
     ITypedEngine* _current = &_null_engine;
     std::unique_ptr<ui::Screen> _selector_screen = nullptr;
   };
@@ -17,7 +17,9 @@ namespace otto::core::engine {
   template<EngineType ET, typename... Egs>
   EngineDispatcher<ET, Egs...>::EngineDispatcher(bool allow_off)
     : IEngineDispatcher(allow_off), _selector_screen(std::make_unique<EngineSelectorScreen>(*this))
-  {}
+  {
+    std::apply([this](auto&... engines) { _engine_ptrs = {(&engines)...}; }, _engines);
+  }
 
   template<EngineType ET, typename... Egs>
   ITypedEngine<ET>& EngineDispatcher<ET, Egs...>::current() noexcept
@@ -28,8 +30,7 @@ namespace otto::core::engine {
   template<EngineType ET, typename... Egs>
   int EngineDispatcher<ET, Egs...>::current_idx() const noexcept
   {
-    if (_current == &_null_engine) return -1;
-    return _engine_storage.index();
+    return _current_index;
   }
 
   template<EngineType ET, typename... Egs>
@@ -52,58 +53,77 @@ namespace otto::core::engine {
   }
 
   template<EngineType ET, typename... Egs>
-  ITypedEngine<ET>& EngineDispatcher<ET, Egs...>::select(util::string_ref name)
+  template<typename Visitor>
+  decltype(auto) EngineDispatcher<ET, Egs...>::visit(Visitor&& visitor)
   {
-    _engine_data.insert_or_replace(_current->name(), _current->to_json());
-    _current = &_null_engine;
-    if (!allow_off || util::to_lowercase(name) != "off") {
-      Application::current().audio_manager->wait_one();
-      bool done = false;
-      try {
-        meta::for_each<meta::list<Egs...>>([&](auto m_type) -> void {
-          using type = decltype(m_type._t());
-          if (!done && name_of_engine_v<type> == name) {
-            _engine_storage.template emplace<type>();
-            if (auto found = _engine_data.try_lookup(_engine_storage->name()); found)
-              _engine_storage.base()->from_json(*found);
-            done = true;
-          }
-        });
-      } catch (std::exception& e) {
-        LOGE("Error loading engine: {}", e.what());
-        done = true;
-      }
-      _current = _engine_storage.base();
-      if (!done) throw util::exception("Engine '{}' not found", name);
+    return visit_impl<0>(std::forward<Visitor>(visitor), _current_index);
+  }
+
+  template<EngineType ET, typename... Egs>
+  template<std::size_t I, typename Visitor>
+  decltype(auto) EngineDispatcher<ET, Egs...>::visit_impl(Visitor&& visitor, int idx)
+  {
+    if constexpr (I == sizeof...(Egs)) {
+      return std::forward<Visitor>(visitor)(_null_engine);
+    } else {
+      if (idx == int(I)) return std::forward<Visitor>(visitor)(std::get<I>(_engines));
+      return visit_impl<I + 1>(std::forward<Visitor>(visitor), idx);
     }
-    return *_current;
+  }
+
+  template<EngineType ET, typename... Egs>
+  ITypedEngine<ET>& EngineDispatcher<ET, Egs...>::select(util::string_ref name)
+  {
+    if (allow_off && util::to_lowercase(name) == "off") return select(-1);
+    int index = -1;
+    meta::for_each<meta::list<Egs...>>([&, idx = 0](auto m_type) mutable {
+      using type = decltype(m_type._t());
+      if (name_of_engine_v<type> == name) index = idx;
+      idx++;
+    });
+    if (index < 0) throw util::exception("Engine '{}' not found", name);
+    return select(index);
   }
 
   template<EngineType ET, typename... Egs>
   ITypedEngine<ET>& EngineDispatcher<ET, Egs...>::select(int index)
   {
-    _engine_data.insert_or_replace(_current->name(), _current->to_json());
-    _current = &_null_engine;
-    if (!allow_off || index >= 0) {
-      Application::current().audio_manager->wait_one();
-      bool done = false;
-      try {
-        meta::for_each<meta::list<Egs...>>([&, idx = 0](auto m_type) mutable {
-          using type = decltype(m_type._t());
-          if (!done && idx == index) {
-            _engine_storage.template emplace<type>();
-            if (auto found = _engine_data.try_lookup(_engine_storage->name()); found)
-              _engine_storage.base()->from_json(*found);
-            done = true;
-          }
-          idx++;
-        });
-      } catch (std::exception& e) {
-        LOGE("Error loading engine: {}", e.what());
-        done = true;
+    if (index < 0 && !allow_off) {
+      throw util::exception("EngineDispatcher::select(): Idx {} out of bounds", index);
+    }
+    if (index >= int(sizeof...(Egs))) {
+      throw util::exception("EngineDispatcher::select(): Idx {} out of bounds", index);
+    }
+
+    // The engines are all constructed up front, so this only swaps a pointer.
+    // Wait for the audio thread anyway, so it never sees a half-finished switch
+    Application::current().audio_manager->wait_one();
+
+    auto* previous = _current;
+
+    if (index < 0) {
+      _current = &_null_engine;
+      _current_index = -1;
+    } else {
+      auto* engine = _engine_ptrs[index];
+      if (auto found = _engine_data.try_lookup(engine->name()); found) {
+        try {
+          engine->from_json(*found);
+        } catch (std::exception& e) {
+          LOGE("Error loading engine state: {}", e.what());
+        }
+        _engine_data.erase_all(engine->name());
       }
-      _current = _engine_storage.base();
-      if (!done) throw util::exception("EngineDispatcher::select(): Idx {} out of bounds", index);
+      _current = engine;
+      _current_index = index;
+    }
+
+    // Let the outgoing engine release shared resources (delay arena regions).
+    // Wait for the audio thread again first - it may still be inside the old
+    // engine's process call from before the swap
+    if (previous != _current) {
+      Application::current().audio_manager->wait_one();
+      previous->on_deselected();
     }
     return *_current;
   }
@@ -120,6 +140,14 @@ namespace otto::core::engine {
     return res;
   }
 
+  template<EngineType ET, typename... Egs>
+  void EngineDispatcher<ET, Egs...>::for_each_engine(const std::function<void(const IEngine&)>& f) const
+  {
+    for (const auto* engine : _engine_ptrs) {
+      f(*engine);
+    }
+  }
+
   template<EngineType ET, typename... Egs>
   ui::Screen& EngineDispatcher<ET, Egs...>::selector_screen() noexcept
   {
@@ -139,10 +167,14 @@ namespace otto::core::engine {
     nlohmann::json j = nlohmann::json::object();
     j["current_engine"] = current().name();
     auto engines = nlohmann::json::object();
-    for (auto&& [key, val] : _engine_data) {
-      engines[std::string(key)] = val;
+    for (const auto* engine : _engine_ptrs) {
+      // Loaded state that was never applied to the engine is still authoritative
+      if (auto found = _engine_data.try_lookup(engine->name()); found) {
+        engines[std::string(engine->name())] = *found;
+      } else {
+        engines[std::string(engine->name())] = engine->to_json();
+      }
     }
-    if (_current != &_null_engine) engines[std::string(_current->name())] = _current->to_json();
     j["engines"] = engines;
     return j;
   }
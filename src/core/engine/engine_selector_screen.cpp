@@ -44,7 +44,7 @@ namespace otto::core::engine {
       try {
       Application::current().preset_manager->apply_preset(cur_eg(), idx);
       } catch (util::exception& e) {
-        LOGE(e.what());
+        LOGE("{}", e.what());
       }
     };
     opts.item_colour = Colours::Gray50;
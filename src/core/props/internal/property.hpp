@@ -116,6 +116,15 @@ namespace otto::core::props {
       return value_;
     }
 
+    /// The value the property was constructed with.
+    ///
+    /// Used by the delta encoding in `util/serialize.hpp` - a property still
+    /// at this value is omitted from the output, and implied on load
+    const value_type& init_value() const
+    {
+      return init_value_;
+    }
+
     void set(const value_type& v)
     {
       auto oldval = value_;
@@ -137,6 +146,8 @@ namespace otto::core::props {
     DECL_REFLECTION(PropertyImpl, ("value", &PropertyImpl::get, &PropertyImpl::set))
   protected:
     value_type value_;
+    /// Initialized after `value_`, so this picks up the construction value
+    value_type init_value_ = value_;
   };
 
 } // namespace otto::core::props
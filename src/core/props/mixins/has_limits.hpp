@@ -3,6 +3,7 @@
 #include <better_enum.hpp>
 
 #include "util/algorithm.hpp"
+#include "util/math.hpp"
 
 #include "services/log_manager.hpp"
 
@@ -86,13 +87,14 @@ namespace otto::core::props {
 
     void on_hook(hook<common::hooks::on_set, HookOrder::Early> & hook)
     {
-      auto& val = hook.value();
-      if (util::underlying(val) < min) {
-        auto hv = run_hook<hooks::on_exceeded>(util::underlying(val));
-        hook.value() = detail::from_integral<value_type>(hv == util::underlying(val) ? min : hv);
-      } else if (util::underlying(val) > max) {
-        auto hv = run_hook<hooks::on_exceeded>(util::underlying(val));
-        hook.value() = detail::from_integral<value_type>(hv == util::underlying(val) ? max : hv);
+      // The clamp itself is branchless min/max - the in-range fast path that
+      // every encoder step takes is one compare, and the on_exceeded hook only
+      // runs when the value actually moved
+      const auto val = util::underlying(hook.value());
+      const auto clamped = util::math::clamp(val, min, max);
+      if (clamped != val) {
+        auto hv = run_hook<hooks::on_exceeded>(val);
+        hook.value() = detail::from_integral<value_type>(hv == val ? clamped : hv);
       }
     }
 
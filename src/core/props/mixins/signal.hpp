@@ -10,6 +10,7 @@
 #include "services/log_manager.hpp"
 #include "util/algorithm.hpp"
 
+#include "util/reflection.hpp"
 #include "util/signals.hpp"
 
 namespace otto::core::props {
@@ -50,14 +51,29 @@ namespace otto::core::props {
       Signal(self_type& owner) : owner(owner) {}
 
       using Super::connect;
-      SlotRef connect(std::function<void(value_type)> f)
+
+      /// Handlers that only want the new value, or no arguments at all, are
+      /// wrapped directly - no `std::function` in between, so the capture goes
+      /// straight into the delegate's inline buffer
+      template<typename F,
+               typename = std::enable_if_t<std::is_invocable_v<F&, value_type> &&
+                                           !std::is_invocable_v<F&, value_type, value_type>>>
+      SlotRef connect(F f)
       {
-        return {connect([f = std::move(f)](value_type new_val, value_type old_val) { return f(new_val); }), *this};
+        return {connect(typename Super::Function(
+                  [f = std::move(f)](value_type new_val, value_type old_val) { f(new_val); })),
+                *this};
       }
 
-      SlotRef connect(std::function<void()> f)
+      template<typename F,
+               typename = std::enable_if_t<std::is_invocable_v<F&> &&
+                                           !std::is_invocable_v<F&, value_type>>,
+               typename = void>
+      SlotRef connect(F f)
       {
-        return {connect([f = std::move(f)](value_type new_val, value_type old_val) { return f(); }), *this};
+        return {connect(typename Super::Function(
+                  [f = std::move(f)](value_type new_val, value_type old_val) { f(); })),
+                *this};
       }
 
       self_type& owner;
@@ -77,4 +93,33 @@ namespace otto::core::props {
     Signal _on_change{*this};
   };
 
+  namespace detail {
+    template<typename T>
+    struct is_property : std::false_type {};
+
+    template<typename T, typename TagList>
+    struct is_property<PropertyImpl<T, TagList>> : std::true_type {};
+  } // namespace detail
+
+  /// Connect `f` to the `on_change` signal of every property in a reflected
+  /// struct, recursing into nested reflected members.
+  ///
+  /// Used by state clients to mark themselves dirty whenever any of their
+  /// properties change, without listing each property by hand.
+  template<typename Class, typename F>
+  void connect_on_change(Class& obj, F f)
+  {
+    if constexpr (detail::is_property<Class>::value) {
+      if constexpr (Class::template is<signal>) {
+        obj.on_change().connect([f] { f(); });
+      }
+    } else if constexpr (reflect::is_registered<Class>()) {
+      reflect::for_all_members<Class>([&obj, &f](auto& member) {
+        if constexpr (std::decay_t<decltype(member)>::can_get_ref()) {
+          connect_on_change(member.get_ref(obj), f);
+        }
+      });
+    }
+  }
+
 } // namespace otto::core::props
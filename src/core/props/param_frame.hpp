@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+
+#include "props.hpp"
+
+namespace otto::core::props {
+
+  /// A per-block snapshot of a set of float properties, with per-sample smoothing.
+  ///
+  /// Voices that read properties per sample to avoid zipper noise pay for the property
+  /// machinery in their inner loops. A `ParamFrame` moves that cost to the block
+  /// boundary: each registered property pushes its new value into the frame through its
+  /// `on_change` signal, and {@ref snapshot} - called once per audio block - computes a
+  /// per-sample delta for every changed parameter. The audio inner loop then only
+  /// touches plain local floats through {@ref step} and {@ref operator[]}.
+  ///
+  /// ```cpp
+  /// ParamFrame frame;
+  /// int detune = frame.add(props.detune);
+  ///
+  /// // Once per block:
+  /// frame.snapshot(nframes);
+  /// // Per sample:
+  /// frame.step();
+  /// float d = frame[detune];
+  /// ```
+  ///
+  /// {@ref add} allocates and must not be called from the audio thread - register all
+  /// parameters on construction. `snapshot`, `step` and `operator[]` are allocation
+  /// free.
+  struct ParamFrame {
+    /// Register a property in the frame
+    ///
+    /// \returns the index to read the smoothed value back with {@ref operator[]}
+    template<typename TagList>
+    int add(PropertyImpl<float, TagList>& prop)
+    {
+      int idx = entries.size();
+      entries.push_back({prop.get(), prop.get(), 0.f});
+      prop.on_change().connect([this, idx](float val) { entries[idx].target = val; });
+      return idx;
+    }
+
+    /// Snapshot all parameters for a block of `nframes` samples.
+    ///
+    /// Computes the per-sample delta that moves each parameter from its current
+    /// (smoothed) value to the last value written by the logic thread over the course
+    /// of the block.
+    void snapshot(int nframes) noexcept
+    {
+      for (auto& e : entries) {
+        e.delta = (e.target - e.current) / float(nframes);
+      }
+    }
+
+    /// Advance all parameters one sample
+    void step() noexcept
+    {
+      for (auto& e : entries) e.current += e.delta;
+    }
+
+    /// Read the current smoothed value of the parameter registered as `idx`
+    float operator[](int idx) const noexcept
+    {
+      return entries[idx].current;
+    }
+
+  private:
+    struct Entry {
+      /// Written by the logic thread through on_change. A word-sized float store, read
+      /// once per block in snapshot.
+      float target;
+      float current;
+      float delta;
+    };
+
+    std::vector<Entry> entries;
+  };
+
+} // namespace otto::core::props
@@ -5,6 +5,7 @@
 
 #include "internal/property.hpp"
 #include "mixins/all.hpp"
+#include "util/binary_codec.hpp"
 #include "util/serialize.hpp"
 
 /// The property system
@@ -66,6 +67,19 @@ namespace otto::core::props {
     return serialize(prop.get());
   }
 
+  namespace detail {
+    /// Whether `T` can be compared to itself with `==`. Drives the delta
+    /// encoding below - incomparable value types always serialize
+    template<typename T, typename Enable = void>
+    struct is_self_comparable : std::false_type {};
+
+    template<typename T>
+    struct is_self_comparable<
+      T,
+      std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+      : std::true_type {};
+  } // namespace detail
+
   /// Deserialize a property from json
   template<typename ValueType, typename TagList>
   inline void deserialize(PropertyImpl<ValueType, TagList>& prop, const nlohmann::json& json)
@@ -75,9 +89,38 @@ namespace otto::core::props {
                   "A property type must be default constructible to be deserializable");
     ValueType v{};
     deserialize(v, json);
+    if constexpr (detail::is_self_comparable<ValueType>::value) {
+      // Untouched props skip assignment and signal emission
+      if (v == prop.get()) return;
+    }
     prop.set(std::move(v));
   }
 
+  /// Delta encoding support - a property still at its construction-time value
+  /// is omitted from the serialized output. See `util/serialize.hpp`
+  template<typename ValueType, typename TagList>
+  inline bool serialize_is_default(const PropertyImpl<ValueType, TagList>& prop) noexcept
+  {
+    if constexpr (detail::is_self_comparable<ValueType>::value) {
+      return prop.get() == prop.init_value();
+    } else {
+      return false;
+    }
+  }
+
+  /// Delta encoding support - restore a property omitted from the input.
+  ///
+  /// No assignment and no signal when the property is already at its
+  /// construction-time value - the common case on startup
+  template<typename ValueType, typename TagList>
+  inline void serialize_reset_default(PropertyImpl<ValueType, TagList>& prop)
+  {
+    if constexpr (detail::is_self_comparable<ValueType>::value) {
+      if (prop.get() == prop.init_value()) return;
+    }
+    prop.set(prop.init_value());
+  }
+
 
   template<typename ValueType, typename TagList>
   void to_json(json& j, PropertyImpl<ValueType, TagList>& t)
@@ -103,3 +146,41 @@ namespace otto::core::props {
     deserialize(t, j);
   }
 } // namespace otto::core::props
+
+namespace otto::util {
+
+  /// Binary-codec a property as its value - the property itself is then flat
+  /// exactly when its value type is. Mirrors the json serialization above:
+  /// decoding goes through `set`, so hooks and change signals fire.
+  template<typename ValueType, typename TagList>
+  struct binary_traits<core::props::PropertyImpl<ValueType, TagList>> {
+    using Property = core::props::PropertyImpl<ValueType, TagList>;
+
+    /// Properties are registered (they reflect their value) - this keeps them
+    /// from dispatching through `binary_layout` and bypassing these traits
+    static constexpr bool overrides_layout = true;
+
+    static constexpr bool is_flat = binary_traits<ValueType>::is_flat;
+    static constexpr std::size_t size = binary_traits<ValueType>::size;
+
+    static void encode(const Property& prop, std::byte*& out) noexcept
+    {
+      binary_traits<ValueType>::encode(prop.get(), out);
+    }
+
+    static void decode(Property& prop, const std::byte*& in)
+    {
+      static_assert(std::is_default_constructible_v<ValueType>,
+                    "A property type must be default constructible to be decodable");
+      ValueType v{};
+      binary_traits<ValueType>::decode(v, in);
+      // The binary layout is fixed, so every value is present - but untouched
+      // props still skip assignment and signal emission on load
+      if constexpr (core::props::detail::is_self_comparable<ValueType>::value) {
+        if (v == prop.get()) return;
+      }
+      prop.set(std::move(v));
+    }
+  };
+
+} // namespace otto::util
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "props.hpp"
+#include "util/symbol.hpp"
+
+namespace otto::core::props {
+
+  /// A flat, type-bucketed index of every numeric property in a reflected
+  /// `Props` struct.
+  ///
+  /// Reflection visits properties through a template recursion - fine for a
+  /// one-off serialize, wasteful for operations that touch every property
+  /// again and again. A `PropertyRegistry` runs that recursion exactly once,
+  /// at engine construction, and records each `float`, `int` and `bool`
+  /// property into a per-type bank: parallel arrays of interned names,
+  /// accessors and raw values. Bulk operations - a state snapshot, applying a
+  /// preset, scanning for changed values - are then linear walks over
+  /// contiguous arrays.
+  ///
+  /// ```cpp
+  /// PropertyRegistry reg{props};
+  ///
+  /// // Snapshot: one linear walk fills the contiguous value arrays
+  /// reg.snapshot();
+  /// for (int i = 0; i < reg.floats.size(); i++) {
+  ///   use(reg.floats.names[i], reg.floats.values[i]);
+  /// }
+  ///
+  /// // Preset apply: write the values, then one walk through the setters
+  /// reg.floats.values[reg.floats.find("filter")] = 0.3f;
+  /// reg.apply();
+  /// ```
+  ///
+  /// Nested structs are walked recursively, naming properties
+  /// `outer/inner`. Properties of other value types - strings, enums -
+  /// are skipped; they keep going through the reflected visit.
+  ///
+  /// {@ref add_all} and {@ref add} allocate and must not be called from the
+  /// audio thread - build the registry on construction. `snapshot` and
+  /// `apply` are allocation free.
+  struct PropertyRegistry {
+    /// The entries of one value type, as parallel arrays.
+    ///
+    /// `values` is a scratch buffer owned by the registry: {@ref snapshot}
+    /// fills it from the properties, {@ref apply} writes it back through
+    /// them. The properties themselves are not relocated.
+    template<typename V>
+    struct Bank {
+      std::vector<util::Symbol> names;
+      std::vector<V> values;
+
+      int size() const noexcept
+      {
+        return int(names.size());
+      }
+
+      /// The index of the property registered as `name`, or -1.
+      ///
+      /// A linear scan over interned ids - fine for the occasional preset
+      /// apply, cache the index for anything hotter
+      int find(util::Symbol name) const noexcept
+      {
+        for (int i = 0; i < size(); i++) {
+          if (names[i] == name) return i;
+        }
+        return -1;
+      }
+
+      /// Type-erased accessors, parallel to `names`. Used by the bulk
+      /// operations - most callers only need `names` and `values`
+      std::vector<void*> props;
+      std::vector<V (*)(void*)> get;
+      std::vector<void (*)(void*, const V&)> set;
+    };
+
+    PropertyRegistry() = default;
+
+    /// Build a registry over every numeric property in a reflected struct
+    template<typename Props>
+    explicit PropertyRegistry(Props& props)
+    {
+      add_all(props);
+    }
+
+    /// Register a single property under `name`
+    template<typename T, typename TagList>
+    void add(util::Symbol name, PropertyImpl<T, TagList>& prop)
+    {
+      using Prop = PropertyImpl<T, TagList>;
+      auto& bank = bank_for<T>();
+      bank.names.push_back(name);
+      bank.values.push_back(prop.get());
+      bank.props.push_back(&prop);
+      bank.get.push_back([](void* p) -> T { return static_cast<Prop*>(p)->get(); });
+      bank.set.push_back([](void* p, const T& v) { static_cast<Prop*>(p)->set(v); });
+    }
+
+    /// Walk a reflected struct and register every `float`, `int` and `bool`
+    /// property, recursing into nested reflected members
+    template<typename Class>
+    void add_all(Class& obj, const std::string& prefix = "")
+    {
+      if constexpr (detail::is_property<Class>::value) {
+        using vt = typename Class::value_type;
+        if constexpr (std::is_same_v<vt, float> || std::is_same_v<vt, int> ||
+                      std::is_same_v<vt, bool>) {
+          add(util::Symbol(prefix), obj);
+        }
+      } else if constexpr (reflect::is_registered<Class>()) {
+        reflect::for_all_members<Class>([this, &obj, &prefix](auto& member) {
+          if constexpr (std::decay_t<decltype(member)>::can_get_ref()) {
+            auto name = prefix.empty() ? std::string(member.get_name().c_str())
+                                       : prefix + "/" + member.get_name().c_str();
+            add_all(member.get_ref(obj), name);
+          }
+        });
+      }
+    }
+
+    /// Copy every property value into the contiguous `values` arrays
+    void snapshot() noexcept
+    {
+      snapshot_bank(floats);
+      snapshot_bank(ints);
+      snapshot_bank(bools);
+    }
+
+    /// Write the `values` arrays back through each property's `set`, running
+    /// hooks and change signals as usual
+    void apply()
+    {
+      apply_bank(floats);
+      apply_bank(ints);
+      apply_bank(bools);
+    }
+
+    Bank<float> floats;
+    Bank<int> ints;
+    Bank<bool> bools;
+
+  private:
+    template<typename V>
+    Bank<V>& bank_for() noexcept
+    {
+      if constexpr (std::is_same_v<V, float>) {
+        return floats;
+      } else if constexpr (std::is_same_v<V, int>) {
+        return ints;
+      } else {
+        return bools;
+      }
+    }
+
+    template<typename V>
+    static void snapshot_bank(Bank<V>& bank) noexcept
+    {
+      for (std::size_t i = 0; i < bank.props.size(); i++) {
+        bank.values[i] = bank.get[i](bank.props[i]);
+      }
+    }
+
+    template<typename V>
+    static void apply_bank(Bank<V>& bank)
+    {
+      for (std::size_t i = 0; i < bank.props.size(); i++) {
+        bank.set[i](bank.props[i], bank.values[i]);
+      }
+    }
+  };
+
+} // namespace otto::core::props
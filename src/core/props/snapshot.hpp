@@ -0,0 +1,61 @@
+#pragma once
+
+#include "util/locked.hpp"
+
+namespace otto::core::props {
+
+  /// A coherent snapshot of a group of parameter values, shared lock-free
+  /// between the logic and audio threads.
+  ///
+  /// Individual property writes are word-sized and safe on their own, but a
+  /// change that touches several props - like OTTO.FM's algorithm number plus
+  /// the operator roles derived from it - can be observed half-applied by the
+  /// audio thread. A `Snapshot` publishes a whole value type atomically
+  /// through a {@ref util::triple_buffer}: the logic thread mutates the
+  /// staging copy in {@ref commit}, and the audio thread calls {@ref flip}
+  /// once at block start to get the latest committed set, which then stays
+  /// stable for the whole block.
+  ///
+  /// ```cpp
+  /// props::Snapshot<Params> params;
+  ///
+  /// // Logic thread, typically from on_change:
+  /// params.commit([&](Params& p) { p.algN = props.algN; });
+  ///
+  /// // Audio thread, once per block:
+  /// auto& p = params.flip();
+  /// ```
+  ///
+  /// Neither side blocks, so `flip` and `read` are safe in the hot path.
+  template<typename T>
+  struct Snapshot {
+    Snapshot(const T& init = T{}) : buffer_(init) {}
+
+    /// Mutate the staging copy and publish it. Logic thread only.
+    ///
+    /// `f` is called with the staging `T&`, which holds the values of the
+    /// previous commit, so it only needs to write what changed.
+    template<typename Func>
+    void commit(Func&& f)
+    {
+      std::invoke(std::forward<Func>(f), buffer_.write());
+      buffer_.publish();
+    }
+
+    /// Flip to the latest committed snapshot. Audio thread, once per block.
+    const T& flip() noexcept
+    {
+      return buffer_.swap_read();
+    }
+
+    /// The snapshot flipped to at block start
+    const T& read() const noexcept
+    {
+      return buffer_.read();
+    }
+
+  private:
+    util::triple_buffer<T> buffer_;
+  };
+
+} // namespace otto::core::props
@@ -20,14 +20,14 @@ namespace otto::core::ui::vg {
     const Color dimmed;
 
     // cppcheck-suppress noExplicitConstructor
-    MainColour(Colour basic) : Colour(basic), dimmed(basic.dim(0)) {}
+    constexpr MainColour(Colour basic) : Colour(basic), dimmed(basic.dim(0)) {}
 
-    MainColour(Colour basic, Colour dimmed) noexcept : Colour(basic), dimmed(dimmed) {}
+    constexpr MainColour(Colour basic, Colour dimmed) noexcept : Colour(basic), dimmed(dimmed) {}
 
     // cppcheck-suppress noExplicitConstructor
-    MainColour(std::uint32_t basic) : Colour(basic), dimmed(dim(0.1)) {}
+    constexpr MainColour(std::uint32_t basic) : Colour(basic), dimmed(dim(0.1)) {}
 
-    MainColour(std::uint32_t basic, std::uint32_t dimmed) : Colour(basic), dimmed(dimmed) {}
+    constexpr MainColour(std::uint32_t basic, std::uint32_t dimmed) : Colour(basic), dimmed(dimmed) {}
   };
 
 } // namespace otto::core::ui::vg
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace otto::core::ui::vg::embedded {
+
+  /// A read-only blob linked into the binary.
+  ///
+  /// The definitions are generated from the files under `data/` by
+  /// `cmake/embed_resources.cmake`. The bytes live in `.rodata`, so they are
+  /// demand-paged straight from the executable and shared between processes,
+  /// and loading one is a pointer handoff instead of an SD-card read on the
+  /// boot path - a missing data file can no longer fail startup.
+  struct Resource {
+    const unsigned char* data;
+    unsigned long size;
+  };
+
+  extern const Resource roboto_light;
+  extern const Resource roboto_medium;
+  extern const Resource roboto_black;
+
+} // namespace otto::core::ui::vg::embedded
@@ -5,10 +5,26 @@
 namespace otto::core::ui::vg::icons {
 
   void Arrow::draw(Canvas& ctx) {
-    ctx.save();
-    ctx.lineJoin(LineJoin::ROUND);
-    ctx.lineCap(LineCap::ROUND);
-    ctx.lineWidth(lineWidth);
+    if (dl_.empty() || cached_size_.w != size.w || cached_size_.h != size.h ||
+        cached_line_width_ != lineWidth || cached_dir_ != dir || cached_stopped_ != stopped ||
+        cached_looping_ != looping || cached_head_ratio_ != headRatio) {
+      dl_.clear();
+      record(dl_);
+      cached_size_ = size;
+      cached_line_width_ = lineWidth;
+      cached_dir_ = dir;
+      cached_stopped_ = stopped;
+      cached_looping_ = looping;
+      cached_head_ratio_ = headRatio;
+    }
+    ctx.draw(dl_, colour);
+  }
+
+  void Arrow::record(DisplayList& dl) const {
+    dl.save();
+    dl.lineJoin(LineJoin::ROUND);
+    dl.lineCap(LineCap::ROUND);
+    dl.lineWidth(lineWidth);
 
     if (!looping) {
 
@@ -23,18 +39,18 @@ namespace otto::core::ui::vg::icons {
       case Right:
         s = size.w;
         rsize = size.swapWH();
-        ctx.rotateAround(0.5 * M_PI, Size(s,s).center());
+        dl.rotateAround(0.5 * M_PI, Size(s,s).center());
         break;
       case Down:
         s = size.h;
         rsize = size;
-        ctx.rotateAround(1.0 * M_PI, size.center());
+        dl.rotateAround(1.0 * M_PI, size.center());
         break;
       case Left:
         s = size.w;
         rsize = size.swapWH();
-        ctx.rotateAround(0.5 * M_PI, Size(s,s).center());
-        ctx.rotateAround(1.0 * M_PI, rsize.center());
+        dl.rotateAround(0.5 * M_PI, Size(s,s).center());
+        dl.rotateAround(1.0 * M_PI, rsize.center());
       }
 
       Point start = {rsize.w / 2.f, rsize.h};
@@ -48,29 +64,27 @@ namespace otto::core::ui::vg::icons {
         float(rsize.h * headRatio)
       };
 
-      ctx.beginPath();
-      ctx.moveTo(start);
-      ctx.lineTo(end);
-      ctx.lineTo(cp1);
-      ctx.lineTo(cp2);
-      ctx.lineTo(end);
+      dl.beginPath();
+      dl.moveTo(start);
+      dl.lineTo(end);
+      dl.lineTo(cp1);
+      dl.lineTo(cp2);
+      dl.lineTo(end);
 
       if (stopped) {
-        ctx.moveTo(cp1.x, end.y);
-        ctx.lineTo(cp2.x, end.y);
+        dl.moveTo(cp1.x, end.y);
+        dl.lineTo(cp2.x, end.y);
       }
 
-      ctx.strokeStyle(colour);
-      ctx.fillStyle(colour);
-      ctx.stroke();
-      ctx.fill();
+      dl.stroke();
+      dl.fill();
 
     } else {
 
       // Draw looping arrow.
 
       const float scale = std::min(size.w / 12, size.h / 6);
-      ctx.translate(size.w / 2 - 6 * scale, size.h / 2 - 3 * scale);
+      dl.translate(size.w / 2 - 6 * scale, size.h / 2 - 3 * scale);
 
       const float r   = 3 * scale;
       Point cp1 = Point{5, 0} * scale;
@@ -104,31 +118,30 @@ namespace otto::core::ui::vg::icons {
         break;
       }
 
-      ctx.beginPath();
-      ctx.moveTo(cp1);
-      ctx.lineTo(cp2);
-      ctx.arcTo(ap1, cp3, r);
-      ctx.arcTo(ap2, cp4, r);
-      ctx.lineTo(cp5);
-      ctx.arcTo(ap3, cp6, r);
-      ctx.arcTo(ap4, cp7, r);
-      ctx.lineTo(cp8);
+      dl.beginPath();
+      dl.moveTo(cp1);
+      dl.lineTo(cp2);
+      dl.arcTo(ap1, cp3, r);
+      dl.arcTo(ap2, cp4, r);
+      dl.lineTo(cp5);
+      dl.arcTo(ap3, cp6, r);
+      dl.arcTo(ap4, cp7, r);
+      dl.lineTo(cp8);
 
-      ctx.strokeStyle(colour);
-      ctx.stroke();
+      dl.stroke();
 
       // Arrow head
-      ctx.beginPath();
-      ctx.moveTo(hp1);
-      ctx.lineTo(hp2);
-      ctx.lineTo(hp3);
-      ctx.lineTo(hp1);
-      ctx.fill(colour);
-      ctx.stroke(colour);
+      dl.beginPath();
+      dl.moveTo(hp1);
+      dl.lineTo(hp2);
+      dl.lineTo(hp3);
+      dl.lineTo(hp1);
+      dl.fill();
+      dl.stroke();
 
     }
 
-    ctx.restore();
+    dl.restore();
   }
 
   void Note::draw(Canvas& ctx) {
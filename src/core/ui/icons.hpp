@@ -29,6 +29,20 @@ namespace otto::core::ui::vg::icons {
 
     void draw(Canvas&) override;
 
+  private:
+    void record(DisplayList& dl) const;
+
+    /// Geometry cache - icons are redrawn every frame at unchanging sizes, so
+    /// the path commands are recorded once per parameter set and replayed.
+    /// Colour is applied through the replay override, so colour changes alone
+    /// don't re-record
+    DisplayList dl_;
+    Size cached_size_ = {-1, -1};
+    float cached_line_width_ = -1;
+    Direction cached_dir_ = Right;
+    bool cached_stopped_ = false;
+    bool cached_looping_ = false;
+    float cached_head_ratio_ = -1;
   };
 
   /// A musical note
@@ -77,6 +77,8 @@ namespace otto::nvg {
       nvgCap = NVG_SQUARE;
     else if (cap == LineCap::ROUND)
       nvgCap = NVG_ROUND;
+    if (nvgCap == m_styleState.lineCap) return *this;
+    m_styleState.lineCap = nvgCap;
     nvgLineCap(m_nvgCtx, nvgCap);
     return *this;
   }
@@ -88,12 +90,16 @@ namespace otto::nvg {
       nvgJoin = NVG_ROUND;
     else if (join == LineJoin::MITER)
       nvgJoin = NVG_MITER;
+    if (nvgJoin == m_styleState.lineJoin) return *this;
+    m_styleState.lineJoin = nvgJoin;
     nvgLineJoin(m_nvgCtx, nvgJoin);
     return *this;
   }
 
   Canvas& Canvas::lineWidth(float width)
   {
+    if (width == m_styleState.strokeWidth) return *this;
+    m_styleState.strokeWidth = width;
     nvgStrokeWidth(m_nvgCtx, width);
     return *this;
   }
@@ -107,6 +113,9 @@ namespace otto::nvg {
 
   Canvas& Canvas::fillStyle(const Color& color)
   {
+    if (m_styleState.hasFillColor && m_styleState.fillColor == color) return *this;
+    m_styleState.hasFillColor = true;
+    m_styleState.fillColor = color;
     nvgFillColor(m_nvgCtx, nvgRGBA(color.r, color.g, color.b, color.a));
     return *this;
   }
@@ -114,6 +123,7 @@ namespace otto::nvg {
   Canvas& Canvas::fillStyle(const Paint& paint)
   {
     if (paint.type != Paint::Type::None) {
+      m_styleState.hasFillColor = false;
       NVGpaint npaint = nvgPaint(*this, paint);
       nvgFillPaint(m_nvgCtx, npaint);
     }
@@ -123,6 +133,7 @@ namespace otto::nvg {
   Canvas& Canvas::strokeStyle(const Paint& paint)
   {
     if (paint.type != Paint::Type::None) {
+      m_styleState.hasStrokeColor = false;
       NVGpaint npaint = nvgPaint(*this, paint);
       nvgStrokePaint(m_nvgCtx, npaint);
     }
@@ -131,6 +142,9 @@ namespace otto::nvg {
 
   Canvas& Canvas::strokeStyle(const Color& color)
   {
+    if (m_styleState.hasStrokeColor && m_styleState.strokeColor == color) return *this;
+    m_styleState.hasStrokeColor = true;
+    m_styleState.strokeColor = color;
     nvgStrokeColor(m_nvgCtx, nvgRGBA(color.r, color.g, color.b, color.a));
     return *this;
   }
@@ -192,45 +206,62 @@ namespace otto::nvg {
 
   Canvas& Canvas::font(const Font& font)
   {
-    if (font.valid()) nvgFontFaceId(m_nvgCtx, font.face);
+    if (font.valid() && font.face != m_fontState.face) {
+      nvgFontFaceId(m_nvgCtx, font.face);
+      m_fontState.face = font.face;
+    }
     return *this;
   }
 
   Canvas& Canvas::font(float size)
   {
+    if (size == m_fontState.size) return *this;
     nvgFontSize(m_nvgCtx, size);
+    m_fontState.size = size;
     return *this;
   }
 
   Canvas& Canvas::textAlign(HorizontalAlign hAlign, VerticalAlign vAlign)
   {
-    nvgTextAlign(m_nvgCtx, hAlign | vAlign);
+    int align = hAlign | vAlign;
+    if (align == m_styleState.textAlign) return *this;
+    m_styleState.textAlign = align;
+    nvgTextAlign(m_nvgCtx, align);
     return *this;
   }
 
   void applyTextStyle(Canvas& canvas, const TextStyle& textStyle)
   {
-    if (textStyle.face >= 0) nvgFontFaceId(canvas.nvgContext(), textStyle.face);
+    if (textStyle.face >= 0 && textStyle.face != canvas.m_fontState.face) {
+      nvgFontFaceId(canvas.nvgContext(), textStyle.face);
+      canvas.m_fontState.face = textStyle.face;
+    }
     if (!std::isnan(textStyle.lineHeight)) nvgTextLineHeight(canvas.nvgContext(), textStyle.lineHeight);
     if (std::isnan(textStyle.blur)) nvgFontBlur(canvas.nvgContext(), textStyle.blur);
-    if (!std::isnan(textStyle.letterSpace)) nvgTextLetterSpacing(canvas.nvgContext(), textStyle.letterSpace);
-    nvgTextAlign(canvas.nvgContext(), textStyle.hAlign | textStyle.vAlign);
-    nvgFontSize(canvas.nvgContext(), textStyle.size);
+    if (!std::isnan(textStyle.letterSpace)) {
+      nvgTextLetterSpacing(canvas.nvgContext(), textStyle.letterSpace);
+      canvas.m_fontState.letterSpace = textStyle.letterSpace;
+    }
+    canvas.textAlign(textStyle.hAlign, textStyle.vAlign);
+    canvas.font(textStyle.size);
   }
 
   Canvas& Canvas::fillStyle(const TextStyle& textStyle)
   {
     applyTextStyle(*this, textStyle);
-    nvgFillColor(m_nvgCtx, nvgColor(textStyle.color));
+    fillStyle(textStyle.color);
     return *this;
   }
 
   float Canvas::measureText(const std::string& text, float rowWidth)
   {
     float width = 0;
-    if (std::isnan(rowWidth))
+    if (std::isnan(rowWidth)) {
+      if (auto* cached = m_textMetrics.find(m_fontState.face, m_fontState.size, m_fontState.letterSpace, text))
+        return *cached;
       width = nvgTextBounds(m_nvgCtx, 0, 0, text.c_str(), nullptr, nullptr);
-    else {
+      m_textMetrics.insert(m_fontState.face, m_fontState.size, m_fontState.letterSpace, text, width);
+    } else {
       float bouds[4]{0};
       width = measureText(text, 0, 0, bouds, rowWidth);
     }
@@ -403,14 +434,14 @@ namespace otto::nvg {
     return *this;
   }
 
-  Canvas& Canvas::fillText(const std::string& text, float x, float y, float rowWidth)
+  Canvas& Canvas::fillText(std::string_view text, float x, float y, float rowWidth)
   {
     if (text.length()) {
       local2Global(x, y);
       if (std::isnan(rowWidth))
-        nvgText(m_nvgCtx, x, y, text.c_str(), nullptr);
+        nvgText(m_nvgCtx, x, y, text.data(), text.data() + text.size());
       else
-        nvgTextBox(m_nvgCtx, x, y, rowWidth, text.c_str(), nullptr);
+        nvgTextBox(m_nvgCtx, x, y, rowWidth, text.data(), text.data() + text.size());
     }
     return *this;
   }
@@ -461,18 +492,30 @@ namespace otto::nvg {
   Canvas& Canvas::save()
   {
     nvgSave(m_nvgCtx);
+    m_fontStateStack.push_back(m_fontState);
+    m_styleStateStack.push_back(m_styleState);
     return *this;
   }
 
   Canvas& Canvas::restore()
   {
     nvgRestore(m_nvgCtx);
+    if (!m_fontStateStack.empty()) {
+      m_fontState = m_fontStateStack.back();
+      m_fontStateStack.pop_back();
+    }
+    if (!m_styleStateStack.empty()) {
+      m_styleState = m_styleStateStack.back();
+      m_styleStateStack.pop_back();
+    }
     return *this;
   }
 
   Canvas& Canvas::reset()
   {
     nvgReset(m_nvgCtx);
+    m_fontState = {};
+    m_styleState = {};
     return *this;
   }
 
@@ -519,6 +562,11 @@ namespace otto::nvg {
   Canvas& Canvas::beginFrame(int windowWidth, int windowHeight)
   {
     nvgBeginFrame(m_nvgCtx, windowWidth, windowHeight, m_scaleRatio);
+    // nvgBeginFrame resets the nvg state, so reset the shadow copies too
+    m_fontState = {};
+    m_fontStateStack.clear();
+    m_styleState = {};
+    m_styleStateStack.clear();
     // Clip out side area
     nvgScissor(m_nvgCtx, m_xPos, m_yPos, m_width, m_height);
 
@@ -655,7 +703,7 @@ namespace otto::nvg {
     return *this;
   }
 
-  Canvas& Canvas::fillText(const std::string& text, Point p, float rowWidth)
+  Canvas& Canvas::fillText(std::string_view text, Point p, float rowWidth)
   {
     fillText(text, p.x, p.y, rowWidth);
     return *this;
@@ -734,6 +782,116 @@ namespace otto::nvg {
     restore();
     return *this;
   }
+
+  Canvas& Canvas::draw(const DisplayList& dl)
+  {
+    replayList(dl, nullptr);
+    return *this;
+  }
+
+  Canvas& Canvas::draw(const DisplayList& dl, const Color& color)
+  {
+    replayList(dl, &color);
+    return *this;
+  }
+
+  Canvas& Canvas::drawAt(Point p, const DisplayList& dl)
+  {
+    save();
+    translate(p);
+    draw(dl);
+    restore();
+    return *this;
+  }
+
+  void Canvas::replayList(const DisplayList& dl, const Color* colorOverride)
+  {
+    using Cmd = DisplayList::Cmd;
+    auto is_path_cmd = [](Cmd c) { return c >= Cmd::moveTo && c <= Cmd::closePath; };
+    auto fill_color = [&](const DisplayList::Command& f) -> const Color* {
+      if (colorOverride) return colorOverride;
+      return f.has_color ? &f.color : nullptr;
+    };
+    auto& cmds = dl.commands_;
+    for (std::size_t i = 0; i < cmds.size(); i++) {
+      if (cmds[i].cmd == Cmd::fill) {
+        // Merge `fill, beginPath, <path>, fill` runs with the same opaque
+        // color: the sub paths accumulate into one path filled once, so the
+        // backend emits one draw call for the whole run instead of one per
+        // shape. The display list records no path windings, so every sub path
+        // is normalized to solid and the merged fill covers the same pixels.
+        // Translucent fills are left alone - merged, their overlaps would
+        // blend only once
+        const Color* fc = fill_color(cmds[i]);
+        while (fc && fc->a == 0xFF && i + 1 < cmds.size() && cmds[i + 1].cmd == Cmd::beginPath) {
+          std::size_t j = i + 2;
+          while (j < cmds.size() && is_path_cmd(cmds[j].cmd)) j++;
+          if (j >= cmds.size() || cmds[j].cmd != Cmd::fill) break;
+          const Color* next = fill_color(cmds[j]);
+          if (next == nullptr || !(Color(*fc) == *next)) break;
+          for (std::size_t k = i + 2; k < j; k++) replayCommand(dl, cmds[k], colorOverride);
+          i = j;
+        }
+      }
+      replayCommand(dl, cmds[i], colorOverride);
+    }
+  }
+
+  void Canvas::replayCommand(const DisplayList& dl, const DisplayList::Command& c, const Color* colorOverride)
+  {
+    using Cmd = DisplayList::Cmd;
+    auto& a = c.args;
+    switch (c.cmd) {
+      case Cmd::beginPath: beginPath(); break;
+      case Cmd::moveTo: moveTo(a[0], a[1]); break;
+      case Cmd::lineTo: lineTo(a[0], a[1]); break;
+      case Cmd::arcTo: arcTo(a[0], a[1], a[2], a[3], a[4]); break;
+      case Cmd::quadraticCurveTo: quadraticCurveTo(a[0], a[1], a[2], a[3]); break;
+      case Cmd::bezierCurveTo: bezierCurveTo(a[0], a[1], a[2], a[3], a[4], a[5]); break;
+      case Cmd::arc: arc(a[0], a[1], a[2], a[3], a[4], a[5] != 0.f); break;
+      case Cmd::circle: circle(a[0], a[1], a[2]); break;
+      case Cmd::ellipse: ellipse(a[0], a[1], a[2], a[3]); break;
+      case Cmd::rect: rect(a[0], a[1], a[2], a[3]); break;
+      case Cmd::roundedRect: roundedRect(a[0], a[1], a[2], a[3], a[4]); break;
+      case Cmd::closePath: closePath(); break;
+      case Cmd::fill:
+        if (colorOverride)
+          fill(*colorOverride);
+        else if (c.has_color)
+          fill(c.color);
+        else
+          fill();
+        break;
+      case Cmd::stroke:
+        if (colorOverride)
+          stroke(*colorOverride);
+        else if (c.has_color)
+          stroke(c.color);
+        else
+          stroke();
+        break;
+      case Cmd::fillStyle: fillStyle(colorOverride ? *colorOverride : c.color); break;
+      case Cmd::strokeStyle: strokeStyle(colorOverride ? *colorOverride : c.color); break;
+      case Cmd::lineWidth: lineWidth(a[0]); break;
+      case Cmd::lineCap: lineCap(static_cast<LineCap>(int(a[0]))); break;
+      case Cmd::lineJoin: lineJoin(static_cast<LineJoin>(int(a[0]))); break;
+      case Cmd::fontFace:
+        if (int(a[0]) >= 0 && int(a[0]) != m_fontState.face) {
+          nvgFontFaceId(m_nvgCtx, int(a[0]));
+          m_fontState.face = int(a[0]);
+        }
+        break;
+      case Cmd::fontSize: font(a[0]); break;
+      case Cmd::textAlign:
+        textAlign(TextAlign::HorizontalAlign(int(a[0])), TextAlign::VerticalAlign(int(a[1])));
+        break;
+      case Cmd::fillText: fillText(dl.strings_[std::size_t(a[0])], a[1], a[2], a[3]); break;
+      case Cmd::save: save(); break;
+      case Cmd::restore: restore(); break;
+      case Cmd::translate: translate(a[0], a[1]); break;
+      case Cmd::rotateAround: rotateAround(a[0], {a[1], a[2]}); break;
+    }
+  }
   // Debuging
 
   Canvas& Canvas::debugDot(Point p, Color c)
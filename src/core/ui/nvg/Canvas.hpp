@@ -1,8 +1,10 @@
 #pragma once
 
 #include <functional>
+#include <string_view>
 
 #include "Color.hpp"
+#include "DisplayList.hpp"
 #include "Image.hpp"
 #include "Paint.hpp"
 #include "Text.hpp"
@@ -327,8 +329,8 @@ namespace otto::nvg {
      * @param rowWidth The max row width of the text box,NAN is not limited
      * @return The canvas to operate with
      */
-    Canvas& fillText(const std::string& text, float x, float y, float rowWidth = NAN);
-    Canvas& fillText(const std::string& text, Point p, float rowWidth = NAN);
+    Canvas& fillText(std::string_view text, float x, float y, float rowWidth = NAN);
+    Canvas& fillText(std::string_view text, Point p, float rowWidth = NAN);
 
     /**
      * @brief Draws an image onto the canvas
@@ -367,6 +369,15 @@ namespace otto::nvg {
 
     Canvas& drawAt(Point p, Drawable& d);
 
+    /// Replay a recorded display list under the current transform. @see DisplayList
+    Canvas& draw(const DisplayList& dl);
+
+    /// Replay a recorded display list, with `color` replacing all recorded colors
+    Canvas& draw(const DisplayList& dl, const Color& color);
+
+    /// Replay a recorded display list translated to `p`
+    Canvas& drawAt(Point p, const DisplayList& dl);
+
     template<typename FuncRef>
     Canvas& group(FuncRef&& func);
 
@@ -877,6 +888,51 @@ namespace otto::nvg {
     }
 
   protected:
+    friend void applyTextStyle(Canvas&, const TextStyle&);
+
+    /// Replay a single display list command. `colorOverride` replaces the recorded
+    /// colors when non-null
+    void replayCommand(const DisplayList& dl, const DisplayList::Command& c, const Color* colorOverride);
+
+    /// Replay a whole display list, merging runs of same-colored opaque fills
+    /// into a single path filled once - one draw call in the GL backend
+    /// instead of one per shape
+    void replayList(const DisplayList& dl, const Color* colorOverride);
+
+    /// Shadow copy of the nvg font state. Forms the text metrics cache key, and is
+    /// kept in sync through @ref font, @ref save / @ref restore and @ref beginFrame
+    struct FontState {
+      int face = -1;
+      float size = 16; // NanoVG's default font size
+      float letterSpace = 0;
+    };
+
+    /// Shadow copy of the nvg style state, used to skip state calls that set
+    /// what is already set. Every redundant call still costs per-state work in
+    /// the backend flush, and screens set the same handful of colors and line
+    /// styles over and over - once per icon, text run or widget. Kept in sync
+    /// the same way as {@ref FontState}
+    struct StyleState {
+      bool hasFillColor = false;
+      Color fillColor;
+      bool hasStrokeColor = false;
+      Color strokeColor;
+      /// Negative means unknown
+      float strokeWidth = -1;
+      /// The nvg line cap value, -1 when unknown
+      int lineCap = -1;
+      /// The nvg line join value, -1 when unknown
+      int lineJoin = -1;
+      /// The combined nvg align flags, -1 when unknown
+      int textAlign = -1;
+    };
+
+    FontState m_fontState;
+    std::vector<FontState> m_fontStateStack;
+    StyleState m_styleState;
+    std::vector<StyleState> m_styleStateStack;
+    TextMetricsCache m_textMetrics;
+
     /// The NanoVG context
     NVGcontext* m_nvgCtx;
     /// The width of the canvas
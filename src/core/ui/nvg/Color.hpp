@@ -11,7 +11,7 @@ namespace otto::nvg {
   using Byte = unsigned char;
 
   struct Color : ColorConverter::Rgba {
-    Color()
+    constexpr Color()
     {
       r = g = b = a = 0;
     }
@@ -20,7 +20,7 @@ namespace otto::nvg {
      * @brief Construct a color with an unsigned integer value
      * @param color The color code value
      */
-    Color(const unsigned int color)
+    constexpr Color(const unsigned int color)
     {
       set(color);
     }
@@ -32,7 +32,7 @@ namespace otto::nvg {
      * @param _b The blue component value
      * @param _a The alpha component value
      */
-    Color(Byte _r, Byte _g, Byte _b, Byte _a = 255)
+    constexpr Color(Byte _r, Byte _g, Byte _b, Byte _a = 255)
     {
       set(_r, _g, _b, _a);
     }
@@ -44,7 +44,7 @@ namespace otto::nvg {
      * @param _b The blue component value
      * @param _a The alpha component value
      */
-    Color(int _r, int _g, int _b, int _a = 255)
+    constexpr Color(int _r, int _g, int _b, int _a = 255)
     {
       set(_r, _g, _b, _a);
     }
@@ -56,7 +56,7 @@ namespace otto::nvg {
      * @param _b The blue component value
      * @param _a The alpha component value
      */
-    Color(unsigned _r, unsigned _g, unsigned _b, unsigned _a = 255)
+    constexpr Color(unsigned _r, unsigned _g, unsigned _b, unsigned _a = 255)
     {
       set(_r, _g, _b, _a);
     }
@@ -68,13 +68,13 @@ namespace otto::nvg {
      * @param _b The blue component value
      * @param _a The alpha component value
      */
-    Color(float _r, float _g, float _b, float _a = 1.0f)
+    constexpr Color(float _r, float _g, float _b, float _a = 1.0f)
     {
       set(_r, _g, _b, _a);
     }
 
     /// Convert the color to unsigned int as the color code
-    inline operator unsigned int() const
+    constexpr operator unsigned int() const
     {
       return code();
     }
@@ -100,21 +100,21 @@ namespace otto::nvg {
       }
     }
 
-    inline bool operator==(const Color& color)
+    constexpr bool operator==(const Color& color)
     {
       return code() == color.code();
     }
-    inline bool operator<(const Color& color)
+    constexpr bool operator<(const Color& color)
     {
       return code() < color.code();
     }
 
-    inline Color& operator=(const unsigned int color)
+    constexpr Color& operator=(const unsigned int color)
     {
       return set(color);
     }
 
-    Color& operator+=(const Color& color)
+    constexpr Color& operator+=(const Color& color)
     {
       r = std::clamp<Byte>(r + color.r, 0, UCHAR_MAX);
       g = std::clamp<Byte>(g + color.g, 0, UCHAR_MAX);
@@ -123,7 +123,7 @@ namespace otto::nvg {
       return *this;
     }
 
-    Color& operator-=(const Color& color)
+    constexpr Color& operator-=(const Color& color)
     {
       using std::max;
       r = std::clamp<Byte>(r - color.r, 0, UCHAR_MAX);
@@ -133,7 +133,7 @@ namespace otto::nvg {
       return *this;
     }
 
-    Color& operator*=(const Color& color)
+    constexpr Color& operator*=(const Color& color)
     {
       r = std::clamp<Byte>(r + (color.r * color.a / UCHAR_MAX), 0, UCHAR_MAX);
       g = std::clamp<Byte>(g + (color.g * color.a / UCHAR_MAX), 0, UCHAR_MAX);
@@ -141,28 +141,28 @@ namespace otto::nvg {
       return *this;
     }
 
-    Color operator+(const Color& color)
+    constexpr Color operator+(const Color& color)
     {
       Color ret(*this);
       ret += color;
       return ret;
     }
 
-    Color operator-(const Color& color)
+    constexpr Color operator-(const Color& color)
     {
       Color ret(*this);
       ret -= color;
       return ret;
     }
 
-    Color operator*(const Color& color)
+    constexpr Color operator*(const Color& color)
     {
       Color ret(*this);
       ret *= color;
       return ret;
     }
 
-    inline Color& set(unsigned int color)
+    constexpr Color& set(unsigned int color)
     {
       r = (Byte)(color >> 24U);
       g = (Byte)((color >> 16U) & 0x00ffU);
@@ -171,7 +171,7 @@ namespace otto::nvg {
       return *this;
     }
 
-    inline Color& set(float _r, float _g, float _b, float _a)
+    constexpr Color& set(float _r, float _g, float _b, float _a)
     {
       r = std::clamp<Byte>((Byte)(_r * UCHAR_MAX), 0, UCHAR_MAX);
       g = std::clamp<Byte>((Byte)(_g * UCHAR_MAX), 0, UCHAR_MAX);
@@ -180,7 +180,7 @@ namespace otto::nvg {
       return *this;
     }
 
-    inline Color& set(Byte _r, Byte _g, Byte _b, Byte _a)
+    constexpr Color& set(Byte _r, Byte _g, Byte _b, Byte _a)
     {
       r = _r;
       g = _g;
@@ -189,7 +189,7 @@ namespace otto::nvg {
       return *this;
     }
 
-    inline Color& set(unsigned _r, unsigned _g, unsigned _b, unsigned _a)
+    constexpr Color& set(unsigned _r, unsigned _g, unsigned _b, unsigned _a)
     {
       r = (Byte) _r;
       g = (Byte) _g;
@@ -198,7 +198,7 @@ namespace otto::nvg {
       return *this;
     }
 
-    inline Color& set(int _r, int _g, int _b, int _a)
+    constexpr Color& set(int _r, int _g, int _b, int _a)
     {
       r = (Byte) _r;
       g = (Byte) _g;
@@ -207,10 +207,10 @@ namespace otto::nvg {
       return *this;
     }
 
-    static Color floats(float r, float g, float b, float a = 1);
-    static Color bytes(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 0xFF);
+    static constexpr Color floats(float r, float g, float b, float a = 1);
+    static constexpr Color bytes(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 0xFF);
 
-    inline unsigned int code() const
+    constexpr unsigned int code() const
     {
       unsigned int color = 0U;
       color |= (r << 24U);
@@ -220,45 +220,45 @@ namespace otto::nvg {
       return color;
     }
 
-    inline float redf() const
+    constexpr float redf() const
     {
       return r / 255.0f;
     }
-    inline float greenf() const
+    constexpr float greenf() const
     {
       return g / 255.0f;
     }
-    inline float bluef() const
+    constexpr float bluef() const
     {
       return b / 255.0f;
     }
-    inline float alphaf() const
+    constexpr float alphaf() const
     {
       return a / 255.0f;
     }
 
-    static Color createWidthHSL(float _h, float _s, float _l, float _a = 1.0f)
+    static constexpr Color createWidthHSL(float _h, float _s, float _l, float _a = 1.0f)
     {
       Rgb rgb = ColorConverter::hslToRgb(_h, _s, _l);
       return {rgb.r, rgb.g, rgb.b, Byte(_a * 255)};
     }
 
-    Color mix(Color c, float ratio) const;
-    Color dim(float amount) const;
-    Color brighten(float amount) const;
+    constexpr Color mix(Color c, float ratio) const;
+    constexpr Color dim(float amount) const;
+    constexpr Color brighten(float amount) const;
   };
 
-  inline Color Color::floats(float r, float g, float b, float a)
+  constexpr Color Color::floats(float r, float g, float b, float a)
   {
     return Color(r * 255, g * 255, b * 255, a * 255);
   }
 
-  inline Color Color::bytes(Byte r, Byte g, Byte b, Byte a)
+  constexpr Color Color::bytes(Byte r, Byte g, Byte b, Byte a)
   {
     return Color(r, g, b, a);
   }
 
-  inline Color Color::mix(Color c, float ratio) const
+  constexpr Color Color::mix(Color c, float ratio) const
   {
     Color ret;
     ret.r = std::clamp<uint8_t>(r + (c.r - r) * ratio, 0x00, 0xFF);
@@ -268,7 +268,7 @@ namespace otto::nvg {
     return ret;
   }
 
-  inline Color Color::dim(float amount) const
+  constexpr Color Color::dim(float amount) const
   {
     float dim = std::clamp(1.f - amount, 0.f, 1.f);
     Color ret;
@@ -279,7 +279,7 @@ namespace otto::nvg {
     return ret;
   }
 
-  inline Color Color::brighten(float amount) const
+  constexpr Color Color::brighten(float amount) const
   {
     Color ret;
     ret.r = std::clamp<uint8_t>(r + (255 - r) * amount, 0x00, 0xFF);
@@ -289,151 +289,152 @@ namespace otto::nvg {
     return ret;
   }
 
+  /// The named colors, as compile time constants in read-only memory
   namespace Colors {
-    static Color ZeroColor = 0U;
-    static Color AliceBlue = 0xF0F8FFFF;
-    static Color AntiqueWhile = 0xFAEBD7FF;
-    static Color Aqua = 0x00FFFFFF;
-    static Color Aquamarine = 0x7FFFd4FF;
-    static Color Azure = 0xF0FFFFFF;
-    static Color Beiqe = 0xF5F5DCFF;
-    static Color Bisque = 0xFFE4C4FF;
-    static Color Black = 0x000000FF;
-    static Color BlanchedAlmond = 0xFFEBCDFF;
-    static Color Blue = 0x0000FFFF;
-    static Color BlueViolet = 0x8A2BE2FF;
-    static Color Brown = 0xA52A2AFF;
-    static Color BurlyWood = 0xDEB887FF;
-    static Color CadetBlue = 0x5F9EA0FF;
-    static Color Chartreuse = 0x7FFF00FF;
-    static Color Chocolate = 0xD2691EFF;
-    static Color Coral = 0xFF7F50FF;
-    static Color CornflowerBlue = 0x6495EDFF;
-    static Color Cornsilk = 0xFFF8DCFF;
-    static Color Crimson = 0xDC143CFF;
-    static Color Cyan = 0x00FFFFFF;
-    static Color DarkBlue = 0x00008BFF;
-    static Color DarkCyan = 0x008B8BFF;
-    static Color DarkGoldenRod = 0xB8860BFF;
-    static Color DarkGray = 0xA9A9A9FF;
-    static Color DarkGreen = 0x006400FF;
-    static Color DarkKhaki = 0xBDB76BFF;
-    static Color DarkMagenta = 0x8B008BFF;
-    static Color DarkOliveGreen = 0x556B2FFF;
-    static Color Darkorange = 0xFF8C00FF;
-    static Color DarkOrchid = 0x9932CCFF;
-    static Color DarkRed = 0x8B0000FF;
-    static Color DarkSalmon = 0xE9967AFF;
-    static Color DarkSeaGreen = 0x8FBC8FFF;
-    static Color DarkSlateBlue = 0x483D8BFF;
-    static Color DarkSlateGray = 0x2F4F4FFF;
-    static Color DarkTurquoise = 0x00CED1FF;
-    static Color DarkViolet = 0x9400D3FF;
-    static Color DeepPink = 0xFF1493FF;
-    static Color DeepSkyBlue = 0x00BFFFFF;
-    static Color DimGray = 0x696969FF;
-    static Color DodgerBlue = 0x1E90FFFF;
-    static Color Feldspar = 0xD19275FF;
-    static Color FireBrick = 0xB22222FF;
-    static Color FloralWhite = 0xFFFAF0FF;
-    static Color ForestGreen = 0x228B22FF;
-    static Color Fuchsia = 0xFF00FFFF;
-    static Color Gainsboro = 0xDCDCDCFF;
-    static Color GhostWhite = 0xF8F8FFFF;
-    static Color Gold = 0xFFD700FF;
-    static Color GoldenRod = 0xDAA520FF;
-    static Color Gray = 0x808080FF;
-    static Color Green = 0x008000FF;
-    static Color GreenYellow = 0xADFF2FFF;
-    static Color HoneyDew = 0xF0FFF0FF;
-    static Color HotPink = 0xFF69B4FF;
-    static Color IndianRed = 0xCD5C5CFF;
-    static Color Indigo = 0x4B0082FF;
-    static Color Ivory = 0xFFFFF0FF;
-    static Color Khaki = 0xF0E68CFF;
-    static Color Lavender = 0xE6E6FAFF;
-    static Color LavenderBlush = 0xFFF0F5FF;
-    static Color LawnGreen = 0x7CFC00FF;
-    static Color LemonChiffon = 0xFFFACDFF;
-    static Color LightBlue = 0xADD8E6FF;
-    static Color LightCoral = 0xF08080FF;
-    static Color LightCyan = 0xE0FFFFFF;
-    static Color LightGoldenRodYellow = 0xFAFAD2FF;
-    static Color LightGrey = 0xD3D3D3FF;
-    static Color LightGreen = 0x90EE90FF;
-    static Color LightPink = 0xFFB6C1FF;
-    static Color LightSalmon = 0xFFA07AFF;
-    static Color LightSeaGreen = 0x20B2AAFF;
-    static Color LightSkyBlue = 0x87CEFAFF;
-    static Color LightSlateBlue = 0x8470FFFF;
-    static Color LightSlateGray = 0x778899FF;
-    static Color LightSteelBlue = 0xB0C4DEFF;
-    static Color LightYellow = 0xFFFFE0FF;
-    static Color Lime = 0x00FF00FF;
-    static Color LimeGreen = 0x32CD32FF;
-    static Color Linen = 0xFAF0E6FF;
-    static Color Magenta = 0xFF00FFFF;
-    static Color Maroon = 0x800000FF;
-    static Color MediumAquaMarine = 0x66CDAAFF;
-    static Color MediumBlue = 0x0000CDFF;
-    static Color MediumOrchid = 0xBA55D3FF;
-    static Color MediumPurple = 0x9370D8FF;
-    static Color MediumSeaGreen = 0x3CB371FF;
-    static Color MediumSlateBlue = 0x7B68EEFF;
-    static Color MediumSpringGreen = 0x00FA9AFF;
-    static Color MediumTurquoise = 0x48D1CCFF;
-    static Color MediumVioletRed = 0xC71585FF;
-    static Color MidnightBlue = 0x191970FF;
-    static Color MintCream = 0xF5FFFAFF;
-    static Color MistyRose = 0xFFE4E1FF;
-    static Color Moccasin = 0xFFE4B5FF;
-    static Color NavajoWhite = 0xFFDEADFF;
-    static Color Navy = 0x000080FF;
-    static Color OldLace = 0xFDF5E6FF;
-    static Color Olive = 0x808000FF;
-    static Color OliveDrab = 0x6B8E23FF;
-    static Color Orange = 0xFFA500FF;
-    static Color OrangeRed = 0xFFA500FF;
-    static Color Orchid = 0xDA70D6FF;
-    static Color PaleGoldenRod = 0xEEE8AAFF;
-    static Color PaleGreen = 0x98FB98FF;
-    static Color PaleTurquoise = 0xAFEEEEFF;
-    static Color PaleVioletRed = 0xD87093FF;
-    static Color PapayaWhip = 0xFFEFD5FF;
-    static Color PeachPuff = 0xFFDAB9FF;
-    static Color Peru = 0xCD853FFF;
-    static Color Pink = 0xFFC0CBFF;
-    static Color Plum = 0xDDA0DDFF;
-    static Color PowderBlue = 0xB0E0E6FF;
-    static Color Purple = 0x800080FF;
-    static Color Red = 0xFF0000FF;
-    static Color RosyBrown = 0xBC8F8FFF;
-    static Color RoyalBlue = 0x4169E1FF;
-    static Color SaddleBrown = 0x8B4513FF;
-    static Color Salmon = 0xFA8072FF;
-    static Color SandyBrown = 0xF4A460FF;
-    static Color SeaGreen = 0x2E8B57FF;
-    static Color SeaShell = 0xFFF5EEFF;
-    static Color Sienna = 0xA0522DFF;
-    static Color Silver = 0xC0C0C0FF;
-    static Color SkyBlue = 0x87CEEBFF;
-    static Color SlateBlue = 0x6A5ACDFF;
-    static Color SlateGray = 0x708090FF;
-    static Color Snow = 0xFFFAFAFF;
-    static Color SpringGreen = 0x00FF7FFF;
-    static Color SteelBlue = 0x4682B4FF;
-    static Color Tan = 0xD2B48CFF;
-    static Color Teal = 0x008080FF;
-    static Color Thistle = 0xD8BFD8FF;
-    static Color Tomato = 0xFF6347FF;
-    static Color Turquoise = 0x40E0D0FF;
-    static Color Violet = 0xEE82EEFF;
-    static Color VioletRed = 0xD02090FF;
-    static Color Wheat = 0xF5DEB3FF;
-    static Color White = 0xFFFFFFFF;
-    static Color WhiteSmoke = 0xF5F5F5FF;
-    static Color Yellow = 0xFFFF00FF;
-    static Color YellowGreen = 0x9ACD32FF;
+    inline constexpr Color ZeroColor = 0U;
+    inline constexpr Color AliceBlue = 0xF0F8FFFF;
+    inline constexpr Color AntiqueWhile = 0xFAEBD7FF;
+    inline constexpr Color Aqua = 0x00FFFFFF;
+    inline constexpr Color Aquamarine = 0x7FFFd4FF;
+    inline constexpr Color Azure = 0xF0FFFFFF;
+    inline constexpr Color Beiqe = 0xF5F5DCFF;
+    inline constexpr Color Bisque = 0xFFE4C4FF;
+    inline constexpr Color Black = 0x000000FF;
+    inline constexpr Color BlanchedAlmond = 0xFFEBCDFF;
+    inline constexpr Color Blue = 0x0000FFFF;
+    inline constexpr Color BlueViolet = 0x8A2BE2FF;
+    inline constexpr Color Brown = 0xA52A2AFF;
+    inline constexpr Color BurlyWood = 0xDEB887FF;
+    inline constexpr Color CadetBlue = 0x5F9EA0FF;
+    inline constexpr Color Chartreuse = 0x7FFF00FF;
+    inline constexpr Color Chocolate = 0xD2691EFF;
+    inline constexpr Color Coral = 0xFF7F50FF;
+    inline constexpr Color CornflowerBlue = 0x6495EDFF;
+    inline constexpr Color Cornsilk = 0xFFF8DCFF;
+    inline constexpr Color Crimson = 0xDC143CFF;
+    inline constexpr Color Cyan = 0x00FFFFFF;
+    inline constexpr Color DarkBlue = 0x00008BFF;
+    inline constexpr Color DarkCyan = 0x008B8BFF;
+    inline constexpr Color DarkGoldenRod = 0xB8860BFF;
+    inline constexpr Color DarkGray = 0xA9A9A9FF;
+    inline constexpr Color DarkGreen = 0x006400FF;
+    inline constexpr Color DarkKhaki = 0xBDB76BFF;
+    inline constexpr Color DarkMagenta = 0x8B008BFF;
+    inline constexpr Color DarkOliveGreen = 0x556B2FFF;
+    inline constexpr Color Darkorange = 0xFF8C00FF;
+    inline constexpr Color DarkOrchid = 0x9932CCFF;
+    inline constexpr Color DarkRed = 0x8B0000FF;
+    inline constexpr Color DarkSalmon = 0xE9967AFF;
+    inline constexpr Color DarkSeaGreen = 0x8FBC8FFF;
+    inline constexpr Color DarkSlateBlue = 0x483D8BFF;
+    inline constexpr Color DarkSlateGray = 0x2F4F4FFF;
+    inline constexpr Color DarkTurquoise = 0x00CED1FF;
+    inline constexpr Color DarkViolet = 0x9400D3FF;
+    inline constexpr Color DeepPink = 0xFF1493FF;
+    inline constexpr Color DeepSkyBlue = 0x00BFFFFF;
+    inline constexpr Color DimGray = 0x696969FF;
+    inline constexpr Color DodgerBlue = 0x1E90FFFF;
+    inline constexpr Color Feldspar = 0xD19275FF;
+    inline constexpr Color FireBrick = 0xB22222FF;
+    inline constexpr Color FloralWhite = 0xFFFAF0FF;
+    inline constexpr Color ForestGreen = 0x228B22FF;
+    inline constexpr Color Fuchsia = 0xFF00FFFF;
+    inline constexpr Color Gainsboro = 0xDCDCDCFF;
+    inline constexpr Color GhostWhite = 0xF8F8FFFF;
+    inline constexpr Color Gold = 0xFFD700FF;
+    inline constexpr Color GoldenRod = 0xDAA520FF;
+    inline constexpr Color Gray = 0x808080FF;
+    inline constexpr Color Green = 0x008000FF;
+    inline constexpr Color GreenYellow = 0xADFF2FFF;
+    inline constexpr Color HoneyDew = 0xF0FFF0FF;
+    inline constexpr Color HotPink = 0xFF69B4FF;
+    inline constexpr Color IndianRed = 0xCD5C5CFF;
+    inline constexpr Color Indigo = 0x4B0082FF;
+    inline constexpr Color Ivory = 0xFFFFF0FF;
+    inline constexpr Color Khaki = 0xF0E68CFF;
+    inline constexpr Color Lavender = 0xE6E6FAFF;
+    inline constexpr Color LavenderBlush = 0xFFF0F5FF;
+    inline constexpr Color LawnGreen = 0x7CFC00FF;
+    inline constexpr Color LemonChiffon = 0xFFFACDFF;
+    inline constexpr Color LightBlue = 0xADD8E6FF;
+    inline constexpr Color LightCoral = 0xF08080FF;
+    inline constexpr Color LightCyan = 0xE0FFFFFF;
+    inline constexpr Color LightGoldenRodYellow = 0xFAFAD2FF;
+    inline constexpr Color LightGrey = 0xD3D3D3FF;
+    inline constexpr Color LightGreen = 0x90EE90FF;
+    inline constexpr Color LightPink = 0xFFB6C1FF;
+    inline constexpr Color LightSalmon = 0xFFA07AFF;
+    inline constexpr Color LightSeaGreen = 0x20B2AAFF;
+    inline constexpr Color LightSkyBlue = 0x87CEFAFF;
+    inline constexpr Color LightSlateBlue = 0x8470FFFF;
+    inline constexpr Color LightSlateGray = 0x778899FF;
+    inline constexpr Color LightSteelBlue = 0xB0C4DEFF;
+    inline constexpr Color LightYellow = 0xFFFFE0FF;
+    inline constexpr Color Lime = 0x00FF00FF;
+    inline constexpr Color LimeGreen = 0x32CD32FF;
+    inline constexpr Color Linen = 0xFAF0E6FF;
+    inline constexpr Color Magenta = 0xFF00FFFF;
+    inline constexpr Color Maroon = 0x800000FF;
+    inline constexpr Color MediumAquaMarine = 0x66CDAAFF;
+    inline constexpr Color MediumBlue = 0x0000CDFF;
+    inline constexpr Color MediumOrchid = 0xBA55D3FF;
+    inline constexpr Color MediumPurple = 0x9370D8FF;
+    inline constexpr Color MediumSeaGreen = 0x3CB371FF;
+    inline constexpr Color MediumSlateBlue = 0x7B68EEFF;
+    inline constexpr Color MediumSpringGreen = 0x00FA9AFF;
+    inline constexpr Color MediumTurquoise = 0x48D1CCFF;
+    inline constexpr Color MediumVioletRed = 0xC71585FF;
+    inline constexpr Color MidnightBlue = 0x191970FF;
+    inline constexpr Color MintCream = 0xF5FFFAFF;
+    inline constexpr Color MistyRose = 0xFFE4E1FF;
+    inline constexpr Color Moccasin = 0xFFE4B5FF;
+    inline constexpr Color NavajoWhite = 0xFFDEADFF;
+    inline constexpr Color Navy = 0x000080FF;
+    inline constexpr Color OldLace = 0xFDF5E6FF;
+    inline constexpr Color Olive = 0x808000FF;
+    inline constexpr Color OliveDrab = 0x6B8E23FF;
+    inline constexpr Color Orange = 0xFFA500FF;
+    inline constexpr Color OrangeRed = 0xFFA500FF;
+    inline constexpr Color Orchid = 0xDA70D6FF;
+    inline constexpr Color PaleGoldenRod = 0xEEE8AAFF;
+    inline constexpr Color PaleGreen = 0x98FB98FF;
+    inline constexpr Color PaleTurquoise = 0xAFEEEEFF;
+    inline constexpr Color PaleVioletRed = 0xD87093FF;
+    inline constexpr Color PapayaWhip = 0xFFEFD5FF;
+    inline constexpr Color PeachPuff = 0xFFDAB9FF;
+    inline constexpr Color Peru = 0xCD853FFF;
+    inline constexpr Color Pink = 0xFFC0CBFF;
+    inline constexpr Color Plum = 0xDDA0DDFF;
+    inline constexpr Color PowderBlue = 0xB0E0E6FF;
+    inline constexpr Color Purple = 0x800080FF;
+    inline constexpr Color Red = 0xFF0000FF;
+    inline constexpr Color RosyBrown = 0xBC8F8FFF;
+    inline constexpr Color RoyalBlue = 0x4169E1FF;
+    inline constexpr Color SaddleBrown = 0x8B4513FF;
+    inline constexpr Color Salmon = 0xFA8072FF;
+    inline constexpr Color SandyBrown = 0xF4A460FF;
+    inline constexpr Color SeaGreen = 0x2E8B57FF;
+    inline constexpr Color SeaShell = 0xFFF5EEFF;
+    inline constexpr Color Sienna = 0xA0522DFF;
+    inline constexpr Color Silver = 0xC0C0C0FF;
+    inline constexpr Color SkyBlue = 0x87CEEBFF;
+    inline constexpr Color SlateBlue = 0x6A5ACDFF;
+    inline constexpr Color SlateGray = 0x708090FF;
+    inline constexpr Color Snow = 0xFFFAFAFF;
+    inline constexpr Color SpringGreen = 0x00FF7FFF;
+    inline constexpr Color SteelBlue = 0x4682B4FF;
+    inline constexpr Color Tan = 0xD2B48CFF;
+    inline constexpr Color Teal = 0x008080FF;
+    inline constexpr Color Thistle = 0xD8BFD8FF;
+    inline constexpr Color Tomato = 0xFF6347FF;
+    inline constexpr Color Turquoise = 0x40E0D0FF;
+    inline constexpr Color Violet = 0xEE82EEFF;
+    inline constexpr Color VioletRed = 0xD02090FF;
+    inline constexpr Color Wheat = 0xF5DEB3FF;
+    inline constexpr Color White = 0xFFFFFFFF;
+    inline constexpr Color WhiteSmoke = 0xF5F5F5FF;
+    inline constexpr Color Yellow = 0xFFFF00FF;
+    inline constexpr Color YellowGreen = 0x9ACD32FF;
   } // namespace Colors
 
   /** @brief Get hex code string from color */
@@ -18,22 +18,22 @@ namespace otto::nvg::ColorConverter {
     byte a = 0;
   };
 
-  inline double clamp(double x, double a, double b)
+  constexpr double clamp(double x, double a, double b)
   {
     return x < a ? a : (x > b ? b : x);
   }
 
-  inline double threeway_max(double a, double b, double c)
+  constexpr double threeway_max(double a, double b, double c)
   {
     return std::max(a, std::max(b, c));
   }
 
-  inline double threeway_min(double a, double b, double c)
+  constexpr double threeway_min(double a, double b, double c)
   {
     return std::min(a, std::min(b, c));
   }
 
-  inline double hue2rgb(double h, double m1, double m2)
+  constexpr double hue2rgb(double h, double m1, double m2)
   {
     if (h < 0.0) h += 1.0;
     if (h > 1.0) h -= 1.0;
@@ -58,11 +58,11 @@ namespace otto::nvg::ColorConverter {
    * @param   double  l       The lightness
    * @return  Rgb   The RGB representation
    */
-  inline Rgb hslToRgb(double h, double s, double l)
+  constexpr Rgb hslToRgb(double h, double s, double l)
   {
-    double m1, m2;
-    double useless;
-    h = std::modf(h, &useless);
+    double m1 = 0.0, m2 = 0.0;
+    // Take the fractional part. std::modf is not constexpr
+    h = h - double((long long) h);
     if (h < 0.0) h += 1.0;
     s = clamp(s, 0.0, 1.0);
     l = clamp(l, 0.0, 1.0);
@@ -87,9 +87,29 @@ namespace otto::nvg::ColorConverter {
    * @param   byte    b       The blue color value
    * @param   double  hsl[]   The HSL representation
    */
-  inline void rgbToHsl(byte r, byte g, byte b, double hsl[])
+  constexpr void rgbToHsl(byte r, byte g, byte b, double hsl[])
   {
-    // TODO:
+    double rf = r / 255.0, gf = g / 255.0, bf = b / 255.0;
+    double max = threeway_max(rf, gf, bf);
+    double min = threeway_min(rf, gf, bf);
+    double l = (max + min) / 2.0;
+    double h = 0.0, s = 0.0;
+
+    if (max != min) {
+      double d = max - min;
+      s = l > 0.5 ? d / (2.0 - max - min) : d / (max + min);
+      if (max == rf)
+        h = (gf - bf) / d + (gf < bf ? 6.0 : 0.0);
+      else if (max == gf)
+        h = (bf - rf) / d + 2.0;
+      else
+        h = (rf - gf) / d + 4.0;
+      h /= 6.0;
+    }
+
+    hsl[0] = h;
+    hsl[1] = s;
+    hsl[2] = l;
   }
 
 
@@ -104,9 +124,29 @@ namespace otto::nvg::ColorConverter {
    * @param   byte  b       The blue color value
    * @return  double hsv[]  The HSV representation
    */
-  inline void rgbToHsv(byte r, byte g, byte b, double hsv[])
+  constexpr void rgbToHsv(byte r, byte g, byte b, double hsv[])
   {
-    // TODO:
+    double rf = r / 255.0, gf = g / 255.0, bf = b / 255.0;
+    double max = threeway_max(rf, gf, bf);
+    double min = threeway_min(rf, gf, bf);
+    double v = max;
+    double d = max - min;
+    double s = max == 0.0 ? 0.0 : d / max;
+    double h = 0.0;
+
+    if (max != min) {
+      if (max == rf)
+        h = (gf - bf) / d + (gf < bf ? 6.0 : 0.0);
+      else if (max == gf)
+        h = (bf - rf) / d + 2.0;
+      else
+        h = (rf - gf) / d + 4.0;
+      h /= 6.0;
+    }
+
+    hsv[0] = h;
+    hsv[1] = s;
+    hsv[2] = v;
   }
 
   /**
@@ -120,8 +160,31 @@ namespace otto::nvg::ColorConverter {
    * @param   double  v       The value
    * @return  byte    rgb[]   The RGB representation
    */
-  inline void hsvToRgb(double h, double s, double v, byte rgb[])
+  constexpr void hsvToRgb(double h, double s, double v, byte rgb[])
   {
-    // TODO:
+    h = h - double((long long) h);
+    if (h < 0.0) h += 1.0;
+    s = clamp(s, 0.0, 1.0);
+    v = clamp(v, 0.0, 1.0);
+
+    int i = int(h * 6.0);
+    double f = h * 6.0 - i;
+    double p = v * (1.0 - s);
+    double q = v * (1.0 - f * s);
+    double t = v * (1.0 - (1.0 - f) * s);
+
+    double r = 0.0, g = 0.0, b = 0.0;
+    switch (i % 6) {
+      case 0: r = v, g = t, b = p; break;
+      case 1: r = q, g = v, b = p; break;
+      case 2: r = p, g = v, b = t; break;
+      case 3: r = p, g = q, b = v; break;
+      case 4: r = t, g = p, b = v; break;
+      case 5: r = v, g = p, b = q; break;
+    }
+
+    rgb[0] = byte(r * 255);
+    rgb[1] = byte(g * 255);
+    rgb[2] = byte(b * 255);
   }
 }; // namespace otto::nvg::ColorConverter
@@ -0,0 +1,267 @@
+#include "DisplayList.hpp"
+
+#include "Canvas.hpp"
+
+namespace otto::nvg {
+
+  DisplayList::Command& DisplayList::add(Cmd cmd)
+  {
+    return commands_.emplace_back(Command{cmd});
+  }
+
+  DisplayList& DisplayList::beginPath()
+  {
+    add(Cmd::beginPath);
+    return *this;
+  }
+
+  DisplayList& DisplayList::moveTo(float x, float y)
+  {
+    add(Cmd::moveTo).args = {x, y};
+    return *this;
+  }
+
+  DisplayList& DisplayList::moveTo(Point p)
+  {
+    return moveTo(p.x, p.y);
+  }
+
+  DisplayList& DisplayList::lineTo(float x, float y)
+  {
+    add(Cmd::lineTo).args = {x, y};
+    return *this;
+  }
+
+  DisplayList& DisplayList::lineTo(Point p)
+  {
+    return lineTo(p.x, p.y);
+  }
+
+  DisplayList& DisplayList::arcTo(float x1, float y1, float x2, float y2, float r)
+  {
+    add(Cmd::arcTo).args = {x1, y1, x2, y2, r};
+    return *this;
+  }
+
+  DisplayList& DisplayList::arcTo(Point p1, Point p2, float r)
+  {
+    return arcTo(p1.x, p1.y, p2.x, p2.y, r);
+  }
+
+  DisplayList& DisplayList::quadraticCurveTo(float cpx, float cpy, float x, float y)
+  {
+    add(Cmd::quadraticCurveTo).args = {cpx, cpy, x, y};
+    return *this;
+  }
+
+  DisplayList& DisplayList::quadraticCurveTo(Point control, Point end)
+  {
+    return quadraticCurveTo(control.x, control.y, end.x, end.y);
+  }
+
+  DisplayList& DisplayList::bezierCurveTo(float cp1x, float cp1y, float cp2x, float cp2y, float x, float y)
+  {
+    add(Cmd::bezierCurveTo).args = {cp1x, cp1y, cp2x, cp2y, x, y};
+    return *this;
+  }
+
+  DisplayList& DisplayList::bezierCurveTo(Point cp1, Point cp2, Point end)
+  {
+    return bezierCurveTo(cp1.x, cp1.y, cp2.x, cp2.y, end.x, end.y);
+  }
+
+  DisplayList& DisplayList::arc(float x, float y, float r, float sAngle, float eAngle, bool counterclockwise)
+  {
+    add(Cmd::arc).args = {x, y, r, sAngle, eAngle, counterclockwise ? 1.f : 0.f};
+    return *this;
+  }
+
+  DisplayList& DisplayList::arc(Point cp, float r, float sAngle, float eAngle, bool counterclockwise)
+  {
+    return arc(cp.x, cp.y, r, sAngle, eAngle, counterclockwise);
+  }
+
+  DisplayList& DisplayList::circle(float cx, float cy, float r)
+  {
+    add(Cmd::circle).args = {cx, cy, r};
+    return *this;
+  }
+
+  DisplayList& DisplayList::circle(Point p, float r)
+  {
+    return circle(p.x, p.y, r);
+  }
+
+  DisplayList& DisplayList::ellipse(float cx, float cy, float rx, float ry)
+  {
+    add(Cmd::ellipse).args = {cx, cy, rx, ry};
+    return *this;
+  }
+
+  DisplayList& DisplayList::ellipse(Point p, float rx, float ry)
+  {
+    return ellipse(p.x, p.y, rx, ry);
+  }
+
+  DisplayList& DisplayList::rect(float x, float y, float w, float h)
+  {
+    add(Cmd::rect).args = {x, y, w, h};
+    return *this;
+  }
+
+  DisplayList& DisplayList::rect(Point p, Size s)
+  {
+    return rect(p.x, p.y, s.w, s.h);
+  }
+
+  DisplayList& DisplayList::rect(Box b)
+  {
+    return rect(b.x, b.y, b.width, b.height);
+  }
+
+  DisplayList& DisplayList::roundedRect(float x, float y, float w, float h, float r)
+  {
+    add(Cmd::roundedRect).args = {x, y, w, h, r};
+    return *this;
+  }
+
+  DisplayList& DisplayList::roundedRect(Point p, Size s, float r)
+  {
+    return roundedRect(p.x, p.y, s.w, s.h, r);
+  }
+
+  DisplayList& DisplayList::closePath()
+  {
+    add(Cmd::closePath);
+    return *this;
+  }
+
+  DisplayList& DisplayList::fill()
+  {
+    add(Cmd::fill);
+    return *this;
+  }
+
+  DisplayList& DisplayList::fill(const Color& color)
+  {
+    auto& c = add(Cmd::fill);
+    c.has_color = true;
+    c.color = color;
+    return *this;
+  }
+
+  DisplayList& DisplayList::stroke()
+  {
+    add(Cmd::stroke);
+    return *this;
+  }
+
+  DisplayList& DisplayList::stroke(const Color& color)
+  {
+    auto& c = add(Cmd::stroke);
+    c.has_color = true;
+    c.color = color;
+    return *this;
+  }
+
+  DisplayList& DisplayList::fillStyle(const Color& color)
+  {
+    auto& c = add(Cmd::fillStyle);
+    c.has_color = true;
+    c.color = color;
+    return *this;
+  }
+
+  DisplayList& DisplayList::strokeStyle(const Color& color)
+  {
+    auto& c = add(Cmd::strokeStyle);
+    c.has_color = true;
+    c.color = color;
+    return *this;
+  }
+
+  DisplayList& DisplayList::lineWidth(float width)
+  {
+    add(Cmd::lineWidth).args = {width};
+    return *this;
+  }
+
+  DisplayList& DisplayList::lineCap(LineCap cap)
+  {
+    add(Cmd::lineCap).args = {float(static_cast<int>(cap))};
+    return *this;
+  }
+
+  DisplayList& DisplayList::lineJoin(LineJoin join)
+  {
+    add(Cmd::lineJoin).args = {float(static_cast<int>(join))};
+    return *this;
+  }
+
+  DisplayList& DisplayList::font(const Font& f)
+  {
+    add(Cmd::fontFace).args = {float(f.face)};
+    return *this;
+  }
+
+  DisplayList& DisplayList::font(float size)
+  {
+    add(Cmd::fontSize).args = {size};
+    return *this;
+  }
+
+  DisplayList& DisplayList::font(const Font& f, float size)
+  {
+    font(f);
+    font(size);
+    return *this;
+  }
+
+  DisplayList& DisplayList::textAlign(TextAlign::HorizontalAlign hAlign, TextAlign::VerticalAlign vAlign)
+  {
+    add(Cmd::textAlign).args = {float(hAlign), float(vAlign)};
+    return *this;
+  }
+
+  DisplayList& DisplayList::fillText(std::string_view text, float x, float y, float rowWidth)
+  {
+    strings_.emplace_back(text);
+    add(Cmd::fillText).args = {float(strings_.size() - 1), x, y, rowWidth};
+    return *this;
+  }
+
+  DisplayList& DisplayList::fillText(std::string_view text, Point p, float rowWidth)
+  {
+    return fillText(text, p.x, p.y, rowWidth);
+  }
+
+  DisplayList& DisplayList::save()
+  {
+    add(Cmd::save);
+    return *this;
+  }
+
+  DisplayList& DisplayList::restore()
+  {
+    add(Cmd::restore);
+    return *this;
+  }
+
+  DisplayList& DisplayList::translate(float x, float y)
+  {
+    add(Cmd::translate).args = {x, y};
+    return *this;
+  }
+
+  DisplayList& DisplayList::translate(Point p)
+  {
+    return translate(p.x, p.y);
+  }
+
+  DisplayList& DisplayList::rotateAround(float r, Point p)
+  {
+    add(Cmd::rotateAround).args = {r, p.x, p.y};
+    return *this;
+  }
+
+} // namespace otto::nvg
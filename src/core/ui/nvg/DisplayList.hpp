@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Color.hpp"
+#include "Text.hpp"
+#include "util.hpp"
+
+namespace otto::nvg {
+
+  struct Canvas; // FWDCL
+  enum struct LineCap;
+  enum struct LineJoin;
+
+  /// A recorded sequence of canvas commands that can be replayed cheaply.
+  ///
+  /// Screens rebuild a lot of identical geometry every frame - icons, rings,
+  /// routing diagrams - re-running the code that computed the paths each time. A
+  /// display list records the path commands once, and `Canvas::draw(const
+  /// DisplayList&)` replays them without that work. Replay runs under the current
+  /// canvas transform, so one list can be stamped at several positions with
+  /// `drawAt`, and can override the recorded colors. Transform and line-style
+  /// state (`save`/`restore`, `translate`, `rotateAround`, `lineCap`,
+  /// `lineJoin`) records too, so a whole drawable can be captured as-is.
+  ///
+  /// Text records too (`font`, `textAlign`, `fillText`), so static chrome like
+  /// parameter labels can be cached along with its geometry - see
+  /// {@ref core::ui::Screen::draw_static}.
+  ///
+  /// To invalidate, `clear()` the list when a property the geometry depends on
+  /// changes, and rebuild lazily in the draw function:
+  ///
+  /// ```cpp
+  /// if (icon_dl.empty()) build_icon(icon_dl);
+  /// ctx.draw(icon_dl);
+  /// ```
+  struct DisplayList {
+    DisplayList& beginPath();
+    DisplayList& moveTo(float x, float y);
+    DisplayList& moveTo(Point p);
+    DisplayList& lineTo(float x, float y);
+    DisplayList& lineTo(Point p);
+    DisplayList& arcTo(float x1, float y1, float x2, float y2, float r);
+    DisplayList& arcTo(Point p1, Point p2, float r);
+    DisplayList& quadraticCurveTo(float cpx, float cpy, float x, float y);
+    DisplayList& quadraticCurveTo(Point control, Point end);
+    DisplayList& bezierCurveTo(float cp1x, float cp1y, float cp2x, float cp2y, float x, float y);
+    DisplayList& bezierCurveTo(Point cp1, Point cp2, Point end);
+    DisplayList& arc(float x, float y, float r, float sAngle, float eAngle, bool counterclockwise = false);
+    DisplayList& arc(Point cp, float r, float sAngle, float eAngle, bool counterclockwise = false);
+    DisplayList& circle(float cx, float cy, float r);
+    DisplayList& circle(Point p, float r);
+    DisplayList& ellipse(float cx, float cy, float rx, float ry);
+    DisplayList& ellipse(Point p, float rx, float ry);
+    DisplayList& rect(float x, float y, float w, float h);
+    DisplayList& rect(Point p, Size s);
+    DisplayList& rect(Box b);
+    DisplayList& roundedRect(float x, float y, float w, float h, float r);
+    DisplayList& roundedRect(Point p, Size s, float r);
+    DisplayList& closePath();
+
+    DisplayList& fill();
+    DisplayList& fill(const Color& color);
+    DisplayList& stroke();
+    DisplayList& stroke(const Color& color);
+
+    DisplayList& fillStyle(const Color& color);
+    DisplayList& strokeStyle(const Color& color);
+    DisplayList& lineWidth(float width);
+    DisplayList& lineCap(LineCap cap);
+    DisplayList& lineJoin(LineJoin join);
+
+    DisplayList& font(const Font& f);
+    DisplayList& font(float size);
+    DisplayList& font(const Font& f, float size);
+    DisplayList& textAlign(TextAlign::HorizontalAlign hAlign, TextAlign::VerticalAlign vAlign);
+    DisplayList& fillText(std::string_view text, float x, float y, float rowWidth = NAN);
+    DisplayList& fillText(std::string_view text, Point p, float rowWidth = NAN);
+
+    DisplayList& save();
+    DisplayList& restore();
+    DisplayList& translate(float x, float y);
+    DisplayList& translate(Point p);
+    DisplayList& rotateAround(float r, Point p);
+
+    /// Is there anything recorded? Use to rebuild lazily after a `clear()`
+    bool empty() const noexcept
+    {
+      return commands_.empty();
+    }
+
+    /// Throw away the recorded commands. Call when a property the recorded
+    /// geometry depends on changes
+    void clear() noexcept
+    {
+      commands_.clear();
+      strings_.clear();
+    }
+
+  private:
+    friend Canvas;
+
+    enum struct Cmd : std::uint8_t {
+      beginPath,
+      moveTo,
+      lineTo,
+      arcTo,
+      quadraticCurveTo,
+      bezierCurveTo,
+      arc,
+      circle,
+      ellipse,
+      rect,
+      roundedRect,
+      closePath,
+      fill,
+      stroke,
+      fillStyle,
+      strokeStyle,
+      lineWidth,
+      lineCap,
+      lineJoin,
+      fontFace,
+      fontSize,
+      textAlign,
+      fillText,
+      save,
+      restore,
+      translate,
+      rotateAround,
+    };
+
+    struct Command {
+      Cmd cmd;
+      bool has_color = false;
+      std::array<float, 6> args = {};
+      Color color;
+    };
+
+    Command& add(Cmd cmd);
+
+    std::vector<Command> commands_;
+    /// The text of recorded `fillText` commands - the command stores an index
+    /// into this in `args[0]`
+    std::vector<std::string> strings_;
+  };
+
+} // namespace otto::nvg
@@ -20,4 +20,26 @@ namespace otto::nvg {
     }
     name = fname;
   }
+
+  std::size_t TextMetricsCache::KeyHash::operator()(const Key& k) const noexcept
+  {
+    std::size_t res = std::hash<std::string>{}(k.text);
+    res ^= std::hash<int>{}(k.face) + 0x9e3779b9 + (res << 6) + (res >> 2);
+    res ^= std::hash<float>{}(k.size) + 0x9e3779b9 + (res << 6) + (res >> 2);
+    res ^= std::hash<float>{}(k.letterSpace) + 0x9e3779b9 + (res << 6) + (res >> 2);
+    return res;
+  }
+
+  const float* TextMetricsCache::find(int face, float size, float letterSpace, const std::string& text) const
+  {
+    auto found = entries_.find(Key{face, size, letterSpace, text});
+    if (found == entries_.end()) return nullptr;
+    return &found->second;
+  }
+
+  void TextMetricsCache::insert(int face, float size, float letterSpace, std::string text, float width)
+  {
+    if (entries_.size() >= max_entries) entries_.clear();
+    entries_.emplace(Key{face, size, letterSpace, std::move(text)}, width);
+  }
 } // namespace NanoCanvas
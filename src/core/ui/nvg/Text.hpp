@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "Color.hpp"
 #include "util.hpp"
 
@@ -74,6 +76,46 @@ namespace otto::nvg {
     };
   } // namespace TextAlign
 
+  /// Caches single-line text advance widths.
+  ///
+  /// Screens measure mostly stable strings (parameter names, preset names) every
+  /// frame, and each measurement makes fontstash re-shape the run. The cache keys
+  /// on the font state that affects metrics, so a string is only shaped again when
+  /// it, the font, the size or the letter spacing changes. The whole cache is
+  /// dropped if it grows past `max_entries`.
+  struct TextMetricsCache {
+    /// Look up a cached width. Returns `nullptr` on a miss
+    const float* find(int face, float size, float letterSpace, const std::string& text) const;
+
+    void insert(int face, float size, float letterSpace, std::string text, float width);
+
+    void clear() noexcept
+    {
+      entries_.clear();
+    }
+
+  private:
+    static constexpr std::size_t max_entries = 1024;
+
+    struct Key {
+      int face;
+      float size;
+      float letterSpace;
+      std::string text;
+
+      bool operator==(const Key& rhs) const noexcept
+      {
+        return face == rhs.face && size == rhs.size && letterSpace == rhs.letterSpace && text == rhs.text;
+      }
+    };
+
+    struct KeyHash {
+      std::size_t operator()(const Key& k) const noexcept;
+    };
+
+    std::unordered_map<Key, float, KeyHash> entries_;
+  };
+
   /// Text style description structure
   /// @note The text alignment of text is formed by horizontal alignment and vertical alignemt
   struct TextStyle {
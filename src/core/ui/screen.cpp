@@ -2,6 +2,65 @@
 
 #include "core/ui/vector_graphics.hpp"
 
+#include <algorithm>
+
 namespace otto::core::ui {
 
+  void Screen::invalidate(vg::Box area) noexcept
+  {
+    tracks_damage_ = true;
+    if (full_damage_) return;
+    // Clamp to the screen, so the scissor never grows past it
+    float x0 = std::clamp(area.x, 0.f, vg::width);
+    float y0 = std::clamp(area.y, 0.f, vg::height);
+    float x1 = std::clamp(area.x + area.width, 0.f, vg::width);
+    float y1 = std::clamp(area.y + area.height, 0.f, vg::height);
+    if (x1 <= x0 || y1 <= y0) return;
+    if (damage_.width == 0 || damage_.height == 0) {
+      damage_ = {x0, y0, x1 - x0, y1 - y0};
+      return;
+    }
+    auto pmin = damage_.pmin();
+    auto pmax = damage_.pmax();
+    damage_ = {vg::Point{std::min(pmin.x, x0), std::min(pmin.y, y0)},
+               vg::Point{std::max(pmax.x, x1), std::max(pmax.y, y1)}};
+  }
+
+  void Screen::invalidate_all() noexcept
+  {
+    full_damage_ = true;
+  }
+
+  bool Screen::has_partial_damage() const noexcept
+  {
+    return tracks_damage_ && !full_damage_;
+  }
+
+  vg::Box Screen::damage() const noexcept
+  {
+    return damage_;
+  }
+
+  void Screen::clear_damage() noexcept
+  {
+    full_damage_ = false;
+    damage_ = {};
+  }
+
+  void Screen::draw_static_layer(vg::Canvas& ctx)
+  {
+    if (!static_recorded_) {
+      static_dl_.clear();
+      draw_static(static_dl_);
+      static_recorded_ = true;
+    }
+    ctx.draw(static_dl_);
+  }
+
+  void Screen::invalidate_static() noexcept
+  {
+    static_recorded_ = false;
+    invalidate_all();
+  }
+
 } // namespace otto::core::ui
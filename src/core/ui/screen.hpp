@@ -56,6 +56,56 @@ namespace otto::core::ui {
 
     /// Run by MainUI when switching to another screen
     virtual void on_hide() {}
+
+    /// Record the static parts of the screen - background and chrome that stay
+    /// the same from frame to frame.
+    ///
+    /// Override this and call @ref draw_static_layer at the top of the draw
+    /// function. The recording is kept and replayed until
+    /// @ref invalidate_static, so the layout code only runs when the chrome
+    /// actually changes.
+    virtual void draw_static(vg::DisplayList&) {}
+
+    /// Replay the cached static layer, recording it through @ref draw_static
+    /// first if it has been invalidated.
+    void draw_static_layer(vg::Canvas& ctx);
+
+    /// Throw away the cached static layer, so @ref draw_static runs again on
+    /// the next frame.
+    ///
+    /// Call when state the static chrome depends on changes. Also invalidates
+    /// the whole screen, since the chrome is not bounded by the damage box.
+    void invalidate_static() noexcept;
+
+    /// Mark an area of the screen as needing a redraw.
+    ///
+    /// The first call also opts the screen into partial redraws - screens that never
+    /// invalidate are fully redrawn every frame, as before. Damage accumulates as a
+    /// bounding box until the next frame is drawn, when MainUI scissors the canvas to
+    /// it and calls @ref clear_damage.
+    void invalidate(vg::Box area) noexcept;
+
+    /// Mark the entire screen as needing a redraw
+    void invalidate_all() noexcept;
+
+    /// Does only part of the screen need redrawing this frame?
+    bool has_partial_damage() const noexcept;
+
+    /// The bounding box of the areas invalidated since the last frame.
+    ///
+    /// Only meaningful when @ref has_partial_damage returns true.
+    vg::Box damage() const noexcept;
+
+    /// Called by MainUI after the frame has been drawn
+    void clear_damage() noexcept;
+
+  private:
+    bool tracks_damage_ = false;
+    bool full_damage_ = true;
+    vg::Box damage_;
+
+    vg::DisplayList static_dl_;
+    bool static_recorded_ = false;
   };
 
 } // namespace otto::core::ui
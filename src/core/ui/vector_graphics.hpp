@@ -2,6 +2,7 @@
 
 #include <fmt/format.h>
 #include "core/ui/canvas.hpp"
+#include "core/ui/embedded_fonts.hpp"
 #include "services/log_manager.hpp"
 #include "util/filesystem.hpp"
 
@@ -10,20 +11,24 @@ namespace otto::core::ui::vg {
   constexpr float width = 320;
   constexpr float height = 240;
 
+  /// The OTTO palette. Everything here is a compile time constant in read-only
+  /// memory, and since all of {@ref Colour}'s operations are constexpr, fixed
+  /// variants like `Colours::Blue.mix(Colours::White, 0.5)` fold to constants
+  /// too instead of redoing the float math on every frame.
   namespace Colours {
-    const Colour Black = Colour(0x000000FF);
+    inline constexpr Colour Black = Colour(0x000000FF);
 
-    const MainColour White = {0xFFFFFFFF, 0x646464FF};
-    const MainColour Yellow = {0xFAB700FF, 0x646464FF};
-    const MainColour Red = {0xE6332AFF, 0x6E0C0CFF};
-    const MainColour Green = {0x5ECF3EFF, 0x0C6E0CFF};
-    const MainColour Blue = {0x009EE3FF, 0x0C0C6EFF};
+    inline constexpr MainColour White = {0xFFFFFFFF, 0x646464FF};
+    inline constexpr MainColour Yellow = {0xFAB700FF, 0x646464FF};
+    inline constexpr MainColour Red = {0xE6332AFF, 0x6E0C0CFF};
+    inline constexpr MainColour Green = {0x5ECF3EFF, 0x0C6E0CFF};
+    inline constexpr MainColour Blue = {0x009EE3FF, 0x0C0C6EFF};
 
-    const Colour Gray50 = 0x646464FF;
-    const Colour Gray60 = 0x999999FF;
-    const Colour Gray70 = 0xB2B2B2FF;
+    inline constexpr Colour Gray50 = 0x646464FF;
+    inline constexpr Colour Gray60 = 0x999999FF;
+    inline constexpr Colour Gray70 = 0xB2B2B2FF;
 
-    const Colour Pink = 0xEE7AAAFF;
+    inline constexpr Colour Pink = 0xEE7AAAFF;
   } // namespace Colours
 
   namespace Fonts {
@@ -31,26 +36,61 @@ namespace otto::core::ui::vg {
     inline Font Norm;
     inline Font Bold;
 
-    inline const fs::path font_dir{"data/fonts"};
-
-    inline void loadFont(Canvas& ctx, Font& font, const std::string& name)
+    /// Hand an embedded font to nanovg.
+    ///
+    /// The data is linked into the binary - see {@ref embedded::Resource} -
+    /// so this is a pointer handoff, with no file I/O on the boot path.
+    /// `invalidateMem` stays false: the bytes are `.rodata`, not ours to free
+    inline void loadFont(Canvas& ctx, Font& font, const std::string& name, const embedded::Resource& res)
     {
-      auto path = Fonts::font_dir / (name + ".ttf");
-      font = Font(ctx, name, path);
-      if (!Fonts::Light.valid()) {
-        LOG_F(ERROR, "Invalid font: {}", Fonts::Light.name);
-        if (!fs::exists(path)) {
-          LOG_F(ERROR, "Font file not found: {}", path);
-        }
+      font = Font(ctx, name, Memery{const_cast<unsigned char*>(res.data), res.size}, false);
+      if (!font.valid()) {
+        LOG_F(ERROR, "Invalid font: {}", name);
       }
     }
   } // namespace Fonts
 
+  /// Rasterize the glyphs screens draw into the fontstash atlas up front.
+  ///
+  /// The first frame that needs a glyph at a new size pays its rasterization
+  /// inside the draw loop, visible as a hitch when entering a screen with an
+  /// unusual size. Drawing every face/size pair once into a cancelled frame
+  /// at startup fills the atlas while nothing is on screen yet - the glyphs
+  /// stay resident, so steady-state frames never rasterize. Runs on the ui
+  /// thread with the context current, like all canvas work.
+  inline void preRasterizeGlyphs(Canvas& ctx)
+  {
+    /// The printable ascii range covers digits, parameter names and units
+    static constexpr const char* glyphs =
+      " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+    struct FaceSizes {
+      const Font* font;
+      std::initializer_list<float> sizes;
+    };
+    /// Every size a screen actually uses. A new `ctx.font(...)` size only
+    /// costs a one-frame hitch until it is added here
+    const FaceSizes sets[] = {
+      {&Fonts::Norm, {15, 20, 22, 25, 30, 35, 40, 42, 60}},
+      {&Fonts::Bold, {26, 30}},
+    };
+    ctx.beginFrame(width, height);
+    for (auto& [font, sizes] : sets) {
+      for (float size : sizes) {
+        ctx.font(*font, size);
+        ctx.fillText(glyphs, 0, 0);
+      }
+    }
+    // The atlas keeps the rasterized glyphs - only the draw calls are dropped
+    ctx.cancelFrame();
+  }
+
   inline void initUtils(Canvas& ctx)
   {
-    Fonts::loadFont(ctx, Fonts::Light, "Roboto-Light");
-    Fonts::loadFont(ctx, Fonts::Norm, "Roboto-Medium");
-    Fonts::loadFont(ctx, Fonts::Bold, "Roboto-Black");
+    Fonts::loadFont(ctx, Fonts::Light, "Roboto-Light", embedded::roboto_light);
+    Fonts::loadFont(ctx, Fonts::Norm, "Roboto-Medium", embedded::roboto_medium);
+    Fonts::loadFont(ctx, Fonts::Bold, "Roboto-Black", embedded::roboto_black);
+    preRasterizeGlyphs(ctx);
   }
 
 } // namespace otto::core::ui::vg
@@ -85,6 +85,16 @@ namespace otto::core::ui::widgets {
       }
     }
 
+    /// Invalidate the cached points.
+    ///
+    /// Call when the audio under the viewed range has changed. When the change
+    /// is new audio appended at the end and the view scrolls to follow it, the
+    /// refresh only averages the new tail - see {@ref PointCache::refresh}.
+    void invalidate() noexcept
+    {
+      point_cache.discard_bins();
+    }
+
     /// Get the graphical point for a sample index
     vg::Point point(int index)
     {
@@ -129,6 +139,18 @@ namespace otto::core::ui::widgets {
         : wf (*wf)
       {}
 
+      /// Drop the cached bin values and mark the cache stale.
+      ///
+      /// Needed when the audio under the cached bins has changed - a plain
+      /// {@ref invalidate} keeps them, since they only depend on the grid.
+      void discard_bins() noexcept
+      {
+        bins.clear();
+        bins_complete = 0;
+        bins_sp2r = -1.f;
+        this->invalidate();
+      }
+
     private:
 
       void refresh() override;
@@ -138,6 +160,19 @@ namespace otto::core::ui::widgets {
       /// Clamp value to container size
       std::size_t clamp(std::size_t) const;
 
+      /// The averaged value of each bin on the current grid. Bin values only
+      /// depend on the audio and the grid, so they survive refreshes as long
+      /// as the zoom is unchanged - scrolling and appends reuse them.
+      std::vector<float> bins;
+      /// The grid index of `bins.front()`
+      int bins_first = 0;
+      /// The grid the bins were averaged on. Bins are dropped when it changes
+      float bins_sp2r = -1.f;
+      /// The number of leading bins that were fully inside the container. A
+      /// trailing partial bin is re-averaged on the next refresh, when more of
+      /// its slot may have been recorded
+      int bins_complete = 0;
+
     } point_cache {this};
 
 
@@ -218,38 +253,57 @@ namespace otto::core::ui::widgets {
     points.clear();
 
     if (wf._range.size() == 0 || wf.container.size() == 0) {
+      bins.clear();
+      bins_complete = 0;
+      bins_sp2r = -1.f;
       return;
     }
 
     sp2r = 2 * radius * smpl_pr_px;
-    double error = 0.f;
-    auto first = std::begin(wf.container);
-    auto fidx = clamp(std::floor(wf._range.in / sp2r) * sp2r);
-    auto lidx = clamp(std::ceil(wf._range.out / sp2r) * sp2r);
-    auto iter = first + fidx;
-    auto last = first + lidx;
-    float start_x = (int(fidx) - int(wf._range.in)) / smpl_pr_px;
-    for (int i = 0; iter != last; i++, iter++) {
-      double intprt = 0;
-      error = std::modf(error + sp2r, &intprt);
-
-      // Average:
+    // The bins are on an absolute grid - bin `k` averages the samples in
+    // `[k * sp2r, (k + 1) * sp2r)` - so their values are independent of the
+    // view offset and can be reused between refreshes
+    int first_bin = int(std::floor(wf._range.in / sp2r));
+    int last_bin = std::max(first_bin + 1, int(std::ceil(wf._range.out / sp2r)));
+
+    // Drop a trailing partial bin, so it is re-averaged below
+    bins.resize(bins_complete);
+    if (sp2r != bins_sp2r || first_bin < bins_first ||
+        first_bin > bins_first + int(bins.size())) {
+      // The grid changed (zoom) or the view jumped - start over
+      bins.clear();
+      bins_first = first_bin;
+      bins_sp2r = sp2r;
+    } else if (first_bin > bins_first) {
+      // The view scrolled forward - drop the bins that scrolled out
+      bins.erase(bins.begin(), bins.begin() + (first_bin - bins_first));
+      bins_first = first_bin;
+    }
+
+    // Average the bins not covered by the cache - in the steady state this
+    // loop runs zero times, and when audio is appended at the end it only
+    // touches the new tail
+    for (int k = bins_first + int(bins.size()); k < last_bin; k++) {
+      auto from = clamp(std::size_t(double(k) * sp2r));
+      auto to = clamp(std::size_t(double(k + 1) * sp2r));
+      if (from >= to) break;
       float sum = 0.f;
-      for (int j = 0; (j < intprt) && (iter != last); j++, iter++) {
+      for (auto iter = std::begin(wf.container) + from,
+                last = std::begin(wf.container) + to;
+           iter != last; ++iter) {
         sum += std::abs(*iter);
       }
-      float val = sum / intprt;
-      // Max
-      // float val = 0;
-      // for (int j = 0; (j < intprt) && (iter != last); j++, iter++) {
-      //   val = std::max(std::abs(*iter), val);
-      // }
-
-      points.emplace_back(
-        start_x + i * 2 * radius,
-        (1 - std::min(val / wf._top_val, 1.f)) * wf.size.h);
-      // Required, as iter might otherwise be incremented twice with no check
-      if (iter == last) break;
+      bins.push_back(sum / float(to - from));
+    }
+    bins_complete = int(bins.size());
+    while (bins_complete > 0 &&
+           std::size_t(double(bins_first + bins_complete) * sp2r) > wf.container.size()) {
+      bins_complete--;
+    }
+
+    for (int i = 0; i < int(bins.size()); i++) {
+      points.emplace_back((float(bins_first + i) * sp2r - wf._range.in) / smpl_pr_px,
+                          (1 - std::min(bins[i] / wf._top_val, 1.f)) * wf.size.h);
     }
 
     // Align points if they are too close
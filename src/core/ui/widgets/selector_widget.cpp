@@ -22,23 +22,30 @@ namespace otto::core::ui {
 
     vitems = std::min(vitems, nitems() - _top_item);
 
-    for (int i = 0; i < vitems; i++) {
-      const int idx = _top_item + i;
+    // Only the rows in view are laid out, and only when the view changes -
+    // every other frame just replays the recording
+    if (_rows_dl.empty() || _top_item != _rows_dl_top) {
+      _rows_dl_top = _top_item;
+      _rows_dl.clear();
+      for (int i = 0; i < vitems; i++) {
+        const int idx = _top_item + i;
 
-      if (idx == _selected_item) {
-        ctx.beginPath();
-        ctx.rect({0, i * options.item_height}, {size.w, options.item_height});
-        // ctx.fill(Colours::Black); - in case you want the background back
-        ctx.fillStyle(options.selected_item_colour);
-      } else {
-        ctx.fillStyle(options.item_colour);
+        if (idx == _selected_item) {
+          _rows_dl.beginPath();
+          _rows_dl.rect({0, i * options.item_height}, {size.w, options.item_height});
+          // _rows_dl.fill(Colours::Black); - in case you want the background back
+          _rows_dl.fillStyle(options.selected_item_colour);
+        } else {
+          _rows_dl.fillStyle(options.item_colour);
+        }
+        _rows_dl.beginPath();
+        _rows_dl.textAlign(TextAlign::Left, TextAlign::Middle);
+        _rows_dl.font(Fonts::Norm, options.font_size);
+        _rows_dl.fillText((*_items)[idx], {5.f, (i + 1.f) * options.item_height},
+                          size.w - 10.f);
       }
-      ctx.beginPath();
-      ctx.textAlign(TextAlign::Left, TextAlign::Middle);
-      ctx.font(Fonts::Norm, options.font_size);
-      ctx.fillText((*_items)[idx], {5.f, (i + 1.f) * options.item_height},
-                   size.w - 10.f);
     }
+    ctx.draw(_rows_dl);
   }
 
   bool SelectorWidget::prev(int n) noexcept
@@ -60,6 +67,7 @@ namespace otto::core::ui {
     if (idx == _selected_item) return true;
     if (idx < 0 || idx >= nitems()) return false;
     _selected_item = idx;
+    _rows_dl.clear();
     if (!no_callback) options.on_select(idx);
     return true;
   }
@@ -85,6 +93,7 @@ namespace otto::core::ui {
     _items = &vec;
     _top_item = 0;
     _selected_item = 0;
+    _rows_dl.clear();
     return *_items;
   }
 } // namespace otto::core::ui
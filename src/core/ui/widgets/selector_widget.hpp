@@ -89,5 +89,11 @@ namespace otto::core::ui {
     int _selected_item = 0;
     int _top_item = 0;
     const std::vector<std::string> * _items;
+
+    /// The visible rows, recorded once and replayed every frame until the
+    /// selection, scroll position or item list changes. Keeps the frame cost
+    /// of long preset lists independent of the list size
+    vg::DisplayList _rows_dl;
+    int _rows_dl_top = -1;
   };
 }
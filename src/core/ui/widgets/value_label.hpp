@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+
+#include <fmt/format.h>
+
+#include "core/ui/vector_graphics.hpp"
+#include "util/signals.hpp"
+
+namespace otto::core::ui {
+
+  /// A formatted value label with a cached string.
+  ///
+  /// Formatting a property to text costs a fmt call and usually an allocation,
+  /// paid every frame for a value that moves on a small fraction of them. This
+  /// widget formats once up front, subscribes to the property's on_change
+  /// signal, and reformats only when the value actually changes - the draw
+  /// loop just blits the cached string.
+  ///
+  /// \module widgets
+  struct ValueLabel {
+    /// Subscribe to `prop` and format its value with `fmt_str`.
+    ///
+    /// `fmt_str` is a {fmt} format string with one placeholder. The label
+    /// must not outlive the property - destruction on either side disconnects
+    /// cleanly, but the label holds no lifetime over the property
+    template<typename Prop>
+    ValueLabel(Prop& prop, std::string fmt_str)
+      : fmt_str_(std::move(fmt_str)), text_(fmt::format(fmt_str_, prop.get()))
+    {
+      slot_ = prop.on_change().connect(
+        [this](auto&& new_val) { text_ = fmt::format(fmt_str_, new_val); });
+    }
+
+    /// The subscription captures `this`
+    ValueLabel(const ValueLabel&) = delete;
+    ValueLabel& operator=(const ValueLabel&) = delete;
+
+    /// The currently cached text
+    const std::string& text() const noexcept
+    {
+      return text_;
+    }
+
+    /// Draw the cached text at `p` with the canvas' current font and style
+    void draw(vg::Canvas& ctx, vg::Point p) const
+    {
+      ctx.fillText(text_, p);
+    }
+
+  private:
+    std::string fmt_str_;
+    std::string text_;
+    util::Slot slot_;
+  };
+
+} // namespace otto::core::ui
@@ -1,16 +1,38 @@
 #include "voice_manager.hpp"
 
+#include <array>
+#include <vector>
+
 #include "core/ui/vector_graphics.hpp"
 
 namespace otto::core::voices {
 
+  using namespace ui;
+  using namespace ui::vg;
+
   struct EnvelopeScreen : ui::Screen {
-    EnvelopeScreen(details::EnvelopeProps& props) : props(props) {}
+    EnvelopeScreen(details::EnvelopeProps& props) : props(props)
+    {
+      // Rebuild the cached curves only when a prop actually signals a change -
+      // this screen stays open for long stretches of sound design with
+      // nothing moving
+      props.attack.on_change().connect([this](float) { dirty = true; });
+      props.decay.on_change().connect([this](float) { dirty = true; });
+      props.sustain.on_change().connect([this](float) { dirty = true; });
+      props.release.on_change().connect([this](float) { dirty = true; });
+    }
 
     void draw(ui::vg::Canvas&) override;
     void encoder(ui::EncoderEvent ev) override;
 
+    void rebuild_curves();
+
     details::EnvelopeProps& props;
+
+    /// The flattened outline of one envelope stage, drawn as a closed
+    /// polyline. Tessellated in {@ref rebuild_curves}, replayed every frame
+    std::array<std::vector<Point>, 4> stages;
+    bool dirty = true;
   };
 
   namespace details {
@@ -20,9 +42,6 @@ namespace otto::core::voices {
     }
   } // namespace details
 
-  using namespace ui;
-  using namespace ui::vg;
-
   void EnvelopeScreen::encoder(EncoderEvent ctx)
   {
     switch (ctx.encoder) {
@@ -33,7 +52,20 @@ namespace otto::core::voices {
     }
   }
 
-  void EnvelopeScreen::draw(Canvas& ctx)
+  /// Flatten a quadratic bezier onto the back of `dest`, excluding the start
+  /// point, which the caller has already added
+  static void flatten_quadratic(std::vector<Point>& dest, Point p0, Point c, Point p1)
+  {
+    constexpr int segments = 12;
+    for (int i = 1; i <= segments; i++) {
+      const float t = float(i) / float(segments);
+      const float u = 1.f - t;
+      dest.push_back({u * u * p0.x + 2.f * u * t * c.x + t * t * p1.x,
+                      u * u * p0.y + 2.f * u * t * c.y + t * t * p1.y});
+    }
+  }
+
+  void EnvelopeScreen::rebuild_curves()
   {
     constexpr auto b = vg::Box{30.f, 60.f, 260.f, 110.f};
     const float spacing = 10.f;
@@ -43,52 +75,72 @@ namespace otto::core::voices {
     const float sh = b.height * props.sustain.normalize();
     const float rw = max_width * props.release.normalize();
 
-    ctx.lineWidth(6.f);
-
     const float arc_size = 0.9;
 
-    ctx.beginPath();
-    ctx.moveTo(b.x, b.y + b.height + spacing);
-    ctx.lineTo(b.x + b.width, b.y + b.height + spacing);
-    ctx.stroke(Colours::White);
+    for (auto& stage : stages) stage.clear();
+
+    // Attack
+    auto& a = stages[0];
+    a.push_back({b.x, b.y + b.height});
+    flatten_quadratic(a, a.back(), {b.x + aw * arc_size, b.y + b.height * arc_size},
+                      {b.x + aw, b.y});
+    a.push_back({b.x + aw, b.y + b.height});
+
+    // Decay
+    auto& d = stages[1];
+    d.push_back({b.x + aw + spacing, b.y + b.height});
+    d.push_back({b.x + aw + spacing, b.y});
+    flatten_quadratic(d,
+                      d.back(), {b.x + aw + spacing + dw * (1 - arc_size), b.y + (b.height - sh) * arc_size},
+                      {b.x + aw + spacing + dw, b.y + b.height - sh});
+    d.push_back({b.x + aw + spacing + dw, b.y + b.height});
+
+    // Sustain
+    auto& s = stages[2];
+    s.push_back({b.x + aw + spacing + dw + spacing, b.y + b.height - sh});
+    s.push_back({b.x + b.width - spacing - rw, b.y + b.height - sh});
+    s.push_back({b.x + b.width - spacing - rw, b.y + b.height});
+    s.push_back({b.x + aw + spacing + dw + spacing, b.y + b.height});
+
+    // Release
+    auto& r = stages[3];
+    r.push_back({b.x + b.width - rw, b.y + b.height});
+    r.push_back({b.x + b.width - rw, b.y + b.height - sh});
+    flatten_quadratic(r, r.back(), {b.x + b.width - rw * arc_size, b.y + b.height - sh * (1 - arc_size)},
+                      {b.x + b.width, b.y + b.height});
+  }
 
-    ctx.beginPath();
-    ctx.moveTo(b.x, b.y + b.height);
-    ctx.quadraticCurveTo({b.x + aw * arc_size, b.y + b.height * arc_size},
-                         {b.x + aw, b.y}); // curve
-    ctx.lineTo(b.x + aw, b.y + b.height);
-    ctx.closePath();
-    ctx.stroke(Colours::Blue);
-    ctx.fill(Colours::Blue);
+  void EnvelopeScreen::draw(Canvas& ctx)
+  {
+    if (dirty) {
+      rebuild_curves();
+      dirty = false;
+    }
 
-    ctx.beginPath();
-    ctx.moveTo(b.x + aw + spacing, b.y + b.height);
-    ctx.lineTo(b.x + aw + spacing, b.y);
-    ctx.quadraticCurveTo(
-      {b.x + aw + spacing + dw * (1 - arc_size), b.y + (b.height - sh) * arc_size},
-      {b.x + aw + spacing + dw, b.y + b.height - sh}); // curve
-    ctx.lineTo(b.x + aw + spacing + dw, b.y + b.height);
-    ctx.closePath();
-    ctx.stroke(Colours::Green);
-    ctx.fill(Colours::Green);
+    constexpr auto b = vg::Box{30.f, 60.f, 260.f, 110.f};
+    const float spacing = 10.f;
+    const std::array<Colour, 4> colours = {Colours::Blue, Colours::Green, Colours::Yellow,
+                                           Colours::Red};
 
-    ctx.beginPath();
-    ctx.moveTo(b.x + aw + spacing + dw + spacing, b.y + b.height - sh);
-    ctx.lineTo(b.x + b.width - spacing - rw, b.y + b.height - sh);
-    ctx.lineTo(b.x + b.width - spacing - rw, b.y + b.height);
-    ctx.lineTo(b.x + aw + spacing + dw + spacing, b.y + b.height);
-    ctx.closePath();
-    ctx.stroke(Colours::Yellow);
-    ctx.fill(Colours::Yellow);
+    ctx.lineWidth(6.f);
 
     ctx.beginPath();
-    ctx.moveTo(b.x + b.width - rw, b.y + b.height);
-    ctx.lineTo(b.x + b.width - rw, b.y + b.height - sh);
-    ctx.quadraticCurveTo({b.x + b.width - rw * arc_size, b.y + b.height - sh * (1 - arc_size)},
-                         {b.x + b.width, b.y + b.height});
-    ctx.closePath();
-    ctx.stroke(Colours::Red);
-    ctx.fill(Colours::Red);
+    ctx.moveTo(b.x, b.y + b.height + spacing);
+    ctx.lineTo(b.x + b.width, b.y + b.height + spacing);
+    ctx.stroke(Colours::White);
+
+    // Replay the cached stage outlines - straight lines only, so the per-frame
+    // cost is line setup, not curve tessellation
+    for (int i = 0; i < 4; i++) {
+      auto& stage = stages[i];
+      if (stage.empty()) continue;
+      ctx.beginPath();
+      ctx.moveTo(stage[0]);
+      for (std::size_t p = 1; p < stage.size(); p++) ctx.lineTo(stage[p]);
+      ctx.closePath();
+      ctx.stroke(colours[i]);
+      ctx.fill(colours[i]);
+    }
   }
 
 } // namespace otto::core::voices
@@ -1,9 +1,10 @@
 #pragma once
 
-#include <deque>
 #include <type_traits>
 #include <vector>
 
+#include "util/audio_span.hpp"
+
 #include <Gamma/Envelope.h>
 #include "util/dsp/ADSR_lite.hpp"
 #include "util/dsp/SegExpBypass.hpp"
@@ -15,6 +16,7 @@
 
 #include "util/algorithm.hpp"
 #include "util/crtp.hpp"
+#include "util/local_vector.hpp"
 
 #include "util/dsp/dsp.hpp"
 
@@ -23,6 +25,11 @@ namespace otto::core::voices {
   template<typename PostT, int NumberOfVoices>
   struct VoiceManager;
 
+  namespace details {
+    template<typename Voice>
+    struct IntrusiveVoiceList;
+  }
+
   template<typename DerivedT, typename PropsT>
   struct PreBase : util::crtp<DerivedT, PreBase<DerivedT, PropsT>> {
     using Props = PropsT;
@@ -53,6 +60,18 @@ namespace otto::core::voices {
   /// It also lets the user implement handlers for note_on and note_off events, along with
   /// the main process call {@ref operator()}, which processes one sample at a time.
   ///
+  /// Optionally, a voice can implement a block process call
+  ///
+  /// ```cpp
+  /// void process_block(audio_span<float> out) noexcept;
+  /// ```
+  ///
+  /// which overwrites `out` with up to {@ref VoiceManager::max_block_size} raw samples.
+  /// When it exists, the manager renders whole blocks instead of single samples, which
+  /// gives the voice a tight inner loop the compiler can vectorize. The envelope is still
+  /// applied per sample by the manager, while {@ref frequency()} is only updated at block
+  /// boundaries.
+  ///
   /// @tparam Derived the derived voice type
   /// @tparam Props the Props type of the engine.
   template<typename DerivedT, typename PreT>
@@ -106,6 +125,8 @@ namespace otto::core::voices {
   private:
     template<typename T, int N>
     friend struct VoiceManager;
+    template<typename T>
+    friend struct details::IntrusiveVoiceList;
 
     /// Triggers a new voice. midi_note gives base frequency, detune is multiplied on this.
     /// Legato and jump control legato on envelope + on_note_on and portamento, respectively.
@@ -119,9 +140,18 @@ namespace otto::core::voices {
     float level = 1.f;
     float aftertouch_ = 0.f;
     int midi_note_ = 0;
+    /// The detune ratio this voice was last triggered with. Used by the
+    /// unison fast path to derive follower frequencies from the leader
+    float detune_ = 1.f;
 
     gam::ADSR<> env_;
     SegExpBypass<> glide_{0.f};
+
+    /// Intrusive free/active list links, maintained by the {@ref VoiceManager}'s
+    /// allocators through {@ref details::IntrusiveVoiceList}
+    DerivedT* next_voice_ = nullptr;
+    DerivedT* prev_voice_ = nullptr;
+    details::IntrusiveVoiceList<DerivedT>* voice_list_ = nullptr;
   };
 
   template<typename DerivedT, typename VoiceT>
@@ -136,6 +166,19 @@ namespace otto::core::voices {
     using Pre = typename Voice::VoiceBase::Pre;
     using Props = typename Voice::VoiceBase::Props;
 
+    /// Process one sample of the summed voice output.
+    ///
+    /// A post can also implement the block counterpart
+    ///
+    /// ```cpp
+    /// void process_block(audio_span<float> buf) noexcept;
+    /// ```
+    ///
+    /// filtering the already-mixed voice buffer in place. When both the voice
+    /// and the post implement their block call, the manager uses it instead
+    /// of this - a tight span loop over contiguous samples, which filters
+    /// like biquads vectorize well. Per-block bookkeeping (ui level mirrors
+    /// etc.) then also runs once per block instead of once per sample
     float operator()(float f) noexcept
     {
       return f;
@@ -208,6 +251,121 @@ namespace otto::core::voices {
     std::unique_ptr<ui::Screen> make_envelope_screen(EnvelopeProps& props);
     std::unique_ptr<ui::Screen> make_settings_screen(SettingsProps& props);
 
+    /// Intrusive doubly-linked list of voices, with the links embedded in
+    /// {@ref VoiceBase}.
+    ///
+    /// Used for the manager's free list and LRU active list. All operations are O(1)
+    /// and allocation-free, so they are safe in the note-on path on the audio thread.
+    /// A voice can be on at most one list at a time - pushing it unlinks it from its
+    /// current list first.
+    template<typename Voice>
+    struct IntrusiveVoiceList {
+      bool empty() const noexcept
+      {
+        return head_ == nullptr;
+      }
+
+      /// Number of voices currently on the list
+      int size() const noexcept
+      {
+        return size_;
+      }
+
+      /// Is `v` currently linked on this list?
+      bool contains(Voice* v) const noexcept
+      {
+        return v->voice_list_ == this;
+      }
+
+      Voice* front() const noexcept
+      {
+        return head_;
+      }
+
+      /// The `i`th voice on the list, or nullptr. O(i), only for the static allocators
+      /// where `i` is bounded by the voice count.
+      Voice* nth(int i) const noexcept
+      {
+        Voice* v = head_;
+        for (; v != nullptr && i > 0; i--) v = v->next_voice_;
+        return v;
+      }
+
+      void push_back(Voice* v) noexcept
+      {
+        if (v->voice_list_ != nullptr) v->voice_list_->erase(v);
+        size_++;
+        v->voice_list_ = this;
+        v->prev_voice_ = tail_;
+        v->next_voice_ = nullptr;
+        if (tail_ != nullptr)
+          tail_->next_voice_ = v;
+        else
+          head_ = v;
+        tail_ = v;
+      }
+
+      Voice* pop_front() noexcept
+      {
+        Voice* v = head_;
+        if (v != nullptr) erase(v);
+        return v;
+      }
+
+      void erase(Voice* v) noexcept
+      {
+        if (v->voice_list_ != this) return;
+        size_--;
+        if (v->prev_voice_ != nullptr)
+          v->prev_voice_->next_voice_ = v->next_voice_;
+        else
+          head_ = v->next_voice_;
+        if (v->next_voice_ != nullptr)
+          v->next_voice_->prev_voice_ = v->prev_voice_;
+        else
+          tail_ = v->prev_voice_;
+        v->prev_voice_ = nullptr;
+        v->next_voice_ = nullptr;
+        v->voice_list_ = nullptr;
+      }
+
+      void clear() noexcept
+      {
+        while (!empty()) pop_front();
+      }
+
+    private:
+      Voice* head_ = nullptr;
+      Voice* tail_ = nullptr;
+      int size_ = 0;
+    };
+
+    /// Does the voice type have a `void process_block(audio_span<float>)` member?
+    template<typename Voice, typename = void>
+    struct has_process_block : std::false_type {};
+
+    template<typename Voice>
+    struct has_process_block<
+      Voice,
+      std::void_t<decltype(std::declval<Voice&>().process_block(std::declval<audio_span<float>>()))>>
+      : std::true_type {};
+
+    template<typename Voice>
+    constexpr bool has_process_block_v = has_process_block<Voice>::value;
+
+    /// Does the post type have a `void process_block(audio_span<float>)` member?
+    template<typename Post, typename = void>
+    struct has_post_block : std::false_type {};
+
+    template<typename Post>
+    struct has_post_block<
+      Post,
+      std::void_t<decltype(std::declval<Post&>().process_block(std::declval<audio_span<float>>()))>>
+      : std::true_type {};
+
+    template<typename Post>
+    constexpr bool has_post_block_v = has_post_block<Post>::value;
+
   } // namespace details
 
   // -- VOICE MANAGER INTERFACE -- //
@@ -243,6 +401,9 @@ namespace otto::core::voices {
     static constexpr int voice_count_v = NumberOfVoices;
     static constexpr int sub_voice_count_v = 2;
 
+    /// The maximum number of samples rendered per call to `Voice::process_block`
+    static constexpr int max_block_size = 64;
+
     int voice_count() noexcept override
     {
       return NumberOfVoices;
@@ -258,6 +419,7 @@ namespace otto::core::voices {
 
     /// Constructor
     VoiceManager(Props& props) noexcept;
+    ~VoiceManager() noexcept;
 
     ui::Screen& envelope_screen() noexcept override;
     ui::Screen& settings_screen() noexcept override;
@@ -271,16 +433,63 @@ namespace otto::core::voices {
     void handle_control_change(const midi::ControlChangeEvent&) noexcept;
 
     /// Process audio, applying Preprocessing, each voice and then postprocessing
+    ///
+    /// When the voice implements `process_block`, the audio is rendered in chunks of up
+    /// to {@ref max_block_size} samples instead of sample by sample.
     audio::ProcessData<1> process(audio::ProcessData<1> data) noexcept;
 
     /// Return list of voices
     std::array<Voice, voice_count_v>& voices();
 
+    /// The current limit on simultaneously playing voices.
+    ///
+    /// Always in `[1, voice_count_v]`. Only the dynamic allocators (poly, interval)
+    /// respect it - mono and unison use fixed voice counts
+    int voice_cap() const noexcept;
+
+    /// Limit the number of simultaneously playing voices.
+    ///
+    /// Clamped to `[1, voice_count_v]`. When shrinking below the number of playing
+    /// voices, the quietest ones are released first
+    void voice_cap(int cap) noexcept;
+
+    /// Enable or disable the cpu governor.
+    ///
+    /// When enabled, {@ref voice_cap} is adjusted from the audio thread based on
+    /// {@ref services::AudioManager::cpu_time} - shrunk when the audio thread gets
+    /// close to its deadline, grown back when there is headroom. Disabling keeps
+    /// the current cap
+    void adaptive_voice_cap(bool enable) noexcept;
+
     DECL_REFLECTION(VoiceManager,
                     ("envelope", &VoiceManager::envelope_props),
                     ("voice_settings", &VoiceManager::settings_props));
 
   private:
+    /// Render one chunk of up to {@ref max_block_size} samples through the block path.
+    ///
+    /// Only available when the voice implements `process_block`. Glide and envelopes are
+    /// still stepped per sample, the voice itself renders the whole chunk at once.
+    void process_block(audio_span<float> out) noexcept;
+
+    /// Structure-of-arrays layout of the hot per-voice scalars.
+    ///
+    /// The per-sample loop only needs one or two scalars from each voice, but reading
+    /// them through the voice objects strides across `sizeof(Voice)` bytes per voice,
+    /// which hurts L1 on the Pi already at 6 voices. The manager steps glide/envelope
+    /// into these packed arrays instead, so the final mix loop runs over contiguous
+    /// floats the compiler can vectorize.
+    struct VoiceStateArrays {
+      /// Frequency after glide and pitch bend, as passed to `Voice::frequency()`
+      alignas(64) std::array<float, voice_count_v> frequency = {};
+      /// Current envelope value
+      alignas(64) std::array<float, voice_count_v> env = {};
+      /// Raw voice output for the current sample, before envelope scaling
+      alignas(64) std::array<float, voice_count_v> out = {};
+    };
+
+    VoiceStateArrays voice_state_;
+
     std::vector<float> detune_values;
     std::vector<float> rand_values;
     // Random values. 100% random, organic and fresh. Works for up to 12 voices.
@@ -350,12 +559,46 @@ namespace otto::core::voices {
     };
 
 
+    /// Adjust {@ref voice_cap_} based on the measured audio load. Called once per
+    /// buffer from {@ref process} when the governor is enabled
+    void run_governor() noexcept;
+
+    /// Push onto the front of {@ref note_stack}, making room when it is full
+    /// by dropping the oldest dead entry (or failing that, the oldest entry)
+    void push_note(const NoteVoicePair&) noexcept;
+
     float pitch_bend_ = 1;
 
+    /// Runtime limit on playing voices - see {@ref voice_cap}
+    int voice_cap_ = voice_count_v;
+    /// Is the cpu governor enabled?
+    bool governor_ = false;
+    /// Buffers left before the governor may adjust the cap again. Keeps the cap
+    /// from flapping on a single slow buffer
+    int governor_cooldown_ = 0;
+    /// Upper limit imposed by the global {@ref services::Governor} tier. The
+    /// adaptive cap never grows past it while the tier is degraded
+    int governor_max_ = voice_count_v;
+    std::uint64_t governor_tier_ = 0;
+
     props::Property<bool> sustain_ = {false};
 
-    std::deque<Voice*> free_voices;
-    std::deque<NoteVoicePair> note_stack;
+    /// Free voices, ready to be allocated. O(1) push/pop, no allocation.
+    details::IntrusiveVoiceList<Voice> free_voices;
+    /// Playing voices, in trigger order - the front is the least recently triggered
+    /// voice, which is the one to steal.
+    details::IntrusiveVoiceList<Voice> active_voices;
+    /// The voice that last played each note, indexed by `note % 128`. A hint for
+    /// re-allocating a note to the voice that played it - entries are validated
+    /// against `midi_note_` before use.
+    std::array<Voice*, 128> note_index_ = {};
+
+    /// Held notes, newest first.
+    ///
+    /// Fixed inline capacity, so note bookkeeping never allocates and the
+    /// whole stack stays in a couple of cache lines. {@ref push_note} handles
+    /// overflow by dropping the oldest dead entry
+    util::local_vector<NoteVoicePair, 64> note_stack;
 
     Props& props;
     Pre pre = {props};
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "services/audio_manager.hpp"
+#include "services/governor.hpp"
 #include "services/ui_manager.hpp"
+#include "util/dsp/mix_kernels.hpp"
 #include "voice_manager.hpp"
 
 namespace otto::core::voices {
@@ -69,6 +71,7 @@ namespace otto::core::voices {
   void VoiceBase<D, P>::trigger(int midi_note, float detune, float velocity, bool legato, bool jump) noexcept
   {
     midi_note_ = midi_note;
+    detune_ = detune;
     //Sets target value of portamento to new note
     glide_ = midi::note_freq(midi_note) * detune;
     frequency_ = glide_();
@@ -117,6 +120,7 @@ namespace otto::core::voices {
     util::for_each(vm.voices_, &Voice::release);
     vm.note_stack.clear();
     vm.free_voices.clear();
+    vm.active_voices.clear();
 
     for (auto&& voice : vm_in.voices_) {
       vm.free_voices.push_back(&voice);
@@ -143,28 +147,31 @@ namespace otto::core::voices {
   template<typename V, int N>
   auto VoiceManager<V, N>::IVoiceAllocator::get_voice(int key, int note) noexcept -> Voice&
   {
-    if (vm.free_voices.size() > 0) {
-      /// Usual behaviour is to return the next free voice
-      auto fvit = vm.free_voices.begin();
-      /// Finds the voice that last played the note if it exists
-      auto it = util::find_if(vm.voices_, [note](Voice& vp) { return vp.midi_note_ == note; });
-      /// If there is/was a voice that is playing this note
-      if (it != vm.voices_.end()) {
-        /// It's not currently playing; choose this voice
-        if (!it->is_triggered()) fvit = util::find(vm.free_voices, it);
-        /// Otherwise, do nothing - That would mean the voice is playing, and we should not steal it.
+    const int slot = ((note % 128) + 128) % 128;
+    if (!vm.free_voices.empty() && vm.active_voices.size() < vm.voice_cap_) {
+      /// Usual behaviour is to return the next free voice. If the voice that last
+      /// played this note is free, prefer it - the note index makes that lookup O(1),
+      /// and the entry is validated before use.
+      Voice* v = vm.note_index_[slot];
+      if (v == nullptr || v->midi_note_ != note || !vm.free_voices.contains(v)) {
+        v = vm.free_voices.front();
       }
-      auto& v = **fvit;
-      vm.free_voices.erase(fvit);
-      return v;
+      vm.free_voices.erase(v);
+      vm.active_voices.push_back(v);
+      vm.note_index_[slot] = v;
+      return *v;
     } else {
-      auto found = util::find_if(vm.note_stack, [](NoteVoicePair& nvp) { return nvp.has_voice(); });
-      if (found != vm.note_stack.end()) {
-        DLOGI("Stealing voice {} from key {}", (found->voice - vm.voices_.data()), found->note);
-        Voice& v = *found->voice;
-        v.release();
-        found->voice = nullptr;
-        return v;
+      /// Steal the least recently triggered voice - the front of the active list
+      Voice* v = vm.active_voices.front();
+      if (v != nullptr) {
+        DLOGI("Stealing voice {}", (v - vm.voices_.data()));
+        auto found = util::find_if(vm.note_stack, [v](NoteVoicePair& nvp) { return nvp.voice == v; });
+        if (found != vm.note_stack.end()) found->voice = nullptr;
+        v->release();
+        /// The caller retriggers it, so it becomes the most recently used
+        vm.active_voices.push_back(v);
+        vm.note_index_[slot] = v;
+        return *v;
       } else {
         DLOGE("No voice found. Using voice 0");
         return vm.voices_[0];
@@ -180,9 +187,12 @@ namespace otto::core::voices {
                                   [](auto nvp) { return !nvp.has_voice(); });
         if (found != vm.note_stack.end()) {
           found->voice = &v;
+          /// Retriggered - becomes the most recently used voice
+          vm.active_voices.push_back(&v);
           v.trigger(found->note, found->detune, found->velocity, vm.settings_props.legato, false);
         } else {
           v.release();
+          /// push_back unlinks the voice from the active list
           vm.free_voices.push_back(&v);
         }
     };
@@ -211,7 +221,7 @@ namespace otto::core::voices {
     auto key = evt.key + services::UIManager::current().state.octave * 12 + vm.settings_props.transpose;
     this->stop_voice(key);
     Voice& voice = this->get_voice(key, key);
-    vm.note_stack.push_front({.key = key, .note = key, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &voice});
+    vm.push_note({.key = key, .note = key, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &voice});
     voice.trigger(key, vm.rand_values[(&voice - vm.voices_.data())], evt.velocity / 127.f, false, false);
   }
 
@@ -225,7 +235,7 @@ namespace otto::core::voices {
     this->stop_voice(key);
     for (int i = 0; i < 2; ++i) {
       Voice& voice = this->get_voice(key, key + interval * i);
-      vm.note_stack.push_front({.key = key, .note = key + interval * i, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &voice});
+      vm.push_note({.key = key, .note = key + interval * i, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &voice});
       voice.trigger(key + interval * i, 1, evt.velocity / 127.f, false, false);
     }
   }
@@ -266,16 +276,15 @@ namespace otto::core::voices {
         /// and will note call on_note_on again.
         if (!vm.settings_props.legato) v.release_no_env();
         note.voice = nullptr;
-        vm.note_stack.push_front({.key = key, .note = key - 12 * i, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &v});
+        vm.push_note({.key = key, .note = key - 12 * i, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &v});
         v.trigger(key - 12 * sv, 1, evt.velocity * (1 - sv + vm.settings_props.sub * (float)sv) / 127.f, vm.settings_props.legato, false);
       }
     }
     else {
       for (int i = 0; i < num_voices_used; ++i) {
         int sv = i>0; //Are we dispatching a subvoice?
-        auto fvit = vm.free_voices.begin() + i;
-        auto& v = **fvit;
-        vm.note_stack.push_front({.key = key, .note = key - 12 * sv, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &v});
+        auto& v = *vm.free_voices.nth(i);
+        vm.push_note({.key = key, .note = key - 12 * sv, .detune = 1, .velocity = evt.velocity / 127.f, .voice = &v});
         v.trigger(key - 12 * sv, 1, evt.velocity * (1 - sv + vm.settings_props.sub * (float)sv) / 127.f, false, vm.settings_props.retrig);
       }
     }
@@ -316,15 +325,14 @@ namespace otto::core::voices {
         /// and will note call on_note_on again.
         if (!vm.settings_props.legato) v.release_no_env();
         note.voice = nullptr;
-        vm.note_stack.push_front({.key = key, .note = key, .detune = vm.detune_values[i], .velocity = evt.velocity / 127.f, .voice = &v});
+        vm.push_note({.key = key, .note = key, .detune = vm.detune_values[i], .velocity = evt.velocity / 127.f, .voice = &v});
         v.trigger(key, vm.detune_values[i], evt.velocity / 127.f, vm.settings_props.legato, false);
       }
     }
     else {
       for (int i = 0; i < num_voices_used; i++) {
-        auto vit = vm.free_voices.begin() + i;
-        auto &v = **vit;
-        vm.note_stack.push_front({.key = key, .note = key, .detune = vm.detune_values[i], .velocity = evt.velocity / 127.f, .voice = &v});
+        auto& v = *vm.free_voices.nth(i);
+        vm.push_note({.key = key, .note = key, .detune = vm.detune_values[i], .velocity = evt.velocity / 127.f, .voice = &v});
         v.trigger(key, vm.detune_values[i], evt.velocity / 127.f, false, vm.settings_props.retrig);
       }
     }
@@ -357,7 +365,8 @@ namespace otto::core::voices {
     settings_props.detune.on_change().connect([this](float det){
       detune_values.clear();
       detune_values.push_back(1);
-      for (int i = 1; i<3; i++) {
+      // Enough pairs for the whole unison stack at any capacity
+      for (int i = 1; i <= voice_count_v / 2; i++) {
         detune_values.push_back(1 + det * 0.015f * i);
         detune_values.push_back(1.f / (1.f + det * 0.015f * (float)i));
       }
@@ -402,6 +411,21 @@ namespace otto::core::voices {
         }
       }
     });
+
+    // Dropping voices hurts the most, so this tier sits last in the global
+    // governor's walk. The apply runs on the audio thread - shrinking the cap
+    // there is what the adaptive governor does every block anyway
+    governor_tier_ = services::Governor::current().register_tier(
+      "voices", 30, 0.3f, [this](bool degraded) {
+        governor_max_ = degraded ? std::max(1, voice_count_v / 2) : voice_count_v;
+        if (voice_cap_ > governor_max_) voice_cap(governor_max_);
+      });
+  }
+
+  template<typename V, int N>
+  VoiceManager<V, N>::~VoiceManager() noexcept
+  {
+    services::Governor::current().unregister_tier(governor_tier_);
   }
 
   template<typename V, int N>
@@ -420,13 +444,29 @@ namespace otto::core::voices {
   float VoiceManager<V, N>::operator()() noexcept
   {
     pre();
-    float voice_sum = 0.f;
-    for (auto& voice : voices_) {
+    auto& vs = voice_state_;
+    for (int v = 0; v < voice_count_v; v++) {
+      auto& voice = voices_[v];
+      /// A finished release envelope means the voice is silent until retriggered -
+      /// skip the render entirely and hand the voice back to the free list
+      if (voice.env_.done()) {
+        if (!free_voices.contains(&voice)) free_voices.push_back(&voice);
+        vs.env[v] = 0.f;
+        vs.out[v] = 0.f;
+        continue;
+      }
       ///Change frequency if applicable
-      voice.frequency(voice.glide_() * pitch_bend_);
+      vs.frequency[v] = voice.glide_() * pitch_bend_;
+      voice.frequency(vs.frequency[v]);
       ///Get next sample
       // TODO: The voice could be called inside the envelope. Maybe later.
-      voice_sum += voice.env_() * voice();
+      vs.env[v] = voice.env_();
+      vs.out[v] = voice();
+    }
+    /// Mix over the packed arrays - a contiguous multiply-accumulate
+    float voice_sum = 0.f;
+    for (int v = 0; v < voice_count_v; v++) {
+      voice_sum += vs.env[v] * vs.out[v];
     }
     return post(voice_sum);
   }
@@ -434,7 +474,7 @@ namespace otto::core::voices {
   template<typename V, int N>
   void VoiceManager<V, N>::handle_pitch_bend(const midi::PitchBendEvent& evt) noexcept
   {
-    pitch_bend_ = powf(2.f, ((float)evt.value / 8192.f) - 1.f);
+    pitch_bend_ = midi::interval_ratio(12.f * (((float) evt.value / 8192.f) - 1.f));
   }
 
   template<typename V, int N>
@@ -446,20 +486,153 @@ namespace otto::core::voices {
     }
   }
 
+  template<typename V, int N>
+  void VoiceManager<V, N>::process_block(audio_span<float> out) noexcept
+  {
+    pre();
+    float env_buf[max_block_size];
+    float voice_buf[max_block_size];
+    const int nframes = int(out.size());
+    // One bounds assertion for the whole block - the accumulation loops below
+    // index raw
+    auto [out_buf] = raw_frames(nframes, out);
+    util::dsp::clear(out_buf, nframes);
+
+    /// In unison, every stacked voice is triggered and released together with the
+    /// same velocity and envelope settings, so envelope and glide values are
+    /// identical across the stack up to the detune ratio. Step them once on a
+    /// leader and reuse them - only phase and detune differ per member. Follower
+    /// state is resynced from the leader after the block, and note events only
+    /// land on chunk boundaries, so the next trigger/release sees exact state.
+    Voice* leader = nullptr;
+    if (settings_props.play_mode == +PlayMode::unison) {
+      for (auto& voice : voices_) {
+        if (voice.is_triggered()) {
+          leader = &voice;
+          break;
+        }
+      }
+    }
+    float leader_freq = 0;
+    if (leader != nullptr) {
+      /// Only the block-boundary frequency reaches the voices, so the glide
+      /// advances in one closed-form jump instead of a per-sample loop
+      leader_freq = leader->glide_.skip(nframes);
+      for (int i = 0; i < nframes; i++) {
+        env_buf[i] = leader->env_();
+      }
+    }
+
+    for (int v = 0; v < voice_count_v; v++) {
+      auto& voice = voices_[v];
+      /// A finished release envelope means the voice is silent until retriggered -
+      /// skip the render entirely and hand the voice back to the free list
+      if (voice.env_.done()) {
+        if (!free_voices.contains(&voice)) free_voices.push_back(&voice);
+        continue;
+      }
+      if (leader != nullptr && voice.is_triggered()) {
+        float freq = leader_freq * (voice.detune_ / leader->detune_) * pitch_bend_;
+        voice_state_.frequency[v] = freq;
+        voice.frequency(freq);
+        voice.process_block({voice_buf, nframes});
+        util::dsp::accumulate_product(out_buf, env_buf, voice_buf, nframes);
+        continue;
+      }
+      /// The envelope is stepped per sample as in the scalar path, but the voice
+      /// only sees the frequency at the block boundary, so the glide advances in
+      /// one closed-form jump
+      float freq = voice.glide_.skip(nframes) * pitch_bend_;
+      for (int i = 0; i < nframes; i++) {
+        env_buf[i] = voice.env_();
+      }
+      voice_state_.frequency[v] = freq;
+      voice.frequency(freq);
+      voice.process_block({voice_buf, nframes});
+      util::dsp::accumulate_product(out_buf, env_buf, voice_buf, nframes);
+    }
+
+    if (leader != nullptr) {
+      for (auto& voice : voices_) {
+        if (&voice == leader || !voice.is_triggered()) continue;
+        voice.env_ = leader->env_;
+        voice.glide_ = leader->glide_;
+        const float scale = voice.detune_ / leader->detune_;
+        if (scale != 1.f) voice.glide_ = leader->glide_.getEnd() * scale;
+      }
+    }
+
+    if constexpr (details::has_post_block_v<Post>) {
+      post.process_block(out);
+    } else {
+      for (auto& frm : out) {
+        frm = post(frm);
+      }
+    }
+  }
+
   template<typename V, int N>
   audio::ProcessData<1> VoiceManager<V, N>::process(audio::ProcessData<1> data) noexcept
   {
-    for (auto& evt : data.midi) {
-      util::match(evt, [&](midi::NoteOnEvent& evt) { voice_allocator->handle_midi_on(evt); },
-                  [&](midi::NoteOffEvent& evt) { voice_allocator->handle_midi_off(evt); },
-                  [&](midi::ControlChangeEvent& evt) { handle_control_change(evt); },
-                  [&](midi::PitchBendEvent& evt) { handle_pitch_bend(evt); },
-                  [](auto&) {});
+    if (governor_) run_governor();
+
+    // The block is preprocessed into typed spans, so no per-event matching.
+    // Control events are applied at block start - note events are applied
+    // sample-accurately below
+    for (auto evt : midi::events_of_type<midi::ControlChangeEvent>(data.midi)) {
+      handle_control_change(evt);
+    }
+    for (auto evt : midi::events_of_type<midi::PitchBendEvent>(data.midi)) {
+      handle_pitch_bend(evt);
     }
 
     auto buf = Application::current().audio_manager->buffer_pool().allocate();
-    for (auto& frm : buf) {
-      frm = (*this)();
+
+    auto render = [&](int start, int length) {
+      if constexpr (details::has_process_block_v<Voice>) {
+        for (int s = start; s < start + length; s += max_block_size) {
+          int l = std::min<int>(max_block_size, start + length - s);
+          process_block({buf.data() + s, l});
+        }
+      } else {
+        for (int i = start; i < start + length; i++) {
+          buf.data()[i] = (*this)();
+        }
+      }
+    };
+
+    // Split the block at each note event's frame offset, and render the
+    // spans between - sample-accurate note timing without a per-sample
+    // event check. Both spans are sorted by frame offset
+    auto offs = midi::events_of_type<midi::NoteOffEvent>(data.midi);
+    auto ons = midi::events_of_type<midi::NoteOnEvent>(data.midi);
+    auto off_it = offs.begin();
+    auto on_it = ons.begin();
+
+    int nframes = buf.size();
+    int frame = 0;
+    while (frame < nframes) {
+      // Apply every event stamped at or before the current frame. Offs
+      // first, so a retriggered key releases before it fires again
+      for (; off_it != offs.end() && (*off_it).time <= frame; ++off_it) {
+        voice_allocator->handle_midi_off(*off_it);
+      }
+      for (; on_it != ons.end() && (*on_it).time <= frame; ++on_it) {
+        voice_allocator->handle_midi_on(*on_it);
+      }
+      int next = nframes;
+      if (off_it != offs.end()) next = std::min(next, (*off_it).time);
+      if (on_it != ons.end()) next = std::min(next, (*on_it).time);
+      render(frame, next - frame);
+      frame = next;
+    }
+    // Events stamped at or past the end of the block take effect here, as
+    // they would have at the start of the next one
+    for (; off_it != offs.end(); ++off_it) {
+      voice_allocator->handle_midi_off(*off_it);
+    }
+    for (; on_it != ons.end(); ++on_it) {
+      voice_allocator->handle_midi_on(*on_it);
     }
     return data.with(buf);
   }
@@ -471,6 +644,75 @@ namespace otto::core::voices {
     return voices_;
   }
 
+  template<typename V, int N>
+  int VoiceManager<V, N>::voice_cap() const noexcept
+  {
+    return voice_cap_;
+  }
+
+  template<typename V, int N>
+  void VoiceManager<V, N>::voice_cap(int cap) noexcept
+  {
+    voice_cap_ = std::clamp(cap, 1, voice_count_v);
+    /// Release excess voices, quietest first - dropping a voice that is barely
+    /// audible is much less noticable than cutting the newest note
+    while (active_voices.size() > voice_cap_) {
+      Voice* quietest = active_voices.front();
+      for (Voice* v = active_voices.front(); v != nullptr; v = v->next_voice_) {
+        if (v->envelope() < quietest->envelope()) quietest = v;
+      }
+      if (quietest == nullptr) break;
+      auto found = util::find_if(note_stack, [&](NoteVoicePair& nvp) { return nvp.voice == quietest; });
+      if (found != note_stack.end()) found->voice = nullptr;
+      quietest->release();
+      /// push_back unlinks the voice from the active list
+      free_voices.push_back(quietest);
+    }
+  }
+
+  template<typename V, int N>
+  void VoiceManager<V, N>::adaptive_voice_cap(bool enable) noexcept
+  {
+    governor_ = enable;
+    governor_cooldown_ = 0;
+  }
+
+  template<typename V, int N>
+  void VoiceManager<V, N>::run_governor() noexcept
+  {
+    if (--governor_cooldown_ > 0) return;
+    float load = Application::current().audio_manager->cpu_time();
+    if (load > 0.8f && voice_cap_ > 1) {
+      /// Close to the deadline - drop a voice now, and wait a short while before
+      /// dropping another, so one slow buffer doesn't cut the whole stack
+      voice_cap(voice_cap_ - 1);
+      governor_cooldown_ = 16;
+    } else if (load < 0.5f && voice_cap_ < governor_max_) {
+      /// Plenty of headroom - grow back slowly. The gap between the thresholds is
+      /// the hysteresis that keeps the cap from flapping
+      voice_cap(voice_cap_ + 1);
+      governor_cooldown_ = 64;
+    } else {
+      governor_cooldown_ = 16;
+    }
+  }
+
+  template<typename V, int N>
+  void VoiceManager<V, N>::push_note(const NoteVoicePair& nvp) noexcept
+  {
+    if (note_stack.full()) {
+      // Prefer evicting an old note whose voice was already stolen - it only
+      // mattered for mono/unison fallthrough on release
+      auto it = note_stack.end();
+      do {
+        --it;
+        if (!it->has_voice()) break;
+      } while (it != note_stack.begin());
+      note_stack.erase(it->has_voice() ? note_stack.end() - 1 : it);
+    }
+    note_stack.push_front(nvp);
+  }
+
   namespace details {
     inline std::string aux_setting(PlayMode pm) noexcept
     {
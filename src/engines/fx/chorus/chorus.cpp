@@ -1,8 +1,13 @@
 #include "chorus.hpp"
 
+#include <algorithm>
+
 #include "core/ui/vector_graphics.hpp"
 
+#include "services/governor.hpp"
+
 #include "util/iterator.hpp"
+#include "util/static_string.hpp"
 #include "util/utility.hpp"
 
 // The chorus was developed with inspiration from this:
@@ -42,21 +47,26 @@ namespace otto::engines {
     using EngineScreen<Chorus>::EngineScreen;
   };
 
-  Chorus::Chorus() : EffectEngine<Chorus>(std::make_unique<ChorusScreen>(this))
+  Chorus::Chorus() : EffectEngine<Chorus>([this] { return std::make_unique<ChorusScreen>(this); })
   {
     // Set proper size of phase accumulator for graphics
     phase.radius(1);
 
+    // The chorus DSP is only stepped every second sample (see process), but its
+    // objects read the full global sample rate. To come out right at half rate,
+    // delays in seconds are halved and oscillator frequencies doubled here.
+
     props.delay.on_change().connect([this](float d) {
-      //Goes from minimal to around 20 ms nominal delay.
-      chorus.center(d * d * 0.020 + 0.0005);
+      //Goes from minimal to around 20 ms nominal delay, halved for the half-rate step.
+      chorus.center(0.5f * (d * d * 0.020 + 0.0005));
       //Naturally, the new nominal delay changes the maximum for the play head movement
       chorus.depth(props.depth * chorus.center());
     }).call_now(props.delay);
 
     props.rate.on_change().connect([this](float rate) {
-      chorus.rate(rate * 0.5);
-      phase.freq(rate * 0.5f);
+      // The doubled compensation cancels the * 0.5 these used before
+      chorus.rate(rate);
+      phase.freq(rate);
     });
 
     props.feedback.on_change().connect([this](float fbk) {
@@ -69,19 +79,46 @@ namespace otto::engines {
       //chorus.depth(depth);
         chorus.depth(d * chorus.center());
     }).call_now(props.depth);
+
+    // The chorus already runs at half rate unconditionally, so the next step
+    // down the governor can take is passing the dry signal through
+    governor_tier_ = services::Governor::current().register_tier(
+      "chorus", 10, 0.1f, [this](bool degraded) { governor_bypass_.store(degraded, std::memory_order_relaxed); });
+  }
+
+  Chorus::~Chorus()
+  {
+    services::Governor::current().unregister_tier(governor_tier_);
+  }
+
+  void Chorus::on_deselected() noexcept
+  {
+    chorus.comb.disarm();
   }
 
   audio::ProcessData<2> Chorus::process(audio::ProcessData<1> data)
   {
+    // No-op when already armed - a standby chorus holds no line memory
+    chorus.comb.arm();
+
     // Allocate two audio buffers (left and right channels)
     auto buf = Application::current().audio_manager->buffer_pool().allocate_multi<2>();
-    // Fill buffers with processed samples
-    for (auto&& [dat, bufL, bufR] : util::zip(data.audio, buf[0], buf[1])) {
-      // Get one sample from chorus effect
-      chorus(dat, bufL, bufR);
-      // Update phase value for graphics
-      props.phase_value = phase.nextPhase();
+    if (governor_bypass_.load(std::memory_order_relaxed)) {
+      // Shed by the governor - dry pass-through
+      std::copy(data.audio.begin(), data.audio.end(), buf[0].begin());
+      std::copy(data.audio.begin(), data.audio.end(), buf[1].begin());
+      return data.with(buf);
     }
+    // The chorus is modulation-tolerant, so it runs at half the sample rate with a
+    // half-band pair at the edges - half the comb and modulator work per block.
+    // Within the half-rate block the chorus runs as a block kernel: modulation
+    // curves first, then the tap reads, then the mix
+    half_rate_.process_block(data.audio.data(), buf[0].data(), buf[1].data(), data.nframes,
+                             [this](const float* in, float* left, float* right, int n) {
+                               chorus.process_block(in, left, right, std::size_t(n));
+                               // Step the graphics phase by the same count
+                               for (int i = 0; i < n; i++) props.phase_value = phase.nextPhase();
+                             });
     // Reassign (redirect) processed data to original data
     return data.with(buf);
   }
@@ -161,22 +198,22 @@ namespace otto::engines {
     // chorus/RedValue/10
     ctx.fillStyle(Colours::Red.dim(1 - env_red()));
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{}", std::round(100 * props.depth)), x_right, y_bottom - number_shift);
+    ctx.fillText(util::format_static("{}", std::round(100 * props.depth)), x_right, y_bottom - number_shift);
 
     // chorus/GreenValue/10
     ctx.fillStyle(Colours::Green.dim(1 - env_green()));
     ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{}", std::round(props.rate * 100)), x_pad, y_bottom - number_shift);
+    ctx.fillText(util::format_static("{}", std::round(props.rate * 100)), x_pad, y_bottom - number_shift);
 
     // chorus/YellowValue/0
     ctx.fillStyle(Colours::Yellow.dim(1 - env_yellow()));
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{}", std::round(props.feedback * 100)), x_right, y_pad + number_shift);
+    ctx.fillText(util::format_static("{}", std::round(props.feedback * 100)), x_right, y_pad + number_shift);
 
     // chorus/BlueValue/1
     ctx.fillStyle(Colours::Blue.dim(1 - env_blue()));
     ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{}", std::round(100 * props.delay)), x_pad, y_pad + number_shift);
+    ctx.fillText(util::format_static("{}", std::round(100 * props.delay)), x_pad, y_pad + number_shift);
 
 
     //Heads
@@ -2,10 +2,13 @@
 
 #include "core/engine/engine.hpp"
 
+#include <atomic>
+
 #include <Gamma/Filter.h>
 #include <Gamma/Oscillator.h>
 #include "core/voices/voice_manager.hpp"
 #include "util/dsp/chorus.hpp"
+#include "util/dsp/half_rate.hpp"
 
 namespace otto::engines {
 
@@ -28,12 +31,22 @@ namespace otto::engines {
     } props;
 
     Chorus();
+    ~Chorus();
 
     audio::ProcessData<2> process(audio::ProcessData<1>) override;
 
+    /// Hand the comb's line memory back to the {@ref util::dsp::DelayArena}
+    void on_deselected() noexcept override;
+
   private:
     ChorusEffect<> chorus;
     gam::AccumPhase<> phase;
+    /// The chorus runs at half the sample rate - see the note in the constructor
+    util::dsp::HalfRateStereoStage half_rate_;
+    /// Set from the audio thread when the governor sheds this stage - the dry
+    /// signal passes through instead
+    std::atomic<bool> governor_bypass_ = false;
+    std::uint64_t governor_tier_ = 0;
 
 
 
@@ -0,0 +1,177 @@
+#include "nebula.hpp"
+
+#include <cstdint>
+
+#include "core/ui/vector_graphics.hpp"
+
+#include "util/iterator.hpp"
+#include "util/static_string.hpp"
+#include "util/utility.hpp"
+
+namespace otto::engines {
+
+  using namespace ui;
+  using namespace ui::vg;
+
+  struct NebulaScreen : EngineScreen<Nebula> {
+    void draw(Canvas& ctx) override;
+    bool keypress(Key key) override;
+    void encoder(EncoderEvent e) override;
+
+    using EngineScreen<Nebula>::EngineScreen;
+  };
+
+  Nebula::Nebula() : EffectEngine<Nebula>([this] { return std::make_unique<NebulaScreen>(this); })
+  {
+    pre_filter.type(gam::LOW_PASS);
+
+    // The response is a pair of decorrelated noise bursts with a one-pole
+    // whose cutoff falls along the tail (air absorption). Decay is applied at
+    // runtime as per-partition gains, so the bursts themselves stay flat.
+    // Fixed seeds keep the room identical across runs
+    constexpr float ir_seconds = 2.f;
+    // Keeps the wet level in the same ballpark as the dry signal once the
+    // whole tail is summed
+    constexpr float noise_level = 0.01f;
+    auto sample_rate = float(gam::sampleRate());
+    auto length = std::size_t(ir_seconds * sample_rate);
+    std::vector<float> ir(length);
+    for (int ch = 0; ch < 2; ch++) {
+      std::uint32_t seed = ch == 0 ? 0x2545F491 : 0x9E3779B9;
+      float lp = 0;
+      for (std::size_t i = 0; i < length; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        float noise = float(std::int32_t(seed)) * (noise_level / 2147483648.f);
+        float a = 1.f - 0.8f * (float(i) / float(length));
+        lp += a * (noise - lp);
+        ir[i] = lp;
+      }
+      convolver.set_ir(ch, ir.data(), length);
+    }
+
+    props.filter.on_change().connect(
+      [this](float flt) { pre_filter.freq(2000 + flt * flt * 18000); }).call_now(props.filter);
+    props.length.on_change().connect([this](float len) {
+      convolver.decay(0.1f + 2.f * len, gam::sampleRate());
+    }).call_now(props.length);
+    props.width.on_change().connect([this](float w) { width_amount = w; }).call_now(props.width);
+    props.damping.on_change().connect([this](float damp) {
+      for (auto& flt : damp_filters) flt.freq(20000 * (1 - damp));
+    }).call_now(props.damping);
+  }
+
+  audio::ProcessData<2> Nebula::process(audio::ProcessData<1> data)
+  {
+    auto buf = Application::current().audio_manager->buffer_pool().allocate_multi<2>();
+    auto n = data.audio.size();
+    if (dry_buf.size() < n) {
+      dry_buf.resize(n);
+      wet_l.resize(n);
+      wet_r.resize(n);
+    }
+
+    for (auto&& [dat, dry] : util::zip(data.audio, dry_buf)) {
+      dry = pre_filter(dat);
+    }
+
+    convolver.process(dry_buf.data(), wet_l.data(), wet_r.data(), n);
+
+    for (auto&& [l, r, bufL, bufR] : util::zip(wet_l, wet_r, buf[0], buf[1])) {
+      float dl = damp_filters[0](l);
+      float dr = damp_filters[1](r);
+      float mid = 0.5f * (dl + dr);
+      float side = 0.5f * (dl - dr);
+      bufL = mid + width_amount * side;
+      bufR = mid - width_amount * side;
+    }
+    return data.with(buf);
+  }
+
+  // SCREEN //
+
+  void NebulaScreen::encoder(ui::EncoderEvent ev)
+  {
+    auto& props = engine.props;
+    switch (ev.encoder) {
+    case Encoder::blue: props.filter.step(ev.steps); break;
+    case Encoder::green: props.length.step(ev.steps); break;
+    case Encoder::yellow: props.width.step(ev.steps); break;
+    case Encoder::red: props.damping.step(ev.steps); break;
+    }
+  }
+
+  bool NebulaScreen::keypress(ui::Key key)
+  {
+    return false;
+  }
+
+  void NebulaScreen::draw(ui::vg::Canvas& ctx)
+  {
+    using namespace ui::vg;
+
+    auto& props = engine.props;
+
+    constexpr float x_pad = 20;
+    constexpr float y_pad = 20;
+
+    constexpr float x_right = width - x_pad;
+    constexpr float y_bottom = height - y_pad;
+    constexpr float number_shift = 30;
+
+    // Text
+    ctx.font(Fonts::Norm, 25);
+    ctx.fillStyle(Colours::Blue);
+    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
+    ctx.fillText("treble", x_pad, y_pad);
+
+    ctx.fillStyle(Colours::Green);
+    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
+    ctx.fillText("length", x_pad, y_bottom);
+
+    ctx.fillStyle(Colours::Yellow);
+    ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
+    ctx.fillText("width", x_right, y_pad);
+
+    ctx.fillStyle(Colours::Red);
+    ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
+    ctx.fillText("damping", x_right, y_bottom);
+
+    // Numbers
+    ctx.font(Fonts::Norm, 40);
+
+    ctx.fillStyle(Colours::Blue);
+    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
+    ctx.fillText(util::format_static("{}", std::round(props.filter * 100)), x_pad, y_pad + number_shift);
+
+    ctx.fillStyle(Colours::Green);
+    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
+    ctx.fillText(util::format_static("{}", std::round(props.length * 100)), x_pad, y_bottom - number_shift);
+
+    ctx.fillStyle(Colours::Yellow);
+    ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
+    ctx.fillText(util::format_static("{}", std::round(props.width * 100)), x_right, y_pad + number_shift);
+
+    ctx.fillStyle(Colours::Red);
+    ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
+    ctx.fillText(util::format_static("{}", std::round(props.damping * 100)), x_right,
+                 y_bottom - number_shift);
+
+    // The cloud - an arc of stars whose spread follows the width and whose
+    // reach follows the length
+    float reach = 40 + props.length * 60;
+    float spread = 10 + props.width * 30;
+    for (int i = 0; i < 9; i++) {
+      float t = float(i) / 8.f;
+      float angle = (t - 0.5f) * 2.f;
+      Point p = {width / 2.f + angle * reach,
+                 height / 2.f - spread * std::sin(t * 3.14159f)};
+      ctx.beginPath();
+      ctx.circle(p, 2 + (1 - std::abs(angle)) * 2);
+      ctx.fillStyle(Colours::White.dim(t * props.damping.normalize()));
+      ctx.fill();
+    }
+  }
+
+} // namespace otto::engines
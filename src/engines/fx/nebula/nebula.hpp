@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core/engine/engine.hpp"
+
+#include <Gamma/Filter.h>
+#include "util/dsp/convolver.hpp"
+#include "util/footprint.hpp"
+
+/// Convolution Reverb Engine
+namespace otto::engines {
+
+  using namespace core;
+  using namespace core::engine;
+  using namespace props;
+
+  struct Nebula : EffectEngine<Nebula> {
+    static constexpr util::string_ref name = "Nebula";
+    struct Props {
+      Property<float> filter = {0, limits(0, 1), step_size(0.01)};
+      Property<float> length = {0.5, limits(0, 1), step_size(0.01)};
+      Property<float> width = {1, limits(0, 1), step_size(0.01)};
+      Property<float> damping = {0.4, limits(0, 0.99), step_size(0.01)};
+
+      DECL_REFLECTION(Props, filter, length, width, damping);
+    } props;
+
+    Nebula();
+
+    audio::ProcessData<2> process(audio::ProcessData<1>) override;
+
+    /// Heap buffers for the footprint report - see {@ref IEngine::memory_footprint}
+    std::size_t owned_buffer_bytes() const noexcept
+    {
+      return util::heap_bytes(dry_buf, wet_l, wet_r) + convolver.heap_bytes();
+    }
+
+  private:
+    float width_amount = 1;
+    util::dsp::PartitionedConvolver convolver;
+    gam::Biquad<> pre_filter;
+    std::array<gam::Biquad<>, 2> damp_filters;
+    /// Block scratch for the convolver input and outputs
+    std::vector<float> dry_buf;
+    std::vector<float> wet_l;
+    std::vector<float> wet_r;
+  };
+
+} // namespace otto::engines
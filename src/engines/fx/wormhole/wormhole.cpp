@@ -3,7 +3,10 @@
 #include <numeric>
 #include "core/ui/vector_graphics.hpp"
 
+#include "services/governor.hpp"
+
 #include "util/iterator.hpp"
+#include "util/static_string.hpp"
 #include "util/utility.hpp"
 
 namespace otto::engines {
@@ -20,36 +23,82 @@ namespace otto::engines {
   };
 
   Wormhole::Wormhole()
-    : EffectEngine<Wormhole>(std::make_unique<WormholeScreen>(this))
+    : EffectEngine<Wormhole>([this] { return std::make_unique<WormholeScreen>(this); })
   {
-    // reverb.resize({1307, 1637, 1811, 1931}, {1051, 337, 113});
-    reverb.resize(gam::JCREVERB);
-
     shimmer_filter.type(gam::LOW_PASS);
     shimmer_filter.freq(18000);
 
     pre_filter.type(gam::LOW_PASS);
 
-    output_delay[0].maxDelay(211.f / gam::sampleRate());
-    output_delay[1].maxDelay(179.f / gam::sampleRate());
-
     props.filter.on_change().connect(
       [this](float flt) { pre_filter.freq(3000 + flt * flt * 17000); }).call_now(props.filter);
     props.shimmer.on_change().connect([this](float sh) { shimmer_amount = sh * 0.03; }).call_now(props.shimmer);
-    props.length.on_change().connect([this](float len) { reverb.decay(3.f * len); }).call_now(props.length);
+    props.length.on_change().connect([this](float len) { reverb.decay(3.f * len, gam::sampleRate()); }).call_now(props.length);
     props.damping.on_change().connect([this](float damp) { reverb.damping(damp); }).call_now(props.damping);
+
+    // The tank itself is cheap - when the governor comes asking, give up the
+    // shimmer octave instead. The tail keeps ringing, just without the sparkle
+    governor_tier_ = services::Governor::current().register_tier(
+      "wormhole shimmer", 20, 0.1f,
+      [this](bool degraded) { governor_shed_shimmer_.store(degraded, std::memory_order_relaxed); });
+  }
+
+  Wormhole::~Wormhole()
+  {
+    services::Governor::current().unregister_tier(governor_tier_);
   }
 
 
+  void Wormhole::on_deselected() noexcept
+  {
+    reverb.disarm();
+    output_delay[0].disarm();
+    output_delay[1].disarm();
+  }
+
   audio::ProcessData<2> Wormhole::process(audio::ProcessData<1> data)
   {
+    // All no-ops when already armed - a standby wormhole holds no delay memory
+    reverb.arm();
+    output_delay[0].arm();
+    output_delay[1].arm();
+
     auto buf = Application::current().audio_manager->buffer_pool().allocate_multi<2>();
-    for (auto&& [dat, bufL, bufR] : util::zip(data.audio, buf[0], buf[1])) {
-      auto frm = reverb(pre_filter(dat) + last_sample * shimmer_amount);
-      last_sample = dc_block(shimmer_filter(pitchshifter(frm)));
+    auto n = data.audio.size();
+    if (tank_buf.size() < n) {
+      tank_buf.resize(n);
+      shimmer_fb.resize(n, 0.f);
+    }
+
+    // The shimmer path used to feed back with a one-sample delay. Feeding the
+    // previous block back instead only adds a block of latency to a tail that
+    // already goes through a windowed pitch shifter, and lets the tank run as a
+    // block
+    for (auto&& [dat, tank_in, shim] : util::zip(data.audio, tank_buf, shimmer_fb)) {
+      tank_in = pre_filter(dat) + shim * shimmer_amount;
+    }
+
+    reverb.process(tank_buf.data(), tank_buf.data(), n);
+
+    if (governor_shed_shimmer_.load(std::memory_order_relaxed)) {
+      // Shed by the governor - skip the granular shifter and silence the
+      // feedback it would have produced
+      std::fill_n(shimmer_fb.data(), n, 0.f);
+      for (auto&& [frm, bufL, bufR] : util::zip(tank_buf, buf[0], buf[1])) {
+        bufL = output_delay[0](frm, std::size_t(211));
+        bufR = output_delay[1](frm, std::size_t(179));
+      }
+      return data.with(buf);
+    }
+
+    // The octave-up runs as a block; its feedback was consumed above, so the
+    // shifted tail can overwrite it in place
+    pitchshifter.process(tank_buf.data(), shimmer_fb.data(), n);
 
-      bufL = output_delay[0](frm);
-      bufR = output_delay[1](frm);
+    for (auto&& [frm, shim, bufL, bufR] : util::zip(tank_buf, shimmer_fb, buf[0], buf[1])) {
+      shim = dc_block(shimmer_filter(shim));
+      bufL = output_delay[0](frm, std::size_t(211));
+      bufR = output_delay[1](frm, std::size_t(179));
     }
     return data.with(buf);
   }
@@ -288,7 +337,7 @@ namespace otto::engines {
       ctx.save();
       ctx.font(Fonts::Norm, 40);
       ctx.fillStyle(Colours::Blue);
-      ctx.fillText(fmt::format("{}", std::round(props.filter * 100)), 22.9, 76.2);
+      ctx.fillText(util::format_static("{}", std::round(props.filter * 100)), 22.9, 76.2);
 
       // mass text
       ctx.font(Fonts::Norm, 25);
@@ -301,7 +350,7 @@ namespace otto::engines {
       ctx.save();
       ctx.font(Fonts::Norm, 40);
       ctx.fillStyle(Colours::Yellow);
-      ctx.fillText(fmt::format("{}", std::round(props.shimmer * 100)), 22.9, 147.9);
+      ctx.fillText(util::format_static("{}", std::round(props.shimmer * 100)), 22.9, 147.9);
 
       // stars text
       ctx.font(Fonts::Norm, 25);
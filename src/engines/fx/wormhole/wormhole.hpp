@@ -2,7 +2,11 @@
 
 #include "core/engine/engine.hpp"
 
+#include <atomic>
+
+#include "util/dsp/reverb_tank.hpp"
 #include "util/dsp/transpose.hpp"
+#include "util/footprint.hpp"
 
 /// Reverb Engine
 namespace otto::engines {
@@ -23,18 +27,34 @@ namespace otto::engines {
     } props;
 
     Wormhole();
+    ~Wormhole();
 
     audio::ProcessData<2> process(audio::ProcessData<1>) override;
 
+    /// Hand the tank and output delay memory back to the {@ref util::dsp::DelayArena}
+    void on_deselected() noexcept override;
+
+    /// Heap buffers for the footprint report - see {@ref IEngine::memory_footprint}
+    std::size_t owned_buffer_bytes() const noexcept
+    {
+      return util::heap_bytes(tank_buf, shimmer_fb) + reverb.heap_bytes();
+    }
+
   private:
-    float last_sample = 0;
     float shimmer_amount = 0;
-    gam::ReverbMS<> reverb;
-    dsp::SimplePitchShift pitchshifter;
-    std::array<gam::Delay<>, 2> output_delay;
+    util::dsp::ReverbTank reverb;
+    dsp::GrainPitchShift pitchshifter;
+    std::array<util::dsp::arena_delay_line<256>, 2> output_delay;
     gam::Biquad<> shimmer_filter;
     gam::BlockDC<> dc_block;
     gam::Biquad<> pre_filter;
+    /// Block scratch for the tank, and the shimmer feedback from the previous block
+    std::vector<float> tank_buf;
+    std::vector<float> shimmer_fb;
+    /// Set from the audio thread when the governor sheds the shimmer path -
+    /// the granular shifter is by far the most expensive part of this engine
+    std::atomic<bool> governor_shed_shimmer_ = false;
+    std::uint64_t governor_tier_ = 0;
   };
 
 } // namespace otto::engines
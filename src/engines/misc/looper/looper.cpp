@@ -0,0 +1,301 @@
+#include "looper.hpp"
+
+#include <algorithm>
+
+#include "core/ui/vector_graphics.hpp"
+
+#include "services/controller.hpp"
+
+#include "util/dsp/mix_kernels.hpp"
+
+namespace otto::engines {
+
+  using namespace ui;
+  using namespace ui::vg;
+  using namespace otto::services;
+
+  struct LooperScreen : EngineScreen<Looper> {
+    void draw(Canvas& ctx) override;
+    bool keypress(Key key) override;
+    void encoder(EncoderEvent e) override;
+
+    using EngineScreen<Looper>::EngineScreen;
+  };
+
+  Looper::Looper() : MiscEngine<Looper>([this] { return std::make_unique<LooperScreen>(this); }) {}
+
+  void Looper::toggle_record() noexcept
+  {
+    request_.store(Request::record, std::memory_order_release);
+  }
+
+  void Looper::toggle_play() noexcept
+  {
+    request_.store(Request::play, std::memory_order_release);
+  }
+
+  void Looper::clear() noexcept
+  {
+    request_.store(Request::clear, std::memory_order_release);
+  }
+
+  void Looper::undo() noexcept
+  {
+    request_.store(Request::undo, std::memory_order_release);
+  }
+
+  float Looper::position() const noexcept
+  {
+    if (state_ == State::recording) return float(pos_) / float(max_loop_frames);
+    if (loop_length_ == 0) return 0.f;
+    return float(pos_) / float(loop_length_);
+  }
+
+  void Looper::apply_request() noexcept
+  {
+    switch (request_.exchange(Request::none, std::memory_order_acquire)) {
+      case Request::none: break;
+      case Request::record:
+        switch (state_) {
+          case State::empty: [[fallthrough]];
+          case State::stopped:
+            loop_length_ = 0;
+            pos_ = 0;
+            state_ = State::recording;
+            break;
+          case State::recording:
+            loop_length_ = pos_;
+            pos_ = 0;
+            state_ = loop_length_ > 0 ? State::playing : State::empty;
+            break;
+          case State::playing:
+            // A new take - the previous one is no longer undoable
+            drop_take();
+            state_ = State::overdubbing;
+            break;
+          case State::overdubbing: state_ = State::playing; break;
+        }
+        break;
+      case Request::play:
+        switch (state_) {
+          case State::recording:
+            loop_length_ = pos_;
+            pos_ = 0;
+            state_ = loop_length_ > 0 ? State::playing : State::empty;
+            break;
+          case State::playing: [[fallthrough]];
+          case State::overdubbing: state_ = State::stopped; break;
+          case State::stopped:
+            pos_ = 0;
+            state_ = State::playing;
+            break;
+          case State::empty: break;
+        }
+        break;
+      case Request::clear:
+        drop_take();
+        // Hand the loop's physical pages back to the kernel
+        ring_l_.decommit();
+        ring_r_.decommit();
+        loop_length_ = 0;
+        pos_ = 0;
+        state_ = State::empty;
+        break;
+      case Request::undo: apply_undo(); break;
+    }
+  }
+
+  void Looper::save_undo_range(int start, int len) noexcept
+  {
+    const int first = start / UndoChunk::frames;
+    const int last = (start + len - 1) / UndoChunk::frames;
+    for (int c = first; c <= last; c++) {
+      if (undo_map_[c] != nullptr) continue;
+      auto* chunk = static_cast<UndoChunk*>(util::slab_pool::local().allocate(sizeof(UndoChunk)));
+      const int off = c * UndoChunk::frames;
+      const int n = std::min(UndoChunk::frames, loop_length_ - off);
+      std::copy_n(ring_l_.data() + off, n, chunk->l.data());
+      std::copy_n(ring_r_.data() + off, n, chunk->r.data());
+      undo_map_[c] = chunk;
+      take_chunks_++;
+    }
+  }
+
+  void Looper::apply_undo() noexcept
+  {
+    if (take_chunks_ == 0) return;
+    for (int c = 0; c * UndoChunk::frames < loop_length_; c++) {
+      auto* chunk = undo_map_[c];
+      if (chunk == nullptr) continue;
+      const int off = c * UndoChunk::frames;
+      const int n = std::min(UndoChunk::frames, loop_length_ - off);
+      std::copy_n(chunk->l.data(), n, ring_l_.data() + off);
+      std::copy_n(chunk->r.data(), n, ring_r_.data() + off);
+    }
+    drop_take();
+    if (state_ == State::overdubbing) state_ = State::playing;
+  }
+
+  void Looper::drop_take() noexcept
+  {
+    if (take_chunks_ == 0) return;
+    for (auto& chunk : undo_map_) {
+      if (chunk == nullptr) continue;
+      util::slab_pool::local().deallocate(chunk, sizeof(UndoChunk));
+      chunk = nullptr;
+      if (--take_chunks_ == 0) break;
+    }
+    take_chunks_ = 0;
+  }
+
+  void Looper::process(float* l, float* r, const float* line_in, int nframes) noexcept
+  {
+    apply_request();
+
+    if (state_ == State::empty || state_ == State::stopped) return;
+
+    const float level = props.play_level;
+    const float dub_decay = props.decay;
+    const float line_gain = props.line_in;
+
+    if (state_ == State::recording) {
+      // First pass - the tap write is the only copy. Hitting the end of the
+      // ring closes the loop at maximum length
+      const int m = std::min(nframes, max_loop_frames - pos_);
+      // Grow by page commits - zero copying, and one syscall per megabyte
+      if (!ring_l_.commit(pos_ + m) || !ring_r_.commit(pos_ + m)) return;
+      util::dsp::copy_scale(ring_l_.data() + pos_, l, 1.f, m);
+      util::dsp::copy_scale(ring_r_.data() + pos_, r, 1.f, m);
+      util::dsp::accumulate_scale(ring_l_.data() + pos_, line_in, line_gain, m);
+      util::dsp::accumulate_scale(ring_r_.data() + pos_, line_in, line_gain, m);
+      pos_ += m;
+      if (pos_ == max_loop_frames) {
+        loop_length_ = max_loop_frames;
+        pos_ = 0;
+        state_ = State::playing;
+      }
+      return;
+    }
+
+    // Playing or overdubbing - walk the loop in wrap-free segments
+    int i = 0;
+    while (i < nframes) {
+      const int m = std::min(nframes - i, loop_length_ - pos_);
+      if (state_ == State::overdubbing) {
+        // Keep the pre-overdub audio for undo - first touch per take only, so
+        // a full pass stops copying after one loop
+        save_undo_range(pos_, m);
+        // In-place accumulate: decay the previous pass, add the chain and the
+        // line input on top. The playback mixed below monitors the result
+        util::dsp::scale(ring_l_.data() + pos_, dub_decay, m);
+        util::dsp::scale(ring_r_.data() + pos_, dub_decay, m);
+        util::dsp::accumulate(ring_l_.data() + pos_, l + i, m);
+        util::dsp::accumulate(ring_r_.data() + pos_, r + i, m);
+        util::dsp::accumulate_scale(ring_l_.data() + pos_, line_in + i, line_gain, m);
+        util::dsp::accumulate_scale(ring_r_.data() + pos_, line_in + i, line_gain, m);
+      }
+      util::dsp::accumulate_scale(l + i, ring_l_.data() + pos_, level, m);
+      util::dsp::accumulate_scale(r + i, ring_r_.data() + pos_, level, m);
+      pos_ += m;
+      if (pos_ == loop_length_) pos_ = 0;
+      i += m;
+    }
+  }
+
+  // SCREEN //
+
+  bool LooperScreen::keypress(ui::Key key)
+  {
+    switch (key) {
+      case Key::rec: engine.toggle_record(); return true;
+      case Key::play: engine.toggle_play(); return true;
+      case Key::red_click: engine.clear(); return true;
+      case Key::yellow_click: engine.undo(); return true;
+      default: return false;
+    }
+  }
+
+  void LooperScreen::encoder(ui::EncoderEvent ev)
+  {
+    auto& props = engine.props;
+    switch (ev.encoder) {
+      case Encoder::blue: props.play_level.step(ev.steps); break;
+      case Encoder::green: props.line_in.step(ev.steps); break;
+      case Encoder::red: props.decay.step(ev.steps); break;
+      default: break;
+    }
+  }
+
+  void LooperScreen::draw(ui::vg::Canvas& ctx)
+  {
+    const auto state = engine.state();
+
+    auto state_text = [&]() -> const char* {
+      switch (state) {
+        case Looper::State::empty: return "empty";
+        case Looper::State::recording: return "recording";
+        case Looper::State::playing: return "playing";
+        case Looper::State::overdubbing: return "overdub";
+        case Looper::State::stopped: return "stopped";
+      }
+      OTTO_UNREACHABLE;
+    };
+
+    auto state_colour = [&] {
+      switch (state) {
+        case Looper::State::recording: [[fallthrough]];
+        case Looper::State::overdubbing: return Colours::Red;
+        case Looper::State::playing: return Colours::Green;
+        default: return Colours::Gray70;
+      }
+    };
+
+    Controller::current().set_color(LED{Key::rec},
+                                    state == Looper::State::recording || state == Looper::State::overdubbing
+                                      ? LEDColor::Red
+                                      : LEDColor::Black);
+    Controller::current().set_color(LED{Key::play},
+                                    state == Looper::State::playing || state == Looper::State::overdubbing
+                                      ? LEDColor::Green
+                                      : LEDColor::Black);
+
+    ctx.font(Fonts::Norm, 25);
+    ctx.fillStyle(Colours::White);
+    ctx.fillText("looper", 22.9, 35.4);
+
+    ctx.font(Fonts::Norm, 40);
+    ctx.fillStyle(state_colour());
+    ctx.fillText(state_text(), 22.9, 76.2);
+
+    // Loop position ring
+    Point centre = {160, 120};
+    float radius = 40;
+    ctx.beginPath();
+    ctx.circle(centre, radius);
+    ctx.lineWidth(6.0);
+    ctx.strokeStyle(Colours::Gray70);
+    ctx.stroke();
+
+    if (state != Looper::State::empty) {
+      ctx.beginPath();
+      ctx.arc(centre.x, centre.y, radius, -M_PI_2, -M_PI_2 + 2 * M_PI * engine.position(), false);
+      ctx.strokeStyle(state_colour());
+      ctx.lineCap(LineCap::ROUND);
+      ctx.stroke();
+    }
+
+    ctx.font(Fonts::Norm, 25);
+    ctx.fillStyle(Colours::Blue);
+    ctx.fillText(fmt::format("level {}", std::round(engine.props.play_level * 100)), 219.3, 44.6);
+    ctx.fillStyle(Colours::Green);
+    ctx.fillText(fmt::format("line in {}", std::round(engine.props.line_in * 100)), 219.3, 80.0);
+    ctx.fillStyle(Colours::Red);
+    ctx.fillText(fmt::format("decay {}", std::round(engine.props.decay * 100)), 219.3, 115.4);
+
+    if (engine.has_undo()) {
+      ctx.fillStyle(Colours::Yellow);
+      ctx.fillText("undo", 219.3, 150.8);
+    }
+  }
+
+} // namespace otto::engines
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "core/engine/engine.hpp"
+
+#include "util/pool_allocator.hpp"
+#include "util/vm_array.hpp"
+
+namespace otto::engines {
+
+  using namespace core;
+  using namespace core::engine;
+  using namespace props;
+
+  /// Loop-station style looper tapping the chain after the effects mix.
+  ///
+  /// Records into a reserved stereo ring - the tap write is the only copy
+  /// per block, playback mixes straight into the chain buffers, and overdub is
+  /// an in-place accumulate on the ring. The first recording pass sets the loop
+  /// length. Transport changes come from the logic thread as a single pending
+  /// request, applied at the next block start.
+  ///
+  /// Overdubs get a one-level undo: the pre-take audio is kept only for the
+  /// stretches the take actually touched, in pool-allocated chunks, instead of
+  /// snapshotting the whole ring.
+  struct Looper : MiscEngine<Looper> {
+    static constexpr util::string_ref name = "Looper";
+
+    /// Longest recordable loop (32 s at 48 kHz). Only address space is
+    /// reserved up front - pages are committed as recording proceeds, and an
+    /// empty looper holds no physical memory
+    static constexpr int max_loop_frames = 48000 * 32;
+
+    struct Props {
+      /// Playback level of the loop in the mix
+      Property<float> play_level = {1, limits(0, 1), step_size(0.01)};
+      /// How much of the previous pass survives an overdub
+      Property<float> decay = {1, limits(0, 1), step_size(0.01)};
+      /// Record gain for the line input
+      Property<float> line_in = {1, limits(0, 2), step_size(0.01)};
+
+      DECL_REFLECTION(Props, play_level, decay, line_in);
+    } props;
+
+    enum struct State { empty, recording, playing, overdubbing, stopped };
+
+    Looper();
+
+    /// Tap the chain. Mixes loop playback into `l`/`r` and records them plus
+    /// `line_in` according to the transport state
+    void process(float* l, float* r, const float* line_in, int nframes) noexcept;
+
+    /// Start recording, close the loop, or toggle overdub. Logic thread
+    void toggle_record() noexcept;
+    /// Stop or restart playback from the loop start. Logic thread
+    void toggle_play() noexcept;
+    /// Drop the loop. Logic thread
+    void clear() noexcept;
+    /// Revert the last overdub take. Logic thread
+    void undo() noexcept;
+
+    /// Whether there is an overdub take to revert
+    bool has_undo() const noexcept { return take_chunks_ > 0; }
+    State state() const noexcept { return state_; }
+    /// Playhead in [0, 1) - 0 when there is no loop
+    float position() const noexcept;
+
+    /// Heap buffers for the footprint report - see {@ref IEngine::memory_footprint}.
+    ///
+    /// The rings reserve address space for the full loop length but only
+    /// committed pages cost memory, so that is what gets reported. Undo chunks
+    /// come from the shared slab pool and are counted there, not here
+    std::size_t owned_buffer_bytes() const noexcept
+    {
+      return sizeof(float) * (ring_l_.committed() + ring_r_.committed()) +
+             sizeof(UndoChunk*) * undo_map_.capacity();
+    }
+
+  private:
+    enum struct Request : char { none, record, play, clear, undo };
+
+    /// Pre-overdub audio for one stretch of the loop, kept only for stretches
+    /// the take actually touched. Sized so a chunk lands exactly in the pool's
+    /// largest bin and never falls through to `operator new` on the audio
+    /// thread
+    struct UndoChunk {
+      static constexpr int frames = 512;
+      std::array<float, frames> l;
+      std::array<float, frames> r;
+    };
+    static_assert(sizeof(UndoChunk) == util::slab_pool::max_bin);
+
+    void apply_request() noexcept;
+    /// Capture `[start, start + len)` into the current take, first touch only
+    void save_undo_range(int start, int len) noexcept;
+    /// Copy the saved chunks back into the ring and drop the take
+    void apply_undo() noexcept;
+    /// Return the take's chunks to the pool
+    void drop_take() noexcept;
+
+    util::vm_array<float> ring_l_{max_loop_frames};
+    util::vm_array<float> ring_r_{max_loop_frames};
+    /// Chunk index -> saved pre-overdub audio, null where the take hasn't
+    /// touched. ~24 kB of pointers, allocated once
+    std::vector<UndoChunk*> undo_map_ =
+      std::vector<UndoChunk*>(max_loop_frames / UndoChunk::frames, nullptr);
+    int take_chunks_ = 0;
+
+    State state_ = State::empty;
+    std::atomic<Request> request_{Request::none};
+    int loop_length_ = 0;
+    int pos_ = 0;
+  };
+
+} // namespace otto::engines
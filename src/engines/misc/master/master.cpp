@@ -2,9 +2,11 @@
 
 #include "core/ui/vector_graphics.hpp"
 
+#include "services/debug_ui.hpp"
 #include "util/iterator.hpp"
 #include "util/utility.hpp"
 
+#include "util/dsp/mix_kernels.hpp"
 #include "util/math.hpp"
 
 namespace otto::engines {
@@ -17,10 +19,20 @@ namespace otto::engines {
     void encoder(EncoderEvent e) override;
 
     using EngineScreen<Master>::EngineScreen;
+
+  private:
+    void draw_meter_bar(Canvas& ctx, float x, float level, float peak);
+
+    /// Screen-side meter ballistics - instant attack, exponential release,
+    /// peaks held a little longer so transients register at 30 fps
+    float meter_l_ = 0;
+    float meter_r_ = 0;
+    float peak_hold_l_ = 0;
+    float peak_hold_r_ = 0;
   };
 
   Master::Master()
-    : MiscEngine<Master>(std::make_unique<MasterScreen>(this))
+    : MiscEngine<Master>([this] { return std::make_unique<MasterScreen>(this); })
   {
     props.volume.on_change().connect([this](float v){
       volume_square = v * v;
@@ -30,12 +42,35 @@ namespace otto::engines {
 
   audio::ProcessData<2> Master::process(audio::ProcessData<2> data)
   {
+    // The gain is applied in one vectorized pass, ramping from last block's
+    // volume so encoder moves don't zipper. The soft clip stays per sample
+    const float from = volume_ramp_.step(volume_square);
+    util::dsp::scale_ramp(data.audio[0].data(), from, volume_square, data.nframes);
+    util::dsp::scale_ramp(data.audio[1].data(), from, volume_square, data.nframes);
+    // Brickwall the peaks before the soft clip - fastatan is only gentle up to
+    // |x| = 1, it grows again past that
+    for (auto&& [l, r] : util::zip(data.audio[0], data.audio[1])) {
+      limiter_(l, r);
+    }
     for (auto&& l : data.audio[0]) {
-      l = util::math::fastatan( l * volume_square );
+      l = util::math::fastatan(l);
     }
     for (auto&& r : data.audio[1]) {
-      r = util::math::fastatan( r * volume_square );
+      r = util::math::fastatan(r);
     }
+    // Output metering as block reductions over the finished buffers - two
+    // horizontal passes per channel, published lock-free for the screen meter
+    using services::master_meter_stats;
+    master_meter_stats::rms_l.store(std::sqrt(util::dsp::mean_square(data.audio[0].data(), data.nframes)),
+                                    std::memory_order_relaxed);
+    master_meter_stats::rms_r.store(std::sqrt(util::dsp::mean_square(data.audio[1].data(), data.nframes)),
+                                    std::memory_order_relaxed);
+    master_meter_stats::peak_l.store(util::dsp::peak(data.audio[0].data(), data.nframes),
+                                     std::memory_order_relaxed);
+    master_meter_stats::peak_r.store(util::dsp::peak(data.audio[1].data(), data.nframes),
+                                     std::memory_order_relaxed);
+    // One relaxed load while the spectrum is not on screen
+    services::spectrum_analyzer::push(data.audio[0].data(), data.audio[1].data(), data.nframes);
     return data;
   }
 
@@ -47,10 +82,56 @@ namespace otto::engines {
     props.volume.step(ev.steps);
   }
 
+  void MasterScreen::draw_meter_bar(ui::vg::Canvas& ctx, float x, float level, float peak)
+  {
+    using namespace ui::vg;
+    constexpr float top = 49.8f;
+    constexpr float bottom = 171.8f;
+    constexpr float height = bottom - top;
+
+    // Track
+    ctx.beginPath();
+    ctx.moveTo(x, bottom);
+    ctx.lineTo(x, top);
+    ctx.lineWidth(6.0);
+    ctx.lineCap(LineCap::ROUND);
+    ctx.strokeStyle(Colour::bytes(99, 99, 99));
+    ctx.stroke();
+
+    // Level
+    if (level > 0.001f) {
+      ctx.beginPath();
+      ctx.moveTo(x, bottom);
+      ctx.lineTo(x, bottom - std::min(level, 1.f) * height);
+      ctx.strokeStyle(Colours::Green);
+      ctx.stroke();
+    }
+
+    // Peak hold tick, red once the soft clip is working hard
+    if (peak > 0.001f) {
+      const float py = bottom - std::min(peak, 1.f) * height;
+      ctx.beginPath();
+      ctx.moveTo(x, py);
+      ctx.lineTo(x, py - 0.5f);
+      ctx.strokeStyle(peak > 0.99f ? Colours::Red : Colours::White);
+      ctx.stroke();
+    }
+  }
+
   void MasterScreen::draw(ui::vg::Canvas& ctx)
   {
     using namespace ui::vg;
 
+    // Meters. The levels are block reductions published by the audio thread -
+    // one relaxed load each, the ballistics run here at frame rate
+    using services::master_meter_stats;
+    meter_l_ = std::max(master_meter_stats::rms_l.load(std::memory_order_relaxed), meter_l_ * 0.85f);
+    meter_r_ = std::max(master_meter_stats::rms_r.load(std::memory_order_relaxed), meter_r_ * 0.85f);
+    peak_hold_l_ = std::max(master_meter_stats::peak_l.load(std::memory_order_relaxed), peak_hold_l_ * 0.97f);
+    peak_hold_r_ = std::max(master_meter_stats::peak_r.load(std::memory_order_relaxed), peak_hold_r_ * 0.97f);
+    draw_meter_bar(ctx, 40, meter_l_, peak_hold_l_);
+    draw_meter_bar(ctx, 280, meter_r_, peak_hold_r_);
+
     // Text
     ctx.font(Fonts::Bold, 26);
     ctx.fillStyle(Colour::bytes(255, 255, 255));
@@ -2,6 +2,9 @@
 
 #include "core/engine/engine.hpp"
 
+#include "util/dsp/limiter.hpp"
+#include "util/dsp/ramped_gain.hpp"
+
 namespace otto::engines {
 
   using namespace core;
@@ -23,6 +26,10 @@ namespace otto::engines {
 
   private:
     float volume_square = 0;
+    /// Ramps volume moves over a block instead of stepping between them
+    util::dsp::RampedGain volume_ramp_;
+    /// Brickwall safety after the volume gain - 128 samples (~2.7 ms) lookahead
+    util::dsp::LookaheadLimiter<128> limiter_;
   };
 
 } // namespace otto::engines
@@ -1,11 +1,17 @@
 #include "sampler.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include "core/ui/vector_graphics.hpp"
 
+#include "util/dir_index.hpp"
+#include "util/dsp/resample_kernel.hpp"
 #include "util/iterator.hpp"
 #include "util/utility.hpp"
 
 #include "services/audio_manager.hpp"
+#include "services/task_pool.hpp"
 
 namespace otto::engines {
 
@@ -33,18 +39,21 @@ namespace otto::engines {
   };
 
   Sampler::Sampler()
-    : MiscEngine<Sampler>(std::make_unique<SamplerScreen>(this)),
-      _envelope_screen(std::make_unique<SamplerEnvelopeScreen>(this))
+    : MiscEngine<Sampler>([this] { return std::make_unique<SamplerScreen>(this); }),
+      _stream_thread([this](auto&&) {
+        while (_stream_thread.running()) {
+          stream_prefetch();
+          _stream_thread.sleep_for(chrono::milliseconds(250));
+        }
+      })
   {
     // Load filenames into vector. TODO: Move this out to enclosing sequencer
-    std::string samples_path = Application::current().data_dir / "samples";
-    for (const auto& entry : filesystem::recursive_directory_iterator(samples_path)) {
-      if (!entry.is_regular_file()) continue;
-      auto path = entry.path().string().substr(samples_path.size() + 1);
+    // One readdir pass, cached across engines - and hidden entries like the
+    // .cache directory stay out of the listing
+    for (auto&& path : util::scan_tree(Application::current().data_dir / "samples")) {
       DLOGI("Found sample file {}", path);
-      props.filenames.push_back(path);
+      props.filenames.push_back(std::move(path));
     }
-    util::sort(props.filenames);
 
     // Set up on_change handler for the file name
     props.file.on_change().connect([this](std::string fl) {
@@ -64,8 +73,21 @@ namespace otto::engines {
     _hi_filter.freq(20000);
 
     // More on_change handlers
-    props.startpoint.on_change().connect([this](float pt) { sample.min(pt * sample.frames()); }).call_now();
-    props.endpoint.on_change().connect([this](float pt) { sample.max(pt * sample.frames()); }).call_now();
+    props.startpoint.on_change()
+      .connect([this](float pt) {
+        sample.min(pt * sample.frames());
+        _loop_xfade_dirty.store(true, std::memory_order_release);
+      })
+      .call_now();
+    props.endpoint.on_change()
+      .connect([this](float pt) {
+        sample.max(pt * sample.frames());
+        _loop_xfade_dirty.store(true, std::memory_order_release);
+      })
+      .call_now();
+    props.loop.on_change()
+      .connect([this] { _loop_xfade_dirty.store(true, std::memory_order_release); })
+      .call_now();
     props.fadein.on_change()
       .connect([this](float fd) { sample.fade((int) fd * 1000, (int) props.fadeout * 1000); })
       .call_now();
@@ -95,6 +117,20 @@ namespace otto::engines {
 */
   }
 
+  Sampler::~Sampler() noexcept
+  {
+    // The load job captures `this` - wait for it before the members go away.
+    // The stream thread joins itself in its own destructor
+    if (_load_job.valid()) _load_job.wait();
+  }
+
+  ui::Screen& Sampler::envelope_screen()
+  {
+    // Built on first display, like the screens owned by IEngine
+    if (!_envelope_screen) _envelope_screen = std::make_unique<SamplerEnvelopeScreen>(this);
+    return *_envelope_screen;
+  }
+
   void Sampler::restart()
   {
     sample.reset();
@@ -117,56 +153,318 @@ namespace otto::engines {
 
   void Sampler::load_file(std::string filename)
   {
-    bool loaded = samplefile.load(Application::current().data_dir / "samples" / filename);
-    int num_samples = 1;
-    if (loaded) {
-      num_samples = samplefile.samples[0].size();
-      props.samplerate = samplefile.getSampleRate();
-      props.samplecontainer.resize(num_samples);
-      props.samplecontainer.assign(samplefile.samples[0]);
-      sample.buffer(props.samplecontainer, (double) props.samplerate, 1);
+    bool push = false;
+    {
+      std::unique_lock lock{_load_mutex};
+      _queued_filename = std::move(filename);
+      _queued_data = nullptr;
+      push = !std::exchange(_load_job_pending, true);
+    }
+    // Decoding is high priority - the sample screen is drawing "loading" until
+    // it finishes
+    if (push) {
+      _load_job = services::TaskPool::current().push(services::TaskPool::Priority::high,
+                                                     [this] { loader_drain(); });
+    }
+  }
 
-      // Check file
+  void Sampler::load_shared(std::string name,
+                            const float* data,
+                            std::uint32_t frames,
+                            float samplerate,
+                            std::uint64_t source_id)
+  {
+    bool push = false;
+    {
+      std::unique_lock lock{_load_mutex};
+      _queued_filename = std::move(name);
+      _queued_data = data;
+      _queued_frames = frames;
+      _queued_samplerate = samplerate;
+      _queued_source_id = source_id;
+      push = !std::exchange(_load_job_pending, true);
+    }
+    if (push) {
+      _load_job = services::TaskPool::current().push(services::TaskPool::Priority::high,
+                                                     [this] { loader_drain(); });
+    }
+  }
 
-      for (auto& f : props.samplecontainer) {
-        if (f == NAN or f == INFINITY or props.samplecontainer.size() == 0) {
-          props.samplecontainer.resize(1);
-          props.samplerate = 1;
-          props.samplecontainer[0] = 0;
-          sample.buffer(props.samplecontainer, (double) props.samplerate, 1);
-          props.error = "Invalid file";
-          goto end;
+  void Sampler::loader_drain()
+  {
+    for (;;) {
+      std::string name;
+      const float* data = nullptr;
+      std::uint32_t frames = 0;
+      float samplerate = 1;
+      std::uint64_t source_id = 0;
+      {
+        std::unique_lock lock{_load_mutex};
+        if (_queued_filename.empty() && _queued_data == nullptr) {
+          _load_job_pending = false;
+          return;
         }
+        name = std::move(_queued_filename);
+        _queued_filename.clear();
+        data = std::exchange(_queued_data, nullptr);
+        frames = _queued_frames;
+        samplerate = _queued_samplerate;
+        source_id = _queued_source_id;
       }
+      if (data != nullptr) {
+        load_shared_into_standby(name, data, frames, samplerate, source_id);
+      } else {
+        load_into_standby(name);
+      }
+    }
+  }
+
+  void Sampler::load_into_standby(const std::string& filename)
+  {
+    // Pick a slot the audio thread cannot be touching
+    auto& slot = *util::find_if(_sample_slots, [this](auto& s) { //
+      return &s != _published_slots[0] && &s != _published_slots[1];
+    });
+    slot.mapped.unmap();
+
+    auto path = Application::current().data_dir / "samples" / filename;
+    // Prefer the memory-mapped native-format cache - loading it is O(page faults),
+    // and the kernel can evict cold samples
+    if (slot.mapped.load(path, Application::current().data_dir / "samples" / ".cache")) {
+      slot.samplerate = slot.mapped.samplerate();
+      slot.container.source(const_cast<float*>(slot.mapped.data()), slot.mapped.frames(), true);
+      DLOGI("Mapped sample file {}. Length: {}. SR: {}", filename, slot.mapped.frames(), slot.samplerate);
+      props.error = "";
+    } else if (slot.decoded.load(path)) {
+      int num_samples = slot.decoded.samples[0].size();
+      slot.samplerate = slot.decoded.getSampleRate();
+      slot.container.resize(num_samples);
+      slot.container.assign(slot.decoded.samples[0]);
+
+      // Check file
 
-      DLOGI("Loaded sample file {}. Length: {}. SR: {}", filename, num_samples, props.samplerate);
       props.error = "";
+      for (auto& f : slot.container) {
+        if (f == NAN or f == INFINITY or slot.container.size() == 0) {
+          slot.container.resize(1);
+          slot.samplerate = 1;
+          slot.container[0] = 0;
+          props.error = "Invalid file";
+          break;
+        }
+      }
+      if (props.error.empty()) {
+        DLOGI("Loaded sample file {}. Length: {}. SR: {}", filename, num_samples, slot.samplerate);
+      }
     } else {
       LOGE("Error Loading sample file {}", filename);
-      props.samplecontainer.resize(1);
-      props.samplerate = 1;
-      props.samplecontainer[0] = 0;
-      sample.buffer(props.samplecontainer, (double) props.samplerate, 1);
+      slot.container.resize(1);
+      slot.samplerate = 1;
+      slot.container[0] = 0;
       props.error = "Unknown Error (check log)";
     }
-  end:
-    props.waveform = {{props.samplecontainer.elems(), props.samplecontainer.size()}, 300};
+    if (props.error.empty()) {
+      // The peak file replaces the O(samples) analysis scan on every load
+      // after the first, and is mapped rather than read - the waveform renders
+      // straight out of it, with no copy and no generation job
+      const auto cache_dir = Application::current().data_dir / "cache";
+      const auto source_id = audio::SampleAnalysis::source_id_of(path);
+      const auto frames = std::uint32_t(slot.container.size());
+      slot.mapped_analysis.unmap();
+      if (!slot.mapped_analysis.load(cache_dir, filename, source_id, frames)) {
+        // Miss - scan once, write the peak file, then map it like every later
+        // load. The vector is the fallback if the write fails (read-only fs)
+        slot.analysis = audio::SampleAnalysis::analyze(slot.container.elems(), frames);
+        if (audio::SampleAnalysis::save_cached(cache_dir, filename, source_id, frames, slot.analysis)) {
+          slot.mapped_analysis.load(cache_dir, filename, source_id, frames);
+        }
+      }
+    } else {
+      slot.analysis = {};
+      slot.mapped_analysis.unmap();
+    }
+    publish_slot(slot);
+  }
+
+  void Sampler::load_shared_into_standby(const std::string& name,
+                                         const float* data,
+                                         std::uint32_t frames,
+                                         float samplerate,
+                                         std::uint64_t source_id)
+  {
+    // Pick a slot the audio thread cannot be touching
+    auto& slot = *util::find_if(_sample_slots, [this](auto& s) { //
+      return &s != _published_slots[0] && &s != _published_slots[1];
+    });
+    slot.mapped.unmap();
+    slot.samplerate = samplerate;
+    slot.container.source(const_cast<float*>(data), frames, true);
+    const auto cache_dir = Application::current().data_dir / "cache";
+    slot.mapped_analysis.unmap();
+    if (!slot.mapped_analysis.load(cache_dir, name, source_id, frames)) {
+      slot.analysis = audio::SampleAnalysis::analyze(data, frames);
+      if (audio::SampleAnalysis::save_cached(cache_dir, name, source_id, frames, slot.analysis)) {
+        slot.mapped_analysis.load(cache_dir, name, source_id, frames);
+      }
+    }
+    DLOGI("Loaded bundled sample {}. Length: {}. SR: {}", name, frames, samplerate);
+    props.error = "";
+    publish_slot(slot);
+  }
+
+  void Sampler::publish_slot(LoadedSample& slot)
+  {
+    // With matching cached bins no generation job runs and the screen never
+    // waits; otherwise the generator scans as before
+    const auto expected_bins =
+      std::size_t((slot.container.size() + audio::Waveform::bin_size - 1) / audio::Waveform::bin_size);
+    if (expected_bins > 0 && slot.mapped_analysis &&
+        std::size_t(slot.mapped_analysis.bin_count()) == expected_bins) {
+      // Straight out of the mapped peak file - no allocation, no copy
+      props.waveform = {{slot.container.elems(), slot.container.size()},
+                        300,
+                        slot.mapped_analysis.bins(),
+                        int(slot.mapped_analysis.bin_count())};
+    } else if (expected_bins > 0 && slot.analysis.peak_bins.size() == expected_bins) {
+      props.waveform = {{slot.container.elems(), slot.container.size()}, 300, slot.analysis.peak_bins};
+    } else {
+      props.waveform = {{slot.container.elems(), slot.container.size()}, 300};
+    }
     auto& envscr = *dynamic_cast<SamplerEnvelopeScreen*>(_envelope_screen.get());
     envscr.update_wf();
-    sample.finish();
+
+    // Publish. The audio thread picks this up at the next block boundary
+    _published_slots[1] = _published_slots[0];
+    _published_slots[0] = &slot;
+    _pending_sample.store(&slot, std::memory_order_release);
+
+    // Wait out a block boundary before returning to the loader. That bounds
+    // how far behind the audio thread can be - it has picked this publish (or
+    // a newer one) up, so the slot the next load reuses is truly unreferenced
+    services::AudioManager::current().wait_one();
+  }
+
+  void Sampler::rebuild_loop_xfade(const LoadedSample& slot) noexcept
+  {
+    const auto lo = std::size_t(std::max<double>(0, sample.min()));
+    const auto hi = std::size_t(std::max<double>(0, sample.max()));
+    _loop_xfade_len = hi - lo > 2 * max_loop_xfade_frames ? max_loop_xfade_frames : (hi - lo) / 2;
+    const float* src = slot.container.elems();
+    for (std::size_t i = 0; i < _loop_xfade_len; i++) {
+      // Equal power - the two sides are usually uncorrelated
+      const float t = float(i + 1) / float(_loop_xfade_len + 1) * float(M_PI_2);
+      _loop_xfade[i] = src[hi - _loop_xfade_len + i] * std::cos(t) + src[lo + i] * std::sin(t);
+    }
   }
 
   void Sampler::process(audio::AudioBufferHandle audio, bool triggered)
   {
+    // Swap in a freshly loaded sample at the block boundary. The exchange is the only
+    // audio-thread side of the handoff, so a load never blocks the callback
+    if (auto* loaded = _pending_sample.exchange(nullptr, std::memory_order_acquire)) {
+      sample.buffer(loaded->container, (double) loaded->samplerate, 1);
+      sample.finish();
+      _playing_slot.store(loaded, std::memory_order_release);
+      _loop_xfade_dirty.store(true, std::memory_order_relaxed);
+    }
     if (triggered && !note_on) {
       note_on = true;
       restart();
     } else if (!triggered && note_on) {
       note_on = false;
     }
+    // Resample the whole block in one call instead of a fractional read per
+    // output sample - see {@ref util::dsp::resample_block}. The player object
+    // stays the bookkeeper: min/max/pos feed the kernel, and the resulting
+    // playhead is written back for the screens and the prefetcher
+    auto scratch = services::AudioManager::current().buffer_pool().allocate();
+    if (auto* slot = _playing_slot.load(std::memory_order_relaxed)) {
+      const double rate =
+        double(props.speed) * slot->samplerate / services::AudioManager::current().samplerate();
+      const double lo = sample.min();
+      const double hi = sample.max();
+      const bool loop = props.loop && rate > 0 && hi - lo > 4;
+      if (loop && _loop_xfade_dirty.exchange(false, std::memory_order_acquire)) {
+        rebuild_loop_xfade(*slot);
+      }
+      if (loop) {
+        // Looping, forward: read the region up to the crossfade, then read
+        // through the pre-blended boundary and wrap. All the blending happened
+        // in {@ref rebuild_loop_xfade} - this is the same plain kernel reads
+        const auto xf = double(_loop_xfade_len);
+        const double edge = hi - xf;
+        double pos = sample.pos();
+        std::size_t filled = 0;
+        while (filled < audio.size()) {
+          if (pos < edge) {
+            auto res = util::dsp::resample_block(scratch.data() + filled, slot->container.elems(),
+                                                 pos, rate, lo, edge + 1, audio.size() - filled);
+            filled += res.frames;
+            pos = res.pos;
+          } else {
+            auto res = util::dsp::resample_block(scratch.data() + filled, _loop_xfade.data(),
+                                                 pos - edge, rate, 0, xf, audio.size() - filled);
+            filled += res.frames;
+            pos = res.finished ? lo + xf : edge + res.pos;
+          }
+        }
+        sample.pos(pos);
+      } else {
+        auto res = util::dsp::resample_block(scratch.data(), slot->container.elems(), sample.pos(),
+                                             rate, lo, hi, audio.size());
+        sample.pos(res.pos);
+        if (res.finished) sample.finish();
+      }
+    } else {
+      std::fill_n(scratch.data(), audio.size(), 0.f);
+    }
+    // The filters run over the whole block either way, so their tails ring out
+    // past the end of the sample like before
+    std::size_t i = 0;
     for (auto&& frm : audio) {
-      frm += _hi_filter(_lo_filter(sample())) * props.volume;
+      frm += _hi_filter(_lo_filter(scratch[i++])) * props.volume;
+    }
+    _play_pos.store(std::uint32_t(std::max(0.0, sample.pos())), std::memory_order_relaxed);
+  }
+
+  void Sampler::stream_prefetch() noexcept
+  {
+    auto* slot = _playing_slot.load(std::memory_order_acquire);
+    if (slot == nullptr || !slot->mapped) return;
+    auto& mapped = slot->mapped;
+    const std::uint32_t frames = mapped.frames();
+    const float speed = props.speed;
+    const auto window = std::uint32_t(stream_window_s * slot->samplerate * std::max(1.f, std::abs(speed)));
+    const std::uint32_t pos = std::min(_play_pos.load(std::memory_order_relaxed), frames);
+
+    // Read ahead in the playback direction
+    if (speed >= 0) {
+      mapped.prefetch(pos, window);
+    } else {
+      mapped.prefetch(pos > window ? pos - window : 0, std::min(pos, window));
+    }
+
+    if (frames <= stream_release_min_frames) return;
+
+    // Long file: bound residency. Keep a window around the playhead plus one at
+    // the start point for instant restarts, and drop everything else - the
+    // prefetch above re-reads it if the playhead comes back
+    struct Range {
+      std::uint32_t lo, hi;
+    };
+    const auto start = std::uint32_t(props.startpoint * frames);
+    std::array<Range, 2> keep = {{
+      {pos > 2 * window ? pos - 2 * window : 0, std::min(pos + 2 * window, frames)},
+      {start, std::min(start + window, frames)},
+    }};
+    if (keep[0].lo > keep[1].lo) std::swap(keep[0], keep[1]);
+    if (keep[1].lo <= keep[0].hi) {
+      keep[0].hi = std::max(keep[0].hi, keep[1].hi);
+      keep[1] = {frames, frames};
     }
+    mapped.release(0, keep[0].lo);
+    mapped.release(keep[0].hi, keep[1].lo - keep[0].hi);
+    mapped.release(keep[1].hi, frames - keep[1].hi);
   }
 
   // MAIN SCREEN //
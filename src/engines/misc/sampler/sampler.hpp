@@ -2,7 +2,13 @@
 
 #include "core/engine/engine.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <mutex>
+
 #include "util/iterator.hpp"
+#include "util/thread.hpp"
 
 #include <AudioFile.h>
 #include <Gamma/Filter.h>
@@ -10,7 +16,9 @@
 
 #include "engines/misc/sends/sends.hpp"
 
+#include "core/audio/sample_analysis.hpp"
 #include "core/audio/waveform.hpp"
+#include "util/mapped_sample.hpp"
 
 namespace otto::engines {
 
@@ -31,32 +39,31 @@ namespace otto::engines {
       Property<float> fadeout = {0, limits(0, 1), step_size(0.01)};
       Property<float> startpoint = {0, limits(0, 1), step_size(0.001)};
       Property<float> endpoint = {1, limits(0, 1), step_size(0.001)};
+      Property<bool> loop = {false};
 
       audio::Waveform waveform;
       std::vector<std::string> filenames;
       std::vector<std::string>::iterator file_it = filenames.begin();
-      gam::Array<float> samplecontainer;
-      float samplerate;
 
       /// The error message loading the last sample
       std::string error = "Sample not loaded yet";
 
       engines::Sends send;
 
-      DECL_REFLECTION(Props, file, volume, filter, speed, fadein, fadeout, startpoint, endpoint);
+      DECL_REFLECTION(Props, file, volume, filter, speed, fadein, fadeout, startpoint, endpoint, loop);
     } props;
 
     Sampler();
+    /// Joins any in-flight load job
+    ~Sampler() noexcept;
 
     void restart();
     void finish();
 
     float progress() const noexcept;
 
-    ui::Screen& envelope_screen()
-    {
-      return *_envelope_screen;
-    }
+    /// The envelope/trim screen, built on first call like the main screen
+    ui::Screen& envelope_screen();
 
     float operator()() noexcept;
 
@@ -66,15 +73,110 @@ namespace otto::engines {
     friend struct SamplerScreen;
     friend struct SamplerEnvelopeScreen;
 
-    void load_file(std::string);
+    /// A fully loaded sample. Prepared by the load job, then handed to the
+    /// audio thread through `_pending_sample` and swapped into `sample` at a
+    /// block boundary.
+    struct LoadedSample {
+      util::MappedSample mapped;
+      AudioFile<float> decoded;
+      gam::Array<float> container;
+      float samplerate = 1;
+      /// Peak envelope/rms/trim - computed (and written as a peak file) on
+      /// first load. Later loads use {@ref mapped_analysis} instead
+      core::audio::SampleAnalysis analysis;
+      /// The peak file mapped in place - the waveform reads its bins straight
+      /// out of the mapping, so browsing renders instantly with no copy
+      core::audio::MappedSampleAnalysis mapped_analysis;
+    };
+
+    /// Queue `filename` for the load job. Returns immediately.
+    void load_file(std::string filename);
+    /// Queue already-decoded sample data for the load job, e.g. one channel of
+    /// a mapped kit bundle. Returns immediately. `data` must stay valid until
+    /// a later load replaces it - the sampler does not take ownership.
+    /// `source_id` identifies the backing file for the analysis cache - see
+    /// {@ref core::audio::SampleAnalysis::source_id_of}
+    void load_shared(std::string name,
+                     const float* data,
+                     std::uint32_t frames,
+                     float samplerate,
+                     std::uint64_t source_id);
+    /// Drain the queued load(s). Runs as a task pool job - at most one per
+    /// sampler at a time, serialized by `_load_job_pending`.
+    void loader_drain();
+    /// Decode `filename` into a free slot and publish it. Load job only.
+    void load_into_standby(const std::string& filename);
+    /// Point a free slot at shared sample data and publish it. Load job only.
+    void load_shared_into_standby(const std::string& name,
+                                  const float* data,
+                                  std::uint32_t frames,
+                                  float samplerate,
+                                  std::uint64_t source_id);
+    /// Hand `slot` to the audio thread, and rebuild the waveform from it.
+    /// Load job only.
+    void publish_slot(LoadedSample& slot);
+    /// Keep the pages around the playhead of a mapped sample resident, and
+    /// bound residency on long files by dropping pages far from the playhead.
+    /// Stream thread only.
+    void stream_prefetch() noexcept;
+    /// Render the loop-boundary crossfade: the last {@ref max_loop_xfade_frames}
+    /// of the region blended equal-power into the first. Looped playback reads
+    /// through this buffer at the boundary, so the loop is click-free at zero
+    /// per-sample cost. Allocation free - runs on the audio thread at the start
+    /// of the block after the region changes
+    void rebuild_loop_xfade(const LoadedSample& slot) noexcept;
+
+    /// How far ahead of the playhead to read. Generous against SD/USB latency -
+    /// half a megabyte at 48 kHz, scaled up with the playback rate
+    static constexpr float stream_window_s = 2;
+    /// Pages are only dropped behind the playhead on files longer than this
+    /// (one minute at 48 kHz) - short one-shots just stay resident
+    static constexpr std::uint32_t stream_release_min_frames = 48000 * 60;
+    /// Length of the rendered loop crossfade - about 21 ms at 48 kHz. Shrunk
+    /// when the loop region is shorter than twice this
+    static constexpr std::size_t max_loop_xfade_frames = 1024;
+
     gam::SamplePlayer<> sample;
-    AudioFile<float> samplefile;
     bool note_on = false;
 
     gam::Biquad<> _lo_filter;
     gam::Biquad<> _hi_filter;
 
     std::unique_ptr<ui::Screen> _envelope_screen;
+
+    std::array<LoadedSample, 3> _sample_slots;
+    /// The last two slots published to the audio thread. Either of them can
+    /// still be pending or playing, so the loader only reuses older slots.
+    std::array<LoadedSample*, 2> _published_slots = {nullptr, nullptr};
+    std::atomic<LoadedSample*> _pending_sample = nullptr;
+
+    /// The slot the audio thread is playing from, for the stream thread
+    std::atomic<LoadedSample*> _playing_slot = nullptr;
+    /// See {@ref rebuild_loop_xfade}
+    std::array<float, max_loop_xfade_frames> _loop_xfade = {};
+    std::size_t _loop_xfade_len = 0;
+    /// Set on region or sample changes - any thread. The audio thread rebuilds
+    /// the crossfade at the next block when looping
+    std::atomic<bool> _loop_xfade_dirty = true;
+    /// Playhead in frames, published per block for the stream thread
+    std::atomic<std::uint32_t> _play_pos = 0;
+
+    std::mutex _load_mutex;
+    std::string _queued_filename;
+    /// When set, the next load points at this shared data instead of opening
+    /// `_queued_filename`. Guarded by `_load_mutex`
+    const float* _queued_data = nullptr;
+    std::uint32_t _queued_frames = 0;
+    float _queued_samplerate = 1;
+    std::uint64_t _queued_source_id = 0;
+    /// Set while a load job is queued or running, so queueing another load
+    /// just updates the fields above instead of pushing a second job. Guarded
+    /// by `_load_mutex`
+    bool _load_job_pending = false;
+    /// The last load job pushed to the task pool. The destructor waits on it,
+    /// since the job captures `this`
+    std::future<void> _load_job;
+    util::sleeper_thread _stream_thread;
   };
 
 } // namespace otto::engines
@@ -21,7 +21,7 @@ namespace otto::engines {
     util::Slot fx2_handler;
   };
 
-  Sends::Sends() : MiscEngine<Sends>(std::make_unique<SendsScreen>(this)) {
+  Sends::Sends() : MiscEngine<Sends>([this] { return std::make_unique<SendsScreen>(this); }) {
   }
 
   LED led_for(ChannelEnum ce) {
@@ -361,6 +361,15 @@ namespace otto::engines {
 
   void SendsScreen::encoder(core::ui::EncoderEvent e)
   {
+    // With shift held, the encoders control the second-synth layer routing
+    if (Controller::current().is_pressed(Key::shift)) {
+      switch (e.encoder) {
+      case core::ui::Encoder::blue: engine.props.layer.step(e.steps); break;
+      case core::ui::Encoder::green: engine.props.split.step(e.steps); break;
+      default: break;
+      }
+      return;
+    }
     switch (e.encoder) {
     case core::ui::Encoder::blue: engine.props.to_FX1.step(e.steps); break;
     case core::ui::Encoder::green: engine.props.to_FX2.step(e.steps); break;
@@ -14,8 +14,13 @@ namespace otto::engines {
       props::Property<float> to_FX2 = {0, props::limits(0, 1), props::step_size(0.01)};
       props::Property<float> dry = {1, props::limits(0, 1), props::step_size(0.01)};
       props::Property<float> dry_pan = {0, props::limits(-1, 1), props::step_size(0.01)};
+      /// Volume of the second synth layered under the main one
+      props::Property<float> layer = {0.5, props::limits(0, 1), props::step_size(0.01)};
+      /// Lowest key routed to the main synth - notes below it go to the layer
+      /// synth instead. 0 layers both synths across the whole keyboard
+      props::Property<int> split = {0, props::limits(0, 127), props::step_size(1)};
 
-      DECL_REFLECTION(Props, to_FX1, to_FX2, dry, dry_pan);
+      DECL_REFLECTION(Props, to_FX1, to_FX2, dry, dry_pan, layer, split);
     } props;
 
     Sends();
@@ -1,7 +1,14 @@
 #include "sequencer.hpp"
 
+#include <algorithm>
+
+#include "core/audio/sample_analysis.hpp"
 #include "services/audio_manager.hpp"
 #include "services/clock_manager.hpp"
+#include "services/controller.hpp"
+
+#include "util/dir_index.hpp"
+#include "util/dsp/mix_kernels.hpp"
 
 namespace otto::engines {
 
@@ -9,17 +16,86 @@ namespace otto::engines {
 
   static std::unique_ptr<ui::Screen> make_screen(Sequencer* seq);
 
-  Sequencer::Sequencer() : MiscEngine<Sequencer>(make_screen(this)) {}
+  Sequencer::Sequencer()
+    : MiscEngine<Sequencer>([this] { return make_screen(this); }),
+      step_timer_(ClockManager::current().add_timer(clock::notes::eighth / substeps))
+  {
+    for (auto&& path : util::scan_tree(Application::current().data_dir / "kits")) {
+      DLOGI("Found kit bundle {}", path);
+      kit_names_.push_back(std::move(path));
+    }
+    // Every sequence edit - step toggles, mutes - comes through the input
+    // signal, so it is a sufficient (if conservative) dirty hook for the
+    // schedule. The rebuild is cheap and only runs when a block follows input
+    on_input_ = Controller::current().signals.on_input.connect(
+      [this](auto&& event) { schedule_dirty_.store(true, std::memory_order_release); });
+  }
 
-  template<std::size_t N>
-  void Sequencer::SamplerGroup<N>::process(audio::AudioBufferHandle audio, int step_n) noexcept
+  void Sequencer::rebuild_schedule() noexcept
   {
-    auto& step = seq.steps[step_n];
-    bool trig = step.triggered() and !mutes[step.note];
+    schedule_.entries.clear();
+    schedule_.any.reset();
+    for (int s = 0; s < bar_length; s++) {
+      std::uint16_t mask = 0;
+      int chan = 0;
+      for_all_chans([&](ChannelEnum, auto& group, int idx) {
+        auto& step = group.seq.steps[s];
+        if (step.triggered() && step.note == idx && !group.mutes[idx]) mask |= 1u << chan;
+        chan++;
+      });
+      if (mask != 0) {
+        schedule_.entries.push_back({std::int16_t(s), mask});
+        schedule_.any.set(s);
+      }
+    }
+  }
+
+  void Sequencer::load_kit(int idx)
+  {
+    if (kit_names_.empty()) return;
+    idx = ((idx % int(kit_names_.size())) + int(kit_names_.size())) % int(kit_names_.size());
+
+    const auto kit_path = Application::current().data_dir / "kits" / kit_names_[idx];
+    util::SampleBundle fresh;
+    if (!fresh.load(kit_path)) {
+      LOGE("Error loading kit bundle {}", kit_names_[idx]);
+      return;
+    }
+    // One identity for the whole bundle - every channel's analysis sidecar is
+    // keyed on it, so editing the kit invalidates them all
+    const auto kit_id = core::audio::SampleAnalysis::source_id_of(kit_path);
+    // The samplers can keep reading the old kit until they swap at a block
+    // boundary, so it has to outlive this call
+    prev_kit_ = std::move(kit_);
+    kit_ = std::move(fresh);
+    cur_kit_ = idx;
+
+    int channel = 0;
+    for_all_chans([&](ChannelEnum, auto& group, int i) {
+      if (channel < kit_.channels()) {
+        auto& entry = kit_.entry(channel);
+        group.samplers[i].load_shared(kit_names_[idx] + "/" + entry.name, entry.data, entry.frames,
+                                      entry.samplerate, kit_id);
+      }
+      channel++;
+    });
+    DLOGI("Loaded kit bundle {} with {} channels", kit_names_[idx], kit_.channels());
+  }
 
-    if (trig and &samplers.current() != &samplers[step.note]) {
-      samplers.current().finish();
-      samplers.select(step.note);
+  template<std::size_t N>
+  void Sequencer::SamplerGroup<N>::process(audio::AudioBufferHandle audio, unsigned trig_mask) noexcept
+  {
+    const bool trig = trig_mask != 0;
+    if (trig) {
+      int note = 0;
+      while ((trig_mask & 1u) == 0) {
+        trig_mask >>= 1u;
+        note++;
+      }
+      if (&samplers.current() != &samplers[note]) {
+        samplers.current().finish();
+        samplers.select(note);
+      }
     }
 
     samplers.current().process(audio, trig);
@@ -29,12 +105,33 @@ namespace otto::engines {
   {
     auto buf = AudioManager::current().buffer_pool().allocate_clear();
 
-    props.group0.process(buf, props.cur_step);
-    props.group1.process(buf, props.cur_step);
-    props.group2.process(buf, props.cur_step);
-    props.group3.process(buf, props.cur_step);
+    if (schedule_dirty_.exchange(false, std::memory_order_acquire)) rebuild_schedule();
 
-    props.cur_step = data.clock.position_of_multiple(clock::notes::eighth / substeps) % (16 * substeps);
+    for (auto& tick : step_timer_.ticks) props.cur_step = tick.position % bar_length;
+
+    // Look up the channel mask for the current step. The bitset rejects the
+    // common silent step without touching the entry array
+    const int step = props.cur_step;
+    std::uint16_t mask = 0;
+    if (schedule_.any[std::size_t(step)]) {
+      auto it = std::lower_bound(schedule_.entries.begin(), schedule_.entries.end(), step,
+                                 [](const Schedule::Entry& e, int s) { return e.step < s; });
+      mask = it->channels;
+    }
+
+    // The groups are independent until the final mix, so half of them render
+    // on the worker core into their own bus while the other half render here.
+    // The lambda lives on this stack frame until the join below
+    auto aux = AudioManager::current().buffer_pool().allocate_clear();
+    auto worker_job = [&] {
+      props.group1.process(aux, (mask >> 2u) & 0b111u);
+      props.group3.process(aux, (mask >> 7u) & 0b111u);
+    };
+    group_worker_.submit([](void* p) { (*static_cast<decltype(worker_job)*>(p))(); }, &worker_job);
+    props.group0.process(buf, (mask >> 0u) & 0b11u);
+    props.group2.process(buf, (mask >> 5u) & 0b11u);
+    group_worker_.wait();
+    util::dsp::accumulate(buf.data(), aux.data(), buf.size());
 
     return data.with(buf);
   }
@@ -258,6 +355,7 @@ namespace otto::engines {
         else
           cm.start();
         break;
+      case Key::yellow_click: engine.load_kit(engine.cur_kit_ + 1); return true;
       default: break;
     }
     return false;
@@ -330,6 +428,15 @@ namespace otto::engines {
   // Draw
 
 
-  void SeqScreen::draw(Canvas& ctx) {}
+  void SeqScreen::draw(Canvas& ctx)
+  {
+    if (engine.cur_kit_ >= 0) {
+      ctx.beginPath();
+      ctx.font(Fonts::Norm, 25);
+      ctx.fillStyle(Colours::Yellow);
+      ctx.textAlign(HorizontalAlign::Center, VerticalAlign::Middle);
+      ctx.fillText(engine.kit_names_[engine.cur_kit_], {160, 210});
+    }
+  }
 
 } // namespace otto::engines
@@ -1,7 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <bitset>
+
 #include "core/engine/engine.hpp"
+#include "services/clock_manager.hpp"
+#include "util/audio_worker.hpp"
 #include "util/local_vector.hpp"
+#include "util/thread.hpp"
+#include "util/sample_bundle.hpp"
+#include "util/signals.hpp"
 #include "util/selectable.hpp"
 
 #include "engines/misc/sampler/sampler.hpp"
@@ -65,7 +73,10 @@ namespace otto::engines {
 
       DECL_REFLECTION(SamplerGroup, samplers, seq, mutes);
 
-      void process(audio::AudioBufferHandle d, int step) noexcept;
+      /// `trig_mask` has bit `i` set when sampler `i` triggers on the current
+      /// step - at most one bit, the sequence is mono. Mutes are already
+      /// applied - see {@ref Sequencer::rebuild_schedule}
+      void process(audio::AudioBufferHandle d, unsigned trig_mask) noexcept;
     };
 
     struct Props {
@@ -87,11 +98,63 @@ namespace otto::engines {
     ui::Screen& sampler_screen() noexcept;
     ui::Screen& envelope_screen() noexcept;
 
+    /// Load kit bundle number `idx` (wrapping) from `data/kits`, feeding its
+    /// channels to the samplers in order. One open + mmap for the whole kit -
+    /// no decoding, so switching is near-instant. Logic thread.
+    void load_kit(int idx);
+
     audio::ProcessData<1> process(audio::ProcessData<0>) noexcept;
   private:
+    constexpr static int bar_length = 16 * substeps;
 
     friend struct SeqScreen;
 
+    /// Precomputed bar-length trigger schedule.
+    ///
+    /// One entry per substep that triggers at least one channel, in step
+    /// order, with a bit per sampler channel and mutes applied at build time.
+    /// The per-block audio path is a bitset probe, a binary search and a mask
+    /// unpack instead of a `Step` struct read per group - the editable `Step`
+    /// arrays are only walked in {@ref rebuild_schedule}
+    struct Schedule {
+      struct Entry {
+        std::int16_t step;
+        std::uint16_t channels;
+      };
+      util::local_vector<Entry, bar_length> entries;
+      /// Dense on/off view of the step arrays - one bit per substep
+      std::bitset<bar_length> any;
+    };
+
+    /// Rebuild {@ref schedule_} from the step arrays and mutes.
+    ///
+    /// Allocation free, so it runs on the audio thread at the start of the
+    /// block after an edit - every edit arrives through the input signal,
+    /// which marks {@ref schedule_dirty_}
+    void rebuild_schedule() noexcept;
+
+    /// Fires on every substep. Transport-gated, since the sequencer only
+    /// advances while the clock runs
+    services::ClockManager::Timer& step_timer_;
+
+    Schedule schedule_;
+    std::atomic<bool> schedule_dirty_ = true;
+    util::Slot on_input_;
+
+    /// Renders half of the sampler groups each block - the groups are
+    /// independent until the final mix, so they fork/join across the two
+    /// cores like the fx stages do. See {@ref process}
+    util::audio_worker group_worker_{util::scheduling::worker_cpu()};
+
+    /// Kit bundle files in `data/kits`, in listing order
+    std::vector<std::string> kit_names_;
+    int cur_kit_ = -1;
+    /// The mapped kit the samplers currently play from. The previous bundle is
+    /// kept one generation, since samplers swap buffers at block boundaries
+    /// and can still read from it until they pick up the new one
+    util::SampleBundle kit_;
+    util::SampleBundle prev_kit_;
+
     /// @param f callable as `f(SamplerGroup, int idx)`
     template<typename F>
     auto for_cur_chan(F&& f);
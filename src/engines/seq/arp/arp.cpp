@@ -3,6 +3,8 @@
 #include "core/ui/vector_graphics.hpp"
 #include <algorithm>
 
+#include "util/static_string.hpp"
+
 namespace otto::engines {
 
   using namespace ui;
@@ -55,117 +57,148 @@ namespace otto::engines {
 
   audio::ProcessData<0> Arp::process(audio::ProcessData<0> data)
   {
-    // Add or remove notes from the held_notes_ stack
-    for (auto& event : data.midi) {
-      util::match(event,
-                  [&](midi::NoteOnEvent& ev) {
-                    // Add notes to stack
-                    held_notes_.push_back(ev);
-                    has_changed_ = true;
-                    // Remove from data struct
-                  },
-                  [&](midi::NoteOffEvent& ev) {
-                    // Remove all corresponding notes from the stack
-                    util::erase_if(held_notes_,
-                                   [ev](midi::NoteOnEvent& noe) { return ev.key == noe.key; });
-                    has_changed_ = true;
-                  },
-                  [](auto&&) {});
-    };
+    // Add or remove notes from the held note stacks. The block is
+    // preprocessed into typed spans, so no per-event matching. Offs first,
+    // so a key released and re-pressed in one block stays held
+    bool changed = false;
+    for (auto ev : midi::events_of_type<midi::NoteOffEvent>(data.midi)) {
+      // Remove all corresponding notes from the stacks
+      util::erase_if(held_notes_, [&ev](midi::NoteOnEvent& noe) { return ev.key == noe.key; });
+      util::erase_if(sorted_held_, [&ev](midi::NoteOnEvent& noe) { return ev.key == noe.key; });
+      changed = true;
+    }
+    for (auto ev : midi::events_of_type<midi::NoteOnEvent>(data.midi)) {
+      held_notes_.push_back(ev);
+      // Keep the sorted view sorted on the way in, so the rebuild never sorts
+      sorted_held_.insert(
+        std::upper_bound(sorted_held_.begin(), sorted_held_.end(), ev,
+                         [](const midi::NoteOnEvent& a, const midi::NoteOnEvent& b) { return a.key < b.key; }),
+        ev);
+      changed = true;
+    }
 
+    // Remove from data struct
     data.midi.clear();
 
-    // If the held_notes_ stack has changed, re-sort and reset.
-    if (has_changed_) {
+    // Rebuild the pattern at chord-change time - the clock ticks below only
+    // index into the ready array. Pending note-offs are served from
+    // `sounding_`, so invalidating `iter` here is safe
+    if (changed) {
       //Flag to recalculate on the graphics thread
       props.graphics_outdated = true;
-      // If stack is now empty, stop the arpeggiator
+      rebuild_pattern();
+      iter = util::view::circular(props.output_stack_).begin();
+      // If the stack is now empty, stop the arpeggiator
       if (held_notes_.empty()) {
         running_ = false;
-        for (auto&& ev : *iter) {
+        for (auto&& ev : sounding_) {
           data.midi.push_back(midi::NoteOffEvent(ev.key));
         }
-        //Necessary to clear the output_stack and the dots on the screen
-        sort_notes();
-        iter = util::view::circular(props.output_stack_).begin();
-        props.graphics_outdated = true;
+        sounding_.clear();
       } else if (!running_) { // If it wasn't running and should start now
         running_ = true;
-        _counter = 0;
+        immediate_beat_ = true;
       }
     }
 
-    // Check for beat. will be obsolete with master clock
-    auto next_beat = (_samples_per_beat - _counter) % _samples_per_beat;
-
-    // If we are running, at a note-off point, and the output stack is not empty send note-off
-    // events
-    if (next_beat <= _samples_per_beat - note_off_frames && running_ && !props.output_stack_.empty()) {
-      for (auto ev : *iter) {
-        data.midi.push_back(midi::NoteOffEvent(ev.key));
+    // At a note-off point, send note-off events for the sounding step at the
+    // exact tick frame
+    for (auto& tick : off_timer_.ticks) {
+      if (!running_ || sounding_.empty()) break;
+      for (auto ev : sounding_) {
+        data.midi.push_back(midi::NoteOffEvent(ev.key, 1, 0, tick.frame));
       }
+      sounding_.clear();
     }
 
-    // If we are running, and at a new beat, do stuff.
-    if (next_beat <= data.nframes && running_) {
-      // Resort notes. Wait until this point to make sure that off events have been sent
-      if (has_changed_) {
-        sort_notes();
-        iter = util::view::circular(props.output_stack_).begin();
-        has_changed_ = false;
-      }
+    auto do_beat = [&](int frame) {
       // Go to next value in the output_stack
       // increment in output stack (wrapping) and push new notes
       iter++;
+      sounding_.clear();
       for (auto ev : *iter) {
+        ev.time = frame;
         data.midi.push_back(ev);
+        sounding_.push_back(ev);
       }
-    }
+    };
 
-    // Increment counter. will be obsolete with master clock
-    _counter += data.nframes;
-    _counter %= _samples_per_beat;
+    if (running_) {
+      if (immediate_beat_) {
+        // Fire the first step at once, as a reset counter used to
+        immediate_beat_ = false;
+        do_beat(0);
+      } else {
+        for (auto& tick : beat_timer_.ticks) do_beat(tick.frame);
+      }
+    }
 
     return data;
   }
 
-  Arp::Arp() : ArpeggiatorEngine<Arp>(std::make_unique<ArpScreen>(this))
+  Arp::Arp()
+    : ArpeggiatorEngine<Arp>([this] { return std::make_unique<ArpScreen>(this); }),
+      beat_timer_(services::ClockManager::current().add_timer(clock::notes::beat, 0, true)),
+      off_timer_(services::ClockManager::current().add_timer(
+        clock::notes::beat,
+        clock::Time(0.2f * float(clock::notes::beat)),
+        true))
   {
     // Set on_change handlers
     props.note_length.on_change().connect(
-      [this](float len) { note_off_frames = (int)(len * (float)_samples_per_beat); });
-    props.subdivision.on_change().connect(
-            [this](int mod) {
-              _samples_per_beat = _samples_per_quarternote / mod;
-              note_off_frames = (int)(props.note_length * (float)_samples_per_beat);
-            });
+      [this](float len) { off_timer_.offset = clock::Time(len * float(beat_timer_.period)); });
+    props.subdivision.on_change().connect([this](int mod) {
+      beat_timer_.period = clock::notes::beat / mod;
+      off_timer_.period = beat_timer_.period;
+      off_timer_.offset = clock::Time(props.note_length * float(beat_timer_.period));
+    });
   }
 
-  // Sorting  for the arpeggiator. This is where the magic happens.
-  void Arp::sort_notes()
+  // Pattern expansion for the arpeggiator. This is where the magic happens.
+  void Arp::rebuild_pattern()
   {
     auto& res = props.output_stack_;
     res.clear();
-    // Sanitize input (remove duplicates)
-    //Maybe only needed for development. Let's leave it for now
+
+    // The manual playmode plays notes in press order, everything else starts
+    // from the key-sorted view - kept sorted incrementally, so no sorting here
+    const bool manual = props.playmode.get() == +Playmode::manual;
+    const auto& src = manual ? held_notes_ : sorted_held_;
+
+    auto push_single = [&](midi::NoteOnEvent ev) {
+      NoteArray step;
+      step.push_back(ev);
+      res.push_back(std::move(step));
+    };
+    // The octave-doubling modes emit two transposed runs of `src`. Each run is
+    // ascending, so the key-ordered expansion is a two-pointer merge - no sort
+    auto push_merged = [&](int t1, int t2) {
+      std::size_t i = 0;
+      std::size_t j = 0;
+      while (i < src.size() || j < src.size()) {
+        const bool first =
+          j == src.size() || (i < src.size() && src[i].key + t1 <= src[j].key + t2);
+        push_single(first ? transpose_note(src[i++], t1) : transpose_note(src[j++], t2));
+      }
+    };
 
     // Add new notes depending on octavemode. Most octavemodes add new vectors to the output
     // (separate steps), but unison modes add new notes to the same steps. To keep things
     // "simple", an octavemode cannot do both.
     switch (props.octavemode.get()) {
     case OctaveMode::octaveup: {
-      for (auto ev : held_notes_) {
-        NoteArray orig;
-        orig.push_back(ev);
-        NoteArray oct;
-        oct.push_back(transpose_note(ev, 12));
-        res.push_back(orig);
-        res.push_back(oct);
+      if (manual) {
+        for (auto ev : src) {
+          push_single(ev);
+          push_single(transpose_note(ev, 12));
+        }
+      } else {
+        push_merged(0, 12);
       }
       break;
     }
     case OctaveMode::octaveupunison: {
-      for (auto ev : held_notes_) {
+      for (auto ev : src) {
         NoteArray new_step;
         new_step.push_back(ev);
         new_step.push_back(transpose_note(ev, 12));
@@ -174,7 +207,7 @@ namespace otto::engines {
       break;
     }
     case OctaveMode::fifthunison: {
-      for (auto ev : held_notes_) {
+      for (auto ev : src) {
         NoteArray new_step;
         new_step.push_back(ev);
         new_step.push_back(transpose_note(ev, 7));
@@ -183,52 +216,56 @@ namespace otto::engines {
       break;
     }
     case OctaveMode::octaveupdown: {
-      for (auto ev : held_notes_) {
-        NoteArray up;
-        up.push_back(transpose_note(ev, 12));
-        NoteArray down;
-        down.push_back(transpose_note(ev, -12));
-        res.push_back(up);
-        res.push_back(down);
+      if (manual) {
+        for (auto ev : src) {
+          push_single(transpose_note(ev, 12));
+          push_single(transpose_note(ev, -12));
+        }
+      } else {
+        push_merged(-12, 12);
       }
       break;
     }
     case OctaveMode::standard: [[fallthrough]];
     default: {
-      for (auto ev : held_notes_) {
-        NoteArray new_step;
-        new_step.push_back(ev);
-        res.push_back(new_step);
+      for (auto ev : src) {
+        push_single(ev);
       }
       break;
     }
     }
 
-    // Sort vectors (steps) according to the playmode. A mode like updown adds extra steps.
-    // The chord mode gathers all vectors into one.
+    // Order the steps according to the playmode. The expansion above is
+    // already in ascending key order, so every mode is a reverse and/or a
+    // mirrored append instead of a sort. A mode like updown adds extra steps,
+    // the chord mode gathers all vectors into one. Reserve before the
+    // mirrored appends - reverse_copy through back_inserter must not
+    // invalidate its own source range
     switch (props.playmode.get()) {
-    case Playmode::up: {
-      util::sort(res, [](auto& a, auto& b) { return a.front().key < b.front().key; });
-    } break;
+    case Playmode::up: break;
     case Playmode::down: {
-      util::sort(res, [](auto& a, auto& b) { return a.front().key > b.front().key; });
+      std::reverse(res.begin(), res.end());
     } break;
     case Playmode::updown: {
-      util::sort(res, [](auto& a, auto& b) { return a.front().key < b.front().key; });
-      if (res.size() > 2)
+      if (res.size() > 2) {
+        res.reserve(2 * res.size() - 2);
         std::reverse_copy(res.begin() + 1, res.end() - 1, std::back_inserter(res));
+      }
     } break;
     case Playmode::downup: {
-      util::sort(res, [](auto& a, auto& b) { return a.front().key > b.front().key; });
-      if (res.size() > 2)
+      std::reverse(res.begin(), res.end());
+      if (res.size() > 2) {
+        res.reserve(2 * res.size() - 2);
         std::reverse_copy(res.begin() + 1, res.end() - 1, std::back_inserter(res));
+      }
     } break;
     case Playmode::updowninc: {
-      util::sort(res, [](auto& a, auto& b) { return a.front().key < b.front().key; });
+      res.reserve(2 * res.size());
       std::reverse_copy(res.begin(), res.end(), std::back_inserter(res));
     } break;
     case Playmode::downupinc: {
-      util::sort(res, [](auto& a, auto& b) { return a.front().key > b.front().key; });
+      std::reverse(res.begin(), res.end());
+      res.reserve(2 * res.size());
       std::reverse_copy(res.begin(), res.end(), std::back_inserter(res));
     } break;
     case Playmode::manual: break;
@@ -296,7 +333,7 @@ namespace otto::engines {
     ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
     ctx.fillText("NoteLength", 52, 81.6);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{:1}", props.note_length * 100), 200, 81.6);
+    ctx.fillText(util::format_static("{:1}", props.note_length * 100), 200, 81.6);
 
     ctx.restore();
 
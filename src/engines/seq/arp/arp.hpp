@@ -3,6 +3,8 @@
 #include <foonathan/array/small_array.hpp>
 
 #include "core/engine/engine.hpp"
+#include "services/clock_manager.hpp"
+#include "util/pool_allocator.hpp"
 
 namespace otto::engines {
 
@@ -46,7 +48,9 @@ namespace otto::engines {
       Property<float> note_length = {0.2f, limits(0.01f, 0.97f), step_size(0.01)};
       Property<int, wrap> subdivision = {1, limits(1, 4)};
 
-      std::vector<NoteArray> output_stack_;
+      // Grows at runtime, so allocate through the slab pool - O(1) and no
+      // heap fragmentation over long sessions
+      std::vector<NoteArray, util::pool_allocator<NoteArray>> output_stack_;
       bool graphics_outdated = false;
 
       DECL_REFLECTION(Props, playmode, octavemode, note_length);
@@ -56,20 +60,34 @@ namespace otto::engines {
 
     audio::ProcessData<0> process(audio::ProcessData<0> data);
 
-    void sort_notes();
-
     midi::NoteOnEvent transpose_note(midi::NoteOnEvent, int);
 
 
   private:
-    int _samples_per_quarternote = 22050;
-    int _samples_per_beat = 22050;
-    int _counter = _samples_per_beat;
-    bool has_changed_ = false;
-    int note_off_frames = 1000;
+    /// Rebuild {@ref Props::output_stack_} from the held notes.
+    ///
+    /// Runs once per chord change, when the note events are ingested - the
+    /// clock ticks just index into the ready array. {@ref sorted_held_} is
+    /// maintained incrementally on note on/off, so the rebuild is a linear
+    /// expansion plus at most a reverse - no comparison sorts of note arrays
+    void rebuild_pattern();
+    /// Fires on every arp step, and at the note-off point within each step.
+    /// Free-running, so the arp works without the transport
+    services::ClockManager::Timer& beat_timer_;
+    services::ClockManager::Timer& off_timer_;
     bool running_ = false;
-
-    std::vector<midi::NoteOnEvent> held_notes_;
+    /// Set on start, to fire the first step at once instead of at the next
+    /// beat tick
+    bool immediate_beat_ = false;
+
+    /// Held notes in press order - the manual playmode plays them as is
+    std::vector<midi::NoteOnEvent, util::pool_allocator<midi::NoteOnEvent>> held_notes_;
+    /// The same notes kept sorted by key, updated incrementally on note
+    /// on/off - see {@ref rebuild_pattern}
+    std::vector<midi::NoteOnEvent, util::pool_allocator<midi::NoteOnEvent>> sorted_held_;
+    /// The notes sounding from the last step, so pending note-offs survive a
+    /// pattern rebuild invalidating {@ref iter}
+    NoteArray sounding_;
     decltype(util::view::circular(props.output_stack_).begin()) iter = util::view::circular(props.output_stack_).begin();
   };
 
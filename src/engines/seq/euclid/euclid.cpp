@@ -51,9 +51,19 @@ namespace otto::engines {
     void draw_channel(ui::vg::Canvas& ctx, State::ChannelState& chan);
   };
 
-  Euclid::Euclid() : ArpeggiatorEngine<Euclid>(std::make_unique<EuclidScreen>(this))
+  Euclid::Euclid()
+    : ArpeggiatorEngine<Euclid>([this] { return std::make_unique<EuclidScreen>(this); }),
+      beat_timer_(services::ClockManager::current().add_timer(clock::notes::sixteenth, 0, true))
   {
-    for (auto& c : props.channels) c.update_notes();
+    for (auto& c : props.channels) {
+      c.update_notes();
+      // Regenerate the pattern whenever a prop moves. The setters run on the
+      // logic thread, so the audio path never recomputes placement
+      auto regen = [&c] { c.update_notes(); };
+      c.length.on_change().connect(regen);
+      c.hits.on_change().connect(regen);
+      c.rotation.on_change().connect(regen);
+    }
     static_cast<EuclidScreen*>(&screen())->refresh_state();
   }
 
@@ -62,38 +72,37 @@ namespace otto::engines {
     auto& current = current_channel();
     // Copy for thread safety
     if (auto recording = this->recording; recording) {
-      for (auto& event : data.midi) {
-        util::match(event,
-                    [&](midi::NoteOnEvent& ev) {
-                      if (!_has_pressed_keys) {
-                        util::fill(recording.value(), -1);
-                        current.notes.set(recording.value());
-                        _has_pressed_keys = true;
-                      }
-                      for (auto& note : recording.value()) {
-                        if (note >= 0) continue;
-                        note = ev.key;
-                        break;
-                      }
-                      util::unique(recording.value(), std::equal_to<char>());
-                      current.notes = recording.value();
-                    },
-                    [&](midi::NoteOffEvent& ev) {
-                      for (auto& note : recording.value()) {
-                        if (note != ev.key) continue;
-                        note = -1;
-                      }
-                      if (util::all_of(recording.value(), [](int note) { return note < 0; })) {
-                        recording = tl::nullopt;
-                      }
-                    },
-                    [](auto&&) {});
-        this->recording = recording;
+      // The block is preprocessed into typed spans, so no per-event matching
+      for (auto ev : midi::events_of_type<midi::NoteOnEvent>(data.midi)) {
+        if (!_has_pressed_keys) {
+          util::fill(recording.value(), -1);
+          current.notes.set(recording.value());
+          _has_pressed_keys = true;
+        }
+        for (auto& note : recording.value()) {
+          if (note >= 0) continue;
+          note = ev.key;
+          break;
+        }
+        util::unique(recording.value(), std::equal_to<char>());
+        current.notes = recording.value();
+      }
+      for (auto ev : midi::events_of_type<midi::NoteOffEvent>(data.midi)) {
         if (!recording) break;
-        ;
+        for (auto& note : recording.value()) {
+          if (note != ev.key) continue;
+          note = -1;
+        }
+        if (util::all_of(recording.value(), [](int note) { return note < 0; })) {
+          recording = tl::nullopt;
+        }
       }
+      this->recording = recording;
+    }
+    if (_should_run && !running) {
+      running = true;
+      _immediate_beat = true;
     }
-    if (_should_run) running = true;
     if (!running) return data;
 
     if (!_should_run && running) {
@@ -104,43 +113,62 @@ namespace otto::engines {
       }
       _counter = _samples_per_beat;
       running = false;
+      midi::preprocess_events(data.midi);
       return data;
     }
 
-    auto next_beat = _samples_per_beat - _counter;
-
-    if (next_beat <= data.nframes) {
+    auto do_beat = [&](int frame) {
       for (auto& channel : props.channels) {
         if (channel.length > 0) {
           channel._beat_counter++;
           channel._beat_counter %= channel.length;
           for (auto& note : channel.notes.get()) {
-            if (note >= 0) data.midi.push_back(midi::NoteOffEvent(note));
+            if (note >= 0) data.midi.push_back(midi::NoteOffEvent(note, 1, 0, frame));
           }
-          if (running && channel._hits_enabled.at(channel._beat_counter)) {
+          if (running && (channel._pattern >> channel._beat_counter & 1)) {
             for (auto note : channel.notes.get()) {
               if (note >= 0) {
-                data.midi.push_back(midi::NoteOnEvent(note));
+                auto ev = midi::NoteOnEvent(note);
+                ev.time = frame;
+                data.midi.push_back(ev);
               }
             }
           }
         }
       }
+      // Keep the screen animation in phase with the timer
+      _counter = -frame;
+    };
+
+    if (_immediate_beat) {
+      // Fire the first beat at once, as a reset counter used to
+      _immediate_beat = false;
+      do_beat(0);
+    } else {
+      for (auto& tick : beat_timer_.ticks) do_beat(tick.frame);
     }
 
+    // Only used for the screen animation
+    auto spb = services::ClockManager::current().samples_pr_beat() / 4;
+    if (spb > 0) _samples_per_beat = spb;
     _counter += data.nframes;
     _counter %= _samples_per_beat;
+    // The channel loop above interleaves off and on events - restore span
+    // order for the consumers downstream
+    midi::preprocess_events(data.midi);
     return data;
   }
 
   void Euclid::Channel::update_notes()
   {
-    util::fill(_hits_enabled, false);
-    if (hits == 0 || length == 0) return;
-    for (float i = 0; i < length; i += length / float(hits)) {
-      int idx = int(std::round(i) + rotation) % length;
-      _hits_enabled.at(idx) = true;
+    std::uint16_t pattern = 0;
+    if (hits > 0 && length > 0) {
+      for (float i = 0; i < length; i += length / float(hits)) {
+        int idx = int(std::round(i) + rotation) % length;
+        pattern |= std::uint16_t(1 << idx);
+      }
     }
+    _pattern = pattern;
   }
 
   // SCREEN //
@@ -158,7 +186,6 @@ namespace otto::engines {
     case Encoder::yellow: current.hits.step(ev.steps); break;
     case Encoder::red: current.rotation.step(ev.steps); break;
     }
-    current.update_notes();
     refresh_state();
   }
 
@@ -329,7 +356,7 @@ namespace otto::engines {
         auto& hs = cs.hits.at(i);
         float angle = 2.0 * M_PI * (i / float(state.max_length) - 0.25);
         hs.point = state.center + Point{cs.radius * std::cos(angle), cs.radius * std::sin(angle)};
-        hs.active = chan._hits_enabled.at(i);
+        hs.active = chan._pattern >> i & 1;
       }
     }
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/engine/engine.hpp"
+#include "services/clock_manager.hpp"
 
 #include <array>
 #include <tl/optional.hpp>
@@ -25,7 +26,11 @@ namespace otto::engines {
       void update_notes();
 
       int _beat_counter = 0;
-      std::array<bool, max_length> _hits_enabled;
+      /// Expanded hit pattern. Bit `i` is set if step `i` is a hit.
+      /// Regenerated from the props on change in the logic thread by
+      /// {@ref update_notes}, so both the audio path and the screen read
+      /// it with a single bit test
+      std::uint16_t _pattern = 0;
 
       DECL_REFLECTION(Channel, length, hits, rotation, notes);
     };
@@ -52,6 +57,13 @@ namespace otto::engines {
   private:
     friend struct EuclidScreen;
 
+    /// Fires on every sixteenth. Free-running, so the sequence plays without
+    /// the transport
+    services::ClockManager::Timer& beat_timer_;
+    // Set on start, to fire the first beat at once instead of at the next tick
+    bool _immediate_beat = false;
+
+    // Only used for the screen animation
     int _samples_per_beat = 22050 / 4;
     int _counter = _samples_per_beat;
     // Used to make sure NoteOff events are sent when stopped
@@ -1,6 +1,9 @@
 #include "core/ui/vector_graphics.hpp"
 #include "ottofm.hpp"
 
+#include "util/dsp/sine_table.hpp"
+#include "util/static_string.hpp"
+
 #include "services/application.hpp"
 #include "services/ui_manager.hpp"
 
@@ -144,19 +147,30 @@ namespace otto::engines {
 
   float OTTOFMSynth::FMOperator::FMSine::operator()(float phsOffset = 0) noexcept
   {
-    return gam::scl::sinP9(gam::scl::wrap(this->nextPhase() + phsOffset, 1.f, -1.f));
+    // Table lookup instead of polynomial evaluation - the table is shared between all
+    // operators of all voices
+    return util::dsp::sine_table::lookup_signed(gam::scl::wrap(this->nextPhase() + phsOffset, 1.f, -1.f));
   }
 
-  float OTTOFMSynth::FMOperator::operator()(float phaseMod = 0)
+  template<bool Modulator>
+  float OTTOFMSynth::FMOperator::tick(float phaseMod) noexcept
   {
-    if (modulator)
+    if constexpr (Modulator) {
       return env() * sine(phaseMod) * outlevel * fm_amount;
-    else {
+    } else {
       previous_value = sine(phaseMod + feedback * previous_value) * outlevel;
       return previous_value;
     }
   }
 
+  float OTTOFMSynth::FMOperator::operator()(float phaseMod = 0)
+  {
+    if (modulator)
+      return tick<true>(phaseMod);
+    else
+      return tick<false>(phaseMod);
+  }
+
   void OTTOFMSynth::FMOperator::freq(float frq)
   {
     sine.freq(frq);
@@ -185,7 +199,86 @@ namespace otto::engines {
   float OTTOFMSynth::Voice::operator()() noexcept
   {
     set_frequencies();
-    return algos(props.algN);
+    return algos(pre.params.read().algN);
+  }
+
+  /// Copy the block's snapshot into the operators' plain fields.
+  ///
+  /// The snapshot is flipped once per block in `Pre`, so every voice applies
+  /// the same coherent parameter set.
+  void OTTOFMSynth::Voice::apply_params() noexcept
+  {
+    auto& p = pre.params.read();
+    for (int i = 0; i < 4; i++) {
+      auto& op = operators[i];
+      op.modulator = algorithms[p.algN].modulator_flags[i];
+      op.fm_amount = p.fmAmount;
+      op.outlevel = p.ops[i].outlevel;
+      op.detune_amount = p.ops[i].detune_amount;
+      op.freq_ratio = p.ops[i].freq_ratio;
+      op.feedback = p.ops[i].feedback;
+    }
+  }
+
+  /// Per-algorithm sample expressions. These mirror `algos`, but both the algorithm and
+  /// the modulator/carrier role of each operator are compile-time constants, so each
+  /// instantiation is one straight-line chain of envelope/sine evaluations.
+  template<int Alg>
+  float OTTOFMSynth::Voice::tick_alg() noexcept
+  {
+    auto& op = operators;
+    if constexpr (Alg == 0) return op[0].tick<false>(op[1].tick<true>(op[2].tick<true>(op[3].tick<true>(0))));
+    else if constexpr (Alg == 1) return op[0].tick<false>(op[1].tick<true>(op[2].tick<true>(0) + op[3].tick<true>(0)));
+    else if constexpr (Alg == 2) return op[0].tick<false>(op[1].tick<true>(op[2].tick<true>(0)) + op[3].tick<true>(0));
+    else if constexpr (Alg == 3) {
+      float aux = op[3].tick<true>(0);
+      return op[0].tick<false>(op[1].tick<true>(aux) + op[2].tick<true>(aux));
+    }
+    else if constexpr (Alg == 4) {
+      float aux = op[2].tick<true>(op[3].tick<true>(0));
+      return op[0].tick<false>(aux) + op[1].tick<false>(aux);
+    }
+    else if constexpr (Alg == 5) return op[0].tick<false>(0) + op[1].tick<false>(op[2].tick<true>(op[3].tick<true>(0)));
+    else if constexpr (Alg == 6) return op[0].tick<false>(op[1].tick<true>(0) + op[2].tick<true>(0) + op[3].tick<true>(0));
+    else if constexpr (Alg == 7) return op[0].tick<false>(op[1].tick<true>(0)) + op[2].tick<false>(op[3].tick<true>(0));
+    else if constexpr (Alg == 8) {
+      float aux = op[3].tick<true>(0);
+      return op[0].tick<false>(aux) + op[1].tick<false>(aux) + op[2].tick<false>(aux);
+    }
+    else if constexpr (Alg == 9) return op[0].tick<false>(0) + op[1].tick<false>(0) + op[2].tick<false>(op[3].tick<true>(0));
+    else if constexpr (Alg == 10)
+      return op[0].tick<false>(0) + op[1].tick<false>(0) + op[2].tick<false>(0) + op[3].tick<false>(0);
+    else
+      return 0.f;
+  }
+
+  template<int Alg>
+  void OTTOFMSynth::Voice::render_block(audio_span<float> out) noexcept
+  {
+    for (auto& smpl : out) {
+      smpl = tick_alg<Alg>();
+    }
+  }
+
+  void OTTOFMSynth::Voice::process_block(audio_span<float> out) noexcept
+  {
+    apply_params();
+    set_frequencies();
+    // Dispatch on the algorithm once per block instead of once per sample
+    switch (pre.params.read().algN) {
+      case 0: render_block<0>(out); break;
+      case 1: render_block<1>(out); break;
+      case 2: render_block<2>(out); break;
+      case 3: render_block<3>(out); break;
+      case 4: render_block<4>(out); break;
+      case 5: render_block<5>(out); break;
+      case 6: render_block<6>(out); break;
+      case 7: render_block<7>(out); break;
+      case 8: render_block<8>(out); break;
+      case 9: render_block<9>(out); break;
+      case 10: render_block<10>(out); break;
+      default: util::fill(out, 0.f); break;
+    }
   }
 
   OTTOFMSynth::Voice::Voice(Pre& pre) noexcept : VoiceBase(pre)
@@ -193,28 +286,10 @@ namespace otto::engines {
     for (int i = 0; i < 4; i++) {
       operators[i].env.finish();
     }
-    /// Connect appropriate voice properties
-    props.algN.on_change().connect([this](int algo) {
-      // Change modulator flags
-      for (int i = 0; i < 4; i++) {
-        operators[i].modulator = algorithms[algo].modulator_flags[i];
-      }
-    });
-    props.fmAmount.on_change().connect([this](float fm) {
-      // Change modulator flags
-      for (int i = 0; i < 4; i++) {
-        operators[i].fm_amount = fm;
-      }
-    });
-
-    // Connect properties for individual operators
+    // Connect the envelope properties. The remaining operator parameters are
+    // published coherently through the snapshot in Pre, and applied per block
+    // in apply_params
     for (int i = 0; i < 4; i++) {
-      props.operators[i].outLev.on_change().connect(
-        [this, i](float level) { operators[i].outlevel = level; });
-      props.operators[i].detune.on_change().connect(
-        [this, i](float detune) { operators[i].detune_amount = detune * 25; });
-      props.operators[i].ratio_idx.on_change().connect(
-        [this, i](int idx) { operators[i].freq_ratio = (float) fractions[idx]; });
       props.operators[i].mAtt.on_change().connect(
         [this, i](float att) { operators[i].env.attack(3 * att); });
       props.operators[i].mDecrel.on_change().connect([this, i](float decrel) {
@@ -226,8 +301,6 @@ namespace otto::engines {
         operators[i].env.release(3 * props.operators[i].mDecrel * suspos);
         operators[i].env.sustain(suspos);
       });
-      props.operators[i].feedback.on_change().connect(
-        [this, i](float fb) { operators[i].feedback = fb; });
     }
   }
 
@@ -249,9 +322,29 @@ namespace otto::engines {
     }
   }
   // Preprocessor
-  OTTOFMSynth::Pre::Pre(Props& props) noexcept : PreBase(props) {}
+  OTTOFMSynth::Pre::Pre(Props& props) noexcept : PreBase(props)
+  {
+    // Re-commit the whole snapshot on any prop change. Committing is cheap,
+    // and one handler keeps every derived value in one coherent set
+    auto publish = [this] {
+      params.commit([&](AudioParams& p) {
+        p.algN = this->props.algN;
+        p.fmAmount = this->props.fmAmount;
+        for (int i = 0; i < 4; i++) {
+          auto& op = this->props.operators[i];
+          p.ops[i] = {op.outLev, op.detune * 25, (float) fractions[op.ratio_idx], op.feedback};
+        }
+      });
+    };
+    connect_on_change(props, publish);
+    publish();
+  }
 
-  void OTTOFMSynth::Pre::operator()() noexcept {}
+  void OTTOFMSynth::Pre::operator()() noexcept
+  {
+    // Flip to the latest committed parameter set for this block
+    params.flip();
+  }
 
   // Postprocessor
   /// Constructor. Takes care of linking appropriate variables to props
@@ -271,6 +364,22 @@ namespace otto::engines {
     return in;
   }
 
+  void OTTOFMSynth::Post::process_block(audio_span<float>) noexcept
+  {
+    // The audio passes through untouched - the per-sample call only mirrored
+    // operator levels into props for the screen, and once per block is
+    // more than enough for that
+    if (pre.last_voice) {
+      for (int i = 0; i < 4; i++) {
+        if (pre.last_voice->operators[i].modulator)
+          props.operators[i].current_level = pre.last_voice->operators[i].level();
+        else
+          props.operators[i].current_level =
+            pre.last_voice->envelope() * pre.last_voice->operators[i].outlevel;
+      }
+    }
+  }
+
   // OTTOFMSynth ////////////////////////////////////////////////////////////////
 
   audio::ProcessData<1> OTTOFMSynth::process(audio::ProcessData<1> data)
@@ -284,6 +393,9 @@ namespace otto::engines {
 
   struct OTTOFMSynthScreen : EngineScreen<OTTOFMSynth> {
     void draw(Canvas& ctx) override;
+    /// Labels and fixed geometry for the current view. Re-recorded when shift
+    /// is pressed or released, replayed every other frame
+    void draw_static(ui::vg::DisplayList& dl) override;
     void draw_with_shift(Canvas& ctx);
     void draw_no_shift(Canvas& ctx);
     void draw_operators(Canvas& ctx);
@@ -294,12 +406,21 @@ namespace otto::engines {
     bool shift = false;
     int cur_op = 0;
 
+    /// The operator wires and arrowheads only depend on the selected algorithm, so
+    /// they are recorded once and replayed until it changes
+    ui::vg::DisplayList alg_wires_dl;
+    ui::vg::DisplayList alg_arrows_dl;
+    int alg_wires_for = -1;
+
     using EngineScreen<OTTOFMSynth>::EngineScreen;
   };
 
   OTTOFMSynth::OTTOFMSynth()
-    : SynthEngine<OTTOFMSynth>(std::make_unique<OTTOFMSynthScreen>(this)), voice_mgr_(props)
-  {}
+    : SynthEngine<OTTOFMSynth>([this] { return std::make_unique<OTTOFMSynthScreen>(this); }), voice_mgr_(props)
+  {
+    // Prefer fewer voices over xruns when the rest of the chain is heavy
+    voice_mgr_.adaptive_voice_cap(true);
+  }
 
   bool OTTOFMSynthScreen::keypress(Key key)
   {
@@ -355,8 +476,13 @@ namespace otto::engines {
   {
     using namespace ui::vg;
 
-    shift = services::Controller::current().is_pressed(ui::Key::shift);
+    bool new_shift = services::Controller::current().is_pressed(ui::Key::shift);
+    if (new_shift != shift) {
+      shift = new_shift;
+      invalidate_static();
+    }
     ctx.font(Fonts::Norm, 35);
+    draw_static_layer(ctx);
 
     if (shift)
       draw_with_shift(ctx);
@@ -367,21 +493,66 @@ namespace otto::engines {
     draw_operators(ctx);
   }
 
-  void OTTOFMSynthScreen::draw_no_shift(ui::vg::Canvas& ctx)
+  void OTTOFMSynthScreen::draw_static(ui::vg::DisplayList& dl)
   {
     using namespace ui::vg;
-    ctx.font(Fonts::Norm, 35);
 
     constexpr float x_pad_left = 90;
     constexpr float x_pad = 30;
     constexpr float y_pad = 50;
     constexpr float space = (height - 2.f * y_pad) / 3.f;
-    // Ratio and Detune
-    ctx.beginPath();
-    ctx.fillStyle(Colours::Blue);
-    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
-    ctx.fillText("Ratio", {x_pad_left, y_pad});
 
+    dl.font(Fonts::Norm, 35);
+
+    // Blue and red labels
+    dl.beginPath();
+    dl.fillStyle(Colours::Blue);
+    dl.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
+    dl.fillText(shift ? "Detune" : "Ratio", {x_pad_left, y_pad});
+
+    dl.beginPath();
+    dl.fillStyle(Colours::Red);
+    dl.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
+    dl.fillText(shift ? "Algorithm" : "FM", {x_pad_left, y_pad + 3 * space});
+
+    if (!shift) {
+      // FM amount outline
+      dl.lineWidth(6.f);
+      constexpr float x_left = width - 6 * x_pad;
+      constexpr float x_right = width - x_pad;
+      constexpr float y_low = y_pad + 3 * space + 10;
+      constexpr float y_high = y_pad + 3 * space - 10;
+      dl.beginPath();
+      dl.moveTo(x_left, y_low);
+      dl.lineTo(x_right, y_high);
+      dl.lineTo(x_right, y_low);
+      dl.closePath();
+      dl.stroke(Colours::Red);
+    }
+
+    // Operator level - vertical line
+    float line_top = y_pad + 0.7 * space;
+    float line_bot = line_top + 1.5 * space;
+    float line_x = 3.5 * x_pad;
+    dl.beginPath();
+    dl.moveTo(line_x, line_top);
+    dl.lineTo(line_x, line_bot);
+    dl.lineWidth(6.0);
+    dl.lineCap(LineCap::ROUND);
+    dl.closePath();
+    dl.stroke(shift ? Colours::Gray60 : Colours::Green);
+  }
+
+  void OTTOFMSynthScreen::draw_no_shift(ui::vg::Canvas& ctx)
+  {
+    using namespace ui::vg;
+    ctx.font(Fonts::Norm, 35);
+
+    constexpr float x_pad = 30;
+    constexpr float y_pad = 50;
+    constexpr float space = (height - 2.f * y_pad) / 3.f;
+    // The "Ratio" and "FM" labels and the FM amount outline are in the static
+    // layer - only the values are drawn here
     ctx.beginPath();
     ctx.fillStyle(Colours::Blue);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
@@ -389,22 +560,10 @@ namespace otto::engines {
                  {width - x_pad, y_pad});
 
     // FM Amount
-    ctx.beginPath();
-    ctx.fillStyle(Colours::Red);
-    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
-    ctx.fillText("FM", {x_pad_left, y_pad + 3 * space});
-
-    ctx.lineWidth(6.f);
     constexpr float x_left = width - 6 * x_pad;
     constexpr float x_right = width - x_pad;
     constexpr float y_low = y_pad + 3 * space + 10;
     constexpr float y_high = y_pad + 3 * space - 10;
-    ctx.beginPath();
-    ctx.moveTo(x_left, y_low);
-    ctx.lineTo(x_right, y_high);
-    ctx.lineTo(x_right, y_low);
-    ctx.closePath();
-    ctx.stroke(Colours::Red);
 
     float x_middle = x_left * (1 - engine.props.fmAmount) + x_right * engine.props.fmAmount;
     float y_middle = y_low * (1 - engine.props.fmAmount) + y_high * engine.props.fmAmount;
@@ -416,20 +575,11 @@ namespace otto::engines {
     ctx.closePath();
     ctx.fill(Colours::Red);
 
-    // Operator level
-    // vertical line
+    // Operator level - the vertical line is in the static layer
     float line_top = y_pad + 0.7 * space;
     float line_bot = line_top + 1.5 * space;
     float line_x = 3.5 * x_pad;
     float bar_width = 20.f;
-    ctx.beginPath();
-    ctx.moveTo(line_x, line_top);
-    ctx.lineTo(line_x, line_bot);
-    ctx.lineWidth(6.0);
-    ctx.lineCap(LineCap::ROUND);
-    ctx.closePath();
-    // shift not held
-    ctx.stroke(Colours::Green);
     // Horizontal line
     ctx.beginPath();
     ctx.moveTo(
@@ -449,36 +599,22 @@ namespace otto::engines {
   {
     using namespace ui::vg;
     ctx.font(Fonts::Norm, 35);
-    constexpr float x_pad_left = 90;
     constexpr float x_pad = 30;
     constexpr float y_pad = 50;
     constexpr float space = (height - 2.f * y_pad) / 3.f;
-    // Ratio and Detune
-    ctx.beginPath();
-    ctx.fillStyle(Colours::Blue);
-    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
-    ctx.fillText("Detune", {x_pad_left, y_pad});
-
+    // The "Detune" and "Algorithm" labels are in the static layer - only the
+    // values are drawn here
     ctx.beginPath();
     ctx.fillStyle(Colours::Blue);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{:2}", engine.props.operators.at(cur_op).detune),
+    ctx.fillText(util::format_static("{:2}", engine.props.operators.at(cur_op).detune),
                  {width - x_pad, y_pad});
 
-    // Operator level
-    // vertical line
+    // Operator level - the vertical line is in the static layer
     float line_top = y_pad + 0.7 * space;
     float line_bot = line_top + 1.5 * space;
     float line_x = 3.5 * x_pad;
     float bar_width = 20.f;
-    ctx.beginPath();
-    ctx.moveTo(line_x, line_top);
-    ctx.lineTo(line_x, line_bot);
-    ctx.lineWidth(6.0);
-    ctx.lineCap(LineCap::ROUND);
-    ctx.closePath();
-    // shift is held
-    ctx.stroke(Colours::Gray60);
     // Horizontal line
     ctx.beginPath();
     ctx.moveTo(
@@ -494,15 +630,10 @@ namespace otto::engines {
     ctx.stroke(Colours::Gray60);
 
     // Algorithm
-    ctx.beginPath();
-    ctx.fillStyle(Colours::Red);
-    ctx.textAlign(HorizontalAlign::Left, VerticalAlign::Middle);
-    ctx.fillText("Algorithm", {x_pad_left, y_pad + 3 * space});
-
     ctx.beginPath();
     ctx.fillStyle(Colours::Red);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{}", engine.props.algN), {width - x_pad, y_pad + 3 * space});
+    ctx.fillText(util::format_static("{}", engine.props.algN), {width - x_pad, y_pad + 3 * space});
   }
 
   void OTTOFMSynthScreen::draw_envelope(Canvas& ctx)
@@ -634,51 +765,100 @@ namespace otto::engines {
     constexpr float y_pad = 50;
     constexpr float space = (height - 2.f * y_pad) / 3.f;
 
-    // Draw lines between operators
-    for (auto&& line : algorithms[engine.props.algN].operator_lines) {
-      int x_middle = x_pad + 12;
-      int mid_to_side = 15;
-      int horizontal_length = 13;
-
-      if (line.side == Drawside::left) {
-        int x_close = x_middle - mid_to_side;
-        int x_far = x_close - horizontal_length;
-
-        int y_start = y_pad + (3 - line.start) * space;
-        int y_end = y_pad + (3 - line.end) * space;
-
-        ctx.beginPath();
-        ctx.moveTo(x_close, y_start);
-        ctx.lineTo(x_far, y_start);
-        ctx.lineTo(x_far, y_end);
-        ctx.lineTo(x_close, y_end);
-        ctx.stroke(Colours::White);
-      } else if (line.side == Drawside::right) {
-        int x_close = x_middle + mid_to_side;
-        int x_far = x_close + horizontal_length;
-
-        int y_start = y_pad + (3 - line.start) * space;
-        int y_end = y_pad + (3 - line.end) * space;
-
-        ctx.beginPath();
-        ctx.moveTo(x_close, y_start);
-        ctx.lineTo(x_far, y_start);
-        ctx.lineTo(x_far, y_end);
-        ctx.lineTo(x_close, y_end);
-        ctx.stroke(Colours::White);
-      } else {
-        int y_start = y_pad + (3 - line.start) * space + 16;
-        int y_end = y_pad + (3 - line.end) * space - 16;
-
-        ctx.beginPath();
-        ctx.moveTo(x_middle, y_start);
-        ctx.lineTo(x_middle, y_end);
-        ctx.lineTo(x_middle, y_end);
-        ctx.lineTo(x_middle, y_end);
-        ctx.stroke(Colours::White);
+    // Record the wires and arrowheads for the current algorithm
+    if (alg_wires_for != engine.props.algN) {
+      alg_wires_for = engine.props.algN;
+      alg_wires_dl.clear();
+      alg_arrows_dl.clear();
+
+      for (auto&& line : algorithms[engine.props.algN].operator_lines) {
+        int x_middle = x_pad + 12;
+        int mid_to_side = 15;
+        int horizontal_length = 13;
+
+        if (line.side == Drawside::left) {
+          int x_close = x_middle - mid_to_side;
+          int x_far = x_close - horizontal_length;
+
+          int y_start = y_pad + (3 - line.start) * space;
+          int y_end = y_pad + (3 - line.end) * space;
+
+          alg_wires_dl.beginPath();
+          alg_wires_dl.moveTo(x_close, y_start);
+          alg_wires_dl.lineTo(x_far, y_start);
+          alg_wires_dl.lineTo(x_far, y_end);
+          alg_wires_dl.lineTo(x_close, y_end);
+          alg_wires_dl.stroke(Colours::White);
+        } else if (line.side == Drawside::right) {
+          int x_close = x_middle + mid_to_side;
+          int x_far = x_close + horizontal_length;
+
+          int y_start = y_pad + (3 - line.start) * space;
+          int y_end = y_pad + (3 - line.end) * space;
+
+          alg_wires_dl.beginPath();
+          alg_wires_dl.moveTo(x_close, y_start);
+          alg_wires_dl.lineTo(x_far, y_start);
+          alg_wires_dl.lineTo(x_far, y_end);
+          alg_wires_dl.lineTo(x_close, y_end);
+          alg_wires_dl.stroke(Colours::White);
+        } else {
+          int y_start = y_pad + (3 - line.start) * space + 16;
+          int y_end = y_pad + (3 - line.end) * space - 16;
+
+          alg_wires_dl.beginPath();
+          alg_wires_dl.moveTo(x_middle, y_start);
+          alg_wires_dl.lineTo(x_middle, y_end);
+          alg_wires_dl.stroke(Colours::White);
+        }
+      }
+
+      alg_arrows_dl.lineWidth(4.f);
+      for (auto&& line : algorithms[engine.props.algN].operator_lines) {
+        int x_middle = x_pad + 12;
+        int mid_to_side = 15;
+        int side_length = 5;
+
+        if (line.side == Drawside::left) {
+          int x = x_middle - mid_to_side;
+          int y = y_pad + (3 - line.end) * space;
+
+          alg_arrows_dl.beginPath();
+          alg_arrows_dl.moveTo(x, y);
+          alg_arrows_dl.lineTo(x - side_length, y - side_length);
+          alg_arrows_dl.lineTo(x - side_length, y + side_length);
+          alg_arrows_dl.closePath();
+          alg_arrows_dl.stroke(Colours::White);
+          alg_arrows_dl.fill(Colours::White);
+        } else if (line.side == Drawside::right) {
+          int x = x_middle + mid_to_side;
+          int y = y_pad + (3 - line.end) * space;
+
+          alg_arrows_dl.beginPath();
+          alg_arrows_dl.moveTo(x, y);
+          alg_arrows_dl.lineTo(x + side_length, y - side_length);
+          alg_arrows_dl.lineTo(x + side_length, y + side_length);
+          alg_arrows_dl.closePath();
+          alg_arrows_dl.stroke(Colours::White);
+          alg_arrows_dl.fill(Colours::White);
+        } else {
+          int x = x_middle;
+          int y = y_pad + (3 - line.end) * space - mid_to_side;
+
+          alg_arrows_dl.beginPath();
+          alg_arrows_dl.moveTo(x, y);
+          alg_arrows_dl.lineTo(x + side_length, y - side_length);
+          alg_arrows_dl.lineTo(x - side_length, y - side_length);
+          alg_arrows_dl.closePath();
+          alg_arrows_dl.stroke(Colours::White);
+          alg_arrows_dl.fill(Colours::White);
+        }
       }
     }
 
+    // Draw lines between operators
+    ctx.draw(alg_wires_dl);
+
     // draw operators
     for (int i = 0; i < 4; i++) {
       ctx.beginPath();
@@ -688,35 +868,18 @@ namespace otto::engines {
         ctx.circle({x_pad + 12, y_pad + (3 - i) * space}, 15);
       }
       ctx.closePath();
-      // Choose colour
-      if (i == 3) {
-        if (i == cur_op) {
-          ctx.fill(Colours::White);
-          ctx.stroke(Colours::Blue.mix(Colours::White, 0.5));
-        } else {
-          ctx.stroke(Colours::Blue);
-        }
-      } else if (i == 2) {
-        if (i == cur_op) {
-          ctx.fill(Colours::White);
-          ctx.stroke(Colours::Green.mix(Colours::White, 0.4));
-        } else {
-          ctx.stroke(Colours::Green);
-        }
-      } else if (i == 1) {
-        if (i == cur_op) {
-          ctx.fill(Colours::White);
-          ctx.stroke(Colours::Yellow.mix(Colours::White, 0.4));
-        } else {
-          ctx.stroke(Colours::Yellow);
-        }
-      } else if (i == 0) {
-        if (i == cur_op) {
-          ctx.fill(Colours::White);
-          ctx.stroke(Colours::Red.mix(Colours::White, 0.4));
-        } else {
-          ctx.stroke(Colours::Red);
-        }
+      // The accent colour per operator, and its selected variant mixed towards
+      // white - all derived at compile time
+      static constexpr std::array<Colour, 4> op_colours = {Colours::Red, Colours::Yellow,
+                                                           Colours::Green, Colours::Blue};
+      static constexpr std::array<Colour, 4> op_selected = {
+        Colours::Red.mix(Colours::White, 0.4), Colours::Yellow.mix(Colours::White, 0.4),
+        Colours::Green.mix(Colours::White, 0.4), Colours::Blue.mix(Colours::White, 0.5)};
+      if (i == cur_op) {
+        ctx.fill(Colours::White);
+        ctx.stroke(op_selected[i]);
+      } else {
+        ctx.stroke(op_colours[i]);
       }
 
       // Draw activity levels
@@ -730,70 +893,14 @@ namespace otto::engines {
         ctx.circle({x_pad + 12, y_pad + (3 - i) * space}, 15 * op_level);
       }
       // Choose colour
-      Colour cl;
-      switch (i) {
-      case 3: cl = Colours::Blue; break;
-      case 2: cl = Colours::Green; break;
-      case 1: cl = Colours::Yellow; break;
-      case 0: cl = Colours::Red; break;
-      default: break;
-      }
-      if (cur_op == i) cl = cl.mix(Colours::White, 0.5);
-      ctx.fill(cl);
+      static constexpr std::array<Colour, 4> op_active = {
+        Colours::Red.mix(Colours::White, 0.5), Colours::Yellow.mix(Colours::White, 0.5),
+        Colours::Green.mix(Colours::White, 0.5), Colours::Blue.mix(Colours::White, 0.5)};
+      ctx.fill(cur_op == i ? op_active[i] : op_colours[i]);
     }
 
     // draw arrowheads
-    for (auto&& line : algorithms[engine.props.algN].operator_lines) {
-      int x_middle = x_pad + 12;
-      int mid_to_side = 15;
-      int side_length = 5;
-
-
-
-      if (line.side == Drawside::left) {
-        int x = x_middle - mid_to_side;
-        int y = y_pad + (3 - line.end) * space;
-
-        ctx.group([&] {
-          ctx.lineWidth(4.f);
-          ctx.beginPath();
-          ctx.moveTo(x, y);
-          ctx.lineTo(x - side_length, y - side_length);
-          ctx.lineTo(x - side_length, y + side_length);
-          ctx.closePath();
-          ctx.stroke(Colours::White);
-          ctx.fill(Colours::White);
-        });
-      } else if (line.side == Drawside::right) {
-        int x = x_middle + mid_to_side;
-        int y = y_pad + (3 - line.end) * space;
-
-        ctx.group([&] {
-          ctx.lineWidth(4.f);
-          ctx.beginPath();
-          ctx.moveTo(x, y);
-          ctx.lineTo(x + side_length, y - side_length);
-          ctx.lineTo(x + side_length, y + side_length);
-          ctx.closePath();
-          ctx.stroke(Colours::White);
-          ctx.fill(Colours::White);
-        });
-      } else {
-        int x = x_middle;
-        int y = y_pad + (3 - line.end) * space - mid_to_side;
-
-        ctx.group([&] {
-          ctx.lineWidth(4.f);
-          ctx.beginPath();
-          ctx.moveTo(x, y);
-          ctx.lineTo(x + side_length, y - side_length);
-          ctx.lineTo(x - side_length, y - side_length);
-          ctx.closePath();
-          ctx.stroke(Colours::White);
-          ctx.fill(Colours::White);
-        });
-      }
-    }
+    ctx.group([&] { ctx.draw(alg_arrows_dl); });
   }
 
 } // namespace otto::engines
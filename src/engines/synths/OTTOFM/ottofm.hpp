@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/engine/engine.hpp"
+#include "core/props/snapshot.hpp"
 #include "core/voices/voice_manager.hpp"
 
 #include <Gamma/Envelope.h>
@@ -65,6 +66,10 @@ namespace otto::engines {
 
       float operator()(float);
 
+      /// Same as the call operator, with the modulator branch resolved at compile time
+      template<bool Modulator>
+      float tick(float) noexcept;
+
       void freq(float); /// Set frequency
 
       float level(); /// Get current level
@@ -84,11 +89,29 @@ namespace otto::engines {
   private:
     struct Voice;
 
+    /// The parameters the audio thread reads, published as one coherent set.
+    ///
+    /// Derived from the props on the logic thread, so e.g. the algorithm
+    /// number and the operator roles it implies can never be observed
+    /// half-applied mid-block.
+    struct AudioParams {
+      struct Op {
+        float outlevel = 1;
+        float detune_amount = 0;
+        float freq_ratio = 1;
+        float feedback = 0;
+      };
+      int algN = 0;
+      float fmAmount = 1;
+      std::array<Op, 4> ops;
+    };
+
     struct Pre : voices::PreBase<Pre, Props> {
       Pre(Props&) noexcept;
 
       void operator()() noexcept;
 
+      props::Snapshot<AudioParams> params;
       Voice* last_voice = nullptr;
     };
 
@@ -102,14 +125,25 @@ namespace otto::engines {
       void release_envelopes();
 
       void set_frequencies();
+      /// Copy the block's parameter snapshot into the operators
+      void apply_params() noexcept;
 
       Voice(Pre&) noexcept;
 
       float operator()() noexcept;
+      /// Render a whole block through a render loop specialized on the algorithm.
+      /// Selects the loop once, so the per-sample algorithm dispatch disappears.
+      void process_block(audio_span<float> out) noexcept;
       void on_note_on(float freq_target) noexcept;
       void on_note_off() noexcept;
 
     private:
+      /// One sample of algorithm `Alg`, with modulator/carrier roles fixed at compile time
+      template<int Alg>
+      float tick_alg() noexcept;
+      template<int Alg>
+      void render_block(audio_span<float> out) noexcept;
+
       friend struct OTTOFMSynthScreen;
     };
 
@@ -117,8 +151,9 @@ namespace otto::engines {
       Post(Pre&) noexcept;
 
       float operator()(float) noexcept;
+      void process_block(audio_span<float>) noexcept;
     };
 
-    voices::VoiceManager<Post, 6> voice_mgr_;
+    voices::VoiceManager<Post, 8> voice_mgr_;
   };
 } // namespace otto::engines
@@ -22,12 +22,15 @@ namespace otto::engines {
   // GossSynth ////////////////////////////////////////////////////////////////
 
   GossSynth::GossSynth()
-    : SynthEngine<GossSynth>(std::make_unique<GossSynthScreen>(this)), voice_mgr_(props)
-  {}
+    : SynthEngine<GossSynth>([this] { return std::make_unique<GossSynthScreen>(this); }), voice_mgr_(props)
+  {
+    // Prefer fewer voices over xruns when the rest of the chain is heavy
+    voice_mgr_.adaptive_voice_cap(true);
+  }
 
   float GossSynth::Voice::operator()() noexcept
   {
-    float fundamental = frequency() * (1 + 0.012 * props.leslie * pre.pitch_modulation_hi.cos()) * 0.5;
+    float fundamental = frequency() * (1 + 0.012 * props.leslie * pre.pitch_mod_value) * 0.5;
     pipes[0].freq(fundamental);
     pipes[1].freq(fundamental);
     pipes[2].freq(fundamental);
@@ -87,6 +90,10 @@ namespace otto::engines {
 
   void GossSynth::Pre::operator()() noexcept {
     props.rotation_value = rotation.nextPhase();
+    // Tick the shared modulation once per sample - voices and post read the results
+    pitch_mod_value = pitch_modulation_hi.cos();
+    leslie_filter_lo_value = leslie_filter_lo.cos();
+    leslie_filter_hi_value = leslie_filter_hi.cos();
   }
 
   /// Constructor. Takes care of linking appropriate variables to props
@@ -102,8 +109,8 @@ namespace otto::engines {
 
   float GossSynth::Post::operator()(float in) noexcept
   {
-    float s_lo = lpf(in) * (1 + pre.leslie_amount_lo * pre.leslie_filter_lo.cos());
-    float s_hi = hpf(in) * (1 + pre.leslie_amount_hi * pre.leslie_filter_hi.cos());
+    float s_lo = lpf(in) * (1 + pre.leslie_amount_lo * pre.leslie_filter_lo_value);
+    float s_hi = hpf(in) * (1 + pre.leslie_amount_hi * pre.leslie_filter_hi_value);
     return s_lo + s_hi;
   }
 
@@ -54,6 +54,13 @@ namespace otto::engines {
 
       gam::AccumPhase<> rotation;
 
+      /// Modulation values for the current sample, computed once in `operator()` and
+      /// read by all voices and the post processor. Ticking the LFOs from the voices
+      /// instead would advance them once per voice per sample.
+      float pitch_mod_value = 1.f;
+      float leslie_filter_lo_value = 0.f;
+      float leslie_filter_hi_value = 0.f;
+
       Pre(Props&) noexcept;
 
       void operator()() noexcept;
@@ -80,7 +87,7 @@ namespace otto::engines {
       float operator()(float) noexcept;
     };
 
-    voices::VoiceManager<Post, 6> voice_mgr_;
+    voices::VoiceManager<Post, 8> voice_mgr_;
   };
 
 } // namespace otto::engines
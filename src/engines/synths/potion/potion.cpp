@@ -1,9 +1,14 @@
 #include "potion.hpp"
 #include "services/application.hpp"
 #include "services/ui_manager.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 
 #include "core/ui/vector_graphics.hpp"
+#include "util/dir_index.hpp"
+#include "util/dsp/mix_kernels.hpp"
+#include "util/dsp/wavetable_kernels.hpp"
 
 namespace otto::engines {
 
@@ -38,14 +43,30 @@ namespace otto::engines {
   // PotionSynth ////////////////////////////////////////////////////////////////
 
   PotionSynth::PotionSynth()
-    : SynthEngine<PotionSynth>(std::make_unique<PotionSynthScreen>(this)), voice_mgr_(props)
+    : SynthEngine<PotionSynth>([this] { return std::make_unique<PotionSynthScreen>(this); }), voice_mgr_(props)
   {
+    // Prefer fewer voices over xruns when the rest of the chain is heavy
+    voice_mgr_.adaptive_voice_cap(true);
+
+    /// Map the packed mipmap set if it has been compiled - one open + mmap
+    /// for all tables, and the voices get band-limited levels per note. The
+    /// loose wavs stay as the source of truth and the fallback
+    if (props.wavetable_set.load(Application::current().data_dir / "wavetables.otwt")) {
+      DLOGI("Loaded wavetable set: {} tables, {} mip levels", props.wavetable_set.tables(),
+            props.wavetable_set.mip_count());
+    }
+
     /// Load filenames into vector
-    std::string path = Application::current().data_dir / "wavetables";
-    for (const auto& entry : filesystem::directory_iterator(path)) {
-      props.filenames.push_back(entry.path().filename());
+    for (auto&& file : util::scan_tree(Application::current().data_dir / "wavetables")) {
+      props.filenames.push_back(fs::path(file).filename());
     }
     util::sort(props.filenames);
+    if (props.filenames.empty() && props.wavetable_set) {
+      // Only the packed set shipped - list its tables instead
+      for (int i = 0; i < props.wavetable_set.tables(); i++) {
+        props.filenames.push_back(props.wavetable_set.name(i) + ".wav");
+      }
+    }
 
     /// Set up on_change handlers for the file names
     props.lfo_osc.wave1.file.on_change().connect([this](std::string fl) {
@@ -92,32 +113,61 @@ namespace otto::engines {
 
   void PotionSynth::load_wavetable(int wt_number, std::string filename)
   {
-    AudioFile<float> aux;
-    bool loaded = aux.load(Application::current().data_dir / "wavetables" / filename);
+    auto& set = props.wavetable_set;
+    const int table = set ? set.find(fs::path(filename).stem().string()) : -1;
     int num_samples = 1;
-    if (loaded) {
-      props.wavetables[wt_number].resize(aux.getNumSamplesPerChannel());
-      props.samplerates[wt_number] = aux.getSampleRate();
-      util::copy(aux.samples[0], props.wavetables[wt_number].elems());
-      num_samples = aux.getNumSamplesPerChannel();
+    if (table >= 0) {
+      /// Reference the mapped mip levels - no decode and no copy. The screen
+      /// and the initial binding below use the full-resolution level;
+      /// on_note_on swaps in the level matching the note
+      for (int m = 0; m < set.mip_count(); m++) {
+        props.wavetable_mips[wt_number][m].source(set.mip(table, m), set.mip_size(m));
+      }
+      // Sets with fewer levels than max_mips keep their coarsest level for
+      // the rest, so select_mip can clamp against max_mips alone
+      for (int m = set.mip_count(); m < util::WavetableSet::max_mips; m++) {
+        props.wavetable_mips[wt_number][m].source(set.mip(table, set.mip_count() - 1),
+                                                  set.mip_size(set.mip_count() - 1));
+      }
+      num_samples = int(set.mip_size(0));
+      props.wavetables[wt_number].source(set.mip(table, 0), set.mip_size(0));
+      props.samplerates[wt_number] = float(num_samples);
     } else {
-      props.wavetables[wt_number].resize(1);
-      props.samplerates[wt_number] = 1;
-      props.wavetables[wt_number][0] = 0;
+      AudioFile<float> aux;
+      bool loaded = aux.load(Application::current().data_dir / "wavetables" / filename);
+      if (loaded) {
+        props.wavetables[wt_number].resize(aux.getNumSamplesPerChannel());
+        props.samplerates[wt_number] = aux.getSampleRate();
+        util::copy(aux.samples[0], props.wavetables[wt_number].elems());
+        num_samples = aux.getNumSamplesPerChannel();
+      } else {
+        props.wavetables[wt_number].resize(1);
+        props.samplerates[wt_number] = 1;
+        props.wavetables[wt_number][0] = 0;
+      }
     }
+    auto* mips = table >= 0 ? &props.wavetable_mips[wt_number] : nullptr;
     for (auto&& v : voice_mgr_.voices()) {
       switch (wt_number) {
       case 0:
         v.lfo_osc.waves[0].buffer(props.wavetables[0], num_samples, 1);
+        v.lfo_osc.mips[0] = mips;
+        v.lfo_osc.cur_mip = -1;
         break;
       case 1:
         v.lfo_osc.waves[1].buffer(props.wavetables[1], num_samples, 1);
+        v.lfo_osc.mips[1] = mips;
+        v.lfo_osc.cur_mip = -1;
         break;
       case 2:
         v.curve_osc.waves[0].buffer(props.wavetables[2], num_samples, 1);
+        v.curve_osc.mips[0] = mips;
+        v.curve_osc.cur_mip = -1;
         break;
       case 3:
         v.curve_osc.waves[1].buffer(props.wavetables[3], num_samples, 1);
+        v.curve_osc.mips[1] = mips;
+        v.curve_osc.cur_mip = -1;
         break;
       default: break;
       }
@@ -140,6 +190,16 @@ namespace otto::engines {
     return in;
   }
 
+  void PotionSynth::Post::process_block(audio_span<float>) noexcept
+  {
+    // Pass-through on the audio - the pan mirrors for the screen only need
+    // updating once per block
+    if (pre.last_voice) {
+      props.lfo_osc.pan_position = pre.last_voice->lfo_pan;
+      props.curve_osc.pan_position = pre.last_voice->curve.value() + 1;
+    }
+  }
+
   audio::ProcessData<1> PotionSynth::process(audio::ProcessData<1> data)
   {
     return voice_mgr_.process(data);
@@ -164,6 +224,8 @@ namespace otto::engines {
   {
     lfo.phase(0.f);
     curve.resetSoft();
+    lfo_osc.select_mip(freq_target);
+    curve_osc.select_mip(freq_target);
     pre.last_voice = this;
   }
 
@@ -182,11 +244,80 @@ namespace otto::engines {
     return result * 2.0f;
   }
 
+  void PotionSynth::Voice::process_block(audio_span<float> out) noexcept
+  {
+    constexpr int max_block = voices::VoiceManager<Post, 8>::max_block_size;
+    int nframes = out.size();
+
+    for (int osc = 0; osc < 2; osc++) {
+      lfo_osc.waves[osc].freq(frequency());
+      curve_osc.waves[osc].freq(frequency());
+    }
+    /// The crossfade weights still evolve per sample - generate them for the whole
+    /// block, then hand both wave pairs to the vectorized kernel
+    float lfo_w1[max_block], lfo_w2[max_block], curve_w1[max_block], curve_w2[max_block];
+    for (int i = 0; i < nframes; i++) {
+      lfo_pan = lfo_smoother(lfo.tri());
+      lfo_osc.pan.pos(lfo_pan);
+      curve_osc.pan.pos(curve() + 1);
+      lfo_w1[i] = lfo_osc.pan.weight1();
+      lfo_w2[i] = lfo_osc.pan.weight2();
+      curve_w1[i] = curve_osc.pan.weight1();
+      curve_w2[i] = curve_osc.pan.weight2();
+    }
+    float curve_buf[max_block];
+    lfo_osc.process_block(out, lfo_w1, lfo_w2);
+    curve_osc.process_block({curve_buf, nframes}, curve_w1, curve_w2);
+    util::dsp::accumulate(out.data(), curve_buf, nframes);
+    util::dsp::scale(out.data(), 2.f, nframes);
+  }
+
   float PotionSynth::DualWavePlayer::operator()() noexcept
   {
     return pan(waves[0](), waves[1]());
   }
 
+  void PotionSynth::DualWavePlayer::select_mip(float freq) noexcept
+  {
+    if (!mips[0] || !mips[1]) return;
+    // One level per octave, level 0 covering up to 20 Hz - the base table's
+    // highest harmonic stays below Nyquist from there up
+    const int level = std::clamp(int(std::log2(std::max(freq, 20.f) / 20.f)), 0,
+                                 util::WavetableSet::max_mips - 1);
+    if (level == cur_mip) return;
+    cur_mip = level;
+    for (int i = 0; i < 2; i++) {
+      auto& table = (*mips[i])[level];
+      waves[i].buffer(table, double(table.size()), 1);
+    }
+  }
+
+  void PotionSynth::DualWavePlayer::process_block(audio_span<float> out, const float* w1, const float* w2) noexcept
+  {
+    constexpr int chunk = 64;
+    int idx1[chunk], idx2[chunk];
+    float fr1[chunk], fr2[chunk];
+    int nframes = out.size();
+
+    for (int start = 0; start < nframes; start += chunk) {
+      int n = std::min(nframes - start, chunk);
+      // Step the play positions (scalar - the phase wrap is data dependent)
+      for (int i = 0; i < n; i++) {
+        double p = waves[0].pos();
+        idx1[i] = int(p);
+        fr1[i] = float(p - idx1[i]);
+        waves[0].advance();
+        p = waves[1].pos();
+        idx2[i] = int(p);
+        fr2[i] = float(p - idx2[i]);
+        waves[1].advance();
+      }
+      util::dsp::dual_table_crossfade(out.data() + start, //
+                                      waves[0].elems(), waves[0].size(), idx1, fr1, w1 + start,
+                                      waves[1].elems(), waves[1].size(), idx2, fr2, w2 + start, n);
+    }
+  }
+
   /*
    * PotionSynthScreen
    */
@@ -443,16 +574,13 @@ namespace otto::engines {
     float y_jump = 30;
     y_scale = 10;
 
+    // The brightened accent per oscillator, derived at compile time
+    static constexpr std::array<Colour, 4> wave_colours = {
+      Colours::Blue.mix(Colours::White, 0.2), Colours::Green.mix(Colours::White, 0.2),
+      Colours::Yellow.mix(Colours::White, 0.2), Colours::Red.mix(Colours::White, 0.2)};
     for (int i=1; i<4; i++) {
-      // Choose colour
       Colour cl;
-      switch (view_order[i]) {
-        case 0: cl = Colours::Blue.mix(Colours::White, 0.2); break;
-        case 1: cl = Colours::Green.mix(Colours::White, 0.2); break;
-        case 2: cl = Colours::Yellow.mix(Colours::White, 0.2); break;
-        case 3: cl = Colours::Red.mix(Colours::White, 0.2); break;
-        default: break;
-      }
+      if (view_order[i] >= 0 && view_order[i] < 4) cl = wave_colours[view_order[i]];
       draw_waveform(ctx, {x_start, y_middle}, {x_scale, y_scale}, cl, steps_small, view_order[i]);
       y_middle += y_jump;
     }
@@ -17,6 +17,7 @@
 #include <Gamma/SamplePlayer.h>
 
 #include "util/filesystem.hpp"
+#include "util/wavetable_set.hpp"
 
 namespace otto::engines {
 
@@ -58,6 +59,11 @@ namespace otto::engines {
 
       std::array<gam::Array<float>, 4> wavetables;
       std::array<float, 4> samplerates;
+      /// The packed mipmap set compiled offline by scripts/compile-wavetables.py.
+      /// When present, `wavetable_mips[slot]` references its per-octave levels
+      /// and the voices pick one per note
+      util::WavetableSet wavetable_set;
+      std::array<std::array<gam::Array<float>, util::WavetableSet::max_mips>, 4> wavetable_mips;
       std::vector<std::string> filenames;
       std::array<std::vector<std::string>::iterator, 4> file_it = {
         {filenames.begin(), filenames.begin(), filenames.begin(), filenames.begin()}};
@@ -81,6 +87,20 @@ namespace otto::engines {
 
       /// Call operator takes play position and pan value
       float operator()() noexcept;
+
+      /// Render a whole block through the SIMD read+lerp+crossfade kernel.
+      ///
+      /// `w1`/`w2` are per-sample crossfade weights, one entry per output sample.
+      void process_block(audio_span<float> out, const float* w1, const float* w2) noexcept;
+
+      /// Rebind both players to the mip level matching `freq`, one octave of
+      /// headroom per level. No-op when the levels are equal or `mips` is null
+      /// (loose wav fallback, where load_wavetable's single-table binding stays)
+      void select_mip(float freq) noexcept;
+
+      std::array<std::array<gam::Array<float>, util::WavetableSet::max_mips>*, 2> mips = {nullptr,
+                                                                                          nullptr};
+      int cur_mip = -1;
     };
 
     DECL_REFLECTION(PotionSynth, props, ("voice_manager", &PotionSynth::voice_mgr_));
@@ -110,6 +130,9 @@ namespace otto::engines {
 
       Voice(Pre&) noexcept;
       float operator()() noexcept;
+      /// Block version - generates the pan weights per sample, then renders both wave
+      /// pairs through the vectorized wavetable kernel
+      void process_block(audio_span<float> out) noexcept;
       void on_note_on(float freq_target) noexcept;
     };
 
@@ -117,9 +140,10 @@ namespace otto::engines {
       Post(Pre&) noexcept;
 
       float operator()(float) noexcept;
+      void process_block(audio_span<float>) noexcept;
     };
 
-    voices::VoiceManager<Post, 6> voice_mgr_;
+    voices::VoiceManager<Post, 8> voice_mgr_;
     friend struct PotionSynthScreen;
   };
 } // namespace otto::engines
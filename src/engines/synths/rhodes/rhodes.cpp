@@ -1,6 +1,8 @@
 #include "rhodes.hpp"
 
 #include "core/ui/vector_graphics.hpp"
+#include "core/ui/widgets/value_label.hpp"
+#include "util/math.hpp"
 
 namespace otto::engines {
 
@@ -16,13 +18,26 @@ namespace otto::engines {
     bool keypress(Key key) override;
     void encoder(EncoderEvent e) override;
 
-    using EngineScreen<RhodesSynth>::EngineScreen;
+    RhodesSynthScreen(RhodesSynth* engine)
+      : EngineScreen<RhodesSynth>(engine),
+        aggro_label_(this->engine.props.aggro, "{:1}"),
+        asymmetry_label_(this->engine.props.asymmetry, "{:1.2}"),
+        speed_label_(this->engine.props.lfo_speed, "{:1.2}"),
+        depth_label_(this->engine.props.lfo_depth, "{:1.2}")
+    {}
+
+  private:
+    /// Value text is formatted on prop change, not per frame
+    ValueLabel aggro_label_;
+    ValueLabel asymmetry_label_;
+    ValueLabel speed_label_;
+    ValueLabel depth_label_;
   };
 
   // RhodesSynth ////////////////////////////////////////////////////////////////
 
   RhodesSynth::RhodesSynth()
-    : SynthEngine<RhodesSynth>(std::make_unique<RhodesSynthScreen>(this)), voice_mgr_(props)
+    : SynthEngine<RhodesSynth>([this] { return std::make_unique<RhodesSynthScreen>(this); }), voice_mgr_(props)
   {}
 
   //Voice
@@ -30,11 +45,30 @@ namespace otto::engines {
   {
     reson.freq(frequency());
     overtones.freq(frequency());
-    float excitation = lpf(exciter() * (1 + noise()));
+    float excitation = lpf(exciter() * (1 + pre.noise_table[noise_pos++ & Pre::noise_mask]));
     float harmonics = env() * overtones();
     float orig_note = reson.nextBP(excitation*hammer_strength);
     float aux = util::math::fasttanh3(0.3f*orig_note + props.asymmetry);
-    return amp * pickup_hpf(powf(2, 10*aux)) + 400 * orig_note + harmonics;
+    return amp * pickup_hpf(util::math::fastexp2(10*aux)) + 400 * orig_note + harmonics;
+  }
+
+  void RhodesSynth::Voice::process_block(audio_span<float> out) noexcept
+  {
+    // The frequency is fixed within a block, so the resonator and overtone
+    // coefficient updates happen once here instead of per sample
+    reson.freq(frequency());
+    overtones.freq(frequency());
+    for (auto& frm : out) {
+      float excitation = lpf(exciter() * (1 + pre.noise_table[noise_pos++ & Pre::noise_mask]));
+      float harmonics = env() * overtones();
+      float orig_note = reson.nextBP(excitation*hammer_strength);
+      float aux = util::math::fasttanh3(0.3f*orig_note + props.asymmetry);
+      frm = amp * pickup_hpf(util::math::fastexp2(10*aux)) + 400 * orig_note + harmonics;
+    }
+    // Released voices decay the filter states into denormal range - flush
+    // once per block so they cannot idle there on builds without FTZ
+    reson.flushDenormals();
+    pickup_hpf.flushDenormals();
   }
 
   RhodesSynth::Voice::Voice(Pre& pre) noexcept : VoiceBase(pre) {
@@ -47,8 +81,6 @@ namespace otto::engines {
     exciter.curve(0);
     exciter.finish();
 
-    noise.seed(123);
-
     lpf.type(gam::LOW_PASS);
     lpf.freq(powf(20,2));
 
@@ -56,9 +88,8 @@ namespace otto::engines {
     pickup_hpf.freq(440.f);
     pickup_hpf.smoothTime(0.004);
 
-    overtones.resize(1024);
-    overtones.addSine(7, 15, 0);
-    overtones.addSine(20, 0.8, 0);
+    // All voices read the one table in Pre - only phase and rate live here
+    overtones.source(pre.overtone_table);
 
     // Parameters for the tine harmonics
     env.decay(2.2);
@@ -74,9 +105,9 @@ namespace otto::engines {
     exciter.decay(1.f/freq_target);
     exciter.resetSoft();
 
-    hammer_strength = powf(2.f, (1.f + 3.0f * props.aggro * velocity()));
+    hammer_strength = util::math::fastexp2(1.f + 3.0f * props.aggro * velocity());
 
-    noise.seed(123);
+    noise_pos = 0;
 
     lpf.freq(powf(velocity()*90*props.aggro + 20,2));
 
@@ -90,7 +121,13 @@ namespace otto::engines {
   //Preprocessor
   RhodesSynth::Pre::Pre(Props& props) noexcept : PreBase(props)
   {
+    overtone_table.resize(1024);
+    overtone_table.addSine(7, 15, 0);
+    overtone_table.addSine(20, 0.8, 0);
 
+    gam::NoiseWhite<> noise;
+    noise.seed(123);
+    for (auto& s : noise_table) s = noise();
   }
 
   void RhodesSynth::Pre::operator()() noexcept {}
@@ -160,7 +197,7 @@ namespace otto::engines {
     ctx.beginPath();
     ctx.fillStyle(Colours::Blue);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{:1}", engine.props.aggro), {width - x_pad, y_pad});
+    aggro_label_.draw(ctx, {width - x_pad, y_pad});
 
     ctx.beginPath();
     ctx.fillStyle(Colours::Green);
@@ -170,7 +207,7 @@ namespace otto::engines {
     ctx.beginPath();
     ctx.fillStyle(Colours::Green);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{:1.2}", engine.props.asymmetry), {width - x_pad, y_pad + space});
+    asymmetry_label_.draw(ctx, {width - x_pad, y_pad + space});
 
     ctx.beginPath();
     ctx.fillStyle(Colours::Yellow);
@@ -180,7 +217,7 @@ namespace otto::engines {
     ctx.beginPath();
     ctx.fillStyle(Colours::Yellow);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{:1.2}", engine.props.lfo_speed), {width - x_pad, y_pad + 2 * space});
+    speed_label_.draw(ctx, {width - x_pad, y_pad + 2 * space});
 
     ctx.beginPath();
     ctx.fillStyle(Colours::Red);
@@ -190,7 +227,7 @@ namespace otto::engines {
     ctx.beginPath();
     ctx.fillStyle(Colours::Red);
     ctx.textAlign(HorizontalAlign::Right, VerticalAlign::Middle);
-    ctx.fillText(fmt::format("{:1.2}", engine.props.lfo_depth), {width - x_pad, y_pad + 3 * space});
+    depth_label_.draw(ctx, {width - x_pad, y_pad + 3 * space});
 
     ///
   }
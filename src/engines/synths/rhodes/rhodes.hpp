@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "core/engine/engine.hpp"
 #include "core/voices/voice_manager.hpp"
 
@@ -43,6 +45,17 @@ namespace otto::engines {
 
   private:
     struct Pre : voices::PreBase<Pre, Props> {
+      /// Overtone table shared by every voice - the content is identical
+      /// across voices, only phase and rate are per voice
+      gam::Osc<> overtone_table;
+
+      /// Exciter noise, precomputed once. Every note replays it from the
+      /// start, which matches the old per-note reseed to a fixed seed. Long
+      /// enough to outlast the exciter envelope at the lowest notes
+      static constexpr int noise_frames = 8192;
+      static constexpr int noise_mask = noise_frames - 1;
+      std::array<float, noise_frames> noise_table;
+
       Pre(Props&) noexcept;
 
       void operator()() noexcept;
@@ -51,22 +64,24 @@ namespace otto::engines {
     struct Voice : voices::VoiceBase<Voice, Pre> {
       BiquadSoftReset<> reson;
       gam::AD<> exciter;
-      gam::NoiseWhite<> noise;
 
       gam::Biquad<> lpf;
       BiquadSoftReset<> pickup_hpf;
 
+      /// References the table in Pre
       gam::Osc<> overtones;
       gam::AD<> env{0.01, 0.2};
 
       float hammer_strength = 2;
       float amp = 1;
-
-
+      int noise_pos = 0;
 
       Voice(Pre&) noexcept;
 
       float operator()() noexcept;
+      /// Block version - hoists the resonator and overtone coefficient
+      /// updates out of the sample loop
+      void process_block(audio_span<float> out) noexcept;
       void on_note_on(float freq_target) noexcept;
     };
 
@@ -1,15 +1,191 @@
 #include "audio_manager.hpp"
 
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
 #include <Gamma/Domain.h>
 
+#include "services/task_pool.hpp"
+#include "util/dsp/denormals.hpp"
+
 namespace otto::services {
 
+  namespace {
+    /// Resident set size in kilobytes, from /proc/self/statm. -1 on failure
+    long read_rss_kb() noexcept
+    {
+      std::FILE* f = std::fopen("/proc/self/statm", "r");
+      if (f == nullptr) return -1;
+      long pages_total = 0;
+      long pages_resident = 0;
+      int n = std::fscanf(f, "%ld %ld", &pages_total, &pages_resident);
+      std::fclose(f);
+      if (n != 2) return -1;
+      static const long page_kb = ::sysconf(_SC_PAGESIZE) / 1024;
+      return pages_resident * page_kb;
+    }
+
+    /// Only log resident-set growth in steps of this, to keep the log quiet
+    constexpr long rss_report_step_kb = 256;
+
+    /// Buffer sizes the auto-tuner walks through, smallest first
+    constexpr std::array<int, 3> tune_steps = {64, 128, 256};
+    /// Escalate when the last {@ref tune_window_s} seconds saw more xruns than this
+    constexpr int tune_xrun_threshold = 3;
+    constexpr int tune_window_s = 10;
+    /// De-escalate after this long without a single xrun
+    constexpr int tune_stable_s = 120;
+
+    /// A single integer from a sysfs file, or `fallback` on failure
+    long read_sysfs_long(const char* path, long fallback) noexcept
+    {
+      std::FILE* f = std::fopen(path, "r");
+      if (f == nullptr) return fallback;
+      long val = fallback;
+      if (std::fscanf(f, "%ld", &val) != 1) val = fallback;
+      std::fclose(f);
+      return val;
+    }
+
+    /// Touch a page-stepped range below the current frame, covering the depth
+    /// the process callbacks can reach. Only useful when mlockall was denied -
+    /// with it, stacks are faulted in and pinned wholesale
+    void prefault_stack() noexcept
+    {
+      constexpr std::size_t stack_prefault_bytes = 256 * 1024;
+      volatile char probe[stack_prefault_bytes];
+      for (std::size_t i = 0; i < stack_prefault_bytes; i += 4096) probe[i] = 0;
+    }
+  } // namespace
+
   AudioManager::AudioManager()
+    : _watch_thread([this](auto&&) {
+        long last = read_rss_kb();
+        const auto max_khz =
+          std::uint32_t(read_sysfs_long("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", 0));
+        thermal_stats::max_khz.store(max_khz, std::memory_order_relaxed);
+        int tick = 0;
+        // Auto-tuner state - per-second xrun counts in a sliding window, and
+        // how long since the last one
+        std::uint64_t last_xrun_total = 0;
+        std::array<int, tune_window_s> xrun_window = {};
+        int stable_s = 0;
+        bool tune_started = false;
+        while (_watch_thread.running()) {
+          _watch_thread.sleep_for(chrono::seconds(1));
+
+          // Thermal and clock, every tick - throttling needs catching before
+          // the xruns it causes
+          const long temp_mc = read_sysfs_long("/sys/class/thermal/thermal_zone0/temp", -1);
+          thermal_stats::temp_mc.store(temp_mc, std::memory_order_relaxed);
+          if (temp_mc > thermal_stats::peak_mc.load(std::memory_order_relaxed)) {
+            thermal_stats::peak_mc.store(temp_mc, std::memory_order_relaxed);
+          }
+          const auto khz =
+            std::uint32_t(read_sysfs_long("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", 0));
+          thermal_stats::cur_khz.store(khz, std::memory_order_relaxed);
+          // With the performance governor the clock only drops when the
+          // firmware caps it
+          const bool throttled = max_khz != 0 && khz != 0 && khz < max_khz;
+          if (throttled != thermal_stats::throttled.load(std::memory_order_relaxed)) {
+            thermal_stats::throttled.store(throttled, std::memory_order_relaxed);
+            if (throttled) {
+              LOGW("Cpu throttled to {} MHz at {} deg C - audio headroom reduced", khz / 1000,
+                   thermal_stats::temp_mc.load(std::memory_order_relaxed) / 1000);
+            } else {
+              LOGI("Cpu clock recovered to {} MHz", khz / 1000);
+            }
+            thermal_stats::on_throttle.emit(throttled);
+          }
+
+          // Buffer size auto-tune, every tick. Starts at the smallest step and
+          // lets the xruns push it up - repeated xruns in the window escalate,
+          // minutes of silence de-escalate. Waits for start(), since this
+          // thread outlives the driver subclass on both ends
+          if (_auto_tune.load(std::memory_order_relaxed) && _running) {
+            const auto total = xrun_stats::total();
+            const int fresh = int(total - last_xrun_total);
+            last_xrun_total = total;
+            xrun_window[tick % tune_window_s] = fresh;
+            stable_s = fresh > 0 ? 0 : stable_s + 1;
+            int recent = 0;
+            for (int c : xrun_window) recent += c;
+            const int bs = buffer_size();
+            if (!tune_started) {
+              tune_started = bs <= tune_steps.front() || set_buffer_size(tune_steps.front());
+              if (tune_started) {
+                LOGI("Auto-tune: starting at {} frames", buffer_size());
+                xrun_window = {};
+                stable_s = 0;
+              }
+            } else if (recent > tune_xrun_threshold && bs < tune_steps.back()) {
+              if (set_buffer_size(bs * 2)) {
+                LOGW("Auto-tune: {} xruns in {}s, buffer size {} -> {}", recent, tune_window_s, bs,
+                     bs * 2);
+                xrun_window = {};
+                stable_s = 0;
+              }
+            } else if (stable_s >= tune_stable_s && bs > tune_steps.front()) {
+              if (set_buffer_size(bs / 2)) {
+                LOGI("Auto-tune: no xruns for {}s, buffer size {} -> {}", stable_s, bs, bs / 2);
+                xrun_window = {};
+                stable_s = 0;
+              }
+            }
+          }
+
+          // Resident set, every few ticks
+          if (++tick % 5 != 0) continue;
+          long rss = read_rss_kb();
+          if (rss < 0) continue;
+          rt_memory_stats::rss_kb.store(rss, std::memory_order_relaxed);
+          // Growth after lock_memory() means something is still faulting in
+          // new pages - a fresh fault source worth hunting down
+          if (rss > last + rss_report_step_kb) {
+            DLOGI("Resident set grew {} KB to {} KB", rss - last, rss);
+            last = rss;
+          }
+        }
+      })
   {
+    _auto_tune = std::getenv("OTTO_AUTO_BUFFER_SIZE") != nullptr;
     events.pre_init.emit();
     core::midi::generateFreqTable(440);
   }
 
+  void AudioManager::lock_memory() noexcept
+  {
+    // Pin everything mapped so far and everything mapped from now on. MCL_FUTURE
+    // makes new mappings - loader thread stacks, pool slabs, heap growth - lock
+    // and fault in at creation instead of in the audio callback
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+      rt_memory_stats::memory_locked.store(true, std::memory_order_relaxed);
+    } else {
+      LOGE("Could not lock memory: {}. Raise the memlock rlimit. Prefaulting by hand instead",
+           std::strerror(errno));
+    }
+    // Belt and braces when locking was denied - touch what the callback will
+    // touch anyway, so at least the known fault sources are warm
+    _buffer_pool.prefault();
+    prefault_stack();
+    rt_memory_stats::baseline_rss_kb.store(read_rss_kb(), std::memory_order_relaxed);
+    DLOGI("RT memory setup done. locked: {}, rss: {} KB", rt_memory_stats::memory_locked.load(),
+          rt_memory_stats::baseline_rss_kb.load());
+  }
+
   core::audio::AudioBufferPool& AudioManager::buffer_pool() noexcept
   {
     return _buffer_pool;
@@ -17,6 +193,10 @@ namespace otto::services {
 
   void AudioManager::start() noexcept
   {
+    // FTZ/DAZ is per-thread; this covers callers that process on the thread
+    // that started us (dummy board, tests). The real drivers set it again on
+    // their own callback threads - see e.g. the rtaudio driver
+    util::dsp::flush_denormals_to_zero();
     _running = true;
   }
 
@@ -27,14 +207,89 @@ namespace otto::services {
 
   void AudioManager::wait_one() const noexcept
   {
-    auto last = buffer_number();
+    const unsigned last = _buffer_number.load(std::memory_order_acquire);
     if (last == 0) return;
-    while (last >= (buffer_number() - 1));
+    // Two increments past `last` guarantees a complete process call happened
+    // in between, whichever end of the callback the driver publishes from
+    const unsigned target = last + 2;
+    for (;;) {
+      const unsigned cur = _buffer_number.load(std::memory_order_acquire);
+      if (int(cur - target) >= 0) return;
+      if (!_running.load(std::memory_order_relaxed)) return;
+#ifdef __linux__
+      // Park until the audio thread publishes the next block. The timeout only
+      // exists so a dying stream can't strand a waiter - the normal exit is
+      // the wake in publish_block
+      _block_waiters.fetch_add(1, std::memory_order_relaxed);
+      struct ::timespec timeout = {0, 100'000'000};
+      ::syscall(SYS_futex, reinterpret_cast<const std::atomic_uint*>(&_buffer_number),
+                FUTEX_WAIT_PRIVATE, cur, &timeout, nullptr, 0);
+      _block_waiters.fetch_sub(1, std::memory_order_relaxed);
+#else
+      std::this_thread::yield();
+#endif
+    }
+  }
+
+  void AudioManager::publish_block() noexcept
+  {
+    _buffer_number.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    if (_block_waiters.load(std::memory_order_relaxed) > 0) {
+      ::syscall(SYS_futex, reinterpret_cast<const std::atomic_uint*>(&_buffer_number),
+                FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#endif
+  }
+
+  void AudioManager::attach_samplerate_client(std::function<void(int)> regenerate)
+  {
+    regenerate(samplerate());
+    std::lock_guard lock(_samplerate_clients_mutex);
+    _samplerate_clients.push_back(std::move(regenerate));
+  }
+
+  void AudioManager::samplerate_changed(int rate) noexcept
+  {
+    _samplerate = rate;
+    gam::sampleRate(rate);
+    LOGI("Samplerate is {}", rate);
+    TaskPool::current().push([this, rate] {
+      // One job for all clients - each is a quick table fill, and running
+      // them in sequence keeps the registration lock short-lived. Clients
+      // publish their standby copies themselves, so nothing here touches
+      // state the audio thread reads mid-block
+      std::lock_guard lock(_samplerate_clients_mutex);
+      for (auto& regenerate : _samplerate_clients) regenerate(rate);
+    });
   }
 
   void AudioManager::send_midi_event(core::midi::AnyMidiEvent evt) noexcept
   {
-    midi_bufs.outer().emplace_back(std::move(evt));
+    if (!midi_queue.try_push({std::move(evt), std::chrono::steady_clock::now()})) {
+      DLOGE("Midi queue full, dropping event");
+    }
+  }
+
+  void AudioManager::drain_midi_queue() noexcept
+  {
+    // Map each arrival time onto a frame offset in this block, as if the
+    // block period started at the previous drain. An event is thus played one
+    // block after it arrived, at the frame matching where in the period it
+    // landed - steady timing at the cost of one block of fixed latency
+    const auto now = std::chrono::steady_clock::now();
+    const auto origin = last_drain_time_;
+    last_drain_time_ = now;
+    const int nframes = int(_buffer_size.load(std::memory_order_relaxed));
+    const double rate = _samplerate.load(std::memory_order_relaxed);
+
+    TimestampedMidi evt;
+    while (midi_queue.try_pop(evt)) {
+      const double secs = std::chrono::duration<double>(evt.arrival - origin).count();
+      const int frame = std::clamp(int(secs * rate), 0, nframes - 1);
+      mpark::visit([&](auto& e) { e.time = frame; }, evt.event);
+      midi_bufs.inner().emplace_back(std::move(evt.event));
+    }
   }
 
   float AudioManager::cpu_time() noexcept
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "core/audio/processor.hpp"
 #include "core/service.hpp"
 #include "services/debug_ui.hpp"
 #include "util/signals.hpp"
 #include "util/locked.hpp"
+#include "util/lockfree_queue.hpp"
+#include "util/thread.hpp"
 
 #include "services/application.hpp"
 
@@ -28,14 +34,59 @@ namespace otto::services {
     /// Send a midi event into the system.
     ///
     /// The `core::midi` namespace has some nice utils for constructing events.
+    ///
+    /// Lock free and allocation free - safe to call from any thread, including midi
+    /// driver callbacks. If the queue is full the event is dropped.
+    ///
+    /// The event is stamped with its monotonic arrival time, and delivered one
+    /// block later at the matching intra-block frame offset - see
+    /// {@ref drain_midi_queue}
     void send_midi_event(core::midi::AnyMidiEvent) noexcept;
 
+    /// Direct hardware monitoring gain for the line input.
+    ///
+    /// When above zero, the driver mixes the raw input straight into the
+    /// device output buffer at the end of its callback - the performer hears
+    /// themselves with near-zero latency, while the chain still receives the
+    /// input for fx and looper capture. Any thread
+    float direct_monitor() const noexcept { return _direct_monitor.load(std::memory_order_relaxed); }
+    void direct_monitor(float gain) noexcept { _direct_monitor.store(gain, std::memory_order_relaxed); }
+
     /// Get the samplerate
     int samplerate() const noexcept { return _samplerate; }
 
     /// Get the buffer size
     int buffer_size() const noexcept { return _buffer_size; }
 
+    /// Register a function that rebuilds samplerate-dependent state - filter
+    /// coefficient tables, wavetable increments, envelope rates.
+    ///
+    /// The function is called immediately with the current rate, and again on
+    /// the task pool whenever a driver renegotiates the rate through
+    /// {@ref samplerate_changed}. It always runs off the audio thread, so
+    /// rebuild into a standby copy and publish it with an atomic flip the
+    /// audio thread picks up at its next block - see Sampler::publish_slot
+    /// for the pattern.
+    void attach_samplerate_client(std::function<void(int)> regenerate);
+
+    /// Renegotiate the buffer size with the driver at runtime.
+    ///
+    /// Call from a non-audio thread only. Drivers that cannot renegotiate
+    /// leave the default, which refuses.
+    ///
+    /// \returns `true` when the driver accepted the new size
+    virtual bool set_buffer_size(int frames) noexcept { return false; }
+
+    /// Enable or disable buffer size auto-tuning.
+    ///
+    /// When enabled the watch thread drops to the smallest buffer size and
+    /// walks it up and down between 64 and 256 frames based on the xrun rate -
+    /// escalating when a sliding window shows repeated xruns, de-escalating
+    /// again after minutes of stability. Needs a driver that implements
+    /// {@ref set_buffer_size}. Also enabled by setting `OTTO_AUTO_BUFFER_SIZE`
+    /// in the environment
+    void auto_tune_buffer_size(bool enable) noexcept { _auto_tune = enable; }
+
     /// Get the current buffer number
     /// 
     /// i.e. number of {@ref buffer_size()} chunks of samples since the start
@@ -44,8 +95,24 @@ namespace otto::services {
     unsigned buffer_number() const noexcept { return _buffer_number; }
 
     /// Wait at least until the current process call is done
+    ///
+    /// Parks on a futex that the audio thread wakes once per callback (through
+    /// {@ref publish_block}), so waiters wake within microseconds of the block
+    /// boundary without burning a core. Returns immediately when audio never
+    /// started, and bails out when it stops while waiting
     void wait_one() const noexcept;
 
+    /// Lock and prefault memory for real-time processing.
+    ///
+    /// `mlockall` with `MCL_FUTURE` pins everything mapped so far - engine DSP
+    /// state, thread stacks - and everything mapped from now on, so the audio
+    /// thread never takes a first-touch page fault after an engine switch.
+    /// When locking is denied (memlock rlimit), the buffer pool arena and the
+    /// calling stack are still prefaulted by hand. Call from the main thread
+    /// after the services are up, before @ref start. Results are published in
+    /// {@ref rt_memory_stats}
+    void lock_memory() noexcept;
+
     /// Start audio processing
     ///
     /// Sets `running() = true`
@@ -71,14 +138,66 @@ namespace otto::services {
     } events;
 
   protected:
-    util::double_buffered<core::midi::shared_vector<core::midi::AnyMidiEvent>> midi_bufs = {{}, {}};
+    /// Drain events queued by {@ref send_midi_event} into the inner midi arena.
+    ///
+    /// Called by the audio drivers at the start of each process call, after swapping
+    /// {@ref midi_bufs}.
+    ///
+    /// Each event's frame offset is derived from its arrival time relative to
+    /// the previous drain, so delivery is one block late but sample-accurate -
+    /// without this, external sequencer timing quantizes to block boundaries,
+    /// which audibly smears tight grooves at larger buffer sizes. The fixed
+    /// one-block delay is what absorbs usb/driver jitter
+    void drain_midi_queue() noexcept;
+
+    /// Advance {@ref buffer_number} and wake {@ref wait_one} waiters.
+    ///
+    /// Called by the audio drivers once per process call. The wake syscall is
+    /// only made when somebody is actually parked
+    void publish_block() noexcept;
+
+    /// Drivers call this after (re)negotiating the samplerate.
+    ///
+    /// Stores the rate, updates the Gamma domain, and queues every function
+    /// registered with {@ref attach_samplerate_client} on the task pool
+    void samplerate_changed(int rate) noexcept;
+
+    /// Per-block event storage, inline and reset on swap - no heap traffic in
+    /// the callback. `ProcessData` carries a view into the inner arena
+    util::double_buffered<core::midi::EventArena> midi_bufs = {{}, {}};
+    /// A midi event plus its monotonic arrival time. Stamped in
+    /// {@ref send_midi_event}, converted to a frame offset in
+    /// {@ref drain_midi_queue}
+    struct TimestampedMidi {
+      core::midi::AnyMidiEvent event;
+      std::chrono::steady_clock::time_point arrival;
+    };
+
+    util::lockfree_queue<TimestampedMidi, 256> midi_queue;
+    /// When the queue was last drained - the arrival-time origin for the
+    /// frame offsets of the block being processed
+    std::chrono::steady_clock::time_point last_drain_time_ = std::chrono::steady_clock::now();
     std::atomic_int _samplerate = 48000;
     std::atomic_uint _buffer_size = 256;
     std::atomic_uint _buffer_number = 0;
     util::audio::Graph _cpu_time;
+    std::atomic<float> _direct_monitor = 0.f;
   private:
     core::audio::AudioBufferPool _buffer_pool{1};
+    /// Threads parked in {@ref wait_one}. Mutable - waiting doesn't change
+    /// observable state
+    mutable std::atomic_int _block_waiters = 0;
     std::atomic_bool _running{false};
+    /// Guards {@ref _samplerate_clients} - registration happens at engine
+    /// construction, regeneration on the task pool
+    std::mutex _samplerate_clients_mutex;
+    std::vector<std::function<void(int)>> _samplerate_clients;
+    std::atomic_bool _auto_tune{false};
+    /// Samples cpu temperature and clock every second into
+    /// {@ref thermal_stats}, and the resident set every few seconds, logging
+    /// growth so new fault sources show up in the session log. Also runs the
+    /// buffer size auto-tuner - see {@ref auto_tune_buffer_size}
+    util::sleeper_thread _watch_thread;
   };
 
 } // namespace otto::services
@@ -0,0 +1,66 @@
+#include "bounce.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <Gamma/Domain.h>
+
+#include "core/audio/audio_buffer_pool.hpp"
+#include "services/application.hpp"
+#include "services/audio_manager.hpp"
+#include "services/clock_manager.hpp"
+#include "services/engine_manager.hpp"
+#include "services/log_manager.hpp"
+#include "util/wav_writer.hpp"
+
+namespace otto::services::bounce {
+
+  bool render(const fs::path& path, float seconds)
+  {
+    auto& audio = *Application::current().audio_manager;
+    auto& engines = *Application::current().engine_manager;
+
+    const int samplerate = audio.samplerate();
+    const int nframes = int(audio.buffer_size());
+    // Set up the pool and domain state a driver would normally own
+    audio.buffer_pool().set_buffer_size(nframes);
+    gam::sampleRate(samplerate);
+
+    util::WavWriter writer;
+    if (!writer.open(path, samplerate, 2)) {
+      LOGE("Could not open bounce file {}", path);
+      return false;
+    }
+
+    ClockManager::current().start();
+    std::vector<float> interleaved(2 * std::size_t(nframes));
+    const auto total = std::int64_t(double(seconds) * samplerate);
+    const auto t0 = std::chrono::steady_clock::now();
+
+    bool ok = true;
+    for (std::int64_t rendered = 0; rendered < total;) {
+      auto in_buf = audio.buffer_pool().allocate_clear();
+      auto out = engines.process({in_buf, {}, core::clock::ClockRange()});
+      const int n = int(std::min<std::int64_t>(out.nframes, total - rendered));
+      for (int i = 0; i < n; i++) {
+        interleaved[2 * i] = out.audio[0][i];
+        interleaved[2 * i + 1] = out.audio[1][i];
+      }
+      if (!writer.write(interleaved.data(), 2 * std::size_t(n))) {
+        LOGE("Write failed during bounce to {}", path);
+        ok = false;
+        break;
+      }
+      rendered += n;
+    }
+    writer.close();
+    ClockManager::current().stop();
+
+    const auto ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    LOGI("Bounced {} s to {} in {} ms", seconds, path, ms);
+    return ok;
+  }
+
+} // namespace otto::services::bounce
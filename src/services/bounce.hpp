@@ -0,0 +1,21 @@
+#pragma once
+
+#include "util/filesystem.hpp"
+
+namespace otto::services::bounce {
+
+  /// Render `seconds` of the current arrangement offline into a stereo float
+  /// WAV at `path`.
+  ///
+  /// Pulls `EngineManager::process` in a tight loop, as fast as the cpu allows
+  /// - the clock is stepped synthetically by the process call itself, so the
+  /// sequencer, looper and arps run exactly as they would live. A 3-minute
+  /// arrangement renders in seconds.
+  ///
+  /// Must only be called while no audio driver is pulling the chain - it
+  /// reconfigures the buffer pool and domain the way a driver would.
+  ///
+  /// \returns `true` when the whole render was written
+  bool render(const fs::path& path, float seconds);
+
+} // namespace otto::services::bounce
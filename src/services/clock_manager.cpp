@@ -1,5 +1,7 @@
 #include "clock_manager.hpp"
 
+#include <algorithm>
+
 #include "util/type_traits.hpp"
 
 #include "services/audio_manager.hpp"
@@ -20,6 +22,11 @@ namespace otto::services {
 
   float ClockManager::bpm() const noexcept
   {
+    // Under external sync the tempo lives in samples_pr_beat_ - derive the
+    // display value here, off the audio path
+    if (sync_external() && samples_pr_beat_ > 0) {
+      return AudioManager::current().samplerate() * 60.f / float(samples_pr_beat_);
+    }
     return bpm_;
   }
 
@@ -33,6 +40,16 @@ namespace otto::services {
     return running_;
   }
 
+  float ClockManager::beat_phase() const noexcept
+  {
+    return float(counter_.current().time() % notes::beat) / float(notes::beat);
+  }
+
+  ClockManager::Time ClockManager::position() const noexcept
+  {
+    return counter_.current().time();
+  }
+
   // Modifiers //
 
   void ClockManager::set_bpm(float bpm) noexcept
@@ -41,10 +58,55 @@ namespace otto::services {
     samples_pr_beat_ = AudioManager::current().samplerate() / (bpm / 60.f);
   }
 
+  ClockManager::Timer& ClockManager::add_timer(Time period, Time offset, bool free_running) noexcept
+  {
+    return timers_.emplace_back(Timer{period, offset, free_running, {}});
+  }
+
+  void ClockManager::fire_timer(Timer& timer, ClockRange range) noexcept
+  {
+    // First firing time at or after range.begin. Unlike
+    // ClockRange::contains_multiple this includes t = 0, so the first beat
+    // after a reset fires immediately instead of one period late
+    Time t = range.begin <= timer.offset
+               ? timer.offset
+               : ((range.begin - timer.offset + timer.period - 1) / timer.period) * timer.period +
+                   timer.offset;
+    for (; t < range.end; t += timer.period) {
+      int frame = int((t - range.begin) * Time(samples_pr_beat_) / notes::beat);
+      // A full tick list drops the rest - more than 8 firings in one block
+      // means the period is far below the block length anyway
+      if (!timer.ticks.push_back({frame, int((t - timer.offset) / timer.period)})) break;
+    }
+  }
+
   ClockRange ClockManager::step_frames(int nframes)
   {
-    if (running()) counter_.step(notes::beat * nframes / samples_pr_beat_);
-    return counter_.current();
+    for (auto& timer : timers_) timer.ticks.clear();
+    const bool external = sync_external_.load(std::memory_order_relaxed);
+    if (external) update_external_sync(nframes);
+    if (samples_pr_beat_ == 0) return counter_.current();
+    // Carry the division remainder across blocks - without it the clock
+    // truncates up to one microstep per block and runs measurably slow, which
+    // would also saturate the external sync phase comparison below
+    const auto ticks_to_step = notes::beat * Time(nframes) + step_rem_;
+    const auto step = ticks_to_step / Time(samples_pr_beat_);
+    step_rem_ = ticks_to_step % Time(samples_pr_beat_);
+    // The estimator locks on the clock time actually stepped, so the phase
+    // comparison sees exactly what the timers see
+    if (external) ext_time_ += std::int64_t(step);
+    auto free_range = free_counter_.step(step);
+    if (running()) counter_.step(step);
+    auto range = counter_.current();
+    for (auto& timer : timers_) {
+      if (timer.period == 0) continue;
+      if (running()) {
+        fire_timer(timer, range);
+      } else if (timer.free_running) {
+        fire_timer(timer, free_range);
+      }
+    }
+    return range;
   }
 
   void ClockManager::start() noexcept
@@ -61,4 +123,109 @@ namespace otto::services {
     counter_.reset();
   }
 
+  // External midi clock sync //
+
+  void ClockManager::set_sync_external(bool enable) noexcept
+  {
+    sync_external_.store(enable, std::memory_order_relaxed);
+    if (enable) ext_resync_.store(true, std::memory_order_release);
+  }
+
+  bool ClockManager::sync_external() const noexcept
+  {
+    return sync_external_.load(std::memory_order_relaxed);
+  }
+
+  void ClockManager::external_clock_tick(std::chrono::steady_clock::time_point arrival) noexcept
+  {
+    if (ext_prev_arrival_.time_since_epoch().count() != 0) {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(arrival - ext_prev_arrival_).count();
+      // At 24 ticks per beat this accepts 10 to 1000 bpm - anything outside is
+      // a dropout or a burst, and feeding it to the estimator would only hurt
+      if (ns > 2'500'000 && ns < 250'000'000) {
+        ext_interval_ns_.store(ns, std::memory_order_relaxed);
+      }
+    }
+    ext_prev_arrival_ = arrival;
+    ext_ticks_.fetch_add(1, std::memory_order_release);
+  }
+
+  void ClockManager::external_clock_start() noexcept
+  {
+    if (!sync_external()) return;
+    ext_resync_.store(true, std::memory_order_release);
+    reset();
+    start();
+  }
+
+  void ClockManager::external_clock_continue() noexcept
+  {
+    if (!sync_external()) return;
+    start();
+  }
+
+  void ClockManager::external_clock_stop() noexcept
+  {
+    if (!sync_external()) return;
+    stop(false);
+  }
+
+  void ClockManager::update_external_sync(int nframes) noexcept
+  {
+    const auto ticks = ext_ticks_.load(std::memory_order_acquire);
+    const auto interval_ns = ext_interval_ns_.load(std::memory_order_relaxed);
+    // Two ticks make a tempo - until then the set bpm stands
+    if (interval_ns <= 0) return;
+
+    const int sr = AudioManager::current().samplerate();
+    if (sr != ext_cached_sr_) {
+      // The only division in here - redone when the samplerate changes, not
+      // per block
+      ext_cached_sr_ = sr;
+      ext_samples_per_ns_q32_ = (std::int64_t(sr) << 32) / 1'000'000'000;
+    }
+    const std::int64_t target_q16 = (interval_ns * ext_samples_per_ns_q32_) >> 16;
+
+    if (ext_resync_.exchange(false, std::memory_order_acq_rel) || ext_spt_q16_ == 0) {
+      ext_spt_q16_ = target_q16;
+      ext_tick_base_ = ticks;
+      ext_last_ticks_ = ticks;
+      ext_time_ = 0;
+      ext_err_lp_q4_ = 0;
+      ext_stale_samples_ = 0;
+    }
+
+    if (ticks == ext_last_ticks_) {
+      ext_stale_samples_ += nframes;
+    } else {
+      ext_stale_samples_ = 0;
+      ext_last_ticks_ = ticks;
+    }
+    // Source went quiet - hold the locked tempo instead of chasing a stale
+    // interval. A Start or re-enable rebases before the next lock
+    if (ext_stale_samples_ > std::int64_t(sr)) return;
+
+    // Frequency branch: low-pass the measured tick interval. The slow corner
+    // (~1/3 s at bs=256) absorbs usb arrival jitter; tempo changes still track
+    // through it, helped by the phase branch below
+    ext_spt_q16_ += (target_q16 - ext_spt_q16_) >> 6;
+
+    // Phase branch: compare the clock time we actually stepped against the
+    // received tick count, and bias the published tempo proportionally. The
+    // error is itself low-passed - it quantizes to microsteps and whole ticks
+    // per block - and the nudge is bounded, so jitter bends the tempo briefly
+    // instead of stepping it. The loop only rests at zero accumulated error:
+    // locked without drift, unlike following the raw intervals
+    const std::int64_t ext_pos = std::int64_t(ticks - ext_tick_base_) * std::int64_t(ext_tick_time);
+    const std::int64_t err_time =
+      std::clamp<std::int64_t>(ext_pos - ext_time_, -4 * std::int64_t(notes::beat), 4 * std::int64_t(notes::beat));
+    ext_err_lp_q4_ += ((err_time << 4) - ext_err_lp_q4_) >> 3;
+    const std::int64_t max_nudge = ext_spt_q16_ >> 5;
+    const std::int64_t nudge = std::clamp(
+      (ext_err_lp_q4_ >> 4) * (ext_spt_q16_ >> 8) / std::int64_t(ext_tick_time), -max_nudge, max_nudge);
+
+    const auto spb = int((24 * (ext_spt_q16_ - nudge)) >> 16);
+    if (spb > 0) samples_pr_beat_ = spb;
+  }
+
 } // namespace otto::services
@@ -1,12 +1,17 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <tl/optional.hpp>
 
 #include "core/audio/clock.hpp"
 #include "core/service.hpp"
 #include "services/application.hpp"
+#include "util/local_vector.hpp"
 
 namespace otto::services {
 
@@ -32,6 +37,33 @@ namespace otto::services {
       return *Application::current().clock_manager;
     }
 
+    /// A periodic timer stepped by the clock service.
+    ///
+    /// Fires at every clock time `t = k * period + offset`. During
+    /// {@ref step_frames} the service fills {@ref ticks} with the exact frame
+    /// offset and multiple index of each firing in the current block, so
+    /// consumers read their firing frames in their process call instead of
+    /// each doing division math on the `ClockRange` per block.
+    struct Timer {
+      struct Tick {
+        /// Exact frame offset within the current block
+        int frame;
+        /// The index `k` of the multiple that fired
+        int position;
+      };
+
+      /// Period between firings. Can be changed at any time
+      Time period;
+      /// Phase offset of the firings. Can be changed at any time
+      Time offset = 0;
+      /// Fire even while the transport is stopped, against a free-running
+      /// counter. While the transport runs, free timers follow it instead,
+      /// so arps and sequencers line up
+      bool free_running = false;
+      /// The firings within the current block, in frame order
+      util::local_vector<Tick, 8> ticks;
+    };
+
     // Member funcs //
 
     // Accessors //
@@ -39,6 +71,17 @@ namespace otto::services {
     float bpm() const noexcept;
     int samples_pr_beat() const noexcept;
     bool running() const noexcept;
+    /// Where in the current beat the clock is, as a fraction `[0, 1)`.
+    ///
+    /// Readable from any thread - the counter is stepped by the audio thread,
+    /// so the value is an approximation, which is all the background
+    /// schedulers using this need
+    float beat_phase() const noexcept;
+    /// The transport position, in clock time.
+    ///
+    /// Readable from any thread with the same caveat as {@ref beat_phase} -
+    /// an approximation, good enough for background schedulers
+    Time position() const noexcept;
 
     // Modifiers //
 
@@ -47,13 +90,87 @@ namespace otto::services {
     void stop(bool reset = true) noexcept;
     void reset() noexcept;
 
+    // External midi clock sync //
+
+    /// Follow an external midi clock instead of the set bpm.
+    ///
+    /// While enabled, {@ref samples_pr_beat} comes from a phase-locked
+    /// estimator fed by {@ref external_clock_tick}, updated once per block
+    /// with fixed-point math - tempo follows the source smoothly instead of
+    /// stepping on every received tick. {@ref set_bpm} still applies, but the
+    /// estimator overwrites it as soon as ticks arrive
+    void set_sync_external(bool enable) noexcept;
+    bool sync_external() const noexcept;
+
+    /// Feed one midi clock tick (0xF8, 24 per beat) with its arrival time.
+    ///
+    /// Lock free and allocation free - called from the midi driver thread.
+    /// Ticks are always accepted; they only drive the clock while
+    /// {@ref sync_external} is enabled
+    void external_clock_tick(std::chrono::steady_clock::time_point arrival) noexcept;
+
+    /// Midi transport Start (0xFA) - reset to the top and run.
+    /// Ignored unless {@ref sync_external} is enabled
+    void external_clock_start() noexcept;
+    /// Midi transport Continue (0xFB). Ignored unless external sync is enabled
+    void external_clock_continue() noexcept;
+    /// Midi transport Stop (0xFC). Ignored unless external sync is enabled
+    void external_clock_stop() noexcept;
+
+    /// Register a periodic timer.
+    ///
+    /// The returned reference is stable for the lifetime of the service.
+    /// Timers are never unregistered - the consumers are engines, which live
+    /// as long as the application.
+    Timer& add_timer(Time period, Time offset = 0, bool free_running = false) noexcept;
+
     ClockRange step_frames(int nframes);
 
   private:
+    void fire_timer(Timer& timer, ClockRange range) noexcept;
+    /// Step the phase-locked tempo estimator. Called once per block from
+    /// {@ref step_frames} while external sync is enabled
+    void update_external_sync(int nframes) noexcept;
+
     bool running_ = false;
     float bpm_ = 0;
     int samples_pr_beat_ = 0;
+    /// Remainder of the per-block step division, carried so the clock does
+    /// not truncate-drift - see {@ref step_frames}
+    Time step_rem_ = 0;
     ClockCounter counter_;
+    /// Steps every block regardless of the transport, for free-running timers
+    ClockCounter free_counter_;
+    /// Deque for reference stability on {@ref add_timer}
+    std::deque<Timer> timers_;
+
+    // External sync state //
+
+    /// A midi clock tick is `notes::beat / 24` clock time units
+    static constexpr Time ext_tick_time = core::clock::notes::beat / 24;
+
+    std::atomic<bool> sync_external_ = false;
+    /// Total ticks received. Written by the midi thread, read per block
+    std::atomic<std::uint32_t> ext_ticks_ = 0;
+    /// Latest accepted inter-tick interval in nanoseconds. The estimator
+    /// low-passes this, so storing only the newest value loses nothing
+    std::atomic<std::int64_t> ext_interval_ns_ = 0;
+    /// Set by transport messages or {@ref set_sync_external} to rebase the
+    /// phase comparison before the next estimator step
+    std::atomic<bool> ext_resync_ = true;
+    /// Previous tick arrival. Only touched on the midi thread
+    std::chrono::steady_clock::time_point ext_prev_arrival_ = {};
+
+    // Estimator state, audio thread only. Q16 fixed point throughout - the
+    // published samples_pr_beat_ stays an int, consumers are unchanged
+    std::int64_t ext_spt_q16_ = 0;       ///< Smoothed samples per tick
+    std::int64_t ext_time_ = 0;          ///< Our clock-time advance since rebase
+    std::int64_t ext_err_lp_q4_ = 0;     ///< Low-passed phase error, Q4 clock time
+    std::uint32_t ext_tick_base_ = 0;    ///< Tick count at rebase
+    std::uint32_t ext_last_ticks_ = 0;   ///< Tick count seen last block
+    std::int64_t ext_stale_samples_ = 0; ///< Samples since the last new tick
+    int ext_cached_sr_ = 0;
+    std::int64_t ext_samples_per_ns_q32_ = 0;
   };
 
 
@@ -1,6 +1,8 @@
 #include "controller.hpp"
 
 #include "util/iterator.hpp"
+#include "util/signals.hpp"
+#include "util/tracing.hpp"
 #include "util/utility.hpp"
 
 #include "services/audio_manager.hpp"
@@ -57,22 +59,116 @@ namespace otto::services {
 
   void Controller::keypress(Key key)
   {
-    if (!send_midi_for(key, true)) events_.outer().push_back(KeyPressEvent{key});
+    if (!send_midi_for(key, true)) {
+      if (!events_.try_push({QueuedEvent::Type::key_press, key._to_integral()})) {
+        LOGE("Event queue full - dropping key press");
+      }
+    }
     key_handler_thread.trigger();
   }
 
   void Controller::encoder(EncoderEvent ev)
   {
-    events_.outer().push_back(ev);
+    if (ev.steps == 0) return;
+    // Coalesce: accumulate the steps, and only queue a wakeup marker when the
+    // accumulator was empty. The logic thread drains the whole accumulation as a
+    // single event
+    if (encoder_steps_[ev.encoder._to_index()].fetch_add(ev.steps, std::memory_order_acq_rel) == 0) {
+      if (!events_.try_push({QueuedEvent::Type::encoder, ev.encoder._to_integral()})) {
+        LOGE("Event queue full - dropping encoder steps");
+        encoder_steps_[ev.encoder._to_index()].store(0, std::memory_order_relaxed);
+      }
+    }
     key_handler_thread.trigger();
   }
 
   void Controller::keyrelease(Key key)
   {
-    if (!send_midi_for(key, false)) events_.outer().push_back(KeyReleaseEvent{key});
+    if (!send_midi_for(key, false)) {
+      if (!events_.try_push({QueuedEvent::Type::key_release, key._to_integral()})) {
+        LOGE("Event queue full - dropping key release");
+      }
+    }
     key_handler_thread.trigger();
   }
 
+  void Controller::set_color(LED led, LEDColor color) noexcept
+  {
+    auto idx = led.key._to_index();
+    led_effects_[idx].effect.type = LEDEffect::Type::none;
+    led_colors_[idx] = color;
+  }
+
+  void Controller::fade_color(LED led, LEDColor from, LEDColor to, chrono::duration time) noexcept
+  {
+    start_effect(led, {LEDEffect::Type::fade, from, to, time});
+  }
+
+  void Controller::blink_colors(LED led, LEDColor a, LEDColor b, chrono::duration period) noexcept
+  {
+    start_effect(led, {LEDEffect::Type::blink, a, b, period});
+  }
+
+  void Controller::start_effect(LED led, const LEDEffect& effect) noexcept
+  {
+    auto idx = led.key._to_index();
+    auto& running = led_effects_[idx];
+    running.effect = effect;
+    running.started = chrono::clock::now();
+    running.on_device = do_start_effect(led, effect);
+    if (running.on_device) {
+      // The device animates the led from here - park the delta tracker on the
+      // end color so it stays out of the way until the next set_color
+      led_colors_[idx] = effect.to;
+      sent_led_colors_[idx] = effect.to;
+    }
+  }
+
+  void Controller::flush_leds()
+  {
+    auto now = chrono::clock::now();
+    if (now - last_led_flush_ < led_flush_interval) return;
+    last_led_flush_ = now;
+    for (auto key : Key::_values()) {
+      auto idx = key._to_index();
+      auto& running = led_effects_[idx];
+      if (running.effect.type != LEDEffect::Type::none && !running.on_device) {
+        // Host-side fallback - step the effect into the wanted color, and let
+        // the delta tracking below decide whether anything needs sending
+        float t = running.effect.period == chrono::duration::zero()
+                    ? 1.f
+                    : float((now - running.started).count()) / float(running.effect.period.count());
+        switch (running.effect.type) {
+          case LEDEffect::Type::fade: {
+            if (t >= 1.f) {
+              led_colors_[idx] = running.effect.to;
+              running.effect.type = LEDEffect::Type::none;
+            } else {
+              led_colors_[idx] = running.effect.from.mix(running.effect.to, t);
+            }
+          } break;
+          case LEDEffect::Type::blink: {
+            led_colors_[idx] =
+              (int(t * 2.f) % 2) == 0 ? running.effect.from : running.effect.to;
+          } break;
+          default: break;
+        }
+      }
+      if (sent_led_colors_[idx] == led_colors_[idx]) continue;
+      do_set_color(LED{key}, led_colors_[idx]);
+      sent_led_colors_[idx] = led_colors_[idx];
+    }
+    // Always flush - the queue can also hold protocol replies from the read thread
+    do_flush_leds();
+  }
+
+  void Controller::clear_leds()
+  {
+    led_colors_.fill(LEDColor::Black);
+    sent_led_colors_.fill(LEDColor::Black);
+    do_clear_leds();
+  }
+
   bool Controller::is_pressed(Key k) noexcept
   {
     return keys[k._to_index()];
@@ -97,23 +193,41 @@ namespace otto::services {
   }
 
   Controller::Controller()
-    : key_handler_thread([this](auto&& should_run) {
-        while (!events_.inner().empty() || should_run()) {
-          events_.swap();
-          for (auto& event : events_.inner()) {
-            signals.on_input.emit(event);
-            util::match(event,
-                        [this](KeyPressEvent& ev) {
-                          keys[ev.key._to_index()] = true;
-                          if (handle_global(ev.key)) return;
-                          UIManager::current().current_screen().keypress(ev.key);
-                        },
-                        [this](KeyReleaseEvent& ev) {
-                          keys[ev.key._to_index()] = false;
-                          if (handle_global(ev.key, false)) return;
-                          UIManager::current().current_screen().keyrelease(ev.key);
-                        },
-                        [](EncoderEvent& ev) { UIManager::current().current_screen().encoder(ev); });
+    : key_handler_thread(util::scheduling::Band::ui, [this](auto&& should_run) {
+        auto dispatch = [this](Event event) {
+          OTTO_TRACE_SCOPE("controller/dispatch");
+          signals.on_input.emit(event);
+          util::match(event,
+                      [this](KeyPressEvent& ev) {
+                        keys[ev.key._to_index()] = true;
+                        if (handle_global(ev.key)) return;
+                        UIManager::current().current_screen().keypress(ev.key);
+                      },
+                      [this](KeyReleaseEvent& ev) {
+                        keys[ev.key._to_index()] = false;
+                        if (handle_global(ev.key, false)) return;
+                        UIManager::current().current_screen().keyrelease(ev.key);
+                      },
+                      [](EncoderEvent& ev) { UIManager::current().current_screen().encoder(ev); });
+        };
+        while (!events_.empty() || should_run()) {
+          QueuedEvent qe;
+          // Coalesce prop-change signals across the whole burst, so a fast
+          // encoder sweep fires each slot once, with the final value
+          util::defer_signals defer;
+          while (events_.try_pop(qe)) {
+            switch (qe.type) {
+              case QueuedEvent::Type::key_press: dispatch(KeyPressEvent{Key::_from_integral_unchecked(qe.arg)}); break;
+              case QueuedEvent::Type::key_release:
+                dispatch(KeyReleaseEvent{Key::_from_integral_unchecked(qe.arg)});
+                break;
+              case QueuedEvent::Type::encoder: {
+                // Drain the accumulated steps as a single event. They can cancel
+                // out to zero, in which case there is nothing to report
+                int steps = encoder_steps_[qe.arg].exchange(0, std::memory_order_acq_rel);
+                if (steps != 0) dispatch(EncoderEvent{Encoder::_from_integral_unchecked(qe.arg), steps});
+              } break;
+            }
           }
         }
       })
@@ -121,9 +235,9 @@ namespace otto::services {
 
   // DummyController //
   struct DummyController final : Controller {
-    void set_color(LED, LEDColor) override {}
-    void flush_leds() override {}
-    void clear_leds() override {}
+    void do_set_color(LED, LEDColor) override {}
+    void do_flush_leds() override {}
+    void do_clear_leds() override {}
   };
 
   std::unique_ptr<Controller> Controller::make_dummy()
@@ -6,6 +6,9 @@
 #include <foonathan/array/flat_map.hpp>
 #include <vector>
 
+#include <atomic>
+
+#include "util/lockfree_queue.hpp"
 #include "util/locked.hpp"
 #include "util/thread.hpp"
 #include "util/variant.hpp"
@@ -20,6 +23,10 @@ namespace otto::board::ui {
   void handle_keyevent(board::ui::Action, board::ui::Modifiers, board::ui::Key);
 } // namespace otto::board::ui
 
+namespace otto::services::soak {
+  bool run(float minutes);
+} // namespace otto::services::soak
+
 namespace otto::services {
 
   BETTER_ENUM(FuncKey,
@@ -188,6 +195,15 @@ namespace otto::services {
               static_cast<std::uint8_t>(b + o.b)};
     }
 
+    bool operator==(LEDColor o) const noexcept
+    {
+      return r == o.r && g == o.g && b == o.b;
+    }
+    bool operator!=(LEDColor o) const noexcept
+    {
+      return !(*this == o);
+    }
+
     static const LEDColor Black;
     static const LEDColor White;
     static const LEDColor Blue;
@@ -219,9 +235,42 @@ namespace otto::services {
       return Application::current().controller;
     }
 
-    virtual void set_color(LED, LEDColor) = 0;
-    virtual void flush_leds() = 0;
-    virtual void clear_leds() = 0;
+    /// Set the color of an led.
+    ///
+    /// Changes are delta-tracked against what was last sent to the device, so
+    /// animating screens can set every led every frame without saturating the
+    /// serial link - only actual changes end up in the batch sent by
+    /// @ref flush_leds.
+    void set_color(LED, LEDColor) noexcept;
+
+    /// Fade an led from one color to another over `time`.
+    ///
+    /// Declarative - a controller that can run the effect on the device gets
+    /// one command, everything else steps it host-side through the normal
+    /// delta-tracked path in @ref flush_leds. Either way the caller issues
+    /// one call per gesture instead of a color update per animation frame.
+    /// The next @ref set_color on the same led cancels the effect
+    void fade_color(LED, LEDColor from, LEDColor to, chrono::duration time) noexcept;
+
+    /// Blink an led between two colors with the given period.
+    ///
+    /// Runs until the next @ref set_color on the led. Execution semantics as
+    /// @ref fade_color
+    void blink_colors(LED, LEDColor a, LEDColor b, chrono::duration period) noexcept;
+
+    /// Send the accumulated led changes to the device as a single batch.
+    ///
+    /// Called once per ui frame. Rate limited by @ref led_flush_interval.
+    void flush_leds();
+
+    /// Turn all leds off
+    void clear_leds();
+
+    /// Minimum time between led batches sent to the device.
+    ///
+    /// Zero (the default) lets every @ref flush_leds call through. Raise it if the
+    /// link can't keep up with the frame rate.
+    chrono::duration led_flush_interval = chrono::duration::zero();
 
 
     /// Check if a key is currently pressed.
@@ -230,11 +279,46 @@ namespace otto::services {
     /// Register a key handler
     void register_key_handler(Key k, KeyHandler press_handler, KeyHandler release_handler = nullptr);
 
+    /// Number of registered key handlers.
+    ///
+    /// Handlers are only expected to be registered during startup - this
+    /// growing afterwards means something re-registers on a running system
+    std::size_t key_handler_count() const noexcept
+    {
+      return key_handlers.size();
+    }
+
     struct Signals {
       util::Signal<Event> on_input;
     } signals;
 
   protected:
+    /// Queue a single led color for the device. Called from @ref flush_leds for
+    /// each led that actually changed
+    virtual void do_set_color(LED, LEDColor) = 0;
+    /// Send the queued messages to the device
+    virtual void do_flush_leds() = 0;
+    /// Turn all leds off on the device
+    virtual void do_clear_leds() = 0;
+
+    /// A declarative led effect. See @ref fade_color and @ref blink_colors
+    struct LEDEffect {
+      enum struct Type : std::uint8_t { none, fade, blink };
+      Type type = Type::none;
+      LEDColor from;
+      LEDColor to;
+      chrono::duration period = chrono::duration::zero();
+    };
+
+    /// Start an effect on the device, if the controller supports it.
+    ///
+    /// Returning false (the default) makes @ref flush_leds step the effect
+    /// host-side instead
+    virtual bool do_start_effect(LED, const LEDEffect&)
+    {
+      return false;
+    }
+
     /// Dispatches to the event handler for the current screen, and handles
     /// global keys.
     ///
@@ -257,12 +341,47 @@ namespace otto::services {
     /// @TODO replace with something cleaner
     friend void ::otto::board::ui::handle_keyevent(board::ui::Action, board::ui::Modifiers, board::ui::Key);
 
+    /// The soak test drives scripted input through the normal event queue
+    friend bool ::otto::services::soak::run(float minutes);
+
   private:
     bool handle_global(Key key, bool is_press = true);
 
+    /// What actually travels through the event ring.
+    ///
+    /// Encoder steps are accumulated in encoder_steps_ and only a wakeup marker is
+    /// queued, so fast twirls wake the logic thread once per encoder touched, not
+    /// once per pulse.
+    struct QueuedEvent {
+      enum struct Type : std::uint8_t { key_press, key_release, encoder };
+      Type type = Type::key_press;
+      /// The key integral value, or the encoder index
+      std::uint8_t arg = 0;
+    };
+
     foonathan::array::flat_map<Key, std::pair<KeyHandler, KeyHandler>> key_handlers;
     std::array<bool, Key::_size()> keys;
-    util::double_buffered<EventBag> events_;
+    util::lockfree_queue<QueuedEvent, 64> events_;
+    std::array<std::atomic<int>, Encoder::_size()> encoder_steps_ = {};
+
+    void start_effect(LED, const LEDEffect&) noexcept;
+
+    /// One effect per led, stamped when it starts.
+    ///
+    /// `on_device` marks effects the controller executes itself - the host
+    /// only keeps them to know the led is taken until the next set_color
+    struct RunningEffect {
+      LEDEffect effect;
+      chrono::time_point started = {};
+      bool on_device = false;
+    };
+
+    std::array<RunningEffect, Key::_size()> led_effects_ = {};
+
+    /// The led colors the screens want, and what was last flushed to the device
+    std::array<LEDColor, Key::_size()> led_colors_ = {};
+    std::array<LEDColor, Key::_size()> sent_led_colors_ = {};
+    chrono::time_point last_led_flush_ = {};
 
     /// Essentially the logic thread, since most logic will happen in key handlers and property change events
     util::triggered_thread key_handler_thread;
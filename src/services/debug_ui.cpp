@@ -0,0 +1,49 @@
+#include "services/debug_ui.hpp"
+
+#include <cmath>
+
+#include <Gamma/FFT.h>
+
+#include "util/dsp/window.hpp"
+
+namespace otto::services {
+
+  void spectrum_analyzer::push(const float* l, const float* r, std::size_t n) noexcept
+  {
+    if (!armed.load(std::memory_order_relaxed)) return;
+    auto pos = write_pos.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < n; i++) {
+      ring[pos++ % ring.size()] = 0.5f * (l[i] + r[i]);
+    }
+    write_pos.store(pos, std::memory_order_release);
+  }
+
+  bool spectrum_analyzer::analyze() noexcept
+  {
+    static constexpr auto window = util::dsp::make_window_table<util::dsp::Window::hann, fft_size>();
+    static gam::RFFT<float> fft{fft_size};
+    static std::uint32_t last_pos = 0;
+
+    const auto pos = write_pos.load(std::memory_order_acquire);
+    if (pos < fft_size || pos == last_pos) return false;
+    last_pos = pos;
+
+    // Copy the newest window out of the ring, applying the hann table on the
+    // way. The writer may overtake the oldest samples mid-copy - a torn
+    // window smears one debug frame, which is fine
+    std::array<float, fft_size + 2> buf = {};
+    const auto start = pos - fft_size;
+    for (int i = 0; i < fft_size; i++) {
+      buf[i] = ring[(start + i) % ring.size()] * float(window[i]);
+    }
+    // Normalize so a full-scale sine lands near 0 dB regardless of fft size
+    fft.forward(buf.data(), true, 2.f / float(fft_size));
+    for (int b = 0; b < bin_count; b++) {
+      const float re = buf[2 * b];
+      const float im = buf[2 * b + 1];
+      bins_db[b] = std::max(-80.f, 10.f * std::log10(re * re + im * im + 1e-12f));
+    }
+    return true;
+  }
+
+} // namespace otto::services
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <functional>
 #include <vector>
 
 #include "util/algorithm.hpp"
 #include "util/locked.hpp"
 #include "util/ringbuffer.hpp"
+#include "util/signals.hpp"
 
 #include "core/service.hpp"
 #include "services/application.hpp"
@@ -16,6 +22,303 @@ namespace otto::services {
 
   };
 
+  /// Per-stage cpu time spent in the audio callback.
+  ///
+  /// The engine manager wraps each stage of its process call in a {@ref scoped} timer.
+  /// The audio thread accumulates into plain integers and publishes them with one
+  /// relaxed atomic store per stage at the end of the block, so other threads (debug
+  /// ui, fifo protocol) can read the breakdown lock-free, and the hot path cost is two
+  /// steady_clock reads per stage.
+  struct audio_stage_timers {
+    enum struct Stage { arp, synth, fx1, fx2, sampler, master };
+    static constexpr int stage_count = 6;
+    static constexpr std::array<const char*, stage_count> stage_names = {"arp",  "synth",   "fx1",
+                                                                         "fx2",  "sampler", "master"};
+
+    /// Time a stage for the duration of the current scope
+    struct scoped {
+      scoped(Stage stage) noexcept : stage(stage), t0(std::chrono::steady_clock::now()) {}
+      ~scoped() noexcept
+      {
+        block_ns[int(stage)] +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+      }
+
+      Stage stage;
+      std::chrono::steady_clock::time_point t0;
+    };
+
+    /// Publish the accumulated stage times. Called once per block by the audio thread
+    static void publish() noexcept
+    {
+      for (int i = 0; i < stage_count; i++) {
+        published[i].store(block_ns[i], std::memory_order_relaxed);
+        session_ns[i] += block_ns[i];
+        session_published[i].store(session_ns[i], std::memory_order_relaxed);
+        block_ns[i] = 0;
+      }
+    }
+
+    /// Nanoseconds spent in `stage` during the last published block. Any thread
+    static std::uint64_t read_ns(Stage stage) noexcept
+    {
+      return published[int(stage)].load(std::memory_order_relaxed);
+    }
+
+    /// Nanoseconds spent in `stage` since startup - the session report
+    /// aggregates these into the per-stage totals. Any thread
+    static std::uint64_t read_session_ns(Stage stage) noexcept
+    {
+      return session_published[int(stage)].load(std::memory_order_relaxed);
+    }
+
+  private:
+    static inline std::array<std::uint64_t, stage_count> block_ns = {};
+    static inline std::array<std::uint64_t, stage_count> session_ns = {};
+    static inline std::array<std::atomic<std::uint64_t>, stage_count> published = {};
+    static inline std::array<std::atomic<std::uint64_t>, stage_count> session_published = {};
+  };
+
+  /// Memory residency, published by {@ref AudioManager}.
+  ///
+  /// `memory_locked` is set when mlockall succeeded during rt setup.
+  /// `baseline_rss_kb` is the resident set right after locking and
+  /// prefaulting; `rss_kb` is sampled every few seconds. The difference
+  /// growing during a session means something is still faulting in new pages -
+  /// a fresh fault source worth hunting down
+  struct rt_memory_stats {
+    static inline std::atomic<bool> memory_locked = false;
+    static inline std::atomic<long> baseline_rss_kb = 0;
+    static inline std::atomic<long> rss_kb = 0;
+  };
+
+  /// Cpu temperature and clock, sampled once a second by {@ref AudioManager}'s
+  /// watch thread.
+  ///
+  /// The firmware throttles silently when the soc gets hot, halving the audio
+  /// headroom mid-set. With the performance governor the clock only drops when
+  /// the firmware caps it, so `cur_khz < max_khz` is the throttle signal -
+  /// {@ref throttled} holds the current verdict, and {@ref on_throttle} fires
+  /// on every edge (`true` when throttling begins, `false` on recovery).
+  /// Emitted from the watch thread - connect during init only
+  struct thermal_stats {
+    /// Millidegrees celsius, from the first thermal zone. -1 when unreadable
+    static inline std::atomic<long> temp_mc = -1;
+    /// Session peak of {@ref temp_mc}, for the session report
+    static inline std::atomic<long> peak_mc = -1;
+    static inline std::atomic<std::uint32_t> cur_khz = 0;
+    static inline std::atomic<std::uint32_t> max_khz = 0;
+    static inline std::atomic<bool> throttled = false;
+    static inline util::Signal<bool> on_throttle = {};
+  };
+
+  /// Total engine memory from the startup footprint report.
+  ///
+  /// Written once by {@ref DefaultEngineManager::start}, which logs the
+  /// per-engine breakdown - see {@ref core::engine::IEngine::memory_footprint}
+  struct engine_memory_stats {
+    static inline std::atomic<long> total_kb = 0;
+  };
+
+  /// Xrun accounting, fed by the audio drivers.
+  ///
+  /// Every callback pushes its duration into a small history ring. When the
+  /// driver reports an over/underrun it calls {@ref record_xrun}, which
+  /// snapshots that history, the per-stage timers from the last published
+  /// block, the midi queue depth and the current cpu frequency. The last
+  /// {@ref capacity} records are kept, dumpable from the settings screen -
+  /// each xrun names its suspect: a slow stage, a queue backing up, or the
+  /// governor clocking down.
+  struct xrun_stats {
+    static constexpr int history_size = 8;
+    static constexpr int capacity = 16;
+
+    struct record {
+      std::uint64_t uptime_ms;
+      /// Most recent callback durations, newest first
+      std::array<std::uint64_t, history_size> callback_ns;
+      /// Per-stage times of the last published block
+      std::array<std::uint64_t, audio_stage_timers::stage_count> stage_ns;
+      std::uint32_t midi_queue_depth;
+      std::uint32_t cpu_khz;
+    };
+
+    /// Called by the driver once per callback. Audio thread only
+    static void push_callback_ns(std::uint64_t ns) noexcept
+    {
+      history[history_head++ % history_size] = ns;
+    }
+
+    /// Called by the driver when it reports an xrun.
+    ///
+    /// Reads a sysfs file - fine here, the deadline is already blown. Jack
+    /// delivers xruns on a separate thread and cannot sample the midi queue,
+    /// so it passes a zero depth
+    static void record_xrun(std::uint32_t midi_queue_depth) noexcept
+    {
+      record& r = records[count.load(std::memory_order_relaxed) % capacity];
+      r.uptime_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count();
+      for (int i = 0; i < history_size; i++) {
+        r.callback_ns[i] = history[(history_head + history_size - 1 - i) % history_size];
+      }
+      for (int i = 0; i < audio_stage_timers::stage_count; i++) {
+        r.stage_ns[i] = audio_stage_timers::read_ns(audio_stage_timers::Stage(i));
+      }
+      r.midi_queue_depth = midi_queue_depth;
+      r.cpu_khz = read_cpu_khz();
+      count.fetch_add(1, std::memory_order_release);
+    }
+
+    /// Total xruns recorded. Any thread
+    static std::uint64_t total() noexcept
+    {
+      return count.load(std::memory_order_acquire);
+    }
+
+    /// Copy out up to `max` of the most recent records, newest first.
+    ///
+    /// Any thread. A record being written concurrently may come out torn -
+    /// acceptable for a debug dump
+    static int read(record* out, int max) noexcept
+    {
+      const auto n = count.load(std::memory_order_acquire);
+      const int avail = int(std::min<std::uint64_t>(n, capacity));
+      const int m = std::min(avail, max);
+      for (int i = 0; i < m; i++) {
+        out[i] = records[(n - 1 - i) % capacity];
+      }
+      return m;
+    }
+
+  private:
+    static std::uint32_t read_cpu_khz() noexcept
+    {
+      std::uint32_t khz = 0;
+      if (std::FILE* f = std::fopen("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", "r")) {
+        if (std::fscanf(f, "%u", &khz) != 1) khz = 0;
+        std::fclose(f);
+      }
+      return khz;
+    }
+
+    static inline std::array<std::uint64_t, history_size> history = {};
+    static inline unsigned history_head = 0;
+    static inline std::array<record, capacity> records = {};
+    static inline std::atomic<std::uint64_t> count = 0;
+  };
+
+  /// Heap allocations on the audio thread, counted by the interposed
+  /// allocator in util/allocation_tracker.cpp.
+  ///
+  /// `track_audio` arms a per-block tracking scope in the engine manager's
+  /// process call. `audio_allocations` climbing while armed means an
+  /// allocation snuck into the callback - the first one caught has its
+  /// backtrace stashed for {@ref util::allocation_tracker::log_first_offender}
+  struct rt_alloc_stats {
+    static inline std::atomic<bool> track_audio = false;
+    static inline std::atomic<std::uint64_t> audio_allocations = 0;
+  };
+
+  /// Swap timing for the UI thread, published by the board's display glue
+  /// once per presented frame.
+  ///
+  /// `last_swap_ns`/`max_swap_ns` are the time spent blocked inside the buffer
+  /// swap. `stalled_swaps` counts swaps that blocked for more than half a 60Hz
+  /// scanout - the previous frame had not hit scanout yet, so this frame's
+  /// deadline slipped a whole vblank. That number climbing is the signature of
+  /// the delayed key-LED feedback stalls
+  struct ui_swap_stats {
+    static inline std::atomic<std::uint64_t> last_swap_ns = 0;
+    static inline std::atomic<std::uint64_t> max_swap_ns = 0;
+    static inline std::atomic<std::uint64_t> frames = 0;
+    static inline std::atomic<std::uint64_t> stalled_swaps = 0;
+
+    /// Frame-to-frame interval histogram - one bucket increment per presented
+    /// frame, so a whole session costs nothing to keep. The first bucket is a
+    /// clean 60Hz cadence, the later ones are progressively worse stutters
+    static constexpr int bucket_count = 8;
+    /// Upper bounds of the histogram buckets in milliseconds. The last bucket
+    /// catches everything above
+    static constexpr std::array<std::uint32_t, bucket_count - 1> bucket_bounds_ms = {17, 20, 25, 33,
+                                                                                    50, 100, 250};
+    static inline std::array<std::atomic<std::uint64_t>, bucket_count> frame_interval_hist = {};
+
+    /// Called by the board's display glue with the time since the previous
+    /// presented frame. Ui thread only
+    static void push_frame_interval_ns(std::uint64_t ns) noexcept
+    {
+      const auto ms = ns / 1'000'000;
+      int bucket = bucket_count - 1;
+      for (int i = 0; i < bucket_count - 1; i++) {
+        if (ms < bucket_bounds_ms[i]) {
+          bucket = i;
+          break;
+        }
+      }
+      frame_interval_hist[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  /// Output loudness after the master chain, published once per block by
+  /// {@ref engines::Master}.
+  ///
+  /// Computed as block reductions ({@ref util::dsp::mean_square} and
+  /// {@ref util::dsp::peak}) over the already-processed buffers, so the cost is
+  /// two horizontal passes per channel. One relaxed store per value - the meter
+  /// on the master screen and the debug overlays read them lock-free
+  struct master_meter_stats {
+    static inline std::atomic<float> rms_l = 0.f;
+    static inline std::atomic<float> rms_r = 0.f;
+    static inline std::atomic<float> peak_l = 0.f;
+    static inline std::atomic<float> peak_r = 0.f;
+  };
+
+  /// Disk recorder counters for the current take, published by
+  /// {@ref services::Recorder}. Relaxed stores from the audio and writer
+  /// threads, readable from anywhere. `frames_dropped` counting up means the
+  /// card cannot keep up and the take has holes
+  struct recorder_stats {
+    static inline std::atomic<std::uint64_t> frames_written = 0;
+    static inline std::atomic<std::uint64_t> frames_dropped = 0;
+  };
+
+  /// Spectrum analyzer over the master output.
+  ///
+  /// The audio thread copies each block into a single-writer capture ring with
+  /// {@ref push} - while nothing shows the spectrum, `armed` is false and the
+  /// call is one relaxed load. {@ref analyze} runs on the ui thread when a
+  /// frame is wanted: it windows the newest {@ref fft_size} samples with the
+  /// constexpr hann table and transforms them with Gamma's real FFT - the same
+  /// transform the convolver runs per partition, so a frame is well within a
+  /// ui frame budget. Torn reads of {@ref bins_db} are acceptable, as with the
+  /// xrun records
+  struct spectrum_analyzer {
+    static constexpr int fft_size = 512;
+    static constexpr int bin_count = fft_size / 2;
+
+    /// Arm/disarm capture. Set by the screen showing the spectrum
+    static inline std::atomic<bool> armed = false;
+
+    /// Copy a block into the capture ring. Called by {@ref engines::Master}
+    /// once per block, audio thread only. Channels are averaged to mono
+    static void push(const float* l, const float* r, std::size_t n) noexcept;
+
+    /// Transform the newest captured window into {@ref bins_db}.
+    ///
+    /// Ui thread. Returns false when no new full window has been captured
+    /// since the last frame
+    static bool analyze() noexcept;
+
+    /// Log magnitude per bin in dB, clamped to a -80 dB floor
+    static inline std::array<float, bin_count> bins_db = {};
+
+  private:
+    static inline std::array<float, 2 * fft_size> ring = {};
+    static inline std::atomic<std::uint32_t> write_pos = 0;
+  };
+
   template<std::size_t N>
   struct graph {
     void push(float val)
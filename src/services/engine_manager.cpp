@@ -1,11 +1,20 @@
 #include "engine_manager.hpp"
+
+#include <algorithm>
+#include <optional>
+
+#include <fmt/format.h>
+
+#include "core/audio/routing_graph.hpp"
 #include "core/engine/engine_dispatcher.hpp"
 #include "core/engine/engine_dispatcher.inl"
 
 #include <engines/synths/goss/goss.hpp>
 #include <engines/synths/potion/potion.hpp>
 #include "engines/fx/chorus/chorus.hpp"
+#include "engines/fx/nebula/nebula.hpp"
 #include "engines/fx/wormhole/wormhole.hpp"
+#include "engines/misc/looper/looper.hpp"
 #include "engines/misc/master/master.hpp"
 #include "engines/misc/sends/sends.hpp"
 #include "engines/misc/sequencer/sequencer.hpp"
@@ -17,9 +26,22 @@
 
 #include "services/application.hpp"
 #include "services/clock_manager.hpp"
+#include "services/debug_ui.hpp"
+#include "services/governor.hpp"
+#include "services/log_manager.hpp"
+#include "services/recorder.hpp"
 
 #include "core/ui/vector_graphics.hpp"
 
+#include "util/allocation_tracker.hpp"
+#include "util/audio_worker.hpp"
+#include "util/symbol.hpp"
+#include "util/thread.hpp"
+#include "util/tracing.hpp"
+#include "util/dsp/mix_kernels.hpp"
+#include "util/dsp/ramped_gain.hpp"
+#include "util/dsp/signal_presence.hpp"
+
 namespace otto::services {
 
   using namespace core;
@@ -35,7 +57,8 @@ namespace otto::services {
     using EffectsDispatcher = EngineDispatcher< //
       EngineType::effect,
       engines::Wormhole,
-      engines::Chorus>;
+      engines::Chorus,
+      engines::Nebula>;
     using ArpDispatcher = EngineDispatcher< //
       EngineType::arpeggiator,
       engines::Euclid,
@@ -48,14 +71,44 @@ namespace otto::services {
       engines::OTTOFMSynth>;
 
     SynthDispatcher synth{false};
+    /// Second synth slot, layered under (or split against) the main one.
+    /// Off by default - the layer stage is skipped entirely while no engine
+    /// is selected
+    SynthDispatcher synth2{true};
     ArpDispatcher arpeggiator{true};
     EffectsDispatcher effect1{true};
     EffectsDispatcher effect2{true};
 
     engines::Sends synth_send;
     engines::Sends line_in_send;
+    engines::Looper looper;
     engines::Master master;
     engines::Sequencer sequencer;
+
+    /// Grabbed at construction, so the recorder (and its writer thread) is
+    /// never first built from the audio thread
+    Recorder& recorder = Recorder::current();
+
+    /// Runs fx2 concurrently with fx1 in the process call. Pinned to the
+    /// board's worker core, which the audio callback does not use.
+    util::audio_worker fx_worker{util::scheduling::worker_cpu()};
+
+    /// Signal presence tracking per effect slot - lets the process call skip a
+    /// stage whose input is silent and whose tail has decayed
+    util::dsp::EffectBypass fx1_bypass_;
+    util::dsp::EffectBypass fx2_bypass_;
+
+    /// Block ramps for the send and dry gains - dezippers encoder moves
+    util::dsp::RampedGain fx1_send_ramp_;
+    util::dsp::RampedGain fx2_send_ramp_;
+    util::dsp::RampedGain dry_l_ramp_;
+    util::dsp::RampedGain dry_r_ramp_;
+    util::dsp::RampedGain layer_ramp_;
+
+    /// Per-block midi routing for split mode - note events are partitioned
+    /// into these by key, everything else goes to both synths
+    core::midi::EventArena synth_arena_;
+    core::midi::EventArena layer_arena_;
   };
 
   std::unique_ptr<EngineManager> EngineManager::create_default()
@@ -82,7 +135,8 @@ namespace otto::services {
       ScreenEnum::fx2, [&]() -> auto& { return effect2->screen(); });
     reg_ss(
       ScreenEnum::fx2_selector, [&]() -> auto& { return effect2.selector_screen(); });
-    // reg_ss(ScreenEnum::looper,         [&] () -> auto& { return  ; });
+    reg_ss(
+      ScreenEnum::looper, [&]() -> auto& { return looper.screen(); });
     reg_ss(
       ScreenEnum::arp, [&]() -> auto& { return arpeggiator->screen(); });
     reg_ss(
@@ -103,6 +157,10 @@ namespace otto::services {
       ScreenEnum::synth_selector, [&]() -> auto& { return synth.selector_screen(); });
     reg_ss(
       ScreenEnum::synth_envelope, [&]() -> auto& { return synth->envelope_screen(); });
+    reg_ss(
+      ScreenEnum::synth2, [&]() -> auto& { return synth2->screen(); });
+    reg_ss(
+      ScreenEnum::synth2_selector, [&]() -> auto& { return synth2.selector_screen(); });
     // reg_ss(ScreenEnum::external,       [&] () -> auto& { return  ; });
     // reg_ss(ScreenEnum::twist1,         [&] () -> auto& { return  ; });
     // reg_ss(ScreenEnum::twist2,         [&] () -> auto& { return  ; });
@@ -112,6 +170,8 @@ namespace otto::services {
         case ScreenEnum::synth: [[fallthrough]];
         case ScreenEnum::synth_envelope: [[fallthrough]];
         case ScreenEnum::synth_selector: [[fallthrough]];
+        case ScreenEnum::synth2: [[fallthrough]];
+        case ScreenEnum::synth2_selector: [[fallthrough]];
         case ScreenEnum::voices:
           if (ui_manager.state.active_channel != +ChannelEnum::internal)
             ui_manager.state.active_channel = +ChannelEnum::internal;
@@ -123,6 +183,8 @@ namespace otto::services {
 
     controller.register_key_handler(ui::Key::sampler, [&](ui::Key k) { ui_manager.display(ScreenEnum::sampler); });
 
+    controller.register_key_handler(ui::Key::looper, [&](ui::Key k) { ui_manager.display(ScreenEnum::looper); });
+
     controller.register_key_handler(ui::Key::arp, [&](ui::Key k) {
       if (controller.is_pressed(ui::Key::shift)) {
         ui_manager.display(ScreenEnum::arp_selector);
@@ -132,8 +194,16 @@ namespace otto::services {
     });
 
     controller.register_key_handler(ui::Key::synth, [&](ui::Key k) {
+      // A second press on the synth key cycles to the layer synth
+      const auto current = ui_manager.state.current_screen.get();
       if (controller.is_pressed(ui::Key::shift)) {
-        ui_manager.display(ScreenEnum::synth_selector);
+        if (current == +ScreenEnum::synth2 || current == +ScreenEnum::synth2_selector) {
+          ui_manager.display(ScreenEnum::synth2_selector);
+        } else {
+          ui_manager.display(ScreenEnum::synth_selector);
+        }
+      } else if (current == +ScreenEnum::synth) {
+        ui_manager.display(ScreenEnum::synth2);
       } else {
         ui_manager.display(ScreenEnum::synth);
       }
@@ -192,9 +262,11 @@ namespace otto::services {
 
     auto load = [&](nlohmann::json& data) {
       synth.from_json(data["Synth"]);
+      if (data.count("Synth2")) synth2.from_json(data["Synth2"]);
       effect1.from_json(data["Effect1"]);
       effect2.from_json(data["Effect2"]);
       master.from_json(data["Master"]);
+      looper.from_json(data["Looper"]);
       arpeggiator.from_json(data["Arpeggiator"]);
       sequencer.from_json(data["Sequencer"]);
     };
@@ -202,57 +274,268 @@ namespace otto::services {
     auto save = [&] {
       return nlohmann::json({
         {"Synth", synth.to_json()},
+        {"Synth2", synth2.to_json()},
         {"Effect1", effect1.to_json()},
         {"Effect2", effect2.to_json()},
         {"Master", master.to_json()},
+        {"Looper", looper.to_json()},
         {"Arpeggiator", arpeggiator.to_json()},
         {"Sequencer", sequencer.to_json()},
       });
     };
 
     state_manager.attach("Engines", load, save);
+
+    // Engine props only change in response to input events, so this is a cheap,
+    // if conservative, dirty hook. The debounce absorbs the false positives.
+    // The name is interned once here - the per-keypress lookup is an integer
+    // compare
+    controller.signals.on_input.connect([&state_manager, tag = util::Symbol("Engines")](
+                                          auto&& event) { state_manager.mark_dirty(tag); });
   }
 
-  void DefaultEngineManager::start() {}
+  void DefaultEngineManager::start()
+  {
+    // Startup footprint report - where the 512 MB goes. Every engine is
+    // constructed up front, selected or not, so all of them count - note that
+    // fx1 and fx2 are separate instances of the same engine set. Memory-mapped
+    // sample data is excluded; it is backed by the files, not the budget.
+    // See {@ref core::engine::IEngine::memory_footprint}
+    std::vector<std::pair<std::string, std::size_t>> footprints;
+    auto add = [&](const char* group, const IEngine& engine) {
+      footprints.emplace_back(fmt::format("{}/{}", group, engine.name()), engine.memory_footprint());
+    };
+    synth.for_each_engine([&](const IEngine& e) { add("synth", e); });
+    synth2.for_each_engine([&](const IEngine& e) { add("synth2", e); });
+    arpeggiator.for_each_engine([&](const IEngine& e) { add("arp", e); });
+    effect1.for_each_engine([&](const IEngine& e) { add("fx1", e); });
+    effect2.for_each_engine([&](const IEngine& e) { add("fx2", e); });
+    add("send", synth_send);
+    add("send", line_in_send);
+    add("misc", looper);
+    add("misc", master);
+    add("misc", sequencer);
+
+    std::sort(footprints.begin(), footprints.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::size_t total = 0;
+    LOGI("Engine memory footprint:");
+    for (const auto& [name, bytes] : footprints) {
+      LOGI("  {:<24} {:>8} KB", name, bytes / 1024);
+      total += bytes;
+    }
+    LOGI("  {:<24} {:>8} KB", "total", total / 1024);
+    engine_memory_stats::total_kb.store(long(total / 1024), std::memory_order_relaxed);
+
+    // The routing declared once, as a graph. The process call below is the
+    // (hand-fused) executor of this schedule; the graph is what computes the
+    // buffer liveness up front, so the pool budget is checked at startup
+    // instead of discovered from the "Using N buffers" log under load. A
+    // routing change starts here - if the declared edges stop matching the
+    // chain, so will the logged schedule.
+    audio::RoutingGraph graph;
+    // The external input is the borrowed device buffer, not a pool slot
+    const int n_ext = graph.add_node("external", 0);
+    const int n_arp = graph.add_node("arp", 0);
+    const int n_synth = graph.add_node("synth", 1);
+    // In-place stages mix into their first input's buffers - fused passes
+    const int n_synth2 = graph.add_node("synth2", 1, true);
+    const int n_fx1_send = graph.add_node("fx1-send", 1);
+    const int n_fx2_send = graph.add_node("fx2-send", 1);
+    const int n_fx1 = graph.add_node("fx1", 2);
+    const int n_fx2 = graph.add_node("fx2", 2);
+    const int n_mix = graph.add_node("mix", 2, true);
+    const int n_sampler = graph.add_node("sampler", 1);
+    const int n_looper = graph.add_node("looper", 2, true);
+    const int n_master = graph.add_node("master", 2, true);
+    bool ok = graph.add_edge(n_arp, n_synth) && graph.add_edge(n_arp, n_synth2) &&
+              graph.add_edge(n_ext, n_synth) && graph.add_edge(n_ext, n_synth2) &&
+              graph.add_edge(n_synth, n_synth2) && graph.add_edge(n_synth2, n_fx1_send) &&
+              graph.add_edge(n_synth2, n_fx2_send) && graph.add_edge(n_fx1_send, n_fx1) &&
+              graph.add_edge(n_fx2_send, n_fx2) && graph.add_edge(n_fx1, n_mix) &&
+              graph.add_edge(n_fx2, n_mix) && graph.add_edge(n_synth2, n_mix) &&
+              graph.add_edge(n_sampler, n_mix) && graph.add_edge(n_mix, n_looper) &&
+              graph.add_edge(n_ext, n_looper) && graph.add_edge(n_looper, n_master);
+    ok = ok && graph.schedule();
+    OTTO_ASSERT(ok, "The routing graph must be well-formed and acyclic");
+    graph.log_schedule();
+    // The engines allocate their outputs from the same pool while the graph's
+    // buses are live, so the schedule's peak plus a concurrent stereo result
+    // must fit the hardcoded pool
+    OTTO_ASSERT(graph.peak_buffers() + 2 <= audio::AudioBufferPool::number_of_buffers,
+                "The declared routing needs more buffers than the pool holds");
+  }
 
   audio::ProcessData<2> DefaultEngineManager::process(audio::ProcessData<1> external_in)
   {
     // Main processor function
+    OTTO_TRACE_SCOPE("audio/process");
+    using Stage = audio_stage_timers::Stage;
+    // Catch allocations sneaking into the callback. Inactive unless armed
+    // from the debug ui - see {@ref rt_alloc_stats}
+    util::allocation_tracker::scope alloc_scope{rt_alloc_stats::track_audio.load(std::memory_order_relaxed), true};
+    // Shed or restore quality tiers based on the measured load - see
+    // {@ref Governor}
+    Governor::current().run();
     auto midi_in = external_in.midi_only();
     midi_in.clock = ClockManager::current().step_frames(external_in.nframes);
-    auto arp_out = arpeggiator->process(midi_in);
-    auto synth_out = synth->process(arp_out.with(external_in.audio));
-
-    auto fx1_bus = Application::current().audio_manager->buffer_pool().allocate();
-    auto fx2_bus = Application::current().audio_manager->buffer_pool().allocate();
+    // The dispatched stages go through EngineDispatcher::visit, which resolves the
+    // concrete engine type once per block - no virtual hop, and the compiler is free
+    // to inline the whole stage into this fixed chain.
+    auto arp_out = [&] {
+      audio_stage_timers::scoped timer{Stage::arp};
+      OTTO_TRACE_SCOPE("audio/arp");
+      return arpeggiator.visit([&](auto& engine) { return engine.process(midi_in); });
+    }();
+    auto nframes = external_in.nframes;
+
+    // The layer synth runs on the worker core concurrently with the main
+    // synth - the same fork/join as the fx stages, which only need the worker
+    // later in the chain. While the slot is off this whole stage vanishes.
+    const bool layer_active = synth2.current_idx() >= 0;
+    const int split_key = synth_send.props.split;
+    if (layer_active) {
+      layer_arena_.clear();
+      if (split_key > 0) {
+        // Split: note events below the split point move to the layer synth,
+        // the rest stays on the main one. Everything else goes to both
+        synth_arena_.clear();
+        for (auto& ev : arp_out.midi) {
+          const auto type = core::midi::MidiEvent::Type(ev.type);
+          const bool note =
+            type == core::midi::MidiEvent::Type::NoteOn || type == core::midi::MidiEvent::Type::NoteOff;
+          if (!note || ev.data0 >= split_key) synth_arena_.push_back(ev);
+          if (!note || ev.data0 < split_key) layer_arena_.push_back(ev);
+        }
+      } else {
+        // Layer: both synths see the full stream
+        for (auto& ev : arp_out.midi) layer_arena_.push_back(ev);
+      }
+    }
 
-    for (auto&& [snth, fx1, fx2] : util::zip(synth_out.audio, fx1_bus, fx2_bus)) {
-      fx1 = snth * synth_send.props.to_FX1;
-      fx2 = snth * synth_send.props.to_FX2;
+    std::optional<audio::ProcessData<1>> layer_result;
+    auto layer_job = [&] {
+      OTTO_TRACE_SCOPE("audio/synth2");
+      layer_result = synth2.visit([&](auto& engine) {
+        return engine.process({external_in.audio, core::midi::EventBuffer{layer_arena_}, midi_in.clock});
+      });
+    };
+    if (layer_active) fx_worker.submit([](void* p) { (*static_cast<decltype(layer_job)*>(p))(); }, &layer_job);
+
+    auto synth_out = [&] {
+      audio_stage_timers::scoped timer{Stage::synth};
+      OTTO_TRACE_SCOPE("audio/synth");
+      if (layer_active && split_key > 0) {
+        return synth.visit([&](auto& engine) {
+          return engine.process({external_in.audio, core::midi::EventBuffer{synth_arena_}, midi_in.clock});
+        });
+      }
+      return synth.visit([&](auto& engine) { return engine.process(arp_out.with(external_in.audio)); });
+    }();
+
+    if (layer_active) {
+      fx_worker.wait();
+      auto& layer_out = *layer_result;
+      const float layer_gain = synth_send.props.layer;
+      const float layer_from = layer_ramp_.step(layer_gain);
+      util::dsp::accumulate_scale_ramp(synth_out.audio.data(), layer_out.audio.data(), layer_from, layer_gain,
+                                       nframes);
+      layer_out.audio.release();
     }
+
+    auto& pool = Application::current().audio_manager->buffer_pool();
+    auto fx1_bus = pool.allocate();
+    auto fx2_bus = pool.allocate();
+    // One mean square of the synth output decides presence on both sends and the
+    // dry path - the send input is just this scaled by the send gain
+    const float synth_ms = util::dsp::mean_square(synth_out.audio.data(), nframes);
+    const float fx1_gain = synth_send.props.to_FX1;
+    const float fx2_gain = synth_send.props.to_FX2;
+    const bool skip_fx1 = fx1_bypass_.should_bypass(synth_ms * fx1_gain * fx1_gain);
+    const bool skip_fx2 = fx2_bypass_.should_bypass(synth_ms * fx2_gain * fx2_gain);
+
+    // The ramps step even when a stage is skipped, so a returning send doesn't
+    // ramp up from a stale level
+    const float fx1_from = fx1_send_ramp_.step(fx1_gain);
+    const float fx2_from = fx2_send_ramp_.step(fx2_gain);
+    if (!skip_fx1) util::dsp::copy_scale_ramp(fx1_bus.data(), synth_out.audio.data(), fx1_from, fx1_gain, nframes);
+    if (!skip_fx2) util::dsp::copy_scale_ramp(fx2_bus.data(), synth_out.audio.data(), fx2_from, fx2_gain, nframes);
     // Sequencer. Outputs L/R dry output and adds to fx busses.
     // auto seq_dry = sequencer.process(midi_in, fx1_bus, fx2_bus);
-    auto fx1_out = effect1->process(audio::ProcessData<1>(fx1_bus));
-    auto fx2_out = effect2->process(audio::ProcessData<1>(fx2_bus));
-    // Stereo output gathered in fx1_out
-    for (auto&& [snth, fx1L, fx1R, fx2L, fx2R] :
-         util::zip(synth_out.audio, fx1_out.audio[0], fx1_out.audio[1], fx2_out.audio[0], fx2_out.audio[1])) {
-      fx1L += fx2L + snth * synth_send.props.dry * (1 - synth_send.props.dry_pan);
-      fx1R += fx2R + snth * synth_send.props.dry * (1 + synth_send.props.dry_pan);
+    // The two effects consume independent send buses, so fx2 runs on the worker core
+    // while fx1 runs here. The job and its result live on this stack frame, which is
+    // kept alive past fx_worker.wait(). A bypassed stage is not run at all - its
+    // tanks freeze at inaudible levels until the send comes back.
+    std::optional<audio::ProcessData<2>> fx2_result;
+    auto fx2_job = [&] {
+      audio_stage_timers::scoped timer{Stage::fx2};
+      OTTO_TRACE_SCOPE("audio/fx2");
+      fx2_result = effect2.visit([&](auto& engine) { return engine.process(audio::ProcessData<1>(fx2_bus)); });
+    };
+    if (!skip_fx2) fx_worker.submit([](void* p) { (*static_cast<decltype(fx2_job)*>(p))(); }, &fx2_job);
+    auto fx1_out = [&]() -> audio::ProcessData<2> {
+      audio_stage_timers::scoped timer{Stage::fx1};
+      OTTO_TRACE_SCOPE("audio/fx1");
+      // A silent stereo pair stands in for the skipped stage - it doubles as the
+      // mix-down target below
+      if (skip_fx1) return audio::ProcessData<2>(pool.allocate_multi_clear<2>());
+      auto out = effect1.visit([&](auto& engine) { return engine.process(audio::ProcessData<1>(fx1_bus)); });
+      if (fx1_bypass_.decaying()) {
+        fx1_bypass_.observe_output(
+          std::max(util::dsp::mean_square(out.audio[0].data(), nframes),
+                   util::dsp::mean_square(out.audio[1].data(), nframes)));
+      }
+      return out;
+    }();
+    if (!skip_fx2) {
+      fx_worker.wait();
+      auto& fx2_out = *fx2_result;
+      if (fx2_bypass_.decaying()) {
+        fx2_bypass_.observe_output(
+          std::max(util::dsp::mean_square(fx2_out.audio[0].data(), nframes),
+                   util::dsp::mean_square(fx2_out.audio[1].data(), nframes)));
+      }
+      // Stereo output gathered in fx1_out
+      util::dsp::accumulate(fx1_out.audio[0].data(), fx2_out.audio[0].data(), nframes);
+      util::dsp::accumulate(fx1_out.audio[1].data(), fx2_out.audio[1].data(), nframes);
+      fx2_out.audio[0].release();
+      fx2_out.audio[1].release();
+    }
+    const float dry_l = synth_send.props.dry * (1 - synth_send.props.dry_pan);
+    const float dry_r = synth_send.props.dry * (1 + synth_send.props.dry_pan);
+    const float dry_l_from = dry_l_ramp_.step(dry_l);
+    const float dry_r_from = dry_r_ramp_.step(dry_r);
+    if (synth_ms > util::dsp::EffectBypass::threshold * util::dsp::EffectBypass::threshold) {
+      util::dsp::accumulate_scale_ramp(fx1_out.audio[0].data(), synth_out.audio.data(), dry_l_from, dry_l, nframes);
+      util::dsp::accumulate_scale_ramp(fx1_out.audio[1].data(), synth_out.audio.data(), dry_r_from, dry_r, nframes);
     }
     synth_out.audio.release();
-    fx2_out.audio[0].release();
-    fx2_out.audio[1].release();
     fx1_bus.release();
     fx2_bus.release();
 
-    auto smplr_out = sequencer.process(midi_in);
-    for (auto&& [resL, resR, smplr] : util::zip(fx1_out.audio[0], fx1_out.audio[1], smplr_out.audio)) {
-      resL += smplr;
-      resR += smplr;
-    }
-
-    return master.process(std::move(fx1_out));
+    auto smplr_out = [&] {
+      audio_stage_timers::scoped timer{Stage::sampler};
+      OTTO_TRACE_SCOPE("audio/sampler");
+      return sequencer.process(midi_in);
+    }();
+    util::dsp::accumulate(fx1_out.audio[0].data(), smplr_out.audio.data(), nframes);
+    util::dsp::accumulate(fx1_out.audio[1].data(), smplr_out.audio.data(), nframes);
+
+    // The looper taps the full post-fx mix plus the line input, and mixes its
+    // playback back in before the master stage
+    looper.process(fx1_out.audio[0].data(), fx1_out.audio[1].data(), external_in.audio.data(), nframes);
+
+    auto res = [&] {
+      audio_stage_timers::scoped timer{Stage::master};
+      OTTO_TRACE_SCOPE("audio/master");
+      return master.process(std::move(fx1_out));
+    }();
+    // Tap the master output for the disk recorder. Wait-free - drops and
+    // counts blocks when the writer falls behind
+    recorder.push(res.audio[0].data(), res.audio[1].data(), nframes);
+    rt_alloc_stats::audio_allocations.fetch_add(alloc_scope.allocations(), std::memory_order_relaxed);
+    audio_stage_timers::publish();
+    return res;
     /*
     auto temp = Application::current().audio_manager->buffer_pool().allocate_multi_clear<2>();
     for (auto&& [in, tmp] : util::zip(seq_out, temp)) {
@@ -0,0 +1,110 @@
+#include "governor.hpp"
+
+#include <algorithm>
+
+#include "services/audio_manager.hpp"
+
+namespace otto::services {
+
+  Governor& Governor::current() noexcept
+  {
+    static Governor instance;
+    return instance;
+  }
+
+  std::uint64_t Governor::register_tier(std::string name, int priority, float cost, Apply apply)
+  {
+    while (lock_.test_and_set(std::memory_order_acquire));
+    const auto token = next_token_++;
+    tiers_.push_back({token, std::move(name), priority, cost, std::move(apply)});
+    lock_.clear(std::memory_order_release);
+    return token;
+  }
+
+  void Governor::unregister_tier(std::uint64_t token)
+  {
+    while (lock_.test_and_set(std::memory_order_acquire));
+    auto found = std::find_if(tiers_.begin(), tiers_.end(), [&](const Tier& t) { return t.token == token; });
+    if (found != tiers_.end()) {
+      if (found->degraded) {
+        found->apply(false);
+        degraded_.fetch_sub(1, std::memory_order_relaxed);
+      }
+      tiers_.erase(found);
+      publish_shed();
+    }
+    lock_.clear(std::memory_order_release);
+  }
+
+  void Governor::enabled(bool e) noexcept
+  {
+    enabled_.store(e, std::memory_order_relaxed);
+    if (e) return;
+    while (lock_.test_and_set(std::memory_order_acquire));
+    for (auto& t : tiers_) {
+      if (!t.degraded) continue;
+      t.degraded = false;
+      t.apply(false);
+      degraded_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    publish_shed();
+    lock_.clear(std::memory_order_release);
+  }
+
+  void Governor::run() noexcept
+  {
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+    if (--cooldown_ > 0) return;
+    const float load = AudioManager::current().cpu_time();
+
+    if (load > degrade_threshold) {
+      // Close to the deadline - shed the lowest-priority tier still running,
+      // then hold off briefly so one slow buffer doesn't strip everything
+      while (lock_.test_and_set(std::memory_order_acquire));
+      Tier* next = nullptr;
+      for (auto& t : tiers_) {
+        if (t.degraded) continue;
+        if (next == nullptr || t.priority < next->priority) next = &t;
+      }
+      if (next != nullptr) {
+        next->degraded = true;
+        next->apply(true);
+        degraded_.fetch_add(1, std::memory_order_relaxed);
+        degrade_actions_.fetch_add(1, std::memory_order_relaxed);
+        publish_shed();
+      }
+      lock_.clear(std::memory_order_release);
+      cooldown_ = 16;
+    } else if (load < restore_threshold) {
+      // Plenty of headroom - bring the most valuable sacrifice back first,
+      // and grow back slowly
+      while (lock_.test_and_set(std::memory_order_acquire));
+      Tier* last = nullptr;
+      for (auto& t : tiers_) {
+        if (!t.degraded) continue;
+        if (last == nullptr || t.priority > last->priority) last = &t;
+      }
+      if (last != nullptr) {
+        last->degraded = false;
+        last->apply(false);
+        degraded_.fetch_sub(1, std::memory_order_relaxed);
+        restore_actions_.fetch_add(1, std::memory_order_relaxed);
+        publish_shed();
+      }
+      lock_.clear(std::memory_order_release);
+      cooldown_ = 64;
+    } else {
+      cooldown_ = 16;
+    }
+  }
+
+  void Governor::publish_shed() noexcept
+  {
+    float sum = 0;
+    for (const auto& t : tiers_) {
+      if (t.degraded) sum += t.cost;
+    }
+    shed_cost_pct_.store(int(sum * 100), std::memory_order_relaxed);
+  }
+
+} // namespace otto::services
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace otto::services {
+
+  /// Sheds quality instead of crackling when the audio thread runs out of
+  /// headroom.
+  ///
+  /// Owners of degradable work - voice managers, effect engines, the ui -
+  /// register a tier with a priority and a cost estimate. Once per block the
+  /// governor compares {@ref AudioManager::cpu_time} against a pair of
+  /// thresholds: above the upper one it degrades the cheapest-to-lose tier
+  /// still running, below the lower one it restores the most recently
+  /// sacrificed kind of tier. The gap between the thresholds and a per-step
+  /// cooldown keep the tiers from flapping on one slow buffer.
+  ///
+  /// Self-contained like {@ref Recorder} - no wiring in `Application`.
+  struct Governor {
+    /// The process-wide instance
+    static Governor& current() noexcept;
+
+    /// Tier switch callback - `true` degrades, `false` restores.
+    ///
+    /// Invoked from the audio thread, so it must be rt-safe: flip atomics or
+    /// adjust caps, never allocate or block
+    using Apply = std::function<void(bool degraded)>;
+
+    /// Register a degradation tier.
+    ///
+    /// Lower `priority` is sacrificed first. `cost` is the owner's estimate of
+    /// the fraction of the audio budget the degraded mode frees - display
+    /// only, the decisions go by measured load. Call during init, before audio
+    /// starts.
+    ///
+    /// \returns a token for {@ref unregister_tier}
+    std::uint64_t register_tier(std::string name, int priority, float cost, Apply apply);
+
+    /// Remove a tier, restoring it first if it is currently degraded
+    void unregister_tier(std::uint64_t token);
+
+    /// Enable or disable the governor. Disabling restores every degraded tier
+    void enabled(bool e) noexcept;
+    bool enabled() const noexcept
+    {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// Number of currently degraded tiers. Any thread
+    int degraded() const noexcept
+    {
+      return degraded_.load(std::memory_order_relaxed);
+    }
+
+    /// Summed cost estimates of the degraded tiers, for display. Any thread
+    float shed_cost() const noexcept
+    {
+      return shed_cost_pct_.load(std::memory_order_relaxed) / 100.f;
+    }
+
+    /// Times {@ref run} shed a tier over the session. Any thread
+    std::uint64_t degrade_actions() const noexcept
+    {
+      return degrade_actions_.load(std::memory_order_relaxed);
+    }
+
+    /// Times {@ref run} brought a tier back over the session. Any thread
+    std::uint64_t restore_actions() const noexcept
+    {
+      return restore_actions_.load(std::memory_order_relaxed);
+    }
+
+    /// Called once per block by the engine manager, on the audio thread
+    void run() noexcept;
+
+    Governor(const Governor&) = delete;
+
+  private:
+    Governor() = default;
+
+    struct Tier {
+      std::uint64_t token;
+      std::string name;
+      int priority;
+      float cost;
+      Apply apply;
+      bool degraded = false;
+    };
+
+    /// Load above which the next tier is shed, and below which the last one
+    /// comes back. The gap is the hysteresis that keeps tiers from flapping
+    static constexpr float degrade_threshold = 0.85f;
+    static constexpr float restore_threshold = 0.55f;
+
+    void publish_shed() noexcept;
+
+    /// Guards {@ref tiers_}. Registration happens during init and teardown, so
+    /// the audio thread only ever contends with itself - and only takes the
+    /// lock when the cooldown has expired, not every block
+    std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+    std::vector<Tier> tiers_;
+    std::uint64_t next_token_ = 1;
+    std::atomic<bool> enabled_ = true;
+    std::atomic<int> degraded_ = 0;
+    /// Summed degraded cost in whole percent
+    std::atomic<int> shed_cost_pct_ = 0;
+    /// Session action counters, for the session report
+    std::atomic<std::uint64_t> degrade_actions_ = 0;
+    std::atomic<std::uint64_t> restore_actions_ = 0;
+    /// Blocks left before the next decision - see {@ref run}
+    int cooldown_ = 0;
+  };
+
+} // namespace otto::services
@@ -1,5 +1,10 @@
 #include "log_manager.hpp"
+
+#include <chrono>
+
 #include "services/application.hpp"
+#include "services/profiler.hpp"
+#include "services/session_report.hpp"
 
 #define LOGURU_IMPLEMENTATION 1
 #include <loguru.hpp>
@@ -35,12 +40,48 @@ namespace otto::services {
                                    std::string(message.prefix) + message.message);
     });
 
+    _drain_thread = std::thread([this] { drain(); });
+
+    Profiler::start();
+    // Construct now, so the throttle listener catches the whole session
+    SessionReport::current();
+
     LOGI("LOGGING NOW");
     initialized = true;
   }
 
+  LogManager::~LogManager()
+  {
+    Profiler::stop();
+    Profiler::dump_all();
+    _running = false;
+    if (_drain_thread.joinable()) _drain_thread.join();
+  }
+
+  void LogManager::drain()
+  {
+    using namespace std::chrono_literals;
+    loguru::set_thread_name("log drain");
+    Record rec;
+    while (true) {
+      bool any = false;
+      while (_queue.try_pop(rec)) {
+        any = true;
+        loguru::log(rec.verbosity, rec.file, rec.line, "{}", rec.text.c_str());
+      }
+      if (int n = _dropped.exchange(0); n > 0) {
+        loguru::log(loguru::Verbosity_WARNING, __FILE__, __LINE__,
+                    "Log ring was full - dropped {} lines", n);
+      }
+      // Check after draining, so everything queued before shutdown is flushed
+      if (!_running.load(std::memory_order_relaxed)) break;
+      if (!any) std::this_thread::sleep_for(1ms);
+    }
+  }
+
   void LogManager::set_thread_name(const std::string& name)
   {
     loguru::set_thread_name(name.c_str());
+    Profiler::attach_this_thread(name.c_str());
   }
 } // namespace otto::services
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+
 #include "util/filesystem.hpp"
 
 #include "core/service.hpp"
@@ -8,7 +11,9 @@
 #include <debug_assert.hpp>
 #include <loguru.hpp>
 
+#include "util/lockfree_queue.hpp"
 #include "util/macros.hpp"
+#include "util/static_string.hpp"
 #include "services/application.hpp"
 
 namespace otto::services {
@@ -20,59 +25,135 @@ namespace otto::services {
                bool enable_console = true,
                const char* logFilePath = nullptr);
 
+    ~LogManager();
+
     /// Set how the current thread appears in the log
     void set_thread_name(const std::string& name);
+
+    /// A preformatted log line waiting for the drain thread
+    struct Record {
+      loguru::Verbosity verbosity = loguru::Verbosity_INFO;
+      const char* file = "";
+      unsigned line = 0;
+      util::static_string<192> text;
+    };
+
+    /// Format a log line inline and queue it for the drain thread.
+    ///
+    /// Wait-free: the line is formatted into inline storage and pushed onto a
+    /// lock-free ring, so this is safe near the audio deadline. If the ring
+    /// is full, the line is dropped and counted - the drain thread reports
+    /// the count once it catches up.
+    template<typename... Args>
+    static void async_log(loguru::Verbosity verbosity, const char* file, unsigned line, Args&&... args)
+    {
+      if (verbosity > loguru::current_verbosity_cutoff()) return;
+      if (!_queue.try_push(Record{verbosity, file, line, util::format_static<192>(args...)})) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+  private:
+    /// Drain thread body - forwards queued records to loguru
+    void drain();
+
+    /// Static, so lines queued before or after the service's lifetime are
+    /// still formatted and not lost (they are drained once the service runs)
+    static inline util::lockfree_queue<Record, 256> _queue;
+    static inline std::atomic<int> _dropped = 0;
+
+    std::atomic<bool> _running = {true};
+    std::thread _drain_thread;
   };
 
 } // namespace otto::services
 
-/// Shorthand to the loguru macro LOG_F(INFO, ...)
-#define LOGI(...) LOG_F(INFO, __VA_ARGS__)
-
-/// Shorthand to the loguru macro LOG_F(WARNING, ...)
-#define LOGW(...) LOG_F(WARNING, __VA_ARGS__)
+/// The format strings below all go through FMT_STRING: the literal is parsed
+/// at build time, so a placeholder/argument mismatch is a compile error
+/// instead of a runtime throw, and the hot log sites serialize their
+/// arguments with the precompiled format instead of re-parsing it per call.
+/// The format argument must therefore be a string literal - to log an
+/// existing string, write `LOGE("{}", str)`.
+
+/// Log asynchronously: format inline, queue for the drain thread.
+/// Wait-free, so usable near the audio deadline
+#define LOGI(Fmt, ...)                                                                             \
+  ::otto::services::LogManager::async_log(loguru::Verbosity_INFO, __FILE__, __LINE__,              \
+                                          FMT_STRING(Fmt), ##__VA_ARGS__)
+
+/// Log asynchronously: format inline, queue for the drain thread.
+/// Wait-free, so usable near the audio deadline
+#define LOGW(Fmt, ...)                                                                             \
+  ::otto::services::LogManager::async_log(loguru::Verbosity_WARNING, __FILE__, __LINE__,           \
+                                          FMT_STRING(Fmt), ##__VA_ARGS__)
 
 /// Shorthand to the loguru macro LOG_F(ERROR, ...)
-#define LOGE(...) LOG_F(ERROR, __VA_ARGS__)
+///
+/// Errors stay synchronous - they often precede a throw or crash, and must
+/// hit the log before it. The line is preformatted with the compile-time
+/// format, so loguru only sees finished text
+#define LOGE(Fmt, ...)                                                                             \
+  LOG_F(ERROR, "{}", ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro LOG_F(FATAL, ...)
-#define LOGF(...) LOG_F(FATAL, __VA_ARGS__)
+#define LOGF(Fmt, ...)                                                                             \
+  LOG_F(FATAL, "{}", ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_F(INFO, ...)
-#define DLOGI(...) DLOG_F(INFO, __VA_ARGS__)
+#define DLOGI(Fmt, ...)                                                                            \
+  DLOG_F(INFO, "{}", ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_F(WARNING, ...)
-#define DLOGW(...) DLOG_F(WARNING, __VA_ARGS__)
+#define DLOGW(Fmt, ...)                                                                            \
+  DLOG_F(WARNING, "{}", ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_F(ERROR, ...)
-#define DLOGE(...) DLOG_F(ERROR, __VA_ARGS__)
+#define DLOGE(Fmt, ...)                                                                            \
+  DLOG_F(ERROR, "{}", ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_F(FATAL, ...)
-#define DLOGF(...) DLOG_F(FATAL, __VA_ARGS__)
+#define DLOGF(Fmt, ...)                                                                            \
+  DLOG_F(FATAL, "{}", ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
-/// Shorthand to the loguru macro LOG_IF_F(INFO, ...)
-#define LOGI_IF(...) LOG_IF_F(INFO, __VA_ARGS__)
+/// Shorthand to the loguru macro LOG_IF_F(INFO, ...). The message is only
+/// formatted when `Cond` holds - it sits inside loguru's conditional
+#define LOGI_IF(Cond, Fmt, ...)                                                                    \
+  LOG_IF_F(INFO, Cond, "{}", ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro LOG_IF_F(WARNING, ...)
-#define LOGW_IF(...) LOG_IF_F(WARNING, __VA_ARGS__)
+#define LOGW_IF(Cond, Fmt, ...)                                                                    \
+  LOG_IF_F(WARNING, Cond, "{}",                                                                    \
+           ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro LOG_IF_F(ERROR, ...)
-#define LOGE_IF(...) LOG_IF_F(ERROR, __VA_ARGS__)
+#define LOGE_IF(Cond, Fmt, ...)                                                                    \
+  LOG_IF_F(ERROR, Cond, "{}",                                                                      \
+           ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro LOG_IF_F(FATAL, ...)
-#define LOGF_IF(...) LOG_IF_F(FATAL, __VA_ARGS__)
+#define LOGF_IF(Cond, Fmt, ...)                                                                    \
+  LOG_IF_F(FATAL, Cond, "{}",                                                                      \
+           ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_IF_F(INFO, ...)
-#define DLOGI_IF(...) DLOG_IF_F(INFO, __VA_ARGS__)
+#define DLOGI_IF(Cond, Fmt, ...)                                                                   \
+  DLOG_IF_F(INFO, Cond, "{}",                                                                      \
+            ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_IF_F(WARNING, ...)
-#define DLOGW_IF(...) DLOG_IF_F(WARNING, __VA_ARGS__)
+#define DLOGW_IF(Cond, Fmt, ...)                                                                   \
+  DLOG_IF_F(WARNING, Cond, "{}",                                                                   \
+            ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_IF_F(ERROR, ...)
-#define DLOGE_IF(...) DLOG_IF_F(ERROR, __VA_ARGS__)
+#define DLOGE_IF(Cond, Fmt, ...)                                                                   \
+  DLOG_IF_F(ERROR, Cond, "{}",                                                                     \
+            ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro DLOG_IF_F(FATAL, ...)
-#define DLOGF_IF(...) DLOG_IF_F(FATAL, __VA_ARGS__)
+#define DLOGF_IF(Cond, Fmt, ...)                                                                   \
+  DLOG_IF_F(FATAL, Cond, "{}",                                                                     \
+            ::otto::util::format_static<256>(FMT_STRING(Fmt), ##__VA_ARGS__).c_str())
 
 /// Shorthand to the loguru macro LOG_SCOPE_F(INFO, ...)
 #define LOGI_SCOPE(...) LOG_SCOPE_F(INFO, __VA_ARGS__)
@@ -106,7 +187,10 @@ namespace otto {
                        Args&&... args) noexcept
     {
       if constexpr (sizeof...(args) > 0) {
-        LOGE("Assertion failed at {}:{}: {} {}", loc.file_name, loc.line_number, expression, fmt::format(args...));
+        // Format the message inline - asserts may fire on the audio thread,
+        // where an allocating fmt::format is the last thing we want
+        LOGE("Assertion failed at {}:{}: {} {}", loc.file_name, loc.line_number, expression,
+             util::format_static<256>(args...).c_str());
       } else {
         LOGE("Assertion failed at {}:{}: {}", loc.file_name, loc.line_number, expression);
       }
@@ -1,6 +1,14 @@
 #include "preset_manager.hpp"
 
+#include <cmath>
+#include <future>
+
 #include "services/debug_ui.hpp"
+#include "services/task_pool.hpp"
+#include "util/dir_index.hpp"
+#include "util/dsp/mix_kernels.hpp"
+#include "util/math.hpp"
+#include "util/symbol.hpp"
 
 namespace otto::services {
 
@@ -8,7 +16,9 @@ namespace otto::services {
 
     /// Initialize preset manager
     ///
-    /// \effects `load_preset_files()`
+    /// \effects Starts `load_preset_files()` on the task pool, so the
+    /// disk scan overlaps the rest of service construction and audio startup.
+    /// Accessors join the scan on first use.
     DefaultPresetManager();
 
     /// Get the names of presets for an engine
@@ -61,6 +71,13 @@ namespace otto::services {
                        std::string_view preset_name,
                        const nlohmann::json& preset_data) override;
 
+    /// The stored data of preset `idx`, as it would be passed to `from_json`
+    ///
+    /// \throws @ref exception with @ref ErrorCode::no_such_preset if no matching
+    /// preset was found, or @ref ErrorCode::no_such_engine if no matching engine
+    /// was found
+    const nlohmann::json& preset_data(util::string_ref engine_name, int idx) override;
+
   private:
 
     /// (Re)load preset files
@@ -70,33 +87,166 @@ namespace otto::services {
     /// \throws @ref filesystem::filesystem_error
     void load_preset_files();
 
+    /// Insert or replace a preset in the in-memory store
+    void insert_preset(const std::string& engine, const std::string& name, nlohmann::json&& props);
+
+    /// Join the background preset scan. Called by every public accessor
+    /// before touching `_preset_data`
+    void wait_for_load();
+
     struct PresetNamesDataPair {
       std::vector<std::string> names;
       std::vector<nlohmann::json> data;
     };
 
-    // Key is engine name.
+    // Key is the interned engine name, so the per-keypress lookups from the
+    // selector are integer compares.
     // This design is chosen because we want to expose the names vector
     // separately.
-    foonathan::array::flat_map<std::string, PresetNamesDataPair> _preset_data;
+    foonathan::array::flat_map<util::Symbol, PresetNamesDataPair> _preset_data;
 
     const fs::path presets_dir = Application::current().data_dir / "presets";
+
+    /// The background scan started by the constructor. Only touched through
+    /// {@ref wait_for_load} after construction
+    std::future<void> _load_task;
   };
 
   std::unique_ptr<PresetManager> PresetManager::create_default() {
     return std::make_unique<DefaultPresetManager>();
   }
 
+  // PresetMorph ///////////////////////////////////////////////////////////////
+
+  namespace {
+    /// Descend into `j` along a registry name like `props/filter`, or nullptr
+    /// if the preset doesn't contain that path
+    const nlohmann::json* resolve_path(const nlohmann::json& j, util::Symbol name)
+    {
+      const nlohmann::json* cur = &j;
+      std::string_view path = name.c_str();
+      while (!path.empty()) {
+        const auto slash = path.find('/');
+        const auto segment = path.substr(0, slash);
+        if (!cur->is_object()) return nullptr;
+        const auto found = cur->find(std::string(segment));
+        if (found == cur->end()) return nullptr;
+        cur = &*found;
+        path = slash == std::string_view::npos ? std::string_view() : path.substr(slash + 1);
+      }
+      return cur;
+    }
+  } // namespace
+
+  bool PresetMorph::setup(core::engine::IEngine& engine, const nlohmann::json& a, const nlohmann::json& b)
+  {
+    clear();
+    auto* reg = engine.registry();
+    if (reg == nullptr) return false;
+    setup(*reg, a, b);
+    return true;
+  }
+
+  void PresetMorph::setup(core::props::PropertyRegistry& registry, const nlohmann::json& a, const nlohmann::json& b)
+  {
+    clear();
+    // The current values are the fallback endpoints for props a preset omits
+    registry.snapshot();
+
+    _float_a.resize(registry.floats.size());
+    _float_b.resize(registry.floats.size());
+    for (int i = 0; i < registry.floats.size(); i++) {
+      const auto* va = resolve_path(a, registry.floats.names[i]);
+      const auto* vb = resolve_path(b, registry.floats.names[i]);
+      _float_a[i] = va && va->is_number() ? va->get<float>() : registry.floats.values[i];
+      _float_b[i] = vb && vb->is_number() ? vb->get<float>() : registry.floats.values[i];
+    }
+    _int_a.resize(registry.ints.size());
+    _int_b.resize(registry.ints.size());
+    for (int i = 0; i < registry.ints.size(); i++) {
+      const auto* va = resolve_path(a, registry.ints.names[i]);
+      const auto* vb = resolve_path(b, registry.ints.names[i]);
+      _int_a[i] = va && va->is_number() ? va->get<int>() : registry.ints.values[i];
+      _int_b[i] = vb && vb->is_number() ? vb->get<int>() : registry.ints.values[i];
+    }
+    _bool_a.resize(registry.bools.size());
+    _bool_b.resize(registry.bools.size());
+    for (int i = 0; i < registry.bools.size(); i++) {
+      const auto* va = resolve_path(a, registry.bools.names[i]);
+      const auto* vb = resolve_path(b, registry.bools.names[i]);
+      _bool_a[i] = char(va && va->is_boolean() ? va->get<bool>() : bool(registry.bools.values[i]));
+      _bool_b[i] = char(vb && vb->is_boolean() ? vb->get<bool>() : bool(registry.bools.values[i]));
+    }
+    _registry = &registry;
+  }
+
+  void PresetMorph::move_to(float position)
+  {
+    if (_registry == nullptr) return;
+    const float t = util::math::clamp(position, 0.f, 1.f);
+    auto& reg = *_registry;
+    // Floats: one vector lerp over the whole bank
+    util::dsp::lerp(reg.floats.values.data(), _float_a.data(), _float_b.data(), t, _float_a.size());
+    // Ints: round-to-nearest lerp, so steps distribute evenly over the travel
+    for (std::size_t i = 0; i < _int_a.size(); i++) {
+      reg.ints.values[i] = _int_a[i] + int(std::floor(t * float(_int_b[i] - _int_a[i]) + 0.5f));
+    }
+    // Bools: switch at the halfway point
+    for (std::size_t i = 0; i < _bool_a.size(); i++) {
+      reg.bools.values[i] = (t < 0.5f ? _bool_a[i] : _bool_b[i]) != 0;
+    }
+    // Hooks and change signals run here, so engine-side snapshots and screens
+    // see the morphed frame like any other edit
+    reg.apply();
+  }
+
+  void PresetMorph::clear() noexcept
+  {
+    _registry = nullptr;
+  }
+
+  void PresetManager::morph_presets(core::engine::IEngine& engine, int idx_a, int idx_b)
+  {
+    const auto& a = preset_data(engine.name(), idx_a);
+    const auto& b = preset_data(engine.name(), idx_b);
+    if (!_morph.setup(engine, a, b)) {
+      DLOGI("Engine '{}' has no registered props to morph", engine.name());
+    }
+  }
+
+  void PresetManager::morph_position(float position)
+  {
+    _morph.move_to(position);
+  }
+
+  void PresetManager::end_morph() noexcept
+  {
+    _morph.clear();
+  }
+
   DefaultPresetManager::DefaultPresetManager()
   {
-    load_preset_files();
+    // The scan only touches _preset_data, which nothing reads until engines
+    // start applying presets - well after the audio stack is up. Boot-to-sound
+    // no longer waits for the preset directory.
+    _load_task = TaskPool::current().push([this] { load_preset_files(); });
+  }
+
+  void DefaultPresetManager::wait_for_load()
+  {
+    // get() also rethrows a failed scan here, on the thread that asked for
+    // the data, instead of losing it on the background thread
+    if (_load_task.valid()) _load_task.get();
   }
 
   const std::vector<std::string>& DefaultPresetManager::preset_names(util::string_ref engine_name)
   {
-    auto eg_found = _preset_data.find(engine_name);
+    wait_for_load();
+    // Engine names are a small fixed set, so interning on first sight is fine
+    auto key = util::Symbol(engine_name);
+    auto eg_found = _preset_data.find(key);
     if (eg_found == _preset_data.end()) {
-      eg_found = _preset_data.insert(std::string(engine_name), PresetNamesDataPair{}).iter();
+      eg_found = _preset_data.insert(key, PresetNamesDataPair{}).iter();
     }
     return eg_found->value.names;
   }
@@ -126,7 +276,8 @@ namespace otto::services {
                                    std::string_view name,
                                    bool no_enable_callback)
   {
-    auto pd_iter = _preset_data.find(engine.name());
+    wait_for_load();
+    auto pd_iter = _preset_data.find(util::Symbol::lookup(engine.name()));
     if (pd_iter == _preset_data.end()) {
       throw exception(ErrorCode::no_such_engine, "No engine named '{}'", engine.name());
     }
@@ -143,7 +294,8 @@ namespace otto::services {
 
   void DefaultPresetManager::apply_preset(core::engine::IEngine& engine, int idx, bool no_enable_callback)
   {
-    auto pd_iter = _preset_data.find(engine.name());
+    wait_for_load();
+    auto pd_iter = _preset_data.find(util::Symbol::lookup(engine.name()));
     if (pd_iter == _preset_data.end()) {
       throw exception(ErrorCode::no_such_engine, "No engine named '{}'", engine.name());
     }
@@ -161,6 +313,21 @@ namespace otto::services {
     engine.current_preset(idx);
   }
 
+  const nlohmann::json& DefaultPresetManager::preset_data(util::string_ref engine_name, int idx)
+  {
+    wait_for_load();
+    auto pd_iter = _preset_data.find(util::Symbol::lookup(engine_name));
+    if (pd_iter == _preset_data.end()) {
+      throw exception(ErrorCode::no_such_engine, "No engine named '{}'", engine_name);
+    }
+    auto& pd = pd_iter->value;
+    if (idx < 0 || static_cast<std::size_t>(idx) >= pd.data.size()) {
+      throw exception(ErrorCode::no_such_preset, "Preset index {} is out range for engine '{}'",
+                      idx, engine_name);
+    }
+    return pd.data[idx];
+  }
+
   void DefaultPresetManager::load_preset_files()
   {
     LOG_SCOPE_FUNCTION(INFO);
@@ -169,27 +336,32 @@ namespace otto::services {
       fs::create_directories(presets_dir);
     }
     DLOGI("Loading presets");
-    for (auto&& de : fs::recursive_directory_iterator(presets_dir)) {
-      if (de.is_directory()) continue;
-      auto filename = de.path().filename().string();
-      if (filename.size() == 0 || filename.c_str()[0] == '.') continue;
-      LOGI_SCOPE("Loading preset file {}", de.path());
-      if (de.is_regular_file() || de.is_symlink()) {
-        util::JsonFile jf{de.path()};
-        jf.read();
-        std::string engine = jf.data()["engine"];
-        std::string name = jf.data()["name"];
-        auto pd_iter = _preset_data.emplace(engine).iter();
-        auto& pd = pd_iter->value;
-        if (auto found = util::find(pd.names, name); found != pd.names.end()) {
-          pd.data[found - pd.names.begin()] = std::move(jf.data()["props"]);
-          DLOGI("Reloaded preset '{}' for engine '{}", name, engine);
-        } else {
-          pd.names.push_back(name);
-          pd.data.emplace_back(std::move(jf.data()["props"]));
-          DLOGI("Loaded preset '{}' for engine '{}", name, engine);
-        }
-      }
+    // One readdir pass per directory instead of a stat per entry, and repeat
+    // scans are served from the cached index
+    for (auto&& file : util::scan_tree(presets_dir)) {
+      auto path = presets_dir / file;
+      LOGI_SCOPE("Loading preset file {}", path);
+      util::JsonFile jf{path};
+      jf.read();
+      std::string engine = jf.data()["engine"];
+      std::string name = jf.data()["name"];
+      insert_preset(engine, name, std::move(jf.data()["props"]));
+    }
+  }
+
+  void DefaultPresetManager::insert_preset(const std::string& engine,
+                                           const std::string& name,
+                                           nlohmann::json&& props)
+  {
+    auto pd_iter = _preset_data.emplace(util::Symbol(engine)).iter();
+    auto& pd = pd_iter->value;
+    if (auto found = util::find(pd.names, name); found != pd.names.end()) {
+      pd.data[found - pd.names.begin()] = std::move(props);
+      DLOGI("Reloaded preset '{}' for engine '{}", name, engine);
+    } else {
+      pd.names.push_back(name);
+      pd.data.emplace_back(std::move(props));
+      DLOGI("Loaded preset '{}' for engine '{}", name, engine);
     }
   }
 
@@ -198,6 +370,7 @@ namespace otto::services {
                                     const nlohmann::json& preset_data)
   {
     LOG_SCOPE_FUNCTION(INFO);
+    wait_for_load();
     util::JsonFile jf{presets_dir / engine_name.c_str() / (std::string(preset_name) + ".json")};
 
     jf.data() = nlohmann::json::object();
@@ -207,7 +380,9 @@ namespace otto::services {
 
     jf.write(util::JsonFile::OpenOptions::create);
 
-    load_preset_files();
+    // Update the in-memory store directly instead of re-reading every preset
+    // file - saving a preset shouldn't hitch on a full rescan
+    insert_preset(std::string(engine_name), std::string(preset_name), std::move(jf.data()["props"]));
   }
 
 } // namespace otto::services
@@ -8,6 +8,54 @@
 
 namespace otto::services {
 
+  /// Interpolates an engine between two presets.
+  ///
+  /// {@ref setup} resolves both presets' values against the engine's
+  /// {@ref otto::core::props::PropertyRegistry} once, into contiguous
+  /// endpoint arrays per type bank. {@ref move_to} is then one SIMD lerp
+  /// over the float bank plus scalar walks over the (typically tiny) int and
+  /// bool banks, written back through the registry - cost is O(props) with
+  /// vector width, and no allocation happens after setup, so it can run on
+  /// every encoder event. The write-back runs the usual property hooks and
+  /// change signals, so engines that mirror their props through a
+  /// {@ref otto::core::props::Snapshot} pick the morphed frame up through the
+  /// triple buffer like any other edit.
+  ///
+  /// Usually driven through {@ref PresetManager::morph_presets} and
+  /// {@ref PresetManager::morph_position}
+  struct PresetMorph {
+    /// Load the two endpoint presets for `engine`.
+    ///
+    /// Properties missing from a preset keep their current value at that
+    /// endpoint. Allocates - not for the audio thread.
+    ///
+    /// \returns false (leaving the morph inactive) if the engine has no
+    /// registered props
+    bool setup(core::engine::IEngine& engine, const nlohmann::json& a, const nlohmann::json& b);
+
+    /// As above, over a registry directly
+    void setup(core::props::PropertyRegistry& registry, const nlohmann::json& a, const nlohmann::json& b);
+
+    /// Move to `position` in `[0, 1]` between the endpoints, and write the
+    /// interpolated values to the engine. Allocation free
+    void move_to(float position);
+
+    /// Drop the endpoints and the registry pointer
+    void clear() noexcept;
+
+    bool active() const noexcept
+    {
+      return _registry != nullptr;
+    }
+
+  private:
+    core::props::PropertyRegistry* _registry = nullptr;
+    std::vector<float> _float_a, _float_b;
+    std::vector<int> _int_a, _int_b;
+    // char, not bool - contiguous and addressable
+    std::vector<char> _bool_a, _bool_b;
+  };
+
   struct PresetManager : core::Service {
     /// Error codes. Thrown with exceptions
     enum struct ErrorCode {
@@ -68,8 +116,34 @@ namespace otto::services {
                                std::string_view preset_name,
                                const nlohmann::json& preset_data) = 0;
 
+    /// The stored data of preset `idx`, as it would be passed to `from_json`
+    ///
+    /// \throws @ref exception with @ref ErrorCode::no_such_preset if no matching
+    /// preset was found, or @ref ErrorCode::no_such_engine if no matching engine
+    /// was found
+    virtual const nlohmann::json& preset_data(util::string_ref engine_name, int idx) = 0;
+
+    /// Start morphing `engine` between presets `idx_a` and `idx_b`.
+    ///
+    /// Resolves the preset data into the engine's prop registry - see
+    /// {@ref PresetMorph}. Allocates; call from the UI thread.
+    ///
+    /// \throws like @ref preset_data
+    void morph_presets(core::engine::IEngine& engine, int idx_a, int idx_b);
+
+    /// Move the active morph to `position` in `[0, 1]`.
+    ///
+    /// Allocation free - safe to call on every encoder event. Does nothing if
+    /// no morph is active
+    void morph_position(float position);
+
+    /// End the active morph, leaving the engine at its last position
+    void end_morph() noexcept;
+
     static std::unique_ptr<PresetManager> create_default();
 
+  private:
+    PresetMorph _morph;
   };
 
 } // namespace otto::services
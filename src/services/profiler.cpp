@@ -0,0 +1,187 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+
+// Linux headers
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include "services/application.hpp"
+#include "services/log_manager.hpp"
+#include "util/static_string.hpp"
+
+namespace otto::services {
+
+  namespace {
+
+    struct ThreadProfile {
+      util::static_string<32> name;
+      std::atomic<std::uint64_t> samples = {0};
+      /// Samples dropped because the table was full
+      std::atomic<std::uint64_t> dropped = {0};
+      std::array<std::atomic<std::uintptr_t>, Profiler::table_size> pc = {};
+      std::array<std::atomic<std::uint64_t>, Profiler::table_size> count = {};
+    };
+
+    std::array<ThreadProfile, Profiler::max_threads> threads;
+    std::atomic<int> attached_count = {0};
+    bool running = false;
+
+    /// The calling thread's profile slot. Set by attach, read by the handler
+    thread_local ThreadProfile* this_thread_profile = nullptr;
+
+    std::uintptr_t pc_of(void* uctx) noexcept
+    {
+      auto* ctx = static_cast<ucontext_t*>(uctx);
+#if defined(__aarch64__)
+      return std::uintptr_t(ctx->uc_mcontext.pc);
+#elif defined(__arm__)
+      return std::uintptr_t(ctx->uc_mcontext.arm_pc);
+#elif defined(__x86_64__)
+      return std::uintptr_t(ctx->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__i386__)
+      return std::uintptr_t(ctx->uc_mcontext.gregs[REG_EIP]);
+#else
+      return 0;
+#endif
+    }
+
+    /// Everything in here must be async signal safe: no allocation, no locks.
+    /// The table is open-addressed with linear probing, and only ever written
+    /// by the thread the signal landed on
+    void sigprof_handler(int, siginfo_t*, void* uctx)
+    {
+      auto* tp = this_thread_profile;
+      if (tp == nullptr) return;
+      auto pc = pc_of(uctx);
+      if (pc == 0) return;
+      tp->samples.fetch_add(1, std::memory_order_relaxed);
+      auto idx = (pc >> 2) & (Profiler::table_size - 1);
+      for (int probe = 0; probe < 32; probe++) {
+        auto slot = (idx + probe) & (Profiler::table_size - 1);
+        auto cur = tp->pc[slot].load(std::memory_order_relaxed);
+        if (cur == 0) {
+          tp->pc[slot].store(pc, std::memory_order_relaxed);
+          cur = pc;
+        }
+        if (cur == pc) {
+          tp->count[slot].fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+      }
+      tp->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::string symbolize(std::uintptr_t pc)
+    {
+      Dl_info info = {};
+      if (dladdr(reinterpret_cast<void*>(pc), &info) && info.dli_sname != nullptr) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr) {
+          std::string res = demangled;
+          free(demangled);
+          return res;
+        }
+        return info.dli_sname;
+      }
+      return fmt::format("{:#x}", pc);
+    }
+
+  } // namespace
+
+  void Profiler::start() noexcept
+  {
+    if (running) return;
+
+    struct sigaction sa = {};
+    sa.sa_sigaction = sigprof_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, nullptr) != 0) return;
+
+    itimerval timer = {};
+    timer.it_interval.tv_usec = 1000000 / sample_hz;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) return;
+
+    running = true;
+  }
+
+  void Profiler::stop() noexcept
+  {
+    if (!running) return;
+    itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    running = false;
+  }
+
+  void Profiler::attach_this_thread(const char* name) noexcept
+  {
+    if (this_thread_profile != nullptr) {
+      // Renamed - keep the slot, update the label
+      this_thread_profile->name.assign(name);
+      return;
+    }
+    auto index = attached_count.fetch_add(1, std::memory_order_relaxed);
+    if (index >= max_threads) {
+      attached_count.store(max_threads, std::memory_order_relaxed);
+      return;
+    }
+    threads[index].name.assign(name);
+    this_thread_profile = &threads[index];
+  }
+
+  int Profiler::thread_count() noexcept
+  {
+    return std::min(attached_count.load(std::memory_order_relaxed), max_threads);
+  }
+
+  const char* Profiler::thread_name(int index) noexcept
+  {
+    return threads[index].name.c_str();
+  }
+
+  std::vector<Profiler::Entry> Profiler::flat_profile(int index, int max_entries)
+  {
+    auto& tp = threads[index];
+    std::vector<std::pair<std::uintptr_t, std::uint64_t>> raw;
+    for (int i = 0; i < table_size; i++) {
+      auto pc = tp.pc[i].load(std::memory_order_relaxed);
+      if (pc == 0) continue;
+      raw.emplace_back(pc, tp.count[i].load(std::memory_order_relaxed));
+    }
+    std::sort(raw.begin(), raw.end(), [](auto& a, auto& b) { return a.second > b.second; });
+    if (int(raw.size()) > max_entries) raw.resize(max_entries);
+
+    std::vector<Entry> res;
+    res.reserve(raw.size());
+    for (auto& [pc, count] : raw) res.push_back({symbolize(pc), count});
+    return res;
+  }
+
+  void Profiler::dump_all()
+  {
+    auto path = Application::current().data_dir / "profile.txt";
+    std::ofstream file(path.c_str());
+    for (int t = 0; t < thread_count(); t++) {
+      auto& tp = threads[t];
+      file << fmt::format("== {} ({} samples, {} dropped)\n", tp.name.c_str(),
+                          tp.samples.load(std::memory_order_relaxed),
+                          tp.dropped.load(std::memory_order_relaxed));
+      for (auto& entry : flat_profile(t)) {
+        file << fmt::format("{:>8}  {}\n", entry.count, entry.symbol);
+      }
+      file << '\n';
+    }
+    LOGI("Wrote flat profiles to {}", path.c_str());
+  }
+
+} // namespace otto::services
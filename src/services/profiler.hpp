@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace otto::services {
+
+  /// A lightweight flat sampling profiler.
+  ///
+  /// A SIGPROF timer fires at \ref sample_hz while the process consumes cpu
+  /// time, and the signal handler records the interrupted program counter in
+  /// a per-thread lock-free histogram. That makes the steady-state cost one
+  /// signal delivery and a few atomic ops per sample - cheap enough to leave
+  /// on in production builds, unlike attaching perf after the fact.
+  ///
+  /// Threads are attached when they are named through
+  /// `LogManager::set_thread_name`, so the audio, logic and drain threads
+  /// show up under the names they already log with. \ref flat_profile()
+  /// returns the symbolized top entries for rendering in the debug ui, and
+  /// \ref dump_all() writes the per-thread profiles to `data/profile.txt`.
+  struct Profiler {
+    /// Maximum number of attached threads
+    static constexpr int max_threads = 8;
+    /// Histogram slots per thread. Must be a power of two
+    static constexpr int table_size = 1024;
+    /// Sample rate. A prime, so sampling does not lock onto the audio block
+    /// rate and always hit the same code
+    static constexpr int sample_hz = 97;
+
+    /// One line of a flat profile
+    struct Entry {
+      std::string symbol;
+      std::uint64_t count = 0;
+    };
+
+    /// Install the signal handler and start the sampling timer
+    static void start() noexcept;
+
+    /// Stop the sampling timer
+    static void stop() noexcept;
+
+    /// Attach the calling thread to a profile slot.
+    ///
+    /// Called by `LogManager::set_thread_name` - samples on unattached
+    /// threads are ignored.
+    static void attach_this_thread(const char* name) noexcept;
+
+    /// Number of attached threads
+    static int thread_count() noexcept;
+
+    /// The name the thread at `index` was attached with
+    static const char* thread_name(int index) noexcept;
+
+    /// The `max_entries` hottest symbols sampled on the thread at `index`,
+    /// sorted by sample count. Callable from any thread
+    static std::vector<Entry> flat_profile(int index, int max_entries = 32);
+
+    /// Write every thread's flat profile to `data/profile.txt`
+    static void dump_all();
+  };
+
+} // namespace otto::services
@@ -0,0 +1,164 @@
+#include "recorder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+#include "services/application.hpp"
+#include "services/audio_manager.hpp"
+#include "services/debug_ui.hpp"
+#include "services/log_manager.hpp"
+
+namespace otto::services {
+
+  Recorder& Recorder::current() noexcept
+  {
+    static Recorder instance;
+    return instance;
+  }
+
+  Recorder::Recorder()
+    : writer_thread_([this](auto&&) {
+        while (writer_thread_.running()) {
+          writer_tick();
+          writer_thread_.sleep_for(chrono::milliseconds(100));
+        }
+        // Flush whatever is still buffered on shutdown
+        armed_.store(false, std::memory_order_relaxed);
+        drain(true);
+        close_take();
+      })
+  {}
+
+  void Recorder::start_take()
+  {
+    auto expected = State::idle;
+    if (!state_.compare_exchange_strong(expected, State::starting, std::memory_order_release)) return;
+    writer_thread_.trigger();
+  }
+
+  void Recorder::stop_take()
+  {
+    // Disarm first, so the audio thread stops pushing before the final drain
+    armed_.store(false, std::memory_order_release);
+    auto expected = State::recording;
+    if (!state_.compare_exchange_strong(expected, State::stopping, std::memory_order_release)) {
+      expected = State::starting;
+      state_.compare_exchange_strong(expected, State::stopping, std::memory_order_release);
+    }
+    writer_thread_.trigger();
+  }
+
+  void Recorder::push(const float* l, const float* r, int nframes) noexcept
+  {
+    if (!armed_.load(std::memory_order_relaxed)) return;
+    const auto n = 2 * std::size_t(nframes);
+    const auto head = head_.load(std::memory_order_relaxed);
+    const auto tail = tail_.load(std::memory_order_acquire);
+    if (ring_size - (head - tail) < n) {
+      // Never block on the writer - drop the whole block and count it
+      recorder_stats::frames_dropped.fetch_add(nframes, std::memory_order_relaxed);
+      return;
+    }
+    for (int i = 0; i < nframes; i++) {
+      ring_[(head + 2 * i) & (ring_size - 1)] = l[i];
+      ring_[(head + 2 * i + 1) & (ring_size - 1)] = r[i];
+    }
+    head_.store(head + n, std::memory_order_release);
+  }
+
+  void Recorder::writer_tick()
+  {
+    switch (state_.load(std::memory_order_acquire)) {
+      case State::idle: return;
+      case State::starting: {
+        if (!open_take()) {
+          state_.store(State::idle, std::memory_order_release);
+          return;
+        }
+        // A stop can have arrived while the file was opening - only arm if not
+        auto expected = State::starting;
+        if (state_.compare_exchange_strong(expected, State::recording, std::memory_order_release)) {
+          armed_.store(true, std::memory_order_release);
+        }
+        return;
+      }
+      case State::recording: drain(false); return;
+      case State::stopping:
+        drain(true);
+        close_take();
+        state_.store(State::idle, std::memory_order_release);
+        return;
+    }
+  }
+
+  bool Recorder::open_take()
+  {
+    auto dir = Application::current().data_dir / "recordings";
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    std::time_t t = std::time(nullptr);
+    char name[32];
+    std::strftime(name, sizeof(name), "take-%Y%m%d-%H%M%S.wav", std::localtime(&t));
+    take_path_ = dir / name;
+
+    if (!writer_.open(take_path_, AudioManager::current().samplerate(), 2)) {
+      LOGE("Could not open recording file {}", take_path_);
+      return false;
+    }
+    synced_bytes_ = 0;
+    recorder_stats::frames_written.store(0, std::memory_order_relaxed);
+    recorder_stats::frames_dropped.store(0, std::memory_order_relaxed);
+    // The take starts now - skip anything stale in the ring
+    tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    DLOGI("Recording to {}", take_path_);
+    return true;
+  }
+
+  void Recorder::drain(bool flush_all)
+  {
+    if (!writer_.is_open()) {
+      tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+      return;
+    }
+    constexpr std::size_t chunk_floats = write_chunk / sizeof(float);
+    for (;;) {
+      const auto head = head_.load(std::memory_order_acquire);
+      const auto tail = tail_.load(std::memory_order_relaxed);
+      const std::size_t avail = head - tail;
+      if (avail == 0 || (!flush_all && avail < chunk_floats)) return;
+      const std::size_t n = std::min(avail, chunk_floats);
+
+      // Un-wrap into the staging buffer, so the disk sees one large write
+      const std::size_t s = tail & (ring_size - 1);
+      const std::size_t first = std::min(n, ring_size - s);
+      std::memcpy(staging_.data(), ring_.data() + s, first * sizeof(float));
+      std::memcpy(staging_.data() + first, ring_.data(), (n - first) * sizeof(float));
+      tail_.store(tail + n, std::memory_order_release);
+
+      if (!writer_.write(staging_.data(), n)) {
+        LOGE("Write to {} failed - stopping the take", take_path_);
+        armed_.store(false, std::memory_order_release);
+        close_take();
+        state_.store(State::idle, std::memory_order_release);
+        return;
+      }
+      recorder_stats::frames_written.fetch_add(n / 2, std::memory_order_relaxed);
+      if (writer_.data_bytes() - synced_bytes_ >= sync_interval) {
+        writer_.sync();
+        synced_bytes_ = writer_.data_bytes();
+      }
+    }
+  }
+
+  void Recorder::close_take()
+  {
+    if (!writer_.is_open()) return;
+    const auto frames = writer_.data_bytes() / (2 * sizeof(float));
+    writer_.close();
+    DLOGI("Finished take {}: {} frames, {} dropped", take_path_, frames,
+          recorder_stats::frames_dropped.load(std::memory_order_relaxed));
+  }
+
+} // namespace otto::services
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "util/dyn-array.hpp"
+#include "util/filesystem.hpp"
+#include "util/thread.hpp"
+#include "util/wav_writer.hpp"
+
+namespace otto::services {
+
+  /// Captures the master output to a WAV file on disk.
+  ///
+  /// The audio thread pushes interleaved blocks into a preallocated SPSC ring -
+  /// one bounds check, a copy, and one release store, so the tap is wait-free
+  /// and runs unconditionally. A writer thread drains the ring to disk in large
+  /// chunks, and syncs periodically so a crash loses at most a few seconds.
+  /// When the writer falls behind (SD card stalls), whole blocks are dropped
+  /// and counted - see {@ref recorder_stats} in `debug_ui.hpp`.
+  ///
+  /// Self-contained: owns its writer thread and needs no wiring in
+  /// `Application`. Takes are written to `data/recordings/`.
+  struct Recorder {
+    /// The process-wide instance
+    static Recorder& current() noexcept;
+
+    /// Start a new timestamped take. Logic thread. No-op while recording
+    void start_take();
+    /// Finish the current take - drains the ring, patches the WAV header and
+    /// syncs. Logic thread. No-op while idle
+    void stop_take();
+
+    bool recording() const noexcept { return armed_.load(std::memory_order_relaxed); }
+
+    /// Audio thread tap. Interleaves `nframes` of `l`/`r` into the ring, or
+    /// drops the whole block if the writer is too far behind
+    void push(const float* l, const float* r, int nframes) noexcept;
+
+    Recorder(const Recorder&) = delete;
+
+  private:
+    Recorder();
+
+    /// What the writer thread should be doing. Written by the logic thread,
+    /// acted on by the writer thread. The audio thread only reads `armed_`
+    enum struct State : char { idle, starting, recording, stopping };
+
+    void writer_tick();
+    bool open_take();
+    void drain(bool flush_all);
+    void close_take();
+
+    /// Interleaved stereo floats - ~1.3 s at 48 kHz, riding out SD stalls
+    static constexpr std::size_t ring_size = 1 << 17;
+    /// Bytes per disk write. Large writes keep the SD card in its happy path
+    static constexpr std::size_t write_chunk = 128 * 1024;
+    /// Sync to disk at least this often (in bytes written, ~5.5 s at 48 kHz)
+    static constexpr std::uint64_t sync_interval = 4 * 1024 * 1024;
+
+    util::dyn_array<float> ring_{ring_size};
+    /// Producer and consumer indices on separate cache lines, free-running -
+    /// `head - tail` is the fill
+    alignas(64) std::atomic<std::size_t> head_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_ = 0;
+
+    std::atomic<bool> armed_ = false;
+    std::atomic<State> state_ = State::idle;
+
+    // Writer thread only
+    util::WavWriter writer_;
+    std::uint64_t synced_bytes_ = 0;
+    util::dyn_array<float> staging_{write_chunk / sizeof(float)};
+    fs::path take_path_;
+
+    util::sleeper_thread writer_thread_;
+  };
+
+} // namespace otto::services
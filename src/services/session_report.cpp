@@ -0,0 +1,135 @@
+#include "session_report.hpp"
+
+#include <ctime>
+#include <fstream>
+
+#include "core/audio/audio_buffer_pool.hpp"
+#include "services/application.hpp"
+#include "services/audio_manager.hpp"
+#include "services/debug_ui.hpp"
+#include "services/governor.hpp"
+#include "services/log_manager.hpp"
+#include "util/jsonfile.hpp"
+
+namespace otto::services {
+
+  SessionReport& SessionReport::current() noexcept
+  {
+    static SessionReport instance;
+    return instance;
+  }
+
+  SessionReport::SessionReport() : session_start_(std::chrono::steady_clock::now())
+  {
+    // Written on pre_exit rather than in a destructor - every service is
+    // still alive when the signal fires
+    Application::current().events.pre_exit.connect([this] { write(); });
+    thermal_stats::on_throttle.connect([this](bool throttled) {
+      const auto uptime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - session_start_)
+                            .count();
+      std::unique_lock lock(mutex_);
+      throttle_events_.push_back({std::uint64_t(uptime), throttled});
+    });
+  }
+
+  fs::path SessionReport::write()
+  {
+    auto dir = Application::current().data_dir / "reports";
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+      LOGE("Could not create {}: {}", dir.c_str(), ec.message());
+      return {};
+    }
+
+    std::time_t t = std::time(nullptr);
+    char name[40];
+    std::strftime(name, sizeof(name), "session-%Y%m%d-%H%M%S.json", std::localtime(&t));
+    const auto path = dir / name;
+
+    const auto uptime_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - session_start_)
+                             .count();
+
+    nlohmann::json j;
+    j["uptime_s"] = double(uptime_ms) / 1000.0;
+
+    auto& audio_mgr = AudioManager::current();
+    auto& audio = j["audio"];
+    audio["samplerate"] = audio_mgr.samplerate();
+    audio["buffer_size"] = audio_mgr.buffer_size();
+    audio["blocks"] = audio_mgr.buffer_number();
+    audio["pool_peak_buffers"] = audio_mgr.buffer_pool().peak_in_use();
+
+    auto& stages = audio["stage_totals_ms"];
+    for (int i = 0; i < audio_stage_timers::stage_count; i++) {
+      stages[audio_stage_timers::stage_names[i]] =
+        double(audio_stage_timers::read_session_ns(audio_stage_timers::Stage(i))) / 1e6;
+    }
+
+    auto& xruns = audio["xruns"];
+    xruns["total"] = xrun_stats::total();
+    std::array<xrun_stats::record, xrun_stats::capacity> records;
+    const int n_records = xrun_stats::read(records.data(), xrun_stats::capacity);
+    auto& xr_list = xruns["recent"] = nlohmann::json::array();
+    for (int i = 0; i < n_records; i++) {
+      const auto& r = records[i];
+      nlohmann::json jr;
+      jr["uptime_ms"] = r.uptime_ms;
+      jr["callback_ns"] = r.callback_ns;
+      for (int s = 0; s < audio_stage_timers::stage_count; s++) {
+        jr["stage_ns"][audio_stage_timers::stage_names[s]] = r.stage_ns[s];
+      }
+      jr["midi_queue_depth"] = r.midi_queue_depth;
+      jr["cpu_khz"] = r.cpu_khz;
+      xr_list.push_back(std::move(jr));
+    }
+
+    auto& ui = j["ui"];
+    ui["frames"] = ui_swap_stats::frames.load(std::memory_order_relaxed);
+    ui["max_swap_ms"] = double(ui_swap_stats::max_swap_ns.load(std::memory_order_relaxed)) / 1e6;
+    ui["stalled_swaps"] = ui_swap_stats::stalled_swaps.load(std::memory_order_relaxed);
+    auto& hist = ui["frame_interval_hist"];
+    for (int i = 0; i < ui_swap_stats::bucket_count; i++) {
+      const auto label = i < ui_swap_stats::bucket_count - 1
+                           ? fmt::format("<{}ms", ui_swap_stats::bucket_bounds_ms[i])
+                           : fmt::format(">={}ms", ui_swap_stats::bucket_bounds_ms.back());
+      hist[label] = ui_swap_stats::frame_interval_hist[i].load(std::memory_order_relaxed);
+    }
+
+    auto& mem = j["memory"];
+    mem["locked"] = rt_memory_stats::memory_locked.load(std::memory_order_relaxed);
+    mem["baseline_rss_kb"] = rt_memory_stats::baseline_rss_kb.load(std::memory_order_relaxed);
+    mem["rss_kb"] = rt_memory_stats::rss_kb.load(std::memory_order_relaxed);
+    mem["engine_total_kb"] = engine_memory_stats::total_kb.load(std::memory_order_relaxed);
+    mem["audio_thread_allocations"] = rt_alloc_stats::audio_allocations.load(std::memory_order_relaxed);
+
+    auto& thermal = j["thermal"];
+    thermal["peak_c"] = double(thermal_stats::peak_mc.load(std::memory_order_relaxed)) / 1000.0;
+    {
+      std::unique_lock lock(mutex_);
+      auto& events = thermal["throttle_events"] = nlohmann::json::array();
+      for (const auto& e : throttle_events_) {
+        events.push_back({{"uptime_ms", e.uptime_ms}, {"throttled", e.throttled}});
+      }
+    }
+
+    auto& governor = Governor::current();
+    auto& gov = j["governor"];
+    gov["enabled"] = governor.enabled();
+    gov["degraded_now"] = governor.degraded();
+    gov["degrade_actions"] = governor.degrade_actions();
+    gov["restore_actions"] = governor.restore_actions();
+
+    auto& rec = j["recorder"];
+    rec["frames_written"] = recorder_stats::frames_written.load(std::memory_order_relaxed);
+    rec["frames_dropped"] = recorder_stats::frames_dropped.load(std::memory_order_relaxed);
+
+    std::ofstream file(path.c_str());
+    file << j.dump(2) << '\n';
+    LOGI("Wrote session report to {}", path.c_str());
+    return path;
+  }
+
+} // namespace otto::services
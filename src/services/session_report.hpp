@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "util/filesystem.hpp"
+
+namespace otto::services {
+
+  /// Writes a per-session performance report to `data/reports/`.
+  ///
+  /// Everything in the report is read from the lock-free instrumentation that
+  /// is already running - the stage timers, xrun records, swap stats, memory
+  /// and thermal stats in `debug_ui.hpp`, plus the {@ref Governor} action
+  /// counters - so a whole session costs nothing beyond what those surfaces
+  /// already pay. The only state of its own is the throttle event log, fed by
+  /// {@ref thermal_stats::on_throttle} edges (a handful per set, from the
+  /// watch thread).
+  ///
+  /// The final report writes itself on `Application::events.pre_exit`, while
+  /// every service is still alive; {@ref write} can also be called on demand
+  /// mid-set. One compact json file per report, timestamped like recorder
+  /// takes, so shows can be compared after the fact.
+  ///
+  /// Self-contained like {@ref Recorder} - no wiring in `Application`.
+  struct SessionReport {
+    /// The process-wide instance. First use connects the throttle listener,
+    /// so touch it during init - {@ref LogManager} does
+    static SessionReport& current() noexcept;
+
+    /// Write a timestamped report file under `data/reports/`.
+    ///
+    /// Logic or shutdown thread - reads the stats surfaces lock-free, a
+    /// record being written concurrently may come out torn, as with the xrun
+    /// dumps.
+    ///
+    /// \returns the path written, or an empty path when the directory could
+    /// not be created
+    fs::path write();
+
+    SessionReport(const SessionReport&) = delete;
+
+  private:
+    SessionReport();
+
+    /// One {@ref thermal_stats::on_throttle} edge
+    struct ThrottleEvent {
+      std::uint64_t uptime_ms;
+      bool throttled;
+    };
+
+    /// Guards {@ref throttle_events_} - written from the watch thread, read
+    /// by {@ref write}
+    std::mutex mutex_;
+    std::vector<ThrottleEvent> throttle_events_;
+    std::chrono::steady_clock::time_point session_start_;
+  };
+
+} // namespace otto::services
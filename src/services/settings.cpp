@@ -1,7 +1,18 @@
 #include "settings.hpp"
 
+#include <algorithm>
+
+#include <fmt/format.h>
+
 #include "core/ui/vector_graphics.hpp"
+#include "services/audio_manager.hpp"
+#include "services/clock_manager.hpp"
 #include "services/controller.hpp"
+#include "services/debug_ui.hpp"
+#include "services/governor.hpp"
+#include "services/log_manager.hpp"
+#include "services/recorder.hpp"
+#include "services/state_manager.hpp"
 #include "services/ui_manager.hpp"
 
 namespace otto::services {
@@ -22,28 +33,52 @@ namespace otto::services {
   // }
 
   struct Settings::Screen : ui::Screen {
-    Screen();
+    Screen(Settings& settings);
 
+    bool keypress(Key) override;
     void encoder(EncoderEvent) override;
     void draw(ui::vg::Canvas& ctx) override;
+    void on_show() override;
+    void on_hide() override;
 
     void scroll_to(int i);
 
     //Page& cur_page(int offset = 0);
 
     ch::Output<float> scroll_position = 0;
+    Settings& settings_;
   };
 
-  Settings::Settings() : screen_(std::make_unique<Screen>())
+  Settings::Settings() : screen_(std::make_unique<Screen>(*this))
   {
     UIManager::current().register_screen_selector(
       ScreenEnum::settings, [this]() -> auto& { return *screen_; });
 
     Controller::current().register_key_handler(Key::settings,
                                                [](auto) { UIManager::current().display(ScreenEnum::settings); });
+
+    props.direct_monitor.on_change().connect([](float gain) {
+      AudioManager::current().direct_monitor(gain);
+    }).call_now();
+
+    props.external_sync.on_change().connect([](bool enable) {
+      ClockManager::current().set_sync_external(enable);
+    }).call_now();
+
+    // Persistence rides the state manager: loads/saves with the rest of the
+    // state file, and every change only dirty-marks the entry - the debounced
+    // background autosave does the journaled write after quiescence, plus the
+    // final save on shutdown. No file I/O on the ui thread mid-twiddle
+    auto& state_manager = *Application::current().state_manager;
+    state_manager.attach(
+      "Settings", [this](const nlohmann::json& j) { util::deserialize(props, j); },
+      [this] { return util::serialize(props); });
+    core::props::connect_on_change(props, [tag = util::Symbol("Settings")] {
+      Application::current().state_manager->mark_dirty(tag);
+    });
   }
 
-  Settings::Screen::Screen()
+  Settings::Screen::Screen(Settings& settings) : settings_(settings)
   {
     // menus.push_back(std::make_unique<SettingsMenu>([](Canvas& ctx) {
     //   ctx.font(Fonts::Bold, 30);
@@ -75,9 +110,62 @@ namespace otto::services {
     // return *menus[util::math::modulo(int(scroll_position + offset), menus.size())];
   // }
 
+  bool Settings::Screen::keypress(Key key)
+  {
+    switch (key) {
+      case Key::rec:
+        // Toggle the disk recorder
+        if (Recorder::current().recording()) {
+          Recorder::current().stop_take();
+        } else {
+          Recorder::current().start_take();
+        }
+        return true;
+      case Key::plus:
+        // Arm/disarm allocation tracking on the audio thread
+        rt_alloc_stats::track_audio.store(!rt_alloc_stats::track_audio.load(std::memory_order_relaxed),
+                                          std::memory_order_relaxed);
+        rt_alloc_stats::audio_allocations.store(0, std::memory_order_relaxed);
+        return true;
+      case Key::minus: {
+        // Dump recent xrun records to the log
+        std::array<xrun_stats::record, xrun_stats::capacity> recs;
+        const int n = xrun_stats::read(recs.data(), recs.size());
+        LOGI("{} xrun(s) total, {} most recent:", xrun_stats::total(), n);
+        for (int i = 0; i < n; i++) {
+          const auto& r = recs[i];
+          std::string stages;
+          for (int s = 0; s < audio_stage_timers::stage_count; s++) {
+            stages += fmt::format(" {}={}us", audio_stage_timers::stage_names[s], r.stage_ns[s] / 1000);
+          }
+          LOGI("  at {}s: callback {}us (prev {}us), midi queue {}, cpu {}MHz,{}", r.uptime_ms / 1000,
+               r.callback_ns[0] / 1000, r.callback_ns[1] / 1000, r.midi_queue_depth, r.cpu_khz / 1000, stages);
+        }
+        return true;
+      }
+      default: return false;
+    }
+  }
+
   void Settings::Screen::encoder(EncoderEvent evt)
   {
     // scroll_to(util::math::modulo(int(scroll_position + evt.steps), menus.size()));
+
+    // Blue adjusts the direct monitoring gain for line-in
+    if (evt.encoder == Encoder::blue) {
+      settings_.props.direct_monitor.step(evt.steps);
+    }
+  }
+
+  // Spectrum capture only runs while this screen is up
+  void Settings::Screen::on_show()
+  {
+    spectrum_analyzer::armed.store(true, std::memory_order_relaxed);
+  }
+
+  void Settings::Screen::on_hide()
+  {
+    spectrum_analyzer::armed.store(false, std::memory_order_relaxed);
   }
 
   void Settings::Screen::draw(Canvas& ctx)
@@ -97,6 +185,24 @@ namespace otto::services {
       // ctx.drawAt(p, cur_menu());
     }
 
+    // Master output spectrum - log frequency, -80..0 dB mapped onto 50 px.
+    // analyze() only transforms when the audio thread delivered a new window,
+    // and the bins change every frame, so the polyline is built directly
+    // rather than through a point cache
+    spectrum_analyzer::analyze();
+    ctx.beginPath();
+    const float bin_scale = 1.f / std::log2(float(spectrum_analyzer::bin_count));
+    for (int b = 1; b < spectrum_analyzer::bin_count; b++) {
+      const float x = 20 + 280 * std::log2(float(b)) * bin_scale;
+      const float y = 70 - 50 * (spectrum_analyzer::bins_db[b] + 80.f) / 80.f;
+      if (b == 1)
+        ctx.moveTo(x, y);
+      else
+        ctx.lineTo(x, y);
+    }
+    ctx.lineWidth(1.5);
+    ctx.stroke(Colours::Green);
+
     ctx.beginPath();
     ctx.moveTo(20, 200);
     ctx.lineTo(300, 200);
@@ -109,6 +215,72 @@ namespace otto::services {
     // ctx.moveTo(20 + start, 200);
     // ctx.lineTo(20 + start + width, 200);
     ctx.stroke(Colors::White);
+
+    // Disk recorder status - rec toggles a take
+    const bool recording = Recorder::current().recording();
+    Controller::current().set_color(LED{Key::rec}, recording ? LEDColor::Red : LEDColor::Black);
+    ctx.font(Fonts::Norm, 25);
+    ctx.fillStyle(recording ? Colours::Red : Colours::Gray70);
+    if (recording) {
+      const auto written = recorder_stats::frames_written.load(std::memory_order_relaxed);
+      const auto dropped = recorder_stats::frames_dropped.load(std::memory_order_relaxed);
+      auto text = fmt::format("recording {}s", written / std::max(1, AudioManager::current().samplerate()));
+      if (dropped > 0) text += fmt::format("  dropped {}", dropped);
+      ctx.fillText(text, 20, 225);
+    } else {
+      ctx.fillText("rec: record to disk", 20, 225);
+    }
+
+    // Quality tiers shed by the governor to stay ahead of the deadline
+    const auto shed = Governor::current().degraded();
+    if (shed > 0) {
+      ctx.fillStyle(Colours::Red);
+      ctx.fillText(fmt::format("governor: {} tier{} shed (~{}%)", shed, shed == 1 ? "" : "s",
+                               int(Governor::current().shed_cost() * 100)),
+                   20, 75);
+    }
+
+    // Soc temperature and clock - red means the firmware is throttling and
+    // the audio headroom is reduced
+    const auto temp_mc = thermal_stats::temp_mc.load(std::memory_order_relaxed);
+    const auto cur_khz = thermal_stats::cur_khz.load(std::memory_order_relaxed);
+    if (temp_mc >= 0 || cur_khz > 0) {
+      const bool throttled = thermal_stats::throttled.load(std::memory_order_relaxed);
+      ctx.fillStyle(throttled ? Colours::Red : Colours::Gray70);
+      ctx.fillText(fmt::format("temp: {} C @ {} MHz{}", temp_mc / 1000, cur_khz / 1000,
+                               throttled ? "  throttled" : ""),
+                   20, 100);
+    }
+
+    // Xruns since boot - minus dumps the records with cause attribution
+    const auto xruns = xrun_stats::total();
+    ctx.fillStyle(xruns > 0 ? Colours::Red : Colours::Gray70);
+    ctx.fillText(fmt::format("xruns: {}", xruns), 20, 125);
+
+    // Direct line-in monitoring level, adjusted with the blue encoder
+    const float monitor = AudioManager::current().direct_monitor();
+    ctx.fillStyle(monitor > 0.f ? Colours::Blue : Colours::Gray70);
+    ctx.fillText(fmt::format("monitor: {}%", int(monitor * 100 + 0.5f)), 170, 125);
+
+    // Audio-thread allocation tracking - anything above zero is a bug
+    if (rt_alloc_stats::track_audio.load(std::memory_order_relaxed)) {
+      const auto allocs = rt_alloc_stats::audio_allocations.load(std::memory_order_relaxed);
+      ctx.fillStyle(allocs > 0 ? Colours::Red : Colours::Gray70);
+      ctx.fillText(fmt::format("alloc: {}", allocs), 20, 150);
+    } else {
+      ctx.fillStyle(Colours::Gray70);
+      ctx.fillText("plus: track audio allocations", 20, 150);
+    }
+
+    // Memory residency - growth since rt setup means new page fault sources
+    const auto rss = rt_memory_stats::rss_kb.load(std::memory_order_relaxed);
+    const auto grown = rss - rt_memory_stats::baseline_rss_kb.load(std::memory_order_relaxed);
+    ctx.fillStyle(Colours::Gray70);
+    const auto engines_kb = engine_memory_stats::total_kb.load(std::memory_order_relaxed);
+    ctx.fillText(fmt::format("mem: {} MB{}{}  engines {} MB", rss / 1024,
+                             rt_memory_stats::memory_locked.load(std::memory_order_relaxed) ? " locked" : "",
+                             grown > 0 ? fmt::format("  +{} KB", grown) : "", engines_kb / 1024),
+                 20, 175);
   }
 
 } // namespace otto::services
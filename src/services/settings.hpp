@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/props/props.hpp"
 #include "core/service.hpp"
 #include "core/ui/screen.hpp"
 #include "util/local_vector.hpp"
@@ -11,6 +12,19 @@ namespace otto::services {
 
     Settings();
 
+    /// Persisted settings values.
+    ///
+    /// Changes apply immediately - persistence goes through the state
+    /// manager's dirty-marking, so the journaled write happens debounced on
+    /// the background thread after quiescence, never mid-interaction
+    struct Props {
+      core::props::Property<float> direct_monitor = {0, core::props::limits(0, 1), core::props::step_size(0.01)};
+      /// Follow an external midi clock - see {@ref ClockManager::set_sync_external}
+      core::props::Property<bool> external_sync = {false};
+
+      DECL_REFLECTION(Props, direct_monitor, external_sync);
+    } props;
+
     struct Screen;
     struct Menu {
       struct Entry {
@@ -0,0 +1,145 @@
+#include "soak.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <Gamma/Domain.h>
+
+#include "core/audio/audio_buffer_pool.hpp"
+#include "core/audio/midi.hpp"
+#include "services/application.hpp"
+#include "services/audio_manager.hpp"
+#include "services/clock_manager.hpp"
+#include "services/controller.hpp"
+#include "services/engine_manager.hpp"
+#include "services/log_manager.hpp"
+#include "services/ui_manager.hpp"
+
+namespace otto::services::soak {
+
+  namespace {
+    /// Resident set size in kilobytes, from /proc/self/statm. -1 on failure.
+    ///
+    /// The audio manager's rss watch thread reads the same file, but it ticks
+    /// in wall time - a soak compresses minutes of audio into seconds, so the
+    /// samples are taken on the simulated clock instead
+    long read_rss_kb() noexcept
+    {
+      std::FILE* f = std::fopen("/proc/self/statm", "r");
+      if (f == nullptr) return -1;
+      long pages_total = 0;
+      long pages_resident = 0;
+      int n = std::fscanf(f, "%ld %ld", &pages_total, &pages_resident);
+      std::fclose(f);
+      if (n != 2) return -1;
+      static const long page_kb = ::sysconf(_SC_PAGESIZE) / 1024;
+      return pages_resident * page_kb;
+    }
+
+    /// Allowed resident-set growth between the end of the warmup quarter and
+    /// the end of the run. Allocator slack and lazily built caches keep
+    /// growing for a while, so zero would flag healthy runs
+    constexpr long rss_slack_kb = 2048;
+
+    /// The screens the engine manager registers selectors for. Cycling
+    /// through them exercises on_show/on_hide, the selector screens and the
+    /// led delta tracking
+    constexpr std::array screens = {
+      ScreenEnum::synth,  ScreenEnum::synth_envelope, ScreenEnum::voices,  ScreenEnum::arp,
+      ScreenEnum::fx1,    ScreenEnum::fx2,            ScreenEnum::looper,  ScreenEnum::sequencer,
+      ScreenEnum::sampler, ScreenEnum::master,
+    };
+  } // namespace
+
+  bool run(float minutes)
+  {
+    auto& audio = *Application::current().audio_manager;
+    auto& engines = *Application::current().engine_manager;
+    auto& controller = Controller::current();
+
+    const int samplerate = audio.samplerate();
+    const int nframes = int(audio.buffer_size());
+    // Set up the pool and domain state a driver would normally own
+    audio.buffer_pool().set_buffer_size(nframes);
+    gam::sampleRate(samplerate);
+
+    ClockManager::current().start();
+
+    const auto total = std::int64_t(double(minutes) * 60 * samplerate);
+    const auto blocks_per_second = std::max<std::int64_t>(1, samplerate / nframes);
+    const auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<long> rss_samples;
+    int pool_leaks = 0;
+    const auto handlers_at_start = controller.key_handler_count();
+    auto handlers_max = handlers_at_start;
+
+    int note = 47;
+    std::int64_t block = 0;
+    for (std::int64_t rendered = 0; rendered < total; block++) {
+      // ~4 notes per second of simulated time, walking the range the key
+      // matrix maps
+      if (block % std::max<std::int64_t>(1, blocks_per_second / 4) == 0) {
+        audio.send_midi_event(core::midi::NoteOffEvent{note});
+        note = note == 72 ? 47 : note + 1;
+        audio.send_midi_event(core::midi::NoteOnEvent{note, 0.8f});
+      }
+      if (block % blocks_per_second == 0) {
+        const auto second = std::size_t(block / blocks_per_second);
+        // A turn on each encoder in rotation, through the normal input queue,
+        // so the logic thread dispatches it to whatever screen is current
+        auto enc = Encoder::_from_integral_unchecked(std::uint8_t(second % Encoder::_size()));
+        controller.encoder({enc, second % 2 == 0 ? 3 : -3});
+        UIManager::current().display(screens[second % screens.size()]);
+      }
+
+      {
+        auto in_buf = audio.buffer_pool().allocate_clear();
+        auto out = engines.process({in_buf, {}, core::clock::ClockRange()});
+        rendered += out.nframes;
+      }
+
+      if (block % blocks_per_second == 0) {
+        // Between blocks every handle should be back in the pool
+        if (audio.buffer_pool().in_use() > 0) pool_leaks++;
+        handlers_max = std::max(handlers_max, controller.key_handler_count());
+        long rss = read_rss_kb();
+        if (rss > 0) rss_samples.push_back(rss);
+      }
+    }
+    // Let the logic thread drain the queued input before the final verdict
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ClockManager::current().stop();
+
+    bool ok = true;
+    if (rss_samples.size() >= 8) {
+      const long base = rss_samples[rss_samples.size() / 4];
+      const long final_rss = rss_samples.back();
+      if (final_rss > base + rss_slack_kb) {
+        LOGE("Soak: resident set grew {} KB after warmup ({} -> {} KB)", final_rss - base, base, final_rss);
+        ok = false;
+      }
+    }
+    if (pool_leaks > 0) {
+      LOGE("Soak: buffers in use between blocks in {} samples - leaked audio buffer handle", pool_leaks);
+      ok = false;
+    }
+    if (handlers_max > handlers_at_start) {
+      LOGE("Soak: key handler count grew from {} to {} - something registers handlers at runtime", handlers_at_start,
+           handlers_max);
+      ok = false;
+    }
+
+    const auto ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    LOGI("Soaked {} min of audio in {} ms ({} blocks): {}", minutes, ms, block, ok ? "no drift detected" : "FAILED");
+    return ok;
+  }
+
+} // namespace otto::services::soak
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace otto::services::soak {
+
+  /// Run the engine chain headless for `minutes` of simulated time with
+  /// scripted midi, encoder and screen-change input, as fast as the cpu
+  /// allows.
+  ///
+  /// Samples the resident set, the buffer pool occupancy and the key handler
+  /// count as it goes, and fails on growth after the warmup quarter - the
+  /// slow leaks that only show after hours on a real unit show up here in
+  /// seconds.
+  ///
+  /// Must only be called while no audio driver is pulling the chain - it
+  /// reconfigures the buffer pool and domain the way a driver would.
+  ///
+  /// \returns `true` when no drift was detected
+  bool run(float minutes);
+
+} // namespace otto::services::soak
@@ -1,10 +1,20 @@
 #include "state_manager.hpp"
 
+#include <array>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "services/application.hpp"
+#include "services/clock_manager.hpp"
 #include "services/log_manager.hpp"
+#include "services/task_pool.hpp"
 
+#include "util/algorithm.hpp"
 #include "util/exception.hpp"
 #include "util/jsonfile.hpp"
+#include "util/tracing.hpp"
 
 namespace otto::services {
 
@@ -16,11 +26,127 @@ namespace otto::services {
 
     void load() override;
     void save() override;
-    void attach(std::string name, Loader load, Saver save) override;
+    void save_slot(int idx) override;
+    void load_slot(int idx) override;
+    void load_autosnap() override;
+    void ab_capture(util::Symbol name) override;
+    void ab_toggle(util::Symbol name) override;
+    void mark_dirty(util::Symbol name) override;
+    void attach(util::Symbol name, Loader load, Saver save) override;
+
+    void detach(util::Symbol name) override;
+
+  private:
+    nlohmann::json& collect_state();
+    void dispatch_state(nlohmann::json& data);
+    void write_snapshot(const fs::path& path);
+    bool load_snapshot(const fs::path& path);
+    void autosnap();
+    fs::path slot_path(int idx);
+    fs::path autosnap_path(int idx);
+    fs::path chunk_path(std::uint64_t hash);
+    void sweep_chunks();
+    void wait_for_offbeat() noexcept;
+    bool dirty_pending();
+
+    /// Recursive because loaders can fire property signals, which in turn call
+    /// @ref mark_dirty on the same thread
+    std::recursive_mutex _mutex;
+    chrono::time_point _last_dirty = {};
+    chrono::time_point _last_autosnap = {};
+    /// Next ring slot to overwrite - see {@ref autosnap}
+    int _autosnap_pos = 0;
+
+    /// One CBOR-encoded section per client with a captured A/B state -
+    /// see {@ref ab_capture} and {@ref ab_toggle}
+    foonathan::array::flat_map<util::Symbol, std::vector<std::uint8_t>> _ab_buffers;
 
-    void detach(std::string name) override;
+    /// Writes `data/state.json` after the changes marked by @ref mark_dirty
+    /// have settled for `autosave_debounce`
+    util::sleeper_thread _autosave_thread = {[this](auto&& should_run) {
+      while (dirty_pending() || should_run()) {
+        // Debounce - wait until no new marks have arrived for a while
+        for (;;) {
+          chrono::time_point deadline;
+          {
+            std::unique_lock lock{_mutex};
+            deadline = _last_dirty + autosave_debounce;
+          }
+          if (!_autosave_thread.running()) return;
+          if (chrono::clock::now() >= deadline) break;
+          _autosave_thread.sleep_until(deadline);
+        }
+        if (!dirty_pending()) continue;
+        // The write shares the task pool with the rest of the background work,
+        // so an autosave can't add a runnable thread on an already busy board.
+        // Waiting keeps at most one save in flight
+        TaskPool::current().push([this] {
+          wait_for_offbeat();
+          save();
+        }).wait();
+      }
+    }};
+
+    /// Writes the autosnapshot ring - one rotating slot every
+    /// {@ref autosnap_interval_bars} bars, aligned to the clock. This thread
+    /// only watches the bar counter and schedules; encoding and writing run on
+    /// the task pool, so the logic thread never carries a snapshot
+    util::sleeper_thread _autosnap_thread = {[this](auto&&...) {
+      int last_fired = -1;
+      // Paced by sleep_for, not should_run() - nothing triggers this thread,
+      // it polls the bar counter. join() wakes the sleep, so shutdown is fast
+      while (_autosnap_thread.running()) {
+        _autosnap_thread.sleep_for(chrono::milliseconds(100));
+        if (!_autosnap_thread.running()) return;
+        if (autosnap_interval_bars <= 0) continue;
+        {
+          // Also gates on the other services being up - _loaded is only set
+          // after post_init
+          std::unique_lock lock{_mutex};
+          if (!_loaded) continue;
+        }
+        auto& clock = ClockManager::current();
+        if (!clock.running()) {
+          last_fired = -1;
+          continue;
+        }
+        const auto interval = core::clock::notes::whole * core::clock::Time(autosnap_interval_bars);
+        const int fired = int(clock.position() / interval);
+        if (fired == last_fired) continue;
+        last_fired = fired;
+        {
+          std::unique_lock lock{_mutex};
+          if (_last_dirty <= _last_autosnap) continue;
+        }
+        // Waiting keeps at most one snapshot in flight
+        TaskPool::current().push([this] { autosnap(); }).wait();
+      }
+    }};
   };
 
+  /// Identifies a binary snapshot file, followed by a format version.
+  ///
+  /// Version 1 stored the whole name -> client state object as one CBOR blob.
+  /// Version 2 stores a name -> chunk hash manifest instead: each client
+  /// section is CBOR-encoded on its own and written to a content-addressed
+  /// chunk file, shared by every slot whose section matches. Saving a slot then
+  /// only writes the sections that changed, and eight slots differing by one
+  /// engine tweak share all but one chunk on disk. Version 1 slots still load.
+  static constexpr std::array<char, 4> snapshot_magic = {'O', 'T', 'B', 'S'};
+  static constexpr std::uint32_t snapshot_version = 2;
+
+  /// FNV-1a, the usual 64 bit variant. Chunks are identified by the hash of
+  /// their encoded bytes - collisions between a handful of small sections are
+  /// not a realistic concern
+  static std::uint64_t chunk_hash(const std::vector<std::uint8_t>& bytes) noexcept
+  {
+    std::uint64_t h = 14695981039346656037u;
+    for (auto b : bytes) {
+      h = (h ^ b) * 1099511628211u;
+    }
+    return h;
+  }
+
   std::unique_ptr<StateManager> StateManager::create_default()
   {
     return std::make_unique<DefaultStateManager>();
@@ -37,7 +163,29 @@ namespace otto::services {
 
   void DefaultStateManager::load()
   {
-    data_file.read(util::JsonFile::OpenOptions::create);
+    OTTO_TRACE_SCOPE("state/load");
+    std::unique_lock lock{_mutex};
+
+    std::vector<util::Symbol> seen;
+
+    // Stream the file section by section. Sections with a client attached go
+    // straight to its loader and are discarded - only the leftovers, kept for
+    // clients attached later, build nodes in the state tree. Section names
+    // from disk may be anything, so they are looked up, never interned
+    data_file.read_sections(
+      [&](const std::string& name, nlohmann::json&& section) {
+        auto found = _clients.find(util::Symbol::lookup(name));
+        if (found == _clients.end()) return false;
+        try {
+          found->value.load(section);
+          found->value.dirty = false;
+        } catch (std::exception& e) {
+          LOGE("Exception while loading state for {}: {}", name, e.what());
+        }
+        seen.push_back(found->key);
+        return true;
+      },
+      util::JsonFile::OpenOptions::create);
 
     auto& data = data_file.data();
 
@@ -49,11 +197,16 @@ namespace otto::services {
       data = {};
     }
 
-    for (const auto& [name, client] : _clients) {
+    // Clients with no section in the file - and all of them, if the document
+    // root wasn't an object and the streaming read fell back to a full parse -
+    // still get their loader called, as dispatch_state would have done
+    for (auto&& [name, client] : _clients) {
+      if (util::find(seen, name) != seen.end()) continue;
       try {
-        client.load(data[name]);
+        client.load(data[name.c_str()]);
+        client.dirty = false;
       } catch (std::exception& e) {
-        LOGE("Exception while loading state for {}: {}", name, e.what());
+        LOGE("Exception while loading state for {}: {}", name.c_str(), e.what());
       }
     }
 
@@ -62,26 +215,277 @@ namespace otto::services {
 
   void DefaultStateManager::save()
   {
+    OTTO_TRACE_SCOPE("state/save");
+    std::unique_lock lock{_mutex};
+
     if (!_loaded) {
       return;
     }
 
+    collect_state();
+    data_file.write();
+  }
+
+  void DefaultStateManager::save_slot(int idx)
+  {
+    auto path = slot_path(idx);
+
+    std::unique_lock lock{_mutex};
+
+    if (!_loaded) {
+      return;
+    }
+
+    collect_state();
+    write_snapshot(path);
+    sweep_chunks();
+  }
+
+  /// Write the collected state tree as a chunked snapshot at `path`.
+  ///
+  /// Requires `_mutex` held and the state collected. Both the chunks and the
+  /// manifest go through a temporary renamed into place, so a power cut
+  /// mid-write leaves the previous snapshot intact - that is what makes the
+  /// autosnapshot ring safe to overwrite in a loop
+  void DefaultStateManager::write_snapshot(const fs::path& path)
+  {
     auto& data = data_file.data();
 
-    data.clear();
+    {
+      fs::path dir_p = path;
+      dir_p.remove_filename();
+      fs::create_directories(dir_p);
+    }
 
-    for (const auto& [name, client] : _clients) {
-      data[name] = client.save();
+    // Encode each section on its own and write it as a content-addressed
+    // chunk. A chunk that already exists - from another slot, or an earlier
+    // save of this one - is shared, not rewritten
+    nlohmann::json manifest = nlohmann::json::object();
+    errno = 0;
+    for (auto it = data.begin(); it != data.end(); ++it) {
+      std::vector<std::uint8_t> cbor = nlohmann::json::to_cbor(it.value());
+      const auto hash = chunk_hash(cbor);
+      auto cpath = chunk_path(hash);
+      if (!fs::exists(cpath)) {
+        fs::create_directories(Application::current().data_dir / "state-chunks");
+        const auto ctmp = cpath.string() + ".tmp";
+        {
+          std::ofstream chunk(ctmp, std::ios::trunc | std::ios::binary);
+          chunk.write(reinterpret_cast<const char*>(cbor.data()), cbor.size());
+        }
+        std::rename(ctmp.c_str(), cpath.string().c_str());
+      }
+      manifest[it.key()] = hash;
     }
 
-    data_file.write();
+    std::vector<std::uint8_t> cbor = nlohmann::json::to_cbor(manifest);
+    const auto tmp = path.string() + ".tmp";
+    {
+      std::ofstream stream(tmp, std::ios::trunc | std::ios::binary);
+      stream.write(snapshot_magic.data(), snapshot_magic.size());
+      stream.write(reinterpret_cast<const char*>(&snapshot_version), sizeof(snapshot_version));
+      stream.write(reinterpret_cast<const char*>(cbor.data()), cbor.size());
+    }
+    std::rename(tmp.c_str(), path.string().c_str());
+    if (errno) {
+      throw std::system_error(errno, std::system_category());
+    }
+  }
+
+  void DefaultStateManager::load_slot(int idx)
+  {
+    auto path = slot_path(idx);
+
+    std::unique_lock lock{_mutex};
+
+    if (!fs::exists(path)) {
+      LOGE("Save slot {} is empty", idx);
+      return;
+    }
+
+    load_snapshot(path);
+  }
+
+  void DefaultStateManager::load_autosnap()
+  {
+    std::unique_lock lock{_mutex};
+
+    // Newest slot first. A slot torn by the power cut the ring is recovering
+    // from fails to load and falls through to the next newest
+    std::vector<int> slots;
+    for (int i = 0; i < num_autosnap_slots; i++) {
+      if (fs::exists(autosnap_path(i))) slots.push_back(i);
+    }
+    util::sort(slots, [&](int a, int b) {
+      return fs::last_write_time(autosnap_path(a)) > fs::last_write_time(autosnap_path(b));
+    });
+    for (int idx : slots) {
+      if (load_snapshot(autosnap_path(idx))) {
+        DLOGI("Recovered state from autosnapshot slot {}", idx);
+        return;
+      }
+    }
+    LOGE("No loadable autosnapshot in the ring");
+  }
+
+  /// Write one ring slot and advance the ring. Task pool only.
+  void DefaultStateManager::autosnap()
+  {
+    OTTO_TRACE_SCOPE("state/autosnap");
+    std::unique_lock lock{_mutex};
+
+    if (!_loaded) {
+      return;
+    }
+
+    collect_state();
+    write_snapshot(autosnap_path(_autosnap_pos));
+    _autosnap_pos = (_autosnap_pos + 1) % num_autosnap_slots;
+    _last_autosnap = chrono::clock::now();
+    sweep_chunks();
+  }
+
+  /// Read the snapshot at `path` and dispatch it. Requires `_mutex` held.
+  ///
+  /// \returns `false` if the file is missing, torn or unreadable - the state
+  /// tree is untouched in that case
+  bool DefaultStateManager::load_snapshot(const fs::path& path)
+  {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+      LOGE("Could not open state snapshot '{}'", path.c_str());
+      return false;
+    }
+
+    std::array<char, 4> magic = {};
+    std::uint32_t version = 0;
+    stream.read(magic.data(), magic.size());
+    stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!stream || magic != snapshot_magic) {
+      LOGE("'{}' is not a state snapshot", path.c_str());
+      return false;
+    }
+    if (version != 1 && version != snapshot_version) {
+      LOGE("Unknown state snapshot version {} in '{}'", version, path.c_str());
+      return false;
+    }
+
+    nlohmann::json data;
+    try {
+      data = nlohmann::json::from_cbor(stream);
+    } catch (nlohmann::json::parse_error& e) {
+      LOGE("Error reading state snapshot '{}': {}", path.c_str(), e.what());
+      return false;
+    }
+
+    // A version 2 slot is a manifest - assemble the state from the chunks it
+    // references. Version 1 holds the whole state inline
+    if (version == 2 && data.is_object()) {
+      nlohmann::json assembled = nlohmann::json::object();
+      for (auto it = data.begin(); it != data.end(); ++it) {
+        auto cpath = chunk_path(it.value().get<std::uint64_t>());
+        std::ifstream chunk(cpath, std::ios::binary);
+        if (!chunk) {
+          LOGE("Missing state chunk '{}' for snapshot '{}'", cpath.c_str(), path.c_str());
+          return false;
+        }
+        try {
+          assembled[it.key()] = nlohmann::json::from_cbor(chunk);
+        } catch (nlohmann::json::parse_error& e) {
+          LOGE("Error reading state chunk '{}': {}", cpath.c_str(), e.what());
+          return false;
+        }
+      }
+      data = std::move(assembled);
+    }
+
+    if (!data.is_object()) {
+      LOGE("Got unexpected data from state snapshot '{}'", path.c_str());
+      return false;
+    }
+
+    // Keep the loaded state around, so clients attached later pick it up too
+    data_file.data() = std::move(data);
+    dispatch_state(data_file.data());
+
+    _loaded = true;
+    return true;
+  }
+
+  void DefaultStateManager::ab_capture(util::Symbol name)
+  {
+    std::unique_lock lock{_mutex};
+
+    auto found = _clients.find(name);
+    if (found == _clients.end()) {
+      LOGE("No state client named '{}' to A/B capture", name.c_str());
+      return;
+    }
+    _ab_buffers.insert_or_replace(name, nlohmann::json::to_cbor(found->value.save()));
   }
 
-  void DefaultStateManager::attach(std::string name, Loader load, Saver save)
+  void DefaultStateManager::ab_toggle(util::Symbol name)
   {
+    OTTO_TRACE_SCOPE("state/ab_toggle");
+    {
+      std::unique_lock lock{_mutex};
+
+      auto buf = _ab_buffers.find(name);
+      if (buf == _ab_buffers.end()) {
+        LOGE("No A/B state captured for '{}'", name.c_str());
+        return;
+      }
+      auto found = _clients.find(name);
+      if (found == _clients.end()) {
+        LOGE("No state client named '{}' to A/B toggle", name.c_str());
+        return;
+      }
+
+      // Encode the live state before restoring, so the next toggle comes back
+      // to it - everything stays in memory on both sides
+      auto current = nlohmann::json::to_cbor(found->value.save());
+      nlohmann::json data;
+      try {
+        data = nlohmann::json::from_cbor(buf->value);
+      } catch (nlohmann::json::parse_error& e) {
+        LOGE("Error decoding A/B state for '{}': {}", name.c_str(), e.what());
+        return;
+      }
+      try {
+        found->value.load(data);
+      } catch (std::exception& e) {
+        LOGE("Exception while loading A/B state for '{}': {}", name.c_str(), e.what());
+        return;
+      }
+      buf->value = std::move(current);
+
+      // The restored state is live but not on disk yet - the debounced
+      // autosave picks it up like any other edit
+      found->value.dirty = true;
+      _last_dirty = chrono::clock::now();
+    }
+    _autosave_thread.wake_up();
+  }
+
+  void DefaultStateManager::mark_dirty(util::Symbol name)
+  {
+    {
+      std::unique_lock lock{_mutex};
+      auto found = _clients.find(name);
+      if (found == _clients.end()) return;
+      found->value.dirty = true;
+      _last_dirty = chrono::clock::now();
+    }
+    _autosave_thread.wake_up();
+  }
+
+  void DefaultStateManager::attach(util::Symbol name, Loader load, Saver save)
+  {
+    std::unique_lock lock{_mutex};
+
     if (_clients.find(name) != _clients.end()) {
-      throw util::exception("Tried to attach a state client with the same name as another: " +
-                            name);
+      throw util::exception("Tried to attach a state client with the same name as another: {}",
+                            name.c_str());
     }
 
     // cannot move load, used below
@@ -89,17 +493,139 @@ namespace otto::services {
 
     if (_loaded) {
       auto& data = data_file.data();
-      load(data[name]);
+      load(data[name.c_str()]);
     }
   }
 
-  void DefaultStateManager::detach(std::string name)
+  void DefaultStateManager::detach(util::Symbol name)
   {
+    std::unique_lock lock{_mutex};
+
     if (_clients.find(name) == _clients.end()) {
-      throw util::exception("Tried to detach a state client that was never attached: " + name);
+      throw util::exception("Tried to detach a state client that was never attached: {}",
+                            name.c_str());
     }
 
     _clients.erase_all(name);
+    data_file.data().erase(name.c_str());
+  }
+
+  /// Re-encode the sections of dirty clients into the state tree, and return it.
+  ///
+  /// Clean clients keep their previous encoding, so a save where only one
+  /// engine changed only invokes that engine's saver.
+  nlohmann::json& DefaultStateManager::collect_state()
+  {
+    auto& data = data_file.data();
+
+    if (!data.is_object()) {
+      data = nlohmann::json::object();
+    }
+
+    for (auto&& [name, client] : _clients) {
+      if (!client.dirty && data.find(name.c_str()) != data.end()) continue;
+      data[name.c_str()] = client.save();
+      client.dirty = false;
+    }
+
+    return data;
+  }
+
+  void DefaultStateManager::dispatch_state(nlohmann::json& data)
+  {
+    for (auto&& [name, client] : _clients) {
+      try {
+        client.load(data[name.c_str()]);
+        client.dirty = false;
+      } catch (std::exception& e) {
+        LOGE("Exception while loading state for {}: {}", name.c_str(), e.what());
+      }
+    }
+  }
+
+  /// Hold an imminent disk write until the clock sits mid-beat.
+  ///
+  /// Beat boundaries are when the audio thread is busiest - every sequencer
+  /// trigger and sampler start lands there - so the SD-card write burst (and
+  /// the fsync behind it) goes in the quiet stretch between them. A stopped
+  /// clock means no alignment to avoid
+  void DefaultStateManager::wait_for_offbeat() noexcept
+  {
+    auto& clock = ClockManager::current();
+    if (!clock.running() || clock.bpm() <= 0) return;
+    const auto beat_ms = 60000.f / clock.bpm();
+    for (int i = 0; i < 4; i++) {
+      const float phase = clock.beat_phase();
+      if (phase > 0.15f && phase < 0.85f) return;
+      std::this_thread::sleep_for(std::chrono::milliseconds(int(beat_ms * 0.2f)));
+    }
+  }
+
+  /// Is there anything for the autosave thread to write?
+  bool DefaultStateManager::dirty_pending()
+  {
+    std::unique_lock lock{_mutex};
+
+    if (!_loaded || autosave_debounce <= chrono::duration::zero()) return false;
+
+    return util::any_of(_clients, [](const auto& entry) { return entry.value.dirty; });
+  }
+
+  fs::path DefaultStateManager::slot_path(int idx)
+  {
+    if (idx < 0 || idx >= num_slots) {
+      throw util::exception("Invalid state snapshot slot: {}", idx);
+    }
+
+    return Application::current().data_dir / fmt::format("state-slot-{}.bin", idx);
+  }
+
+  fs::path DefaultStateManager::autosnap_path(int idx)
+  {
+    return Application::current().data_dir / "autosnap" / fmt::format("slot-{}.bin", idx);
+  }
+
+  fs::path DefaultStateManager::chunk_path(std::uint64_t hash)
+  {
+    return Application::current().data_dir / "state-chunks" / fmt::format("{:016x}.bin", hash);
+  }
+
+  /// Delete chunks no slot references anymore.
+  ///
+  /// Runs after every slot save - the manifests are a few hundred bytes each,
+  /// so rereading all of them is nothing next to the write. This is what keeps
+  /// `data/` from growing with save history on the small SD partitions
+  void DefaultStateManager::sweep_chunks()
+  {
+    auto dir = Application::current().data_dir / "state-chunks";
+    if (!fs::exists(dir)) return;
+
+    std::vector<fs::path> referenced;
+    auto collect_refs = [&](const fs::path& path) {
+      std::ifstream stream(path, std::ios::binary);
+      if (!stream) return;
+      std::array<char, 4> magic = {};
+      std::uint32_t version = 0;
+      stream.read(magic.data(), magic.size());
+      stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+      if (!stream || magic != snapshot_magic || version != 2) return;
+      try {
+        auto manifest = nlohmann::json::from_cbor(stream);
+        if (!manifest.is_object()) return;
+        for (auto it = manifest.begin(); it != manifest.end(); ++it) {
+          referenced.push_back(chunk_path(it.value().get<std::uint64_t>()));
+        }
+      } catch (nlohmann::json::parse_error&) {
+      }
+    };
+    for (int i = 0; i < num_slots; i++) collect_refs(slot_path(i));
+    for (int i = 0; i < num_autosnap_slots; i++) collect_refs(autosnap_path(i));
+
+    for (auto&& entry : fs::directory_iterator(dir)) {
+      if (util::find(referenced, entry.path()) == referenced.end()) {
+        fs::remove(entry.path());
+      }
+    }
   }
 
 } // namespace otto::services
@@ -7,6 +7,8 @@
 
 #include "core/service.hpp"
 #include "services/application.hpp"
+#include "util/symbol.hpp"
+#include "util/thread.hpp"
 
 namespace otto::services {
 
@@ -16,35 +18,110 @@ namespace otto::services {
     /// Encoder
     using Saver = std::function<nlohmann::json()>;
 
+    /// The number of binary snapshot slots
+    static constexpr int num_slots = 8;
+
+    /// The number of rotating autosnapshot slots in `data/autosnap/`
+    static constexpr int num_autosnap_slots = 4;
+
     /// Read `data/state.json` and invoke attached loaders
     virtual void load() = 0;
 
     /// Invoke attached savers and write `data/state.json`
     virtual void save() = 0;
 
+    /// Invoke attached savers and write a binary snapshot to a slot
+    ///
+    /// The slots use a versioned binary format which is much faster to encode
+    /// than `data/state.json` - that file stays around as the readable
+    /// export/debug path.
+    ///
+    /// \throws [otto::util::exception]() If `idx` is not a valid slot
+    virtual void save_slot(int idx) = 0;
+
+    /// Read a binary snapshot from a slot and invoke attached loaders
+    ///
+    /// Does nothing but log an error if the slot has never been saved to.
+    ///
+    /// \throws [otto::util::exception]() If `idx` is not a valid slot
+    virtual void load_slot(int idx) = 0;
+
+    /// Load the newest snapshot from the autosnapshot ring
+    ///
+    /// The crash recovery path - after a power cut this restores the state as
+    /// of at most {@ref autosnap_interval_bars} bars before the cut. A torn
+    /// or unreadable slot falls through to the next newest. Does nothing but
+    /// log an error if the whole ring is empty.
+    virtual void load_autosnap() = 0;
+
+    /// Capture a client's current state into its in-memory A/B buffer
+    ///
+    /// The section is held CBOR-encoded in memory - no disk and no json text
+    /// on either side of the toggle. Does nothing but log an error if no
+    /// client is attached with the name `name`.
+    virtual void ab_capture(util::Symbol name) = 0;
+
+    /// Swap a client's live state with its A/B buffer
+    ///
+    /// Encodes the current state, dispatches the buffered one to the client's
+    /// loader and keeps the fresh encoding as the new buffer - so repeated
+    /// calls toggle between the two states. Fast enough to sit directly on a
+    /// key and be played rhythmically; engine props restored this way reach
+    /// the audio thread through the usual snapshot commit, at the next block
+    /// boundary. Does nothing but log an error if nothing was captured.
+    virtual void ab_toggle(util::Symbol name) = 0;
+
+    /// Mark a client's state as changed
+    ///
+    /// `save`/`save_slot` only re-invoke the saver of dirty clients, and reuse
+    /// the previous encoding for the rest. Marking also schedules a debounced
+    /// background autosave. Does nothing if no client is attached with the
+    /// name `name`.
+    ///
+    /// Clients built on props can hook this up to every property in one go
+    /// with [otto::core::props::connect_on_change]().
+    ///
+    /// Names are interned symbols - callers on hot paths (every keypress hits
+    /// this) should intern once and pass the symbol, making the lookup below
+    /// pure integer compares.
+    virtual void mark_dirty(util::Symbol name) = 0;
+
+    /// Quiet period after the last @ref mark_dirty before the background
+    /// autosave writes `data/state.json`. Zero disables autosave.
+    chrono::duration autosave_debounce = chrono::seconds(2);
+
+    /// Write a rolling binary autosnapshot every this many bars while the
+    /// transport runs, rotating through {@ref num_autosnap_slots} slots in
+    /// `data/autosnap/`. Zero disables the ring. Edits made while the
+    /// transport is stopped are covered by the debounced autosave instead
+    int autosnap_interval_bars = 8;
+
     /// Attach state handler with a name
     ///
     /// \throws [otto::util::exception]() If a handler has already been attached
     /// with the name `name`
-    virtual void attach(std::string name, Loader load, Saver save) = 0;
+    virtual void attach(util::Symbol name, Loader load, Saver save) = 0;
 
     /// Detach a state handler
     ///
     /// \throws [otto::util::exception]() If no such handler is attached
-    virtual void detach(std::string name) = 0;
+    virtual void detach(util::Symbol name) = 0;
 
     static std::unique_ptr<StateManager> create_default();
 
   protected:
 
     struct Client {
-      std::string name;
+      util::Symbol name;
       Loader load;
       Saver save;
+      /// Whether the client's state has changed since its section was last
+      /// encoded. Starts out dirty so the first save encodes everything
+      bool dirty = true;
     };
 
     bool _loaded = false;
-    foonathan::array::flat_map<std::string, Client> _clients;
+    foonathan::array::flat_map<util::Symbol, Client> _clients;
   };
 
 } // namespace otto::services
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "services/log_manager.hpp"
+#include "services/task_pool.hpp"
+
+namespace otto::services {
+
+  namespace detail {
+
+    /// `void` steps produce and consume nothing - `monostate` stands in so the
+    /// result slots can all live in one tuple
+    template<typename T>
+    using chain_value_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    /// What invoking `Step` with a `Prev` yields - specialized so only the
+    /// matching `invoke_result` is ever instantiated
+    template<typename Step, typename Prev, typename = void>
+    struct step_result {
+      using type = std::invoke_result_t<Step&, Prev>;
+    };
+
+    template<typename Step, typename Prev>
+    struct step_result<Step, Prev, std::enable_if_t<std::is_void_v<Prev>>> {
+      using type = std::invoke_result_t<Step&>;
+    };
+
+    /// Result type of step `I` - step 0 is invoked with nothing, every later
+    /// step with the (moved) result of the one before it
+    template<std::size_t I, typename Tuple>
+    struct chain_result {
+      using prev = typename chain_result<I - 1, Tuple>::type;
+      using type = typename step_result<std::tuple_element_t<I, Tuple>, prev>::type;
+    };
+
+    template<typename Tuple>
+    struct chain_result<0, Tuple> {
+      using type = std::invoke_result_t<std::tuple_element_t<0, Tuple>&>;
+    };
+
+    /// Type-erased part of a chain, shared between the {@ref TaskChain} handle
+    /// and the job currently queued on the pool
+    struct chain_state_base {
+      virtual ~chain_state_base() noexcept = default;
+
+      /// Run the next step, then re-queue `self` (which is `this`) for the one
+      /// after. Must not throw - it goes through {@ref TaskPool::push_detached}
+      virtual void run_next(std::shared_ptr<chain_state_base> self) noexcept = 0;
+
+      std::atomic<bool> cancelled_ = false;
+      std::atomic<bool> done_ = false;
+      TaskPool::Priority priority_ = TaskPool::Priority::normal;
+      /// Only touched by whichever worker holds the chain - at most one job per
+      /// chain is ever queued, so never concurrently
+      std::size_t next_step_ = 0;
+    };
+
+    template<typename... Steps>
+    struct chain_state final : chain_state_base {
+      static constexpr std::size_t step_count = sizeof...(Steps);
+
+      chain_state(std::tuple<Steps...> steps) : steps_(std::move(steps)) {}
+
+      void run_next(std::shared_ptr<chain_state_base> self) noexcept override
+      {
+        if (cancelled_.load(std::memory_order_acquire)) {
+          done_.store(true, std::memory_order_release);
+          return;
+        }
+        try {
+          (this->*step_table[next_step_])();
+        } catch (const std::exception& e) {
+          LOGE("Task chain step {} threw: {}", next_step_, e.what());
+          cancelled_.store(true, std::memory_order_release);
+          done_.store(true, std::memory_order_release);
+          return;
+        } catch (...) {
+          LOGE("Task chain step {} threw", next_step_);
+          cancelled_.store(true, std::memory_order_release);
+          done_.store(true, std::memory_order_release);
+          return;
+        }
+        if (++next_step_ == step_count) {
+          done_.store(true, std::memory_order_release);
+          return;
+        }
+        // The lambda captures one shared_ptr, which fits std::function's
+        // inline storage - re-queuing a continuation allocates nothing
+        TaskPool::current().push_detached(priority_, [s = std::move(self)]() mutable {
+          s->run_next(std::move(s));
+        });
+      }
+
+    private:
+      template<std::size_t I>
+      using result_t = typename chain_result<I, std::tuple<Steps...>>::type;
+
+      template<std::size_t I>
+      void run_step()
+      {
+        auto& step = std::get<I>(steps_);
+        auto& slot = std::get<I>(results_);
+        if constexpr (I == 0) {
+          if constexpr (std::is_void_v<result_t<0>>) {
+            step();
+            slot.emplace();
+          } else {
+            slot.emplace(step());
+          }
+        } else {
+          auto& prev = std::get<I - 1>(results_);
+          if constexpr (std::is_void_v<result_t<I - 1>>) {
+            if constexpr (std::is_void_v<result_t<I>>) {
+              step();
+              slot.emplace();
+            } else {
+              slot.emplace(step());
+            }
+          } else {
+            if constexpr (std::is_void_v<result_t<I>>) {
+              step(std::move(*prev));
+              slot.emplace();
+            } else {
+              slot.emplace(step(std::move(*prev)));
+            }
+          }
+          // Drop the intermediate as soon as it is consumed - decoded sample
+          // buffers should not outlive the step that ate them
+          prev.reset();
+        }
+      }
+
+      template<std::size_t... Is>
+      static auto result_storage(std::index_sequence<Is...>)
+        -> std::tuple<std::optional<chain_value_t<typename chain_result<Is, std::tuple<Steps...>>::type>>...>;
+      using Results = decltype(result_storage(std::index_sequence_for<Steps...>()));
+
+      using StepFn = void (chain_state::*)();
+
+      template<std::size_t... Is>
+      static constexpr std::array<StepFn, step_count> make_step_table(std::index_sequence<Is...>)
+      {
+        return {&chain_state::template run_step<Is>...};
+      }
+
+      /// {@ref run_step} instantiations, indexed by {@ref next_step_}
+      static constexpr std::array<StepFn, step_count> step_table =
+        make_step_table(std::index_sequence_for<Steps...>());
+
+      std::tuple<Steps...> steps_;
+      Results results_;
+    };
+
+  } // namespace detail
+
+  /// Handle to a running task chain - see {@ref task_chain}.
+  ///
+  /// Copyable and cheap; dropping every handle neither waits for nor cancels
+  /// the chain, like the futures from {@ref TaskPool::push}
+  struct TaskChain {
+    TaskChain() = default;
+
+    /// Stop the chain at the next step boundary.
+    ///
+    /// The step currently running (if any) finishes - steps are not
+    /// interrupted mid-flight - but the queued continuation drops instead of
+    /// running, so a canceled kit load stops eating worker time after the
+    /// block it is in. Any thread
+    void cancel() noexcept
+    {
+      if (state_) state_->cancelled_.store(true, std::memory_order_release);
+    }
+
+    bool cancelled() const noexcept
+    {
+      return state_ != nullptr && state_->cancelled_.load(std::memory_order_acquire);
+    }
+
+    /// The chain has stopped - ran to the end, was canceled, or a step threw.
+    /// Any thread
+    bool done() const noexcept
+    {
+      return state_ == nullptr || state_->done_.load(std::memory_order_acquire);
+    }
+
+  private:
+    template<typename...>
+    friend struct TaskChainBuilder;
+
+    TaskChain(std::shared_ptr<detail::chain_state_base> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<detail::chain_state_base> state_;
+  };
+
+  /// Accumulates the steps of a chain before it starts - see {@ref task_chain}
+  template<typename... Steps>
+  struct TaskChainBuilder {
+    TaskChainBuilder(std::tuple<Steps...> steps) : steps_(std::move(steps)) {}
+
+    /// Append a step, invoked with the previous step's result moved in (or
+    /// with nothing, after a `void` step)
+    template<typename F>
+    auto then(F&& f) && -> TaskChainBuilder<Steps..., std::decay_t<F>>
+    {
+      return {std::tuple_cat(std::move(steps_), std::make_tuple(std::forward<F>(f)))};
+    }
+
+    /// Start the chain on the {@ref TaskPool}.
+    ///
+    /// The one allocation the whole pipeline makes - steps, result slots and
+    /// control flags land in a single shared block; every hop between steps
+    /// after this is allocation-free
+    TaskChain run(TaskPool::Priority priority = TaskPool::Priority::normal) &&
+    {
+      std::shared_ptr<detail::chain_state_base> state =
+        std::make_shared<detail::chain_state<Steps...>>(std::move(steps_));
+      state->priority_ = priority;
+      TaskChain handle = {state};
+      TaskPool::current().push_detached(priority, [s = std::move(state)]() mutable {
+        s->run_next(std::move(s));
+      });
+      return handle;
+    }
+
+  private:
+    std::tuple<Steps...> steps_;
+  };
+
+  /// Linear multi-step background pipelines over the {@ref TaskPool}.
+  ///
+  /// Flows like "decode the sample, build the analysis cache, generate the
+  /// waveform pyramid, notify the ui" used to be hand-chained callbacks, each
+  /// hop paying {@ref TaskPool::push}'s `packaged_task` allocation and none of
+  /// them stoppable once queued. A chain reads in step order instead:
+  ///
+  ///     auto chain = task_chain([path] { return decode(path); })
+  ///                    .then([](Buffer b) { return analyse(std::move(b)); })
+  ///                    .then([](Cache c) { publish(std::move(c)); })
+  ///                    .run(TaskPool::Priority::high);
+  ///
+  /// Each step runs as one pool job and hands its result to the next by move.
+  /// Between steps the chain goes back through the queues, so a long pipeline
+  /// never hogs a worker - and {@ref TaskChain::cancel} takes effect at those
+  /// boundaries, dropping the remaining steps of an abandoned load instead of
+  /// letting them run to completion. The builder's one `shared_ptr` is the
+  /// only allocation; see {@ref TaskChainBuilder::run}
+  template<typename F>
+  auto task_chain(F&& f)
+  {
+    return TaskChainBuilder<std::decay_t<F>>(std::make_tuple(std::forward<F>(f)));
+  }
+
+} // namespace otto::services
@@ -0,0 +1,101 @@
+#include "task_pool.hpp"
+
+#include <algorithm>
+
+#include "services/log_manager.hpp"
+
+namespace otto::services {
+
+  TaskPool& TaskPool::current() noexcept
+  {
+    static TaskPool instance;
+    return instance;
+  }
+
+  TaskPool::TaskPool()
+  {
+    // Leave room for the audio callback and the ui thread. On the quad-core Pi
+    // this gives two workers
+    const int n = std::clamp(int(std::thread::hardware_concurrency()) - 2, 1, 4);
+    queues_.reserve(n);
+    for (int i = 0; i < n; i++) queues_.push_back(std::make_unique<Worker>());
+    threads_.reserve(n);
+    for (int i = 0; i < n; i++) {
+      threads_.push_back(std::make_unique<util::thread>(
+        util::scheduling::Band::worker, [this, i](auto&& should_run) { worker_loop(i, should_run); }));
+    }
+    DLOGI("Task pool started with {} workers", n);
+  }
+
+  TaskPool::~TaskPool() noexcept
+  {
+    stopping_.store(true, std::memory_order_relaxed);
+    sleep_cv_.notify_all();
+    // Joins. Queued jobs that never ran leave their futures with broken_promise
+    threads_.clear();
+  }
+
+  void TaskPool::enqueue(Priority priority, Job job)
+  {
+    auto& worker = *queues_[next_.fetch_add(1, std::memory_order_relaxed) % queues_.size()];
+    {
+      std::unique_lock lock{worker.mutex};
+      (priority == Priority::high ? worker.high : worker.normal).push_back(std::move(job));
+    }
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    sleep_cv_.notify_one();
+  }
+
+  bool TaskPool::try_get(int worker_index, Job& out)
+  {
+    const int n = int(queues_.size());
+    // Own queue from the front...
+    {
+      auto& own = *queues_[worker_index];
+      std::unique_lock lock{own.mutex};
+      if (!own.high.empty()) {
+        out = std::move(own.high.front());
+        own.high.pop_front();
+        return true;
+      }
+      if (!own.normal.empty()) {
+        out = std::move(own.normal.front());
+        own.normal.pop_front();
+        return true;
+      }
+    }
+    // ...then steal from the back of the others, high band first
+    for (int pass = 0; pass < 2; pass++) {
+      for (int k = 1; k < n; k++) {
+        auto& other = *queues_[(worker_index + k) % n];
+        std::unique_lock lock{other.mutex};
+        auto& queue = pass == 0 ? other.high : other.normal;
+        if (!queue.empty()) {
+          out = std::move(queue.back());
+          queue.pop_back();
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void TaskPool::worker_loop(int index, const std::function<bool()>& should_run)
+  {
+    while (should_run()) {
+      Job job;
+      if (try_get(index, job)) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        // packaged_task stores exceptions in the future, so this never throws
+        job();
+        continue;
+      }
+      std::unique_lock lock{sleep_mutex_};
+      sleep_cv_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+        return pending_.load(std::memory_order_relaxed) > 0 ||
+               stopping_.load(std::memory_order_relaxed);
+      });
+    }
+  }
+
+} // namespace otto::services
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/thread.hpp"
+
+namespace otto::services {
+
+  /// A small work-stealing pool for background work.
+  ///
+  /// All non-realtime work - sample decoding, waveform bins, preset parsing,
+  /// state saves - goes through one pool sized to the machine, instead of each
+  /// subsystem spawning its own thread, so simultaneous background jobs can no
+  /// longer oversubscribe the board and starve the ui thread. The workers run
+  /// in the worker scheduling band, which keeps them off the audio core.
+  ///
+  /// Jobs are pushed round-robin onto per-worker queues; a worker serves its
+  /// own queue from the front and steals from the back of the others when idle.
+  /// {@ref Priority::high} jobs (anything a screen is waiting for) run before
+  /// normal ones.
+  struct TaskPool {
+    enum struct Priority { high, normal };
+
+    /// Get the instance. The workers are started on first use
+    static TaskPool& current() noexcept;
+
+    /// Queue `f` on the pool.
+    ///
+    /// \returns a future for the result, which also carries any exception the
+    /// job throws. Destroying the future neither waits for nor cancels the job
+    template<typename F>
+    auto push(Priority priority, F&& f) -> std::future<std::invoke_result_t<F&>>;
+
+    template<typename F>
+    auto push(F&& f)
+    {
+      return push(Priority::normal, std::forward<F>(f));
+    }
+
+    /// Queue `f` on the pool, fire and forget.
+    ///
+    /// Skips the per-job `packaged_task` allocation of {@ref push} - the
+    /// function goes onto the queues as-is, so a small callable (a single
+    /// `shared_ptr` capture, say) stays in its inline storage. No future, so
+    /// nothing catches exceptions: `f` must not throw. Used by the task chains
+    /// in `task_chain.hpp` to re-queue continuations allocation-free
+    void push_detached(Priority priority, std::function<void()> f)
+    {
+      enqueue(priority, std::move(f));
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+    ~TaskPool() noexcept;
+
+  private:
+    TaskPool();
+
+    using Job = std::function<void()>;
+
+    void enqueue(Priority, Job);
+    bool try_get(int worker_index, Job& out);
+    void worker_loop(int index, const std::function<bool()>& should_run);
+
+    struct Worker {
+      std::mutex mutex;
+      std::deque<Job> high;
+      std::deque<Job> normal;
+    };
+
+    std::vector<std::unique_ptr<Worker>> queues_;
+    std::atomic<unsigned> next_ = 0;
+    /// Total queued jobs, so idle workers can sleep without holding any queue
+    /// mutex. May lag the queues by a moment - the sleep has a timeout
+    std::atomic<int> pending_ = 0;
+    std::atomic<bool> stopping_ = false;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    /// Started last, joined first
+    std::vector<std::unique_ptr<util::thread>> threads_;
+  };
+
+  template<typename F>
+  auto TaskPool::push(Priority priority, F&& f) -> std::future<std::invoke_result_t<F&>>
+  {
+    using R = std::invoke_result_t<F&>;
+    // One allocation per job - packaged_task is move-only, and the queues hold
+    // copyable std::functions
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    auto fut = task->get_future();
+    enqueue(priority, [task = std::move(task)] { (*task)(); });
+    return fut;
+  }
+
+} // namespace otto::services
@@ -1,7 +1,12 @@
 #include "ui_manager.hpp"
 
+#include "util/algorithm.hpp"
+#include "util/tracing.hpp"
+
 #include "services/audio_manager.hpp"
+#include "services/debug_ui.hpp"
 #include "services/engine_manager.hpp"
+#include "services/governor.hpp"
 #include "services/state_manager.hpp"
 
 #include "core/ui/vector_graphics.hpp"
@@ -32,6 +37,8 @@ namespace otto::services {
       case ScreenEnum::external: return LED(Key::external);
       case ScreenEnum::twist1: return LED(Key::twist1);
       case ScreenEnum::twist2: return LED(Key::twist2);
+      case ScreenEnum::synth2: return LED(Key::synth);
+      case ScreenEnum::synth2_selector: return LED(Key::synth);
     }
     OTTO_UNREACHABLE;
   }
@@ -44,6 +51,8 @@ namespace otto::services {
       case ScreenEnum::voices: [[fallthrough]];
       case ScreenEnum::synth_selector: [[fallthrough]];
       case ScreenEnum::synth_envelope: [[fallthrough]];
+      case ScreenEnum::synth2: [[fallthrough]];
+      case ScreenEnum::synth2_selector: [[fallthrough]];
       case ScreenEnum::synth: return KeyMode::midi;
 
       case ScreenEnum::sampler: [[fallthrough]];
@@ -54,6 +63,26 @@ namespace otto::services {
     }
   }
 
+  /// The screen the user most likely visits next from `screen`, or `screen`
+  /// itself when there is no good guess.
+  ///
+  /// Selectors lead to the screen they select for, engine screens to their
+  /// envelope - the pairs the navigation keys make cheap to reach
+  ScreenEnum predict_next(ScreenEnum screen)
+  {
+    switch (screen) {
+      case ScreenEnum::synth_selector: return ScreenEnum::synth;
+      case ScreenEnum::synth2_selector: return ScreenEnum::synth2;
+      case ScreenEnum::fx1_selector: return ScreenEnum::fx1;
+      case ScreenEnum::fx2_selector: return ScreenEnum::fx2;
+      case ScreenEnum::arp_selector: return ScreenEnum::arp;
+      case ScreenEnum::synth: return ScreenEnum::synth_envelope;
+      case ScreenEnum::sampler: return ScreenEnum::sampler_envelope;
+      case ScreenEnum::twist1: return ScreenEnum::twist2;
+      default: return screen;
+    }
+  }
+
   using namespace core::ui;
   void UIManager::display(ScreenEnum screen)
   {
@@ -70,6 +99,8 @@ namespace otto::services {
       Controller::current().set_color(led_for_screen(new_val), LEDColor::White);
       DLOGI("Select screen {}", new_val._to_string());
       key_mode_for(new_val).map([&](auto&& km) { state.key_mode.set(km); });
+      auto predicted = predict_next(new_val);
+      prewarm_target_ = predicted == new_val ? -1 : predicted._to_integral();
     });
 
     state.active_channel.on_change().connect([&](auto chan) { state.current_screen = state.current_screen.get(); });
@@ -97,12 +128,24 @@ namespace otto::services {
     auto save = [this] { return util::serialize(state); };
 
     Application::current().state_manager->attach("UI", load, save);
+
+    // Any change to the ui state schedules a debounced autosave. The name is
+    // interned up front, so the lookup on each change is an integer compare
+    core::props::connect_on_change(state, [tag = util::Symbol("UI")] {
+      Application::current().state_manager->mark_dirty(tag);
+    });
+
+    // The frame rate is the cheapest thing to lose - first on the governor's
+    // list. The ui lives the application's lifetime, so no unregistration
+    Governor::current().register_tier("ui frame rate", 0, 0.05f,
+                                      [this](bool degraded) { governor_throttle_.store(degraded, std::memory_order_relaxed); });
   }
 
   void UIManager::display(Screen& screen)
   {
     cur_screen->on_hide();
     cur_screen = &screen;
+    cur_screen->invalidate_all();
     cur_screen->on_show();
   }
 
@@ -118,12 +161,18 @@ namespace otto::services {
 
   void UIManager::draw_frame(vg::Canvas& ctx)
   {
+    OTTO_TRACE_SCOPE("ui/draw_frame");
     ctx.lineWidth(6);
     ctx.lineCap(vg::LineCap::ROUND);
     ctx.lineJoin(vg::LineJoin::ROUND);
+    frame_damage_ = cur_screen->has_partial_damage() ? cur_screen->damage() : vg::Box{0, 0, vg::width, vg::height};
     ctx.group([&] {
-      ctx.clip(0, 0, 320, 240);
-      cur_screen->draw(ctx);
+      ctx.clip(0, 0, vg::width, vg::height);
+      ctx.group([&] {
+        // Scissor to the damaged area, so unchanged geometry is clipped away early
+        ctx.clip(frame_damage_.x, frame_damage_.y, frame_damage_.width, frame_damage_.height);
+        cur_screen->draw(ctx);
+      });
 
       ctx.group([&] {
         ctx.beginPath();
@@ -131,17 +180,102 @@ namespace otto::services {
         ctx.font(vg::Fonts::Norm, 12);
         std::string cpu_time = fmt::format("{}%", int(100 * Application::current().audio_manager->cpu_time()));
         ctx.fillText(cpu_time, {290, 230});
+        // Throttle indicator - the cpu% reading is about to stop telling the
+        // truth about headroom
+        if (thermal_stats::throttled.load(std::memory_order_relaxed)) {
+          ctx.fillStyle(vg::Colours::Red);
+          ctx.fillText(fmt::format("{}C", thermal_stats::temp_mc.load(std::memory_order_relaxed) / 1000), {260, 230});
+        }
       });
 
       signals.on_draw.emit(ctx);
     });
+    cur_screen->clear_damage();
+
+    // With the frame drawn, spend otherwise idle time warming the screen the
+    // user is likely headed for
+    if (prewarm_target_ >= 0 && !animations_running()) prewarm_next(ctx);
 
     Controller::current().flush_leds();
     _frame_count++;
 
+    step_animations();
+  }
+
+  void UIManager::prewarm_next(vg::Canvas& ctx)
+  {
+    OTTO_TRACE_SCOPE("ui/prewarm");
+    auto target = ScreenEnum::_from_integral_unchecked(prewarm_target_);
+    prewarm_target_ = -1;
+    auto& selector = screen_selectors_[target];
+    if (!selector) return;
+    // Running the selector is half the warmup - lazily built screens get
+    // constructed here
+    Screen& screen = selector();
+    if (&screen == cur_screen) return;
+    ctx.group([&] {
+      // Scissored to nothing and fully transparent - the text layout and
+      // path building still run, which is exactly the work to cache
+      ctx.clip(0, 0, 0, 0);
+      ctx.globalAlpha(0);
+      screen.draw(ctx);
+    });
+  }
+
+  void UIManager::register_timeline(ch::Timeline& timeline)
+  {
+    if (util::find(extra_timelines_, &timeline) == extra_timelines_.end()) {
+      extra_timelines_.push_back(&timeline);
+    }
+  }
+
+  void UIManager::unregister_timeline(ch::Timeline& timeline) noexcept
+  {
+    extra_timelines_.erase(std::remove(extra_timelines_.begin(), extra_timelines_.end(), &timeline),
+                           extra_timelines_.end());
+  }
+
+  void UIManager::step_animations()
+  {
     auto now = chrono::clock::now();
-    timeline_.step(chrono::duration_cast<chrono::milliseconds>(now - last_frame).count());
+    auto ms = chrono::duration_cast<chrono::milliseconds>(now - last_frame).count();
+    // Stepping runs motion callbacks and bookkeeping - skip timelines that
+    // have nothing in flight
+    if (!timeline_.empty()) timeline_.step(ms);
+    for (auto* tl : extra_timelines_) {
+      if (!tl->empty()) tl->step(ms);
+    }
     last_frame = now;
   }
 
+  bool UIManager::animations_running() const noexcept
+  {
+    if (!timeline_.empty()) return true;
+    return util::any_of(extra_timelines_, [](ch::Timeline* tl) { return !tl->empty(); });
+  }
+
+  int UIManager::frame_time_multiplier() noexcept
+  {
+    float load = Application::current().audio_manager->cpu_time();
+    if (!throttle_frames_ && load > 0.8f)
+      throttle_frames_ = true;
+    else if (throttle_frames_ && load < 0.6f)
+      throttle_frames_ = false;
+    return (throttle_frames_ || governor_throttle_.load(std::memory_order_relaxed)) ? 2 : 1;
+  }
+
+  bool UIManager::frame_would_be_identical() const noexcept
+  {
+    if (!cur_screen->has_partial_damage()) return false;
+    auto damage = cur_screen->damage();
+    return damage.width == 0 && damage.height == 0 && !animations_running();
+  }
+
+  void UIManager::skip_frame()
+  {
+    Controller::current().flush_leds();
+
+    step_animations();
+  }
+
 } // namespace otto::services
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include <chrono>
+#include <vector>
 
 #include <json.hpp>
 #include <type_safe/bounded_type.hpp>
@@ -13,6 +15,7 @@
 #include "core/props/props.hpp"
 #include "core/service.hpp"
 #include "core/ui/screen.hpp"
+#include "core/ui/vector_graphics.hpp"
 #include "services/application.hpp"
 
 namespace otto::services {
@@ -58,7 +61,9 @@ namespace otto::services {
               settings,
               external,
               twist1,
-              twist2)
+              twist2,
+              synth2,
+              synth2_selector)
 
   BETTER_ENUM(KeyMode, std::int8_t, midi, seq);
 
@@ -114,10 +119,50 @@ namespace otto::services {
       return timeline_;
     }
 
+    /// Register an extra animation timeline.
+    ///
+    /// The timeline is stepped along with the main one on each frame it has
+    /// motions running, and counts towards the quiescence check behind
+    /// @ref frame_would_be_identical. An empty registered timeline costs a
+    /// pointer chase per frame, so owners (typically screens) can register
+    /// once and leave the timeline in place between animations, but must
+    /// @ref unregister_timeline before the timeline is destroyed.
+    void register_timeline(ch::Timeline& timeline);
+
+    /// Unregister a timeline registered with @ref register_timeline
+    void unregister_timeline(ch::Timeline& timeline) noexcept;
+
+    /// The area of the screen redrawn by the last @ref draw_frame.
+    ///
+    /// Board UI loops can use this to only push the dirty scanlines to the display
+    core::ui::vg::Box last_frame_damage() const noexcept
+    {
+      return frame_damage_;
+    }
+
   protected:
     /// Draws the current screen and overlays.
     void draw_frame(core::ui::vg::Canvas& ctx);
 
+    /// The multiplier board ui loops should apply to their frame time.
+    ///
+    /// Returns 2 - halving the frame rate - while the audio thread is close to its
+    /// deadline (@ref AudioManager::cpu_time), with hysteresis so the rate doesn't
+    /// flap around the threshold. The audio callback deadline always wins over
+    /// UI smoothness.
+    int frame_time_multiplier() noexcept;
+
+    /// Would drawing now produce the same frame as the last one?
+    ///
+    /// True when the current screen tracks damage and has none, and no animations
+    /// are running. Board loops can skip the render entirely and call
+    /// @ref skip_frame instead.
+    bool frame_would_be_identical() const noexcept;
+
+    /// Bookkeeping for a skipped frame - flushes LEDs and steps time, without
+    /// drawing anything
+    void skip_frame();
+
     /// Display a screen.
     ///
     /// Calls @ref Screen::on_hide for the old screen, and then @ref Screen::on_show
@@ -125,6 +170,23 @@ namespace otto::services {
     void display(core::ui::Screen& screen);
 
   private:
+    /// Draw the predicted next screen once, fully transparent and scissored
+    /// away.
+    ///
+    /// Pays the target screen's first-frame costs - lazy construction, text
+    /// layout, path building - on an idle frame instead of at the switch,
+    /// so the swap lands with warm caches
+    void prewarm_next(core::ui::vg::Canvas& ctx);
+
+    /// Step every timeline with running motions, and advance the frame clock.
+    ///
+    /// Timelines without motions are skipped entirely - when the UI is
+    /// quiescent, this only reads the clock.
+    void step_animations();
+
+    /// Does any timeline have motions running?
+    bool animations_running() const noexcept;
+
     struct EmptyScreen : core::ui::Screen {
       void draw(core::ui::vg::Canvas& ctx) {}
     } empty_screen;
@@ -133,10 +195,20 @@ namespace otto::services {
 
     util::enum_map<ScreenEnum, ScreenSelector> screen_selectors_;
 
+    /// Integral of the screen {@ref prewarm_next} should warm up, or -1.
+    /// Set on navigation, cleared once the prewarm has run
+    std::int8_t prewarm_target_ = -1;
+
     unsigned _frame_count = 0;
+    core::ui::vg::Box frame_damage_ = {0, 0, core::ui::vg::width, core::ui::vg::height};
+    bool throttle_frames_ = false;
+    /// Set from the audio thread when the governor sheds the ui tier - see
+    /// the registration in the constructor
+    std::atomic<bool> governor_throttle_ = false;
 
     chrono::time_point last_frame = chrono::clock::now();
     ch::Timeline timeline_;
+    std::vector<ch::Timeline*> extra_timelines_;
   };
 
 } // namespace otto::services
@@ -0,0 +1,153 @@
+#include "allocation_tracker.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <execinfo.h>
+
+#include "services/log_manager.hpp"
+
+namespace otto::util::allocation_tracker {
+
+  static thread_local thread_counters t_counters;
+
+  /// One-shot slot for the first offending allocation seen process-wide.
+  /// Written by the allocation hook, read by {@ref log_first_offender}
+  static void* first_offender[max_trace_frames];
+  static std::atomic<int> first_offender_size = 0;
+
+  thread_counters& counters() noexcept
+  {
+    return t_counters;
+  }
+
+  scope::scope(bool active, bool capture_trace) noexcept : active_(active)
+  {
+    if (!active_) return;
+    saved_ = t_counters;
+    t_counters = {};
+    t_counters.active = true;
+    t_counters.capture_trace = capture_trace;
+  }
+
+  scope::~scope() noexcept
+  {
+    if (!active_) return;
+    saved_.allocations += t_counters.allocations;
+    saved_.bytes += t_counters.bytes;
+    t_counters = saved_;
+  }
+
+  std::uint64_t scope::allocations() const noexcept
+  {
+    return active_ ? t_counters.allocations : 0;
+  }
+
+  std::uint64_t scope::bytes() const noexcept
+  {
+    return active_ ? t_counters.bytes : 0;
+  }
+
+  void log_first_offender()
+  {
+    int size = first_offender_size.load(std::memory_order_acquire);
+    if (size == 0) {
+      LOGI("No offending allocation recorded");
+      return;
+    }
+    char** symbols = ::backtrace_symbols(first_offender, size);
+    LOGE("First offending allocation:");
+    for (int i = 0; i < size; i++) {
+      LOGE("  {}", symbols ? symbols[i] : "??");
+    }
+    std::free(symbols);
+  }
+
+  /// Called from the interposed operators below on every allocation
+  static void record(std::size_t size) noexcept
+  {
+    auto& t = t_counters;
+    if (!t.active || t.in_hook) return;
+    t.allocations++;
+    t.bytes += size;
+    if (t.capture_trace && first_offender_size.load(std::memory_order_relaxed) == 0) {
+      t.in_hook = true;
+      int n = ::backtrace(first_offender, max_trace_frames);
+      first_offender_size.store(n, std::memory_order_release);
+      t.in_hook = false;
+    }
+  }
+
+} // namespace otto::util::allocation_tracker
+
+// The interposed global allocator. Forwards to malloc/free, so it is
+// compatible with allocations made before these symbols are linked in.
+
+void* operator new(std::size_t size)
+{
+  void* ptr = std::malloc(size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  otto::util::allocation_tracker::record(size);
+  return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  void* ptr = std::malloc(size);
+  if (ptr != nullptr) otto::util::allocation_tracker::record(size);
+  return ptr;
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return ::operator new(size, tag);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  void* ptr = nullptr;
+  if (::posix_memalign(&ptr, std::size_t(align), size) != 0) throw std::bad_alloc();
+  otto::util::allocation_tracker::record(size);
+  return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+  return ::operator new(size, align);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace otto::util::allocation_tracker {
+
+  /// Number of return addresses kept from the first allocation seen by a
+  /// trace-capturing {@ref scope}
+  constexpr int max_trace_frames = 32;
+
+  /// Allocation counters for the calling thread.
+  ///
+  /// Counting only happens while a {@ref scope} is alive on the thread - the
+  /// interposed `operator new` costs one thread local read otherwise, so the
+  /// hook is always compiled in.
+  struct thread_counters {
+    bool active = false;
+    bool capture_trace = false;
+    /// Guards against the hook recursing into itself (backtrace may allocate
+    /// the first time it is called)
+    bool in_hook = false;
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+  };
+
+  /// The counters of the calling thread
+  thread_counters& counters() noexcept;
+
+  /// Count heap allocations made by this thread while alive.
+  ///
+  /// The global `operator new`/`operator delete` are interposed in
+  /// `allocation_tracker.cpp`. With `capture_trace`, the return addresses of
+  /// the first offending allocation are kept in a process-wide one-shot slot
+  /// (the capture itself does not allocate), to be symbolized later with
+  /// {@ref log_first_offender} - off the realtime path.
+  ///
+  /// Scopes nest - an inner scope counts separately and adds its totals to
+  /// the outer scope when it dies. An inactive scope is free.
+  struct scope {
+    scope(bool active = true, bool capture_trace = false) noexcept;
+    ~scope() noexcept;
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    /// Allocations made in this scope so far. Zero for an inactive scope
+    std::uint64_t allocations() const noexcept;
+
+    /// Bytes allocated in this scope so far. Zero for an inactive scope
+    std::uint64_t bytes() const noexcept;
+
+  private:
+    bool active_;
+    thread_counters saved_ = {};
+  };
+
+  /// Symbolize and log the backtrace of the first allocation caught by a
+  /// trace-capturing scope, if any. Allocates - never call this from the
+  /// audio thread.
+  void log_first_offender();
+
+} // namespace otto::util::allocation_tracker
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include <gsl/span>
+
+#include "util/assert.hpp"
+
+namespace otto {
+
+  /// A non-owning view of audio data - `gsl::span` minus the release-build cost.
+  ///
+  /// GSL's `Expects` bounds checks survive into our release builds, which puts
+  /// a branch in front of every sample access in the audio hot path.
+  /// `audio_span` indexes raw in release and asserts in debug, and it converts
+  /// implicitly to and from `gsl::span` and anything else with `data()` and
+  /// `size()`, so adopting it is signature-only at the call sites.
+  ///
+  /// For loops that index several buffers, {@ref raw_frames} trades the
+  /// per-access debug check for a single length assertion up front.
+  template<typename T = float>
+  struct audio_span {
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using index_type = std::ptrdiff_t;
+    using pointer = T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    constexpr audio_span() noexcept = default;
+    constexpr audio_span(pointer data, index_type size) noexcept : data_(data), size_(size) {}
+    constexpr audio_span(pointer first, pointer last) noexcept
+      : data_(first), size_(last - first)
+    {}
+
+    /// From anything with `data()` and `size()` over compatible elements -
+    /// `std::array`, `std::vector`, `AudioBufferHandle`, `gsl::span`, ...
+    template<typename C,
+             typename = std::enable_if_t<
+               std::is_convertible_v<decltype(std::declval<C&>().data()), pointer>>>
+    constexpr audio_span(C&& container) noexcept
+      : data_(container.data()), size_(index_type(container.size()))
+    {}
+
+    template<std::size_t N>
+    constexpr audio_span(value_type (&arr)[N]) noexcept : data_(arr), size_(N)
+    {}
+
+    constexpr operator gsl::span<T>() const noexcept
+    {
+      return {data_, size_};
+    }
+
+    constexpr pointer data() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr index_type size() const noexcept
+    {
+      return size_;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+      return size_ == 0;
+    }
+
+    constexpr iterator begin() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr iterator end() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    constexpr const_iterator cbegin() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr const_iterator cend() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    /// Bounds-checked in debug, raw in release
+    T& operator[](index_type i) const noexcept
+    {
+      OTTO_ASSERT(0 <= i && i < size_);
+      return data_[i];
+    }
+
+    T& front() const noexcept
+    {
+      OTTO_ASSERT(size_ > 0);
+      return data_[0];
+    }
+
+    T& back() const noexcept
+    {
+      OTTO_ASSERT(size_ > 0);
+      return data_[size_ - 1];
+    }
+
+    audio_span first(index_type n) const noexcept
+    {
+      OTTO_ASSERT(0 <= n && n <= size_);
+      return {data_, n};
+    }
+
+    audio_span last(index_type n) const noexcept
+    {
+      OTTO_ASSERT(0 <= n && n <= size_);
+      return {data_ + size_ - n, n};
+    }
+
+    /// A subview of `length` elements starting at `idx`. A negative `length`
+    /// means everything from `idx` to the end
+    audio_span subspan(index_type idx, index_type length = -1) const noexcept
+    {
+      OTTO_ASSERT(0 <= idx && idx <= size_);
+      if (length < 0) length = size_ - idx;
+      OTTO_ASSERT(length <= size_ - idx);
+      return {data_ + idx, length};
+    }
+
+  private:
+    pointer data_ = nullptr;
+    index_type size_ = 0;
+  };
+
+  /// Assert once that every span holds at least `nframes`, and get the raw
+  /// pointers for the loop body - one debug check per loop instead of one per
+  /// access.
+  ///
+  /// ```cpp
+  /// auto [out, in] = raw_frames(nframes, out_span, in_span);
+  /// for (int i = 0; i < nframes; i++) out[i] += in[i];
+  /// ```
+  template<typename... Ts>
+  auto raw_frames(std::ptrdiff_t nframes, audio_span<Ts>... spans) noexcept
+  {
+    (OTTO_ASSERT(spans.size() >= nframes), ...);
+    return std::tuple<Ts*...>(spans.data()...);
+  }
+
+} // namespace otto
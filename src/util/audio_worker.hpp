@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include "util/dsp/denormals.hpp"
+
+/// \file
+/// A real-time-safe worker thread for offloading part of the audio callback to a
+/// second core.
+
+namespace otto::util {
+
+  /// A single worker thread with lock-free job handoff.
+  ///
+  /// The audio thread submits exactly one job per block with {@ref submit} and picks the
+  /// result up with {@ref wait}. Neither call allocates, locks or blocks in the kernel -
+  /// the handoff is a single atomic pointer, and waiting is a spin with yields, so this
+  /// is safe to use from the audio callback.
+  ///
+  /// On linux the worker can be pinned to a core, keeping it off the core running the
+  /// audio callback.
+  struct audio_worker {
+    /// Construct the worker, optionally pinning it to `cpu` (linux only, -1 = no pinning)
+    audio_worker(int cpu = -1) : std_thread([this] { run(); })
+    {
+#ifdef __linux__
+      if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(std_thread.native_handle(), sizeof(set), &set);
+      }
+#endif
+    }
+
+    audio_worker(const audio_worker&) = delete;
+
+    ~audio_worker() noexcept
+    {
+      _should_run.store(false, std::memory_order_release);
+      std_thread.join();
+    }
+
+    /// Hand a job to the worker.
+    ///
+    /// `arg` must stay valid until {@ref wait} returns. The usual pattern is a capturing
+    /// lambda on the caller's stack with a captureless thunk:
+    ///
+    /// ```cpp
+    /// auto job = [&] { ... };
+    /// worker.submit([](void* p) { (*static_cast<decltype(job)*>(p))(); }, &job);
+    /// ```
+    void submit(void (*fn)(void*), void* arg) noexcept
+    {
+      _arg.store(arg, std::memory_order_relaxed);
+      _job.store(fn, std::memory_order_release);
+    }
+
+    /// Spin until the submitted job has finished
+    void wait() const noexcept
+    {
+      while (_job.load(std::memory_order_acquire) != nullptr) std::this_thread::yield();
+    }
+
+  private:
+    void run() noexcept
+    {
+      // Jobs are DSP - give this thread the same denormal protection as the
+      // audio callback
+      dsp::flush_denormals_to_zero();
+      while (_should_run.load(std::memory_order_acquire)) {
+        auto* fn = _job.load(std::memory_order_acquire);
+        if (fn == nullptr) {
+          std::this_thread::yield();
+          continue;
+        }
+        fn(_arg.load(std::memory_order_relaxed));
+        _job.store(nullptr, std::memory_order_release);
+      }
+    }
+
+    std::atomic<void (*)(void*)> _job = nullptr;
+    std::atomic<void*> _arg = nullptr;
+    std::atomic_bool _should_run = true;
+    std::thread std_thread;
+  };
+
+} // namespace otto::util
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "util/reflection.hpp"
+
+namespace otto::util {
+
+  /// \defgroup binary_codec
+  ///
+  /// A reflection-driven binary codec for "flat" structs.
+  ///
+  /// For structs registered with `DECL_REFLECTION` whose members are all
+  /// trivially copyable values (directly or wrapped in properties), the
+  /// layout - total size and member order - is known at compile time, and
+  /// encoding/decoding compiles down to a fixed sequence of small memcpys.
+  /// No string keys, no tree walking, no allocation, which makes this
+  /// usable where the json serialization in `util/serialize.hpp` is not.
+  ///
+  /// Members are packed unaligned in declaration order, so the layout is
+  /// exactly as stable as the `DECL_REFLECTION` member list.
+  ///
+  /// \{
+
+  /// How a single value is packed by the binary codec.
+  ///
+  /// The default handles trivially copyable values with a memcpy. Note that
+  /// this covers the `BETTER_ENUM` types used in props, which are trivially
+  /// copyable classes. Specialize for wrapper types that should be packed as
+  /// their underlying value - see the `PropertyImpl` specialization in
+  /// `core/props/props.hpp`.
+  template<typename T, typename Enable = void>
+  struct binary_traits {
+    static constexpr bool is_flat = std::is_trivially_copyable_v<T>;
+    static constexpr std::size_t size = is_flat ? sizeof(T) : 0;
+
+    static void encode(const T& value, std::byte*& out) noexcept
+    {
+      std::memcpy(out, &value, sizeof(T));
+      out += sizeof(T);
+    }
+
+    static void decode(T& value, const std::byte*& in) noexcept
+    {
+      std::memcpy(&value, in, sizeof(T));
+      in += sizeof(T);
+    }
+  };
+
+  template<typename Class>
+  struct binary_layout;
+
+  namespace detail {
+
+    /// Detect `binary_traits` specializations that should win over the
+    /// reflected layout even for registered types - they say so with an
+    /// `overrides_layout` member. See the property specialization in
+    /// `core/props/props.hpp`
+    template<typename T, typename Enable = void>
+    struct traits_override : std::false_type {};
+
+    template<typename T>
+    struct traits_override<T, std::void_t<decltype(binary_traits<T>::overrides_layout)>>
+      : std::true_type {};
+
+    /// Dispatch for a single member: registered classes recurse through
+    /// their own reflected members, everything else goes to `binary_traits`
+    template<typename T, typename Enable = void>
+    struct binary_node : binary_traits<T> {};
+
+    template<typename T>
+    struct binary_node<T, std::enable_if_t<reflect::is_registered<T>() && !traits_override<T>::value>>
+      : binary_layout<T> {};
+
+    /// Fold `is_flat` and `size` over the member list. Purely type-level -
+    /// only the `member_type`s of the reflected members are inspected.
+    template<typename Members>
+    struct fold_members;
+
+    template<typename... Members>
+    struct fold_members<std::tuple<Members...>> {
+      static constexpr bool is_flat = (binary_node<typename Members::member_type>::is_flat && ...);
+      static constexpr std::size_t size =
+        (std::size_t(0) + ... + binary_node<typename Members::member_type>::size);
+    };
+
+  } // namespace detail
+
+  /// Compile-time layout descriptor for a reflected struct.
+  ///
+  /// `is_flat` is true when every reflected member, recursively, packs to a
+  /// fixed-size trivially copyable value. For such structs `size` is the
+  /// exact number of bytes {\ref encode} writes and {\ref decode} reads.
+  template<typename Class>
+  struct binary_layout {
+  private:
+    using Members = decltype(reflect::register_members<Class>());
+
+  public:
+    static constexpr bool is_flat = detail::fold_members<Members>::is_flat;
+    static constexpr std::size_t size = detail::fold_members<Members>::size;
+
+    /// Pack all members of `obj` at `out`, advancing it past them
+    static void encode(const Class& obj, std::byte*& out) noexcept
+    {
+      static_assert(is_flat, "binary_layout can only encode flat structs");
+      reflect::for_all_members<Class>([&](auto& member) { //
+        detail::binary_node<typename std::decay_t<decltype(member)>::member_type>::encode(
+          member.get(obj), out);
+      });
+    }
+
+    /// Unpack all members of `obj` from `in`, advancing it past them.
+    ///
+    /// Members are written through `get_ref` when available, otherwise
+    /// through their setter - so property hooks and change signals fire
+    /// just like they do on the json path.
+    static void decode(Class& obj, const std::byte*& in)
+    {
+      static_assert(is_flat, "binary_layout can only decode flat structs");
+      reflect::for_all_members<Class>([&](auto& member) {
+        using Member = std::decay_t<decltype(member)>;
+        using MT = typename Member::member_type;
+        if constexpr (Member::can_get_ref()) {
+          detail::binary_node<MT>::decode(member.get_ref(obj), in);
+        } else {
+          MT value{};
+          detail::binary_node<MT>::decode(value, in);
+          member.set(obj, std::move(value));
+        }
+      });
+    }
+  };
+
+  /// Encode `obj` into exactly `binary_layout<Class>::size` bytes at `out`
+  template<typename Class>
+  void binary_encode(const Class& obj, std::byte* out) noexcept
+  {
+    binary_layout<Class>::encode(obj, out);
+  }
+
+  /// Decode `obj` from exactly `binary_layout<Class>::size` bytes at `in`
+  template<typename Class>
+  void binary_decode(Class& obj, const std::byte* in)
+  {
+    binary_layout<Class>::decode(obj, in);
+  }
+
+  /// \}
+
+} // namespace otto::util
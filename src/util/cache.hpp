@@ -1,38 +1,89 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <vector>
+
 #include "util/type_traits.hpp"
 
 namespace otto::util {
 
+  /// The invalidation handle of a cache - the non-template part.
+  ///
+  /// Holds an atomic generation counter. `invalidate()` just bumps the
+  /// counter, so it is safe to call from any thread - typically the logic
+  /// thread invalidates when a property changes, and the UI thread refreshes
+  /// lazily on the next read. The release/acquire pairing on the counter also
+  /// makes the writes that happened before `invalidate()` visible to the
+  /// refresh that observes it.
+  ///
+  /// Other caches can depend on a node through \ref cache_base::depends_on(),
+  /// and will lazily refresh when it is invalidated.
+  struct cache_node {
+    /// Invalidate the cache. Thread safe, wait-free
+    void invalidate() noexcept
+    {
+      _target.fetch_add(1, std::memory_order_release);
+    }
+
+    /// The current generation - bumped by every `invalidate()`
+    std::uint32_t generation() const noexcept
+    {
+      return _target.load(std::memory_order_acquire);
+    }
+
+  protected:
+    std::atomic<std::uint32_t> _target = {1};
+  };
 
   /// A CRTP style cache base class.
   ///
-  /// The cached value is imutable, and lazilly refreshed.
-  /// This wrapper is not thread safe at invalidation!
+  /// The cached value is imutable, and lazilly refreshed on `value()`.
+  ///
+  /// `invalidate()` can be called from any thread, but `value()` and
+  /// `depends_on()` must only be called from the single thread that owns the
+  /// cache - usually the UI thread.
+  ///
+  /// A cache can be chained onto other caches with `depends_on(parent)`:
+  /// invalidating the parent makes this node stale too, and it refreshes at
+  /// most once per read after that, however many times the parent was
+  /// invalidated in between.
   ///
   /// \requires `T` shall be `DefaultConstructible`
   template<typename T>
-  struct cache_base {
-
-    /// Invalidate the cache
-    void invalidate()
+  struct cache_base : cache_node {
+    /// Check if the cache is valid
+    bool valid() const
     {
-      _valid = false;
+      if (_refreshed != generation()) return false;
+      for (auto& par : _parents) {
+        if (par.last_seen != par.node->generation()) return false;
+      }
+      return true;
     }
 
-    /// Check if the cache is valid
-    bool valid() const
+    /// Refresh this cache whenever `parent` has been invalidated.
+    ///
+    /// Call during setup, from the thread that owns the cache. `parent` must
+    /// outlive this cache.
+    void depends_on(cache_node& parent)
     {
-      return _valid;
+      _parents.push_back({&parent, 0});
     }
 
-    /// Access the cached value
+    /// Access the cached value, refreshing it if invalid
     const T& value()
     {
-      if (!_valid) {
+      auto target = generation();
+      bool stale = _refreshed != target;
+      for (auto& par : _parents) {
+        stale = stale || par.last_seen != par.node->generation();
+      }
+      if (stale) {
         refresh();
-        _valid = true;
+        _refreshed = target;
+        for (auto& par : _parents) par.last_seen = par.node->generation();
       }
       return dynamic_cast<const T&>(*this);
     }
@@ -40,27 +91,35 @@ namespace otto::util {
     /// Access the cached value
     ///
     /// Alias to `value()`
-    const T* operator->() {
+    const T* operator->()
+    {
       return &value();
     }
 
     /// Access the cached value
     ///
     /// Alias to `value()`
-    const T& operator*() {
+    const T& operator*()
+    {
       return value();
     }
 
   protected:
-
     /// Refresh the cache
     ///
     /// It should be implemented in the derived class, and it is called by
     /// `value()` when the cache is invalid
     virtual void refresh() = 0;
 
-    bool _valid = false;
-
+  private:
+    struct Parent {
+      cache_node* node;
+      std::uint32_t last_seen;
+    };
+
+    /// Only touched by the owning thread
+    std::uint32_t _refreshed = 0;
+    std::vector<Parent> _parents;
   };
 
   /// A simple wrapper for invalidatable caches.
@@ -68,8 +127,8 @@ namespace otto::util {
   /// If you are writing a separate struct to contain the cache data, use
   /// `cache_base` instead.
   ///
-  /// The cached value is imutable, and lazilly refreshed.
-  /// This wrapper is not thread safe at invalidation!
+  /// The cached value is imutable, and lazilly refreshed. Like `cache_base`,
+  /// invalidation is thread safe, reading is not.
   ///
   /// It is constructed with a generator function, which can take two forms:
   ///
@@ -81,35 +140,55 @@ namespace otto::util {
   ///
   /// \requires `T` shall be `DefaultConstructible`
   template<typename T>
-  struct cached : cache_base<T> {
-
+  struct cached : cache_base<cached<T>> {
     template<typename FuncRef>
-    cached(FuncRef&& f)
-      : generator(make_generator(std::forward<FuncRef>(f)))
+    cached(FuncRef&& f) : generator(make_generator(std::forward<FuncRef>(f)))
     {}
 
-  private:
+    /// Access the cached value, refreshing it if invalid
+    const T& value()
+    {
+      cache_base<cached<T>>::value();
+      return cache;
+    }
 
-    void refresh() override {
-      generator(cache_base<T>::cache);
+    /// Access the cached value
+    ///
+    /// Alias to `value()`
+    const T* operator->()
+    {
+      return &value();
     }
 
+    /// Access the cached value
+    ///
+    /// Alias to `value()`
+    const T& operator*()
+    {
+      return value();
+    }
+
+  private:
+    void refresh() override
+    {
+      generator(cache);
+    }
+
+    T cache = {};
     std::function<void(T&)> generator;
 
     /// Creates the apropriate generator function from the two valid signatures
     ///
     /// Used in the constructor
     template<typename Fr>
-    static auto make_generator(Fr&& fr) {
+    static auto make_generator(Fr&& fr)
+    {
       if constexpr (util::is_invocable_v<Fr, T&>) {
         return fr;
       } else if constexpr (std::is_same_v<util::invoke_result_t<Fr>, T>) {
-        return [fr = std::forward<Fr>(fr)] (T& cache) {
-          cache = std::invoke(fr);
-        };
+        return [fr = std::forward<Fr>(fr)](T& cache) { cache = std::invoke(fr); };
       }
     }
-
   };
 
-}
+} // namespace otto::util
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace otto::util {
+
+  /// A fixed-capacity callable - `std::function` minus the heap.
+  ///
+  /// Stores the callable in an inline buffer of {@ref capacity} bytes and
+  /// dispatches through a plain function pointer. Unlike `std::function` it
+  /// never allocates - a callable that does not fit the buffer is a compile
+  /// error, not a silent heap allocation. Capturing `this` and a value or two
+  /// fits; anything bigger should capture a pointer to state that lives
+  /// elsewhere.
+  ///
+  /// Used by \ref Signal for property change hooks, where hundreds of
+  /// instances exist and dispatch happens on every encoder step.
+  template<typename Signature>
+  struct delegate;
+
+  template<typename R, typename... Args>
+  struct delegate<R(Args...)> {
+    /// Room for two pointers' worth of captured state
+    static constexpr std::size_t capacity = 2 * sizeof(void*);
+
+    constexpr delegate() noexcept = default;
+    constexpr delegate(std::nullptr_t) noexcept {}
+
+    template<typename F,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, delegate> &&
+                                         std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    delegate(F&& func) noexcept
+    {
+      assign(std::forward<F>(func));
+    }
+
+    delegate(const delegate& rhs)
+    {
+      if (rhs._manage) rhs._manage(Op::copy, &_storage, &rhs._storage);
+      _invoke = rhs._invoke;
+      _manage = rhs._manage;
+    }
+
+    delegate(delegate&& rhs) noexcept
+    {
+      if (rhs._manage) rhs._manage(Op::move, &_storage, &rhs._storage);
+      _invoke = std::exchange(rhs._invoke, nullptr);
+      _manage = std::exchange(rhs._manage, nullptr);
+    }
+
+    delegate& operator=(const delegate& rhs)
+    {
+      if (this == &rhs) return *this;
+      reset();
+      if (rhs._manage) rhs._manage(Op::copy, &_storage, &rhs._storage);
+      _invoke = rhs._invoke;
+      _manage = rhs._manage;
+      return *this;
+    }
+
+    delegate& operator=(delegate&& rhs) noexcept
+    {
+      if (this == &rhs) return *this;
+      reset();
+      if (rhs._manage) rhs._manage(Op::move, &_storage, &rhs._storage);
+      _invoke = std::exchange(rhs._invoke, nullptr);
+      _manage = std::exchange(rhs._manage, nullptr);
+      return *this;
+    }
+
+    delegate& operator=(std::nullptr_t) noexcept
+    {
+      reset();
+      return *this;
+    }
+
+    template<typename F,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, delegate> &&
+                                         std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    delegate& operator=(F&& func) noexcept
+    {
+      reset();
+      assign(std::forward<F>(func));
+      return *this;
+    }
+
+    ~delegate() noexcept
+    {
+      reset();
+    }
+
+    R operator()(Args... args) const
+    {
+      return _invoke(&_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+      return _invoke != nullptr;
+    }
+
+  private:
+    enum struct Op { copy, move, destroy };
+    using Storage = std::aligned_storage_t<capacity, alignof(void*)>;
+
+    void reset() noexcept
+    {
+      if (_manage) _manage(Op::destroy, nullptr, &_storage);
+      _invoke = nullptr;
+      _manage = nullptr;
+    }
+
+    template<typename F>
+    void assign(F&& func) noexcept
+    {
+      using Func = std::decay_t<F>;
+      static_assert(sizeof(Func) <= capacity,
+                    "Callable too large for delegate - capture a pointer to the state instead");
+      static_assert(alignof(Func) <= alignof(Storage),
+                    "Callable over-aligned for delegate storage");
+      static_assert(std::is_nothrow_move_constructible_v<Func>,
+                    "delegate requires a nothrow move constructible callable");
+      new (&_storage) Func(std::forward<F>(func));
+      _invoke = [](const Storage* s, Args... args) -> R {
+        return (*reinterpret_cast<Func*>(const_cast<Storage*>(s)))(std::forward<Args>(args)...);
+      };
+      _manage = [](Op op, Storage* dst, const Storage* src) {
+        auto& f = *reinterpret_cast<Func*>(const_cast<Storage*>(src));
+        switch (op) {
+          case Op::copy: new (dst) Func(f); break;
+          case Op::move:
+            new (dst) Func(std::move(f));
+            f.~Func();
+            break;
+          case Op::destroy: f.~Func(); break;
+        }
+      };
+    }
+
+    mutable Storage _storage;
+    R (*_invoke)(const Storage*, Args...) = nullptr;
+    void (*_manage)(Op, Storage*, const Storage*) = nullptr;
+  };
+
+  template<typename Signature>
+  bool operator==(const delegate<Signature>& d, std::nullptr_t) noexcept
+  {
+    return !d;
+  }
+  template<typename Signature>
+  bool operator==(std::nullptr_t, const delegate<Signature>& d) noexcept
+  {
+    return !d;
+  }
+  template<typename Signature>
+  bool operator!=(const delegate<Signature>& d, std::nullptr_t) noexcept
+  {
+    return bool(d);
+  }
+  template<typename Signature>
+  bool operator!=(std::nullptr_t, const delegate<Signature>& d) noexcept
+  {
+    return bool(d);
+  }
+
+} // namespace otto::util
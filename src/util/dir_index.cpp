@@ -0,0 +1,108 @@
+#include "dir_index.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <map>
+#include <mutex>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace otto::util {
+
+  namespace {
+    /// A directory in a cached tree, identified by its path relative to the
+    /// root ("" for the root itself) and the mtime it had when scanned
+    struct CachedDir {
+      std::string rel;
+      std::time_t mtime;
+    };
+
+    struct CachedTree {
+      std::vector<std::string> files;
+      std::vector<CachedDir> dirs;
+    };
+
+    std::mutex cache_mutex;
+    std::map<std::string, CachedTree> cache;
+
+    std::string join(const std::string& base, const std::string& rel)
+    {
+      if (base.empty()) return rel;
+      if (rel.empty()) return base;
+      return base + "/" + rel;
+    }
+
+    /// Do the directory mtimes still match the cached scan? Adding, removing
+    /// or renaming an entry bumps its parent's mtime, so this catches every
+    /// change to the set of files - only in-place rewrites slip through
+    bool still_valid(const std::string& root, const CachedTree& tree)
+    {
+      struct stat st;
+      for (auto& dir : tree.dirs) {
+        if (::stat(join(root, dir.rel).c_str(), &st) != 0) return false;
+        if (!S_ISDIR(st.st_mode) || st.st_mtime != dir.mtime) return false;
+      }
+      return true;
+    }
+
+    bool scan_cold(const std::string& root, CachedTree& out)
+    {
+      std::vector<std::string> pending = {""};
+      while (!pending.empty()) {
+        auto rel = std::move(pending.back());
+        pending.pop_back();
+        const auto abs = join(root, rel);
+        DIR* dir = ::opendir(abs.c_str());
+        if (dir == nullptr) {
+          if (rel.empty()) return false;
+          continue;
+        }
+        struct stat st;
+        if (::stat(abs.c_str(), &st) == 0) out.dirs.push_back({rel, st.st_mtime});
+        const auto& dir_rel = rel;
+        while (auto* ent = ::readdir(dir)) {
+          std::string name = ent->d_name;
+          if (name.empty() || name[0] == '.') continue;
+          auto type = ent->d_type;
+          if (type == DT_UNKNOWN || type == DT_LNK) {
+            // Filesystems without d_type, and symlinks - one stat fallback
+            if (::stat((abs + "/" + name).c_str(), &st) != 0) continue;
+            type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+          }
+          if (type == DT_DIR) {
+            pending.push_back(join(dir_rel, name));
+          } else if (type == DT_REG) {
+            out.files.push_back(join(dir_rel, name));
+          }
+        }
+        ::closedir(dir);
+      }
+      std::sort(out.files.begin(), out.files.end());
+      return true;
+    }
+  } // namespace
+
+  std::vector<std::string> scan_tree(const fs::path& root)
+  {
+    const auto key = root.string();
+    std::unique_lock lock{cache_mutex};
+    auto found = cache.find(key);
+    if (found != cache.end() && still_valid(key, found->second)) return found->second.files;
+
+    CachedTree tree;
+    if (!scan_cold(key, tree)) {
+      cache.erase(key);
+      return {};
+    }
+    auto& slot = cache[key] = std::move(tree);
+    return slot.files;
+  }
+
+  void invalidate_tree(const fs::path& root)
+  {
+    std::unique_lock lock{cache_mutex};
+    cache.erase(root.string());
+  }
+
+} // namespace otto::util
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "util/filesystem.hpp"
+
+namespace otto::util {
+
+  /// Recursively list the regular files under `root`, as sorted paths relative
+  /// to `root`.
+  ///
+  /// The listing is cached per root. A repeated scan re-checks only the
+  /// directory mtimes - one stat per directory, not per file - and serves the
+  /// result from memory when nothing changed. A cold scan is a single readdir
+  /// pass per directory, taking the entry type from the dirent instead of
+  /// stat'ing every file. Hidden files and directories (leading '.') are
+  /// skipped, which also keeps the sample cache out of sample listings.
+  ///
+  /// Thread safe. Does disk i/o - not for the audio thread. A missing or
+  /// unreadable root yields an empty listing.
+  std::vector<std::string> scan_tree(const fs::path& root);
+
+  /// Drop the cached listing for `root`, forcing the next scan cold
+  void invalidate_tree(const fs::path& root);
+
+} // namespace otto::util
@@ -57,6 +57,14 @@ public:
     /// Generate next value
     Tv operator()();
 
+    /// Generate a block of envelope values into `out`
+
+    /// Unlike \ref operator()() this does not call the voice function per sample.
+    /// Each segment is rendered with a tight inner loop that only steps the curve
+    /// recursion, so there is no per-sample dispatch of any kind. Segment boundary
+    /// logic runs at most N times per block.
+    void generate(Tv* out, unsigned n);
+
     /// Release the envelope
     void release();
 
@@ -311,6 +319,43 @@ inline Tv Env_lite<N,Tv,Tp,Td>::operator()(){
   return mLevels[mStage];
 }
 
+template <int N,class Tv,class Tp,class Td>
+void Env_lite<N,Tv,Tp,Td>::generate(Tv* out, unsigned n){
+  unsigned i = 0;
+  while(i < n){
+    // Sustain and done hold a constant level - fill the rest of the block at once
+    if(sustained()){
+      Tv lvl = mLevels[mStage];
+      for(; i<n; ++i) out[i] = lvl;
+      return;
+    }
+    if(done()){
+      Tv lvl = mLevels[mStage];
+      for(; i<n; ++i) out[i] = lvl;
+      return;
+    }
+    // Interpolating along segment - tight loop up to the segment boundary
+    if(mPos < mLen){
+      unsigned count = mLen - mPos;
+      if(count > n - i) count = n - i;
+      for(unsigned j=0; j<count; ++j) out[i+j] = mCurve();
+      mPos += count;
+      i += count;
+      continue;
+    }
+    // Advance to next segment, as in operator()
+    ++mStage;
+    if(mLoop && done()) mStage=0;
+    if(!done()){
+      mPos = 0;
+      setLen(mStage);
+      int nextStage = mStage+1;
+      if(mLoop && (nextStage==size())) nextStage = 0;
+      mCurve.set(mLen, mCurves[mStage], mLevels[mStage], mLevels[nextStage]);
+    }
+  }
+}
+
 template <int N,class Tv,class Tp,class Td>
 void Env_lite<N,Tv,Tp,Td>::release(){
 
@@ -1,3 +1,6 @@
+#include <array>
+#include <cmath>
+
 #include "Gamma/ipl.h"
 #include "Gamma/scl.h"
 #include "Gamma/Containers.h"
@@ -5,6 +8,61 @@
 #include "Gamma/Types.h"
 #include "Gamma/Filter.h"
 
+#include "util/dsp/denormals.hpp"
+#include "util/math.hpp"
+
+/// Log-spaced table of (cos w, sin w) for biquad coefficient updates.
+///
+/// Every coefficient recalculation needs the cosine and sine of the normalized
+/// center frequency w - the rest is a handful of multiplies. Encoder sweeps
+/// recalculate hundreds of times per second on the audio thread, so the trig
+/// is replaced by a lookup with linear interpolation between log-spaced
+/// entries. Indexing by w directly makes the table independent of the sample
+/// rate, so rate changes cost nothing.
+///
+/// 1024 entries over w in [1e-4, 3.13] keep the interpolation error below
+/// 2e-4, which shifts a cutoff by well under a cent.
+class BiquadTrigTable {
+public:
+    static constexpr int size = 1024;
+    static constexpr float w_min = 1e-4f;
+    static constexpr float w_max = 3.13f;
+
+    static const BiquadTrigTable& instance(){
+      // Filters call freq() from their constructors, so this is built at
+      // startup, never on the audio thread
+      static const BiquadTrigTable table;
+      return table;
+    }
+
+    /// Look up cos(w) and sin(w). `w` is clamped to the table range
+    void lookup(float w, float& cosw, float& sinw) const {
+      float t = (otto::util::math::fastlog2(w) - log2_w_min_) * idx_scale_;
+      t = t < 0.f ? 0.f : (t > float(size - 1) ? float(size - 1) : t);
+      const int i = int(t);
+      const float fr = t - float(i);
+      cosw = cos_[i] + (cos_[i + 1] - cos_[i]) * fr;
+      sinw = sin_[i] + (sin_[i + 1] - sin_[i]) * fr;
+    }
+
+private:
+    BiquadTrigTable(){
+      log2_w_min_ = std::log2(w_min);
+      idx_scale_ = float(size - 1) / (std::log2(w_max) - log2_w_min_);
+      for (int i = 0; i <= size; ++i) {
+        const float w = std::exp2(log2_w_min_ + float(i) / idx_scale_);
+        cos_[i] = std::cos(w);
+        sin_[i] = std::sin(w);
+      }
+    }
+
+    /// One entry past `size`, so the interpolation never needs a branch
+    std::array<float, size + 1> cos_;
+    std::array<float, size + 1> sin_;
+    float log2_w_min_;
+    float idx_scale_;
+};
+
 template <class T=gam::real, class Td=gam::DomainObserver>
 class PanFromConstant : public Td{
 public:
@@ -79,6 +137,7 @@ public:
     void zero();						///< Zero internal delays. Softly.
     void smoothOutput();    ///< Manual smoothing of the output
     void smoothTime(Tp time); ///< Set smoothing time
+    void flushDenormals();  ///< Flush denormal inner delays to zero. Call once per block
 
     Tv operator()(Tv in);				///< Filter next sample
     Tv nextBP(Tv in);					///< Optimized for band-pass types
@@ -156,6 +215,15 @@ void BiquadSoftReset<Tv,Tp,Td>::smoothOutput(){
   smooth = o0;
 }
 
+template <class Tv, class Tp, class Td>
+void BiquadSoftReset<Tv,Tp,Td>::flushDenormals(){
+  // Backstop for threads without FTZ mode - a decaying tail parks d1/d2 in
+  // denormal range, and every sample after that multiplies by them
+  d1 = otto::util::dsp::flush_denormal(d1);
+  d2 = otto::util::dsp::flush_denormal(d2);
+  o0 = otto::util::dsp::flush_denormal(o0);
+}
+
 template <class Tv, class Tp, class Td>
 void BiquadSoftReset<Tv,Tp,Td>::smoothTime(Tp time){
   smooth.period(time);
@@ -170,8 +238,10 @@ template <class Tv, class Tp, class Td>
 inline void BiquadSoftReset<Tv,Tp,Td>::freq(Tp v){
   mFreq = v;
   Tp w = gam::scl::clip(mFreq * mFrqToRad, Tp(3.13));
-  mReal = gam::scl::cosT8(w);
-  mImag = gam::scl::sinT7(w);
+  float real, imag;
+  BiquadTrigTable::instance().lookup(float(w), real, imag);
+  mReal = Tp(real);
+  mImag = Tp(imag);
   resRecip(mResRecip);
 }
 
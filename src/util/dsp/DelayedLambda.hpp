@@ -1,15 +1,55 @@
-#include <functional>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <Gamma/Domain.h>
 
-template <class Td=gam::DomainObserver>
+/// Fixed-size inline callable storage - a `std::function<void()>` that never
+/// allocates.
+///
+/// Capturing lambdas are placed into an aligned inline buffer; anything larger
+/// than `Size` bytes, or with a non-trivially-copyable capture, is rejected at
+/// compile time. That keeps `operator new` out of anything scheduled near the
+/// audio path.
+template <std::size_t Size = 32>
+class InlineLambda {
+public:
+    InlineLambda() noexcept = default;
+
+    template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineLambda>>>
+    InlineLambda(F fct) noexcept {
+      static_assert(sizeof(F) <= Size, "InlineLambda: capture too large for the inline storage");
+      static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>,
+                    "InlineLambda: captures must be trivially copyable - no owning captures");
+      new (storage_) F(std::move(fct));
+      invoke_ = [](void* s) { (*std::launder(reinterpret_cast<F*>(s)))(); };
+    }
+
+    void operator()() { invoke_(storage_); }
+
+    explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+private:
+    alignas(std::max_align_t) unsigned char storage_[Size];
+    void (*invoke_)(void*) = nullptr;
+};
+
+
+/// Runs a callable a fixed time after reset() - used to schedule parameter
+/// changes near the audio path. The callable lives in inline storage, so
+/// neither construction nor firing ever allocates.
+template <class Td=gam::DomainObserver, std::size_t Size = 32>
 class DelayedLambda : public Td{
 public:
 
-    DelayedLambda(float delay_in_s, std::function<void()> fct) : fct_(fct) {
+    DelayedLambda(float delay_in_s, InlineLambda<Size> fct) : fct_(fct) {
       delay_in_samples = delay_in_s * Td::spu();
     };
 
     void operator()();
+    /// Advance a whole block, firing the action if it comes due within it.
+    /// Equivalent to `nframes` per-sample calls, but the check runs once
+    void advance(int nframes);
     void reset();
     void finish();
 
@@ -17,11 +57,11 @@ private:
     int delay_in_samples = 0;
     int mDel = 0;
     bool running = false;
-    std::function<void()> fct_;
+    InlineLambda<Size> fct_;
 };
 
-template <class Td>
-void DelayedLambda<Td>::operator()(){
+template <class Td, std::size_t Size>
+void DelayedLambda<Td, Size>::operator()(){
   if (mDel == delay_in_samples) {
     fct_();
     mDel++;
@@ -30,14 +70,26 @@ void DelayedLambda<Td>::operator()(){
   if (running) mDel++;
 }
 
-template <class Td>
-void DelayedLambda<Td>::reset() {
+template <class Td, std::size_t Size>
+void DelayedLambda<Td, Size>::advance(int nframes){
+  if (!running) return;
+  if (mDel + nframes > delay_in_samples) {
+    fct_();
+    mDel = delay_in_samples + 1;
+    running = false;
+  } else {
+    mDel += nframes;
+  }
+}
+
+template <class Td, std::size_t Size>
+void DelayedLambda<Td, Size>::reset() {
   mDel = 0;
   running = true;
 }
 
-template <class Td>
-void DelayedLambda<Td>::finish() {
+template <class Td, std::size_t Size>
+void DelayedLambda<Td, Size>::finish() {
   mDel = delay_in_samples + 1;
   running = false;
-}
\ No newline at end of file
+}
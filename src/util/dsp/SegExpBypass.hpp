@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cfloat> /* DBL_MAX, FLT_MAX */
+#include <cmath>
 #include <Gamma/gen.h>
 #include <Gamma/ipl.h>
 #include <Gamma/scl.h>
@@ -47,6 +48,55 @@ public:
 
     T getEnd() { return mVal0; }
 
+    /// Advance the segment `n` samples and return the value there.
+    ///
+    /// The normalized curve is `(1 - b^t) / (1 - b^len)`, so the position after
+    /// `n` steps is closed-form - one pow per block instead of a multiply and a
+    /// target check per sample. Used where only the block-boundary value
+    /// matters, like the voice glide
+    T skip(int n){
+      if(done()) return mVal0;
+      if(mSamples < T(1) || mOneMinusB == T(0)){
+        // Degenerate segment - step through like the scalar path would
+        T res = mVal0;
+        for(int i=0; i<n; ++i) res = (*this)();
+        return res;
+      }
+      T r0 = T(1) - mCurve.value() * mOneMinusB;
+      T c = (T(1) - r0 * std::pow(mRatio, T(n))) / mOneMinusB;
+      mCurve.value(c);
+      return gam::ipl::linear(gam::scl::min(c, T(1)), mVal1, mVal0);
+    }
+
+    /// Fill `n` samples, equivalent to calling the object `n` times.
+    ///
+    /// The segment is written as a geometric ramp - one multiply-add per sample
+    /// with the per-sample ratio precomputed in set() - and completion is
+    /// detected once up front, so there is no target-check branch in the loop
+    void generate(T* out, int n){
+      if(done()){ for(int i=0; i<n; ++i) out[i] = mVal0; return; }
+      if(mSamples < T(1) || mOneMinusB == T(0)){
+        for(int i=0; i<n; ++i) out[i] = (*this)();
+        return;
+      }
+      T c0 = mCurve.value();
+      T r0 = T(1) - c0 * mOneMinusB;
+      // Samples left until the curve reaches 1
+      T remaining = mSamples * (T(1) - std::log(r0) / mCrv);
+      int m = int(remaining);
+      if(m > n) m = n;
+      // out[i] = k1 + g * ratio^(i+1) - the lerp of the curve, refactored so the
+      // frequency-dependent factor is the only thing that moves
+      T scale = (mVal0 - mVal1) / mOneMinusB;
+      T k1 = mVal1 + scale;
+      T g = -scale * r0;
+      for(int i=0; i<m; ++i){ g *= mRatio; out[i] = k1 + g; }
+      for(int i=m; i<n; ++i) out[i] = mVal0;
+      // Sync the curve to where per-sample stepping would have left it
+      if(m < n) mCurve.value(T(1));
+      else mCurve.value((T(1) - r0 * std::pow(mRatio, T(n))) / mOneMinusB);
+    }
+
     /// Set curvature.  Negative gives faster change, positive gives slower change.
     void curve(T v){ set(mLen, v); }
 
@@ -58,13 +108,19 @@ public:
     /// Set length and curvature
     void set(T len, T crv){
       mLen = len; mCrv = crv;
-      mCurve.set(len * Td::spu(), crv);
+      mSamples = len * Td::spu();
+      mOneMinusB = T(1) - std::exp(crv);
+      mRatio = mSamples >= T(1) ? std::exp(crv / mSamples) : T(1);
+      mCurve.set(mSamples, crv);
     }
 
     void onDomainChange(double r){ set(mLen, mCrv); }
 
 protected:
     T mLen, mCrv, mVal1, mVal0;
+    T mSamples = 0;   ///< Segment length in samples
+    T mRatio = 1;     ///< Per-sample geometric ratio b for the block variants
+    T mOneMinusB = 0; ///< 1 - b^len, the curve normalization
     gam::Curve<T,T> mCurve;
 };
 
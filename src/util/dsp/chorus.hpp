@@ -1,6 +1,48 @@
+#include <array>
+#include <cmath>
+#include <vector>
+
 #include <Gamma/ipl.h>
 #include <Gamma/Delay.h>
 
+#include "util/dsp/delay_line.hpp"
+#include "util/dsp/mix_kernels.hpp"
+
+/// Shared sine table for the chorus modulators.
+///
+/// The taps are modulated by six slow sines. Generating a block's modulation
+/// curves from one table with linear interpolation replaces the per-sample
+/// oscillator objects - at sub-hertz rates the interpolation error is far
+/// below the depth of a single sample of delay.
+class ChorusLfoTable {
+public:
+    static constexpr int size = 1024;
+
+    static const ChorusLfoTable& instance(){
+      // Built on first use during engine construction, never on the audio thread
+      static const ChorusLfoTable table;
+      return table;
+    }
+
+    /// Look up sin(2 pi phase). `phase` is in cycles, any non-negative value
+    float lookup(float phase) const {
+      float t = (phase - float(int(phase))) * float(size);
+      const int i = int(t);
+      const float fr = t - float(i);
+      return sin_[i] + (sin_[i + 1] - sin_[i]) * fr;
+    }
+
+private:
+    ChorusLfoTable(){
+      for (int i = 0; i <= size; ++i) {
+        sin_[i] = std::sin(2.0 * M_PI * double(i) / double(size));
+      }
+    }
+
+    /// One entry past `size`, so the interpolation never needs a wrap branch
+    std::array<float, size + 1> sin_;
+};
+
 /// Variable length delay-line with feedback and/or feedforward.
 
 /// The general comb filter transfer function provides N evenly spaced poles
@@ -11,27 +53,18 @@
 /// other, an Nth order all-pass filter results. Comb filters are stable as
 /// long as |feedback| < 1.
 ///
-/// \tparam Tv	Value (sample) type
-/// \tparam Si	Interpolation strategy
-/// \tparam Tp	Parameter type
-/// \tparam Td	Domain type
+/// Backed by otto::util::dsp::delay_line - the four taps are read in one
+/// interpolated NEON gather with bitmask wrapping, instead of Gamma's
+/// per-sample generic wrapping.
+///
 /// \ingroup Delay Filter
 // H(z) = (ffd + z^-m) / (1 - fbk z^-m)
 // y[n] = ffd x[n] + x[n-m] + fbk y[n-m]
-template<
-        class Tv = gam::real,
-        template <class> class Si = gam::ipl::Linear,
-        class Tp = gam::real,
-        class Td = gam::DomainObserver
->
-class ChorusComb : public gam::Multitap<Tv,Si,Td> {
-private:
-    typedef gam::Multitap<Tv,Si,Td> Base;
-
+class ChorusComb {
 public:
-    /// \param[in]	delay		Delay length. The size of the delay line will
-    ///							be the smallest possible power of two.
-    /// \param[in]  N       Number of taps on the delay line.
+    using Tp = gam::real;
+
+    /// \param[in]	delayMax	Maximum delay length, in seconds
     /// \param[in]	ffd			Feedforward amount, in [-1, 1]
     /// \param[in]	fbk			Feedback amount, in (-1, 1)
     ChorusComb(float delayMax, const Tp& ffd = Tp(0), const Tp& fbk = Tp(0));
@@ -47,14 +80,29 @@ public:
     /// Sets feedback to argument and feedforward to argument negated
     void allPass(const Tp& v);
 
+    ChorusComb& maxDelay(float v){ mMaxDelay = v; return *this; }
     void fbk(const Tp& v);					///< Set feedback amount, in (-1, 1)
     void ffd(const Tp& v);					///< Set feedforward amount [-1, 1]
     void feeds(const Tp& fwd, const Tp& bwd){ ffd(fwd); fbk(bwd); }
 
     void set(float delay, const Tp& ffd, const Tp& fbk); ///< Set several parameters
-    void set_delays(float d0, float d1, float d2, float d3);
+    void set_delays(float d0, float d1, float d2, float d3); ///< Set all four tap delays, in seconds
+
+    /// Attach line memory from the {@ref otto::util::dsp::DelayArena} - safe per block
+    void arm() noexcept { mLine.arm(); }
+    /// Hand the line memory back, dropping the delayed signal with it
+    void disarm() noexcept { mLine.disarm(); }
+
+    void operator()(float in, float& oL, float& oR);				///< Returns next filtered value
 
-    void operator()(const Tv& in, Tv& oL, Tv& oR);				///< Returns next filtered value
+    /// Process a block with per-sample tap delay curves (in seconds).
+    ///
+    /// Three phases, like the reverb tank: the feedback pass runs the line as
+    /// a comb at the constant tap 3, then all modulated tap reads happen as
+    /// block gather+lerp over the line, then the taps are mixed into the
+    /// outputs with the span kernels
+    void process_block(const float* in, float* oL, float* oR,
+                       const float* d0, const float* d1, const float* d2, float d3, std::size_t n);
 
     float norm() const;				///< Get unity gain scale factor
     float normFbk() const;			///< Get unity gain scale factor due to feedback
@@ -63,44 +111,94 @@ public:
     Tp fbk() const;					///< Get feedback amount
 
 protected:
+    /// Convert a delay in seconds to samples, clamped to the line capacity
+    float to_samples(float delay) const;
+
     Tp mFFD, mFBK;
+    float mDelay = 0.f;		///< Main delay (tap 0), in seconds. Used by decay()
+    float mMaxDelay;		///< Maximum delay, in seconds
+    std::array<float, 4> mTaps = {};	///< Tap delays, in samples
+    /// Block scratch - three converted tap curves followed by three tap reads
+    std::vector<float> scratch_;
+    /// 4096 samples is ~93 ms at 44.1 kHz - comfortably above the 42 ms the
+    /// chorus engine modulates up to. Arena-backed, so a standby chorus holds
+    /// no line memory - the owner arms it before processing
+    otto::util::dsp::arena_delay_line<4096> mLine;
 };
 
-#define TM1 template<class Tv, template<class> class Si, class Tp, class Td>
-#define TM2 Tv,Si,Tp,Td
-
-TM1 ChorusComb<TM2>::ChorusComb(float delayMax, const Tp& ffd, const Tp& fbk)
-        :	gam::Multitap<Tv,Si,Td>(delayMax, 4), mFFD(ffd), mFBK(fbk)
+inline ChorusComb::ChorusComb(float delayMax, const Tp& ffd, const Tp& fbk)
+        :	mFFD(ffd), mFBK(fbk), mMaxDelay(delayMax)
 {}
 
-TM1 inline void ChorusComb<TM2>::operator()(const Tv& in, Tv& oL, Tv& oR){
-  oL = this->read(0) + 0.5 * this->read(1) + in * mFFD;
-  oR = this->read(2) + 0.5 * this->read(1) + in * mFFD;
-  this->write(in + this->read(3)*mFBK);
+inline float ChorusComb::to_samples(float delay) const {
+  float d = delay < mMaxDelay ? delay : mMaxDelay;
+  d *= float(gam::sampleRate());
+  return d < 1.f ? 1.f : (d > 4094.f ? 4094.f : d);
 }
 
-TM1 inline void ChorusComb<TM2>::decay(float units, float end){
-  mFBK = powf(end, this->delay() / gam::scl::abs(units));
-  if(units < 0.f) mFBK = -mFBK;
+inline void ChorusComb::operator()(float in, float& oL, float& oR){
+  auto r = mLine.read4(mTaps);
+  oL = r[0] + 0.5f * r[1] + in * mFFD;
+  oR = r[2] + 0.5f * r[1] + in * mFFD;
+  mLine.write(in + r[3]*mFBK);
 }
 
-TM1 inline void ChorusComb<TM2>::set_delays(float d0, float d1, float d2, float d3) {
-  this->delay(d0, 0); this->delay(d1, 1); this->delay(d2, 2); this->delay(d3, 3);
+inline void ChorusComb::process_block(const float* in, float* oL, float* oR,
+                                      const float* d0, const float* d1, const float* d2,
+                                      float d3, std::size_t n){
+  namespace dsp = otto::util::dsp;
+  if (scratch_.size() < 6 * n) scratch_.resize(6 * n);
+  float* c0 = scratch_.data();
+  float* c1 = c0 + n;
+  float* c2 = c1 + n;
+  float* t0 = c2 + n;
+  float* t1 = t0 + n;
+  float* t2 = t1 + n;
+
+  // Seconds to clamped samples. to_samples keeps every tap inside the line
+  for (std::size_t i = 0; i < n; i++) c0[i] = to_samples(d0[i]);
+  for (std::size_t i = 0; i < n; i++) c1[i] = to_samples(d1[i]);
+  for (std::size_t i = 0; i < n; i++) c2[i] = to_samples(d2[i]);
+  mTaps = {c0[n - 1], c1[n - 1], c2[n - 1], to_samples(d3)};
+  mDelay = d0[n - 1];
+
+  // Feedback pass at the constant tap, then all modulated reads as a block
+  mLine.write_comb(in, mFBK, mTaps[3], n);
+  mLine.read_block(t0, c0, n);
+  mLine.read_block(t1, c1, n);
+  mLine.read_block(t2, c2, n);
+
+  // oL = t0 + 0.5 t1 + ffd in, oR = t2 + 0.5 t1 + ffd in
+  dsp::copy_scale(oL, t1, 0.5f, n);
+  dsp::copy_scale(oR, t1, 0.5f, n);
+  dsp::accumulate(oL, t0, n);
+  dsp::accumulate(oR, t2, n);
+  if (mFFD != Tp(0)) {
+    dsp::accumulate_scale(oL, in, mFFD, n);
+    dsp::accumulate_scale(oR, in, mFFD, n);
+  }
 }
 
-TM1 inline void ChorusComb<TM2>::allPass(const Tp& v){ fbk(v); ffd(-v); }
-TM1 inline void ChorusComb<TM2>::fbk(const Tp& v){ mFBK=v; }
-TM1 inline void ChorusComb<TM2>::ffd(const Tp& v){ mFFD=v; }
-TM1 inline void ChorusComb<TM2>::set(float d, const Tp& ff, const Tp& fb){ this->delay(d); ffd(ff); fbk(fb); }
+inline void ChorusComb::decay(float units, float end){
+  mFBK = powf(end, mDelay / gam::scl::abs(units));
+  if(units < 0.f) mFBK = -mFBK;
+}
 
-TM1 inline Tp ChorusComb<TM2>::fbk() const { return mFBK; }
-TM1 inline Tp ChorusComb<TM2>::ffd() const { return mFFD; }
-TM1 inline float ChorusComb<TM2>::norm() const { return (1.f - gam::scl::abs(fbk()))/(1.f + gam::scl::abs(ffd())); }
-TM1 inline float ChorusComb<TM2>::normFbk() const { return 1.f - gam::scl::abs(fbk()); }
-TM1 inline float ChorusComb<TM2>::normFfd() const { return 1.f/(1.f + gam::scl::abs(ffd())); }
+inline void ChorusComb::set_delays(float d0, float d1, float d2, float d3) {
+  mTaps = {to_samples(d0), to_samples(d1), to_samples(d2), to_samples(d3)};
+  mDelay = d0;
+}
+
+inline void ChorusComb::allPass(const Tp& v){ fbk(v); ffd(-v); }
+inline void ChorusComb::fbk(const Tp& v){ mFBK=v; }
+inline void ChorusComb::ffd(const Tp& v){ mFFD=v; }
+inline void ChorusComb::set(float d, const Tp& ff, const Tp& fb){ mDelay = d; mTaps[0] = to_samples(d); ffd(ff); fbk(fb); }
 
-#undef TM1
-#undef TM2
+inline ChorusComb::Tp ChorusComb::fbk() const { return mFBK; }
+inline ChorusComb::Tp ChorusComb::ffd() const { return mFFD; }
+inline float ChorusComb::norm() const { return (1.f - gam::scl::abs(fbk()))/(1.f + gam::scl::abs(ffd())); }
+inline float ChorusComb::normFbk() const { return 1.f - gam::scl::abs(fbk()); }
+inline float ChorusComb::normFfd() const { return 1.f/(1.f + gam::scl::abs(ffd())); }
 
 ///
 /// \ingroup Effects
@@ -114,8 +212,7 @@ public:
     /// \param[in] fbk		Feedback amount
     ChorusEffect(float delayMax=0.042, float depth=0.007, float freq1=0.15, float freq2=0.4, float ffd=0.7, float fbk=0.0):
             comb(delayMax, ffd, fbk),
-            mod1A(freq1, 0), mod1B(freq1, 0.33f), mod1C(freq1, 0.66f),
-            mod2A(freq2, 0), mod2B(freq2, 0.33f), mod2C(freq2, 0.66f),
+            mFreq1(freq1), mFreq2(freq2),
             mDelayMax(delayMax), mDepth1(depth)
     {
       mDepth2 = depth * 0.2;
@@ -125,8 +222,8 @@ public:
     ChorusEffect& maxDelay(float v){ comb.maxDelay(v); return *this; }
     ChorusEffect& fbk(float v){ comb.fbk(v); return *this; }
     ChorusEffect& ffd(float v){ comb.ffd(v); return *this; }
-    ChorusEffect& freq1(float v){ mod1A.freq(v); mod1C.freq(v); mod1C.freq(v); return *this; }
-    ChorusEffect& freq2(float v){ mod2A.freq(v); mod2C.freq(v); mod2C.freq(v); return *this; }
+    ChorusEffect& freq1(float v){ mFreq1 = v; return *this; }
+    ChorusEffect& freq2(float v){ mFreq2 = v; return *this; }
     ChorusEffect& depth(float v){ mDepth1 = v; mDepth2 = 0.2*v; return *this; }
     ChorusEffect& center(float v){mCenter = v; return *this; }
     float center(){return mCenter; }
@@ -139,22 +236,57 @@ public:
       comb(in, o1, o2);
     }
 
+    /// Process a block.
+    ///
+    /// The block's modulation curves for all taps are generated first from the
+    /// shared sine table - two phasors, three tap offsets each - then the comb
+    /// runs as a block over them. Same modulators as the per-sample path, an
+    /// order of magnitude fewer per-sample branches
+    void process_block(const float* in, float* oL, float* oR, std::size_t n){
+      if (curves_.size() < 3 * n) curves_.resize(3 * n);
+      float* d0 = curves_.data();
+      float* d1 = d0 + n;
+      float* d2 = d1 + n;
+      const auto& lfo = ChorusLfoTable::instance();
+      const float inc1 = mFreq1 / float(gam::sampleRate());
+      const float inc2 = mFreq2 / float(gam::sampleRate());
+      float p1 = mPhase1;
+      float p2 = mPhase2;
+      for (std::size_t i = 0; i < n; i++) {
+        d0[i] = mCenter + lfo.lookup(p1) * mDepth1 + lfo.lookup(p2) * mDepth2;
+        d1[i] = mCenter + lfo.lookup(p1 + 0.33f) * mDepth1 + lfo.lookup(p2 + 0.33f) * mDepth2;
+        d2[i] = mCenter + lfo.lookup(p1 + 0.66f) * mDepth1 + lfo.lookup(p2 + 0.66f) * mDepth2;
+        p1 += inc1;
+        p2 += inc2;
+      }
+      mPhase1 = p1 - float(int(p1));
+      mPhase2 = p2 - float(int(p2));
+      comb.process_block(in, oL, oR, d0, d1, d2, mCenter, n);
+    }
 
     /// Perform delay modulation step (must manually step play heads after use!)
     void modulate(){
-      float d0 = mCenter + mod1A()*mDepth1 + mod2A()*mDepth2;
-      float d1 = mCenter + mod1B()*mDepth1 + mod2B()*mDepth2;
-      float d2 = mCenter + mod1C()*mDepth1 + mod2C()*mDepth2;
+      const auto& lfo = ChorusLfoTable::instance();
+      float d0 = mCenter + lfo.lookup(mPhase1) * mDepth1 + lfo.lookup(mPhase2) * mDepth2;
+      float d1 = mCenter + lfo.lookup(mPhase1 + 0.33f) * mDepth1 + lfo.lookup(mPhase2 + 0.33f) * mDepth2;
+      float d2 = mCenter + lfo.lookup(mPhase1 + 0.66f) * mDepth1 + lfo.lookup(mPhase2 + 0.66f) * mDepth2;
       float d3 = mCenter;
       comb.set_delays(d0, d1, d2, d3);
+      mPhase1 += mFreq1 / float(gam::sampleRate());
+      mPhase2 += mFreq2 / float(gam::sampleRate());
+      mPhase1 -= float(int(mPhase1));
+      mPhase2 -= float(int(mPhase2));
     }
 
-    ChorusComb<T, gam::ipl::Linear> comb;		///< Multitap comb filter
-    gam::Sine<> mod1A, mod1B, mod1C, mod2A, mod2B, mod2C;						///< Modulators
+    ChorusComb comb;		///< Multitap comb filter
 
 private:
+    float mFreq1, mFreq2;	///< Modulator rates, in Hz
+    float mPhase1 = 0, mPhase2 = 0;	///< Modulator phases, in cycles
     float mDelayMax; // Delay interval
     float mDepth1, mDepth2, mCenter;
+    /// Block scratch for the three tap modulation curves
+    std::vector<float> curves_;
 
 };
 
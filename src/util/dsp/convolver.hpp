@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <Gamma/FFT.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTTO_CONVOLVER_NEON 1
+#endif
+
+/// \file
+/// Uniformly partitioned FFT convolution.
+///
+/// The impulse response is cut into fixed-size partitions, each transformed
+/// once up front. Per audio partition the work is one forward FFT, one
+/// spectral multiply-accumulate per partition and one inverse FFT - the same
+/// amount of work no matter how long the tail is, which is the whole point
+/// compared to a feedback network whose density has to be bought with more
+/// series stages.
+
+namespace otto::util::dsp {
+
+  /// Mono-in, stereo-out partitioned convolver.
+  ///
+  /// The two output channels share one input spectrum delay line, so the
+  /// per-block cost of a second channel is only the multiply-accumulate and
+  /// inverse transform.
+  ///
+  /// Processing happens in blocks of {@ref partition_size} samples internally.
+  /// Arbitrary caller block sizes are handled by a small fifo, at the cost of
+  /// one partition of latency.
+  struct PartitionedConvolver {
+    static constexpr std::size_t partition_size = 256;
+    static constexpr std::size_t fft_size = 2 * partition_size;
+    /// Gamma's paired complex layout: `[re0, im0, ..., re(N/2), im(N/2)]`
+    static constexpr std::size_t spectrum_size = fft_size + 2;
+
+    using Spectrum = std::array<float, spectrum_size>;
+
+    /// Set the impulse response for one output channel.
+    ///
+    /// Partitions and transforms `ir` up front. Both channels should be set to
+    /// the same length - the partition count follows the longest one.
+    void set_ir(int channel, const float* ir, std::size_t length)
+    {
+      std::size_t parts = (length + partition_size - 1) / partition_size;
+      if (parts > num_partitions_) resize(parts);
+      auto& spectra = ir_spectra_[channel];
+      spectra.assign(num_partitions_, Spectrum{});
+      std::array<float, spectrum_size> buf = {};
+      for (std::size_t p = 0; p < parts; p++) {
+        buf.fill(0.f);
+        std::size_t remaining = length - p * partition_size;
+        std::size_t m = remaining < partition_size ? remaining : partition_size;
+        std::copy_n(ir + p * partition_size, m, buf.data());
+        // The product of two unnormalized forward transforms carries a factor
+        // of fft_size - fold the compensation into the stored spectra
+        fft_.forward(buf.data(), true, 1.f / float(fft_size));
+        spectra[p] = buf;
+      }
+    }
+
+    /// Set the decay time (T60) in seconds.
+    ///
+    /// Applied as one gain per partition on top of the stored response, so a
+    /// flat (non-decaying) impulse response decays in steps of one partition
+    /// (~6 ms at 44.1k) - inaudibly fine-grained, and it keeps a decay change
+    /// from retransforming the whole tail.
+    void decay(float seconds, float sample_rate) noexcept
+    {
+      for (std::size_t p = 0; p < num_partitions_; p++) {
+        float t = float(p * partition_size) / sample_rate;
+        gains_[p] = seconds <= 0.f ? (p == 0 ? 1.f : 0.f) : std::pow(0.001f, t / seconds);
+      }
+    }
+
+    /// Process a block of any size. `in` may alias either output
+    void process(const float* in, float* out_l, float* out_r, std::size_t n)
+    {
+      for (std::size_t i = 0; i < n; i++) {
+        float x = in[i];
+        out_l[i] = out_bufs_[0][fill_];
+        out_r[i] = out_bufs_[1][fill_];
+        in_buf_[fill_] = x;
+        if (++fill_ == partition_size) {
+          step();
+          fill_ = 0;
+        }
+      }
+    }
+
+    /// Heap bytes held by the delay line and IR spectra - see
+    /// {@ref otto::core::engine::IEngine::memory_footprint}
+    std::size_t heap_bytes() const noexcept
+    {
+      return sizeof(Spectrum) * (fdl_.capacity() + ir_spectra_[0].capacity() + ir_spectra_[1].capacity()) +
+             sizeof(float) * gains_.capacity();
+    }
+
+  private:
+    void resize(std::size_t parts)
+    {
+      num_partitions_ = parts;
+      fdl_.assign(parts, Spectrum{});
+      for (auto& spectra : ir_spectra_) spectra.resize(parts, Spectrum{});
+      gains_.resize(parts, 1.f);
+      fdl_pos_ = 0;
+    }
+
+    /// Run one partition: overlap-save convolution of the newest input block
+    void step()
+    {
+      // Time buffer is the previous partition followed by the new one
+      Spectrum time = {};
+      std::copy_n(prev_in_.data(), partition_size, time.data());
+      std::copy_n(in_buf_.data(), partition_size, time.data() + partition_size);
+      prev_in_ = in_buf_;
+
+      fft_.forward(time.data(), true);
+      fdl_pos_ = (fdl_pos_ + 1) % num_partitions_;
+      fdl_[fdl_pos_] = time;
+
+      for (int ch = 0; ch < 2; ch++) {
+        Spectrum acc = {};
+        for (std::size_t p = 0; p < num_partitions_; p++) {
+          std::size_t x = (fdl_pos_ + num_partitions_ - p) % num_partitions_;
+          accumulate(acc.data(), fdl_[x].data(), ir_spectra_[ch][p].data(), gains_[p]);
+        }
+        fft_.inverse(acc.data(), true);
+        // Overlap-save: the first half is circular garbage, the second half is
+        // the valid output
+        std::copy_n(acc.data() + partition_size, partition_size, out_bufs_[ch].data());
+      }
+    }
+
+    /// `acc += gain * x * h`, complex, over all bins
+    static void accumulate(float* acc, const float* x, const float* h, float gain) noexcept
+    {
+      std::size_t bins = fft_size / 2 + 1;
+      std::size_t i = 0;
+#if OTTO_CONVOLVER_NEON
+      float32x4_t g = vdupq_n_f32(gain);
+      for (; i + 4 <= bins; i += 4) {
+        float32x4x2_t xv = vld2q_f32(x + 2 * i);
+        float32x4x2_t hv = vld2q_f32(h + 2 * i);
+        float32x4x2_t av = vld2q_f32(acc + 2 * i);
+        float32x4_t re = vmlsq_f32(vmulq_f32(xv.val[0], hv.val[0]), xv.val[1], hv.val[1]);
+        float32x4_t im = vmlaq_f32(vmulq_f32(xv.val[0], hv.val[1]), xv.val[1], hv.val[0]);
+        av.val[0] = vmlaq_f32(av.val[0], g, re);
+        av.val[1] = vmlaq_f32(av.val[1], g, im);
+        vst2q_f32(acc + 2 * i, av);
+      }
+#endif
+      for (; i < bins; i++) {
+        float xr = x[2 * i], xi = x[2 * i + 1];
+        float hr = h[2 * i], hi = h[2 * i + 1];
+        acc[2 * i] += gain * (xr * hr - xi * hi);
+        acc[2 * i + 1] += gain * (xr * hi + xi * hr);
+      }
+    }
+
+    gam::RFFT<float> fft_{int(fft_size)};
+
+    std::size_t num_partitions_ = 0;
+    /// Spectra of past input partitions, newest at fdl_pos_
+    std::vector<Spectrum> fdl_;
+    std::size_t fdl_pos_ = 0;
+    std::array<std::vector<Spectrum>, 2> ir_spectra_;
+    std::vector<float> gains_;
+
+    std::array<float, partition_size> in_buf_ = {};
+    std::array<float, partition_size> prev_in_ = {};
+    std::array<std::array<float, partition_size>, 2> out_bufs_ = {{}};
+    std::size_t fill_ = 0;
+  };
+
+} // namespace otto::util::dsp
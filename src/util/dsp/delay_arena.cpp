@@ -0,0 +1,110 @@
+#include "delay_arena.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "services/log_manager.hpp"
+
+namespace otto::util::dsp {
+
+  namespace {
+    struct SpinGuard {
+      SpinGuard(std::atomic_flag& lock) : lock_(lock)
+      {
+        while (lock_.test_and_set(std::memory_order_acquire)) {}
+      }
+      ~SpinGuard()
+      {
+        lock_.clear(std::memory_order_release);
+      }
+      std::atomic_flag& lock_;
+    };
+  } // namespace
+
+  DelayArena& DelayArena::instance() noexcept
+  {
+    // First touched during engine construction at startup, never first on the
+    // audio thread
+    static DelayArena arena;
+    return arena;
+  }
+
+  DelayArena::DelayArena()
+  {
+    slab_ = static_cast<float*>(std::aligned_alloc(alignment, slab_bytes));
+    std::memset(slab_, 0, slab_bytes);
+    blocks_[0] = {0, slab_bytes, false};
+  }
+
+  DelayArena::~DelayArena()
+  {
+    std::free(slab_);
+  }
+
+  float* DelayArena::acquire(std::size_t floats) noexcept
+  {
+    std::size_t bytes = floats * sizeof(float);
+    bytes = (bytes + alignment - 1) & ~(alignment - 1);
+
+    {
+      SpinGuard guard(lock_);
+      for (int i = 0; i < block_count_; i++) {
+        Block& b = blocks_[i];
+        if (b.used || b.size < bytes) continue;
+        if (b.size > bytes && block_count_ < max_blocks) {
+          // Split: shift the tail up and carve the remainder off as free
+          for (int j = block_count_; j > i + 1; j--) blocks_[j] = blocks_[j - 1];
+          blocks_[i + 1] = {b.offset + bytes, b.size - bytes, false};
+          block_count_++;
+          b.size = bytes;
+        }
+        b.used = true;
+        const auto in_use = bytes_in_use_.fetch_add(b.size, std::memory_order_relaxed) + b.size;
+        if (in_use > peak_bytes_.load(std::memory_order_relaxed)) {
+          peak_bytes_.store(in_use, std::memory_order_relaxed);
+        }
+        float* res = slab_ + b.offset / sizeof(float);
+        std::memset(res, 0, bytes);
+        return res;
+      }
+    }
+
+    // Exhausted - a sizing bug. Fall back to the heap so audio keeps running
+    LOGW("DelayArena exhausted, heap-allocating {} bytes", bytes);
+    auto* res = static_cast<float*>(std::aligned_alloc(alignment, bytes));
+    std::memset(res, 0, bytes);
+    return res;
+  }
+
+  void DelayArena::release(float* ptr) noexcept
+  {
+    if (ptr == nullptr) return;
+    if (ptr < slab_ || ptr >= slab_ + slab_bytes / sizeof(float)) {
+      // A heap fallback region
+      std::free(ptr);
+      return;
+    }
+    const std::size_t offset = std::size_t(ptr - slab_) * sizeof(float);
+    SpinGuard guard(lock_);
+    for (int i = 0; i < block_count_; i++) {
+      if (blocks_[i].offset != offset || !blocks_[i].used) continue;
+      blocks_[i].used = false;
+      bytes_in_use_.fetch_sub(blocks_[i].size, std::memory_order_relaxed);
+      // Coalesce with free neighbours, so churn from engine switching cannot
+      // fragment the slab
+      if (i + 1 < block_count_ && !blocks_[i + 1].used) {
+        blocks_[i].size += blocks_[i + 1].size;
+        for (int j = i + 1; j < block_count_ - 1; j++) blocks_[j] = blocks_[j + 1];
+        block_count_--;
+      }
+      if (i > 0 && !blocks_[i - 1].used) {
+        blocks_[i - 1].size += blocks_[i].size;
+        for (int j = i; j < block_count_ - 1; j++) blocks_[j] = blocks_[j + 1];
+        block_count_--;
+      }
+      return;
+    }
+    LOGE("DelayArena::release: pointer does not match an acquired region");
+  }
+
+} // namespace otto::util::dsp
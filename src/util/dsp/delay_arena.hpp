@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/// \file
+/// Shared arena for effect delay-line memory.
+///
+/// Every effect engine is constructed up front and stays alive - see
+/// {@ref core::engine::EngineDispatcher} - so delay lines stored inline in the
+/// engines cost their worst case for every registered engine, selected or not.
+/// The arena bounds that by the active set instead: an engine acquires its
+/// delay memory when it first processes and hands it back when deselected, so
+/// only the engines actually in the chain hold regions.
+
+namespace otto::util::dsp {
+
+  /// Hands out cache-aligned regions from one preallocated slab.
+  ///
+  /// `acquire` runs on the audio thread when an engine arms itself on its
+  /// first block, so it does no heap allocation: a first-fit walk over a
+  /// fixed block table under a short spin lock, plus zeroing the region.
+  /// `release` runs on the logic thread during engine switching, after
+  /// {@ref services::AudioManager::wait_one} has confirmed the audio thread
+  /// is done with the old engine.
+  ///
+  /// The slab is sized for the worst-case active set with headroom. If it is
+  /// ever exhausted the arena falls back to the heap and logs - that is a
+  /// sizing bug, not a crash.
+  struct DelayArena {
+    /// Regions start on cache lines, and sizes round up to whole ones
+    static constexpr std::size_t alignment = 64;
+    /// Comfortably above the sum of every effect's declared worst case
+    static constexpr std::size_t slab_bytes = 256 * 1024;
+
+    static DelayArena& instance() noexcept;
+
+    /// Get a zeroed, cache-aligned region of `floats` floats
+    float* acquire(std::size_t floats) noexcept;
+
+    /// Hand a region back. `ptr` must come from {@ref acquire}; nullptr is a no-op
+    void release(float* ptr) noexcept;
+
+    /// Bytes currently handed out - the delay cost of the active set
+    std::size_t bytes_in_use() const noexcept
+    {
+      return bytes_in_use_.load(std::memory_order_relaxed);
+    }
+
+    /// High-water mark of {@ref bytes_in_use} - for sizing {@ref slab_bytes}
+    std::size_t peak_bytes() const noexcept
+    {
+      return peak_bytes_.load(std::memory_order_relaxed);
+    }
+
+    DelayArena(const DelayArena&) = delete;
+
+  private:
+    DelayArena();
+    ~DelayArena();
+
+    /// A span of the slab, in bytes. The table is kept sorted by offset, so
+    /// freeing coalesces with the neighbouring entries
+    struct Block {
+      std::size_t offset;
+      std::size_t size;
+      bool used;
+    };
+
+    /// Engines hold one or two regions each - a handful of blocks covers the
+    /// whole chain
+    static constexpr int max_blocks = 32;
+
+    float* slab_ = nullptr;
+    Block blocks_[max_blocks];
+    int block_count_ = 1;
+
+    std::atomic<std::size_t> bytes_in_use_ = 0;
+    std::atomic<std::size_t> peak_bytes_ = 0;
+    mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+  };
+
+} // namespace otto::util::dsp
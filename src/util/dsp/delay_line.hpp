@@ -0,0 +1,212 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "util/dsp/delay_arena.hpp"
+#include "util/ringbuffer.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTTO_DELAY_LINE_NEON 1
+#endif
+
+/// \file
+/// Fixed-capacity delay line with bitmask wrapping and fractional reads.
+
+namespace otto::util::dsp {
+
+  namespace detail {
+    /// Bitmask-wrapping view over external memory, for arena-backed lines
+    template<std::size_t N>
+    struct wrapping_view {
+      float* data = nullptr;
+
+      float& operator[](std::size_t i) noexcept
+      {
+        return data[i & (N - 1)];
+      }
+      const float& operator[](std::size_t i) const noexcept
+      {
+        return data[i & (N - 1)];
+      }
+    };
+  } // namespace detail
+
+  /// Delay line over a power-of-two buffer with wrapping indexing.
+  ///
+  /// All index wrapping is a bitmask, unlike the generic modulo wrapping the
+  /// Gamma delays do per sample. Fractional reads use linear interpolation, and
+  /// {@ref read4} interpolates four taps at once with NEON - the shape the
+  /// chorus comb needs.
+  ///
+  /// The buffer type decides who owns the samples - see {@ref delay_line} and
+  /// {@ref arena_delay_line}.
+  ///
+  /// \tparam N capacity in samples. Must be a power of two, and at least two
+  ///           samples longer than the longest delay read
+  template<std::size_t N, typename Buf>
+  struct basic_delay_line {
+    static_assert((N & (N - 1)) == 0, "delay_line: N must be a power of two");
+
+    /// Push a new sample
+    void write(float v) noexcept
+    {
+      pos_++;
+      buf_[pos_] = v;
+    }
+
+    /// Read at an integer delay in samples
+    float read(std::size_t delay) const noexcept
+    {
+      return buf_[pos_ - delay];
+    }
+
+    /// Read at a fractional delay in samples, with linear interpolation
+    float read(float delay) const noexcept
+    {
+      auto di = std::size_t(delay);
+      float frac = delay - float(di);
+      float s0 = buf_[pos_ - di];
+      float s1 = buf_[pos_ - di - 1];
+      return s0 + frac * (s1 - s0);
+    }
+
+    /// Read four fractional taps at once
+    std::array<float, 4> read4(const std::array<float, 4>& delays) const noexcept
+    {
+#if OTTO_DELAY_LINE_NEON
+      float32x4_t d = vld1q_f32(delays.data());
+      int32x4_t di = vcvtq_s32_f32(d);
+      float32x4_t frac = vsubq_f32(d, vcvtq_f32_s32(di));
+      std::array<std::int32_t, 4> idx;
+      vst1q_s32(idx.data(), di);
+      std::array<float, 4> s0, s1;
+      for (int t = 0; t < 4; t++) {
+        s0[t] = buf_[pos_ - idx[t]];
+        s1[t] = buf_[pos_ - idx[t] - 1];
+      }
+      float32x4_t v0 = vld1q_f32(s0.data());
+      float32x4_t v1 = vld1q_f32(s1.data());
+      std::array<float, 4> res;
+      vst1q_f32(res.data(), vmlaq_f32(v0, frac, vsubq_f32(v1, v0)));
+      return res;
+#else
+      return {read(delays[0]), read(delays[1]), read(delays[2]), read(delays[3])};
+#endif
+    }
+
+    /// Read the delayed sample, then push `in`
+    template<typename Delay>
+    float operator()(float in, Delay delay) noexcept
+    {
+      float res = read(delay);
+      write(in);
+      return res;
+    }
+
+    /// Run the line as a feedback comb for a block.
+    ///
+    /// Per sample: `write(in[i] + fbk * read(delay))`, with `delay` constant
+    /// over the block. The read-before-write order matches the per-sample
+    /// {@ref operator()} exactly
+    void write_comb(const float* in, float fbk, float delay, std::size_t n) noexcept
+    {
+      for (std::size_t i = 0; i < n; i++) {
+        write(in[i] + fbk * read(delay));
+      }
+    }
+
+    /// Fractional reads for the last `n` written samples, at per-sample delays.
+    ///
+    /// `dest[i]` is what `read(delays[i])` would have returned just before the
+    /// i-th of the last `n` writes - so after a {@ref write_comb} this yields
+    /// exactly the per-sample serial tap reads, but as a block of gather+lerp
+    /// with the interpolation in NEON lanes
+    void read_block(float* dest, const float* delays, std::size_t n) noexcept
+    {
+      // Unsigned underflow is fine - N divides 2^64, so wrapping still lands
+      // on the right slot
+      const std::size_t base = pos_ - n;
+      std::size_t i = 0;
+#if OTTO_DELAY_LINE_NEON
+      for (; i + 4 <= n; i += 4) {
+        float32x4_t d = vld1q_f32(delays + i);
+        int32x4_t di = vcvtq_s32_f32(d);
+        float32x4_t frac = vsubq_f32(d, vcvtq_f32_s32(di));
+        std::array<std::int32_t, 4> idx;
+        vst1q_s32(idx.data(), di);
+        std::array<float, 4> s0, s1;
+        for (int t = 0; t < 4; t++) {
+          s0[t] = buf_[base + i + t - std::size_t(idx[t])];
+          s1[t] = buf_[base + i + t - std::size_t(idx[t]) - 1];
+        }
+        float32x4_t v0 = vld1q_f32(s0.data());
+        float32x4_t v1 = vld1q_f32(s1.data());
+        vst1q_f32(dest + i, vmlaq_f32(v0, frac, vsubq_f32(v1, v0)));
+      }
+#endif
+      for (; i < n; i++) {
+        auto di = std::size_t(delays[i]);
+        float frac = delays[i] - float(di);
+        float s0 = buf_[base + i - di];
+        float s1 = buf_[base + i - di - 1];
+        dest[i] = s0 + frac * (s1 - s0);
+      }
+    }
+
+  protected:
+    Buf buf_ = {};
+    /// Index of the most recently written sample. Only ever wrapped on access -
+    /// N divides 2^64, so overflow is harmless
+    std::size_t pos_ = 0;
+  };
+
+  /// Delay line owning its samples inline - the default
+  template<std::size_t N>
+  struct delay_line : basic_delay_line<N, util::wrapping_array<float, N>> {};
+
+  /// Delay line over memory acquired from the {@ref DelayArena}.
+  ///
+  /// The owner attaches a region of at least `N` floats before processing and
+  /// detaches it before handing the region back. A detached line must not be
+  /// read or written
+  template<std::size_t N>
+  struct arena_delay_line : basic_delay_line<N, detail::wrapping_view<N>> {
+    /// Floats to acquire for one line
+    static constexpr std::size_t arena_floats = N;
+
+    void attach(float* mem) noexcept
+    {
+      this->buf_.data = mem;
+      this->pos_ = 0;
+    }
+
+    void detach() noexcept
+    {
+      this->buf_.data = nullptr;
+    }
+
+    bool attached() const noexcept
+    {
+      return this->buf_.data != nullptr;
+    }
+
+    /// Attach a fresh region from the {@ref DelayArena}. No-op when attached,
+    /// so this is safe to call per block from the audio thread
+    void arm() noexcept
+    {
+      if (!attached()) attach(DelayArena::instance().acquire(arena_floats));
+    }
+
+    /// Hand the region back to the arena. No-op when detached
+    void disarm() noexcept
+    {
+      if (!attached()) return;
+      DelayArena::instance().release(this->buf_.data);
+      detach();
+    }
+  };
+
+} // namespace otto::util::dsp
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OTTO_DENORMALS_SSE 1
+#endif
+
+/// \file
+/// Denormal protection for the audio threads.
+///
+/// A long decay tail drives filter and delay states down through ~1e-38 into
+/// denormal range, where x86 traps each multiply to microcode - tens of times
+/// slower than a normal multiply. That is the classic CPU spike near silence:
+/// the quieter the tail, the more expensive it gets.
+
+namespace otto::util::dsp {
+
+  /// Put the calling thread's FPU in flush-to-zero / denormals-are-zero mode.
+  ///
+  /// The hardware then treats denormals as exact zeros, which is inaudible
+  /// (below -750 dB) and costs nothing. The mode lives in the per-thread FP
+  /// status register, so every thread running DSP sets it for itself - the
+  /// audio driver callback, the audio workers, and
+  /// {@ref services::AudioManager::start} for the callers that process on
+  /// their own thread (dummy board, tests). No-op on architectures without
+  /// the mode bits
+  inline void flush_denormals_to_zero() noexcept
+  {
+#if OTTO_DENORMALS_SSE
+    // MXCSR bit 15: flush-to-zero (results), bit 6: denormals-are-zero
+    // (operands). The DAZ bit exists on everything this ships on
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#elif defined(__aarch64__)
+    // FPCR.FZ, bit 24
+    std::uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    asm volatile("msr fpcr, %0" : : "r"(fpcr | (std::uint64_t(1) << 24)));
+#elif defined(__arm__) && defined(__VFP_FP__)
+    // FPSCR.FZ, bit 24
+    std::uint32_t fpscr;
+    asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    asm volatile("vmsr fpscr, %0" : : "r"(fpscr | (std::uint32_t(1) << 24)));
+#endif
+  }
+
+  /// Flush one state variable: exact zero if it fell into denormal range.
+  ///
+  /// For DSP state the FPU mode cannot cover - values written on a protected
+  /// thread but read on an unprotected one, or builds without the mode bits.
+  /// The biquad wrappers flush their inner delays with this once per block,
+  /// which is enough to keep a tail from idling in denormal range
+  inline float flush_denormal(float v) noexcept
+  {
+    return std::abs(v) < 1e-30f ? 0.f : v;
+  }
+
+} // namespace otto::util::dsp
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "util/ringbuffer.hpp"
+
+namespace otto::util::dsp {
+
+  /// Stereo-linked lookahead brickwall limiter.
+  ///
+  /// The running max of the input magnitude over the lookahead window is
+  /// maintained with the monotonic-deque algorithm: each sample is pushed and
+  /// popped at most once, so the window max costs O(1) amortized instead of a
+  /// per-sample scan. The signal is delayed by the window, so the gain can ramp
+  /// down *ahead* of a peak and be fully engaged when it arrives; release is a
+  /// slow exponential.
+  ///
+  /// The one-pole attack shapes the gain but chases a moving target, so it alone
+  /// cannot guarantee the ceiling. A hard clamp against the delayed frame's own
+  /// magnitude makes the limit exact; it only engages in the last fraction of a
+  /// dB, so the audible work is still done by the smooth lookahead gain. The
+  /// time constants assume the 48 kHz the OTTO runs at.
+  ///
+  /// \tparam N lookahead window in samples. A power of two - also the added
+  ///   latency (128 samples is ~2.7 ms)
+  template<std::size_t N = 128>
+  struct LookaheadLimiter {
+    /// Peaks are held at this level
+    static constexpr float ceiling = 1.f;
+
+    LookaheadLimiter() noexcept
+    {
+      // Down to e^-8 of the remaining distance over one window
+      attack_coef_ = 1.f - std::exp(-8.f / float(N));
+      // ~80 ms release at 48 kHz
+      release_coef_ = 1.f - std::exp(-1.f / (0.080f * 48000.f));
+    }
+
+    /// Process one stereo frame in place. Output is delayed by `N` samples
+    void operator()(float& l, float& r) noexcept
+    {
+      const float mag = std::max(std::abs(l), std::abs(r));
+
+      // Monotonic deque push - anything older and not larger can never be the
+      // window max again
+      while (dq_size_ > 0 && deque_[dq_front_ + dq_size_ - 1].value <= mag) dq_size_--;
+      deque_[dq_front_ + dq_size_] = {pos_, mag};
+      dq_size_++;
+      // Expire entries that fell out of the window
+      while (deque_[dq_front_].pos + N <= pos_) {
+        dq_front_++;
+        dq_size_--;
+      }
+
+      const float peak = deque_[dq_front_].value;
+      const float target = peak > ceiling ? ceiling / peak : 1.f;
+      gain_ += (target < gain_ ? attack_coef_ : release_coef_) * (target - gain_);
+
+      // Read the frame leaving the window before overwriting its slot
+      const float out_l = delay_l_[pos_ + 1];
+      const float out_r = delay_r_[pos_ + 1];
+      // Exact ceiling - see the class comment. The branch is rarely taken
+      float g = gain_;
+      const float out_mag = std::max(std::abs(out_l), std::abs(out_r));
+      if (out_mag * g > ceiling) g = ceiling / out_mag;
+      delay_l_[pos_] = l;
+      delay_r_[pos_] = r;
+      pos_++;
+      l = out_l * g;
+      r = out_r * g;
+    }
+
+    /// The gain currently applied - 1 when the limiter is not working
+    float gain() const noexcept
+    {
+      return gain_;
+    }
+
+  private:
+    struct Entry {
+      std::size_t pos = 0;
+      float value = 0.f;
+    };
+
+    wrapping_array<float, N> delay_l_ = {};
+    wrapping_array<float, N> delay_r_ = {};
+    /// The monotonic deque holds at most one entry per live sample
+    wrapping_array<Entry, N> deque_ = {};
+    std::size_t dq_front_ = 0;
+    std::size_t dq_size_ = 0;
+    std::size_t pos_ = 0;
+
+    float gain_ = 1.f;
+    float attack_coef_;
+    float release_coef_;
+  };
+
+} // namespace otto::util::dsp
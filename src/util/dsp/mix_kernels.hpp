@@ -0,0 +1,501 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTTO_MIX_KERNELS_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OTTO_MIX_KERNELS_SSE 1
+// The integer sample-format kernels need SSE2, which every x86-64 target has
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OTTO_MIX_KERNELS_SSE2 1
+#endif
+#endif
+
+/// \file
+/// SIMD mix/accumulate kernels for the audio buffer operations in the engine chain.
+///
+/// All kernels process four samples per iteration with NEON on the Pi and SSE on
+/// desktop, with a scalar tail/fallback. They deliberately take raw pointers and a
+/// length - callers hand them `AudioBufferHandle::data()` directly, so no iterator
+/// machinery ends up in the hot loop.
+
+namespace otto::util::dsp {
+
+  /// `dest[i] = src[i] * gain`
+  inline void copy_scale(float* dest, const float* src, float gain, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vmulq_f32(vld1q_f32(src + i), g));
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] = src[i] * gain;
+    }
+  }
+
+  /// `dest[i] += src[i]`
+  inline void accumulate(float* dest, const float* src, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), vld1q_f32(src + i)));
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_loadu_ps(src + i)));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] += src[i];
+    }
+  }
+
+  /// `dest[i] += src[i] * gain`
+  inline void accumulate_scale(float* dest, const float* src, float gain, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(src + i), g));
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] += src[i] * gain;
+    }
+  }
+
+  /// `dest[i] *= gain`
+  inline void scale(float* dest, float gain, std::size_t n) noexcept
+  {
+    copy_scale(dest, dest, gain, n);
+  }
+
+  /// `dest[i] = src[i] * g`, with `g` ramping linearly from `g0` at the block
+  /// start towards `g1` - the next block starts exactly at `g1`
+  inline void copy_scale_ramp(float* dest, const float* src, float g0, float g1, std::size_t n) noexcept
+  {
+    if (n == 0) return;
+    const float step = (g1 - g0) / float(n);
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    const float init[4] = {g0, g0 + step, g0 + 2 * step, g0 + 3 * step};
+    float32x4_t g = vld1q_f32(init);
+    float32x4_t dg = vdupq_n_f32(4 * step);
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vmulq_f32(vld1q_f32(src + i), g));
+      g = vaddq_f32(g, dg);
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    __m128 g = _mm_setr_ps(g0, g0 + step, g0 + 2 * step, g0 + 3 * step);
+    __m128 dg = _mm_set1_ps(4 * step);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+      g = _mm_add_ps(g, dg);
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] = src[i] * (g0 + step * float(i));
+    }
+  }
+
+  /// `dest[i] += src[i] * g`, with `g` ramping linearly from `g0` towards `g1`
+  inline void accumulate_scale_ramp(float* dest, const float* src, float g0, float g1, std::size_t n) noexcept
+  {
+    if (n == 0) return;
+    const float step = (g1 - g0) / float(n);
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    const float init[4] = {g0, g0 + step, g0 + 2 * step, g0 + 3 * step};
+    float32x4_t g = vld1q_f32(init);
+    float32x4_t dg = vdupq_n_f32(4 * step);
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(src + i), g));
+      g = vaddq_f32(g, dg);
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    __m128 g = _mm_setr_ps(g0, g0 + step, g0 + 2 * step, g0 + 3 * step);
+    __m128 dg = _mm_set1_ps(4 * step);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+      g = _mm_add_ps(g, dg);
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] += src[i] * (g0 + step * float(i));
+    }
+  }
+
+  /// `dest[i] *= g`, with `g` ramping linearly from `g0` towards `g1`
+  inline void scale_ramp(float* dest, float g0, float g1, std::size_t n) noexcept
+  {
+    copy_scale_ramp(dest, dest, g0, g1, n);
+  }
+
+  /// `dest[i] = 0`
+  inline void clear(float* dest, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t z = vdupq_n_f32(0.f);
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, z);
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    __m128 z = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, z);
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] = 0.f;
+    }
+  }
+
+  /// The largest `|src[i]|` in the block - metering and limiter lookahead
+  inline float peak(const float* src, std::size_t n) noexcept
+  {
+    float res = 0.f;
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t acc = vdupq_n_f32(0.f);
+    for (; i + 4 <= n; i += 4) {
+      acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(src + i)));
+    }
+    float32x2_t m = vmax_f32(vget_low_f32(acc), vget_high_f32(acc));
+    m = vpmax_f32(m, m);
+    res = vget_lane_f32(m, 0);
+#elif OTTO_MIX_KERNELS_SSE
+    const __m128 sign = _mm_set1_ps(-0.f);
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+      acc = _mm_max_ps(acc, _mm_andnot_ps(sign, _mm_loadu_ps(src + i)));
+    }
+    float tmp[4];
+    _mm_storeu_ps(tmp, acc);
+    res = std::max(std::max(tmp[0], tmp[1]), std::max(tmp[2], tmp[3]));
+#endif
+    for (; i < n; i++) {
+      const float a = src[i] < 0.f ? -src[i] : src[i];
+      if (a > res) res = a;
+    }
+    return res;
+  }
+
+  /// `dest[2i] = l[i], dest[2i + 1] = r[i]` - writing a stereo device buffer
+  inline void interleave2(float* dest, const float* l, const float* r, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    for (; i + 4 <= n; i += 4) {
+      float32x4x2_t v = {{vld1q_f32(l + i), vld1q_f32(r + i)}};
+      vst2q_f32(dest + 2 * i, v);
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    for (; i + 4 <= n; i += 4) {
+      __m128 vl = _mm_loadu_ps(l + i);
+      __m128 vr = _mm_loadu_ps(r + i);
+      _mm_storeu_ps(dest + 2 * i, _mm_unpacklo_ps(vl, vr));
+      _mm_storeu_ps(dest + 2 * i + 4, _mm_unpackhi_ps(vl, vr));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[2 * i] = l[i];
+      dest[2 * i + 1] = r[i];
+    }
+  }
+
+  /// `l[i] = src[2i], r[i] = src[2i + 1]` - splitting an interleaved device or
+  /// frame buffer into the per-channel spans engines want
+  inline void deinterleave2(float* l, float* r, const float* src, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    for (; i + 4 <= n; i += 4) {
+      float32x4x2_t v = vld2q_f32(src + 2 * i);
+      vst1q_f32(l + i, v.val[0]);
+      vst1q_f32(r + i, v.val[1]);
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    for (; i + 4 <= n; i += 4) {
+      __m128 lo = _mm_loadu_ps(src + 2 * i);
+      __m128 hi = _mm_loadu_ps(src + 2 * i + 4);
+      _mm_storeu_ps(l + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(r + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#endif
+    for (; i < n; i++) {
+      l[i] = src[2 * i];
+      r[i] = src[2 * i + 1];
+    }
+  }
+
+  /// `dest[i] = src[i] / 32768` - reading an int16-native device or file.
+  ///
+  /// Both drivers open float32 streams, so this only runs where the device or
+  /// the data really is 16 bit - it should not sneak into the regular chain
+  inline void int16_to_float(float* dest, const std::int16_t* src, std::size_t n) noexcept
+  {
+    constexpr float scale = 1.f / 32768.f;
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t g = vdupq_n_f32(scale);
+    for (; i + 8 <= n; i += 8) {
+      int16x8_t v = vld1q_s16(src + i);
+      vst1q_f32(dest + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), g));
+      vst1q_f32(dest + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), g));
+    }
+#elif OTTO_MIX_KERNELS_SSE2
+    const __m128 g = _mm_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      // Unpack against itself and shift to sign-extend 16 -> 32 bit
+      __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+      __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+      _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), g));
+      _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), g));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] = float(src[i]) * scale;
+    }
+  }
+
+  /// `dest[i] = src[i] * 32767`, saturated - writing an int16-native device or
+  /// file. Out-of-range floats clip instead of wrapping
+  inline void float_to_int16(std::int16_t* dest, const float* src, std::size_t n) noexcept
+  {
+    constexpr float scale = 32767.f;
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t g = vdupq_n_f32(scale);
+    for (; i + 8 <= n; i += 8) {
+      int32x4_t lo = vcvtq_s32_f32(vmulq_f32(vld1q_f32(src + i), g));
+      int32x4_t hi = vcvtq_s32_f32(vmulq_f32(vld1q_f32(src + i + 4), g));
+      vst1q_s16(dest + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+#elif OTTO_MIX_KERNELS_SSE2
+    const __m128 g = _mm_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+      __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), g));
+      __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), g));
+      // packs saturates to int16, so clipping comes for free
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < n; i++) {
+      const float v = src[i] * scale;
+      dest[i] = std::int16_t(std::clamp(v, -32768.f, 32767.f));
+    }
+  }
+
+  /// `dest[i] += a[i] * b[i]` - the windowed overlap-add shape
+  inline void accumulate_product(float* dest, const float* a, const float* b, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(a + i), vld1q_f32(b + i)));
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i))));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] += a[i] * b[i];
+    }
+  }
+
+  /// `dest[i] = src[2 * i]` - reading a delay line at double speed
+  inline void copy_stride2(float* dest, const float* src, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vld2q_f32(src + 2 * i).val[0]);
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    for (; i + 4 <= n; i += 4) {
+      __m128 lo = _mm_loadu_ps(src + 2 * i);
+      __m128 hi = _mm_loadu_ps(src + 2 * i + 4);
+      _mm_storeu_ps(dest + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] = src[2 * i];
+    }
+  }
+
+  /// `dest[2i] += l[i] * gain, dest[2i + 1] += r[i] * gain` - mixing into an
+  /// interleaved stereo device buffer, e.g. direct input monitoring
+  inline void accumulate_interleave2(float* dest, const float* l, const float* r, float gain, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= n; i += 4) {
+      float32x4x2_t v = vld2q_f32(dest + 2 * i);
+      v.val[0] = vmlaq_f32(v.val[0], vld1q_f32(l + i), g);
+      v.val[1] = vmlaq_f32(v.val[1], vld1q_f32(r + i), g);
+      vst2q_f32(dest + 2 * i, v);
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= n; i += 4) {
+      __m128 vl = _mm_mul_ps(_mm_loadu_ps(l + i), g);
+      __m128 vr = _mm_mul_ps(_mm_loadu_ps(r + i), g);
+      __m128 lo = _mm_unpacklo_ps(vl, vr);
+      __m128 hi = _mm_unpackhi_ps(vl, vr);
+      _mm_storeu_ps(dest + 2 * i, _mm_add_ps(_mm_loadu_ps(dest + 2 * i), lo));
+      _mm_storeu_ps(dest + 2 * i + 4, _mm_add_ps(_mm_loadu_ps(dest + 2 * i + 4), hi));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[2 * i] += l[i] * gain;
+      dest[2 * i + 1] += r[i] * gain;
+    }
+  }
+
+  /// Mean of `src[i]^2` - the squared RMS of a block
+  inline float mean_square(const float* src, std::size_t n) noexcept
+  {
+    if (n == 0) return 0.f;
+    float sum = 0.f;
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t acc = vdupq_n_f32(0.f);
+    for (; i + 4 <= n; i += 4) {
+      float32x4_t v = vld1q_f32(src + i);
+      acc = vmlaq_f32(acc, v, v);
+    }
+    float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    s = vpadd_f32(s, s);
+    sum = vget_lane_f32(s, 0);
+#elif OTTO_MIX_KERNELS_SSE
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+      __m128 v = _mm_loadu_ps(src + i);
+      acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+    }
+    float tmp[4];
+    _mm_storeu_ps(tmp, acc);
+    sum = tmp[0] + tmp[1] + tmp[2] + tmp[3];
+#endif
+    for (; i < n; i++) {
+      sum += src[i] * src[i];
+    }
+    return sum / float(n);
+  }
+
+  /// `dest[i] = clamp(src[i], lo, hi)` - bulk limit enforcement, e.g. a whole
+  /// block of smoothed property values at once
+  inline void clamp(float* dest, const float* src, float lo, float hi, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t vlo = vdupq_n_f32(lo);
+    float32x4_t vhi = vdupq_n_f32(hi);
+    for (; i + 4 <= n; i += 4) {
+      vst1q_f32(dest + i, vminq_f32(vmaxq_f32(vld1q_f32(src + i), vlo), vhi));
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    const __m128 vlo = _mm_set1_ps(lo);
+    const __m128 vhi = _mm_set1_ps(hi);
+    for (; i + 4 <= n; i += 4) {
+      _mm_storeu_ps(dest + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), vlo), vhi));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] = std::min(std::max(src[i], lo), hi);
+    }
+  }
+
+  /// `dest[i] = clamp(lo + round((src[i] - lo) / step) * step, lo, hi)` - the
+  /// span form of {@ref otto::util::math::step_quantize}. `step` must be
+  /// positive; the single division happens once, outside the loop.
+  ///
+  /// Ties round up, implemented as truncation after +0.5 so the vector and
+  /// scalar paths agree on every arch. Off-grid-below-lo inputs truncate
+  /// differently than they floor, but everything down there clamps to `lo`
+  /// anyway
+  inline void step_quantize(float* dest, const float* src, float step, float lo, float hi, std::size_t n) noexcept
+  {
+    const float inv_step = 1.f / step;
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t vlo = vdupq_n_f32(lo);
+    float32x4_t vhi = vdupq_n_f32(hi);
+    float32x4_t vstep = vdupq_n_f32(step);
+    float32x4_t vinv = vdupq_n_f32(inv_step);
+    float32x4_t vhalf = vdupq_n_f32(0.5f);
+    for (; i + 4 <= n; i += 4) {
+      float32x4_t k = vmulq_f32(vsubq_f32(vld1q_f32(src + i), vlo), vinv);
+      float32x4_t q = vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(k, vhalf)));
+      vst1q_f32(dest + i, vminq_f32(vmaxq_f32(vmlaq_f32(vlo, q, vstep), vlo), vhi));
+    }
+#elif OTTO_MIX_KERNELS_SSE2
+    const __m128 vlo = _mm_set1_ps(lo);
+    const __m128 vhi = _mm_set1_ps(hi);
+    const __m128 vstep = _mm_set1_ps(step);
+    const __m128 vinv = _mm_set1_ps(inv_step);
+    const __m128 vhalf = _mm_set1_ps(0.5f);
+    for (; i + 4 <= n; i += 4) {
+      __m128 k = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i), vlo), vinv);
+      __m128 q = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_add_ps(k, vhalf)));
+      __m128 v = _mm_add_ps(vlo, _mm_mul_ps(q, vstep));
+      _mm_storeu_ps(dest + i, _mm_min_ps(_mm_max_ps(v, vlo), vhi));
+    }
+#endif
+    for (; i < n; i++) {
+      const float q = lo + float(std::int32_t((src[i] - lo) * inv_step + 0.5f)) * step;
+      dest[i] = std::min(std::max(q, lo), hi);
+    }
+  }
+
+  /// `dest[i] = a[i] + t * (b[i] - a[i])` - interpolate two whole parameter
+  /// or sample vectors at one shared position, e.g. preset morphing
+  inline void lerp(float* dest, const float* a, const float* b, float t, std::size_t n) noexcept
+  {
+    std::size_t i = 0;
+#if OTTO_MIX_KERNELS_NEON
+    float32x4_t vt = vdupq_n_f32(t);
+    for (; i + 4 <= n; i += 4) {
+      float32x4_t va = vld1q_f32(a + i);
+      vst1q_f32(dest + i, vmlaq_f32(va, vsubq_f32(vld1q_f32(b + i), va), vt));
+    }
+#elif OTTO_MIX_KERNELS_SSE
+    const __m128 vt = _mm_set1_ps(t);
+    for (; i + 4 <= n; i += 4) {
+      __m128 va = _mm_loadu_ps(a + i);
+      __m128 vb = _mm_loadu_ps(b + i);
+      _mm_storeu_ps(dest + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), vt)));
+    }
+#endif
+    for (; i < n; i++) {
+      dest[i] = a[i] + t * (b[i] - a[i]);
+    }
+  }
+
+} // namespace otto::util::dsp
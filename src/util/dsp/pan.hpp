@@ -43,6 +43,14 @@ struct PanSM {
     vol2 = v;
   }
 
+  /// Current channel weights (volume included), as set by `pos()`
+  float weight1() const {
+    return w1;
+  }
+  float weight2() const {
+    return w2;
+  }
+
 protected:
   float w1, w2; // channel weights
   float vol1 = 0.5;
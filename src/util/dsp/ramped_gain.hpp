@@ -0,0 +1,38 @@
+#pragma once
+
+/// \file
+/// Per-block gain ramping between prop snapshots.
+
+namespace otto::util::dsp {
+
+  /// A gain that follows a prop with one linear ramp per block.
+  ///
+  /// Call {@ref step} once per block with the current prop value; it returns the
+  /// gain at the block start, while the prop value itself is the gain at the block
+  /// end. Feed the pair to one of the `*_ramp` kernels in mix_kernels.hpp. This
+  /// dezippers level moves without recomputing any curve per sample - the ramp is
+  /// folded into the kernel's gain vector.
+  struct RampedGain {
+    RampedGain(float initial = 0.f) noexcept : current_(initial) {}
+
+    /// Snapshot `target` as the new block-end gain
+    ///
+    /// \returns the gain at the block start
+    float step(float target) noexcept
+    {
+      float from = current_;
+      current_ = target;
+      return from;
+    }
+
+    /// The gain at the end of the last block
+    float current() const noexcept
+    {
+      return current_;
+    }
+
+  private:
+    float current_;
+  };
+
+} // namespace otto::util::dsp
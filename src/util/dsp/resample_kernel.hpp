@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTTO_RESAMPLE_KERNEL_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OTTO_RESAMPLE_KERNEL_SSE 1
+#endif
+
+/// \file
+/// Block resampling kernel - gather + linear interpolation across a whole
+/// output block, replacing per-sample fractional reads.
+///
+/// End-of-sample handling lives outside the inner loop: the playback region is
+/// turned into a frame budget up front, the budgeted span runs without bounds
+/// checks, and the remainder of the block is zero filled. The phase
+/// accumulates in double - mapped samples run into tens of millions of frames,
+/// past what a float index can address exactly.
+
+namespace otto::util::dsp {
+
+  /// Result of {@ref resample_block}
+  struct ResampleResult {
+    /// The playhead after the block, in source frames. Clamped to the region
+    /// boundary when finished
+    double pos;
+    /// Frames written before the zero fill - `n` unless `finished`. Lets a
+    /// caller chain calls over multiple regions within one block
+    std::size_t frames;
+    /// Playback ran past the region - the rest of the block was zero filled
+    bool finished;
+  };
+
+  /// `dest[i] = lerp(src[floor(p)], src[floor(p) + 1], frac(p))` with `p = pos + i * rate`
+  ///
+  /// Reads stay inside `[lo, hi)` - `rate` may be negative for reverse
+  /// playback, and the entry `pos` is clamped into the region. Once `p` leaves
+  /// it, the rest of `dest` is zero filled and `finished` is set.
+  inline ResampleResult resample_block(float* dest,
+                                       const float* src,
+                                       double pos,
+                                       double rate,
+                                       double lo,
+                                       double hi,
+                                       std::size_t n) noexcept
+  {
+    pos = std::max(lo, std::min(pos, hi - 1));
+
+    // Frames until `floor(p) + 1` would read outside the region. This is the
+    // only boundary logic - the gather loop below is branch free
+    std::size_t budget = 0;
+    if (rate > 0) {
+      if (pos < hi - 1) budget = std::min(double(n), std::ceil((hi - 1 - pos) / rate));
+    } else if (rate < 0) {
+      if (pos > lo) budget = std::min(double(n), std::floor((pos - lo) / -rate) + 1);
+    } else {
+      budget = n;
+    }
+
+    std::size_t i = 0;
+#if OTTO_RESAMPLE_KERNEL_NEON
+    for (; i + 4 <= budget; i += 4) {
+      // No gather on NEON - fill the lanes scalar, vectorize the lerp
+      float a[4];
+      float b[4];
+      float f[4];
+      for (int k = 0; k < 4; k++) {
+        const double p = pos + double(i + k) * rate;
+        const auto idx = std::size_t(p);
+        a[k] = src[idx];
+        b[k] = src[idx + 1];
+        f[k] = float(p - double(idx));
+      }
+      const float32x4_t va = vld1q_f32(a);
+      vst1q_f32(dest + i, vmlaq_f32(va, vsubq_f32(vld1q_f32(b), va), vld1q_f32(f)));
+    }
+#elif OTTO_RESAMPLE_KERNEL_SSE
+    for (; i + 4 <= budget; i += 4) {
+      float a[4];
+      float b[4];
+      float f[4];
+      for (int k = 0; k < 4; k++) {
+        const double p = pos + double(i + k) * rate;
+        const auto idx = std::size_t(p);
+        a[k] = src[idx];
+        b[k] = src[idx + 1];
+        f[k] = float(p - double(idx));
+      }
+      const __m128 va = _mm_loadu_ps(a);
+      _mm_storeu_ps(dest + i,
+                    _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b), va), _mm_loadu_ps(f))));
+    }
+#endif
+    for (; i < budget; i++) {
+      const double p = pos + double(i) * rate;
+      const auto idx = std::size_t(p);
+      dest[i] = src[idx] + (src[idx + 1] - src[idx]) * float(p - double(idx));
+    }
+    for (; i < n; i++) {
+      dest[i] = 0.f;
+    }
+
+    ResampleResult res;
+    res.frames = budget;
+    res.finished = budget < n;
+    res.pos = res.finished ? (rate > 0 ? hi : lo) : pos + double(n) * rate;
+    return res;
+  }
+
+} // namespace otto::util::dsp
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "util/dsp/delay_arena.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTTO_REVERB_TANK_NEON 1
+#endif
+
+/// \file
+/// Block-processing Schroeder reverb tank - four damped feedback combs in
+/// parallel into three allpasses in series.
+///
+/// All comb delays are longer than an audio block, so reads within a block never
+/// depend on writes within the same block. That splits each block into three
+/// phases: contiguous delayed reads into an interleaved scratch buffer, a
+/// feedback/damping pass where the four tank legs sit in the four NEON lanes,
+/// and contiguous ring writes. No per-sample modulo anywhere - the rings are
+/// power-of-two sized and the only index wrapping is a segment split per block.
+
+namespace otto::util::dsp {
+
+  namespace reverb_detail {
+    constexpr std::size_t pow2_above(std::size_t n)
+    {
+      std::size_t res = 1;
+      while (res < n) res *= 2;
+      return res;
+    }
+  } // namespace reverb_detail
+
+  struct ReverbTank {
+    /// Comb (tank leg) delays in samples. Mutually prime, tuned at 44.1k
+    static constexpr std::array<std::size_t, 4> comb_delays = {1307, 1637, 1811, 1931};
+    /// Allpass delays in samples
+    static constexpr std::array<std::size_t, 3> allpass_delays = {1051, 337, 113};
+
+    static constexpr float allpass_gain = 0.7f;
+
+    /// All ring memory comes from the {@ref DelayArena} in one region - the
+    /// four comb rings followed by the three allpass rings.
+    ///
+    /// The owner arms the tank before processing and disarms it when its
+    /// engine is deselected, so a standby reverb holds no ring memory
+    void arm() noexcept
+    {
+      if (mem_ != nullptr) return;
+      mem_ = DelayArena::instance().acquire(arena_floats);
+      comb_pos_ = 0;
+      allpass_pos_ = {};
+      lowpass_ = {};
+    }
+
+    /// Hand the ring memory back. The tail is dropped with it
+    void disarm() noexcept
+    {
+      if (mem_ == nullptr) return;
+      DelayArena::instance().release(mem_);
+      mem_ = nullptr;
+    }
+
+    bool armed() const noexcept
+    {
+      return mem_ != nullptr;
+    }
+
+    /// Set the decay time (T60) in seconds
+    void decay(float seconds, float sample_rate) noexcept
+    {
+      for (std::size_t c = 0; c < 4; c++) {
+        feedback_[c] =
+          seconds <= 0.f ? 0.f : std::pow(0.001f, float(comb_delays[c]) / (seconds * sample_rate));
+      }
+    }
+
+    /// Set the damping of the comb feedback paths, in `[0, 1)`
+    void damping(float d) noexcept
+    {
+      damping_ = d;
+    }
+
+    /// Process a block. `in` and `out` may alias
+    void process(const float* in, float* out, std::size_t n)
+    {
+      if (legs_.size() < 4 * n) {
+        legs_.resize(4 * n);
+        writes_.resize(4 * n);
+      }
+
+      // Phase 1: delayed reads, interleaved so sample i of leg c lands in lane c
+      for (std::size_t c = 0; c < 4; c++) {
+        read_ring(comb_ring(c), (comb_pos_ + comb_ring_size - comb_delays[c]) & comb_mask,
+                  legs_.data() + c, n);
+      }
+
+      // Phase 2: damping one-pole and feedback, all four legs per iteration
+      std::size_t i = 0;
+#if OTTO_REVERB_TANK_NEON
+      {
+        float32x4_t lp = vld1q_f32(lowpass_.data());
+        float32x4_t fbk = vld1q_f32(feedback_.data());
+        float32x4_t d1 = vdupq_n_f32(1.f - damping_);
+        float32x4_t d2 = vdupq_n_f32(damping_);
+        for (; i < n; i++) {
+          float32x4_t legs = vld1q_f32(legs_.data() + 4 * i);
+          lp = vmlaq_f32(vmulq_f32(legs, d1), lp, d2);
+          vst1q_f32(writes_.data() + 4 * i, vmlaq_f32(vdupq_n_f32(in[i]), fbk, lp));
+          float32x2_t sum2 = vadd_f32(vget_low_f32(legs), vget_high_f32(legs));
+          out[i] = vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+        }
+        vst1q_f32(lowpass_.data(), lp);
+      }
+#else
+      for (; i < n; i++) {
+        float sum = 0;
+        for (std::size_t c = 0; c < 4; c++) {
+          float leg = legs_[4 * i + c];
+          lowpass_[c] = leg * (1.f - damping_) + lowpass_[c] * damping_;
+          writes_[4 * i + c] = in[i] + feedback_[c] * lowpass_[c];
+          sum += leg;
+        }
+        out[i] = sum;
+      }
+#endif
+
+      // Phase 3: contiguous ring writes
+      for (std::size_t c = 0; c < 4; c++) {
+        write_ring(comb_ring(c), comb_pos_, writes_.data() + c, n);
+      }
+      comb_pos_ = (comb_pos_ + n) & comb_mask;
+
+      // Allpasses in series. Delays can be shorter than the block, so process in
+      // chunks of at most one delay length - within a chunk, reads and writes
+      // don't overlap
+      process_allpass<0>(out, n);
+      process_allpass<1>(out, n);
+      process_allpass<2>(out, n);
+    }
+
+    /// Heap bytes held by the tank - see {@ref otto::core::engine::IEngine::memory_footprint}
+    std::size_t heap_bytes() const noexcept
+    {
+      return sizeof(float) * (legs_.capacity() + writes_.capacity());
+    }
+
+  private:
+    static constexpr std::size_t comb_ring_size = 2048;
+    static constexpr std::size_t comb_mask = comb_ring_size - 1;
+
+    /// Region layout: four comb rings, then the three allpass rings
+    static constexpr std::size_t arena_floats =
+      4 * comb_ring_size + reverb_detail::pow2_above(allpass_delays[0]) +
+      reverb_detail::pow2_above(allpass_delays[1]) + reverb_detail::pow2_above(allpass_delays[2]);
+
+    /// Copy `n` samples starting at ring position `start` to `dest`, `dest + 4`, ...
+    static void read_ring(const float* ring, std::size_t start, float* dest, std::size_t n)
+    {
+      std::size_t first = std::min(n, comb_ring_size - start);
+      for (std::size_t i = 0; i < first; i++) dest[4 * i] = ring[start + i];
+      for (std::size_t i = first; i < n; i++) dest[4 * i] = ring[i - first];
+    }
+
+    /// Copy `src[0], src[4], ...` into the ring starting at position `start`
+    static void write_ring(float* ring, std::size_t start, const float* src, std::size_t n)
+    {
+      std::size_t first = std::min(n, comb_ring_size - start);
+      for (std::size_t i = 0; i < first; i++) ring[start + i] = src[4 * i];
+      for (std::size_t i = first; i < n; i++) ring[i - first] = src[4 * i];
+    }
+
+    template<std::size_t A>
+    void process_allpass(float* buf, std::size_t n)
+    {
+      constexpr std::size_t delay = allpass_delays[A];
+      constexpr std::size_t size = reverb_detail::pow2_above(delay);
+      constexpr std::size_t mask = size - 1;
+      float* ring = allpass_ring<A>();
+      std::size_t& pos = allpass_pos_[A];
+      for (std::size_t done = 0; done < n;) {
+        std::size_t chunk = std::min(delay, n - done);
+        std::size_t read = (pos + size - delay) & mask;
+        for (std::size_t i = 0; i < chunk; i++) {
+          float vd = ring[(read + i) & mask];
+          float v = buf[done + i] + allpass_gain * vd;
+          ring[(pos + i) & mask] = v;
+          buf[done + i] = vd - allpass_gain * v;
+        }
+        pos = (pos + chunk) & mask;
+        done += chunk;
+      }
+    }
+
+    std::array<float, 4> feedback_ = {};
+    std::array<float, 4> lowpass_ = {};
+    float damping_ = 0;
+
+    /// The arena region - see {@ref arm}. All rings index into this
+    float* mem_ = nullptr;
+    std::size_t comb_pos_ = 0;
+
+    /// Interleaved scratch - sample i of leg c at index `4 * i + c`
+    std::vector<float> legs_;
+    std::vector<float> writes_;
+
+    float* comb_ring(std::size_t c) noexcept
+    {
+      return mem_ + c * comb_ring_size;
+    }
+
+    // The allpass rings have different sizes
+    template<std::size_t A>
+    float* allpass_ring()
+    {
+      std::size_t offset = 4 * comb_ring_size;
+      if constexpr (A > 0) offset += reverb_detail::pow2_above(allpass_delays[0]);
+      if constexpr (A > 1) offset += reverb_detail::pow2_above(allpass_delays[1]);
+      return mem_ + offset;
+    }
+
+    std::array<std::size_t, 3> allpass_pos_ = {};
+  };
+
+} // namespace otto::util::dsp
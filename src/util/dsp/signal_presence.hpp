@@ -0,0 +1,65 @@
+#pragma once
+
+/// \file
+/// Block-level signal presence tracking, used to bypass idle stages in the
+/// effect chain.
+
+namespace otto::util::dsp {
+
+  /// Tracks whether an effect stage provably outputs silence.
+  ///
+  /// An effect can only be skipped when its input is silent *and* its tail has
+  /// decayed - a reverb tank keeps ringing long after the input stops. The tail is
+  /// not estimated from effect parameters; it is measured. While the input is
+  /// silent the effect keeps running, and once a whole output block falls below
+  /// the threshold too, the stage is bypassed until the input comes back.
+  ///
+  /// The owner calls {@ref should_bypass} at block start with the mean square of
+  /// the stage input, and - only while {@ref decaying} - {@ref observe_output}
+  /// with the mean square of the rendered output.
+  struct EffectBypass {
+    /// Amplitude below which a block counts as silent - about -80 dBFS.
+    ///
+    /// Low enough that a tail cut at this level is inaudible over the rest of the
+    /// mix, high enough that denormal-range tank feedback doesn't keep a stage
+    /// alive forever
+    static constexpr float threshold = 1e-4f;
+
+    /// Update with the mean square of the stage input for this block.
+    ///
+    /// \returns true when the stage can be skipped this block
+    bool should_bypass(float input_mean_square) noexcept
+    {
+      input_active_ = input_mean_square > threshold * threshold;
+      if (input_active_) bypassed_ = false;
+      return bypassed_;
+    }
+
+    /// Is the stage running on a decaying tail only?
+    ///
+    /// True when the input is silent but the stage has not been bypassed yet. The
+    /// owner only needs to measure the output in this state
+    bool decaying() const noexcept
+    {
+      return !input_active_ && !bypassed_;
+    }
+
+    /// Update with the mean square of the rendered output.
+    ///
+    /// Flips to bypassed once the tail has decayed below the threshold
+    void observe_output(float output_mean_square) noexcept
+    {
+      if (!input_active_ && output_mean_square <= threshold * threshold) bypassed_ = true;
+    }
+
+    bool bypassed() const noexcept
+    {
+      return bypassed_;
+    }
+
+  private:
+    bool input_active_ = false;
+    bool bypassed_ = false;
+  };
+
+} // namespace otto::util::dsp
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+
+namespace otto::util::dsp {
+
+  /// A single shared, precomputed sine wavetable with linear interpolation.
+  ///
+  /// All oscillators reading from it share one table, so with many operators/voices the
+  /// table stays hot in cache and the per-sample cost is two loads and a lerp instead
+  /// of a polynomial sine evaluation.
+  struct sine_table {
+    static constexpr int size = 4096;
+
+    /// Look up `sin(pi * p)` for a signed normalized phase `p` in `[-1, 1)`
+    static float lookup_signed(float p) noexcept
+    {
+      float idx = (p * 0.5f + 0.5f) * size;
+      int i = int(idx);
+      float frac = idx - float(i);
+      return table[i] + frac * (table[i + 1] - table[i]);
+    }
+
+    /// Look up `sin(2pi * p)` for a unit phase `p` in `[0, 1)`
+    static float lookup_unit(float p) noexcept
+    {
+      float idx = p * size + size / 2;
+      if (idx >= size) idx -= size;
+      int i = int(idx);
+      float frac = idx - float(i);
+      return table[i] + frac * (table[i + 1] - table[i]);
+    }
+
+  private:
+    /// The table spans one full period with a guard point, so interpolation never wraps
+    static inline const std::array<float, size + 1> table = [] {
+      std::array<float, size + 1> res = {};
+      for (int i = 0; i < size + 1; i++) {
+        res[i] = std::sin(2.0 * M_PI * double(i) / double(size) - M_PI);
+      }
+      return res;
+    }();
+  };
+
+} // namespace otto::util::dsp
@@ -1,64 +1,70 @@
 #include "transpose.hpp"
 
+#include <algorithm>
+
+#include "util/dsp/mix_kernels.hpp"
+#include "util/dsp/window.hpp"
+
 namespace otto::dsp {
 
-  /// Simple Pitch shifter
-  SimplePitchShift::SimplePitchShift()
-  {
-    this->maxdelay(10000);
-    this->crossfade(1000);
+  namespace {
 
-    for (int i = 0; i < 2; i++) {
-      amp[i].attack(0.9 * _crossfade / gam::sampleRate());
-      amp[i].decay(0.f);
-      amp[i].sustain(1.0);
-      amp[i].release(0.9 * _crossfade / gam::sampleRate());
-      amp[i].finish();
-    }
+    /// Periodic hann at the grain length - entries [0, grain_length) of the
+    /// compile-time table. The grains sit half a grain apart, and
+    /// `w[a] + w[a + hop] == 1` exactly, so the overlap-add level is flat
+    constexpr auto window_table =
+      util::dsp::make_window_table<util::dsp::Window::hann, GrainPitchShift::grain_length>();
 
-    lfo_delay[1].phase(0.5);
-  }
+    const std::array<float, GrainPitchShift::grain_length> window = [] {
+      std::array<float, GrainPitchShift::grain_length> res = {};
+      for (int i = 0; i < GrainPitchShift::grain_length; i++) res[i] = float(window_table[i]);
+      return res;
+    }();
+  } // namespace
 
-  float SimplePitchShift::operator()(float in) noexcept
+  void GrainPitchShift::process(const float* in, float* out, int nframes) noexcept
   {
-    float res = float(0);
-    for (int i = 0; i < 2; i++) {
-      delay_amount[i] -= 1;
-      if (delay_amount[i] < 0)
-        delay_amount[i] = 0;
-      else if (delay_amount[i] < _crossfade) {
-        amp_amount[i] = 0.f;
-        amp[i].release();
-      }
+    // Write the whole block first - grain reads always lag the write head, so
+    // this also makes `out` aliasing `in` safe
+    for (int i = 0; i < nframes; i++) ring_[w_ + i] = in[i];
+    const std::size_t block_start = w_;
+    w_ += std::size_t(nframes);
 
-      if (delay_amount[(i + 1) % 2] == _crossfade) {
-        delay_amount[i] = _maxdelay + _crossfade;
-        amp_amount[i] = 1.;
-        amp[i].reset();
-      }
+    std::fill_n(out, nframes, 0.f);
 
-      delay[i].delaySamples(delay_amount[i]);
-      res += delay[i](in) * amp[i]();
-    }
-    return res;
-  }
-
-  void SimplePitchShift::crossfade(int cf)
-  {
-    _crossfade = cf;
-    for (int i = 0; i < 2; i++) {
-      delay[i].maxDelay((float) (_maxdelay + _crossfade) / gam::sampleRate());
+    int i = 0;
+    while (i < nframes) {
+      if (phase_ == 0) {
+        // (Re)start the next grain one grain behind the write head; reading at
+        // twice the write rate it ends just short of it
+        grains_[next_grain_] = {0, block_start + std::size_t(i) - std::size_t(grain_length + 2)};
+        next_grain_ ^= 1;
+        phase_ = hop;
+      }
+      // Segments are bounded by grain restarts, so ages stay in [0, grain_length)
+      const int m = std::min(nframes - i, phase_);
+      for (auto& grain : grains_) {
+        if (grain.age >= grain_length) continue;
+        read_stride2(grain.read_start + 2 * std::size_t(grain.age), m);
+        util::dsp::accumulate_product(out + i, grain_buf_.data(), window.data() + grain.age, std::size_t(m));
+        grain.age += m;
+      }
+      phase_ -= m;
+      i += m;
     }
-    _frac = cf / _maxdelay;
   }
 
-  void SimplePitchShift::maxdelay(int md)
+  void GrainPitchShift::read_stride2(std::size_t start, int m) noexcept
   {
-    _maxdelay = md;
-    for (int i = 0; i < 2; i++) {
-      delay[i].maxDelay((float) (_maxdelay + _crossfade) / gam::sampleRate());
+    int done = 0;
+    while (done < m) {
+      const std::size_t s = ring_.wrap(start + 2 * std::size_t(done));
+      // The SIMD gather reads pairs, so keep `s + 2 * fit` inside the ring; at
+      // the very edge fall back to a single scalar read to keep making progress
+      const int fit = std::min(m - done, std::max(int((ring_size - s) / 2), 1));
+      util::dsp::copy_stride2(grain_buf_.data() + done, ring_.data() + s, std::size_t(fit));
+      done += fit;
     }
-    _frac = _crossfade / md;
   }
 
 } // namespace otto::dsp
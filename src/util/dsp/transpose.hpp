@@ -1,40 +1,48 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
-#include <Gamma/Delay.h>
-#include <Gamma/Filter.h>
-#include <Gamma/Oscillator.h>
-#include <Gamma/Spatial.h>
-#include <Gamma/Types.h>
-#include <Gamma/scl.h>
-#include <Gamma/Envelope.h>
+#include "util/ringbuffer.hpp"
 
 namespace otto::dsp {
 
-  /// Simple Pitch shifter
-  struct SimplePitchShift {
-    SimplePitchShift();
-
-    float operator()(float) noexcept;
-
-    // Sets crossfade in seconds
-    void crossfade(int);
-
-    // Sets maximum delay in seconds
-    void maxdelay(int);
+  /// Overlap-add granular pitch shifter, fixed one octave up.
+  ///
+  /// Feeds the Wormhole shimmer path. Two hann-windowed grains at 50% overlap
+  /// read a ring buffer at twice the write rate; the octave ratio makes the
+  /// read stride an exact two samples, so the fractional-delay reads reduce to
+  /// a vectorized stride-2 gather and the crossfades to span-wise
+  /// multiply-accumulates against the compile-time window tables from
+  /// util/dsp/window. The window pair sums to exactly one across the overlap,
+  /// so the shifted level matches the input.
+  struct GrainPitchShift {
+    /// Grain length in samples (~43 ms at 48 kHz)
+    static constexpr int grain_length = 2048;
+    /// Distance between grain starts - 50% overlap
+    static constexpr int hop = grain_length / 2;
+
+    /// Shift a block up an octave. `out` may alias `in`
+    void process(const float* in, float* out, int nframes) noexcept;
 
   private:
-    std::array<gam::Delay<>, 2> delay;
-    std::array<gam::ADSR<>, 2> amp;
-    std::array<gam::LFO<>, 2> lfo_delay;
-
-    int _maxdelay = 10000;
-    int _crossfade = 300;
-    float _frac = 0.2;
-
-    std::array<int, 2> delay_amount = {_maxdelay + _crossfade, 0};
-    std::array<float, 2> amp_amount = {1.f, 0.f};
+    static constexpr std::size_t ring_size = 4096;
+
+    struct Grain {
+      int age = grain_length;     ///< Samples rendered; at grain_length the window has closed
+      std::size_t read_start = 0; ///< Unwrapped ring index of the first read
+    };
+
+    /// Gather `m` samples at stride 2 from the ring into `grain_buf_`,
+    /// splitting at the wrap so the kernel reads contiguous memory
+    void read_stride2(std::size_t start, int m) noexcept;
+
+    util::wrapping_array<float, ring_size> ring_ = {};
+    std::array<Grain, 2> grains_ = {};
+    std::array<float, hop> grain_buf_ = {};
+    std::size_t w_ = 0; ///< Total samples written - only ever wrapped on access
+    int phase_ = 0;     ///< Samples until the next grain (re)start
+    int next_grain_ = 0;
   };
 
 } // namespace otto::dsp
@@ -3,6 +3,35 @@
 
 namespace otto::util::dsp {
 
+  namespace {
+
+    constexpr int table_points = 1024;
+
+    constexpr auto hann_table            = make_window_table<Window::hann, table_points>();
+    constexpr auto hamming_table         = make_window_table<Window::hamming, table_points>();
+    constexpr auto blackman_table        = make_window_table<Window::blackman, table_points>();
+    constexpr auto blackman_harris_table = make_window_table<Window::blackman_harris, table_points>();
+
+    /// Fill the buffer by linearly interpolating the table over [0, 1]
+    void fill_from_table (gsl::span<double> buffer, const std::array<double, table_points + 1>& table) noexcept
+    {
+        const auto size = buffer.size();
+        if (size == 1)
+        {
+            buffer[0] = table[0];
+            return;
+        }
+        const double step = static_cast<double> (table_points) / static_cast<double> (size - 1);
+        for (int i = 0; i < size; ++i)
+        {
+            const double idx = static_cast<double> (i) * step;
+            const int j = idx >= table_points ? table_points - 1 : static_cast<int> (idx);
+            const double frac = idx - static_cast<double> (j);
+            buffer[i] = table[j] + frac * (table[j + 1] - table[j]);
+        }
+    }
+  }
+
   Window::Window (int size, WindowType type, bool normalize) : window_buffer(size)
   {
       reset (size, type, normalize);
@@ -18,7 +47,8 @@ namespace otto::util::dsp {
 
   void Window::compute (gsl::span<double> buffer, WindowType type, bool normalize) noexcept
   {
-      auto cosn = [](int n, int i, int size) { return cos (static_cast<double> (n * M_PI * i) / static_cast<double> (size - 1)); };
+      // The trig-based shapes come from compile-time tables sampled over
+      // [0, 1]; any runtime size just interpolates them
       auto size = buffer.size();
 
       switch (type)
@@ -39,48 +69,19 @@ namespace otto::util::dsp {
           break;
 
           case hann:
-          {
-              for (int i = 0; i < size; ++i)
-              {
-                  auto cos2 = cosn (2, i, size);
-                  buffer[i] = 0.5 - 0.5 * cos2;
-              }
-          }
+              fill_from_table (buffer, hann_table);
           break;
 
           case hamming:
-          {
-              for (int i = 0; i < size; ++i)
-              {
-                  auto cos2 = cosn (2, i, size);
-                  buffer[i] = 0.54 - 0.46 * cos2;
-              }
-          }
+              fill_from_table (buffer, hamming_table);
           break;
 
           case blackman:
-          {
-              for (int i = 0; i < size; ++i)
-              {
-                  auto cos2 = cosn (2, i, size);
-                  auto cos4 = cosn (4, i, size);
-
-                  buffer[i] = 0.42 - 0.5 * cos2 + 0.08 * cos4;
-              }
-          }
+              fill_from_table (buffer, blackman_table);
           break;
 
           case blackman_harris:
-          {
-              for (int i = 0; i < size; ++i)
-              {
-                  auto cos2 = cosn (2, i, size);
-                  auto cos4 = cosn (4, i, size);
-                  auto cos6 = cosn (6, i, size);
-
-                  buffer[i] = 0.35875 - 0.48829 * cos2 + 0.14128 * cos4 - 0.01168 * cos6;
-              }
-          }
+              fill_from_table (buffer, blackman_harris_table);
           break;
           default:
               break;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <gsl/span>
 #include <string>
 #include "util/dyn-array.hpp"
@@ -38,4 +39,64 @@ namespace otto::util::dsp {
   private:
       dyn_array<double> window_buffer;
   };
+
+  namespace window_detail {
+
+    /// cos for compile-time table generation - std::cos is not constexpr.
+    ///
+    /// Range reduction to [0, pi] plus a Taylor series; accurate to well below
+    /// 1e-10 over the arguments the window formulas produce
+    constexpr double ccos (double x) noexcept
+    {
+        if (x < 0.0) x = -x;
+        constexpr double two_pi = 2.0 * M_PI;
+        while (x >= two_pi) x -= two_pi;
+        if (x > M_PI) x = two_pi - x;
+        const double x2 = x * x;
+        double term = 1.0;
+        double sum = 1.0;
+        for (int k = 1; k <= 10; ++k)
+        {
+            term *= -x2 / static_cast<double> ((2 * k - 1) * (2 * k));
+            sum += term;
+        }
+        return sum;
+    }
+  }
+
+  /// Sample a window shape at compile time.
+  ///
+  /// Returns `Points + 1` samples of the window over [0, 1] inclusive. The
+  /// tables built from this are constexpr, so they live in read-only data
+  /// shared between processes and cost nothing to generate at startup or on
+  /// Window::reset - arbitrary runtime sizes are filled by interpolating them.
+  template<Window::WindowType Type, int Points>
+  constexpr std::array<double, Points + 1> make_window_table() noexcept
+  {
+      std::array<double, Points + 1> res = {};
+      for (int j = 0; j <= Points; ++j)
+      {
+          const double x = static_cast<double> (j) / static_cast<double> (Points);
+          const double cos2 = window_detail::ccos (2.0 * M_PI * x);
+          switch (Type)
+          {
+              case Window::hann:
+                  res[j] = 0.5 - 0.5 * cos2;
+                  break;
+              case Window::hamming:
+                  res[j] = 0.54 - 0.46 * cos2;
+                  break;
+              case Window::blackman:
+                  res[j] = 0.42 - 0.5 * cos2 + 0.08 * window_detail::ccos (4.0 * M_PI * x);
+                  break;
+              case Window::blackman_harris:
+                  res[j] = 0.35875 - 0.48829 * cos2 + 0.14128 * window_detail::ccos (4.0 * M_PI * x)
+                         - 0.01168 * window_detail::ccos (6.0 * M_PI * x);
+                  break;
+              default:
+                  res[j] = 1.0;
+          }
+      }
+      return res;
+  }
 }
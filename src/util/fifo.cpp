@@ -1,11 +1,14 @@
 #include "fifo.hpp"
 
+#include <algorithm>
 #include <cstdio>
 #include <gsl/gsl_util>
 
 // Linux headers
 #include <errno.h>   // Error integer and strerror() function
 #include <fcntl.h>   // Contains file controls like O_RDWR
+#include <poll.h>    // poll()
+#include <sys/uio.h> // writev()
 #include <termios.h> // Contains POSIX terminal control definitions
 #include <unistd.h>  // write(), read(), close()
 
@@ -50,16 +53,68 @@ namespace otto::util {
     return {};
   }
 
+  expected<void> FIFO::write(gsl::span<const ConstBytesView> parts)
+  {
+    std::vector<::iovec> iov;
+    iov.reserve(parts.size());
+    std::size_t total = 0;
+    for (auto& part : parts) {
+      iov.push_back({const_cast<std::uint8_t*>(part.data()), std::size_t(part.size())});
+      total += part.size();
+    }
+    auto res = ::writev(fd_, iov.data(), iov.size());
+    if (res != total) {
+      return tl::make_unexpected(exception(ErrorCode::error,
+        "Error writing {} bytes to fifo {}, writev returned {}. ERR {}: {}", total, path_, res,
+        errno, strerror(errno)));
+    }
+    return {};
+  }
+
+  expected<void> FIFO::refill() noexcept
+  {
+    auto res = ::read(fd_, read_buf_.data(), read_buf_.size());
+    if (res == 0) {
+      return tl::make_unexpected(exception(ErrorCode::empty_buffer, "No data avaliable on fifo"));
+    }
+    if (res < 0) {
+      return tl::make_unexpected(
+        exception(ErrorCode::error, "Error reading from fifo {}, read returned {}. ERR {}: {}",
+                  path_, res, errno, strerror(errno)));
+    }
+    read_pos_ = 0;
+    read_size_ = std::size_t(res);
+    return {};
+  }
+
   expected<void> FIFO::read(BytesView dest) noexcept
   {
-    auto res = ::read(fd_, dest.data(), dest.size());
+    std::size_t copied = 0;
+    while (copied < std::size_t(dest.size())) {
+      if (!has_buffered()) {
+        auto res = refill();
+        if (!res) return res;
+      }
+      auto n = std::min(std::size_t(dest.size()) - copied, read_size_ - read_pos_);
+      std::copy_n(read_buf_.begin() + read_pos_, n, dest.begin() + copied);
+      read_pos_ += n;
+      copied += n;
+    }
+    return {};
+  }
+
+  expected<void> FIFO::wait_readable(int timeout_ms) noexcept
+  {
+    if (has_buffered()) return {};
+    ::pollfd pfd = {fd_, POLLIN, 0};
+    auto res = ::poll(&pfd, 1, timeout_ms);
     if (res == 0) {
       return tl::make_unexpected(exception(ErrorCode::empty_buffer, "No data avaliable on fifo"));
     }
-    if (res != dest.size()) {
-      return tl::make_unexpected(exception(ErrorCode::error,
-        "Error reading {} bytes from fifo {}, write returned {}. ERR {}: {}", dest.size(),
-        path_, res, errno, strerror(errno)));
+    if (res < 0) {
+      return tl::make_unexpected(
+        exception(ErrorCode::error, "Error polling fifo {}. ERR {}: {}", path_, errno,
+                  strerror(errno)));
     }
     return {};
   }
@@ -80,14 +135,19 @@ namespace otto::util {
   expected<std::vector<std::uint8_t>> FIFO::read_line(std::uint8_t delim) noexcept
   {
     std::vector<std::uint8_t> res;
-    std::uint8_t c;
-    do {
-      auto ec = read_single();
-      if (!ec) return tl::make_unexpected(ec.error());
-      c = *ec;
-      res.push_back(c);
-    } while (c != delim);
-    return res;
+    while (true) {
+      if (!has_buffered()) {
+        auto ec = refill();
+        if (!ec) return tl::make_unexpected(ec.error());
+      }
+      auto first = read_buf_.begin() + read_pos_;
+      auto last = read_buf_.begin() + read_size_;
+      auto found = std::find(first, last, delim);
+      if (found != last) ++found;
+      res.insert(res.end(), first, found);
+      read_pos_ = std::size_t(found - read_buf_.begin());
+      if (!res.empty() && res.back() == delim) return res;
+    }
   }
 
 } // namespace otto::util
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <gsl/span>
 #include <string>
 #include <tl/expected.hpp>
@@ -24,6 +25,8 @@ namespace otto::util {
     using exception = util::as_exception<ErrorCode>;
 
     tl::expected<void, exception> write(ConstBytesView);
+    /// Write multiple buffers with a single writev() syscall
+    tl::expected<void, exception> write(gsl::span<const ConstBytesView> parts);
     tl::expected<void, exception> read(BytesView dest) noexcept;
     tl::expected<std::vector<std::uint8_t>, exception> read(std::size_t n) noexcept;
     template<std::size_t N>
@@ -32,6 +35,19 @@ namespace otto::util {
     tl::expected<std::vector<std::uint8_t>, exception> read_line(
       std::uint8_t delim = '\n') noexcept;
 
+    /// Block until the fifo is readable, or `timeout_ms` has passed.
+    ///
+    /// Returns `ErrorCode::empty_buffer` on timeout. Combined with
+    /// \ref has_buffered(), this lets a reader thread wake once per burst and
+    /// then drain complete frames from the internal buffer without syscalls.
+    tl::expected<void, exception> wait_readable(int timeout_ms) noexcept;
+
+    /// Is there unread data in the internal read buffer?
+    bool has_buffered() const noexcept
+    {
+      return read_pos_ != read_size_;
+    }
+
     const std::string& path() noexcept
     {
       return path_;
@@ -43,8 +59,19 @@ namespace otto::util {
     }
 
   private:
+    /// Refill the internal read buffer with a single read() syscall.
+    ///
+    /// All reads are served from this buffer, so a burst of small messages
+    /// costs one syscall, not one per message (or worse, per byte, as
+    /// `read_line` used to)
+    tl::expected<void, exception> refill() noexcept;
+
     std::string path_;
     int fd_;
+
+    std::array<std::uint8_t, 256> read_buf_;
+    std::size_t read_pos_ = 0;
+    std::size_t read_size_ = 0;
   };
 
   template<std::size_t N>
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/// \file
+/// Helpers for implementing `owned_buffer_bytes()` - the heap half of
+/// {@ref otto::core::engine::IEngine::memory_footprint}.
+
+namespace otto::util {
+
+  namespace footprint_detail {
+    template<typename C, typename = void>
+    struct has_capacity : std::false_type {};
+    template<typename C>
+    struct has_capacity<C, std::void_t<decltype(std::declval<const C&>().capacity())>> : std::true_type {};
+  } // namespace footprint_detail
+
+  /// Heap bytes held by a single container.
+  ///
+  /// Uses `capacity()` when the container has one (std::vector et al.) and
+  /// `size()` otherwise (util::dyn_array, the gam buffer types - they all
+  /// report their length in elements). The element size comes from
+  /// `operator[]`, so no `value_type` typedef is required.
+  template<typename C>
+  std::size_t heap_bytes_of(const C& c) noexcept
+  {
+    std::size_t n;
+    if constexpr (footprint_detail::has_capacity<C>::value) {
+      n = c.capacity();
+    } else {
+      n = c.size();
+    }
+    return n * sizeof(c[0]);
+  }
+
+  /// Sum {@ref heap_bytes_of} over several containers
+  template<typename... Cs>
+  std::size_t heap_bytes(const Cs&... cs) noexcept
+  {
+    return (heap_bytes_of(cs) + ... + std::size_t(0));
+  }
+
+} // namespace otto::util
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <tuple>
 #include <type_traits>
@@ -869,6 +870,112 @@ namespace otto::util {
       zipped_iterator<std::decay_t<decltype(std::end(std::declval<Ranges>()))>...> last;
     };
 
+    namespace detail {
+
+      /// Does `std::data(range)` yield a raw pointer, and `std::size(range)` exist?
+      ///
+      /// True for `std::vector`, `std::array`, `AudioBufferHandle`, C arrays etc.
+      template<typename Range, typename = void>
+      struct is_contiguous_range : std::false_type {};
+
+      template<typename Range>
+      struct is_contiguous_range<
+        Range,
+        std::void_t<decltype(std::data(std::declval<Range&>())),
+                    decltype(std::size(std::declval<Range&>()))>>
+        : std::is_pointer<decltype(std::data(std::declval<Range&>()))> {};
+
+    } // namespace detail
+
+    /// A zip over contiguous ranges, lowered to raw pointers
+    ///
+    /// Drop-in for \ref ZippedRange at the call site, but the iterator is a
+    /// pointer tuple and an index, so the compiler sees plain indexed loads
+    /// and stores and can vectorize the loop. Like the generic zip, iteration
+    /// stops at the end of the shortest range.
+    ///
+    /// The underlying pointers are also exposed through \ref data<N>() and
+    /// \ref size(), for handing the ranges on to SIMD kernels directly.
+    template<typename... Ts>
+    struct ContiguousZippedRange {
+      struct iterator {
+        using value_type = std::tuple<std::remove_const_t<Ts>...>;
+        using reference = std::tuple<Ts&...>;
+        using pointer = value_type*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        reference operator*() const
+        {
+          return dereference(std::index_sequence_for<Ts...>());
+        }
+
+        iterator& operator++()
+        {
+          ++index;
+          return *this;
+        }
+
+        iterator operator++(int)
+        {
+          auto copy = *this;
+          ++index;
+          return copy;
+        }
+
+        bool operator==(const iterator& o) const
+        {
+          return index == o.index;
+        }
+
+        bool operator!=(const iterator& o) const
+        {
+          return index != o.index;
+        }
+
+        std::tuple<Ts*...> pointers;
+        std::size_t index = 0;
+
+      private:
+        template<std::size_t... Ns>
+        reference dereference(std::index_sequence<Ns...>) const
+        {
+          return {std::get<Ns>(pointers)[index]...};
+        }
+      };
+
+      ContiguousZippedRange(std::size_t size, Ts*... pointers)
+        : _pointers{pointers...}, _size{size}
+      {}
+
+      iterator begin() const
+      {
+        return {_pointers, 0};
+      }
+
+      iterator end() const
+      {
+        return {_pointers, _size};
+      }
+
+      /// Pointer to the start of the `N`th zipped range
+      template<std::size_t N>
+      auto data() const
+      {
+        return std::get<N>(_pointers);
+      }
+
+      /// Number of zipped elements - the size of the shortest range
+      std::size_t size() const
+      {
+        return _size;
+      }
+
+    private:
+      std::tuple<Ts*...> _pointers;
+      std::size_t _size;
+    };
+
     /// Create a ZippedRange from ranges
     ///
     /// Its very useful with structured bindings and `for` loops, letting you iterate
@@ -878,10 +985,20 @@ namespace otto::util {
     ///   ...
     /// }
     /// ```
+    ///
+    /// When all ranges are contiguous, this returns a \ref ContiguousZippedRange
+    /// instead, which generates tight, vectorizable loops.
     template<typename... Ranges>
     auto zip(Ranges&&... ranges)
     {
-      return ZippedRange<Ranges...>(std::forward<Ranges>(ranges)...);
+      if constexpr ((detail::is_contiguous_range<Ranges>::value && ...)) {
+        auto size = std::numeric_limits<std::size_t>::max();
+        ((size = std::size(ranges) < size ? std::size(ranges) : size), ...);
+        return ContiguousZippedRange<std::remove_pointer_t<decltype(std::data(ranges))>...>(
+          size, std::data(ranges)...);
+      } else {
+        return ZippedRange<Ranges...>(std::forward<Ranges>(ranges)...);
+      }
     }
 
 
@@ -1,13 +1,135 @@
 #include "jsonfile.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <fstream>
 #include <iomanip>
+#include <utility>
+#include <vector>
 #include <json.hpp>
 
 namespace otto::util {
 
   using json = nlohmann::json;
 
+  namespace {
+    /// SAX handler that builds one top-level section at a time, handing each
+    /// completed section to the callback instead of growing a document-wide
+    /// DOM. Only unconsumed sections end up in `rest`
+    struct SectionSax final : nlohmann::json_sax<json> {
+      SectionSax(const JsonFile::SectionHandler& h, json& r) : handler(h), rest(r) {}
+
+      const JsonFile::SectionHandler& handler;
+      json& rest;
+
+      /// The document root turned out not to be an object - the caller should
+      /// fall back to a full parse
+      bool not_an_object = false;
+      std::string error;
+
+      bool null() override { return handle_value(nullptr); }
+      bool boolean(bool val) override { return handle_value(val); }
+      bool number_integer(number_integer_t val) override { return handle_value(val); }
+      bool number_unsigned(number_unsigned_t val) override { return handle_value(val); }
+      bool number_float(number_float_t val, const string_t&) override { return handle_value(val); }
+      bool string(string_t& val) override { return handle_value(std::move(val)); }
+
+      bool start_object(std::size_t) override { return start_container(json::object()); }
+      bool start_array(std::size_t) override { return start_container(json::array()); }
+
+      bool key(string_t& val) override
+      {
+        if (_stack.empty()) {
+          _section_key = std::move(val);
+        } else {
+          _pending_key = std::move(val);
+        }
+        return true;
+      }
+
+      bool end_object() override
+      {
+        // The root object closing is the only end event with no container open
+        if (_stack.empty()) return true;
+        return end_container();
+      }
+
+      bool end_array() override { return end_container(); }
+
+      bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+      {
+        error = ex.what();
+        return false;
+      }
+
+    private:
+      bool handle_value(json&& v)
+      {
+        if (!_root_started) {
+          not_an_object = true;
+          return false;
+        }
+        if (_stack.empty()) {
+          finish_section(std::move(v));
+          return true;
+        }
+        place(std::move(v));
+        return true;
+      }
+
+      bool start_container(json&& container)
+      {
+        if (!_root_started) {
+          if (!container.is_object()) {
+            not_an_object = true;
+            return false;
+          }
+          _root_started = true;
+          return true;
+        }
+        _stack.push_back(&place(std::move(container)));
+        return true;
+      }
+
+      bool end_container()
+      {
+        _stack.pop_back();
+        if (_stack.empty()) finish_section(std::move(_section_value));
+        return true;
+      }
+
+      /// Insert `v` into the innermost open container, or make it the section
+      /// value when none is open
+      json& place(json&& v)
+      {
+        if (_stack.empty()) {
+          return _section_value = std::move(v);
+        }
+        auto& parent = *_stack.back();
+        if (parent.is_array()) {
+          parent.push_back(std::move(v));
+          return parent.back();
+        }
+        return parent[std::move(_pending_key)] = std::move(v);
+      }
+
+      void finish_section(json&& v)
+      {
+        if (!handler(_section_key, std::move(v))) {
+          rest[std::move(_section_key)] = std::move(v);
+        }
+      }
+
+      bool _root_started = false;
+      std::string _section_key;
+      json _section_value;
+      /// Open containers within the current section, innermost last
+      std::vector<json*> _stack;
+      std::string _pending_key;
+    };
+  } // namespace
+
   JsonFile::JsonFile(const fs::path& p)
     : _path (p)
   {}
@@ -22,16 +144,60 @@ namespace otto::util {
       dir_p.remove_filename();
       fs::create_directories(dir_p);
     }
+    // Serialize to a sibling temp file, sync it, and rename over the target -
+    // a power cut anywhere in here leaves either the old file or the new one,
+    // never a truncated mix. The fsync before the rename matters: without it
+    // the rename can hit the journal before the data does, and a badly timed
+    // cut leaves an empty file under the final name
+    auto tmp = _path.string() + ".tmp";
     errno = 0;
-    std::ofstream stream(_path, std::ios::trunc);
+    std::ofstream stream(tmp, std::ios::trunc);
     stream << std::setw(2) << _data << std::endl;
     stream.close();
     if (errno) {
       throw std::system_error(errno, std::system_category());
     }
+    int fd = ::open(tmp.c_str(), O_WRONLY);
+    if (fd >= 0) {
+      ::fsync(fd);
+      ::close(fd);
+    }
+    fs::rename(tmp, _path);
   }
 
   void JsonFile::read(JsonFile::OpenOptions options)
+  {
+    auto stream = open_read(options);
+    _data.clear();
+    stream >> _data;
+    stream.close();
+    if (auto ec = validate(); ec != ErrorCode::none) {
+      throw exception(ec, "Error while reading preset file '{}'", _path.c_str());
+    }
+  }
+
+  void JsonFile::read_sections(const SectionHandler& handler, OpenOptions options)
+  {
+    auto stream = open_read(options);
+    _data.clear();
+    SectionSax sax{handler, _data};
+    const bool ok = json::sax_parse(stream, &sax);
+    stream.close();
+    if (sax.not_an_object) {
+      // Nothing to split into sections - parse the document whole instead
+      read(options);
+      return;
+    }
+    if (!ok) {
+      throw exception(ErrorCode::invalid_json, "Error while reading '{}': {}", _path.c_str(),
+                      sax.error);
+    }
+    if (auto ec = validate(); ec != ErrorCode::none) {
+      throw exception(ec, "Error while reading '{}'", _path.c_str());
+    }
+  }
+
+  std::ifstream JsonFile::open_read(JsonFile::OpenOptions options)
   {
     std::ifstream stream;
     stream.open(_path);
@@ -45,12 +211,7 @@ namespace otto::util {
     if (!stream) {
       throw std::system_error(errno, std::system_category());
     }
-    _data.clear();
-    stream >> _data;
-    stream.close();
-    if (auto ec = validate(); ec != ErrorCode::none) {
-      throw exception(ec, "Error while reading preset file '{}'", _path.c_str());
-    }
+    return stream;
   }
 
 #pragma GCC diagnostic push 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+#include <iosfwd>
 #include <string>
 #include <json.hpp>
 
@@ -53,6 +55,26 @@ namespace otto::util {
     /// `std::system_error` on IO failure
     virtual void read(OpenOptions = OpenOptions::none);
 
+    /// Handler for one top-level section during a streaming read
+    ///
+    /// Receives the key and the fully parsed value of one member of the
+    /// document root. Return `true` if the section was consumed. A handler
+    /// that returns `false` must leave the value intact - it is then stored
+    /// in `data()` as a normal read would have.
+    using SectionHandler = std::function<bool(const std::string&, nlohmann::json&&)>;
+
+    /// Read the file one top-level section at a time
+    ///
+    /// \effects parse `path()` with a SAX parser, calling `handler` with each
+    /// member of the document root as it completes. Consumed sections are
+    /// discarded immediately, so only the leftovers build nodes in `data()`.
+    /// If the document root is not an object, falls back to a plain @ref read.
+    /// No filestreams are left open.
+    ///
+    /// \throws `exception` on parse failure, `fs::filesystem_error` or
+    /// `std::system_error` on IO failure
+    void read_sections(const SectionHandler& handler, OpenOptions = OpenOptions::none);
+
     /// Access the stored data
     nlohmann::json& data() noexcept { return _data; }
 
@@ -70,6 +92,10 @@ namespace otto::util {
     /// called in `read` and `write`, and should be used to validate the json data.
     virtual ErrorCode validate() const { return ErrorCode::none; };
 
+    /// Open `path()` for reading, creating it first if `OpenOptions::create`
+    /// is set. Shared by @ref read and @ref read_sections
+    std::ifstream open_read(OpenOptions);
+
     nlohmann::json _data = {};
     const fs::path _path;
   };
@@ -2,6 +2,7 @@
 
 #include <initializer_list>
 #include <new>
+#include <utility>
 #include <tl/expected.hpp>
 
 #include "util/exception.hpp"
@@ -169,6 +170,12 @@ namespace otto::util {
       });
     }
 
+    /// Inserts value at the front, shifting the other elements back
+    constexpr tl::expected<iterator, error> push_front(const value_type& value) noexcept
+    {
+      return insert_before(begin(), value);
+    }
+
     /// Inserts value before iter. NOTE: use insert_before for noexcept version
     ///
     /// Mainly provided for use with STL algorithms like transform.
@@ -179,6 +186,23 @@ namespace otto::util {
       return insert_before(iter, value).value();
     }
 
+    /// Erase the element at `iter`, preserving the order of the rest
+    constexpr iterator erase(iterator iter) noexcept
+    {
+      return erase(iter, iter + 1);
+    }
+
+    /// Erase the elements in `[first, last)`, preserving the order of the rest
+    constexpr iterator erase(iterator first, iterator last) noexcept
+    {
+      for (auto *src = last, *dst = first; src != end(); ++src, ++dst) {
+        *dst = std::move(*src);
+      }
+      const auto n = last - first;
+      for (auto i = 0; i < n; i++) pop_back();
+      return first;
+    }
+
     constexpr tl::expected<void, error> pop_back() noexcept
     {
       if (empty()) return tl::unexpected(error::empty);
@@ -160,6 +160,129 @@ namespace otto::util {
     std::mutex _outer_lock;
   };
 
+  /// A sequence lock around a trivially copyable `T`
+  ///
+  /// For read-mostly state shared with the draw thread - screen display
+  /// state, meter values. Writers serialize on a mutex among themselves and
+  /// bump a sequence counter around every store; readers copy the value out
+  /// and retry on the rare overlap with a write, so the draw loop never
+  /// blocks behind a burst of key handlers the way it does behind
+  /// {@ref locked}'s mutex, and readers never make the writer wait.
+  ///
+  /// A read costs a copy of `T` plus two loads of the counter - keep `T`
+  /// small. For bigger or non-trivial state, use {@ref triple_buffer}.
+  template<typename T>
+  struct seq_lock {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "seq_lock contents are copied out under a possible concurrent write, so they "
+                  "must be trivially copyable");
+
+    seq_lock(const T& init = T{}) noexcept : _value(init) {}
+
+    /// Writer side: publish a new value. Never blocked by readers
+    void store(const T& v) noexcept
+    {
+      std::unique_lock lock(_write_lock);
+      const auto seq = _seq.load(std::memory_order_relaxed);
+      // Odd sequence = write in progress. The fence keeps the data stores
+      // from moving up past it
+      _seq.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      _value = v;
+      _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Writer side: update the current value in place and publish it
+    ///
+    /// \param f Invocable as `f(T&)`
+    template<typename Func>
+    void modify(Func&& f)
+    {
+      std::unique_lock lock(_write_lock);
+      const auto seq = _seq.load(std::memory_order_relaxed);
+      _seq.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      std::invoke(std::forward<Func>(f), _value);
+      _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Reader side: copy the current value out, without ever blocking.
+    ///
+    /// Retries when a write overlapped the copy - with the intended
+    /// read-mostly usage that is rare enough to never spin more than once
+    T load() const noexcept
+    {
+      for (;;) {
+        const auto before = _seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        T copy = _value;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_seq.load(std::memory_order_relaxed) == before) return copy;
+      }
+    }
+
+  private:
+    std::atomic<std::uint32_t> _seq = 0;
+    T _value;
+    std::mutex _write_lock;
+  };
+
+  /// Wait-free single-producer single-consumer triple buffer
+  ///
+  /// The writer fills {@ref write} and calls {@ref publish}, the reader calls
+  /// {@ref swap_read} to flip to the most recently published buffer. Neither
+  /// side ever blocks or spins, and the reader always sees a complete,
+  /// coherent `T` - never a half-written one.
+  template<typename T>
+  struct triple_buffer {
+    static_assert(std::is_copy_assignable_v<T>);
+
+    triple_buffer(const T& init = T{}) : _store{{init, init, init}} {}
+
+    /// Writer side: the buffer currently being filled
+    T& write() noexcept
+    {
+      return _store[_write_idx];
+    }
+
+    /// Writer side: hand the write buffer over to the reader
+    ///
+    /// The new write buffer is seeded with a copy of the published contents,
+    /// so partial updates accumulate instead of reviving stale values.
+    void publish() noexcept
+    {
+      auto published = _write_idx;
+      _write_idx = _shared.exchange(published | _fresh_bit, std::memory_order_acq_rel) & _index_mask;
+      _store[_write_idx] = _store[published];
+    }
+
+    /// Reader side: flip to the latest published buffer, if there is a new one
+    const T& swap_read() noexcept
+    {
+      if (_shared.load(std::memory_order_relaxed) & _fresh_bit) {
+        _read_idx = _shared.exchange(_read_idx, std::memory_order_acq_rel) & _index_mask;
+      }
+      return _store[_read_idx];
+    }
+
+    /// Reader side: the buffer flipped to by the last {@ref swap_read}
+    const T& read() const noexcept
+    {
+      return _store[_read_idx];
+    }
+
+  private:
+    static constexpr char _index_mask = 0b011;
+    static constexpr char _fresh_bit = 0b100;
+
+    std::array<T, 3> _store;
+    char _write_idx = 0;
+    char _read_idx = 1;
+    /// Index of the last published buffer, with {@ref _fresh_bit} set if the
+    /// reader has not picked it up yet
+    std::atomic<char> _shared = 2;
+  };
+
 } // namespace otto::util
 
 //  LocalWords:  util
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/// \file
+/// A bounded lock-free queue for passing events into the audio thread.
+
+namespace otto::util {
+
+  /// Bounded multi-producer/multi-consumer lock-free queue.
+  ///
+  /// Based on the classic bounded MPMC queue design with a per-cell sequence number.
+  /// All storage is allocated inline, so neither {@ref try_push} nor {@ref try_pop}
+  /// allocates - both are safe to call from the audio thread.
+  ///
+  /// \tparam T the element type. Moved in on push, moved out on pop.
+  /// \tparam Capacity the fixed capacity. Must be a power of two.
+  template<typename T, std::size_t Capacity>
+  struct lockfree_queue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "lockfree_queue: Capacity must be a power of two");
+
+    lockfree_queue() noexcept
+    {
+      for (std::size_t i = 0; i < Capacity; i++) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    lockfree_queue(const lockfree_queue&) = delete;
+
+    /// Try to push an element.
+    ///
+    /// \returns `false` if the queue was full, in which case the element is untouched
+    bool try_push(T&& val) noexcept
+    {
+      std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+      for (;;) {
+        Cell& cell = _cells[pos & (Capacity - 1)];
+        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        auto diff = (std::intptr_t) seq - (std::intptr_t) pos;
+        if (diff == 0) {
+          if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            cell.value = std::move(val);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /// Try to pop an element into `val`.
+    ///
+    /// \returns `false` if the queue was empty
+    bool try_pop(T& val) noexcept
+    {
+      std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+      for (;;) {
+        Cell& cell = _cells[pos & (Capacity - 1)];
+        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        auto diff = (std::intptr_t) seq - (std::intptr_t)(pos + 1);
+        if (diff == 0) {
+          if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            val = std::move(cell.value);
+            cell.sequence.store(pos + Capacity, std::memory_order_release);
+            return true;
+          }
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /// Is the queue empty?
+    ///
+    /// Approximate under concurrent access - use it as a hint only, e.g. for the
+    /// wakeup-pending check in a consumer loop.
+    bool empty() const noexcept
+    {
+      return _enqueue_pos.load(std::memory_order_acquire) == _dequeue_pos.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Cell {
+      std::atomic<std::size_t> sequence;
+      T value;
+    };
+
+    std::array<Cell, Capacity> _cells;
+    // Producer and consumer indices on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<std::size_t> _enqueue_pos = 0;
+    alignas(64) std::atomic<std::size_t> _dequeue_pos = 0;
+  };
+
+} // namespace otto::util
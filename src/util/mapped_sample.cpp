@@ -0,0 +1,166 @@
+#include "mapped_sample.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <AudioFile.h>
+
+#include "services/log_manager.hpp"
+
+namespace otto::util {
+
+  namespace {
+    /// Header of the native cache format. Followed directly by `frames` floats.
+    struct CacheHeader {
+      static constexpr std::uint32_t magic_value = 0x4F545346; // "OTSF"
+      std::uint32_t magic = magic_value;
+      std::uint32_t frames = 0;
+      float samplerate = 0;
+      std::uint32_t reserved = 0;
+    };
+
+    bool convert_to_cache(const fs::path& audio_file, const fs::path& cache_file)
+    {
+      AudioFile<float> decoded;
+      if (!decoded.load(audio_file)) {
+        LOGE("Could not decode sample file {}", audio_file);
+        return false;
+      }
+      CacheHeader header;
+      header.frames = decoded.getNumSamplesPerChannel();
+      header.samplerate = decoded.getSampleRate();
+      auto tmp = cache_file.string() + ".tmp";
+      int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) return false;
+      bool ok = ::write(fd, &header, sizeof(header)) == sizeof(header);
+      auto data_size = std::size_t(header.frames) * sizeof(float);
+      ok = ok && ::write(fd, decoded.samples[0].data(), data_size) == ssize_t(data_size);
+      ::close(fd);
+      if (!ok) {
+        ::unlink(tmp.c_str());
+        return false;
+      }
+      return ::rename(tmp.c_str(), cache_file.string().c_str()) == 0;
+    }
+  } // namespace
+
+  MappedSample::MappedSample(MappedSample&& rhs) noexcept
+    : _map_base(rhs._map_base),
+      _data(rhs._data),
+      _map_length(rhs._map_length),
+      _frames(rhs._frames),
+      _samplerate(rhs._samplerate)
+  {
+    rhs._map_base = nullptr;
+    rhs._data = nullptr;
+    rhs._map_length = 0;
+  }
+
+  MappedSample& MappedSample::operator=(MappedSample&& rhs) noexcept
+  {
+    unmap();
+    _map_base = rhs._map_base;
+    _data = rhs._data;
+    _map_length = rhs._map_length;
+    _frames = rhs._frames;
+    _samplerate = rhs._samplerate;
+    rhs._map_base = nullptr;
+    rhs._data = nullptr;
+    rhs._map_length = 0;
+    return *this;
+  }
+
+  MappedSample::~MappedSample() noexcept
+  {
+    unmap();
+  }
+
+  void MappedSample::unmap() noexcept
+  {
+    if (_map_base != nullptr) {
+      ::munmap(_map_base, _map_length);
+      _map_base = nullptr;
+      _data = nullptr;
+      _map_length = 0;
+    }
+  }
+
+  void MappedSample::advise(std::uint32_t first_frame, std::uint32_t n_frames, int advice) const noexcept
+  {
+    if (_map_base == nullptr || n_frames == 0 || first_frame >= _frames) return;
+    n_frames = std::min(n_frames, _frames - first_frame);
+    static const std::uintptr_t page = ::sysconf(_SC_PAGESIZE);
+    auto begin = reinterpret_cast<std::uintptr_t>(_data + first_frame);
+    auto end = reinterpret_cast<std::uintptr_t>(_data + first_frame + n_frames);
+    if (advice == MADV_DONTNEED) {
+      // Narrow to whole pages, so dropping a range never takes out data a
+      // neighbouring keep range shares a page with
+      begin = (begin + page - 1) & ~(page - 1);
+      end = end & ~(page - 1);
+    } else {
+      begin = begin & ~(page - 1);
+      end = (end + page - 1) & ~(page - 1);
+    }
+    if (begin >= end) return;
+    ::madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+  }
+
+  void MappedSample::prefetch(std::uint32_t first_frame, std::uint32_t n_frames) const noexcept
+  {
+    advise(first_frame, n_frames, MADV_WILLNEED);
+  }
+
+  void MappedSample::release(std::uint32_t first_frame, std::uint32_t n_frames) const noexcept
+  {
+    advise(first_frame, n_frames, MADV_DONTNEED);
+  }
+
+  bool MappedSample::load(const fs::path& audio_file, const fs::path& cache_dir)
+  {
+    std::error_code ec;
+    fs::create_directories(cache_dir, ec);
+    auto cache_file = cache_dir / (audio_file.filename().string() + ".f32");
+
+    bool need_convert = !fs::exists(cache_file, ec);
+    if (!need_convert) {
+      auto src_time = fs::last_write_time(audio_file, ec);
+      auto cache_time = fs::last_write_time(cache_file, ec);
+      need_convert = !ec && cache_time < src_time;
+    }
+    if (need_convert && !convert_to_cache(audio_file, cache_file)) return false;
+
+    int fd = ::open(cache_file.string().c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(CacheHeader)) {
+      ::close(fd);
+      return false;
+    }
+    auto length = std::size_t(st.st_size);
+    void* map = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    if (header.magic != CacheHeader::magic_value ||
+        length < sizeof(CacheHeader) + std::size_t(header.frames) * sizeof(float)) {
+      ::munmap(map, length);
+      return false;
+    }
+
+    unmap();
+    _map_base = map;
+    _data = reinterpret_cast<const float*>(static_cast<const char*>(map) + sizeof(CacheHeader));
+    _map_length = length;
+    _frames = header.frames;
+    _samplerate = header.samplerate;
+    return true;
+  }
+
+} // namespace otto::util
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "util/filesystem.hpp"
+
+namespace otto::util {
+
+  /// A sample memory-mapped from a native-format cache file.
+  ///
+  /// Audio files are converted once into a raw float cache file (a small header
+  /// followed by the mono sample data), which is then mapped read-only. Loading a
+  /// previously converted sample costs page faults instead of a full decode + copy,
+  /// the mapping is shared between processes, and the kernel can evict cold sample
+  /// pages under memory pressure.
+  ///
+  /// The mapped data can be handed directly to `gam::Array::source` /
+  /// `gam::SamplePlayer`.
+  struct MappedSample {
+    MappedSample() = default;
+    MappedSample(const MappedSample&) = delete;
+    MappedSample(MappedSample&&) noexcept;
+    MappedSample& operator=(MappedSample&&) noexcept;
+    ~MappedSample() noexcept;
+
+    /// Map the cache file for `audio_file`, converting it first if the cache is
+    /// missing or older than the source.
+    ///
+    /// The cache file lives in `cache_dir`, named after the audio file.
+    ///
+    /// \returns `true` on success. On failure the previous mapping (if any) is kept.
+    bool load(const fs::path& audio_file, const fs::path& cache_dir);
+
+    /// Release the mapping
+    void unmap() noexcept;
+
+    /// Ask the kernel to read `[first_frame, first_frame + n_frames)` ahead of
+    /// use, so playback never faults on disk latency. Cheap to repeat on
+    /// already-resident pages
+    void prefetch(std::uint32_t first_frame, std::uint32_t n_frames) const noexcept;
+    /// Drop the pages backing `[first_frame, first_frame + n_frames)`. The data
+    /// is re-read from the cache file on the next access. Only whole pages
+    /// inside the range are dropped
+    void release(std::uint32_t first_frame, std::uint32_t n_frames) const noexcept;
+
+    const float* data() const noexcept { return _data; }
+    std::uint32_t frames() const noexcept { return _frames; }
+    float samplerate() const noexcept { return _samplerate; }
+
+    explicit operator bool() const noexcept { return _data != nullptr; }
+
+  private:
+    void advise(std::uint32_t first_frame, std::uint32_t n_frames, int advice) const noexcept;
+
+    void* _map_base = nullptr;
+    const float* _data = nullptr;
+    std::size_t _map_length = 0;
+    std::uint32_t _frames = 0;
+    float _samplerate = 0;
+  };
+
+} // namespace otto::util
@@ -3,8 +3,12 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <valarray>
 
+#include "util/audio_span.hpp"
+
 namespace otto::util::math {
 
   template<typename T>
@@ -38,6 +42,35 @@ namespace otto::util::math {
     return (i % n + n) % n;
   }
 
+  /// Branchless clamp.
+  ///
+  /// min/max based, so floats compile to `minss`/`maxss` and integers to
+  /// conditional moves - no unpredictable branches when an encoder sweep
+  /// hammers a limited property, unlike the compare-and-branch form
+  template<typename T>
+  constexpr T clamp(T v, T min, T max) noexcept
+  {
+    return std::min(std::max(v, min), max);
+  }
+
+  /// Fused step-quantize and clamp.
+  ///
+  /// Snaps `v` to the grid `min + k * step` (nearest, ties up), then clamps
+  /// to `[min, max]` - one straight-line expression for the whole limit
+  /// enforcement of a stepped property. Agrees with the span form in
+  /// {@ref otto::util::dsp::step_quantize} on every representable input
+  template<typename T>
+  constexpr T step_quantize(T v, T step, T min, T max) noexcept
+  {
+    if (step <= T(0)) return clamp(v, min, max);
+    if constexpr (std::is_floating_point_v<T>) {
+      return clamp(T(min + std::floor((v - min) / step + T(0.5)) * step), min, max);
+    } else {
+      const T offs = v - min + (v >= min ? step / 2 : -step / 2);
+      return clamp(T(min + (offs / step) * step), min, max);
+    }
+  }
+
   /// Split a number into `N` values between 0 and 1, each representing a Nth
   /// part of the range `[min,max]`
   ///
@@ -79,5 +112,104 @@ namespace otto::util::math {
     const float a2 = 0.273f * x * (1.f - std::abs(x));
     return a1 + a2;
   }
+
+  /// Fast base-2 exponential.
+  ///
+  /// Fifth order polynomial for the fraction, exponent assembled directly
+  /// into the float bits. Max relative error < 1e-4 - about 0.2 cents when
+  /// used for pitch, so fine for per-sample pitch/envelope math.
+  inline float fastexp2(float x) noexcept
+  {
+    x = std::clamp(x, -126.f, 126.f);
+    const float fi = std::floor(x);
+    const float f = x - fi;
+    // Taylor polynomial for 2^f = e^(f ln2) on [0, 1)
+    const float p =
+      1.f +
+      f * (0.6931471806f +
+           f * (0.2402265070f + f * (0.0555041087f + f * (0.0096181291f + f * 0.0013333558f))));
+    std::uint32_t bits;
+    std::memcpy(&bits, &p, sizeof(bits));
+    bits += std::uint32_t(std::int32_t(fi)) << 23;
+    float res;
+    std::memcpy(&res, &bits, sizeof(res));
+    return res;
+  }
+
+  /// Fast natural exponential, through \ref fastexp2.
+  ///
+  /// Max relative error < 1e-4
+  inline float fastexp(float x) noexcept
+  {
+    return fastexp2(x * 1.4426950409f);
+  }
+
+  /// Fast base-2 logarithm for positive `x`.
+  ///
+  /// Exponent read from the float bits, rational approximation for the
+  /// mantissa. Max absolute error < 3e-4
+  inline float fastlog2(float x) noexcept
+  {
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const float y = float(bits) * 1.1920928955078125e-7f; // bits / 2^23
+    float m;
+    const std::uint32_t mbits = (bits & 0x007FFFFF) | 0x3F000000; // mantissa in [0.5, 1)
+    std::memcpy(&m, &mbits, sizeof(m));
+    return y - 124.22551499f - 1.498030302f * m - 1.72587999f / (0.3520887068f + m);
+  }
+
+  /// Fast `b^x` for positive `b`, through \ref fastexp2 and \ref fastlog2.
+  ///
+  /// Max relative error in the order of 1e-3 - use where std::pow shows up
+  /// per sample, not where exact response curves matter
+  inline float fastpow(float b, float x) noexcept
+  {
+    return fastexp2(x * fastlog2(b));
+  }
+
+  /// Fast sine for `x` in `[-pi, pi]`.
+  ///
+  /// Parabolic approximation with one refinement step. Max absolute
+  /// error < 1.2e-3 - smooth and zero at the right places, good for LFO
+  /// shapes, too coarse for additive synthesis
+  inline float fastsin(float x) noexcept
+  {
+    constexpr float B = 4.f / M_PI;
+    constexpr float C = -4.f / (M_PI * M_PI);
+    const float y = B * x + C * x * std::abs(x);
+    return 0.225f * (y * std::abs(y) - y) + y;
+  }
+
+  /// Fast tangent for `x` in `[-pi/4, pi/4]`.
+  ///
+  /// Odd Taylor polynomial. Max relative error < 4e-3 at the interval ends -
+  /// intended for filter coefficient prewarp, where cutoffs live well below
+  /// the interval end
+  inline float fasttan(float x) noexcept
+  {
+    const float x2 = x * x;
+    return x * (1.f + x2 * (1.f / 3.f + x2 * (2.f / 15.f + x2 * (17.f / 315.f))));
+  }
+
+  /// Span versions - simple loops over the scalar approximations, which
+  /// contain no branches, so the compiler can vectorize them
+  inline void fastexp2(audio_span<const float> x, audio_span<float> out) noexcept
+  {
+    auto [xp, op] = raw_frames(std::min(x.size(), out.size()), x, out);
+    for (std::ptrdiff_t i = 0; i < std::min(x.size(), out.size()); i++) op[i] = fastexp2(xp[i]);
+  }
+
+  inline void fastlog2(audio_span<const float> x, audio_span<float> out) noexcept
+  {
+    auto [xp, op] = raw_frames(std::min(x.size(), out.size()), x, out);
+    for (std::ptrdiff_t i = 0; i < std::min(x.size(), out.size()); i++) op[i] = fastlog2(xp[i]);
+  }
+
+  inline void fastsin(audio_span<const float> x, audio_span<float> out) noexcept
+  {
+    auto [xp, op] = raw_frames(std::min(x.size(), out.size()), x, out);
+    for (std::ptrdiff_t i = 0; i < std::min(x.size(), out.size()); i++) op[i] = fastsin(xp[i]);
+  }
 }// namespace otto::util::math
 
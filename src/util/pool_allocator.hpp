@@ -1,113 +1,150 @@
 #pragma once
 
-#include <limits>
+#include <array>
+#include <cstddef>
 #include <memory>
-
-#include "util/dyn-array.hpp"
+#include <vector>
 
 namespace otto::util {
 
-  template<typename T>
-  struct memory_pool {
-    memory_pool(std::size_t size) noexcept
-    {
-      // Allocate uninitialized storage
-      auto [ptr, len] = std::get_temporary_buffer<T>(size);
-      _data = ptr;
-      _size = len;
+  /// A slab allocator with power-of-two size-class bins and O(1) free lists.
+  ///
+  /// Memory is carved from fixed-size slabs requested from the system in bulk
+  /// and never returned, so long sessions cannot fragment the heap through
+  /// this pool - a freed block goes straight onto its bin's free list and is
+  /// handed out again by the next allocation of that size class.
+  ///
+  /// Each thread has its own pool, accessed through {@ref local}, so neither
+  /// allocation nor deallocation involves locks or atomics. A block freed on
+  /// a different thread than it was allocated on simply migrates to the
+  /// freeing thread's bin, which is safe because slabs are never returned to
+  /// the system.
+  ///
+  /// Requests larger than {@ref max_bin} fall through to plain `operator
+  /// new`/`delete`, and are counted in {@ref Stats::oversize}.
+  struct slab_pool {
+    /// Smallest bin size in bytes. Also the alignment guarantee
+    static constexpr std::size_t min_bin = 8;
+    /// Largest bin size in bytes
+    static constexpr std::size_t max_bin = 4096;
+    /// Bytes requested from the system per slab
+    static constexpr std::size_t slab_size = 64 * 1024;
+
+    /// Counters for inspection from the debug ui or tests
+    struct Stats {
+      std::size_t allocations = 0;
+      std::size_t deallocations = 0;
+      /// Allocations served by popping a free list instead of carving a slab
+      std::size_t reuses = 0;
+      /// Requests larger than {@ref max_bin}, served by `operator new`
+      std::size_t oversize = 0;
+      /// Number of slabs requested from the system
+      std::size_t slabs = 0;
+      /// Total bytes held in slabs
+      std::size_t bytes_reserved = 0;
     };
 
-    T* data() const noexcept
+    /// The calling thread's pool
+    static slab_pool& local() noexcept
     {
-      return _data;
+      thread_local slab_pool pool;
+      return pool;
     }
 
-    std::size_t size() const noexcept
+    void* allocate(std::size_t bytes)
     {
-      return _size;
+      stats_.allocations++;
+      if (bytes > max_bin) {
+        stats_.oversize++;
+        return ::operator new(bytes);
+      }
+      int bin = bin_of(bytes);
+      if (auto* node = bins_[bin]) {
+        bins_[bin] = node->next;
+        stats_.reuses++;
+        return node;
+      }
+      return carve(bin);
     }
 
-  private:
-    T* _data;
-    std::size_t _size;
-  };
-
-  template<typename T>
-  struct pool_allocator {
-    typedef T value_type;
-    typedef T* pointer;
-    typedef const T* const_pointer;
-    typedef T& reference;
-    typedef const T& const_reference;
-    typedef std::size_t size_type;
-    typedef std::ptrdiff_t difference_type;
-
-    template<typename U>
-    struct rebind {
-      typedef pool_allocator<U> other;
-    };
-
-    // return address of values
-    pointer address(reference value) const
+    void deallocate(void* ptr, std::size_t bytes) noexcept
     {
-      return &value;
+      stats_.deallocations++;
+      if (bytes > max_bin) {
+        ::operator delete(ptr);
+        return;
+      }
+      int bin = bin_of(bytes);
+      bins_[bin] = new (ptr) FreeNode{bins_[bin]};
     }
 
-    const_pointer address(const_reference value) const
+    const Stats& stats() const noexcept
     {
-      return &value;
+      return stats_;
     }
 
-    /* constructors and destructor
-     * - nothing to do because the allocator has no state
-     */
-    pool_allocator() noexcept = default;
-    pool_allocator(const pool_allocator&) noexcept = default;
-
-    template<typename U>
-    pool_allocator(const pool_allocator<U>&) noexcept {};
+  private:
+    struct FreeNode {
+      FreeNode* next;
+    };
 
-    ~pool_allocator() noexcept = default;
+    static constexpr int bin_count = 10; // 8, 16, ... 4096
 
-    // return maximum number of elements that can be allocated
-    size_type max_size() const noexcept
+    /// The bin index of the smallest size class that fits `bytes`
+    static int bin_of(std::size_t bytes) noexcept
     {
-      return std::numeric_limits<std::size_t>::max() / sizeof(T);
+      int bin = 0;
+      for (auto size = min_bin; size < bytes; size <<= 1) bin++;
+      return bin;
     }
 
-    // allocate but don't initialize num elements of type T
-    pointer allocate(size_type num, const void* = 0)
+    /// Carve a fresh slab into blocks for `bin`, and return one of them
+    void* carve(int bin)
     {
-      pointer ret = (pointer)(::operator new(num * sizeof(T)));
-      return ret;
+      auto block_size = min_bin << bin;
+      auto& slab = slabs_.emplace_back(std::make_unique<char[]>(slab_size));
+      stats_.slabs++;
+      stats_.bytes_reserved += slab_size;
+      // Chain all blocks but the first onto the free list
+      for (auto* block = slab.get() + block_size; block + block_size <= slab.get() + slab_size;
+           block += block_size) {
+        bins_[bin] = new (block) FreeNode{bins_[bin]};
+      }
+      return slab.get();
     }
 
-    // initialize elements of allocated storage p with value value
-    void construct(pointer p, const T& value)
-    {
-      // initialize memory with placement new
-      new ((void*) p) T(value);
-    }
+    std::array<FreeNode*, bin_count> bins_ = {};
+    std::vector<std::unique_ptr<char[]>> slabs_;
+    Stats stats_;
+  };
+
+  /// Standard allocator adaptor for {@ref slab_pool}
+  ///
+  /// Allocates from the calling thread's pool, so containers used on the
+  /// audio and logic threads get O(1) allocations without touching the
+  /// system heap.
+  template<typename T>
+  struct pool_allocator {
+    using value_type = T;
 
-    // destroy elements of initialized storage p
-    void destroy(pointer p)
+    pool_allocator() noexcept = default;
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U>&) noexcept {};
+
+    T* allocate(std::size_t n)
     {
-      // destroy objects by calling their destructor
-      p->~T();
+      return static_cast<T*>(slab_pool::local().allocate(n * sizeof(T)));
     }
 
-    // deallocate storage p of deleted elements
-    void deallocate(pointer p, size_type num)
+    void deallocate(T* p, std::size_t n) noexcept
     {
-      // print message and deallocate memory with global delete
-      ::operator delete((void*) p);
+      slab_pool::local().deallocate(p, n * sizeof(T));
     }
-
-  private:
-    memory_pool<value_type>& _mem_pool;
   };
 
-  // return that all specializations of this allocator are interchangeable
+  /// All instances are interchangeable - memory freed through any of them
+  /// lands in the freeing thread's pool
   template<class T1, class T2>
   bool operator==(const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept
   {
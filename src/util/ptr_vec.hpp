@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <memory>
 #include <type_traits>
@@ -307,6 +308,274 @@ namespace otto::util {
   }
 
 
+  /// A `unique_ptr_vec` with small-buffer storage, like \ref local_vector
+  ///
+  /// The first `Capacity` elements live inline in the container, so pushing
+  /// and erasing them never touches the allocator - elements past that spill
+  /// to the heap like `unique_ptr_vec`. Pointer stability is the same as
+  /// `unique_ptr_vec`: elements never move, so references stay valid until
+  /// the element is erased or the container is moved/destroyed.
+  template<typename T, std::size_t Capacity = 4>
+  struct local_ptr_vec {
+    using value_type = T;
+
+  private:
+    std::vector<value_type*> data_;
+
+  public:
+    using iterator = double_iterator<typename decltype(data_)::iterator>;
+    using const_iterator = double_iterator<typename decltype(data_)::const_iterator>;
+
+    using reverse_iterator = double_iterator<typename decltype(data_)::reverse_iterator>;
+    using const_reverse_iterator = double_iterator<typename decltype(data_)::const_reverse_iterator>;
+
+    local_ptr_vec() = default;
+
+    local_ptr_vec(const local_ptr_vec&) = delete;
+    local_ptr_vec& operator=(const local_ptr_vec&) = delete;
+
+    /// Bulk move - heap elements are stolen, inline elements move-constructed
+    local_ptr_vec(local_ptr_vec&& rhs)
+    {
+      append(std::move(rhs));
+    }
+
+    local_ptr_vec& operator=(local_ptr_vec&& rhs)
+    {
+      clear();
+      append(std::move(rhs));
+      return *this;
+    }
+
+    ~local_ptr_vec() noexcept
+    {
+      clear();
+    }
+
+    template<typename... Args>
+    value_type& emplace_back(Args&&... args)
+    {
+      // Reserve first, so the pointer push cannot throw after construction
+      data_.reserve(data_.size() + 1);
+      for (std::size_t i = 0; i < Capacity; i++) {
+        if (!used_[i]) {
+          auto* res = new (&storage_[i]) value_type(std::forward<Args>(args)...);
+          used_[i] = true;
+          data_.push_back(res);
+          return *res;
+        }
+      }
+      auto ptr = std::make_unique<value_type>(std::forward<Args>(args)...);
+      data_.push_back(ptr.get());
+      return *ptr.release();
+    }
+
+    value_type& push_back(const value_type& v)
+    {
+      return emplace_back(v);
+    }
+
+    value_type& push_back(value_type&& v)
+    {
+      return emplace_back(std::move(v));
+    }
+
+    value_type& push_back(std::unique_ptr<value_type> ptr)
+    {
+      data_.push_back(ptr.get());
+      return *ptr.release();
+    }
+
+    /// Move every element of `rhs` to the back of this vector
+    ///
+    /// Heap-allocated elements change owner without being moved or copied.
+    /// Inline elements are move-constructed into this vector - into inline
+    /// slots when free, otherwise onto the heap.
+    void append(local_ptr_vec&& rhs)
+    {
+      data_.reserve(data_.size() + rhs.size());
+      for (auto* el : rhs.data_) {
+        if (rhs.is_local(el)) {
+          emplace_back(std::move(*el));
+          el->~value_type();
+        } else {
+          data_.push_back(el);
+        }
+      }
+      rhs.data_.clear();
+      rhs.used_ = {};
+    }
+
+    /// Move every element of `rhs` to the back of this vector, stealing the
+    /// allocations
+    void append(unique_ptr_vec<value_type>&& rhs)
+    {
+      data_.reserve(data_.size() + rhs.size());
+      for (auto& ptr : rhs.underlying()) {
+        data_.push_back(ptr.get());
+        ptr.release();
+      }
+      rhs.underlying().clear();
+    }
+
+    /// Destroy the element `v`. Returns false if `v` is not in this vector
+    bool erase(const value_type& v)
+    {
+      auto iter = std::find_if(data_.begin(), data_.end(), [&v](auto* ptr) { return ptr == &v; });
+      if (iter == data_.end()) return false;
+      destroy(*iter);
+      data_.erase(iter);
+      return true;
+    }
+
+    void clear() noexcept
+    {
+      for (auto* el : data_) destroy(el);
+      data_.clear();
+    }
+
+    /// The number of elements stored inline
+    static constexpr std::size_t local_capacity() noexcept
+    {
+      return Capacity;
+    }
+
+    std::size_t size() const noexcept
+    {
+      return data_.size();
+    }
+
+    bool empty() const noexcept
+    {
+      return data_.empty();
+    }
+
+    std::size_t max_size() const noexcept
+    {
+      return data_.max_size();
+    }
+
+    void reserve(std::size_t new_cap)
+    {
+      data_.reserve(new_cap);
+    }
+
+    value_type& operator[](std::size_t n)
+    {
+      return *data_[n];
+    }
+
+    const value_type& operator[](std::size_t n) const
+    {
+      return *data_[n];
+    }
+
+    value_type& at(std::size_t n)
+    {
+      return *data_.at(n);
+    }
+
+    const value_type& at(std::size_t n) const
+    {
+      return *data_.at(n);
+    }
+
+    iterator begin()
+    {
+      return data_.begin();
+    }
+    iterator end()
+    {
+      return data_.end();
+    }
+    const_iterator begin() const
+    {
+      return data_.begin();
+    }
+    const_iterator end() const
+    {
+      return data_.end();
+    }
+
+    reverse_iterator rbegin()
+    {
+      return data_.rbegin();
+    }
+    reverse_iterator rend()
+    {
+      return data_.rend();
+    }
+    const_reverse_iterator rbegin() const
+    {
+      return data_.rbegin();
+    }
+    const_reverse_iterator rend() const
+    {
+      return data_.rend();
+    }
+
+    value_type& front()
+    {
+      return *data_.front();
+    }
+
+    value_type& back()
+    {
+      return *data_.back();
+    }
+
+    const value_type& front() const
+    {
+      return *data_.front();
+    }
+
+    const value_type& back() const
+    {
+      return *data_.back();
+    }
+
+    std::vector<value_type*>& underlying()
+    {
+      return data_;
+    }
+
+  private:
+    bool is_local(const value_type* ptr) const noexcept
+    {
+      auto* addr = reinterpret_cast<const char*>(ptr);
+      auto* first = reinterpret_cast<const char*>(&storage_);
+      return first <= addr && addr < first + sizeof(storage_);
+    }
+
+    void destroy(value_type* ptr) noexcept
+    {
+      if (is_local(ptr)) {
+        used_[static_cast<std::size_t>(reinterpret_cast<const Storage*>(ptr) - storage_.data())] =
+          false;
+        ptr->~value_type();
+      } else {
+        delete ptr;
+      }
+    }
+
+    using Storage = std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
+    std::array<Storage, Capacity> storage_;
+    std::array<bool, Capacity> used_ = {};
+  };
+
+  template<typename T, std::size_t C, typename T2>
+  bool erase(local_ptr_vec<T, C>& vec, T2* el)
+  {
+    return vec.erase(*el);
+  }
+
+  template<typename T, std::size_t C, typename T2>
+  bool erase(local_ptr_vec<T, C>& vec, T2& el)
+  {
+    return vec.erase(el);
+  }
+
+
   /// A convenience wrapper for std::vector<std::shared_ptr<T>>
   template<typename T>
   struct shared_ptr_vec {
@@ -91,6 +91,11 @@ namespace otto::util {
     {
       return storage[wrap(idx)];
     }
+
+    const value_type& operator[](std::size_t idx) const
+    {
+      return storage[wrap(idx)];
+    }
   };
 
   template<typename T, std::size_t N>
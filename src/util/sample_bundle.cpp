@@ -0,0 +1,170 @@
+#include "sample_bundle.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <AudioFile.h>
+
+#include "services/log_manager.hpp"
+
+namespace otto::util {
+
+  namespace {
+    /// Header of the bundle format. Followed by `channels` entries, followed
+    /// directly by the payload floats.
+    struct BundleHeader {
+      static constexpr std::uint32_t magic_value = 0x4F544B42; // "OTKB"
+      static constexpr std::uint32_t version_value = 1;
+      std::uint32_t magic = magic_value;
+      std::uint32_t version = version_value;
+      std::uint32_t channels = 0;
+      std::uint32_t reserved = 0;
+    };
+
+    struct BundleEntry {
+      char name[48] = {};
+      /// First frame in the payload
+      std::uint32_t offset = 0;
+      std::uint32_t frames = 0;
+      float samplerate = 0;
+      std::uint8_t root_note = 60;
+      std::uint8_t reserved[3] = {};
+    };
+    static_assert(sizeof(BundleEntry) == 64);
+
+    /// More channels than any kit can have - a larger count means a corrupt
+    /// index
+    constexpr std::uint32_t max_channels = 64;
+  } // namespace
+
+  SampleBundle::SampleBundle(SampleBundle&& rhs) noexcept
+    : _map_base(rhs._map_base), _map_length(rhs._map_length), _entries(std::move(rhs._entries))
+  {
+    rhs._map_base = nullptr;
+    rhs._map_length = 0;
+    rhs._entries.clear();
+  }
+
+  SampleBundle& SampleBundle::operator=(SampleBundle&& rhs) noexcept
+  {
+    unmap();
+    _map_base = rhs._map_base;
+    _map_length = rhs._map_length;
+    _entries = std::move(rhs._entries);
+    rhs._map_base = nullptr;
+    rhs._map_length = 0;
+    rhs._entries.clear();
+    return *this;
+  }
+
+  SampleBundle::~SampleBundle() noexcept
+  {
+    unmap();
+  }
+
+  void SampleBundle::unmap() noexcept
+  {
+    if (_map_base != nullptr) {
+      ::munmap(_map_base, _map_length);
+      _map_base = nullptr;
+      _map_length = 0;
+    }
+    _entries.clear();
+  }
+
+  bool SampleBundle::load(const fs::path& bundle_file)
+  {
+    int fd = ::open(bundle_file.string().c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(BundleHeader)) {
+      ::close(fd);
+      return false;
+    }
+    auto length = std::size_t(st.st_size);
+    void* map = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    BundleHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    auto fail = [&] {
+      ::munmap(map, length);
+      return false;
+    };
+    if (header.magic != BundleHeader::magic_value || header.version != BundleHeader::version_value ||
+        header.channels > max_channels) {
+      return fail();
+    }
+    auto index_size = sizeof(BundleHeader) + header.channels * sizeof(BundleEntry);
+    if (length < index_size) return fail();
+    auto* payload = reinterpret_cast<const float*>(static_cast<const char*>(map) + index_size);
+    auto payload_frames = (length - index_size) / sizeof(float);
+
+    std::vector<Entry> entries;
+    entries.reserve(header.channels);
+    for (std::uint32_t i = 0; i < header.channels; i++) {
+      BundleEntry raw;
+      std::memcpy(&raw, static_cast<const char*>(map) + sizeof(BundleHeader) + i * sizeof(raw),
+                  sizeof(raw));
+      if (raw.offset > payload_frames || raw.frames > payload_frames - raw.offset) return fail();
+      Entry entry;
+      entry.name = std::string(raw.name, ::strnlen(raw.name, sizeof(raw.name)));
+      entry.data = payload + raw.offset;
+      entry.frames = raw.frames;
+      entry.samplerate = raw.samplerate > 0 ? raw.samplerate : 1;
+      entry.root_note = raw.root_note;
+      entries.push_back(std::move(entry));
+    }
+
+    unmap();
+    _map_base = map;
+    _map_length = length;
+    _entries = std::move(entries);
+    return true;
+  }
+
+  bool SampleBundle::pack(const std::vector<fs::path>& sources, const fs::path& dest)
+  {
+    std::vector<AudioFile<float>> decoded(sources.size());
+    std::vector<BundleEntry> entries(sources.size());
+    std::uint32_t offset = 0;
+    for (std::size_t i = 0; i < sources.size(); i++) {
+      if (!decoded[i].load(sources[i])) {
+        LOGE("Could not decode sample file {}", sources[i]);
+        return false;
+      }
+      auto& entry = entries[i];
+      auto name = sources[i].stem().string();
+      std::strncpy(entry.name, name.c_str(), sizeof(entry.name) - 1);
+      entry.offset = offset;
+      entry.frames = decoded[i].getNumSamplesPerChannel();
+      entry.samplerate = decoded[i].getSampleRate();
+      offset += entry.frames;
+    }
+
+    BundleHeader header;
+    header.channels = std::uint32_t(entries.size());
+    auto tmp = dest.string() + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = ::write(fd, &header, sizeof(header)) == sizeof(header);
+    auto index_size = entries.size() * sizeof(BundleEntry);
+    ok = ok && ::write(fd, entries.data(), index_size) == ssize_t(index_size);
+    for (std::size_t i = 0; ok && i < decoded.size(); i++) {
+      auto data_size = std::size_t(entries[i].frames) * sizeof(float);
+      ok = ::write(fd, decoded[i].samples[0].data(), data_size) == ssize_t(data_size);
+    }
+    ::close(fd);
+    if (!ok) {
+      ::unlink(tmp.c_str());
+      return false;
+    }
+    return ::rename(tmp.c_str(), dest.string().c_str()) == 0;
+  }
+
+} // namespace otto::util
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "util/filesystem.hpp"
+
+namespace otto::util {
+
+  /// A packed kit of samples, memory-mapped from a single bundle file.
+  ///
+  /// The file is a small header index (names, offsets, lengths, samplerates,
+  /// root notes) followed by the raw mono float data of every channel, so a
+  /// whole drum kit loads with one open + mmap instead of a seek and decode per
+  /// file. The entry data can be handed directly to `gam::Array::source` /
+  /// `gam::SamplePlayer`, and the single file doubles as the unit for sharing
+  /// kits between units.
+  struct SampleBundle {
+    /// One channel of the kit. `data` points into the mapping and is valid
+    /// until the bundle is unmapped
+    struct Entry {
+      std::string name;
+      const float* data = nullptr;
+      std::uint32_t frames = 0;
+      float samplerate = 1;
+      /// The midi note the sample is pitched at. Stored for pitched playback
+      /// and round-tripping - playback speed stays a user property
+      std::uint8_t root_note = 60;
+    };
+
+    SampleBundle() = default;
+    SampleBundle(const SampleBundle&) = delete;
+    SampleBundle(SampleBundle&&) noexcept;
+    SampleBundle& operator=(SampleBundle&&) noexcept;
+    ~SampleBundle() noexcept;
+
+    /// Map `bundle_file` and parse its index.
+    ///
+    /// \returns `true` on success. On failure the previous mapping (if any) is
+    /// kept.
+    bool load(const fs::path& bundle_file);
+
+    /// Release the mapping. Invalidates the data pointers of all entries
+    void unmap() noexcept;
+
+    int channels() const noexcept { return int(_entries.size()); }
+
+    /// \preconditions `0 <= idx < channels()`
+    const Entry& entry(int idx) const noexcept { return _entries[idx]; }
+
+    explicit operator bool() const noexcept { return _map_base != nullptr; }
+
+    /// Decode `sources` and write them as a bundle to `dest`, one channel per
+    /// file in order. Entry names are the source filenames without extension.
+    ///
+    /// \returns `true` on success. Written atomically - `dest` is either the
+    /// complete bundle or untouched.
+    static bool pack(const std::vector<fs::path>& sources, const fs::path& dest);
+
+  private:
+    void* _map_base = nullptr;
+    std::size_t _map_length = 0;
+    std::vector<Entry> _entries;
+  };
+
+} // namespace otto::util
@@ -96,6 +96,19 @@ namespace otto::util {
     return {};
   }
 
+  expected<std::size_t> Serial::read_some(BytesView dest) noexcept
+  {
+    auto res = ::read(fd_, dest.data(), dest.size());
+    if (res == 0) {
+      return tl::make_unexpected(exception(ErrorCode::empty_buffer, "No data avaliable on serial port"));
+    }
+    if (res < 0) {
+      return tl::make_unexpected(exception(ErrorCode::error,
+        "Error reading from serial port {}. ERR {}: {}", path_, errno, strerror(errno)));
+    }
+    return std::size_t(res);
+  }
+
   expected<std::vector<std::uint8_t>> Serial::read(std::size_t n) noexcept
   {
     std::vector<std::uint8_t> res;
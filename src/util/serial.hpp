@@ -25,6 +25,11 @@ namespace otto::util {
 
     tl::expected<void, exception> write(ConstBytesView);
     tl::expected<void, exception> read(BytesView dest) noexcept;
+    /// Read whatever is available in one syscall, up to `dest.size()` bytes.
+    ///
+    /// Blocks per the vmin/vtime settings until at least one byte arrives.
+    /// Returns the number of bytes read
+    tl::expected<std::size_t, exception> read_some(BytesView dest) noexcept;
     tl::expected<std::vector<std::uint8_t>, exception> read(std::size_t n) noexcept;
     template<std::size_t N>
     tl::expected<std::array<std::uint8_t, N>, exception> read() noexcept;
@@ -46,6 +46,30 @@ namespace otto::util {
   json serialize_basic(const std::unordered_map<K, V>& obj);
 
 
+  /////////////////// DELTA ENCODING
+
+  /// Customization point for the delta encoding in {@ref serialize}.
+  ///
+  /// Members for which this returns true are omitted from the output, and
+  /// implied on load. The default never omits; properties overload it in
+  /// `core/props/props.hpp` to mean "still at its construction-time value",
+  /// which is what keeps state and preset files down to actual deviations.
+  template<typename T>
+  constexpr bool serialize_is_default(const T&) noexcept
+  {
+    return false;
+  }
+
+  /// Customization point: restore a member omitted from a delta encoded file.
+  ///
+  /// Invoked by {@ref deserialize} for reflected members with no entry in the
+  /// json. Does nothing by default; properties reset to their
+  /// construction-time value, skipping assignment and signal emission
+  /// entirely when they are already there - the common case on startup.
+  template<typename T>
+  constexpr void serialize_reset_default(T&) noexcept
+  {}
+
   /////////////////// DESERIALIZATION
 
   template<typename Class, typename = std::enable_if_t<reflect::is_registered<Class>()>>
@@ -9,10 +9,13 @@ namespace otto::util {
   template<typename Class, typename>
   json serialize(const Class& obj)
   {
-    json value;
+    // Delta encoding - members still at their default are omitted and
+    // implied on load. See serialize_is_default
+    json value = json::object();
     reflect::for_all_members<Class>([&obj, &value](auto& member) {
-      auto& valueName = value[std::string(member.get_name())];
-      valueName = serialize(member.get(obj));
+      decltype(auto) v = member.get(obj);
+      if (serialize_is_default(v)) return;
+      value[std::string(member.get_name())] = serialize(v);
     });
     return value;
   }
@@ -82,7 +85,14 @@ namespace otto::util {
     if (object.is_object()) {
       reflect::for_all_members<Class>([&obj, &object](auto& member) {
         auto iter = object.find(std::string(member.get_name()));
-        if (iter == object.end()) throw util::exception("Error: Member '{}' not found in json", member.get_name());
+        if (iter == object.end()) {
+          // Delta encoded files omit members at their default - restore it,
+          // so loading over a changed live state is still exact
+          if constexpr (std::decay_t<decltype(member)>::can_get_ref()) {
+            serialize_reset_default(member.get_ref(obj));
+          }
+          return;
+        }
         auto& objName = *iter;
         if (!objName.is_null()) {
           using MemberT = reflect::get_member_type<decltype(member)>;
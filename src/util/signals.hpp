@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <forward_list>
-#include <functional>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "util/delegate.hpp"
 
 namespace otto::util {
 
@@ -12,11 +17,76 @@ namespace otto::util {
   template<typename... Args>
   struct Signal;
 
+  namespace signal_detail {
+    /// Per-thread state for \ref defer_signals
+    struct signal_defer_state {
+      struct Entry {
+        void* signal;
+        void (*flush)(void*);
+      };
+
+      int depth = 0;
+      std::vector<Entry> queue;
+
+      static signal_defer_state& current()
+      {
+        static thread_local signal_defer_state instance;
+        return instance;
+      }
+
+      void remove(void* signal)
+      {
+        queue.erase(
+          std::remove_if(queue.begin(), queue.end(),
+                         [signal](const Entry& e) { return e.signal == signal; }),
+          queue.end());
+      }
+    };
+  } // namespace signal_detail
+
+  /// RAII scope that defers signal emissions on the current thread.
+  ///
+  /// While a `defer_signals` scope is alive, `Signal::emit` does not invoke
+  /// its slots - it stores the arguments, coalescing repeated emits of the
+  /// same signal to the last value. When the outermost scope ends, each
+  /// pending signal fires once. This turns a burst of emissions - say a fast
+  /// encoder sweep stepping the same property hundreds of times - into one
+  /// callback per distinct signal.
+  ///
+  /// Deferral is per-thread: emissions on other threads are unaffected, and
+  /// emissions from within the flushed slots run synchronously as usual.
+  struct defer_signals {
+    defer_signals() noexcept
+    {
+      signal_detail::signal_defer_state::current().depth++;
+    }
+
+    defer_signals(const defer_signals&) = delete;
+    defer_signals& operator=(const defer_signals&) = delete;
+
+    ~defer_signals()
+    {
+      auto& state = signal_detail::signal_defer_state::current();
+      if (--state.depth > 0) return;
+      // Swap out the queue first - slots may emit, and those emissions
+      // should run synchronously now that the scope has ended
+      auto queue = std::move(state.queue);
+      state.queue.clear();
+      for (auto& entry : queue) entry.flush(entry.signal);
+    }
+
+    /// Is emission currently deferred on this thread?
+    static bool active() noexcept
+    {
+      return signal_detail::signal_defer_state::current().depth > 0;
+    }
+  };
+
   /// Type-erased connection
   struct Slot {
     Slot() /*noexcept*/ = default;
 
-    Slot(Slot*& ptr, std::function<void()> d) noexcept : _ptr(&ptr), _disconnect(std::move(d))
+    Slot(Slot*& ptr, delegate<void()> d) noexcept : _ptr(&ptr), _disconnect(std::move(d))
     {
       if (_ptr) *_ptr = this;
     }
@@ -58,23 +128,23 @@ namespace otto::util {
     }
 
   private:
-    /// Pointer to the slot field in the Connection object in the list
+    /// Pointer to the slot field in the Connection object in the signal
     Slot** _ptr = nullptr;
-    std::function<void()> _disconnect = nullptr;
+    delegate<void()> _disconnect = nullptr;
   };
 
   template<typename... Args>
   struct SlotRef {
     using Signal = otto::util::Signal<Args...>;
     using Function = typename Signal::Function;
-    using ConIterator = typename Signal::ConIterator;
+    using Connection = typename Signal::Connection;
 
     Signal* signal;
-    ConIterator func_iter;
+    Connection* con;
 
     operator Slot()
     {
-      return {func_iter->slot, [cpy = *this] { cpy.signal->disconnect(cpy); }};
+      return {con->slot, [cpy = *this] { cpy.signal->disconnect(cpy); }};
     }
 
     SlotRef& call_now(Args...);
@@ -83,18 +153,17 @@ namespace otto::util {
   template<typename... Args>
   struct Signal {
     using SlotRef = otto::util::SlotRef<Args...>;
-    using Function = std::function<void(Args...)>;
+    using Function = delegate<void(Args...)>;
     struct Connection {
-      Connection(const Function& f) : func(f) {}
+      Connection() = default;
       Connection(Function&& f) : func(std::move(f)) {}
       ~Connection() noexcept
       {
         if (slot) slot->clear();
       }
-      Function func;
+      Function func = nullptr;
       Slot* slot = nullptr;
     };
-    using ConIterator = typename std::forward_list<Connection>::iterator;
 
     Signal() = default;
     ~Signal() noexcept;
@@ -103,8 +172,7 @@ namespace otto::util {
     Signal& operator=(const Signal&) = default;
     Signal& operator=(Signal&&) = default;
 
-    SlotRef connect(const Function& func);
-    SlotRef connect(Function&& func);
+    SlotRef connect(Function func);
 
     template<typename T>
     SlotRef connect_member(T* inst, void (T::*func)(Args...));
@@ -118,7 +186,15 @@ namespace otto::util {
     void emit(Args... a);
 
   private:
-    std::forward_list<Connection> _slots;
+    void flush_pending();
+
+    /// The first connection lives inline - a property with a single listener,
+    /// which is the overwhelmingly common case, never touches the heap and
+    /// emits through one function pointer
+    Connection _first;
+    std::forward_list<Connection> _overflow;
+    /// The coalesced arguments of deferred emissions - see \ref defer_signals
+    std::optional<std::tuple<std::decay_t<Args>...>> _pending;
   };
 
   // -- SlotRef IMPLEMENTATIONS -- //
@@ -126,7 +202,7 @@ namespace otto::util {
   template<typename... Args>
   SlotRef<Args...>& SlotRef<Args...>::call_now(Args... args)
   {
-    func_iter->func(std::forward<Args>(args)...);
+    con->func(std::forward<Args>(args)...);
     return *this;
   }
 
@@ -137,21 +213,19 @@ namespace otto::util {
   template<typename... Args>
   Signal<Args...>::~Signal() noexcept
   {
+    if (_pending) signal_detail::signal_defer_state::current().remove(this);
     disconnect_all();
   }
 
   template<typename... Args>
-  auto Signal<Args...>::connect(const Function& func) -> SlotRef
-  {
-    _slots.emplace_front(func);
-    return {this, _slots.begin()};
-  }
-
-  template<typename... Args>
-  auto Signal<Args...>::connect(Function&& func) -> SlotRef
+  auto Signal<Args...>::connect(Function func) -> SlotRef
   {
-    _slots.emplace_front(std::move(func));
-    return {this, _slots.begin()};
+    if (_first.func == nullptr) {
+      _first.func = std::move(func);
+      return {this, &_first};
+    }
+    _overflow.emplace_front(std::move(func));
+    return {this, &*_overflow.begin()};
   }
 
   template<typename... Args>
@@ -171,10 +245,16 @@ namespace otto::util {
   template<typename... Args>
   void Signal<Args...>::disconnect(SlotRef sr)
   {
-    auto prev = _slots.before_begin();
-    for (auto i = _slots.begin(); i != _slots.end(); i++) {
-      if (i == sr.func_iter) {
-        _slots.erase_after(prev);
+    if (sr.con == &_first) {
+      if (_first.slot) _first.slot->clear();
+      _first.slot = nullptr;
+      _first.func = nullptr;
+      return;
+    }
+    auto prev = _overflow.before_begin();
+    for (auto i = _overflow.begin(); i != _overflow.end(); i++) {
+      if (&*i == sr.con) {
+        _overflow.erase_after(prev);
         break;
       }
       prev = i;
@@ -184,15 +264,45 @@ namespace otto::util {
   template<typename... Args>
   void Signal<Args...>::disconnect_all()
   {
-    _slots.clear();
+    if (_first.slot) _first.slot->clear();
+    _first.slot = nullptr;
+    _first.func = nullptr;
+    _overflow.clear();
   }
 
   template<typename... Args>
   void Signal<Args...>::emit(Args... args)
   {
-    for (auto&& slot : _slots) {
+    auto& defer = signal_detail::signal_defer_state::current();
+    if (defer.depth > 0) {
+      if (!_pending) {
+        defer.queue.push_back(
+          {this, [](void* self) { static_cast<Signal*>(self)->flush_pending(); }});
+      }
+      // Coalesce to the last emitted value
+      _pending.emplace(args...);
+      return;
+    }
+    if (_first.func != nullptr) _first.func(args...);
+    for (auto&& slot : _overflow) {
       slot.func(args...);
     }
   }
 
+  template<typename... Args>
+  void Signal<Args...>::flush_pending()
+  {
+    if (!_pending) return;
+    auto args = std::move(*_pending);
+    _pending.reset();
+    std::apply(
+      [this](auto&... as) {
+        if (_first.func != nullptr) _first.func(as...);
+        for (auto&& slot : _overflow) {
+          slot.func(as...);
+        }
+      },
+      args);
+  }
+
 } // namespace otto::util
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include <fmt/format.h>
+
+namespace otto::util {
+
+  /// A fixed-capacity string with inline storage and no heap allocation.
+  ///
+  /// For values formatted every frame or every event - parameter displays,
+  /// log lines - where `std::string` shows up in allocation traces. Holds up
+  /// to `Capacity` characters plus a null terminator; anything longer is
+  /// truncated.
+  template<std::size_t Capacity>
+  struct static_string {
+    constexpr static_string() noexcept
+    {
+      data_[0] = '\0';
+    }
+
+    constexpr static_string(std::string_view str) noexcept
+    {
+      assign(str);
+    }
+
+    constexpr void assign(std::string_view str) noexcept
+    {
+      length_ = str.size() < Capacity ? str.size() : Capacity;
+      for (std::size_t i = 0; i < length_; i++) data_[i] = str[i];
+      data_[length_] = '\0';
+    }
+
+    constexpr const char* c_str() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr char* data() noexcept
+    {
+      return data_;
+    }
+
+    constexpr const char* data() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+      return length_;
+    }
+
+    constexpr static std::size_t capacity() noexcept
+    {
+      return Capacity;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+      return length_ == 0;
+    }
+
+    constexpr char* begin() noexcept
+    {
+      return data_;
+    }
+
+    constexpr char* end() noexcept
+    {
+      return data_ + length_;
+    }
+
+    constexpr const char* begin() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr const char* end() const noexcept
+    {
+      return data_ + length_;
+    }
+
+    constexpr operator std::string_view() const noexcept
+    {
+      return {data_, length_};
+    }
+
+    /// Set the length directly, after writing into {@ref data}
+    constexpr void resize(std::size_t length) noexcept
+    {
+      length_ = length < Capacity ? length : Capacity;
+      data_[length_] = '\0';
+    }
+
+  private:
+    char data_[Capacity + 1];
+    std::size_t length_ = 0;
+  };
+
+  /// `fmt::format` into a {@ref static_string}, with no heap allocation.
+  ///
+  /// Output that does not fit in `Capacity` characters is truncated.
+  /// `Fmt` is generic so compile-time format strings (`FMT_STRING`) pass
+  /// through to fmt with their type intact - the parse then happens at build
+  /// time. Plain strings still work, parsed at runtime as before.
+  template<std::size_t Capacity = 32, typename Fmt, typename... Args>
+  static_string<Capacity> format_static(const Fmt& format_str, Args&&... args)
+  {
+    static_string<Capacity> res;
+    auto result = fmt::format_to_n(res.data(), Capacity, format_str, std::forward<Args>(args)...);
+    res.resize(result.size);
+    return res;
+  }
+
+} // namespace otto::util
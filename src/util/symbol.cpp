@@ -0,0 +1,69 @@
+#include "symbol.hpp"
+
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace otto::util {
+
+  namespace {
+
+    /// The global intern table. `names` is a deque, so registered strings never
+    /// move and the `string_ref`s handed out stay valid forever. `index` keys
+    /// on views into those same strings - one copy of each name, total.
+    struct InternTable {
+      std::mutex mutex;
+      std::deque<std::string> names;
+      std::map<std::string_view, std::uint32_t> index;
+
+      static InternTable& instance() noexcept
+      {
+        static InternTable table;
+        return table;
+      }
+
+      std::uint32_t intern(std::string_view name)
+      {
+        if (name.empty()) return 0;
+        std::unique_lock lock{mutex};
+        auto found = index.find(name);
+        if (found != index.end()) return found->second;
+        names.emplace_back(name);
+        // id 0 is the empty symbol, so ids are offset by one
+        auto id = std::uint32_t(names.size());
+        index.emplace(names.back(), id);
+        return id;
+      }
+
+      std::uint32_t find(std::string_view name)
+      {
+        if (name.empty()) return 0;
+        std::unique_lock lock{mutex};
+        auto found = index.find(name);
+        return found == index.end() ? 0 : found->second;
+      }
+
+      const std::string* name_of(std::uint32_t id)
+      {
+        if (id == 0) return nullptr;
+        std::unique_lock lock{mutex};
+        return &names[id - 1];
+      }
+    };
+
+  } // namespace
+
+  Symbol::Symbol(string_ref name) noexcept : id_(InternTable::instance().intern(name)) {}
+
+  Symbol Symbol::lookup(std::string_view name) noexcept
+  {
+    return Symbol{InternTable::instance().find(name)};
+  }
+
+  string_ref Symbol::name() const noexcept
+  {
+    auto* str = InternTable::instance().name_of(id_);
+    return str ? string_ref(*str) : string_ref();
+  }
+
+} // namespace otto::util
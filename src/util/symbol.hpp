@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "util/string_ref.hpp"
+
+namespace otto::util {
+
+  /// An interned string identifier.
+  ///
+  /// A name is registered once into a global table - typically at startup,
+  /// when engines and state clients announce themselves - and every `Symbol`
+  /// over the same name holds the same 32-bit id. From then on comparisons,
+  /// and map lookups keyed on symbols, are integer compares instead of string
+  /// hashing, and {@ref name} gives the string back for display.
+  ///
+  /// Interned names are never freed, so the returned `string_ref`s stay valid
+  /// for the lifetime of the program. Don't intern unbounded user input - for
+  /// names that may not be registered, query with {@ref lookup}.
+  struct Symbol {
+    /// The empty symbol. Compares equal only to itself, and to `Symbol("")`
+    constexpr Symbol() noexcept = default;
+
+    /// Intern `name`. The first caller registers it; later calls with the same
+    /// name are a lookup and yield an identical symbol
+    Symbol(string_ref name) noexcept;
+    Symbol(const std::string& name) noexcept : Symbol(string_ref(name)) {}
+    Symbol(const char* name) noexcept : Symbol(string_ref(name)) {}
+
+    /// Find an already-interned name without registering it.
+    ///
+    /// Returns the empty symbol if `name` was never interned. Queries for
+    /// names that may not exist - preset lookups, sections read from disk -
+    /// should use this, so junk never grows the table
+    static Symbol lookup(std::string_view name) noexcept;
+
+    constexpr std::uint32_t id() const noexcept
+    {
+      return id_;
+    }
+
+    /// The interned name. The empty symbol yields ""
+    string_ref name() const noexcept;
+
+    const char* c_str() const noexcept
+    {
+      return name().c_str();
+    }
+
+    explicit constexpr operator bool() const noexcept
+    {
+      return id_ != 0;
+    }
+
+  private:
+    explicit constexpr Symbol(std::uint32_t id) noexcept : id_(id) {}
+
+    std::uint32_t id_ = 0;
+  };
+
+  constexpr bool operator==(Symbol a, Symbol b) noexcept
+  {
+    return a.id() == b.id();
+  }
+  constexpr bool operator!=(Symbol a, Symbol b) noexcept
+  {
+    return a.id() != b.id();
+  }
+  /// Orders by id, i.e. by registration order - not alphabetically
+  constexpr bool operator<(Symbol a, Symbol b) noexcept
+  {
+    return a.id() < b.id();
+  }
+  constexpr bool operator<=(Symbol a, Symbol b) noexcept
+  {
+    return a.id() <= b.id();
+  }
+  constexpr bool operator>(Symbol a, Symbol b) noexcept
+  {
+    return a.id() > b.id();
+  }
+  constexpr bool operator>=(Symbol a, Symbol b) noexcept
+  {
+    return a.id() >= b.id();
+  }
+
+} // namespace otto::util
+
+namespace std {
+  template<>
+  struct hash<otto::util::Symbol> {
+    std::size_t operator()(otto::util::Symbol s) const noexcept
+    {
+      return s.id();
+    }
+  };
+} // namespace std
@@ -0,0 +1,71 @@
+#include "thread.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "services/log_manager.hpp"
+
+namespace otto::util::scheduling {
+
+  namespace {
+    /// Written once from main() before any threads start, read at every thread
+    /// creation after that
+    Config global_config = {};
+
+    const Config::BandConfig& band_config(Band band) noexcept
+    {
+      switch (band) {
+        case Band::audio: return global_config.audio;
+        case Band::ui: return global_config.ui;
+        case Band::worker: return global_config.worker;
+      }
+      return global_config.worker;
+    }
+  } // namespace
+
+  void set_config(const Config& config) noexcept
+  {
+    global_config = config;
+  }
+
+  const Config& config() noexcept
+  {
+    return global_config;
+  }
+
+  void apply(Band band) noexcept
+  {
+    const auto& bc = band_config(band);
+    if (bc.fifo_priority > 0) {
+      struct sched_param param = {};
+      param.sched_priority = bc.fifo_priority;
+      if (int err = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param); err != 0) {
+        LOGE("Could not set SCHED_FIFO priority {}: {}. Raise the rtprio rlimit",
+             bc.fifo_priority, std::strerror(err));
+      }
+    }
+    if (bc.cpu_mask != 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int cpu = 0; cpu < 64; cpu++) {
+        if (bc.cpu_mask & (std::uint64_t(1) << cpu)) CPU_SET(cpu, &set);
+      }
+      if (::sched_setaffinity(0, sizeof(set), &set) != 0) {
+        LOGE("Could not set cpu affinity {:#x}: {}", bc.cpu_mask, std::strerror(errno));
+      }
+    }
+  }
+
+  int worker_cpu() noexcept
+  {
+    const auto mask = global_config.worker.cpu_mask;
+    for (int cpu = 0; cpu < 64; cpu++) {
+      if (mask & (std::uint64_t(1) << cpu)) return cpu;
+    }
+    return -1;
+  }
+
+} // namespace otto::util::scheduling
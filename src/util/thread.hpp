@@ -2,9 +2,11 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <thread>
+#include <type_traits>
 
 #include <chrono>
 #include <ctime>
@@ -38,9 +40,61 @@ namespace otto::chrono {
 
 namespace otto::util {
 
+  /// Per-board thread scheduling configuration.
+  ///
+  /// Boards install a {@ref Config} from `main()` before the services start any
+  /// threads, and every thread created through the wrappers in this file applies
+  /// the band it belongs to: SCHED_FIFO priority and a core affinity mask. The
+  /// audio drivers apply {@ref Band::audio} from their callback thread, which
+  /// keeps ui, logic and worker threads off the audio core. The default config
+  /// leaves scheduling entirely to the kernel.
+  namespace scheduling {
+
+    /// The scheduling band a thread belongs to
+    enum struct Band { audio, ui, worker };
+
+    struct Config {
+      struct BandConfig {
+        /// SCHED_FIFO priority. 0 keeps the default policy
+        int fifo_priority = 0;
+        /// Bitmask of allowed cores. 0 means no affinity
+        std::uint64_t cpu_mask = 0;
+      };
+      BandConfig audio;
+      BandConfig ui;
+      BandConfig worker;
+    };
+
+    /// Install the board's config
+    void set_config(const Config&) noexcept;
+
+    /// The installed config
+    const Config& config() noexcept;
+
+    /// Apply the config for `band` to the calling thread. Failures (missing
+    /// rtprio rlimit) are logged and otherwise ignored
+    void apply(Band) noexcept;
+
+    /// The first core in the worker band's mask, or -1 when unset. For
+    /// {@ref audio_worker}, which pins to a single core
+    int worker_cpu() noexcept;
+
+  } // namespace scheduling
+
   struct thread {
     template<typename Func>
-    thread(Func&& func) : std_thread(std::forward<Func>(func), [this] { return should_run(); })
+    thread(scheduling::Band band, Func&& func)
+      : std_thread(
+          [band](auto func, auto should_run) {
+            scheduling::apply(band);
+            func(std::move(should_run));
+          },
+          std::forward<Func>(func), [this] { return should_run(); })
+    {}
+
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, scheduling::Band>>>
+    thread(Func&& func) : thread(scheduling::Band::worker, std::forward<Func>(func))
     {}
 
     ~thread()
@@ -66,8 +120,18 @@ namespace otto::util {
 
   struct triggered_thread {
     template<typename Func>
-    triggered_thread(Func&& func)
-      : std_thread(std::forward<Func>(func), [this] { return should_run(); })
+    triggered_thread(scheduling::Band band, Func&& func)
+      : std_thread(
+          [band](auto func, auto should_run) {
+            scheduling::apply(band);
+            func(std::move(should_run));
+          },
+          std::forward<Func>(func), [this] { return should_run(); })
+    {}
+
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, scheduling::Band>>>
+    triggered_thread(Func&& func) : triggered_thread(scheduling::Band::worker, std::forward<Func>(func))
     {}
 
     ~triggered_thread()
@@ -103,8 +167,18 @@ namespace otto::util {
 
   struct sleeper_thread {
     template<typename Func>
-    sleeper_thread(Func&& func)
-      : std_thread(std::forward<Func>(func), [this] { return should_run(); })
+    sleeper_thread(scheduling::Band band, Func&& func)
+      : std_thread(
+          [band](auto func, auto should_run) {
+            scheduling::apply(band);
+            func(std::move(should_run));
+          },
+          std::forward<Func>(func), [this] { return should_run(); })
+    {}
+
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, scheduling::Band>>>
+    sleeper_thread(Func&& func) : sleeper_thread(scheduling::Band::worker, std::forward<Func>(func))
     {}
 
     ~sleeper_thread()
@@ -0,0 +1,113 @@
+#include "tracing.hpp"
+
+#if OTTO_ENABLE_TRACING
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include "services/log_manager.hpp"
+
+namespace otto::util::tracing {
+
+  namespace {
+
+    struct event {
+      const char* name;
+      std::uint64_t begin_ns;
+      std::uint64_t end_ns;
+    };
+
+    /// One ring per thread. Overwrites the oldest events when full, so a
+    /// trace always holds the most recent history. The writing thread only
+    /// touches its own ring; {@ref write_json} reads all of them - a torn
+    /// event read during an active burst is skipped by the end < begin check.
+    struct thread_ring {
+      static constexpr std::size_t capacity = 1 << 14;
+
+      std::array<event, capacity> events = {};
+      std::atomic<std::uint64_t> head = 0;
+      int tid;
+
+      void push(const event& e) noexcept
+      {
+        const auto h = head.load(std::memory_order_relaxed);
+        events[h % capacity] = e;
+        head.store(h + 1, std::memory_order_release);
+      }
+    };
+
+    std::mutex g_registry_mutex;
+    std::vector<thread_ring*> g_registry;
+
+    void write_json_at_exit()
+    {
+      const char* path = std::getenv("OTTO_TRACE_FILE");
+      write_json(path != nullptr ? path : "otto-trace.json");
+    }
+
+    /// The calling thread's ring. Heap allocated and intentionally leaked -
+    /// the registry keeps reading it after the thread is gone, and the
+    /// trace is written from an exit handler
+    thread_ring& ring() noexcept
+    {
+      static thread_local thread_ring* instance = [] {
+        auto* r = new thread_ring();
+        std::lock_guard lock{g_registry_mutex};
+        r->tid = int(g_registry.size());
+        if (g_registry.empty()) std::atexit(write_json_at_exit);
+        g_registry.push_back(r);
+        return r;
+      }();
+      return *instance;
+    }
+
+  } // namespace
+
+  std::uint64_t now_ns() noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+  }
+
+  void record(const char* name, std::uint64_t begin_ns, std::uint64_t end_ns) noexcept
+  {
+    ring().push({name, begin_ns, end_ns});
+  }
+
+  void write_json(const char* path)
+  {
+    std::FILE* file = std::fopen(path, "w");
+    if (file == nullptr) {
+      LOGE("Could not open trace file {}", path);
+      return;
+    }
+    std::fputs("[", file);
+    bool first = true;
+    std::lock_guard lock{g_registry_mutex};
+    for (auto* ring : g_registry) {
+      const auto head = ring->head.load(std::memory_order_acquire);
+      const auto count = std::min<std::uint64_t>(head, thread_ring::capacity);
+      for (std::uint64_t i = head - count; i < head; i++) {
+        const event e = ring->events[i % thread_ring::capacity];
+        if (e.name == nullptr || e.end_ns < e.begin_ns) continue;
+        std::fprintf(file,
+                     "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                     first ? "" : ",", e.name, ring->tid, e.begin_ns / 1000.0,
+                     (e.end_ns - e.begin_ns) / 1000.0);
+        first = false;
+      }
+    }
+    std::fputs("\n]\n", file);
+    std::fclose(file);
+    LOGI("Wrote trace to {}", path);
+  }
+
+} // namespace otto::util::tracing
+
+#endif
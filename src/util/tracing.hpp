@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+/// Compile-time-zoned tracing.
+///
+/// `OTTO_TRACE_SCOPE("name")` opens a named zone for the rest of the
+/// enclosing scope. With `OTTO_ENABLE_TRACING` off (the default), the macro
+/// expands to nothing. With it on, each zone pushes one event into a
+/// per-thread lock-free ring on close, and the rings are written to a Trace
+/// Event Format JSON file on exit - loadable in chrome://tracing or
+/// Perfetto. The file path defaults to `otto-trace.json` and can be
+/// overridden with the `OTTO_TRACE_FILE` environment variable.
+///
+/// Zone names must be string literals (or otherwise outlive the program) -
+/// only the pointer is stored.
+
+#if OTTO_ENABLE_TRACING
+
+namespace otto::util::tracing {
+
+  /// Nanoseconds on the steady clock
+  std::uint64_t now_ns() noexcept;
+
+  /// Push a finished zone into the calling thread's ring
+  void record(const char* name, std::uint64_t begin_ns, std::uint64_t end_ns) noexcept;
+
+  /// Write all rings to `path` in Trace Event Format.
+  ///
+  /// Installed as an exit handler on first use, but can also be called
+  /// manually mid-run. Events still being written may be skipped
+  void write_json(const char* path);
+
+  struct zone {
+    zone(const char* name) noexcept : name_(name), begin_(now_ns()) {}
+    ~zone() noexcept
+    {
+      record(name_, begin_, now_ns());
+    }
+
+    zone(const zone&) = delete;
+    zone& operator=(const zone&) = delete;
+
+  private:
+    const char* name_;
+    std::uint64_t begin_;
+  };
+
+} // namespace otto::util::tracing
+
+#define OTTO_TRACE_CONCAT_IMPL(a, b) a##b
+#define OTTO_TRACE_CONCAT(a, b) OTTO_TRACE_CONCAT_IMPL(a, b)
+#define OTTO_TRACE_SCOPE(name) \
+  ::otto::util::tracing::zone OTTO_TRACE_CONCAT(_otto_trace_zone_, __LINE__) { name }
+
+#else
+
+#define OTTO_TRACE_SCOPE(name) ((void) 0)
+
+#endif
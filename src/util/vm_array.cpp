@@ -0,0 +1,38 @@
+#include "vm_array.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace otto::util::vm_detail {
+
+  void* reserve(std::size_t bytes) noexcept
+  {
+    // PROT_NONE + NORESERVE: pure address space, no physical memory and no
+    // charge against overcommit until pages are committed
+    void* res = ::mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return res == MAP_FAILED ? nullptr : res;
+  }
+
+  bool commit(void* base, std::size_t bytes) noexcept
+  {
+    return ::mprotect(base, bytes, PROT_READ | PROT_WRITE) == 0;
+  }
+
+  void decommit(void* base, std::size_t bytes) noexcept
+  {
+    ::madvise(base, bytes, MADV_DONTNEED);
+    ::mprotect(base, bytes, PROT_NONE);
+  }
+
+  void unreserve(void* base, std::size_t bytes) noexcept
+  {
+    ::munmap(base, bytes);
+  }
+
+  std::size_t page_size() noexcept
+  {
+    static const std::size_t page = ::sysconf(_SC_PAGESIZE);
+    return page;
+  }
+
+} // namespace otto::util::vm_detail
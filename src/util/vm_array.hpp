@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace otto::util {
+
+  namespace vm_detail {
+    /// Reserve `bytes` of address space with no access and no physical backing
+    void* reserve(std::size_t bytes) noexcept;
+    /// Make `[base, base + bytes)` of a reservation readable and writable.
+    /// Physical pages still arrive lazily, zero-filled, on first touch
+    bool commit(void* base, std::size_t bytes) noexcept;
+    /// Return the physical pages behind `[base, base + bytes)` to the kernel
+    /// and re-protect. The range reads as zero after the next commit
+    void decommit(void* base, std::size_t bytes) noexcept;
+    /// Release the whole reservation
+    void unreserve(void* base, std::size_t bytes) noexcept;
+
+    std::size_t page_size() noexcept;
+  } // namespace vm_detail
+
+  /// A growable array over reserved virtual address space.
+  ///
+  /// The full capacity is reserved up front as inaccessible address space -
+  /// free on a 64-bit kernel - and pages are committed on demand as the array
+  /// grows. Growth is a protection change on the new pages, never a
+  /// reallocate-and-copy, so the data pointer is stable for the lifetime of
+  /// the array and growing a recording buffer mid-performance costs no memcpy
+  /// spike. {@ref decommit} hands the physical pages back, so a dropped
+  /// recording stops counting against residency.
+  ///
+  /// Elements are zero-filled by the kernel when their page is first touched.
+  /// Only the first {@ref committed} elements may be accessed.
+  template<typename T>
+  struct vm_array {
+    static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                  "vm_array: elements live in kernel-zeroed pages and are never constructed or destroyed");
+
+    explicit vm_array(std::size_t capacity) noexcept
+      : capacity_(capacity), base_(static_cast<T*>(vm_detail::reserve(capacity * sizeof(T))))
+    {}
+
+    vm_array(const vm_array&) = delete;
+
+    ~vm_array() noexcept
+    {
+      if (base_ != nullptr) vm_detail::unreserve(base_, capacity_ * sizeof(T));
+    }
+
+    /// Make at least the first `n` elements accessible. Commits in large steps
+    /// so repeated small growth does one syscall per megabyte, not per call
+    bool commit(std::size_t n) noexcept
+    {
+      if (n <= committed_) return true;
+      if (n > capacity_ || base_ == nullptr) return false;
+      // Round the new frontier up to the commit chunk, clamped to capacity
+      constexpr std::size_t chunk = (1 << 20) / sizeof(T);
+      std::size_t target = ((n + chunk - 1) / chunk) * chunk;
+      if (target > capacity_) target = capacity_;
+      const auto page = vm_detail::page_size();
+      const auto lo = (committed_ * sizeof(T) / page) * page;
+      const auto hi = ((target * sizeof(T) + page - 1) / page) * page;
+      if (!vm_detail::commit(reinterpret_cast<char*>(base_) + lo, hi - lo)) return false;
+      committed_ = target;
+      return true;
+    }
+
+    /// Return all physical pages to the kernel. The array reads as zero after
+    /// the next {@ref commit}
+    void decommit() noexcept
+    {
+      if (committed_ == 0 || base_ == nullptr) return;
+      const auto page = vm_detail::page_size();
+      const auto hi = ((committed_ * sizeof(T) + page - 1) / page) * page;
+      vm_detail::decommit(base_, hi);
+      committed_ = 0;
+    }
+
+    T* data() noexcept { return base_; }
+    const T* data() const noexcept { return base_; }
+
+    T& operator[](std::size_t i) noexcept { return base_[i]; }
+    const T& operator[](std::size_t i) const noexcept { return base_[i]; }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    /// Number of accessible elements
+    std::size_t committed() const noexcept { return committed_; }
+
+  private:
+    std::size_t capacity_;
+    std::size_t committed_ = 0;
+    T* base_;
+  };
+
+} // namespace otto::util
@@ -0,0 +1,85 @@
+#include "wav_writer.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace otto::util {
+
+  namespace {
+    /// 32-bit float WAV header. Written with placeholder sizes on open,
+    /// patched in place on close.
+    struct WavHeader {
+      char riff[4] = {'R', 'I', 'F', 'F'};
+      std::uint32_t riff_size = 0;
+      char wave[4] = {'W', 'A', 'V', 'E'};
+      char fmt[4] = {'f', 'm', 't', ' '};
+      std::uint32_t fmt_size = 16;
+      std::uint16_t format = 3; // IEEE float
+      std::uint16_t channels = 2;
+      std::uint32_t samplerate = 48000;
+      std::uint32_t byte_rate = 48000 * 2 * sizeof(float);
+      std::uint16_t block_align = 2 * sizeof(float);
+      std::uint16_t bits = 32;
+      char fact[4] = {'f', 'a', 'c', 't'};
+      std::uint32_t fact_size = 4;
+      std::uint32_t frames = 0;
+      char data[4] = {'d', 'a', 't', 'a'};
+      std::uint32_t data_size = 0;
+    };
+    static_assert(sizeof(WavHeader) == 56, "WavHeader must be naturally packed");
+
+    WavHeader make_header(int samplerate, int channels) noexcept
+    {
+      WavHeader header;
+      header.samplerate = samplerate;
+      header.channels = channels;
+      header.block_align = channels * sizeof(float);
+      header.byte_rate = samplerate * channels * sizeof(float);
+      return header;
+    }
+  } // namespace
+
+  bool WavWriter::open(const fs::path& path, int samplerate, int channels)
+  {
+    close();
+    fd_ = ::open(path.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+    auto header = make_header(samplerate, channels);
+    if (::write(fd_, &header, sizeof(header)) != sizeof(header)) {
+      ::close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    samplerate_ = samplerate;
+    channels_ = channels;
+    data_bytes_ = 0;
+    return true;
+  }
+
+  bool WavWriter::write(const float* interleaved, std::size_t count) noexcept
+  {
+    const auto bytes = count * sizeof(float);
+    if (::write(fd_, interleaved, bytes) != ssize_t(bytes)) return false;
+    data_bytes_ += bytes;
+    return true;
+  }
+
+  void WavWriter::sync() noexcept
+  {
+    if (fd_ >= 0) ::fdatasync(fd_);
+  }
+
+  void WavWriter::close() noexcept
+  {
+    if (fd_ < 0) return;
+    auto header = make_header(samplerate_, channels_);
+    header.data_size = std::uint32_t(data_bytes_);
+    header.frames = std::uint32_t(data_bytes_ / (channels_ * sizeof(float)));
+    header.riff_size = std::uint32_t(sizeof(WavHeader) - 8 + data_bytes_);
+    ::pwrite(fd_, &header, sizeof(header), 0);
+    ::fdatasync(fd_);
+    ::close(fd_);
+    fd_ = -1;
+  }
+
+} // namespace otto::util
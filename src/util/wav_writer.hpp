@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "util/filesystem.hpp"
+
+namespace otto::util {
+
+  /// Writes a 32-bit float WAV file incrementally.
+  ///
+  /// The header is written with placeholder sizes on {@ref open} and patched in
+  /// place on {@ref close}, so everything in between is strictly sequential
+  /// appends. Both the disk recorder and the offline bounce go through this.
+  struct WavWriter {
+    WavWriter() = default;
+    WavWriter(const WavWriter&) = delete;
+    ~WavWriter() noexcept { close(); }
+
+    /// Open `path`, truncating it, and write the header
+    bool open(const fs::path& path, int samplerate, int channels);
+    /// Append `count` floats of interleaved sample data
+    bool write(const float* interleaved, std::size_t count) noexcept;
+    /// Flush the sample data to disk. The header is only synced on {@ref close}
+    void sync() noexcept;
+    /// Patch the header sizes, sync and close. No-op when not open
+    void close() noexcept;
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+    /// Bytes of sample data written so far
+    std::uint64_t data_bytes() const noexcept { return data_bytes_; }
+
+  private:
+    int fd_ = -1;
+    int samplerate_ = 0;
+    int channels_ = 0;
+    std::uint64_t data_bytes_ = 0;
+  };
+
+} // namespace otto::util
@@ -0,0 +1,162 @@
+#include "wavetable_set.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace otto::util {
+
+  namespace {
+    /// Header of the set format, written by `scripts/compile-wavetables.py`.
+    /// Followed by `tables` entries, followed directly by the payload floats.
+    struct SetHeader {
+      static constexpr std::uint32_t magic_value = 0x4F545754; // "OTWT"
+      static constexpr std::uint32_t version_value = 1;
+      std::uint32_t magic = magic_value;
+      std::uint32_t version = version_value;
+      std::uint32_t tables = 0;
+      std::uint32_t mip_count = 0;
+      std::uint32_t base_size = 0;
+      std::uint32_t reserved = 0;
+    };
+
+    struct SetEntry {
+      char name[56] = {};
+      /// First frame of level 0 in the payload. The further levels follow
+      /// contiguously, each half the size of the previous
+      std::uint32_t offset = 0;
+      std::uint32_t reserved = 0;
+    };
+    static_assert(sizeof(SetEntry) == 64);
+
+    /// More tables than any set ships - a larger count means a corrupt index
+    constexpr std::uint32_t max_tables = 256;
+
+    /// Frames in one table across all levels
+    std::uint32_t frames_per_table(std::uint32_t base_size, int mip_count)
+    {
+      std::uint32_t frames = 0;
+      for (int m = 0; m < mip_count; m++) frames += base_size >> m;
+      return frames;
+    }
+  } // namespace
+
+  WavetableSet::WavetableSet(WavetableSet&& rhs) noexcept
+    : _map_base(rhs._map_base),
+      _map_length(rhs._map_length),
+      _base_size(rhs._base_size),
+      _mip_count(rhs._mip_count),
+      _entries(std::move(rhs._entries))
+  {
+    rhs._map_base = nullptr;
+    rhs._map_length = 0;
+    rhs._entries.clear();
+  }
+
+  WavetableSet& WavetableSet::operator=(WavetableSet&& rhs) noexcept
+  {
+    unmap();
+    _map_base = rhs._map_base;
+    _map_length = rhs._map_length;
+    _base_size = rhs._base_size;
+    _mip_count = rhs._mip_count;
+    _entries = std::move(rhs._entries);
+    rhs._map_base = nullptr;
+    rhs._map_length = 0;
+    rhs._entries.clear();
+    return *this;
+  }
+
+  WavetableSet::~WavetableSet() noexcept
+  {
+    unmap();
+  }
+
+  void WavetableSet::unmap() noexcept
+  {
+    if (_map_base != nullptr) {
+      ::munmap(_map_base, _map_length);
+      _map_base = nullptr;
+      _map_length = 0;
+    }
+    _base_size = 0;
+    _mip_count = 0;
+    _entries.clear();
+  }
+
+  bool WavetableSet::load(const fs::path& set_file)
+  {
+    int fd = ::open(set_file.string().c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(SetHeader)) {
+      ::close(fd);
+      return false;
+    }
+    auto length = std::size_t(st.st_size);
+    // Private mapping - the data is handed out through non-const pointers for
+    // gam::Array::source, and copy-on-write keeps any stray store away from
+    // the file
+    void* map = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    SetHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    auto fail = [&] {
+      ::munmap(map, length);
+      return false;
+    };
+    if (header.magic != SetHeader::magic_value || header.version != SetHeader::version_value ||
+        header.tables > max_tables || header.mip_count == 0 || header.mip_count > max_mips ||
+        header.base_size == 0 || (header.base_size & (header.base_size - 1)) != 0 ||
+        (header.base_size >> (header.mip_count - 1)) == 0) {
+      return fail();
+    }
+    auto index_size = sizeof(SetHeader) + header.tables * sizeof(SetEntry);
+    if (length < index_size) return fail();
+    auto* payload = reinterpret_cast<float*>(static_cast<char*>(map) + index_size);
+    auto payload_frames = (length - index_size) / sizeof(float);
+    auto table_frames = frames_per_table(header.base_size, int(header.mip_count));
+
+    std::vector<Entry> entries;
+    entries.reserve(header.tables);
+    for (std::uint32_t i = 0; i < header.tables; i++) {
+      SetEntry raw;
+      std::memcpy(&raw, static_cast<const char*>(map) + sizeof(SetHeader) + i * sizeof(raw),
+                  sizeof(raw));
+      if (raw.offset > payload_frames || table_frames > payload_frames - raw.offset) return fail();
+      Entry entry;
+      entry.name = std::string(raw.name, ::strnlen(raw.name, sizeof(raw.name)));
+      entry.data = payload + raw.offset;
+      entries.push_back(std::move(entry));
+    }
+
+    unmap();
+    _map_base = map;
+    _map_length = length;
+    _base_size = header.base_size;
+    _mip_count = int(header.mip_count);
+    _entries = std::move(entries);
+    return true;
+  }
+
+  float* WavetableSet::mip(int table, int level) const noexcept
+  {
+    std::uint32_t offset = 0;
+    for (int m = 0; m < level; m++) offset += _base_size >> m;
+    return _entries[table].data + offset;
+  }
+
+  int WavetableSet::find(std::string_view name) const noexcept
+  {
+    for (int i = 0; i < int(_entries.size()); i++) {
+      if (_entries[i].name == name) return i;
+    }
+    return -1;
+  }
+
+} // namespace otto::util
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/filesystem.hpp"
+
+namespace otto::util {
+
+  /// A packed set of band-limited wavetable mipmaps, memory-mapped from a
+  /// single file.
+  ///
+  /// Every table is stored as a series of per-octave mip levels - level `m`
+  /// holds `base_size() >> m` frames with the harmonics above its Nyquist
+  /// removed - so a player can read the level matching the note instead of
+  /// aliasing a full-resolution table. The file is produced offline by
+  /// `scripts/compile-wavetables.py`; at runtime the whole set loads with one
+  /// open + mmap and the level data can be handed directly to
+  /// `gam::Array::source`.
+  struct WavetableSet {
+    /// Upper bound on levels per table - a larger count in the header means a
+    /// corrupt file
+    static constexpr int max_mips = 8;
+
+    WavetableSet() = default;
+    WavetableSet(const WavetableSet&) = delete;
+    WavetableSet(WavetableSet&&) noexcept;
+    WavetableSet& operator=(WavetableSet&&) noexcept;
+    ~WavetableSet() noexcept;
+
+    /// Map `set_file` and parse its index.
+    ///
+    /// \returns `true` on success. On failure the previous mapping (if any) is
+    /// kept.
+    bool load(const fs::path& set_file);
+
+    /// Release the mapping. Invalidates the data pointers of all tables
+    void unmap() noexcept;
+
+    int tables() const noexcept { return int(_entries.size()); }
+    int mip_count() const noexcept { return _mip_count; }
+
+    /// Frames in every table's level `level`
+    std::uint32_t mip_size(int level) const noexcept { return _base_size >> level; }
+
+    /// \preconditions `0 <= table < tables()`
+    const std::string& name(int table) const noexcept { return _entries[table].name; }
+
+    /// Level `level` of table `table`, `mip_size(level)` frames. Valid until
+    /// the set is unmapped.
+    ///
+    /// \preconditions `0 <= table < tables()` and `0 <= level < mip_count()`
+    float* mip(int table, int level) const noexcept;
+
+    /// \returns the index of the table named `name`, or `-1`
+    int find(std::string_view name) const noexcept;
+
+    explicit operator bool() const noexcept { return _map_base != nullptr; }
+
+  private:
+    struct Entry {
+      std::string name;
+      /// Level 0 - the levels of one table are contiguous
+      float* data = nullptr;
+    };
+
+    void* _map_base = nullptr;
+    std::size_t _map_length = 0;
+    std::uint32_t _base_size = 0;
+    int _mip_count = 0;
+    std::vector<Entry> _entries;
+  };
+
+} // namespace otto::util
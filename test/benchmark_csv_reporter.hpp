@@ -2,11 +2,39 @@
 
 //#include "testing.t.hpp"
 
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
 namespace Catch {
 
+  /// Number of benchmarks that regressed beyond the threshold compared to the baseline
+  /// file. Picked up by main() to fail the run.
+  inline int benchmark_regressions = 0;
+
   struct BenchmarkCSVReporter : StreamingReporterBase<BenchmarkCSVReporter> {
     BenchmarkCSVReporter(ReporterConfig const& _config) : StreamingReporterBase(_config) {
       stream << "Name, Iterations, Mean (ns), StdDev (ns)\n";
+      // Baseline comparison mode: OTTO_BENCHMARK_BASELINE points to a csv written by a
+      // previous run. Results more than OTTO_BENCHMARK_THRESHOLD (default 0.1 = 10%)
+      // slower than their baseline count as regressions.
+      if (const char* path = std::getenv("OTTO_BENCHMARK_BASELINE")) {
+        if (const char* thrs = std::getenv("OTTO_BENCHMARK_THRESHOLD")) threshold = std::atof(thrs);
+        std::ifstream file{path};
+        std::string line;
+        std::getline(file, line); // header
+        while (std::getline(file, line)) {
+          auto name_end = line.rfind('"');
+          if (name_end == std::string::npos || name_end < 1) continue;
+          auto name = line.substr(1, name_end - 1);
+          std::istringstream rest{line.substr(name_end + 1)};
+          char comma;
+          long iterations;
+          double mean;
+          if (rest >> comma >> iterations >> comma >> mean) baseline[name] = mean;
+        }
+      }
     }
 
     static std::string getDescription()
@@ -31,11 +59,22 @@ namespace Catch {
     void benchmarkEnded(BenchmarkStats<> const& stats) override
     {
       stream << fmt::format("\"{}\", {}, {}, {}\n", stats.info.name, stats.info.iterations, stats.mean.point.count(), stats.standardDeviation.point.count());
+      auto found = baseline.find(stats.info.name);
+      if (found != baseline.end() && stats.mean.point.count() > found->second * (1.0 + threshold)) {
+        benchmark_regressions++;
+        Catch::cerr() << fmt::format("REGRESSION: \"{}\": {:.0f} ns, baseline {:.0f} ns (+{:.1f}%)\n",
+                                     stats.info.name, stats.mean.point.count(), found->second,
+                                     (stats.mean.point.count() / found->second - 1.0) * 100.0);
+      }
     }
     void benchmarkFailed(std::string const& str) override
     {
       //stream << "Failed " << str;
     }
+
+  private:
+    std::unordered_map<std::string, double> baseline;
+    double threshold = 0.1;
   };
 
   CATCH_REGISTER_REPORTER("benchmarks.csv", BenchmarkCSVReporter);
@@ -2,9 +2,16 @@
 
 #include "dummy_services.hpp"
 
+#include "util/allocation_tracker.hpp"
+
 #include "engines/fx/chorus/chorus.hpp"
 #include "engines/fx/wormhole/wormhole.hpp"
+#include "engines/seq/arp/arp.hpp"
+#include "engines/seq/euclid/euclid.hpp"
 #include "engines/synths/OTTOFM/ottofm.hpp"
+#include "engines/synths/goss/goss.hpp"
+#include "engines/synths/potion/potion.hpp"
+#include "engines/synths/rhodes/rhodes.hpp"
 
 namespace otto::services::test {
 
@@ -38,6 +45,16 @@ namespace otto::services::test {
         meter.measure([&] { DummyAudioManager::current().process(); });
       };
     }
+
+    SECTION ("AudioManager::process() does not allocate") {
+      DummyAudioManager::current().set_bs_sr(256, 44100);
+      // Warm up - lazy first-use allocations (buffer pool growth etc.) are fine
+      for (int i = 0; i < 4; i++) DummyAudioManager::current().process();
+      util::allocation_tracker::scope scope{true, true};
+      for (int i = 0; i < 16; i++) DummyAudioManager::current().process();
+      if (scope.allocations() > 0) util::allocation_tracker::log_first_offender();
+      REQUIRE(scope.allocations() == 0);
+    }
   }
 
   template<typename Engine>
@@ -81,6 +98,102 @@ namespace otto::services::test {
     }
   }
 
+  /// Benchmark an fx engine processing silence after its tail has decayed away.
+  ///
+  /// An impulse is sent in first, then enough unmeasured silent blocks for the
+  /// tail to decay into denormal range. Without flush-to-zero the measured
+  /// silent blocks then run on denormal feedback state, which on x86 traps
+  /// every multiply to microcode - the "CPU spike near silence". With the
+  /// audio threads in FTZ/DAZ mode this should cost the same as
+  /// {@ref benchmark_fx} on a live signal; a regression here means the mode
+  /// got lost somewhere.
+  template<typename Engine>
+  void benchmark_fx_denormal_tail()
+  {
+    SECTION (std::string(Engine::name) + " denormal tail") {
+      DummyAudioManager::current().set_bs_sr(256, 44100);
+      Engine engine;
+      auto buf = AudioManager::current().buffer_pool().allocate_clear();
+      buf.data()[0] = 1.f;
+      engine.process({buf});
+      // ~3 s of silence - long enough for the feedback paths to decay below
+      // the smallest normal float
+      for (int i = 0; i < 512; i++) {
+        std::fill(buf.begin(), buf.end(), 0.f);
+        engine.process({buf});
+      }
+      BENCHMARK_ADVANCED(std::string(Engine::name) + "::process denormal tail")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.divisor(buf.size());
+        meter.measure([&] {
+          // The refill is a constant, tiny cost next to the fx processing
+          std::fill(buf.begin(), buf.end(), 0.f);
+          engine.process({buf});
+        });
+      };
+    }
+  }
+
+  /// Benchmark a synth engine in steady state with `notes` held notes.
+  ///
+  /// The note-ons are sent in a first, unmeasured process call, so the measured calls
+  /// see the engine with the voices already playing.
+  template<typename Engine>
+  void benchmark_synth(int notes, std::string name = "")
+  {
+    Engine engine;
+    auto& pool = AudioManager::current().buffer_pool();
+    {
+      core::midi::EventArena midi;
+      for (int i = 0; i < notes; i++) {
+        midi.emplace_back(core::midi::NoteOnEvent{40 + i * 3, 0.8f});
+      }
+      engine.process({pool.allocate_clear(), {midi}}).audio.release();
+    }
+    BENCHMARK_ADVANCED(std::string(Engine::name) + "::process " + name)(Catch::Benchmark::Chronometer meter)
+    {
+      auto buf = pool.allocate_clear();
+      meter.divisor(buf.size());
+      meter.measure([&] { engine.process({buf}).audio.release(); });
+    };
+  }
+
+  template<typename Engine>
+  void benchmark_synth_pr_voices()
+  {
+    SECTION (std::string(Engine::name) + " at different voice counts") {
+      DummyAudioManager::current().set_bs_sr(256, 44100);
+      benchmark_synth<Engine>(1, "notes = 1");
+      benchmark_synth<Engine>(3, "notes = 3");
+      benchmark_synth<Engine>(6, "notes = 6");
+    }
+    SECTION (std::string(Engine::name) + " at different buffer sizes") {
+      DummyAudioManager::current().set_bs_sr(64, 44100);
+      benchmark_synth<Engine>(3, "buffer_size = 64");
+      DummyAudioManager::current().set_bs_sr(256, 44100);
+      benchmark_synth<Engine>(3, "buffer_size = 256");
+      DummyAudioManager::current().set_bs_sr(1024, 44100);
+      benchmark_synth<Engine>(3, "buffer_size = 1024");
+    }
+  }
+
+  /// Benchmark an arpeggiator engine. Midi-only, so measured per call, not per sample.
+  template<typename Engine>
+  void benchmark_arp()
+  {
+    SECTION (std::string(Engine::name)) {
+      DummyAudioManager::current().set_bs_sr(256, 44100);
+      Engine engine;
+      core::midi::EventArena midi;
+      midi.emplace_back(core::midi::NoteOnEvent{52, 0.8f});
+      engine.process({{midi}, 256});
+      BENCHMARK_ADVANCED(std::string(Engine::name) + "::process")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.measure([&] { engine.process({{}, 256}); });
+      };
+    }
+  }
+
   TEST_CASE ("Engine benchmarks", "[.benchmarks]") {
     auto app = make_dummy_application();
     app.engine_manager->start();
@@ -90,6 +203,17 @@ namespace otto::services::test {
     benchmark_fx_pr_bs<Wormhole>();
     benchmark_fx_pr_bs<Chorus>();
 
+    benchmark_fx_denormal_tail<Wormhole>();
+    benchmark_fx_denormal_tail<Chorus>();
+
+    benchmark_synth_pr_voices<OTTOFMSynth>();
+    benchmark_synth_pr_voices<GossSynth>();
+    benchmark_synth_pr_voices<RhodesSynth>();
+    benchmark_synth_pr_voices<PotionSynth>();
+
+    benchmark_arp<Arp>();
+    benchmark_arp<Euclid>();
+
     SECTION ("Parameter changes") {}
   }
 } // namespace otto::services::test
@@ -111,6 +111,52 @@ namespace otto::core::props {
     REQUIRE(pp == -10.f);
   }
 
+  TEST_CASE ("Delta serialization", "[props]") {
+    struct Props {
+      Property<float> filter = {0.5f, has_limits::init(0.f, 1.f)};
+      Property<int> octave = {1, has_limits::init(-4, 4)};
+      Property<bool> enable = {false};
+      DECL_REFLECTION(Props, filter, octave, enable);
+    } props;
+
+    SECTION ("Members at their default are omitted") {
+      auto j = util::serialize(props);
+      REQUIRE(j.is_object());
+      REQUIRE(j.empty());
+
+      props.filter = 0.75f;
+      j = util::serialize(props);
+      REQUIRE(j.size() == 1);
+      REQUIRE(j.count("filter") == 1);
+    }
+
+    SECTION ("Omitted members restore their default on load") {
+      props.filter = 0.75f;
+      auto j = util::serialize(props);
+      props.octave = 3;
+      props.enable = true;
+      util::deserialize(props, j);
+      REQUIRE(props.filter == 0.75f);
+      REQUIRE(props.octave == 1);
+      REQUIRE(props.enable == false);
+    }
+
+    SECTION ("Untouched props skip assignment and signals") {
+      props.filter = 0.75f;
+      auto j = util::serialize(props);
+      int signals = 0;
+      props.filter.on_change().connect([&](float) { signals++; });
+      props.octave.on_change().connect([&](int) { signals++; });
+      util::deserialize(props, j);
+      REQUIRE(signals == 0);
+
+      j["filter"] = 0.25f;
+      util::deserialize(props, j);
+      REQUIRE(signals == 1);
+      REQUIRE(props.filter == 0.25f);
+    }
+  }
+
   TEST_CASE ("wrap", "[props]") {
     Property<int, wrap> prop = {0, has_limits::init(-2, 2)};
 
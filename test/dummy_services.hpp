@@ -20,13 +20,37 @@ namespace otto::services::test {
     {
       LOGI("DummyStateManager::save()");
     }
-    void attach(std::string name, Loader load, Saver save) override
+    void save_slot(int idx) override
     {
-      //LOGI("DummyStateManager::attach({})", name);
+      LOGI("DummyStateManager::save_slot()");
     }
-    void detach(std::string name) override
+    void load_slot(int idx) override
     {
-      LOGI("DummyStateManager::detach({})", name);
+      LOGI("DummyStateManager::load_slot()");
+    }
+    void load_autosnap() override
+    {
+      LOGI("DummyStateManager::load_autosnap()");
+    }
+    void ab_capture(util::Symbol name) override
+    {
+      LOGI("DummyStateManager::ab_capture()");
+    }
+    void ab_toggle(util::Symbol name) override
+    {
+      LOGI("DummyStateManager::ab_toggle()");
+    }
+    void mark_dirty(util::Symbol name) override
+    {
+      //LOGI("DummyStateManager::mark_dirty({})", name.c_str());
+    }
+    void attach(util::Symbol name, Loader load, Saver save) override
+    {
+      //LOGI("DummyStateManager::attach({})", name.c_str());
+    }
+    void detach(util::Symbol name) override
+    {
+      LOGI("DummyStateManager::detach({})", name.c_str());
     }
   };
 
@@ -67,6 +91,13 @@ namespace otto::services::test {
     {
       LOGI("DummyPresetManager::create_preset()");
     }
+
+    const nlohmann::json& preset_data(util::string_ref engine_name, int idx) override
+    {
+      LOGI("DummyPresetManager::preset_data()");
+      static nlohmann::json res = nlohmann::json::object();
+      return res;
+    }
   };
 
   struct DummyUIManager final : UIManager {
@@ -97,32 +128,27 @@ namespace otto::services::test {
     core::audio::ProcessData<2> process()
     {
       int nframes = _buffer_size;
-      static int r1 = 0;
       using namespace core::audio;
       _buffer_number++;
       auto running = this->running() && Application::current().running();
       if (!running) {
-        return {{AudioBufferHandle(nullptr, 0, r1), AudioBufferHandle(nullptr, 0, r1)}};
+        return {{AudioBufferHandle::borrowed(nullptr, 0), AudioBufferHandle::borrowed(nullptr, 0)}};
       }
 
       if ((unsigned) nframes > _buffer_size) {
         LOGE("RTAudio requested more frames than expected");
-        return {{AudioBufferHandle(nullptr, 0, r1), AudioBufferHandle(nullptr, 0, r1)}};
+        return {{AudioBufferHandle::borrowed(nullptr, 0), AudioBufferHandle::borrowed(nullptr, 0)}};
       }
 
       midi_bufs.swap();
 
       auto in_buf = Application::current().audio_manager->buffer_pool().allocate_clear();
-      // steal the inner midi buffer
-      auto out = Application::current().engine_manager->process({in_buf, {std::move(midi_bufs.inner())}, core::clock::ClockRange()});
+      auto out = Application::current().engine_manager->process({in_buf, {midi_bufs.inner()}, core::clock::ClockRange()});
 
       // process_audio_output(out);
 
       LOGW_IF(out.nframes != nframes, "Frames went missing!");
 
-      // return the midi buffer
-      midi_bufs.inner() = out.midi.move_vector_out();
-
       return out;
     }
 
@@ -132,6 +158,15 @@ namespace otto::services::test {
       gam::sampleRate(sample_rate);
     }
 
+    /// No stream to bounce here - just resize the pool
+    bool set_buffer_size(int frames) noexcept override
+    {
+      if (frames <= 0) return false;
+      _buffer_size = frames;
+      buffer_pool().set_buffer_size(frames);
+      return true;
+    }
+
     static DummyAudioManager& current()
     {
       return dynamic_cast<DummyAudioManager&>(*Application::current().audio_manager);
@@ -0,0 +1,89 @@
+#include "testing.t.hpp"
+
+#include "dummy_services.hpp"
+
+#ifdef OTTO_BOARD_PARTS_UI_GLFW
+
+#include "board/ui/glfw_ui_manager.hpp"
+
+#include "engines/fx/chorus/chorus.hpp"
+#include "engines/fx/wormhole/wormhole.hpp"
+#include "engines/seq/arp/arp.hpp"
+#include "engines/seq/euclid/euclid.hpp"
+#include "engines/synths/OTTOFM/ottofm.hpp"
+#include "engines/synths/goss/goss.hpp"
+#include "engines/synths/potion/potion.hpp"
+#include "engines/synths/rhodes/rhodes.hpp"
+
+// C APIs. Include last
+#include <GL/gl3w.h>
+#include <GLFW/glfw3.h>
+
+namespace otto::services::test {
+
+  using namespace otto::engines;
+
+  /// Render `screen` through a full `begin_frame`/`draw`/`end_frame` cycle.
+  ///
+  /// `glFinish` is called inside the measured section, so the reported time
+  /// includes the GPU actually executing the frame, not just the command
+  /// submission - that is what matters on the 400MHz target GPU.
+  inline void benchmark_screen(glfw::NVGWindow& window, core::ui::Screen& screen, std::string name)
+  {
+    screen.on_show();
+    BENCHMARK_ADVANCED(name + " screen")(Catch::Benchmark::Chronometer meter)
+    {
+      meter.measure([&] {
+        window.begin_frame();
+        window.canvas().lineWidth(6);
+        window.canvas().lineCap(core::ui::vg::LineCap::ROUND);
+        window.canvas().lineJoin(core::ui::vg::LineJoin::ROUND);
+        screen.draw(window.canvas());
+        window.end_frame();
+        glFinish();
+      });
+    };
+    screen.on_hide();
+  }
+
+  template<typename Engine>
+  void benchmark_engine_screen(glfw::NVGWindow& window)
+  {
+    Engine engine;
+    benchmark_screen(window, engine.screen(), std::string(Engine::name));
+  }
+
+  template<typename Engine>
+  void benchmark_synth_screens(glfw::NVGWindow& window)
+  {
+    Engine engine;
+    benchmark_screen(window, engine.screen(), std::string(Engine::name));
+    benchmark_screen(window, engine.envelope_screen(), std::string(Engine::name) + " envelope");
+    benchmark_screen(window, engine.voices_screen(), std::string(Engine::name) + " voices");
+  }
+
+  TEST_CASE ("UI benchmarks", "[.benchmarks]") {
+    auto app = make_dummy_application();
+    app.audio_manager->start();
+
+    glfw::NVGWindow window = {int(core::ui::vg::width), int(core::ui::vg::height), "UI benchmarks"};
+    core::ui::vg::initUtils(window.canvas());
+    window.make_current();
+    // Uncap the swap so we measure draw cost, not the host vsync
+    glfwSwapInterval(0);
+
+    WARN("Benchmark times are per frame");
+
+    benchmark_engine_screen<Wormhole>(window);
+    benchmark_engine_screen<Chorus>(window);
+    benchmark_engine_screen<Arp>(window);
+    benchmark_engine_screen<Euclid>(window);
+
+    benchmark_synth_screens<OTTOFMSynth>(window);
+    benchmark_synth_screens<GossSynth>(window);
+    benchmark_synth_screens<RhodesSynth>(window);
+    benchmark_synth_screens<PotionSynth>(window);
+  }
+} // namespace otto::services::test
+
+#endif
@@ -0,0 +1,67 @@
+#include "testing.t.hpp"
+
+#include <limits>
+
+#include "dummy_services.hpp"
+
+namespace otto::services::test {
+
+  /// Measure the number of samples between a NoteOn entering the midi queue
+  /// and the first non-silent sample at the master output.
+  ///
+  /// This is the in-process part of the latency - midi queue, engine chain
+  /// and master. It does not include the driver's period buffering or the
+  /// converters; for those, see the jack loopback mode
+  /// (OTTO_JACK_LOOPBACK_TEST in boards/parts/audio/jack).
+  TEST_CASE ("Input to sound latency", "[.latency]") {
+    auto app = make_dummy_application_default_engines();
+    app.engine_manager->start();
+    app.audio_manager->start();
+
+    constexpr float threshold = 1e-4f;
+
+    auto measure = [&](int bs) -> long {
+      auto& audio = DummyAudioManager::current();
+      app.audio_manager->send_midi_event(core::midi::NoteOnEvent{60, 0.8f});
+      long offset = 0;
+      for (int block = 0; block < 512; block++) {
+        auto out = audio.process();
+        const float* left = out.audio[0].data();
+        const float* right = out.audio[1].data();
+        for (int i = 0; i < bs; i++) {
+          if (std::abs(left[i]) > threshold || std::abs(right[i]) > threshold) {
+            app.audio_manager->send_midi_event(core::midi::NoteOffEvent{60});
+            return offset + i;
+          }
+        }
+        offset += bs;
+      }
+      return -1;
+    };
+
+    auto drain = [&](int blocks) {
+      for (int i = 0; i < blocks; i++) DummyAudioManager::current().process();
+    };
+
+    constexpr int rounds = 20;
+
+    for (int bs : {16, 64, 256, 1024}) {
+      DummyAudioManager::current().set_bs_sr(bs, 44100);
+      // Let the release tail of the previous round die out
+      drain(4 * 44100 / bs);
+
+      long min = std::numeric_limits<long>::max(), max = 0, sum = 0;
+      for (int round = 0; round < rounds; round++) {
+        long samples = measure(bs);
+        REQUIRE(samples >= 0);
+        min = std::min(min, samples);
+        max = std::max(max, samples);
+        sum += samples;
+        drain(44100 / bs);
+      }
+      WARN(fmt::format("bs = {:4}: min {} samples ({:.2f} ms), mean {:.0f} samples ({:.2f} ms), max {} samples ({:.2f} ms)",
+                       bs, min, min * 1000.0 / 44100, sum / double(rounds), sum * 1000.0 / (rounds * 44100.0), max,
+                       max * 1000.0 / 44100));
+    }
+  }
+} // namespace otto::services::test
@@ -13,6 +13,11 @@ int main( int argc, char* argv[] )
 
   fs::remove_all(test::dir);
 
+  if (result == 0 && Catch::benchmark_regressions > 0) {
+    fmt::print(stderr, "{} benchmark(s) regressed beyond the threshold\n", Catch::benchmark_regressions);
+    return 1;
+  }
+
   return ( result < 0xff ? result : 0xff );
 }
 
@@ -0,0 +1,146 @@
+#include "testing.t.hpp"
+
+#include "core/props/mixins/all.hpp"
+#include "core/props/props.hpp"
+#include "util/iterator.hpp"
+#include "util/local_vector.hpp"
+#include "util/ptr_vec.hpp"
+#include "util/signals.hpp"
+
+/// Microbenchmarks of the building blocks under the audio and UI threads.
+///
+/// The full-chain benchmarks in benchmarks.cpp catch regressions, but not
+/// where they come from - these pin down the foundations individually, sized
+/// to the access patterns the real threads use (a handful of engines, a
+/// block's worth of events, one listener per property). Same tag and CSV
+/// reporter as the rest, so they take part in baseline comparison.
+namespace otto::test {
+
+  using namespace core::props;
+
+  TEST_CASE ("Container microbenchmarks", "[.benchmarks]") {
+    SECTION ("unique_ptr_vec") {
+      struct Elem {
+        virtual ~Elem() = default;
+        virtual int get() const noexcept
+        {
+          return x;
+        }
+        int x = 1;
+      };
+      // Sized like the engine lists the dispatchers iterate per event
+      util::unique_ptr_vec<Elem> pv;
+      for (int i = 0; i < 16; i++) pv.emplace_back();
+      BENCHMARK_ADVANCED("unique_ptr_vec<16> iterate + virtual call")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.divisor(pv.size());
+        meter.measure([&] {
+          int sum = 0;
+          for (auto& e : pv) sum += e.get();
+          return sum;
+        });
+      };
+    }
+
+    SECTION ("local_vector") {
+      // A block's worth of midi events - filled and drained once per buffer
+      util::local_vector<int, 64> lv;
+      BENCHMARK_ADVANCED("local_vector<64> fill + drain")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.divisor(64);
+        meter.measure([&] {
+          for (int i = 0; i < 64; i++) lv.push_back(i).value();
+          int sum = 0;
+          for (auto& e : lv) sum += e;
+          lv.clear();
+          return sum;
+        });
+      };
+    }
+
+    SECTION ("zip iteration") {
+      std::vector<float> a(256, 1.f);
+      std::vector<float> b(256, 2.f);
+      // The pattern the per-sample mixing loops use. The raw loop is the
+      // baseline zip should compile down to
+      BENCHMARK_ADVANCED("zip over 2x256 floats")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.divisor(a.size());
+        meter.measure([&] {
+          float sum = 0;
+          for (auto&& [x, y] : util::zip(a, b)) sum += x * y;
+          return sum;
+        });
+      };
+      BENCHMARK_ADVANCED("raw index loop over 2x256 floats")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.divisor(a.size());
+        meter.measure([&] {
+          float sum = 0;
+          for (std::size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+          return sum;
+        });
+      };
+    }
+  }
+
+  TEST_CASE ("Props and signal microbenchmarks", "[.benchmarks]") {
+    SECTION ("Property get/set") {
+      // The mixin stack every encoder turn and serialized engine field goes
+      // through
+      Property<float> pf = {0, limits(0, 10), step_size(0.1)};
+      BENCHMARK_ADVANCED("Property<float>::set through limits")(Catch::Benchmark::Chronometer meter)
+      {
+        float f = 0;
+        meter.measure([&] {
+          pf.set(f);
+          f += 0.01f;
+          if (f > 10.f) f = 0.f;
+        });
+      };
+      BENCHMARK_ADVANCED("Property<float>::get")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.measure([&] { return pf.get(); });
+      };
+      BENCHMARK_ADVANCED("Property step")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.measure([&, i = 0]() mutable { pf.step((i++ & 1) ? 1 : -1); });
+      };
+    }
+
+    SECTION ("Signal emission") {
+      // One listener is the overwhelmingly common case and takes the inline
+      // fast path - see the note in signals.hpp
+      util::Signal<float> sig1;
+      int count = 0;
+      auto slot1 = sig1.connect([&](float f) { count += int(f); });
+      BENCHMARK_ADVANCED("Signal emit, 1 listener")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.measure([&] { sig1.emit(1.f); });
+      };
+
+      util::Signal<float> sig4;
+      std::vector<util::SlotRef<float>> slots;
+      for (int i = 0; i < 4; i++) {
+        slots.push_back(sig4.connect([&](float f) { count += int(f); }));
+      }
+      BENCHMARK_ADVANCED("Signal emit, 4 listeners")(Catch::Benchmark::Chronometer meter)
+      {
+        meter.measure([&] { sig4.emit(1.f); });
+      };
+
+      // What every props.on_change() subscriber costs per set
+      Property<float> pf = 0;
+      auto slot = pf.on_change().connect([&](float f) { count += int(f); });
+      BENCHMARK_ADVANCED("Property set through on_change")(Catch::Benchmark::Chronometer meter)
+      {
+        float f = 0;
+        meter.measure([&] {
+          pf.set(f);
+          f += 1.f;
+        });
+      };
+    }
+  }
+
+} // namespace otto::test
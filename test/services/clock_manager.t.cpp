@@ -0,0 +1,63 @@
+#include "../testing.t.hpp"
+
+#include <chrono>
+
+#include "../dummy_services.hpp"
+#include "services/clock_manager.hpp"
+
+using namespace otto;
+using namespace std::chrono;
+
+TEST_CASE ("ClockManager external sync", "[services]") {
+  auto app = services::test::make_dummy_application();
+  auto& clock = services::ClockManager::current();
+  // The estimator reads the audio manager's samplerate, so the test does too
+  const int sr = services::AudioManager::current().samplerate();
+  constexpr int bs = 256;
+  clock.set_bpm(120.f);
+
+  SECTION ("Locks onto a steady midi clock") {
+    clock.set_sync_external(true);
+    const float bpm = 100.f;
+    const auto tick_interval = nanoseconds(std::int64_t(60.0e9 / (bpm * 24.0)));
+    auto t = steady_clock::time_point(seconds(1));
+    auto next_tick = t;
+    // Four seconds of blocks with ticks arriving on their exact grid
+    const int blocks = 4 * sr / bs;
+    for (int b = 0; b < blocks; b++) {
+      auto block_end = t + nanoseconds(std::int64_t(1e9 * bs / sr));
+      while (next_tick < block_end) {
+        clock.external_clock_tick(next_tick);
+        next_tick += tick_interval;
+      }
+      t = block_end;
+      clock.step_frames(bs);
+    }
+    const float expected = sr * 60.f / bpm;
+    REQUIRE(clock.samples_pr_beat() == Approx(expected).epsilon(0.01));
+    REQUIRE(clock.bpm() == Approx(bpm).epsilon(0.01));
+    clock.set_sync_external(false);
+  }
+
+  SECTION ("Without ticks the set bpm stands") {
+    clock.set_sync_external(true);
+    const int before = clock.samples_pr_beat();
+    for (int b = 0; b < 16; b++) clock.step_frames(bs);
+    REQUIRE(clock.samples_pr_beat() == before);
+    clock.set_sync_external(false);
+  }
+
+  SECTION ("The stepped clock does not truncate-drift") {
+    // At 140 bpm the per-block step is fractional - the carried remainder
+    // keeps long-run time exact where plain truncation runs measurably slow
+    clock.set_bpm(140.f);
+    clock.start();
+    const int blocks = 8 * sr / bs;
+    core::clock::Time end = 0;
+    for (int b = 0; b < blocks; b++) end = clock.step_frames(bs).end;
+    const double beats = double(end) / core::clock::notes::beat;
+    const double expected = double(blocks) * bs / (sr * 60.0 / 140.0);
+    REQUIRE(beats == Approx(expected).epsilon(0.001));
+    clock.stop();
+  }
+}
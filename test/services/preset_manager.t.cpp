@@ -0,0 +1,96 @@
+#include "../testing.t.hpp"
+
+#include "services/preset_manager.hpp"
+
+#include "core/props/props.hpp"
+#include "core/props/registry.hpp"
+
+namespace otto::services {
+
+  using namespace core::props;
+
+  namespace {
+    struct Inner {
+      Property<float> depth = {0.f, has_limits::init(0.f, 1.f)};
+      DECL_REFLECTION(Inner, depth);
+    };
+
+    struct Props {
+      Property<float> filter = {0.f, has_limits::init(0.f, 1.f)};
+      Property<int> octave = {0, has_limits::init(-4, 4)};
+      Property<bool> enable = {false};
+      Inner lfo;
+      DECL_REFLECTION(Props, filter, octave, enable, lfo);
+    };
+
+    struct FakeEngine {
+      Props props;
+      DECL_REFLECTION(FakeEngine, props);
+    };
+  } // namespace
+
+  TEST_CASE ("PresetMorph", "[preset_manager]") {
+    FakeEngine eg;
+    PropertyRegistry reg{eg};
+
+    // The same shape the preset store holds - what from_json receives
+    const nlohmann::json a = {
+      {"props",
+       {{"filter", 0.f}, {"octave", -2}, {"enable", false}, {"lfo", {{"depth", 1.f}}}}}};
+    // b omits lfo/depth - the value at setup must hold at that endpoint
+    const nlohmann::json b = {{"props", {{"filter", 1.f}, {"octave", 2}, {"enable", true}}}};
+
+    eg.props.lfo.depth = 0.25f;
+
+    PresetMorph morph;
+    morph.setup(reg, a, b);
+    REQUIRE(morph.active());
+
+    SECTION ("The endpoints reproduce the presets") {
+      morph.move_to(0.f);
+      REQUIRE(eg.props.filter == 0.f);
+      REQUIRE(eg.props.octave == -2);
+      REQUIRE(eg.props.enable == false);
+      REQUIRE(eg.props.lfo.depth == Approx(1.f));
+
+      morph.move_to(1.f);
+      REQUIRE(eg.props.filter == 1.f);
+      REQUIRE(eg.props.octave == 2);
+      REQUIRE(eg.props.enable == true);
+      // Held at the value it had when the morph was set up
+      REQUIRE(eg.props.lfo.depth == Approx(0.25f));
+    }
+
+    SECTION ("The midpoint interpolates") {
+      morph.move_to(0.5f);
+      REQUIRE(eg.props.filter == Approx(0.5f));
+      REQUIRE(eg.props.octave == 0);
+      REQUIRE(eg.props.enable == true);
+      REQUIRE(eg.props.lfo.depth == Approx(0.625f));
+    }
+
+    SECTION ("The position clamps to [0, 1]") {
+      morph.move_to(1.5f);
+      REQUIRE(eg.props.filter == 1.f);
+      morph.move_to(-0.5f);
+      REQUIRE(eg.props.filter == 0.f);
+    }
+
+    SECTION ("Change signals run on every move") {
+      int signals = 0;
+      eg.props.filter.on_change().connect([&](float) { signals++; });
+      morph.move_to(0.25f);
+      REQUIRE(signals == 1);
+      REQUIRE(eg.props.filter == Approx(0.25f));
+    }
+
+    SECTION ("An inactive morph does nothing") {
+      morph.clear();
+      REQUIRE(!morph.active());
+      eg.props.filter = 0.7f;
+      morph.move_to(0.f);
+      REQUIRE(eg.props.filter == Approx(0.7f));
+    }
+  }
+
+} // namespace otto::services
@@ -0,0 +1,72 @@
+#include "../testing.t.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "services/task_chain.hpp"
+
+using namespace otto;
+using namespace std::chrono_literals;
+
+namespace {
+  void wait_done(services::TaskChain& chain)
+  {
+    for (int i = 0; i < 2000 && !chain.done(); i++) std::this_thread::sleep_for(1ms);
+  }
+} // namespace
+
+TEST_CASE ("TaskChain", "[services]") {
+  SECTION ("Runs the steps in order, moving results along") {
+    std::atomic<int> result = 0;
+    auto chain = services::task_chain([] { return 3; })
+                   .then([](int x) { return x * 7; })
+                   .then([&](int x) { result = x; })
+                   .run();
+    wait_done(chain);
+    REQUIRE(chain.done());
+    REQUIRE(!chain.cancelled());
+    REQUIRE(result == 21);
+  }
+
+  SECTION ("void steps chain onto each other") {
+    std::atomic<int> order = 0;
+    auto chain = services::task_chain([&] { order = order * 10 + 1; })
+                   .then([&] { order = order * 10 + 2; })
+                   .then([&] { return order * 10 + 3; })
+                   .then([&](int x) { order = x; })
+                   .run();
+    wait_done(chain);
+    REQUIRE(chain.done());
+    REQUIRE(order == 123);
+  }
+
+  SECTION ("Cancel drops the steps that have not started") {
+    std::atomic<bool> gate = false;
+    std::atomic<int> later_steps = 0;
+    auto chain = services::task_chain([&] {
+                   while (!gate) std::this_thread::sleep_for(1ms);
+                 })
+                   .then([&] { later_steps++; })
+                   .run();
+    // The first step is blocked on the gate, so this lands before the chain
+    // reaches its next boundary
+    chain.cancel();
+    gate = true;
+    wait_done(chain);
+    REQUIRE(chain.done());
+    REQUIRE(chain.cancelled());
+    REQUIRE(later_steps == 0);
+  }
+
+  SECTION ("A throwing step stops the chain") {
+    std::atomic<int> later_steps = 0;
+    auto chain = services::task_chain([]() -> int { throw std::runtime_error("nope"); })
+                   .then([&](int) { later_steps++; })
+                   .run();
+    wait_done(chain);
+    REQUIRE(chain.done());
+    REQUIRE(chain.cancelled());
+    REQUIRE(later_steps == 0);
+  }
+}
@@ -0,0 +1,24 @@
+#include "testing.t.hpp"
+
+#include <cstdlib>
+
+#include "services/soak.hpp"
+
+#include "dummy_services.hpp"
+
+namespace otto::services::test {
+
+  /// Hidden like the benchmarks - the nightly job runs it with
+  /// `otto_tests "[.soak]"`. OTTO_SOAK_MINUTES overrides the duration
+  TEST_CASE ("Soak test", "[.soak]") {
+    auto app = make_dummy_application_default_engines();
+    app.engine_manager->start();
+    app.audio_manager->start();
+    DummyAudioManager::current().set_bs_sr(256, 44100);
+
+    float minutes = 2;
+    if (const char* env = std::getenv("OTTO_SOAK_MINUTES")) minutes = std::atof(env);
+
+    REQUIRE(soak::run(minutes));
+  }
+} // namespace otto::services::test
@@ -0,0 +1,90 @@
+#include "../testing.t.hpp"
+
+#include "util/math.hpp"
+
+using namespace otto::util;
+
+TEST_CASE ("Fast math approximations", "[math]") {
+  SECTION ("fastexp2 stays within its documented relative error") {
+    float max_err = 0;
+    for (float x = -30.f; x <= 30.f; x += 0.001f) {
+      float exact = std::exp2(x);
+      max_err = std::max(max_err, std::abs(math::fastexp2(x) - exact) / exact);
+    }
+    REQUIRE(max_err < 1e-4f);
+  }
+
+  SECTION ("fastexp stays within its documented relative error") {
+    float max_err = 0;
+    for (float x = -20.f; x <= 20.f; x += 0.001f) {
+      float exact = std::exp(x);
+      max_err = std::max(max_err, std::abs(math::fastexp(x) - exact) / exact);
+    }
+    REQUIRE(max_err < 1e-4f);
+  }
+
+  SECTION ("fastlog2 stays within its documented absolute error") {
+    float max_err = 0;
+    for (float x = 1e-3f; x <= 1e3f; x *= 1.001f) {
+      max_err = std::max(max_err, std::abs(math::fastlog2(x) - std::log2(x)));
+    }
+    REQUIRE(max_err < 3e-4f);
+  }
+
+  SECTION ("fastpow stays within its documented relative error") {
+    float max_err = 0;
+    for (float b : {0.001f, 0.5f, 2.f, 20.f, 440.f}) {
+      for (float x = -3.f; x <= 3.f; x += 0.001f) {
+        float exact = std::pow(b, x);
+        max_err = std::max(max_err, std::abs(math::fastpow(b, x) - exact) / exact);
+      }
+    }
+    REQUIRE(max_err < 2e-3f);
+  }
+
+  SECTION ("fastsin stays within its documented absolute error") {
+    float max_err = 0;
+    for (float x = -M_PI; x <= M_PI; x += 0.0001f) {
+      max_err = std::max(max_err, std::abs(math::fastsin(x) - std::sin(x)));
+    }
+    REQUIRE(max_err < 1.2e-3f);
+  }
+
+  SECTION ("fasttan stays within its documented relative error") {
+    float max_err = 0;
+    for (float x = 0.001f; x <= M_PI / 4.f; x += 0.0001f) {
+      float exact = std::tan(x);
+      max_err = std::max(max_err, std::abs(math::fasttan(x) - exact) / exact);
+    }
+    REQUIRE(max_err < 4e-3f);
+  }
+
+  SECTION ("span versions match the scalar versions") {
+    std::array<float, 64> in = {};
+    for (int i = 0; i < 64; i++) in[i] = -3.f + i * 0.1f;
+    std::array<float, 64> out = {};
+    math::fastexp2(in, out);
+    for (int i = 0; i < 64; i++) REQUIRE(out[i] == math::fastexp2(in[i]));
+  }
+
+  SECTION ("clamp matches std::clamp") {
+    for (float v = -2.f; v <= 2.f; v += 0.01f) {
+      REQUIRE(math::clamp(v, -1.f, 1.f) == std::clamp(v, -1.f, 1.f));
+    }
+    REQUIRE(math::clamp(7, 0, 5) == 5);
+    REQUIRE(math::clamp(-7, 0, 5) == 0);
+  }
+
+  SECTION ("step_quantize snaps to the grid and clamps") {
+    REQUIRE(math::step_quantize(0.49f, 0.25f, 0.f, 1.f) == Approx(0.5f));
+    REQUIRE(math::step_quantize(0.37f, 0.25f, 0.f, 1.f) == Approx(0.25f));
+    REQUIRE(math::step_quantize(1.4f, 0.25f, 0.f, 1.f) == 1.f);
+    REQUIRE(math::step_quantize(-0.3f, 0.25f, 0.f, 1.f) == 0.f);
+    // Integers round to nearest in both directions
+    REQUIRE(math::step_quantize(7, 5, 0, 20) == 5);
+    REQUIRE(math::step_quantize(8, 5, 0, 20) == 10);
+    REQUIRE(math::step_quantize(23, 5, 0, 20) == 20);
+    // A zero step only clamps
+    REQUIRE(math::step_quantize(0.3f, 0.f, 0.f, 1.f) == Approx(0.3f));
+  }
+}
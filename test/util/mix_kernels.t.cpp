@@ -0,0 +1,166 @@
+#include "../testing.t.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "util/dsp/mix_kernels.hpp"
+
+using namespace otto::util;
+
+namespace {
+
+  /// Odd length, so every kernel's scalar tail is exercised too
+  constexpr std::size_t n = 259;
+
+  std::vector<float> ramp(float scale)
+  {
+    std::vector<float> res(n);
+    for (std::size_t i = 0; i < n; i++) {
+      res[i] = scale * (float(i) - float(n) / 2);
+    }
+    return res;
+  }
+
+} // namespace
+
+TEST_CASE ("Mix kernels match their scalar definitions", "[mix_kernels]") {
+  const auto a = ramp(0.01f);
+  const auto b = ramp(-0.03f);
+
+  SECTION ("copy_scale") {
+    std::vector<float> dest(n);
+    dsp::copy_scale(dest.data(), a.data(), 1.5f, n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[i] == Approx(a[i] * 1.5f));
+    }
+  }
+
+  SECTION ("accumulate_scale") {
+    auto dest = b;
+    dsp::accumulate_scale(dest.data(), a.data(), 0.25f, n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[i] == Approx(b[i] + a[i] * 0.25f));
+    }
+  }
+
+  SECTION ("accumulate_product") {
+    auto dest = b;
+    dsp::accumulate_product(dest.data(), a.data(), b.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[i] == Approx(b[i] + a[i] * b[i]));
+    }
+  }
+
+  SECTION ("scale_ramp covers the full gain range") {
+    std::vector<float> dest(n, 1.f);
+    dsp::scale_ramp(dest.data(), 0.f, 1.f, n);
+    REQUIRE(dest[0] == Approx(0.f).margin(1.f / n));
+    REQUIRE(dest[n - 1] == Approx(1.f).margin(2.f / n));
+    REQUIRE(std::is_sorted(dest.begin(), dest.end()));
+  }
+
+  SECTION ("clear") {
+    auto dest = a;
+    dsp::clear(dest.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[i] == 0.f);
+    }
+  }
+
+  SECTION ("peak") {
+    auto src = a;
+    src[n - 2] = -17.f;
+    REQUIRE(dsp::peak(src.data(), n) == Approx(17.f));
+    REQUIRE(dsp::peak(src.data(), 0) == 0.f);
+  }
+
+  SECTION ("mean_square") {
+    float expected = 0;
+    for (auto v : a) expected += v * v;
+    expected /= float(n);
+    REQUIRE(dsp::mean_square(a.data(), n) == Approx(expected));
+  }
+
+  SECTION ("interleave2") {
+    std::vector<float> dest(2 * n);
+    dsp::interleave2(dest.data(), a.data(), b.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[2 * i] == a[i]);
+      REQUIRE(dest[2 * i + 1] == b[i]);
+    }
+  }
+
+  SECTION ("accumulate_interleave2") {
+    std::vector<float> dest(2 * n, 1.f);
+    dsp::accumulate_interleave2(dest.data(), a.data(), b.data(), 0.5f, n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[2 * i] == Approx(1.f + a[i] * 0.5f));
+      REQUIRE(dest[2 * i + 1] == Approx(1.f + b[i] * 0.5f));
+    }
+  }
+
+  SECTION ("copy_stride2") {
+    const auto src = ramp(1.f);
+    std::vector<float> dest(n / 2);
+    dsp::copy_stride2(dest.data(), src.data(), n / 2);
+    for (std::size_t i = 0; i < n / 2; i++) {
+      REQUIRE(dest[i] == src[2 * i]);
+    }
+  }
+
+  SECTION ("clamp") {
+    const auto src = ramp(0.02f);
+    std::vector<float> dest(n);
+    dsp::clamp(dest.data(), src.data(), 1.f, 3.f, n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[i] == std::clamp(src[i], 1.f, 3.f));
+    }
+  }
+
+  SECTION ("lerp") {
+    std::vector<float> dest(n);
+    dsp::lerp(dest.data(), a.data(), b.data(), 0.3f, n);
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(dest[i] == Approx(a[i] + 0.3f * (b[i] - a[i])));
+    }
+  }
+
+  SECTION ("step_quantize") {
+    const auto src = ramp(0.017f);
+    std::vector<float> dest(n);
+    dsp::step_quantize(dest.data(), src.data(), 0.25f, 0.5f, 3.5f, n);
+    for (std::size_t i = 0; i < n; i++) {
+      // Ties round up - truncation after +0.5, matching the vector paths
+      const float expected = std::clamp(0.5f + float(std::int32_t((src[i] - 0.5f) / 0.25f + 0.5f)) * 0.25f, 0.5f, 3.5f);
+      REQUIRE(dest[i] == Approx(expected));
+    }
+  }
+}
+
+TEST_CASE ("Mix kernel benchmarks", "[.benchmarks]") {
+  constexpr std::size_t bs = 256;
+  std::vector<float> dest(2 * bs, 0.f);
+  const auto a = ramp(0.01f);
+  const auto b = ramp(-0.03f);
+
+  BENCHMARK ("accumulate_scale, bs = 256") {
+    dsp::accumulate_scale(dest.data(), a.data(), 0.5f, bs);
+    return dest[0];
+  };
+  BENCHMARK ("accumulate_product, bs = 256") {
+    dsp::accumulate_product(dest.data(), a.data(), b.data(), bs);
+    return dest[0];
+  };
+  BENCHMARK ("scale_ramp, bs = 256") {
+    dsp::scale_ramp(dest.data(), 0.99f, 1.01f, bs);
+    return dest[0];
+  };
+  BENCHMARK ("peak, bs = 256") {
+    return dsp::peak(a.data(), bs);
+  };
+  BENCHMARK ("interleave2, bs = 256") {
+    dsp::interleave2(dest.data(), a.data(), b.data(), bs);
+    return dest[0];
+  };
+}